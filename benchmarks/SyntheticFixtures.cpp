@@ -0,0 +1,416 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SyntheticFixtures.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The synthetic benchmark fixtures definition
+//!
+//---------------------------------------------------------------------------//
+
+// StormLib Includes
+#include <StormLib.h>
+
+// Qt Includes
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QImage>
+
+// QtD1 Includes
+#include "SyntheticFixtures.h"
+#include "PCXHandler.h"
+
+// Initialize static member data
+const char* SyntheticFixtures::s_palette_name = "levels/towndata/town.pal";
+const char* SyntheticFixtures::s_cel_image_name = "town.cel";
+const char* SyntheticFixtures::s_cl2_image_name = "acidbf1.cl2";
+const char* SyntheticFixtures::s_town_min_file_name =
+  "/levels/towndata/town.min";
+const char* SyntheticFixtures::s_town_til_file_name =
+  "/levels/towndata/town.til";
+const char* SyntheticFixtures::s_town_dun_file_name =
+  "/levels/towndata/sector1s.dun";
+
+// The positions that are zero in a tile frame with upper-left trans
+static const int s_upper_left_zero_positions[] =
+  {0, 1, 8, 9, 24, 25, 48, 49, 80, 81, 120, 121, 168, 169, 224, 225};
+
+// The positions that are zero in a tile frame with upper-right trans
+static const int s_upper_right_zero_positions[] =
+  {2, 3, 14, 15, 34, 35, 62, 63, 98, 99, 142, 143, 194, 195, 254, 255};
+
+// The number of zero positions
+static const int s_number_of_zero_positions = 16;
+
+// Create the palette data
+/*! \details The palette is a color ramp (the colors do not affect the
+ * decode times).
+ */
+QByteArray SyntheticFixtures::createPaletteData()
+{
+  QByteArray palette_data( 3*256, 0 );
+
+  for( int i = 0; i < 256; ++i )
+  {
+    palette_data[3*i] = (char)i;
+    palette_data[3*i+1] = (char)(255 - i);
+    palette_data[3*i+2] = (char)(i/2);
+  }
+
+  return palette_data;
+}
+
+// Create the data of a frame (without a frame header)
+/*! \details The tile frames have the sizes and the implicit transparency
+ * markers that the frame decoder uses to select a decoder (see
+ * CelFrameDecoder::getDecoder). The standard frames mix transparent, run
+ * length encoded and explicit pixels.
+ */
+QByteArray SyntheticFixtures::createFrameData( const FrameType type )
+{
+  QByteArray frame_data;
+
+  switch( type )
+  {
+  case NoTransTileFrame:
+    return SyntheticFixtures::createNoiseData( 0x400, type );
+
+  case UpperLowerLeftTransTileFrame:
+  case UpperLowerRightTransTileFrame:
+  case UpperLeftTransTileFrame:
+  case UpperRightTransTileFrame:
+  {
+    const bool upper_lower =
+      type == UpperLowerLeftTransTileFrame ||
+      type == UpperLowerRightTransTileFrame;
+
+    const bool left =
+      type == UpperLowerLeftTransTileFrame ||
+      type == UpperLeftTransTileFrame;
+
+    frame_data =
+      SyntheticFixtures::createNoiseData( upper_lower ? 0x220 : 0x320, type );
+
+    const int* zero_positions =
+      left ? s_upper_left_zero_positions : s_upper_right_zero_positions;
+
+    for( int i = 0; i < s_number_of_zero_positions; ++i )
+      frame_data[zero_positions[i]] = 0;
+
+    return frame_data;
+  }
+
+  case StandardCelFrame:
+  {
+    // 32 rows: 16 transparent pixels and 16 explicit pixels
+    const QByteArray pixels = SyntheticFixtures::createNoiseData( 16, type );
+
+    for( int row = 0; row < 32; ++row )
+    {
+      frame_data.append( (char)(256-16) );
+      frame_data.append( (char)16 );
+      frame_data.append( pixels );
+    }
+
+    return frame_data;
+  }
+
+  case StandardCl2Frame:
+  {
+    // Every row: 32 transparent, 32 run length encoded and 32 explicit
+    // pixels
+    const QByteArray pixels = SyntheticFixtures::createNoiseData( 32, type );
+
+    for( int row = 0; row < s_cl2_frame_height; ++row )
+    {
+      frame_data.append( (char)32 );
+      frame_data.append( (char)-(65+32) );
+      frame_data.append( (char)(row+1) );
+      frame_data.append( (char)-32 );
+      frame_data.append( pixels );
+    }
+
+    return frame_data;
+  }
+  }
+
+  qFatal( "SyntheticFixtures Error: Frame type %i is not valid!", (int)type );
+
+  return frame_data;
+}
+
+// Create a cel file that cycles through the town tile frame types
+/*! \details The standard cel frames are 32x32 (see the town.cel entry in
+ * cel.ini).
+ */
+QByteArray SyntheticFixtures::createCelFileData( const int number_of_frames )
+{
+  QVector<QByteArray> frames( number_of_frames );
+
+  for( int i = 0; i < number_of_frames; ++i )
+  {
+    frames[i] =
+      SyntheticFixtures::createFrameData( (FrameType)(i%StandardCl2Frame) );
+  }
+
+  return SyntheticFixtures::createCelFileData( frames, 0 );
+}
+
+// Create a cl2 file
+QByteArray SyntheticFixtures::createCl2FileData( const int number_of_frames )
+{
+  QVector<QByteArray> frames( number_of_frames,
+                              SyntheticFixtures::createFrameData(
+                                                        StandardCl2Frame ) );
+
+  return SyntheticFixtures::createCelFileData( frames,
+                                               s_cl2_frame_header_size );
+}
+
+// Create a cel file from the frames
+/*! \details The file starts with the number of frames and the frame
+ * offsets (little endian). The frame headers are zeroed.
+ */
+QByteArray SyntheticFixtures::createCelFileData(
+                                        const QVector<QByteArray>& frames,
+                                        const int frame_header_size )
+{
+  QByteArray file_data;
+
+  QBuffer buffer( &file_data );
+  buffer.open( QIODevice::WriteOnly );
+
+  QDataStream stream( &buffer );
+  stream.setByteOrder( QDataStream::LittleEndian );
+
+  stream << (quint32)frames.size();
+
+  quint32 offset = 4*(frames.size() + 2);
+
+  for( int i = 0; i < frames.size(); ++i )
+  {
+    stream << offset;
+
+    offset += frame_header_size + frames[i].size();
+  }
+
+  stream << offset;
+
+  const QByteArray frame_header( frame_header_size, 0 );
+
+  for( int i = 0; i < frames.size(); ++i )
+  {
+    stream.writeRawData( frame_header.data(), frame_header.size() );
+    stream.writeRawData( frames[i].data(), frames[i].size() );
+  }
+
+  return file_data;
+}
+
+// Create the town min file data (16 blocks per pillar)
+/*! \details The upper blocks of every other pillar are transparent (like
+ * the pillars of the real town).
+ */
+QByteArray SyntheticFixtures::createTownMinData( const int number_of_pillars,
+                                                 const int number_of_frames )
+{
+  QByteArray min_data;
+
+  QBuffer buffer( &min_data );
+  buffer.open( QIODevice::WriteOnly );
+
+  QDataStream stream( &buffer );
+  stream.setByteOrder( QDataStream::LittleEndian );
+
+  for( int i = 0; i < number_of_pillars; ++i )
+  {
+    for( int j = 0; j < 16; ++j )
+    {
+      if( i%2 == 1 && j >= 12 )
+        stream << (quint16)0;
+      else
+      {
+        const int frame_index = (16*i + j)%number_of_frames;
+
+        stream << (quint16)((frame_index + 1) | ((frame_index%5) << 12));
+      }
+    }
+  }
+
+  return min_data;
+}
+
+// Create the til file data (4 pillars per square)
+QByteArray SyntheticFixtures::createTilData( const int number_of_squares,
+                                             const int number_of_pillars )
+{
+  QByteArray til_data;
+
+  QBuffer buffer( &til_data );
+  buffer.open( QIODevice::WriteOnly );
+
+  QDataStream stream( &buffer );
+  stream.setByteOrder( QDataStream::LittleEndian );
+
+  for( int i = 0; i < 4*number_of_squares; ++i )
+    stream << (quint16)(i%number_of_pillars);
+
+  return til_data;
+}
+
+// Create the dun file data
+QByteArray SyntheticFixtures::createDunData( const int number_of_rows,
+                                             const int number_of_columns,
+                                             const int number_of_squares )
+{
+  QByteArray dun_data;
+
+  QBuffer buffer( &dun_data );
+  buffer.open( QIODevice::WriteOnly );
+
+  QDataStream stream( &buffer );
+  stream.setByteOrder( QDataStream::LittleEndian );
+
+  stream << (quint16)number_of_columns;
+  stream << (quint16)number_of_rows;
+
+  for( int i = 0; i < number_of_rows*number_of_columns; ++i )
+    stream << (quint16)(i%number_of_squares + 1);
+
+  return dun_data;
+}
+
+// Create the pcx file data (8-bit indexed with a 256 color palette)
+/*! \details The image has runs of 8 identical pixels so that the run
+ * length encoding is exercised.
+ */
+QByteArray SyntheticFixtures::createPCXData( const int width,
+                                             const int height )
+{
+  QImage image( width, height, QImage::Format_Indexed8 );
+  image.setColorCount( 256 );
+
+  for( int i = 0; i < 256; ++i )
+    image.setColor( i, qRgb( i, 255 - i, i/2 ) );
+
+  for( int y = 0; y < height; ++y )
+  {
+    uchar* scan_line = image.scanLine( y );
+
+    for( int x = 0; x < width; ++x )
+      scan_line[x] = (uchar)((x/8 + y)%256);
+  }
+
+  QByteArray pcx_data;
+
+  QBuffer buffer( &pcx_data );
+  buffer.open( QIODevice::WriteOnly );
+
+  QtD1::PCXHandler handler;
+  handler.setDevice( &buffer );
+
+  if( !handler.write( image ) )
+    qFatal( "SyntheticFixtures Error: The pcx data could not be created!" );
+
+  return pcx_data;
+}
+
+// Create the synthetic archive (returns false if it couldn't be written)
+/*! \details The files are PKWARE imploded like the files in diabdat.mpq.
+ * The archive will be overwritten if it already exists.
+ */
+bool SyntheticFixtures::createArchive( const QString& archive_file_name )
+{
+  QFile::remove( archive_file_name );
+
+  const QStringList file_names = SyntheticFixtures::getArchivedFileNames();
+
+  QVector<QByteArray> file_data;
+  file_data << SyntheticFixtures::createPaletteData()
+            << SyntheticFixtures::createCelFileData( 1024 )
+            << SyntheticFixtures::createTownMinData( 1024, 1024 )
+            << SyntheticFixtures::createTilData( 512, 1024 )
+            << SyntheticFixtures::createDunData( 25, 25, 512 )
+            << SyntheticFixtures::createCl2FileData( 16 )
+            << SyntheticFixtures::createPCXData( 640, 480 )
+            << SyntheticFixtures::createNoiseData( 1 << 20, 0 );
+
+  HANDLE archive;
+
+  if( !SFileCreateArchive( archive_file_name.toLocal8Bit().data(),
+                           MPQ_CREATE_ARCHIVE_V1,
+                           2*file_names.size(),
+                           &archive ) )
+    return false;
+
+  bool success = true;
+
+  for( int i = 0; i < file_names.size() && success; ++i )
+  {
+    // Convert the path to the mpq path style
+    QString archived_file_name = file_names[i].mid( 1 );
+    archived_file_name.replace( '/', '\\' );
+
+    HANDLE archived_file;
+
+    success = SFileCreateFile( archive,
+                               archived_file_name.toLatin1().data(),
+                               0,
+                               file_data[i].size(),
+                               0,
+                               MPQ_FILE_IMPLODE | MPQ_FILE_REPLACEEXISTING,
+                               &archived_file );
+
+    if( success )
+    {
+      success = SFileWriteFile( archived_file,
+                                file_data[i].data(),
+                                file_data[i].size(),
+                                MPQ_COMPRESSION_PKWARE );
+
+      success = SFileFinishFile( archived_file ) && success;
+    }
+  }
+
+  return SFileCloseArchive( archive ) && success;
+}
+
+// Get the names of the files in the synthetic archive
+QStringList SyntheticFixtures::getArchivedFileNames()
+{
+  return QStringList() << QString( "/" ) + s_palette_name
+                       << "/levels/towndata/town.cel"
+                       << s_town_min_file_name
+                       << s_town_til_file_name
+                       << s_town_dun_file_name
+                       << "/monsters/acid/acidbf1.cl2"
+                       << "/ui_art/title.pcx"
+                       << "/music/synthetic.bin";
+}
+
+// Create pseudo-random but deterministic bytes
+/*! \details The bytes are never zero (zero bytes are used as implicit
+ * transparency markers in the tile frames).
+ */
+QByteArray SyntheticFixtures::createNoiseData( const int size,
+                                               const unsigned seed )
+{
+  QByteArray data( size, 0 );
+
+  unsigned state = 2463534242u + seed;
+
+  for( int i = 0; i < size; ++i )
+  {
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    data[i] = (char)(state%255 + 1);
+  }
+
+  return data;
+}
+
+//---------------------------------------------------------------------------//
+// end SyntheticFixtures.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,122 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SyntheticFixtures.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The synthetic benchmark fixtures declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef SYNTHETIC_FIXTURES_H
+#define SYNTHETIC_FIXTURES_H
+
+// Qt Includes
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+
+/*! The synthetic benchmark fixtures
+ *
+ * diabdat.mpq cannot be shipped so the benchmarks run on generated data
+ * that has the same layout as the real assets (e.g. the town tile frames,
+ * the town min, til and dun files and a PKWARE imploded archive). The
+ * fixtures are deterministic so that benchmark runs can be compared.
+ */
+class SyntheticFixtures
+{
+
+public:
+
+  //! The cel frame types
+  enum FrameType{
+    NoTransTileFrame = 0,
+    UpperLowerLeftTransTileFrame,
+    UpperLowerRightTransTileFrame,
+    UpperLeftTransTileFrame,
+    UpperRightTransTileFrame,
+    StandardCelFrame,
+    StandardCl2Frame
+  };
+
+  //! The number of frame types
+  static const int s_number_of_frame_types = 7;
+
+  //! The palette name (the default palette of the cel and cl2 images)
+  static const char* s_palette_name;
+
+  //! The cel image name (town.cel properties are used)
+  static const char* s_cel_image_name;
+
+  //! The cl2 image name (acidbf1.cl2 properties are used)
+  static const char* s_cl2_image_name;
+
+  //! The width of the synthetic cl2 frames (see cl2.ini)
+  static const int s_cl2_frame_width = 96;
+
+  //! The height of the synthetic cl2 frames (see cl2.ini)
+  static const int s_cl2_frame_height = 96;
+
+  //! The size of the synthetic cl2 frame headers (see cl2.ini)
+  static const int s_cl2_frame_header_size = 10;
+
+  //! The synthetic town min file (with path)
+  static const char* s_town_min_file_name;
+
+  //! The synthetic town til file (with path)
+  static const char* s_town_til_file_name;
+
+  //! The synthetic town dun file (with path)
+  static const char* s_town_dun_file_name;
+
+  //! Create the palette data
+  static QByteArray createPaletteData();
+
+  //! Create the data of a frame (without a frame header)
+  static QByteArray createFrameData( const FrameType type );
+
+  //! Create a cel file that cycles through the town tile frame types
+  static QByteArray createCelFileData( const int number_of_frames );
+
+  //! Create a cl2 file
+  static QByteArray createCl2FileData( const int number_of_frames );
+
+  //! Create the town min file data (16 blocks per pillar)
+  static QByteArray createTownMinData( const int number_of_pillars,
+                                       const int number_of_frames );
+
+  //! Create the til file data (4 pillars per square)
+  static QByteArray createTilData( const int number_of_squares,
+                                   const int number_of_pillars );
+
+  //! Create the dun file data
+  static QByteArray createDunData( const int number_of_rows,
+                                   const int number_of_columns,
+                                   const int number_of_squares );
+
+  //! Create the pcx file data (8-bit indexed with a 256 color palette)
+  static QByteArray createPCXData( const int width, const int height );
+
+  //! Create the synthetic archive (returns false if it couldn't be written)
+  static bool createArchive( const QString& archive_file_name );
+
+  //! Get the names of the files in the synthetic archive
+  static QStringList getArchivedFileNames();
+
+private:
+
+  // Create a cel file from the frames
+  static QByteArray createCelFileData( const QVector<QByteArray>& frames,
+                                       const int frame_header_size );
+
+  // Create pseudo-random but deterministic bytes
+  static QByteArray createNoiseData( const int size, const unsigned seed );
+
+  // Constructor
+  SyntheticFixtures();
+};
+
+#endif // end SYNTHETIC_FIXTURES_H
+
+//---------------------------------------------------------------------------//
+// end SyntheticFixtures.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,129 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   bmCelDecoder.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The cel frame decoder and cel decoder benchmarks
+//!
+//---------------------------------------------------------------------------//
+
+// Google Benchmark Includes
+#include <benchmark/benchmark.h>
+
+// Qt Includes
+#include <QImage>
+#include <QVector>
+
+// QtD1 Includes
+#include "CelFrameDecoder.h"
+#include "CelDecoder.h"
+#include "CelPalette.h"
+#include "SyntheticFixtures.h"
+
+//---------------------------------------------------------------------------//
+// Benchmarks.
+//---------------------------------------------------------------------------//
+// Decode a single frame of the requested type
+/*! \details The decoder selection (e.g. the frame property lookup) is part
+ * of the measured time, just like it is in CelDecoder::decode.
+ */
+static void BM_CelFrameDecoder_decode( benchmark::State& state,
+                                       const SyntheticFixtures::FrameType type )
+{
+  const QtD1::CelPalette palette( SyntheticFixtures::s_palette_name,
+                                  SyntheticFixtures::createPaletteData() );
+
+  const QString file_name = type == SyntheticFixtures::StandardCl2Frame ?
+    SyntheticFixtures::s_cl2_image_name : SyntheticFixtures::s_cel_image_name;
+
+  const QByteArray frame_data = SyntheticFixtures::createFrameData( type );
+
+  while( state.KeepRunning() )
+  {
+    QtD1::CelFrameDecoder::DecodeFunctor decode_frame =
+      QtD1::CelFrameDecoder::getDecoder( file_name, 0, frame_data );
+
+    QImage frame = decode_frame( palette );
+
+    benchmark::DoNotOptimize( frame.constBits() );
+  }
+
+  state.SetBytesProcessed( state.iterations()*frame_data.size() );
+  state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK_CAPTURE( BM_CelFrameDecoder_decode, no_trans_tile,
+                   SyntheticFixtures::NoTransTileFrame );
+BENCHMARK_CAPTURE( BM_CelFrameDecoder_decode, upper_lower_left_trans_tile,
+                   SyntheticFixtures::UpperLowerLeftTransTileFrame );
+BENCHMARK_CAPTURE( BM_CelFrameDecoder_decode, upper_lower_right_trans_tile,
+                   SyntheticFixtures::UpperLowerRightTransTileFrame );
+BENCHMARK_CAPTURE( BM_CelFrameDecoder_decode, upper_left_trans_tile,
+                   SyntheticFixtures::UpperLeftTransTileFrame );
+BENCHMARK_CAPTURE( BM_CelFrameDecoder_decode, upper_right_trans_tile,
+                   SyntheticFixtures::UpperRightTransTileFrame );
+BENCHMARK_CAPTURE( BM_CelFrameDecoder_decode, standard_cel,
+                   SyntheticFixtures::StandardCelFrame );
+BENCHMARK_CAPTURE( BM_CelFrameDecoder_decode, standard_cl2,
+                   SyntheticFixtures::StandardCl2Frame );
+
+//---------------------------------------------------------------------------//
+// Decode a cel file that cycles through the town tile frame types
+static void BM_CelDecoder_decode_cel( benchmark::State& state )
+{
+  const QtD1::CelPalette palette( SyntheticFixtures::s_palette_name,
+                                  SyntheticFixtures::createPaletteData() );
+
+  QByteArray file_data =
+    SyntheticFixtures::createCelFileData( state.range( 0 ) );
+
+  QtD1::CelDecoder decoder( QString( "/levels/towndata/" ) +
+                            SyntheticFixtures::s_cel_image_name,
+                            file_data );
+
+  while( state.KeepRunning() )
+  {
+    QVector<QImage> frames;
+
+    decoder.decode( frames, palette );
+
+    benchmark::DoNotOptimize( frames.data() );
+  }
+
+  state.SetBytesProcessed( state.iterations()*file_data.size() );
+  state.SetItemsProcessed( state.iterations()*state.range( 0 ) );
+}
+
+BENCHMARK( BM_CelDecoder_decode_cel )->Arg( 64 )->Arg( 1024 );
+
+//---------------------------------------------------------------------------//
+// Decode a cl2 file
+static void BM_CelDecoder_decode_cl2( benchmark::State& state )
+{
+  const QtD1::CelPalette palette( SyntheticFixtures::s_palette_name,
+                                  SyntheticFixtures::createPaletteData() );
+
+  QByteArray file_data =
+    SyntheticFixtures::createCl2FileData( state.range( 0 ) );
+
+  QtD1::CelDecoder decoder( QString( "/monsters/acid/" ) +
+                            SyntheticFixtures::s_cl2_image_name,
+                            file_data );
+
+  while( state.KeepRunning() )
+  {
+    QVector<QImage> frames;
+
+    decoder.decode( frames, palette );
+
+    benchmark::DoNotOptimize( frames.data() );
+  }
+
+  state.SetBytesProcessed( state.iterations()*file_data.size() );
+  state.SetItemsProcessed( state.iterations()*state.range( 0 ) );
+}
+
+BENCHMARK( BM_CelDecoder_decode_cl2 )->Arg( 16 )->Arg( 128 );
+
+//---------------------------------------------------------------------------//
+// end bmCelDecoder.cpp
+//---------------------------------------------------------------------------//
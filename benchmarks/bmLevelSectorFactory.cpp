@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   bmLevelSectorFactory.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level sector factory benchmarks
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <memory>
+
+// Google Benchmark Includes
+#include <benchmark/benchmark.h>
+
+// QtD1 Includes
+#include "LevelSectorFactory.h"
+#include "LevelSquareFactory.h"
+#include "LevelSector.h"
+#include "SyntheticFixtures.h"
+
+//---------------------------------------------------------------------------//
+// Benchmarks.
+//---------------------------------------------------------------------------//
+// Create the town sector (the min, til and dun files are read every time)
+static void BM_LevelSectorFactory_createLevelSector( benchmark::State& state )
+{
+  QtD1::LevelSectorFactory
+    factory( SyntheticFixtures::s_town_min_file_name,
+             SyntheticFixtures::s_town_til_file_name,
+             SyntheticFixtures::s_town_dun_file_name );
+
+  while( state.KeepRunning() )
+  {
+    std::unique_ptr<QtD1::LevelSector>
+      sector( factory.createLevelSector() );
+
+    benchmark::DoNotOptimize( sector.get() );
+  }
+
+  state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( BM_LevelSectorFactory_createLevelSector )
+->Unit( benchmark::kMillisecond );
+
+//---------------------------------------------------------------------------//
+// Create the town sector from squares that have already been created
+static void BM_LevelSectorFactory_createLevelSector_cachedSquares(
+                                                     benchmark::State& state )
+{
+  QtD1::LevelSquareFactory
+    square_factory( SyntheticFixtures::s_town_min_file_name,
+                    SyntheticFixtures::s_town_til_file_name );
+
+  const QList<std::shared_ptr<QtD1::LevelSquare> > squares =
+    square_factory.createLevelSquares();
+
+  QtD1::LevelSectorFactory
+    factory( SyntheticFixtures::s_town_min_file_name,
+             SyntheticFixtures::s_town_til_file_name,
+             SyntheticFixtures::s_town_dun_file_name );
+
+  while( state.KeepRunning() )
+  {
+    std::unique_ptr<QtD1::LevelSector>
+      sector( factory.createLevelSector( squares ) );
+
+    benchmark::DoNotOptimize( sector.get() );
+  }
+
+  state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( BM_LevelSectorFactory_createLevelSector_cachedSquares )
+->Unit( benchmark::kMillisecond );
+
+//---------------------------------------------------------------------------//
+// end bmLevelSectorFactory.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,52 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   bmMPQHandler.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The mpq handler benchmarks
+//!
+//---------------------------------------------------------------------------//
+
+// Google Benchmark Includes
+#include <benchmark/benchmark.h>
+
+// Qt Includes
+#include <QByteArray>
+#include <QStringList>
+
+// QtD1 Includes
+#include "MPQHandler.h"
+#include "SyntheticFixtures.h"
+
+//---------------------------------------------------------------------------//
+// Benchmarks.
+//---------------------------------------------------------------------------//
+// Extract a file from the synthetic archive (the arg is the file index)
+static void BM_MPQHandler_extractFile( benchmark::State& state )
+{
+  const QString file_name =
+    SyntheticFixtures::getArchivedFileNames()[state.range( 0 )];
+
+  QtD1::MPQHandler* handler = QtD1::MPQHandler::getInstance();
+
+  qint64 bytes_extracted = 0;
+
+  while( state.KeepRunning() )
+  {
+    QByteArray file_data;
+
+    handler->extractFile( file_name, file_data );
+
+    benchmark::DoNotOptimize( file_data.data() );
+
+    bytes_extracted += file_data.size();
+  }
+
+  state.SetBytesProcessed( bytes_extracted );
+  state.SetLabel( file_name.toStdString() );
+}
+
+BENCHMARK( BM_MPQHandler_extractFile )->DenseRange( 0, 7 );
+
+//---------------------------------------------------------------------------//
+// end bmMPQHandler.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,53 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   bmPCXHandler.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The pcx handler benchmarks
+//!
+//---------------------------------------------------------------------------//
+
+// Google Benchmark Includes
+#include <benchmark/benchmark.h>
+
+// Qt Includes
+#include <QBuffer>
+#include <QImage>
+
+// QtD1 Includes
+#include "PCXHandler.h"
+#include "SyntheticFixtures.h"
+
+//---------------------------------------------------------------------------//
+// Benchmarks.
+//---------------------------------------------------------------------------//
+// Read a pcx image (the args are the image width and height)
+static void BM_PCXHandler_read( benchmark::State& state )
+{
+  QByteArray file_data =
+    SyntheticFixtures::createPCXData( state.range( 0 ), state.range( 1 ) );
+
+  while( state.KeepRunning() )
+  {
+    QBuffer buffer( &file_data );
+    buffer.open( QIODevice::ReadOnly );
+
+    QtD1::PCXHandler handler;
+    handler.setDevice( &buffer );
+
+    QImage image;
+
+    if( !handler.read( &image ) )
+      state.SkipWithError( "The pcx image could not be read" );
+
+    benchmark::DoNotOptimize( image.constBits() );
+  }
+
+  state.SetBytesProcessed( state.iterations()*file_data.size() );
+  state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( BM_PCXHandler_read )->Args( {32, 32} )->Args( {640, 480} );
+
+//---------------------------------------------------------------------------//
+// end bmPCXHandler.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,45 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   bmThreadSafeQueue.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The thread safe queue benchmarks
+//!
+//---------------------------------------------------------------------------//
+
+// Google Benchmark Includes
+#include <benchmark/benchmark.h>
+
+// QtD1 Includes
+#include "ThreadSafeQueue.h"
+
+// The queue shared by the benchmark threads
+static QtD1::ThreadSafeQueue<int> s_queue;
+
+//---------------------------------------------------------------------------//
+// Benchmarks.
+//---------------------------------------------------------------------------//
+// Push an item and pop an item (every thread uses the same queue)
+/*! \details The queue never runs dry because each thread pushes before it
+ * pops, so popTop never has to wait.
+ */
+static void BM_ThreadSafeQueue_pushBackPopTop( benchmark::State& state )
+{
+  int item = 0;
+
+  while( state.KeepRunning() )
+  {
+    s_queue.pushBack( item );
+    s_queue.popTop();
+
+    ++item;
+  }
+
+  state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( BM_ThreadSafeQueue_pushBackPopTop )
+->Threads( 1 )->Threads( 2 )->Threads( 4 )->Threads( 8 )->UseRealTime();
+
+//---------------------------------------------------------------------------//
+// end bmThreadSafeQueue.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,61 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   qtd1_benchmarks.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The benchmark main
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+
+// Google Benchmark Includes
+#include <benchmark/benchmark.h>
+
+// Qt Includes
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+
+// QtD1 Includes
+#include "SyntheticFixtures.h"
+#include "MPQHandler.h"
+
+//! Run the benchmarks
+/*! \details The synthetic archive replaces diabdat.mpq (it is created in
+ * the temp directory and removed when the benchmarks finish). Use
+ * --benchmark_out=<file> --benchmark_out_format=json to record the results.
+ */
+int main( int argc, char** argv )
+{
+  QApplication application( argc, argv );
+
+  const QString archive_file_name =
+    QDir::temp().filePath( "qtd1_benchmark_synthetic.mpq" );
+
+  if( !SyntheticFixtures::createArchive( archive_file_name ) )
+  {
+    std::cerr << "Error: The synthetic archive ("
+              << archive_file_name.toStdString()
+              << ") could not be created!" << std::endl;
+
+    return 1;
+  }
+
+  // Register the MPQHandler (with the synthetic archive) with the file
+  // engine system
+  QtD1::MPQHandler::setArchiveFileName( archive_file_name );
+  QtD1::MPQHandler::getInstance();
+
+  benchmark::Initialize( &argc, argv );
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  QFile::remove( archive_file_name );
+
+  return 0;
+}
+
+//---------------------------------------------------------------------------//
+// end qtd1_benchmarks.cpp
+//---------------------------------------------------------------------------//
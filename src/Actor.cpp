@@ -18,7 +18,9 @@ namespace QtD1{
 // Constructor
 Actor::Actor( QGraphicsObject* parent )
   : InteractiveLevelObject( parent ),
-    d_data( new ActorData )
+    d_data( new ActorData ),
+    d_previous_simulated_pos(),
+    d_simulated_pos()
 {
   this->connectActorDataSignalsToActorSlots();
 }
@@ -26,7 +28,9 @@ Actor::Actor( QGraphicsObject* parent )
 // Copy constructor
 Actor::Actor( const Actor& other_actor )
   : InteractiveLevelObject( other_actor.parentObject() ),
-    d_data( other_actor.d_data )
+    d_data( other_actor.d_data ),
+    d_previous_simulated_pos( other_actor.d_previous_simulated_pos ),
+    d_simulated_pos( other_actor.d_simulated_pos )
 {
   this->connectActorDataSignalsToActorSlots();
 }
@@ -34,7 +38,9 @@ Actor::Actor( const Actor& other_actor )
 // Constructor
 Actor::Actor( ActorData* data, QGraphicsObject* parent )
   : InteractiveLevelObject( parent ),
-    d_data( data )
+    d_data( data ),
+    d_previous_simulated_pos(),
+    d_simulated_pos()
 {
   this->connectActorDataSignalsToActorSlots();
 }
@@ -59,8 +65,13 @@ Actor& Actor::operator=( const Actor& other_actor )
 // Set the state of the actor
 void Actor::setState( const State state )
 {
+  const bool was_animated = this->isAnimated();
+  
   // Set the default sprite
   d_data->setActiveState( state );
+
+  if( this->isAnimated() != was_animated )
+    emit animationStateChanged( !was_animated );
 }
 
 // Get the state of the actor
@@ -90,7 +101,12 @@ void Actor::setLevel( const int level )
 // Set the state and direction of the actor
 void Actor::setStateAndDirection( const State state, const Direction direction )
 {
+  const bool was_animated = this->isAnimated();
+  
   d_data->setActiveStateAndDirection( state, direction );
+
+  if( this->isAnimated() != was_animated )
+    emit animationStateChanged( !was_animated );
 }
 
 // Get the level
@@ -390,7 +406,19 @@ QPainterPath Actor::shape() const
     return QPainterPath();
 }
 
+// Check if the actor must be advanced every simulation tick
+/*! \details Dead actors have nothing left to animate.
+ */
+bool Actor::isAnimated() const
+{
+  return d_data->getActiveState() != Actor::Dead;
+}
+
 // Advance the actor state
+/*! \details The actor will be placed at its new simulated position. Call
+ * Actor::interpolatePos before rendering to smooth out the movement when
+ * frames are rendered more often than the simulation is advanced.
+ */
 void Actor::advance( int phase )
 {
   // Phase 0: actor state is about to advance
@@ -400,12 +428,46 @@ void Actor::advance( int phase )
     if( d_data->getActiveSprite() )
     {
       d_data->getActiveSprite()->incrementFrame();
-      this->moveBy( d_data->getXVelocity(), d_data->getYVelocity() );
+
+      d_previous_simulated_pos = d_simulated_pos;
+      d_simulated_pos += QPointF( d_data->getXVelocity(),
+                                  d_data->getYVelocity() );
+
+      this->setPos( d_simulated_pos );
       this->update( d_data->getActiveSprite()->boundingRect() );
     }    
   }
 }
 
+// Set the simulated position of the actor (no interpolation)
+void Actor::setSimulatedPos( const QPointF& position )
+{
+  d_previous_simulated_pos = position;
+  d_simulated_pos = position;
+
+  this->setPos( position );
+}
+
+// Get the simulated position of the actor
+const QPointF& Actor::getSimulatedPos() const
+{
+  return d_simulated_pos;
+}
+
+// Place the actor between its last two simulated positions
+/*! \details A fraction of 0.0 will place the actor at its previous simulated
+ * position and a fraction of 1.0 will place it at its current simulated
+ * position.
+ */
+void Actor::interpolatePos( const qreal fraction )
+{
+  if( d_previous_simulated_pos != d_simulated_pos )
+  {
+    this->setPos( d_previous_simulated_pos +
+                  (d_simulated_pos - d_previous_simulated_pos)*fraction );
+  }
+}
+
 // Paint the actor
 void Actor::paintImpl( QPainter* painter,
                        const QStyleOptionGraphicsItem* option,
@@ -476,11 +538,11 @@ const ActorData* Actor::getActorData() const
 }
 
 // Set the actor sprites
-void Actor::setActorSprites(
-                  const std::shared_ptr<StateDirectionGameSpriteMap>& sprites )
+void Actor::setActorSprites( const std::shared_ptr<ActorSpriteTable>& sprites,
+                             const int sprite_set )
 {
   d_data->getSprites() = sprites;
-  d_data->updateActiveSprite();
+  d_data->setActiveSpriteSet( sprite_set );
 }
 
 // Connect actor data signals to actor slots
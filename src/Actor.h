@@ -21,6 +21,7 @@
 namespace QtD1{
 
 class ActorData;
+class ActorSpriteTable;
 
 /*! The actor base class
  *
@@ -67,13 +68,6 @@ public:
     Dead
   };
 
-  //! The directional sprites type
-  typedef QMap<Direction,GameSprite> DirectionGameSpriteMap;
-
-  //! The state sprites type
-  typedef QMap<Actor::State,std::shared_ptr<DirectionGameSpriteMap> >
-  StateDirectionGameSpriteMap;
-
   //! Constructor
   Actor( QGraphicsObject* parent = 0 );
 
@@ -249,9 +243,21 @@ public:
   //! Get the shape of the actor
   QPainterPath shape() const override;
 
+  //! Check if the actor must be advanced every simulation tick
+  bool isAnimated() const override;
+
   //! Advance the actor state
   void advance( int phase ) override;
 
+  //! Set the simulated position of the actor (no interpolation)
+  void setSimulatedPos( const QPointF& position );
+
+  //! Get the simulated position of the actor
+  const QPointF& getSimulatedPos() const;
+
+  //! Place the actor between its last two simulated positions
+  void interpolatePos( const qreal fraction );
+
   //! Clone the actor
   virtual Actor* clone( QGraphicsObject* parent = 0 ) const = 0;
 
@@ -304,8 +310,8 @@ protected:
   const ActorData* getActorData() const;
 
   //! Set the actor sprites
-  void setActorSprites(
-                 const std::shared_ptr<StateDirectionGameSpriteMap>& sprites );
+  void setActorSprites( const std::shared_ptr<ActorSpriteTable>& sprites,
+                        const int sprite_set = 0 );
 
   //! Paint the actor
   void paintImpl( QPainter* painter,
@@ -322,6 +328,12 @@ private:
 
   // The actor data
   std::shared_ptr<ActorData> d_data;
+
+  // The simulated position before the last tick
+  QPointF d_previous_simulated_pos;
+
+  // The simulated position after the last tick
+  QPointF d_simulated_pos;
 };
 
 } // end QtD1 namespace
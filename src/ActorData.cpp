@@ -28,6 +28,7 @@ ActorData::ActorData( QObject* parent )
     d_x_velocity( 0.0 ),
     d_y_velocity( 0.0 ),
     d_sprites(),
+    d_active_sprite_set( 0 ),
     d_active_sprite()
 { /* ... */ }
 
@@ -52,6 +53,7 @@ ActorData& ActorData::operator=( const ActorData& other )
 
     // Need to do a deep copy of the sprites
     d_sprites = other.d_sprites;
+    d_active_sprite_set = other.d_active_sprite_set;
     d_active_sprite = other.d_active_sprite;
   }
 
@@ -359,18 +361,32 @@ void ActorData::setVelocity( const qreal x_velocity, const qreal y_velocity )
   d_y_velocity = y_velocity;
 }
 
-// Get the state direction game sprite map
-auto ActorData::getSprites() -> std::shared_ptr<StateDirectionGameSpriteMap>&
+// Get the sprite table
+std::shared_ptr<ActorSpriteTable>& ActorData::getSprites()
 {
   return d_sprites;
 }
 
-// Get the state direction game sprite map
-auto ActorData::getSprites() const -> const std::shared_ptr<StateDirectionGameSpriteMap>&
+// Get the sprite table
+const std::shared_ptr<ActorSpriteTable>& ActorData::getSprites() const
 {
   return d_sprites;
 }
 
+// Get the active sprite set
+int ActorData::getActiveSpriteSet() const
+{
+  return d_active_sprite_set;
+}
+
+// Set the active sprite set
+void ActorData::setActiveSpriteSet( const int sprite_set )
+{
+  d_active_sprite_set = sprite_set;
+
+  this->updateActiveSprite();
+}
+
 // Get the active sprite
 GameSprite* ActorData::getActiveSprite()
 {
@@ -485,6 +501,10 @@ void ActorData::setMana( const int new_mana )
 }
 
 // Update the active sprite
+/*! \details The active sprite is looked up directly in the sprite table
+ * slots. If no sprite has been assigned to the active slot the active
+ * sprite will be NULL.
+ */
 void ActorData::updateActiveSprite()
 {
   Actor::State current_state = std::get<0>( d_active_sprite );
@@ -493,7 +513,9 @@ void ActorData::updateActiveSprite()
   if( d_sprites )
   {
     std::get<2>( d_active_sprite ) =
-      &(*(*d_sprites)[current_state])[current_direction];
+      d_sprites->getSprite( d_active_sprite_set,
+                            current_state,
+                            current_direction );
   }
   else
     std::get<2>( d_active_sprite ) = NULL;
@@ -18,6 +18,7 @@
 
 // QtD1 Includes
 #include "Actor.h"
+#include "ActorSpriteTable.h"
 #include "Direction.h"
 
 namespace QtD1{
@@ -29,12 +30,6 @@ class ActorData : public QObject
 
 public:
 
-  //! The directional sprites type
-  typedef Actor::DirectionGameSpriteMap DirectionGameSpriteMap;
-
-  //! The state sprites type
-  typedef Actor::StateDirectionGameSpriteMap StateDirectionGameSpriteMap;
-
   //! Constructor
   ActorData( QObject* parent = 0 );
 
@@ -186,11 +181,17 @@ public:
   //! Set the actor velocity
   void setVelocity( const qreal x_velocity, const qreal y_velocity );
 
-  //! Get the state direction game sprite map
-  std::shared_ptr<StateDirectionGameSpriteMap>& getSprites();
+  //! Get the sprite table
+  std::shared_ptr<ActorSpriteTable>& getSprites();
+
+  //! Get the sprite table
+  const std::shared_ptr<ActorSpriteTable>& getSprites() const;
 
-  //! Get the state direction game sprite map
-  const std::shared_ptr<StateDirectionGameSpriteMap>& getSprites() const;
+  //! Get the active sprite set
+  int getActiveSpriteSet() const;
+
+  //! Set the active sprite set
+  void setActiveSpriteSet( const int sprite_set );
 
   // Update active sprite
   void updateActiveSprite();
@@ -284,7 +285,10 @@ private:
   qreal d_y_velocity;
 
   // The actor sprites
-  std::shared_ptr<StateDirectionGameSpriteMap> d_sprites;
+  std::shared_ptr<ActorSpriteTable> d_sprites;
+
+  // The active sprite set
+  int d_active_sprite_set;
 
   // The active game sprite (active state, active direction, active sprite)
   std::tuple<Actor::State,Direction,GameSprite*> d_active_sprite;
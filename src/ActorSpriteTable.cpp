@@ -0,0 +1,182 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ActorSpriteTable.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The actor sprite table class definition
+//!
+//---------------------------------------------------------------------------//
+
+// QtD1 Includes
+#include "ActorSpriteTable.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int ActorSpriteTable::s_number_of_states;
+const int ActorSpriteTable::s_number_of_directions;
+const int ActorSpriteTable::s_no_sprite;
+
+// Constructor
+ActorSpriteTable::ActorSpriteTable( const int number_of_sprite_sets )
+  : d_stored_sprites(),
+    d_source_sprite_ids(),
+    d_source_sprite_counts(),
+    d_slots( number_of_sprite_sets*s_number_of_states*s_number_of_directions,
+             s_no_sprite )
+{
+  if( number_of_sprite_sets < 1 )
+  {
+    qFatal( "ActorSpriteTable Error: Invalid number of sprite sets (%i)!",
+            number_of_sprite_sets );
+  }
+}
+
+// Get the number of sprite sets
+int ActorSpriteTable::getNumberOfSpriteSets() const
+{
+  return d_slots.size()/(s_number_of_states*s_number_of_directions);
+}
+
+// Get the number of stored sprites
+int ActorSpriteTable::getNumberOfStoredSprites() const
+{
+  return d_stored_sprites.size();
+}
+
+// Find the first stored sprite created for a source asset
+/*! \details If no sprites have been created for the source asset
+ * s_no_sprite will be returned.
+ */
+int ActorSpriteTable::findStoredSprites( const QString& source ) const
+{
+  return d_source_sprite_ids.value( source, s_no_sprite );
+}
+
+// Create consecutive stored sprites for a source asset
+/*! \details The id of the first created sprite will be returned. If sprites
+ * have already been created for the source asset the id of the first
+ * existing sprite will be returned instead (a source asset is only ever
+ * stored once).
+ */
+int ActorSpriteTable::createStoredSprites( const QString& source,
+                                           const int number_of_sprites )
+{
+  const int existing_sprite_id = this->findStoredSprites( source );
+
+  if( existing_sprite_id != s_no_sprite )
+    return existing_sprite_id;
+
+  const int first_sprite_id = d_stored_sprites.size();
+
+  for( int i = 0; i < number_of_sprites; ++i )
+    d_stored_sprites.emplace_back();
+
+  d_source_sprite_ids[source] = first_sprite_id;
+  d_source_sprite_counts[source] = number_of_sprites;
+
+  return first_sprite_id;
+}
+
+// Get a stored sprite
+GameSprite& ActorSpriteTable::getStoredSprite( const int sprite_id )
+{
+  return d_stored_sprites[sprite_id];
+}
+
+// Get a stored sprite
+const GameSprite& ActorSpriteTable::getStoredSprite( const int sprite_id ) const
+{
+  return d_stored_sprites[sprite_id];
+}
+
+// Assign a stored sprite to a slot
+void ActorSpriteTable::assignSprite( const int sprite_set,
+                                     const Actor::State state,
+                                     const Direction direction,
+                                     const int sprite_id )
+{
+  d_slots[this->getSlotIndex( sprite_set, state, direction )] = sprite_id;
+}
+
+// Get the stored sprite id assigned to a slot
+int ActorSpriteTable::getSpriteId( const int sprite_set,
+                                   const Actor::State state,
+                                   const Direction direction ) const
+{
+  return d_slots[this->getSlotIndex( sprite_set, state, direction )];
+}
+
+// Get the sprite assigned to a slot
+/*! \details If no sprite has been assigned to the slot NULL will be returned.
+ */
+GameSprite* ActorSpriteTable::getSprite( const int sprite_set,
+                                         const Actor::State state,
+                                         const Direction direction )
+{
+  const int sprite_id = this->getSpriteId( sprite_set, state, direction );
+
+  if( sprite_id != s_no_sprite )
+    return &d_stored_sprites[sprite_id];
+  else
+    return NULL;
+}
+
+// Get the sprite assigned to a slot
+const GameSprite* ActorSpriteTable::getSprite( const int sprite_set,
+                                               const Actor::State state,
+                                               const Direction direction ) const
+{
+  const int sprite_id = this->getSpriteId( sprite_set, state, direction );
+
+  if( sprite_id != s_no_sprite )
+    return &d_stored_sprites[sprite_id];
+  else
+    return NULL;
+}
+
+// Dump the assets of all stored sprites
+void ActorSpriteTable::dumpAssets()
+{
+  std::deque<GameSprite>::iterator sprite_it, sprite_end;
+  sprite_it = d_stored_sprites.begin();
+  sprite_end = d_stored_sprites.end();
+
+  while( sprite_it != sprite_end )
+  {
+    sprite_it->dumpAsset();
+
+    ++sprite_it;
+  }
+}
+
+// Dump the assets of the stored sprites created for a source asset
+/*! \details The stored sprites and the slots that refer to them are kept so
+ * that the source asset can be reloaded later.
+ */
+void ActorSpriteTable::dumpAssets( const QString& source )
+{
+  const int first_sprite_id = this->findStoredSprites( source );
+
+  if( first_sprite_id != s_no_sprite )
+  {
+    const int number_of_sprites = d_source_sprite_counts.value( source );
+
+    for( int i = 0; i < number_of_sprites; ++i )
+      d_stored_sprites[first_sprite_id+i].dumpAsset();
+  }
+}
+
+// Get the slot index
+int ActorSpriteTable::getSlotIndex( const int sprite_set,
+                                    const Actor::State state,
+                                    const Direction direction ) const
+{
+  return (sprite_set*s_number_of_states + state)*s_number_of_directions +
+    direction;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end ActorSpriteTable.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,129 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ActorSpriteTable.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The actor sprite table class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef ACTOR_SPRITE_TABLE_H
+#define ACTOR_SPRITE_TABLE_H
+
+// Std Lib Includes
+#include <deque>
+
+// Qt Includes
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+// QtD1 Includes
+#include "Actor.h"
+#include "Direction.h"
+#include "GameSprite.h"
+
+namespace QtD1{
+
+/*! The actor sprite table
+ *
+ * The table stores the unique sprites of an actor (one sprite per source
+ * asset and direction) and a flat slot table that maps a packed
+ * (sprite set, actor state, direction) key to a stored sprite. A sprite set
+ * is a group of state-direction slots that is selected by the owner of the
+ * table (e.g. a character selects a set from its spell, weapon and armor
+ * states). Several slots can refer to the same stored sprite, which removes
+ * the need to copy sprites between sets. Sprite lookups are O(1).
+ */
+class ActorSpriteTable
+{
+
+public:
+
+  //! The number of actor states
+  static const int s_number_of_states = Actor::Dead + 1;
+
+  //! The number of directions
+  static const int s_number_of_directions = SouthSoutheast + 1;
+
+  //! The id of a slot that has no sprite
+  static const int s_no_sprite = -1;
+
+  //! Constructor
+  ActorSpriteTable( const int number_of_sprite_sets = 1 );
+
+  //! Destructor
+  ~ActorSpriteTable()
+  { /* ... */ }
+
+  //! Get the number of sprite sets
+  int getNumberOfSpriteSets() const;
+
+  //! Get the number of stored sprites
+  int getNumberOfStoredSprites() const;
+
+  //! Find the first stored sprite created for a source asset
+  int findStoredSprites( const QString& source ) const;
+
+  //! Create consecutive stored sprites for a source asset
+  int createStoredSprites( const QString& source, const int number_of_sprites );
+
+  //! Get a stored sprite
+  GameSprite& getStoredSprite( const int sprite_id );
+
+  //! Get a stored sprite
+  const GameSprite& getStoredSprite( const int sprite_id ) const;
+
+  //! Assign a stored sprite to a slot
+  void assignSprite( const int sprite_set,
+                     const Actor::State state,
+                     const Direction direction,
+                     const int sprite_id );
+
+  //! Get the stored sprite id assigned to a slot
+  int getSpriteId( const int sprite_set,
+                   const Actor::State state,
+                   const Direction direction ) const;
+
+  //! Get the sprite assigned to a slot
+  GameSprite* getSprite( const int sprite_set,
+                         const Actor::State state,
+                         const Direction direction );
+
+  //! Get the sprite assigned to a slot
+  const GameSprite* getSprite( const int sprite_set,
+                               const Actor::State state,
+                               const Direction direction ) const;
+
+  //! Dump the assets of all stored sprites
+  void dumpAssets();
+
+  //! Dump the assets of the stored sprites created for a source asset
+  void dumpAssets( const QString& source );
+
+private:
+
+  // Get the slot index
+  int getSlotIndex( const int sprite_set,
+                    const Actor::State state,
+                    const Direction direction ) const;
+
+  // The stored sprites (a deque keeps the sprite addresses stable)
+  std::deque<GameSprite> d_stored_sprites;
+
+  // The first stored sprite id of each source asset
+  QHash<QString,int> d_source_sprite_ids;
+
+  // The number of stored sprites of each source asset
+  QHash<QString,int> d_source_sprite_counts;
+
+  // The slots (stored sprite ids)
+  QVector<int> d_slots;
+};
+
+} // end QtD1 namespace
+
+#endif // end ACTOR_SPRITE_TABLE_H
+
+//---------------------------------------------------------------------------//
+// end ActorSpriteTable.h
+//---------------------------------------------------------------------------//
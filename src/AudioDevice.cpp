@@ -8,6 +8,8 @@
 
 // QtD1 includes
 #include "AudioDevice.h"
+#include "MusicStreamer.h"
+#include "SoftwareMixer.h"
 
 namespace QtD1{
 
@@ -15,6 +17,7 @@ namespace QtD1{
 std::unique_ptr<AudioDevice> AudioDevice::s_instance;
 const int AudioDevice::s_first_free_unreserved_channel = -1;
 const int AudioDevice::s_infinite_looping = -1;
+const int AudioDevice::s_default_number_of_mixer_channels = 32;
 
 // Get the singleton instance
 AudioDevice& AudioDevice::getInstance()
@@ -37,6 +40,15 @@ int AudioDevice::infiniteLooping()
   return s_infinite_looping;
 }
 
+// Get the default number of mixer channels
+/*! \details The sound bank voices are the mixer channels. There must be
+ * enough of them that busy scenes rarely have to steal a voice.
+ */
+int AudioDevice::getDefaultNumberOfMixerChannels()
+{
+  return s_default_number_of_mixer_channels;
+}
+
 // Constructor
 AudioDevice::AudioDevice()
   : d_device_open( false ),
@@ -96,13 +108,21 @@ void AudioDevice::open( int frequency,
     d_number_of_mixer_channels = Mix_AllocateChannels( mix_channels );
 
     d_device_open = true;
+
+    // Reopening the audio device unregisters the software mixer
+    if( SoftwareMixer::getInstance()->isEnabled() )
+      SoftwareMixer::getInstance()->enable();
   }
 }
 
 // Open the audio device with default settings
 void AudioDevice::open()
 {
-  this->open( 44100, AUDIO_S16SYS, 2, 2048, 10 );
+  this->open( 44100,
+              AUDIO_S16SYS,
+              2,
+              2048,
+              AudioDevice::getDefaultNumberOfMixerChannels() );
 }
 
 // Close the audio device
@@ -164,6 +184,15 @@ int AudioDevice::setMixerChannelVolume( int channel, int volume )
   return Mix_Volume( channel, volume );
 }
 
+// Set the distance of a mixer channel (0 = near, 255 = far)
+/*! \details The distance effect stays registered until the distance is
+ * reset to 0.
+ */
+bool AudioDevice::setMixerChannelDistance( int channel, Uint8 distance )
+{
+  return Mix_SetDistance( channel, distance ) != 0;
+}
+
 // Check if a mixer channel is paused
 bool AudioDevice::isMixerChannelPaused( int channel ) const
 {
@@ -347,9 +376,13 @@ Mix_Fading AudioDevice::isMusicFading() const
 }
 
 // Set the music volume
+/*! \details The volume of the streamed music is set too.
+ */
 void AudioDevice::setMusicVolume( int volume )
 {
   Mix_VolumeMusic( volume );
+
+  MusicStreamer::getInstance()->setVolume( volume );
 }
 
 // Play the music
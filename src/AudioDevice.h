@@ -38,6 +38,9 @@ public:
   //! Set infinite looping
   static int infiniteLooping();
 
+  //! Get the default number of mixer channels
+  static int getDefaultNumberOfMixerChannels();
+
   //! Destructor
   ~AudioDevice();
 
@@ -49,7 +52,8 @@ public:
              SDL_AudioFormat format,
              int audio_channels,
              int chunksize,
-             int mix_channels = 8 );
+             int mix_channels =
+             AudioDevice::getDefaultNumberOfMixerChannels() );
 
   //! Open the audio device with default settings
   void open();
@@ -81,6 +85,9 @@ public:
   //! Set the volume of a mixer channel
   int setMixerChannelVolume( int channel, int volume );
 
+  //! Set the distance of a mixer channel (0 = near, 255 = far)
+  bool setMixerChannelDistance( int channel, Uint8 distance );
+
   //! Check if a mixer channel is paused
   bool isMixerChannelPaused( int channel ) const;
 
@@ -232,6 +239,9 @@ private:
   // Use to indicate infinite looping
   static const int s_infinite_looping;
 
+  // The default number of mixer channels
+  static const int s_default_number_of_mixer_channels;
+
   // Is the device open?
   bool d_device_open;
 
@@ -16,6 +16,7 @@
 // QtD1 Includes
 #include "AudioStream.h"
 #include "AudioDevice.h"
+#include "Telemetry.h"
 
 namespace QtD1{
 
@@ -276,6 +277,13 @@ int AudioStream::getRequiredNumberOfSamples( const AVFrameWrapper& frame )
     expected_display_time -
     std::chrono::duration<double>(d_sync_timer->elapsed()/1000.0);
 
+  // Record the drift from the sync clock (the video is synched to it too)
+  const qint64 drift = (qint64)(time_diff.count()*1e6);
+
+  Telemetry::setCounter( Telemetry::AudioVideoDriftCounter, drift );
+  Telemetry::addSample( Telemetry::AudioVideoDriftHistogram,
+                        drift < 0 ? -drift : drift );
+
   // Check if the time difference is small enough to recalculate the samples
   if( fabs( time_diff.count() ) < d_audio_sync_data.s_audio_sync_threshold.count() )
   {
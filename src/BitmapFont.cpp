@@ -14,46 +14,69 @@
 
 // QtD1 includes
 #include "BitmapFont.h"
-#include "MenuSprite.h"
+#include "PCXFrameLoader.h"
+#include "CelFrameLoader.h"
 
 namespace QtD1{
 
 // Default Constructor
 BitmapFont::BitmapFont()
-  : d_glyph_map()
+  : d_glyph_images(),
+    d_glyph_map()
 { /* ... */ }
 
 // Construct with filename and widths
+/*! \details Only QImages are created so the font can be constructed on a
+ * worker thread. The glyph pixmaps are created by createGlyphPixmaps.
+ */
 BitmapFont::BitmapFont( const QString& source, const QVector<int>& widths )
-  : d_glyph_map()
+  : d_glyph_images(),
+    d_glyph_map()
 {
-  // Extract the frames and set the glyph map
-  MenuSprite glyph_sprite;
-  glyph_sprite.setSource( source );
-  glyph_sprite.setBackgroundColor( "#00ff00" );
-  glyph_sprite.setNumberOfRows( 256 );
-  glyph_sprite.setNumberOfCols( 1 );
-  glyph_sprite.loadSync();
-
-  glyph_sprite.getFrames( d_glyph_map );
+  // Extract the frames and set the glyph images
+  PCXFrameLoader glyph_loader;
+  glyph_loader.setSource( source );
+  glyph_loader.setTransparentColor( "#00ff00" );
+  glyph_loader.setNumberOfRows( 256 );
+  glyph_loader.setNumberOfCols( 1 );
+
+  d_glyph_images = *glyph_loader.decodeFrames();
   this->resetGlyphWidths( widths );
 }
 
 // Constructor with filename, widths and orders
+/*! \details Only QImages are created so the font can be constructed on a
+ * worker thread. The glyph pixmaps are created by createGlyphPixmaps.
+ */
 BitmapFont::BitmapFont( const QString& source,
                         const QVector<int>& widths,
                         const QVector<int>& order )
-  : d_glyph_map()
+  : d_glyph_images(),
+    d_glyph_map()
 {
-  // Extract the frames and set the glyph map
-  MenuSprite glyph_sprites;
-  glyph_sprites.setSource( source );
-  glyph_sprites.setDisplayedFrameIndices( "all" );
-  glyph_sprites.loadSync();
-
-  QVector<QPixmap> raw_glyphs;
-  glyph_sprites.getFrames( raw_glyphs );
-  this->resetGlyphWidthsAndOrder( raw_glyphs, widths, order );
+  // Extract the frames and set the glyph images
+  CelFrameLoader glyph_loader;
+  glyph_loader.setSource( source );
+
+  ImageAssetCache::AssetHandle raw_glyphs = glyph_loader.decodeFrames();
+  this->resetGlyphWidthsAndOrder( *raw_glyphs, widths, order );
+}
+
+// Create the glyph pixmaps (must be called from the GUI thread)
+/*! \details Calling this method more than once has no effect.
+ */
+void BitmapFont::createGlyphPixmaps()
+{
+  if( d_glyph_map.size() == d_glyph_images.size() )
+    return;
+
+  d_glyph_map.resize( d_glyph_images.size() );
+
+  for( int i = 0; i < d_glyph_images.size(); ++i )
+  {
+    if( !d_glyph_images[i].isNull() )
+      d_glyph_map[i] = QPixmap::fromImage( d_glyph_images[i] );
+  }
 }
 
 // Check if the character has an associated glyph
@@ -62,7 +85,7 @@ bool BitmapFont::doesCharHaveGlyph( const char character ) const
   // Convert the char to an unsigned
   uchar glyph_index = (uchar)character;
 
-  if( d_glyph_map[glyph_index].isNull() )
+  if( d_glyph_images[glyph_index].isNull() )
     return false;
   else
     return true;
@@ -74,6 +97,12 @@ QPixmap BitmapFont::getGlyph( const char character ) const
   // Convert the char to an unsigned
   uchar glyph_index = (uchar)character;
 
+  if( d_glyph_map.isEmpty() )
+  {
+    qWarning( "BitmapFont Warning: The glyph pixmaps have not been created!" );
+    return QPixmap();
+  }
+
   return d_glyph_map[glyph_index];
 }
 
@@ -83,7 +112,7 @@ int BitmapFont::getGlyphWidth( const char character ) const
   // Convert the char to an unsigned
   uchar glyph_index = (uchar)character;
 
-  return d_glyph_map[glyph_index].width();
+  return d_glyph_images[glyph_index].width();
 }
 
 // Reset the widths of each character in the glyph map
@@ -93,20 +122,20 @@ void BitmapFont::resetGlyphWidths( const QVector<int>& widths )
   {
     if( widths[i] > 0 )
     {
-      d_glyph_map[i] =
-        d_glyph_map[i].copy( 0, 0, widths[i], d_glyph_map[i].height() );
+      d_glyph_images[i] =
+        d_glyph_images[i].copy( 0, 0, widths[i], d_glyph_images[i].height() );
     }
     else
-      d_glyph_map[i] = QPixmap();
+      d_glyph_images[i] = QImage();
   }
 }
 
 // Reset the glyph widths and order
-void BitmapFont::resetGlyphWidthsAndOrder( const QVector<QPixmap>& raw_glyphs,
+void BitmapFont::resetGlyphWidthsAndOrder( const QVector<QImage>& raw_glyphs,
                                            const QVector<int>& widths,
                                            const QVector<int>& order )
 {
-  d_glyph_map.resize( 256 );
+  d_glyph_images.resize( 256 );
 
   int height = raw_glyphs.front().height();
 
@@ -116,15 +145,16 @@ void BitmapFont::resetGlyphWidthsAndOrder( const QVector<QPixmap>& raw_glyphs,
     {
       if( order[i] >= 0 )
       {
-        d_glyph_map[i] = raw_glyphs[order[i]].copy( 0, 0, widths[i], height );
+        d_glyph_images[i] =
+          raw_glyphs[order[i]].copy( 0, 0, widths[i], height );
       }
       // A transparent image needs to be created
       else
       {
-        QPixmap trans_image( widths[i], height );
+        QImage trans_image( widths[i], height, QImage::Format_ARGB32 );
         trans_image.fill( Qt::transparent );
 
-        d_glyph_map[i] = trans_image;
+        d_glyph_images[i] = trans_image;
       }
     }
   }
@@ -11,6 +11,7 @@
 
 // Qt Includes
 #include <QPixmap>
+#include <QImage>
 #include <QVector>
 #include <QString>
 #include <QColor>
@@ -44,10 +45,13 @@ public:
   //! Return the font size
   virtual int getSize() const = 0;
 
+  //! Create the glyph pixmaps (must be called from the GUI thread)
+  void createGlyphPixmaps();
+
   //! Check if the character has an associated glyph
   bool doesCharHaveGlyph( const char character ) const;
 
-  //! Return the glyph associated with the character
+  //! Return the glyph associated with the character (see createGlyphPixmaps)
   QPixmap getGlyph( const char character ) const;
 
   //! Return the width of the glyph associated with the character
@@ -59,10 +63,13 @@ private:
   void resetGlyphWidths( const QVector<int>& widths );
 
   // Reset the glyph widths and order
-  void resetGlyphWidthsAndOrder( const QVector<QPixmap>& raw_glyphs,
+  void resetGlyphWidthsAndOrder( const QVector<QImage>& raw_glyphs,
                                  const QVector<int>& widths,
                                  const QVector<int>& order );
 
+  // The glyph images
+  QVector<QImage> d_glyph_images;
+
   // The glyph map
   QVector<QPixmap> d_glyph_map;
 };
@@ -323,6 +323,37 @@ void BitmapText::loadStandardFonts()
   QtD1::BitmapText::registerFont<QtD1::Gold45BitmapFont>( "QtD1Gold45" );
 }
 
+// Add the standard font decoding tasks to a parallel initializer
+/*! \details Every font is decoded to QImages by its own task. The fonts must
+ * still be registered on the GUI thread (see loadStandardFonts) once the tasks
+ * have finished, which creates the glyph pixmaps.
+ */
+void BitmapText::addStandardFontTasks( ParallelInitializer& initializer )
+{
+  initializer.addTask( "Decode font QtD1White11",
+                       &BitmapText::createFont<QtD1::White11BitmapFont> );
+  initializer.addTask( "Decode font QtD1Gold16",
+                       &BitmapText::createFont<QtD1::Gold16BitmapFont> );
+  initializer.addTask( "Decode font QtD1Silver16",
+                       &BitmapText::createFont<QtD1::Silver16BitmapFont> );
+  initializer.addTask( "Decode font QtD1Gold22",
+                       &BitmapText::createFont<QtD1::Gold22BitmapFont> );
+  initializer.addTask( "Decode font QtD1Gold24",
+                       &BitmapText::createFont<QtD1::Gold24BitmapFont> );
+  initializer.addTask( "Decode font QtD1Silver24",
+                       &BitmapText::createFont<QtD1::Silver24BitmapFont> );
+  initializer.addTask( "Decode font QtD1Gold30",
+                       &BitmapText::createFont<QtD1::Gold30BitmapFont> );
+  initializer.addTask( "Decode font QtD1Silver30",
+                       &BitmapText::createFont<QtD1::Silver30BitmapFont> );
+  initializer.addTask( "Decode font QtD1Gold42",
+                       &BitmapText::createFont<QtD1::Gold42BitmapFont> );
+  initializer.addTask( "Decode font QtD1Silver42",
+                       &BitmapText::createFont<QtD1::Silver42BitmapFont> );
+  initializer.addTask( "Decode font QtD1Gold45",
+                       &BitmapText::createFont<QtD1::Gold45BitmapFont> );
+}
+
 QML_REGISTER_TYPE( BitmapText );
 
 } // end QtD1 namespace
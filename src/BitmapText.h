@@ -21,6 +21,7 @@
 // QtD1 Includes
 #include "BitmapFont.h"
 #include "Viewport.h"
+#include "ParallelInitializer.h"
 #include "QMLRegistrationHelper.h"
 
 namespace QtD1{
@@ -117,13 +118,16 @@ public:
               const QStyleOptionGraphicsItem* option,
               QWidget* widget = 0 ) override;
 
-  //! Register the font
+  //! Register the font (must be called from the GUI thread)
   template<typename FontClass>
   static void registerFont( const QString& font_alias );
 
   //! Load standard fonts
   static void loadStandardFonts();
 
+  //! Add the standard font decoding tasks to a parallel initializer
+  static void addStandardFontTasks( ParallelInitializer& initializer );
+
 public slots:
 
   // Load the text bitmap
@@ -131,6 +135,10 @@ public slots:
 
 private:
 
+  // Create the font (only the glyph images are decoded)
+  template<typename FontClass>
+  static void createFont();
+
   // The registered fonts
   static std::map<QString,BitmapFont*> s_registered_fonts;
 
@@ -164,12 +172,26 @@ private:
 
 // Register the font
 /*! \details Using an alias again will override any previously set fonts
- * registered with that alias. All font classes must be singletons.
+ * registered with that alias. All font classes must be singletons. The
+ * glyph pixmaps of the font are created here.
  */
 template<typename FontClass>
 inline void BitmapText::registerFont( const QString& font_alias )
 {
-  s_registered_fonts[font_alias] = FontClass::getInstance();
+  FontClass* font = FontClass::getInstance();
+  font->createGlyphPixmaps();
+
+  s_registered_fonts[font_alias] = font;
+}
+
+// Create the font (only the glyph images are decoded)
+/*! \details This can be called from a worker thread. The glyph pixmaps are
+ * created when the font is registered.
+ */
+template<typename FontClass>
+inline void BitmapText::createFont()
+{
+  FontClass::getInstance();
 }
 
 } // end QtD1 namespace
@@ -14,13 +14,14 @@
 #include <QColor>
 #include <QDataStream>
 #include <QImage>
+#include <QFile>
 
 // QtD1 Includes
 #include "CelHandler.h"
 #include "MPQHandler.h"
 #include "CustomMPQFileHeader.h"
 #include "CelDecoder.h"
-#include "CelPalette.h"
+#include "CelPaletteRegistry.h"
 
 namespace QtD1{
 
@@ -106,8 +107,16 @@ bool CelHandler::jumpToNextImage()
 }
 
 // Load the image frames from the device
+/*! \details If the device is an mpq file the cel image data and the
+ * palette data will be taken directly from the parts of the compound asset.
+ * Otherwise the device will be read and the custom header will be used to
+ * split the file data.
+ */
 void CelHandler::loadImageFrames()
 {
+  if( this->loadImageFramesFromCompoundAsset() )
+    return;
+  
   // Open the device
   if( !this->device()->isOpen() )
     this->device()->open( QIODevice::ReadOnly );
@@ -167,12 +176,75 @@ void CelHandler::loadImageFrames()
   QByteArray palette_data( file_data.data()+palette_data_start_index,
                            palette_file_size );
   
-  // Decode the cel image data
-  CelPalette palette( palette_file_name, palette_data );
+  this->decodeImageFrames( cel_file_name,
+                           cel_image_data,
+                           palette_file_name,
+                           palette_data );
+}
+
+// Load the image frames from a compound asset
+/*! \details The part data is implicitly shared with the mpq file engine so
+ * no file data will be read or copied. If the device is not an mpq file
+ * false will be returned.
+ */
+bool CelHandler::loadImageFramesFromCompoundAsset()
+{
+  QFile* file_device = dynamic_cast<QFile*>( this->device() );
+
+  if( !file_device )
+    return false;
+
+  MPQFileEngine* file_engine =
+    dynamic_cast<MPQFileEngine*>( file_device->fileEngine() );
+
+  if( !file_engine )
+    return false;
+
+  const CompoundAsset& asset = file_engine->getCompoundAsset();
+
+  if( asset.getNumberOfParts() != 2 )
+    return false;
+
+  int cel_part = asset.findPart( ".cel" );
+
+  if( cel_part < 0 )
+    cel_part = asset.findPart( ".cl2" );
+
+  if( cel_part < 0 )
+  {
+    qFatal( "CelHandler Error: the compound asset %s does not have a cel "
+            "part!",
+            file_device->fileName().toStdString().c_str() );
+  }
+
+  const int palette_part = 1 - cel_part;
+  
+  this->decodeImageFrames( asset.getPartFileName( cel_part ),
+                           asset.getPartData( cel_part ),
+                           asset.getPartFileName( palette_part ),
+                           asset.getPartData( palette_part ) );
+
+  return true;
+}
+
+// Decode the image frames
+void CelHandler::decodeImageFrames( const QString& cel_file_name,
+                                    const QByteArray& cel_image_data,
+                                    const QString& palette_file_name,
+                                    const QByteArray& palette_data )
+{
+  // The palette is only parsed the first time that it is requested - every
+  // frame that is decoded with it shares its color table
+  CelPaletteRegistry::PaletteHandle palette =
+    CelPaletteRegistry::getInstance()->getPalette( palette_file_name,
+                                                   palette_data );
+
+  // The decoder only reads the (implicitly shared) data
+  QByteArray shared_cel_image_data = cel_image_data;
 
-  CelDecoder decoder( cel_file_name, cel_image_data );
+  CelDecoder decoder( cel_file_name, shared_cel_image_data );
 
-  decoder.decode( d_image_frames, palette );
+  decoder.decode( d_image_frames, *palette );
 }
 
 // Check if the handler can read from the device
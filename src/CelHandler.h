@@ -56,6 +56,15 @@ public:
 
 private:
 
+  // Load the image frames from a compound asset
+  bool loadImageFramesFromCompoundAsset();
+
+  // Decode the image frames
+  void decodeImageFrames( const QString& cel_file_name,
+                          const QByteArray& cel_image_data,
+                          const QString& palette_file_name,
+                          const QByteArray& palette_data );
+
   // The image frames
   QVector<QImage> d_image_frames;
 
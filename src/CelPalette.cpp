@@ -9,6 +9,7 @@
 // Std Lib Includes
 #include <iostream>
 #include <memory>
+#include <cmath>
 
 // Qt Includes
 #include <QDataStream>
@@ -43,7 +44,8 @@ CelPalette::CelPalette( const QString& file_name,
                         const QByteArray& palette_data )
   : d_file_name( file_name ),
     d_palette_colors( 256 ),
-    d_palette_rgbs( 256 )
+    d_palette_rgbs( 256 ),
+    d_transparent_color_key( 0 )
 {
   QBuffer buffer;
   buffer.setData( palette_data );
@@ -52,6 +54,80 @@ CelPalette::CelPalette( const QString& file_name,
   this->extractPalette( buffer );
 }
 
+// Constructor (translated palette)
+/*! \details A translation (.trn) maps every key to a key of the base
+ * palette (e.g. to recolor a monster). The transparent color is never
+ * translated. The palette keeps the name of the base palette so that it is
+ * compatible with the same images.
+ */
+CelPalette::CelPalette( const CelPalette& base_palette,
+                        const QByteArray& translation_data )
+  : d_file_name( base_palette.getName() ),
+    d_palette_colors( 256 ),
+    d_palette_rgbs( 256 ),
+    d_transparent_color_key( base_palette.getTransparentColorKey() )
+{
+  if( translation_data.size() < 256 )
+  {
+    qFatal( "CelPalette Error: The translation of palette %s has an invalid "
+            "size (%i < 256)!",
+            d_file_name.toStdString().c_str(),
+            translation_data.size() );
+  }
+
+  for( int i = 0; i < 256; ++i )
+  {
+    if( i == d_transparent_color_key )
+      this->setColor( i, base_palette[i] );
+    else
+      this->setColor( i, base_palette[(quint8)translation_data[i]] );
+  }
+}
+
+// Constructor (gamma corrected palette)
+/*! \details Each color channel c is mapped to 255*(c/255)^gamma. The
+ * transparent color is never corrected. The palette keeps the name of the
+ * base palette so that it is compatible with the same images.
+ */
+CelPalette::CelPalette( const CelPalette& base_palette,
+                        const double gamma )
+  : d_file_name( base_palette.getName() ),
+    d_palette_colors( 256 ),
+    d_palette_rgbs( 256 ),
+    d_transparent_color_key( base_palette.getTransparentColorKey() )
+{
+  if( gamma <= 0.0 )
+  {
+    qFatal( "CelPalette Error: The gamma (%f) of palette %s must be "
+            "positive!",
+            gamma,
+            d_file_name.toStdString().c_str() );
+  }
+
+  // Create the channel lookup table
+  int channel_table[256];
+
+  for( int i = 0; i < 256; ++i )
+  {
+    channel_table[i] =
+      qBound( 0, (int)(255.0*std::pow( i/255.0, gamma ) + 0.5), 255 );
+  }
+
+  for( int i = 0; i < 256; ++i )
+  {
+    const QColor& color = base_palette[i];
+
+    if( i == d_transparent_color_key )
+      this->setColor( i, color );
+    else
+    {
+      this->setColor( i, QColor( channel_table[color.red()],
+                                 channel_table[color.green()],
+                                 channel_table[color.blue()] ) );
+    }
+  }
+}
+
 // Validate the palette file name
 void CelPalette::validatePaletteFileName( const QString& file_name )
 {
@@ -96,14 +172,12 @@ void CelPalette::extractPalette( QIODevice& device )
 
     if( r == 255 && g == 255 && b == 255 )
     {
-      d_palette_colors[i] = Qt::transparent;
+      this->setColor( i, Qt::transparent );
       d_transparent_color_key = i;
       trans_color_found = true;
     }
     else
-      d_palette_colors[i] = QColor( r, g, b );
-    
-    d_palette_rgbs[i] = d_palette_colors[i].rgba();
+      this->setColor( i, QColor( r, g, b ) );
   }
 
   if( !trans_color_found )
@@ -113,6 +187,13 @@ void CelPalette::extractPalette( QIODevice& device )
   }
 }
   
+// Set a palette color
+void CelPalette::setColor( const int key, const QColor& color )
+{
+  d_palette_colors[key] = color;
+  d_palette_rgbs[key] = color.rgba();
+}
+
 // Get the palette name
 const QString& CelPalette::getName() const
 {
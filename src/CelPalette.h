@@ -29,6 +29,14 @@ public:
   CelPalette( const QString& file_name,
               const QByteArray& palette_data );
 
+  //! Constructor (translated palette)
+  CelPalette( const CelPalette& base_palette,
+              const QByteArray& translation_data );
+
+  //! Constructor (gamma corrected palette)
+  CelPalette( const CelPalette& base_palette,
+              const double gamma );
+
   //! Destructor
   ~CelPalette()
   { /* ... */ }
@@ -59,6 +67,9 @@ private:
   // Extract the palette from the device
   void extractPalette( QIODevice& device );
 
+  // Set a palette color
+  void setColor( const int key, const QColor& color );
+
   // The palette file name
   QString d_file_name;
 
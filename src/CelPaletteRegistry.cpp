@@ -0,0 +1,253 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   CelPaletteRegistry.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The cel palette registry class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QFile>
+#include <QMutexLocker>
+
+// QtD1 Includes
+#include "CelPaletteRegistry.h"
+
+namespace QtD1{
+
+// Initialize static member data
+std::unique_ptr<CelPaletteRegistry> CelPaletteRegistry::s_instance;
+QMutex CelPaletteRegistry::s_instance_mutex;
+
+// Get the singleton instance
+/*! \details The instance can be requested by any thread.
+ */
+CelPaletteRegistry* CelPaletteRegistry::getInstance()
+{
+  QMutexLocker instance_locker( &s_instance_mutex );
+
+  // Just-in-time initialization
+  if( !s_instance )
+    s_instance.reset( new CelPaletteRegistry );
+
+  return s_instance.get();
+}
+
+// Constructor
+CelPaletteRegistry::CelPaletteRegistry()
+  : d_mutex(),
+    d_palettes(),
+    d_hits( 0 ),
+    d_misses( 0 )
+{ /* ... */ }
+
+// Get a palette (it will only be parsed if it has not been interned)
+/*! \details The palette is parsed without holding the registry lock so
+ * that other palettes can be requested while it is being parsed.
+ */
+CelPaletteRegistry::PaletteHandle CelPaletteRegistry::getPalette(
+                                           const QString& palette_file_name )
+{
+  const QString interned_name =
+    CelPaletteRegistry::getInternedName( palette_file_name );
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    PaletteHandle palette = this->findImpl( interned_name );
+
+    if( palette )
+      return palette;
+  }
+
+  return this->intern( interned_name,
+                       PaletteHandle( new CelPalette( interned_name ) ) );
+}
+
+// Get a palette (the extracted data is only parsed if not interned)
+CelPaletteRegistry::PaletteHandle CelPaletteRegistry::getPalette(
+                                            const QString& palette_file_name,
+                                            const QByteArray& palette_data )
+{
+  const QString interned_name =
+    CelPaletteRegistry::getInternedName( palette_file_name );
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    PaletteHandle palette = this->findImpl( interned_name );
+
+    if( palette )
+      return palette;
+  }
+
+  return this->intern(
+             interned_name,
+             PaletteHandle( new CelPalette( interned_name, palette_data ) ) );
+}
+
+// Get a translated palette
+/*! \details The base palette is interned too.
+ */
+CelPaletteRegistry::PaletteHandle CelPaletteRegistry::getTranslatedPalette(
+                                       const QString& palette_file_name,
+                                       const QString& translation_file_name )
+{
+  const QString interned_name =
+    QString( "%1|%2" )
+    .arg( CelPaletteRegistry::getInternedName( palette_file_name ) )
+    .arg( CelPaletteRegistry::getInternedName( translation_file_name ) );
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    PaletteHandle palette = this->findImpl( interned_name );
+
+    if( palette )
+      return palette;
+  }
+
+  PaletteHandle base_palette = this->getPalette( palette_file_name );
+
+  return this->intern(
+         interned_name,
+         PaletteHandle( new CelPalette(
+                 *base_palette,
+                 CelPaletteRegistry::readFile( translation_file_name ) ) ) );
+}
+
+// Get a gamma corrected palette
+/*! \details The base palette is interned too.
+ */
+CelPaletteRegistry::PaletteHandle
+CelPaletteRegistry::getGammaCorrectedPalette(
+                                            const QString& palette_file_name,
+                                            const double gamma )
+{
+  const QString interned_name =
+    QString( "%1?gamma=%2" )
+    .arg( CelPaletteRegistry::getInternedName( palette_file_name ) )
+    .arg( gamma );
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    PaletteHandle palette = this->findImpl( interned_name );
+
+    if( palette )
+      return palette;
+  }
+
+  PaletteHandle base_palette = this->getPalette( palette_file_name );
+
+  return this->intern( interned_name,
+                       PaletteHandle( new CelPalette( *base_palette,
+                                                      gamma ) ) );
+}
+
+// Get the number of interned palettes
+int CelPaletteRegistry::getNumberOfPalettes() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_palettes.size();
+}
+
+// Get the number of palette requests that found an interned palette
+int CelPaletteRegistry::getNumberOfHits() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_hits;
+}
+
+// Get the number of palette requests that did not find a palette
+int CelPaletteRegistry::getNumberOfMisses() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_misses;
+}
+
+// Release all interned palettes (palettes in use stay valid)
+void CelPaletteRegistry::clear()
+{
+  QMutexLocker locker( &d_mutex );
+
+  d_palettes.clear();
+}
+
+// Get the interned name of a palette
+/*! \details The leading and trailing '/' characters are removed so that a
+ * palette has the same name as in the image properties files (e.g.
+ * "levels/towndata/town.pal").
+ */
+QString CelPaletteRegistry::getInternedName(
+                                           const QString& palette_file_name )
+{
+  QString interned_name = palette_file_name;
+
+  while( interned_name.startsWith( '/' ) )
+    interned_name.remove( 0, 1 );
+
+  while( interned_name.endsWith( '/' ) )
+    interned_name.chop( 1 );
+
+  return interned_name;
+}
+
+// Find an interned palette (the mutex must be locked)
+CelPaletteRegistry::PaletteHandle CelPaletteRegistry::findImpl(
+                                               const QString& interned_name )
+{
+  PaletteHandle palette = d_palettes.value( interned_name );
+
+  if( palette )
+    ++d_hits;
+  else
+    ++d_misses;
+
+  return palette;
+}
+
+// Intern a palette (returns the interned palette if there is one)
+/*! \details If the palette has already been interned (e.g. it was parsed
+ * by another thread at the same time) the interned palette is returned and
+ * the new palette is discarded.
+ */
+CelPaletteRegistry::PaletteHandle CelPaletteRegistry::intern(
+                                              const QString& interned_name,
+                                              const PaletteHandle& palette )
+{
+  QMutexLocker locker( &d_mutex );
+
+  QHash<QString,PaletteHandle>::const_iterator palette_it =
+    d_palettes.constFind( interned_name );
+
+  if( palette_it != d_palettes.constEnd() )
+    return palette_it.value();
+
+  d_palettes.insert( interned_name, palette );
+
+  return palette;
+}
+
+// Read a file from the mpq
+QByteArray CelPaletteRegistry::readFile( const QString& file_name )
+{
+  QFile file( "/" + CelPaletteRegistry::getInternedName( file_name ) );
+
+  if( !file.open( QIODevice::ReadOnly ) )
+  {
+    qFatal( "CelPaletteRegistry Error: The file %s could not be opened!",
+            file_name.toStdString().c_str() );
+  }
+
+  return file.readAll();
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end CelPaletteRegistry.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   CelPaletteRegistry.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The cel palette registry class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef CEL_PALETTE_REGISTRY_H
+#define CEL_PALETTE_REGISTRY_H
+
+// Std Lib Includes
+#include <memory>
+
+// Qt Includes
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+// QtD1 Includes
+#include "CelPalette.h"
+
+namespace QtD1{
+
+/*! The cel palette registry
+ *
+ * The palettes are interned: every palette (.pal) file is only parsed once
+ * and the immutable palette is shared by every cel/cl2 asset that uses it.
+ * Derived palettes (translated and gamma corrected palettes) are interned
+ * too. Because every frame that is decoded with an interned palette is
+ * given the same (implicitly shared) color table the color table is
+ * never copied per frame.
+ *
+ * Palettes are small so the registry never releases them (see clear).
+ * The registry is thread safe (assets are decoded by worker threads).
+ */
+class CelPaletteRegistry
+{
+
+public:
+
+  //! The palette handle
+  typedef std::shared_ptr<const CelPalette> PaletteHandle;
+
+  //! Get the singleton instance
+  static CelPaletteRegistry* getInstance();
+
+  //! Destructor
+  ~CelPaletteRegistry()
+  { /* ... */ }
+
+  //! Get a palette (it will only be parsed if it has not been interned)
+  PaletteHandle getPalette( const QString& palette_file_name );
+
+  //! Get a palette (the extracted data is only parsed if not interned)
+  PaletteHandle getPalette( const QString& palette_file_name,
+                            const QByteArray& palette_data );
+
+  //! Get a translated palette
+  PaletteHandle getTranslatedPalette( const QString& palette_file_name,
+                                      const QString& translation_file_name );
+
+  //! Get a gamma corrected palette
+  PaletteHandle getGammaCorrectedPalette( const QString& palette_file_name,
+                                          const double gamma );
+
+  //! Get the number of interned palettes
+  int getNumberOfPalettes() const;
+
+  //! Get the number of palette requests that found an interned palette
+  int getNumberOfHits() const;
+
+  //! Get the number of palette requests that did not find a palette
+  int getNumberOfMisses() const;
+
+  //! Release all interned palettes (palettes in use stay valid)
+  void clear();
+
+  //! Get the interned name of a palette
+  static QString getInternedName( const QString& palette_file_name );
+
+private:
+
+  // Constructor
+  CelPaletteRegistry();
+
+  // Find an interned palette (the mutex must be locked)
+  PaletteHandle findImpl( const QString& interned_name );
+
+  // Intern a palette (returns the interned palette if there is one)
+  PaletteHandle intern( const QString& interned_name,
+                        const PaletteHandle& palette );
+
+  // Read a file from the mpq
+  static QByteArray readFile( const QString& file_name );
+
+  // The singleton instance
+  static std::unique_ptr<CelPaletteRegistry> s_instance;
+
+  // The singleton instance mutex
+  static QMutex s_instance_mutex;
+
+  // The registry mutex
+  mutable QMutex d_mutex;
+
+  // The interned palettes
+  QHash<QString,PaletteHandle> d_palettes;
+
+  // The number of hits
+  int d_hits;
+
+  // The number of misses
+  int d_misses;
+};
+
+} // end QtD1 namespace
+
+#endif // end CEL_PALETTE_REGISTRY_H
+
+//---------------------------------------------------------------------------//
+// end CelPaletteRegistry.h
+//---------------------------------------------------------------------------//
@@ -15,6 +15,11 @@
 
 namespace QtD1{
 
+// Initialize static member data
+const int Character::s_number_of_sprite_sheet_directions;
+const Direction Character::s_sprite_sheet_directions[] =
+  {South, Southwest, West, Northwest, North, Northeast, East, Southeast};
+
 // Constructor
 Character::Character( QGraphicsObject* parent )
   : Actor( parent )
@@ -114,12 +119,36 @@ int Character::getExperienceToNextLevelThreshold()
   return std::max( this->getCharacterData()->getNextLevelExperienceThreshold() - this->getCharacterData()->getExperience(), 0 );
 }
 
+// Set the gold amount
+void Character::setGold( const int gold )
+{
+  this->getCharacterData()->setGold( gold );
+}
+
 // Get the gold amount
 int Character::getGold()
 {
   return this->getCharacterData()->getGold();
 }
 
+// Recalculate the stats that depend on the level and the base stats
+void Character::recalculateDerivedStats()
+{
+  this->getCharacterData()->recalculateDerivedStats();
+}
+
+// Save the character state (the location is not saved)
+void Character::saveState( SaveGameState::CharacterState& state ) const
+{
+  this->getCharacterData()->saveState( state );
+}
+
+// Restore the character state (the name and type are not restored)
+void Character::restoreState( const SaveGameState::CharacterState& state )
+{
+  this->getCharacterData()->restoreState( state );
+}
+
 // Get the inventory
 const Inventory& Character::getInventory() const
 {
@@ -156,10 +185,115 @@ QuestLog& Character::getQuestLog()
   return this->getCharacterData()->getQuestLog();
 }
 
+// Check if the character is in town
+bool Character::isInTown() const
+{
+  return this->getCharacterData()->isInTown();
+}
+
+// Get the active weapon state
+Inventory::WeaponState Character::getActiveWeaponState() const
+{
+  return this->getCharacterData()->getActiveWeaponState();
+}
+
+// Get the active armor state
+Inventory::ChestArmorState Character::getActiveArmorState() const
+{
+  return this->getCharacterData()->getActiveArmorState();
+}
+
+// Get the image asset names of a location, weapon and armor sprite set
+/*! \details The spell cast image assets of every spell state are part of a
+ * dungeon sprite set (changing spells should never require a load).
+ */
+void Character::getSpriteSetImageAssetNames(
+                                 const bool in_town,
+                                 const Inventory::WeaponState weapon_state,
+                                 const Inventory::ChestArmorState armor_state,
+                                 QSet<QString>& image_asset_names ) const
+{
+  QSet<QString> all_image_asset_names;
+  this->getImageAssetNames( all_image_asset_names );
+
+  QSet<QString>::const_iterator image_asset_name_it, image_asset_name_end;
+  image_asset_name_it = all_image_asset_names.begin();
+  image_asset_name_end = all_image_asset_names.end();
+
+  while( image_asset_name_it != image_asset_name_end )
+  {
+    const States& image_asset_states =
+      this->getImageAssetStates( *image_asset_name_it );
+
+    if( image_asset_states.in_town == in_town &&
+        image_asset_states.weapon_state == weapon_state &&
+        image_asset_states.armor_state == armor_state )
+    {
+      image_asset_names.insert( *image_asset_name_it );
+    }
+
+    ++image_asset_name_it;
+  }
+}
+
+// Get the image asset names of the active sprite set
+void Character::getActiveImageAssetNames(
+                                     QSet<QString>& image_asset_names ) const
+{
+  this->getSpriteSetImageAssetNames( this->isInTown(),
+                                     this->getActiveWeaponState(),
+                                     this->getActiveArmorState(),
+                                     image_asset_names );
+}
+
+// Get the image asset names of the active sprite set that are not loaded
+void Character::getMissingActiveImageAssetNames(
+                                     QSet<QString>& image_asset_names ) const
+{
+  QSet<QString> active_image_asset_names;
+  this->getActiveImageAssetNames( active_image_asset_names );
+
+  QSet<QString>::const_iterator image_asset_name_it, image_asset_name_end;
+  image_asset_name_it = active_image_asset_names.begin();
+  image_asset_name_end = active_image_asset_names.end();
+
+  while( image_asset_name_it != image_asset_name_end )
+  {
+    if( !this->isImageAssetLoaded( *image_asset_name_it ) )
+      image_asset_names.insert( *image_asset_name_it );
+
+    ++image_asset_name_it;
+  }
+}
+
+// Check if an image asset has been loaded
+bool Character::isImageAssetLoaded( const QString& image_asset_name ) const
+{
+  return this->getCharacterData()->isImageAssetLoaded( image_asset_name );
+}
+
+// Get the loaded image asset names
+QList<QString> Character::getLoadedImageAssetNames() const
+{
+  return this->getCharacterData()->getLoadedImageAssetNames();
+}
+
+// Get the memory used by the loaded image assets (bytes)
+qint64 Character::getLoadedImageAssetBytes() const
+{
+  return this->getCharacterData()->getLoadedImageAssetBytes();
+}
+
 // Check if the image assets have been loaded
+/*! \details Only the image assets of the active sprite set are required.
+ * The other sprite sets are streamed in when the character state changes.
+ */
 bool Character::imageAssetsLoaded() const
 {
-  return this->getCharacterData()->spritesLoaded();
+  QSet<QString> missing_image_asset_names;
+  this->getMissingActiveImageAssetNames( missing_image_asset_names );
+
+  return missing_image_asset_names.empty();
 }
 
 // Load the image asset
@@ -206,6 +340,41 @@ void Character::loadImageAsset( const QString& image_asset_name,
                   image_asset_states.armor_state );
     }
   }
+
+  // Record the memory used by the asset (the frames are shared by the sprites)
+  qint64 image_asset_bytes = 0;
+
+  for( int i = 0; i < image_asset_frames.size(); ++i )
+  {
+    image_asset_bytes += (qint64)image_asset_frames[i].width()*
+      image_asset_frames[i].height()*image_asset_frames[i].depth()/8;
+  }
+
+  this->getCharacterData()->setImageAssetLoaded( image_asset_name,
+                                                 image_asset_bytes );
+}
+
+// Load the raw image assets
+/*! \details Only the character image assets that are present in the map
+ * will be loaded (the character never requires all of its image assets).
+ */
+void Character::loadRawImageAssets(
+                          const QMap<QString,QVector<QImage> >& image_assets )
+{
+  QSet<QString> image_asset_names;
+  this->getImageAssetNames( image_asset_names );
+
+  QMap<QString,QVector<QImage> >::const_iterator asset_map_it, asset_map_end;
+  asset_map_it = image_assets.begin();
+  asset_map_end = image_assets.end();
+
+  while( asset_map_it != asset_map_end )
+  {
+    if( image_asset_names.contains( asset_map_it.key() ) )
+      this->loadRawImageAsset( asset_map_it.key(), asset_map_it.value() );
+
+    ++asset_map_it;
+  }
 }
 
 // Load the town state game sprites
@@ -217,25 +386,24 @@ void Character::loadTownStateGameSprites(
                                   const Inventory::ChestArmorState armor_state,
                                   const Actor::State actor_state )
 {
-  std::shared_ptr<Actor::StateDirectionGameSpriteMap>& actor_state_direction_sprite_map =
-    this->getCharacterData()->getCharacterTownSprites()[weapon_state][armor_state];
+  const int first_sprite_id =
+    this->loadDirectionGameSprites( image_asset_name,
+                                    image_asset_frames,
+                                    frames_per_direction );
 
-  if( !actor_state_direction_sprite_map )
-  {
-    actor_state_direction_sprite_map.reset(
-                                      new Actor::StateDirectionGameSpriteMap );
-  }
-
-  std::shared_ptr<Actor::DirectionGameSpriteMap>&
-    direction_game_sprites = (*actor_state_direction_sprite_map)[actor_state];
-
-  this->loadDirectionGameSprites( image_asset_name,
-                                  image_asset_frames,
-                                  frames_per_direction,
-                                  direction_game_sprites );
+  this->assignDirectionGameSprites(
+                     CharacterData::getSpriteSet( true,
+                                                  SpellBook::NoSpellEquiped,
+                                                  weapon_state,
+                                                  armor_state ),
+                     actor_state,
+                     first_sprite_id );
 }
 
 // Load the non-spell cast dungeon state game sprites
+/*! \details The sprites do not depend on the equiped spell. They are only
+ * stored once and are assigned to the sprite sets of every spell state.
+ */
 void Character::loadNonSpellCastDungeonStateGameSprites(
                                   const QString& image_asset_name,
                                   const QVector<QPixmap>& image_asset_frames,
@@ -244,62 +412,27 @@ void Character::loadNonSpellCastDungeonStateGameSprites(
                                   const Inventory::ChestArmorState armor_state,
                                   const Actor::State actor_state )
 {
-  // Set the no spell equiped state
-  std::shared_ptr<Actor::StateDirectionGameSpriteMap>& no_spell_state_direction_sprite_map =
-    this->getCharacterData()->getCharacterDungeonSprites()[SpellBook::NoSpellEquiped][weapon_state][armor_state];
+  const int first_sprite_id =
+    this->loadDirectionGameSprites( image_asset_name,
+                                    image_asset_frames,
+                                    frames_per_direction );
 
-  if( !no_spell_state_direction_sprite_map )
-  {
-    no_spell_state_direction_sprite_map.reset(
-                                      new Actor::StateDirectionGameSpriteMap );
-  }
-
-  std::shared_ptr<Actor::DirectionGameSpriteMap>& direction_game_sprites =
-    (*no_spell_state_direction_sprite_map)[actor_state];
-
-  this->loadDirectionGameSprites( image_asset_name,
-                                  image_asset_frames,
-                                  frames_per_direction,
-                                  direction_game_sprites );
+  const SpellBook::SpellState spell_states[4] =
+    {SpellBook::NoSpellEquiped,
+     SpellBook::NonElementalSpellEquiped,
+     SpellBook::FireSpellEquiped,
+     SpellBook::LightningSpellEquiped};
 
-  // Set the non-elemental spell equiped state
-  std::shared_ptr<Actor::StateDirectionGameSpriteMap>&
-    non_elemental_spell_state_direction_game_sprite_map = this->getCharacterData()->getCharacterDungeonSprites()[SpellBook::NonElementalSpellEquiped][weapon_state][armor_state];
-
-  if( !non_elemental_spell_state_direction_game_sprite_map )
+  for( int i = 0; i < 4; ++i )
   {
-    non_elemental_spell_state_direction_game_sprite_map.reset(
-                                      new Actor::StateDirectionGameSpriteMap );
+    this->assignDirectionGameSprites(
+                             CharacterData::getSpriteSet( false,
+                                                          spell_states[i],
+                                                          weapon_state,
+                                                          armor_state ),
+                             actor_state,
+                             first_sprite_id );
   }
-
-  (*non_elemental_spell_state_direction_game_sprite_map)[actor_state] =
-    direction_game_sprites;
-
-  // Set the fire spell equiped state
-  std::shared_ptr<Actor::StateDirectionGameSpriteMap>&
-    fire_spell_state_direction_game_sprite_map = this->getCharacterData()->getCharacterDungeonSprites()[SpellBook::NonElementalSpellEquiped][weapon_state][armor_state];
-
-  if( !fire_spell_state_direction_game_sprite_map )
-  {
-    fire_spell_state_direction_game_sprite_map.reset(
-                                  new Actor::StateDirectionGameSpriteMap );
-  }
-
-  (*fire_spell_state_direction_game_sprite_map)[actor_state] =
-    direction_game_sprites;
-
-  // Set the lightning spell equiped state
-  std::shared_ptr<Actor::StateDirectionGameSpriteMap>&
-    lightning_spell_state_direction_game_sprite_map = this->getCharacterData()->getCharacterDungeonSprites()[SpellBook::NonElementalSpellEquiped][weapon_state][armor_state];
-
-  if( !lightning_spell_state_direction_game_sprite_map )
-  {
-    lightning_spell_state_direction_game_sprite_map.reset(
-                                      new Actor::StateDirectionGameSpriteMap );
-  }
-
-  (*lightning_spell_state_direction_game_sprite_map)[actor_state] =
-    direction_game_sprites;
 }
 
 // Load the spell cast dungeon state game sprites
@@ -311,102 +444,63 @@ void Character::loadSpellCastDungeonStateGameSprites(
                                  const Inventory::WeaponState weapon_state,
                                  const Inventory::ChestArmorState armor_state )
 {
-  std::shared_ptr<Actor::StateDirectionGameSpriteMap>&
-    spell_cast_state_direction_game_sprite_map = this->getCharacterData()->getCharacterDungeonSprites()[spell_state][weapon_state][armor_state];
+  const int first_sprite_id =
+    this->loadDirectionGameSprites( image_asset_name,
+                                    image_asset_frames,
+                                    frames_per_direction );
+
+  this->assignDirectionGameSprites(
+                             CharacterData::getSpriteSet( false,
+                                                          spell_state,
+                                                          weapon_state,
+                                                          armor_state ),
+                             Actor::CastingSpell,
+                             first_sprite_id );
+}
+
+// Load the direction game sprites
+/*! \details The sprites of each direction are stored consecutively in the
+ * sprite table (in the order of the sprite sheet). The id of the first
+ * sprite will be returned. The sprites of an asset are only created once -
+ * reloading an asset (e.g. after the assets have been dumped) will reuse
+ * the existing sprites.
+ */
+int Character::loadDirectionGameSprites(
+                                   const QString& source,
+                                   const QVector<QPixmap>& image_asset_frames,
+                                   const int frames_per_direction )
+{
+  ActorSpriteTable& sprites = *this->getCharacterData()->getSprites();
 
-  if( !spell_cast_state_direction_game_sprite_map )
+  const int first_sprite_id =
+    sprites.createStoredSprites( source, s_number_of_sprite_sheet_directions );
+
+  for( int i = 0; i < s_number_of_sprite_sheet_directions; ++i )
   {
-    spell_cast_state_direction_game_sprite_map.reset(
-                                  new Actor::StateDirectionGameSpriteMap );
+    this->loadGameSprites( source,
+                           image_asset_frames,
+                           frames_per_direction,
+                           i*frames_per_direction,
+                           sprites.getStoredSprite( first_sprite_id + i ) );
   }
 
-  std::shared_ptr<Actor::DirectionGameSpriteMap>& direction_game_sprites =
-    (*spell_cast_state_direction_game_sprite_map)[Actor::CastingSpell];
-
-  this->loadDirectionGameSprites( image_asset_name,
-                                  image_asset_frames,
-                                  frames_per_direction,
-                                  direction_game_sprites );
+  return first_sprite_id;
 }
 
-// Create the direction game sprites
-void Character::loadDirectionGameSprites(
-                            const QString& source,
-                            const QVector<QPixmap>& image_asset_frames,
-                            const int frames_per_direction,
-                            std::shared_ptr<Actor::DirectionGameSpriteMap>&
-                            direction_game_sprites )
+// Assign the direction game sprites to a sprite set state
+void Character::assignDirectionGameSprites( const int sprite_set,
+                                            const Actor::State actor_state,
+                                            const int first_sprite_id )
 {
-  if( !direction_game_sprites )
-    direction_game_sprites.reset( new Actor::DirectionGameSpriteMap );
-
-  int offset = 0;
-
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[South] );
-
-  offset += frames_per_direction;
-
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[Southwest] );
+  ActorSpriteTable& sprites = *this->getCharacterData()->getSprites();
 
-  offset += frames_per_direction;
-
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[West] );
-  
-  offset += frames_per_direction;
-
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[Northwest] );
-
-  offset += frames_per_direction;
-  
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[North] );
-
-  offset += frames_per_direction;
-
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[Northeast] );
-
-  offset += frames_per_direction;
-
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[East] );
-
-  offset += frames_per_direction;
-
-  this->loadGameSprites( source,
-                         image_asset_frames,
-                         frames_per_direction,
-                         offset,
-                         (*direction_game_sprites)[Southeast] );
-
-  // Cache these sprites for quick lookup later
-  this->getCharacterData()->getDirectionSprites()[source] =
-    direction_game_sprites;
+  for( int i = 0; i < s_number_of_sprite_sheet_directions; ++i )
+  {
+    sprites.assignSprite( sprite_set,
+                          actor_state,
+                          s_sprite_sheet_directions[i],
+                          first_sprite_id + i );
+  }
 }
 
 // Load the game sprites 
@@ -431,53 +525,60 @@ void Character::loadGameSprites( const QString& source,
 }
 
 // Finalize image asset loading
+/*! \details The active sprite will be refreshed so that a sprite set that
+ * was streamed in after the character state changed is displayed.
+ */
 void Character::finalizeImageAssetLoading()
 {
-  this->getCharacterData()->setSpritesLoaded();
-  this->setActorSprites( this->getCharacterData()->getCharacterTownSprites()[Inventory::NothingEquiped][Inventory::LowClassArmorEquiped] );
+  const CharacterData* data = this->getCharacterData();
+
+  this->setActorSprites( this->getCharacterData()->getSprites(),
+                         CharacterData::getSpriteSet(
+                                              data->isInTown(),
+                                              data->getActiveSpellState(),
+                                              data->getActiveWeaponState(),
+                                              data->getActiveArmorState() ) );
+}
+
+// Dump an image asset
+/*! \details The sprites that were created for the image asset are kept so
+ * that the image asset can be reloaded later.
+ */
+void Character::dumpImageAsset( const QString& image_asset_name )
+{
+  this->getCharacterData()->getSprites()->dumpAssets( image_asset_name );
+
+  this->getCharacterData()->setImageAssetNotLoaded( image_asset_name );
 }
 
 // Dump the image assets
 void Character::dumpImageAssets()
 {
-  QMap<QString,std::shared_ptr<Actor::DirectionGameSpriteMap> >::iterator
-    asset_sprite_it, asset_sprite_end;
-  asset_sprite_it = this->getCharacterData()->getDirectionSprites().begin();
-  asset_sprite_end = this->getCharacterData()->getDirectionSprites().end();
-
-  while( asset_sprite_it != asset_sprite_end )
-  {
-    if( asset_sprite_it.value() )
-    {
-      Actor::DirectionGameSpriteMap::iterator direction_sprite_it,
-        direction_sprite_end;
-      direction_sprite_it = asset_sprite_it.value()->begin();
-      direction_sprite_end = asset_sprite_it.value()->end();
-
-      while( direction_sprite_it != direction_sprite_end )
-      {
-        direction_sprite_it.value().dumpAsset();
-        
-        ++direction_sprite_it;
-      }
-    }
-    
-    ++asset_sprite_it;
-  }
+  this->getCharacterData()->getSprites()->dumpAssets();
 
-  this->getCharacterData()->setSpritesNotLoaded();
+  this->getCharacterData()->setImageAssetsNotLoaded();
 }
 
 // Enter the town
+/*! \details The state is set through Actor::setStateAndDirection so that
+ * the level is told if the character starts or stops animating.
+ */
 void Character::enterTown()
 {
   this->getCharacterData()->enterTown();
+
+  this->setStateAndDirection( Actor::Standing, Direction::South );
 }
 
 // Exit the town
+/*! \details The state is set through Actor::setStateAndDirection so that
+ * the level is told if the character starts or stops animating.
+ */
 void Character::exitTown()
 {
-  this->getCharacterData()->enterTown();
+  this->getCharacterData()->exitTown();
+
+  this->setStateAndDirection( Actor::Standing, Direction::South );
 }
 
 void Character::handleLevelUpInCharacterData( const int new_level )
@@ -490,6 +591,11 @@ void Character::handleStatsChangedInCharacterData()
   emit statsChanged();
 }
 
+void Character::handleCharacterStateChangedInCharacterData()
+{
+  emit characterStateChanged();
+}
+
 // Connect character data signals to character slots
 void Character::connectCharacterDataSignalsToCharacterSlots()
 {
@@ -497,6 +603,8 @@ void Character::connectCharacterDataSignalsToCharacterSlots()
                     this, SLOT(handleLevelUpInCharacterData(const int)) );
   QObject::connect( this->getCharacterData(), SIGNAL(statsChanged()),
                     this, SLOT(handleStatsChangedInCharacterData()) );
+  QObject::connect( this->getCharacterData(), SIGNAL(characterStateChanged()),
+                    this, SLOT(handleCharacterStateChangedInCharacterData()) );
 }
 
 // Disconnect character slots from character data signals
@@ -506,6 +614,10 @@ void Character::disconnectCharacterSlotsFromCharacterDataSignals()
                        this, SLOT(handleLevelUpInCharacterData(const int)) );
   QObject::disconnect( this->getCharacterData(), SIGNAL(statsChanged()),
                        this, SLOT(handleStatsChangedInCharacterData()) );
+  QObject::disconnect( this->getCharacterData(),
+                       SIGNAL(characterStateChanged()),
+                       this,
+                       SLOT(handleCharacterStateChangedInCharacterData()) );
 }
 
 // Update character stats
@@ -15,6 +15,7 @@
 #include "Inventory.h"
 #include "SpellBook.h"
 #include "QuestLog.h"
+#include "SaveGameState.h"
 
 namespace QtD1{
 
@@ -93,9 +94,21 @@ public:
   //! Get experience to next level threshold
   int getExperienceToNextLevelThreshold();
 
+  //! Set the gold amount
+  void setGold( const int gold );
+
   //! Get the gold amount
   int getGold();
 
+  //! Recalculate the stats that depend on the level and the base stats
+  void recalculateDerivedStats();
+
+  //! Save the character state (the location is not saved)
+  void saveState( SaveGameState::CharacterState& state ) const;
+
+  //! Restore the character state (the name and type are not restored)
+  void restoreState( const SaveGameState::CharacterState& state );
+
   //! Get the inventory
   const Inventory& getInventory() const;
 
@@ -114,6 +127,38 @@ public:
   //! Get the quest log
   QuestLog& getQuestLog();
 
+  //! Check if the character is in town
+  bool isInTown() const;
+
+  //! Get the active weapon state
+  Inventory::WeaponState getActiveWeaponState() const;
+
+  //! Get the active armor state
+  Inventory::ChestArmorState getActiveArmorState() const;
+
+  //! Get the image asset names of a location, weapon and armor sprite set
+  void getSpriteSetImageAssetNames(
+                               const bool in_town,
+                               const Inventory::WeaponState weapon_state,
+                               const Inventory::ChestArmorState armor_state,
+                               QSet<QString>& image_asset_names ) const;
+
+  //! Get the image asset names of the active sprite set
+  void getActiveImageAssetNames( QSet<QString>& image_asset_names ) const;
+
+  //! Get the image asset names of the active sprite set that are not loaded
+  void getMissingActiveImageAssetNames(
+                                   QSet<QString>& image_asset_names ) const;
+
+  //! Check if an image asset has been loaded
+  bool isImageAssetLoaded( const QString& image_asset_name ) const;
+
+  //! Get the loaded image asset names
+  QList<QString> getLoadedImageAssetNames() const;
+
+  //! Get the memory used by the loaded image assets (bytes)
+  qint64 getLoadedImageAssetBytes() const;
+
   //! Check if the image assets have been loaded
   bool imageAssetsLoaded() const override;
 
@@ -121,9 +166,16 @@ public:
   void loadImageAsset( const QString& image_asset_name,
                        const QVector<QPixmap>& image_asset_frames ) override;
 
+  //! Load the raw image assets
+  void loadRawImageAssets(
+           const QMap<QString,QVector<QImage> >& image_assets ) override;
+
   //! Finalize image asset loading
   void finalizeImageAssetLoading() override;
 
+  //! Dump an image asset
+  void dumpImageAsset( const QString& image_asset_name );
+
   //! Dump the image assets
   void dumpImageAssets() override;
 
@@ -135,6 +187,9 @@ signals:
   //! Character stats changed
   void statsChanged();
 
+  //! Character location, weapon, armor or spell state changed
+  void characterStateChanged();
+
 public slots:
 
   //! Enter the town
@@ -151,6 +206,9 @@ private slots:
   //! Forward stats changed signal in character data to stats changed signal
   void handleStatsChangedInCharacterData();
 
+  //! Forward state changed signal in character data to state changed signal
+  void handleCharacterStateChangedInCharacterData();
+
 protected:
 
   // The states type associated with an asset (bool = true for in town)
@@ -216,12 +274,14 @@ private:
                                 const Inventory::ChestArmorState armor_state );
 
   // Load the direction game sprites
-  void loadDirectionGameSprites(
-                            const QString& source,
-                            const QVector<QPixmap>& image_asset_frames,
-                            const int frames_per_direction,
-                            std::shared_ptr<Actor::DirectionGameSpriteMap>&
-                            direction_game_sprites );
+  int loadDirectionGameSprites( const QString& source,
+                                const QVector<QPixmap>& image_asset_frames,
+                                const int frames_per_direction );
+
+  // Assign the direction game sprites to a sprite set state
+  void assignDirectionGameSprites( const int sprite_set,
+                                   const Actor::State actor_state,
+                                   const int first_sprite_id );
 
   // Load the game sprites 
   void loadGameSprites( const QString& source,
@@ -230,6 +290,13 @@ private:
                         const int offset,
                         GameSprite& game_sprite );
 
+  // The number of directions in the sprite sheets
+  static const int s_number_of_sprite_sheet_directions = 8;
+
+  // The directions in the order of the sprite sheets
+  static const Direction
+  s_sprite_sheet_directions[s_number_of_sprite_sheet_directions];
+
   // The character data
   std::shared_ptr<CharacterData> d_data;
 };
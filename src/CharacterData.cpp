@@ -6,6 +6,9 @@
 //!
 //---------------------------------------------------------------------------//
 
+// Qt Includes
+#include <QTimer>
+
 // QtD1 Includes
 #include "CharacterData.h"
 #include "Character.h"
@@ -18,9 +21,16 @@
 
 namespace QtD1{
 
+// Initialize static member data
+const int CharacterData::s_number_of_sprite_sets;
+
 // Constructor
 CharacterData::CharacterData( QObject* parent )
-  : ActorData( parent )
+  : ActorData( parent ),
+    d_dirty_stat_sources( AllStatSources ),
+    d_stats_flush_scheduled( false ),
+    d_stats_calculated( false ),
+    d_inventory_modifiers()
 { /* ... */ }
 
 // Constructor
@@ -35,8 +45,10 @@ CharacterData::CharacterData( const QString& character_name,
     d_gold( 0 ),
     d_strength( 0 ),
     d_magic( 0 ),
+    d_magic_bonus( 0 ),
     d_dexterity( 0 ),
     d_vitality( 0 ),
+    d_vitality_bonus( 0 ),
     d_max_health( 1 ),
     d_max_mana( 1 ),
     d_magic_resistance_fraction( 0.0 ),
@@ -51,10 +63,12 @@ CharacterData::CharacterData( const QString& character_name,
     d_inventory( NULL ),
     d_spell_book( NULL ),
     d_quest_log( NULL ),
-    d_dungeon_sprites(),
-    d_town_sprites(),
-    d_direction_sprites(),
-    d_sprites_loaded( false ),
+    d_dirty_stat_sources( AllStatSources ),
+    d_stats_flush_scheduled( false ),
+    d_stats_calculated( false ),
+    d_inventory_modifiers(),
+    d_loaded_image_assets(),
+    d_loaded_image_asset_bytes( 0 ),
     d_active_armor_state( Inventory::LowClassArmorEquiped ),
     d_active_weapon_state( Inventory::NothingEquiped ),
     d_active_spell_state( SpellBook::NoSpellEquiped ),
@@ -90,6 +104,13 @@ CharacterData::CharacterData( const QString& character_name,
   // Create the quest log
   d_quest_log = new QuestLog;
 
+  // Create the sprite table (the sprites are loaded with the image assets)
+  this->getSprites().reset( new ActorSpriteTable( s_number_of_sprite_sets ) );
+  this->setActiveSpriteSet( this->getSpriteSet( d_in_town,
+                                                d_active_spell_state,
+                                                d_active_weapon_state,
+                                                d_active_armor_state ) );
+
   // Initialize the spell book pages
   d_spell_book->initializePages();
 
@@ -120,8 +141,10 @@ CharacterData& CharacterData::operator=( const CharacterData& other_data )
     d_gold = other_data.d_gold;
     d_strength = other_data.d_strength;
     d_magic = other_data.d_magic;
+    d_magic_bonus = other_data.d_magic_bonus;
     d_dexterity = other_data.d_dexterity;
     d_vitality = other_data.d_vitality;
+    d_vitality_bonus = other_data.d_vitality_bonus;
     d_max_health = other_data.d_max_health;
     d_max_mana = other_data.d_max_mana;
     d_magic_resistance_fraction = other_data.d_magic_resistance_fraction;
@@ -138,6 +161,8 @@ CharacterData& CharacterData::operator=( const CharacterData& other_data )
     d_active_weapon_state = other_data.d_active_weapon_state;
     d_active_spell_state = other_data.d_active_spell_state;
     d_in_town = other_data.d_in_town;
+    d_stats_calculated = other_data.d_stats_calculated;
+    d_inventory_modifiers = other_data.d_inventory_modifiers;
 
     // Disconnect from the current inventory signals
     this->disconnectCharacterDataSlotsFromInventorySignals();
@@ -157,11 +182,6 @@ CharacterData& CharacterData::operator=( const CharacterData& other_data )
 
     // Connect to the spell book signals
     this->connectSpellBookSignalsToCharacterDataSlots();
-
-    // Do we need a deep copy of the sprites too?
-    d_dungeon_sprites = other_data.d_dungeon_sprites;
-    d_town_sprites = other_data.d_town_sprites;
-    d_direction_sprites = other_data.d_direction_sprites;
   }
 
   return *this;
@@ -229,6 +249,12 @@ int CharacterData::getNextLevelExperienceThreshold()
   return d_next_level_experience_threshold;
 }
 
+// Set the gold amount
+void CharacterData::setGold( const int gold )
+{
+  d_gold = std::max( gold, 0 );
+}
+
 // Get the gold amount
 int CharacterData::getGold()
 {
@@ -361,58 +387,65 @@ QuestLog& CharacterData::getQuestLog()
   return *d_quest_log;
 }
 
-// Get the character dungeon sprites
-auto CharacterData::getCharacterDungeonSprites() -> SpellWeaponAndArmorClassStateGameSpriteMap&
+// Get the sprite set of a location, spell, weapon and armor state
+/*! \details The spell state is ignored in town (spells cannot be cast).
+ */
+int CharacterData::getSpriteSet( const bool in_town,
+                                 const SpellBook::SpellState spell_state,
+                                 const Inventory::WeaponState weapon_state,
+                                 const Inventory::ChestArmorState armor_state )
 {
-  return d_dungeon_sprites;
-}
+  const int location = in_town ? 1 : 0;
+  const int spell = in_town ? (int)SpellBook::NoSpellEquiped : (int)spell_state;
 
-// Get the character dungeon sprites
-auto CharacterData::getCharacterDungeonSprites() const -> const SpellWeaponAndArmorClassStateGameSpriteMap&
-{
-  return d_dungeon_sprites;
+  return ((location*(SpellBook::LightningSpellEquiped+1) + spell)*
+          (Inventory::NothingEquiped+1) + weapon_state)*
+    (Inventory::HighClassArmorEquiped+1) + armor_state;
 }
 
-// Get the character town sprites
-auto CharacterData::getCharacterTownSprites() -> WeaponAndArmorClassStateGameSpriteMap&
+// Check if a sprite image asset has been loaded
+bool CharacterData::isImageAssetLoaded( const QString& image_asset_name ) const
 {
-  return d_town_sprites;
+  return d_loaded_image_assets.contains( image_asset_name );
 }
 
-// Get the character town sprites
-auto CharacterData::getCharacterTownSprites() const -> const WeaponAndArmorClassStateGameSpriteMap&
+// A sprite image asset has been loaded
+/*! \details If the image asset has already been loaded (e.g. it was
+ * reloaded) the memory that it uses will be updated.
+ */
+void CharacterData::setImageAssetLoaded( const QString& image_asset_name,
+                                         const qint64 image_asset_bytes )
 {
-  return d_town_sprites;
-}
+  d_loaded_image_asset_bytes -=
+    d_loaded_image_assets.value( image_asset_name, 0 );
 
-// Get the state direction sprites
-auto CharacterData::getDirectionSprites() ->   QMap<QString,std::shared_ptr<ActorData::DirectionGameSpriteMap> >&
-{
-  return d_direction_sprites;
+  d_loaded_image_assets[image_asset_name] = image_asset_bytes;
+  d_loaded_image_asset_bytes += image_asset_bytes;
 }
 
-// Get the state direction sprites
-auto CharacterData::getDirectionSprites() const -> const QMap<QString,std::shared_ptr<ActorData::DirectionGameSpriteMap> >&
+// A sprite image asset has not been loaded
+void CharacterData::setImageAssetNotLoaded( const QString& image_asset_name )
 {
-  return d_direction_sprites;
+  d_loaded_image_asset_bytes -= d_loaded_image_assets.take( image_asset_name );
 }
 
-// Check if the sprites have been loaded
-bool CharacterData::spritesLoaded() const
+// No sprite image assets have been loaded
+void CharacterData::setImageAssetsNotLoaded()
 {
-  return d_sprites_loaded;
+  d_loaded_image_assets.clear();
+  d_loaded_image_asset_bytes = 0;
 }
 
-// The sprites have been loaded
-void CharacterData::setSpritesLoaded()
+// Get the loaded sprite image asset names
+QList<QString> CharacterData::getLoadedImageAssetNames() const
 {
-  d_sprites_loaded = true;
+  return d_loaded_image_assets.keys();
 }
 
-// The sprites have not been loaded
-void CharacterData::setSpritesNotLoaded()
+// Get the memory used by the loaded sprite image assets (bytes)
+qint64 CharacterData::getLoadedImageAssetBytes() const
 {
-  d_sprites_loaded = false;
+  return d_loaded_image_asset_bytes;
 }
 
 // Get the active armor state
@@ -440,21 +473,25 @@ bool CharacterData::isInTown() const
 }
 
 // The character has entered the town
+/*! \details Only the sprites are updated. The character must reset its
+ * state (see Character::enterTown).
+ */
 void CharacterData::enterTown()
 {
   d_in_town = true;
 
   this->updateActorSprites();
-  this->setActiveStateAndDirection( Actor::Standing, Direction::South );
 }
 
 // The character has exited the town
+/*! \details Only the sprites are updated. The character must reset its
+ * state (see Character::exitTown).
+ */
 void CharacterData::exitTown()
 {
   d_in_town = false;
 
   this->updateActorSprites();
-  this->setActiveStateAndDirection( Actor::Standing, Direction::South );
 }
 
 // Weapon has been changed
@@ -467,7 +504,7 @@ void CharacterData::handleWeaponChanged( const Inventory::WeaponState state )
     this->updateActorSprites();
   }
 
-  this->updateStats();
+  this->invalidateStats( InventoryStatSource );
 }
 
 // Shield has been changed
@@ -480,19 +517,19 @@ void CharacterData::handleShieldChanged( const Inventory::WeaponState state )
     this->updateActorSprites();
   }
 
-  this->updateStats();
+  this->invalidateStats( InventoryStatSource );
 }
 
 // Ring has been changed
 void CharacterData::handleRingChanged()
 {
-  this->updateStats();
+  this->invalidateStats( InventoryStatSource );
 }
 
 // Amulet has been changed
 void CharacterData::handleAmuletChanged()
 {
-  this->updateStats();
+  this->invalidateStats( InventoryStatSource );
 }
 
 // Armor has been changed
@@ -505,13 +542,13 @@ void CharacterData::handleArmorChanged( const Inventory::ChestArmorState state )
     this->updateActorSprites();
   }
 
-  this->updateStats();
+  this->invalidateStats( InventoryStatSource );
 }
 
 // Helmet has been changed
 void CharacterData::handleHelmetChanged()
 {
-  this->updateStats();
+  this->invalidateStats( InventoryStatSource );
 }
 
 // Spell changed
@@ -528,90 +565,250 @@ void CharacterData::handleSpellChanged( const SpellBook::SpellState state )
 // Update the active actor sprites
 void CharacterData::updateActorSprites()
 {
-  if( d_in_town )
-  {
-    this->getSprites() =
-      d_town_sprites[d_active_weapon_state][d_active_armor_state];
-  }
-  else
-  {
-    this->getSprites() = d_dungeon_sprites[d_active_spell_state][d_active_weapon_state][d_active_armor_state];
-  }
-
-  this->updateActiveSprite();
+  this->setActiveSpriteSet( this->getSpriteSet( d_in_town,
+                                                d_active_spell_state,
+                                                d_active_weapon_state,
+                                                d_active_armor_state ) );
 
   emit characterStateChanged();
 }
 
-// Update the character stats after the inventory has changed
+// Update the character stats
+/*! \details The stats will be recalculated immediately (use this method when
+ * the stats must be valid before the next event loop turn, e.g. when the
+ * character is initialized). Changes that are made by the inventory and the
+ * base stats are coalesced and recalculated once per event loop turn.
+ */
 void CharacterData::updateStats()
 {
+  d_dirty_stat_sources = AllStatSources;
+
+  this->recalculateStats();
+}
+
+// Recalculate the stats that depend on the level and the base stats
+/*! \details The level and base stat setters only assign the values (e.g.
+ * when a character is restored). The total stats are updated first so that
+ * the level dependent base stats (e.g. the base health and mana) are
+ * calculated from them. The stats are then updated again so that the max
+ * health and mana include the new base stats.
+ */
+void CharacterData::recalculateDerivedStats()
+{
+  this->updateStats();
+
+  this->calculateBaseStats();
+
+  this->updateStats();
+}
+
+// Save the character state (the location is not saved)
+void CharacterData::saveState( SaveGameState::CharacterState& state ) const
+{
+  state.name = this->getName();
+  state.type = this->getType();
+  state.level = this->getLevel();
+  state.experience = this->getExperience();
+  state.gold = d_gold;
+  state.strength = this->getBaseStrength();
+  state.magic = this->getBaseMagic();
+  state.dexterity = this->getBaseDexterity();
+  state.vitality = this->getBaseVitality();
+  state.health = this->getHealth();
+  state.mana = this->getMana();
+}
+
+// Restore the character state (the name and type are not restored)
+/*! \details The derived stats are recalculated before the health and mana
+ * are restored (they are limited by the max health and mana).
+ */
+void CharacterData::restoreState( const SaveGameState::CharacterState& state )
+{
+  this->setLevel( state.level );
+  this->setExperience( state.experience );
+  this->setGold( state.gold );
+  this->setBaseStrength( state.strength );
+  this->setBaseMagic( state.magic );
+  this->setBaseDexterity( state.dexterity );
+  this->setBaseVitality( state.vitality );
+
+  this->recalculateDerivedStats();
+
+  this->setHealth( state.health );
+  this->setMana( state.mana );
+}
+
+// Calculate the base stats that depend on the level and the total stats
+/*! \details The character classes calculate their own base stats.
+ */
+void CharacterData::calculateBaseStats()
+{ /* ... */ }
+
+// Handle a base stat change
+void CharacterData::handleBaseStatsChanged()
+{
+  this->invalidateStats( BaseStatSource );
+}
+
+// Flush the dirty stats
+void CharacterData::flushStats()
+{
+  d_stats_flush_scheduled = false;
+
+  if( d_dirty_stat_sources != NoStatSource )
+    this->recalculateStats();
+}
+
+// Mark stat sources as dirty
+/*! \details A single flush will be scheduled for the next event loop turn
+ * regardless of how many times this method is called before then.
+ */
+void CharacterData::invalidateStats( const int stat_sources )
+{
+  d_dirty_stat_sources |= stat_sources;
+
+  if( !d_stats_flush_scheduled )
+  {
+    d_stats_flush_scheduled = true;
+
+    QTimer::singleShot( 0, this, SLOT(flushStats()) );
+  }
+}
+
+// Recalculate the stats and emit the changes
+/*! \details The inventory modifiers are only recalculated (in a single
+ * pass) if the inventory has changed. The individual stat signals are only
+ * emitted for the stats that have changed and the stats changed signal is
+ * emitted once for the whole change set.
+ */
+void CharacterData::recalculateStats()
+{
+  if( d_dirty_stat_sources & InventoryStatSource )
+    d_inventory_modifiers = d_inventory->calculateModifiers();
+
+  d_dirty_stat_sources = NoStatSource;
+
+  const bool emit_all = !d_stats_calculated;
+  d_stats_calculated = true;
+
+  bool stats_changed = emit_all;
+
   // Update strength
-  d_strength = this->getBaseStrength() +
-    d_inventory->calculateStrengthModifier();
-  emit strengthChanged( d_strength );
+  const int strength = this->getBaseStrength() +
+    d_inventory_modifiers.strength;
+
+  if( emit_all || strength != d_strength )
+  {
+    d_strength = strength;
+    stats_changed = true;
+
+    emit strengthChanged( d_strength );
+  }
 
-  // Update magic
-  d_magic = this->getBaseMagic() +
-    d_inventory->calculateMagicModifier();
-  emit magicChanged( this->getBaseMagic(), d_inventory->calculateMagicModifier() );
+  // Update magic (the base and the bonus can change by opposite amounts in
+  // the same change set so they are compared separately)
+  const int magic = this->getBaseMagic() + d_inventory_modifiers.magic;
+
+  if( emit_all ||
+      magic != d_magic ||
+      d_inventory_modifiers.magic != d_magic_bonus )
+  {
+    d_magic = magic;
+    d_magic_bonus = d_inventory_modifiers.magic;
+    stats_changed = true;
+
+    emit magicChanged( this->getBaseMagic(), d_inventory_modifiers.magic );
+  }
 
   // Update dexterity
-  d_dexterity = this->getBaseDexterity() +
-    d_inventory->calculateDexterityModifier();
-  emit dexterityChanged( d_dexterity );
+  const int dexterity = this->getBaseDexterity() +
+    d_inventory_modifiers.dexterity;
+
+  if( emit_all || dexterity != d_dexterity )
+  {
+    d_dexterity = dexterity;
+    stats_changed = true;
+
+    emit dexterityChanged( d_dexterity );
+  }
 
-  // Update vitality
-  d_vitality = this->getBaseVitality() +
-    d_inventory->calculateVitalityModifier();
-  emit vitalityChanged( this->getBaseVitality(), d_inventory->calculateVitalityModifier() );
+  // Update vitality (the base and the bonus are compared separately)
+  const int vitality = this->getBaseVitality() +
+    d_inventory_modifiers.vitality;
+
+  if( emit_all ||
+      vitality != d_vitality ||
+      d_inventory_modifiers.vitality != d_vitality_bonus )
+  {
+    d_vitality = vitality;
+    d_vitality_bonus = d_inventory_modifiers.vitality;
+    stats_changed = true;
+
+    emit vitalityChanged( this->getBaseVitality(),
+                          d_inventory_modifiers.vitality );
+  }
+
+  // Update the derived stats (the core stat signals above have already
+  // updated the base values that they depend on)
+  const int max_health = this->getBaseHealth() + d_inventory_modifiers.health;
+  const int max_mana = this->getBaseMana() + d_inventory_modifiers.mana;
+  const int magic_resistance_fraction = this->getBaseMagicResistance() +
+    d_inventory_modifiers.magic_resistance;
+  const int fire_resistance_fraction = this->getBaseFireResistance() +
+    d_inventory_modifiers.fire_resistance;
+  const int lightning_resistance_fraction =
+    this->getBaseLightningResistance() +
+    d_inventory_modifiers.lightning_resistance;
+  const int armor_class = this->getBaseArmorClass() +
+    d_inventory_modifiers.armor_class;
+
+  // Note: the inventory damage modifier is not applied yet
+  const int minimum_damage = this->getBaseDamage();
+  const int maximum_damage = this->getBaseDamage();
+
+  if( max_health != d_max_health ||
+      max_mana != d_max_mana ||
+      magic_resistance_fraction != d_magic_resistance_fraction ||
+      fire_resistance_fraction != d_fire_resistance_fraction ||
+      lightning_resistance_fraction != d_lightning_resistance_fraction ||
+      armor_class != d_armor_class ||
+      minimum_damage != d_minimum_damage ||
+      maximum_damage != d_maximum_damage )
+  {
+    stats_changed = true;
+  }
 
   // Update max health
-  d_max_health = this->getBaseHealth() +
-    d_inventory->calculateHealthModifier();
+  d_max_health = max_health;
   if( d_max_health < this->getHealth() )
     this->setHealth( d_max_health );
 
   // Update max mana
-  d_max_mana = this->getBaseMana() +
-    d_inventory->calculateManaModifier();
+  d_max_mana = max_mana;
   if( d_max_mana < this->getMana() )
     this->setMana( d_max_mana );
 
-  // Update magic resistance
-  d_magic_resistance_fraction = this->getBaseMagicResistance() +
-    d_inventory->calculateMagicResistance();
-
-  // Update fire resistance
-  d_fire_resistance_fraction = this->getBaseFireResistance() +
-    d_inventory->calculateFireResistance();
-
-  // Update lightning resistance
-  d_lightning_resistance_fraction = this->getBaseLightningResistance() +
-    d_inventory->calculateLightningResistance();
+  // Update the resistances
+  d_magic_resistance_fraction = magic_resistance_fraction;
+  d_fire_resistance_fraction = fire_resistance_fraction;
+  d_lightning_resistance_fraction = lightning_resistance_fraction;
 
   // Update the armor class
-  d_armor_class = this->getBaseArmorClass() +
-    d_inventory->calculateArmorClass();
+  d_armor_class = armor_class;
 
   // Update the damage
-  /*d_damage = this->getBaseDamage() +
-    d_inventory->calculateDamage();*/
-
-  d_minimum_damage = this->getBaseDamage();
-  //   + d_inventory->calculateMinimumDamage();
-  //
-  d_maximum_damage = this->getBaseDamage();
-  //   + d_inventory->calculateMaximumDamage();
+  d_minimum_damage = minimum_damage;
+  d_maximum_damage = maximum_damage;
 
-  emit statsChanged();
+  if( stats_changed )
+    emit statsChanged();
 }
 
 // Connect to base stats changed signal
 void CharacterData::connectToBaseStatsChangedSignal()
 {
   QObject::connect( this, SIGNAL(coreStatIncremented()),
-                    this, SLOT(updateStats()) );
+                    this, SLOT(handleBaseStatsChanged()) );
 }
 
 // Connect to inventory signals
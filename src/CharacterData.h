@@ -16,6 +16,8 @@
 // Qt Includes
 #include <QObject>
 #include <QString>
+#include <QHash>
+#include <QList>
 
 // QtD1 Includes
 #include "Character.h"
@@ -23,6 +25,7 @@
 #include "Inventory.h"
 #include "SpellBook.h"
 #include "QuestLog.h"
+#include "SaveGameState.h"
 
 namespace QtD1{
 
@@ -33,14 +36,17 @@ class CharacterData : public ActorData
 
 public:
 
-  // The armor class state sprites type
-  typedef QMap<Inventory::ChestArmorState,std::shared_ptr<ActorData::StateDirectionGameSpriteMap> > ArmorClassStateGameSpriteMap;
+  //! The number of sprite sets (location, spell, weapon and armor states)
+  static const int s_number_of_sprite_sets =
+    2*(SpellBook::LightningSpellEquiped+1)*
+    (Inventory::NothingEquiped+1)*
+    (Inventory::HighClassArmorEquiped+1);
 
-  // The weapon state sprites type
-  typedef QMap<Inventory::WeaponState,ArmorClassStateGameSpriteMap> WeaponAndArmorClassStateGameSpriteMap;
-
-  // The spell state sprites type
-  typedef QMap<SpellBook::SpellState,WeaponAndArmorClassStateGameSpriteMap> SpellWeaponAndArmorClassStateGameSpriteMap;
+  //! Get the sprite set of a location, spell, weapon and armor state
+  static int getSpriteSet( const bool in_town,
+                           const SpellBook::SpellState spell_state,
+                           const Inventory::WeaponState weapon_state,
+                           const Inventory::ChestArmorState armor_state );
 
   //! Constructor
   CharacterData( QObject* parent = 0 );
@@ -71,6 +77,9 @@ public:
   //! Get the next level experience threshold
   int getNextLevelExperienceThreshold();
 
+  //! Set the gold amount
+  void setGold( const int gold );
+
   //! Get the gold amount
   int getGold();
 
@@ -137,35 +146,24 @@ public:
   //! Get the quest log
   const QuestLog& getQuestLog() const;
 
-  //! Get the character dungeon sprites
-  SpellWeaponAndArmorClassStateGameSpriteMap& getCharacterDungeonSprites();
-
-  //! Get the character dungeon sprites
-  const SpellWeaponAndArmorClassStateGameSpriteMap&
-  getCharacterDungeonSprites() const;
-
-  //! Get the character town sprites
-  WeaponAndArmorClassStateGameSpriteMap& getCharacterTownSprites();
-
-  //! Get the character town sprites
-  const WeaponAndArmorClassStateGameSpriteMap& getCharacterTownSprites() const;
+  //! Check if a sprite image asset has been loaded
+  bool isImageAssetLoaded( const QString& image_asset_name ) const;
 
-  //! Get the state direction sprites
-  QMap<QString,std::shared_ptr<ActorData::DirectionGameSpriteMap> >&
-  getDirectionSprites();
+  //! A sprite image asset has been loaded
+  void setImageAssetLoaded( const QString& image_asset_name,
+                            const qint64 image_asset_bytes );
 
-  //! Get the state direction sprites
-  const QMap<QString,std::shared_ptr<ActorData::DirectionGameSpriteMap> >&
-  getDirectionSprites() const;
+  //! A sprite image asset has not been loaded
+  void setImageAssetNotLoaded( const QString& image_asset_name );
 
-  //! Check if the sprites have been loaded
-  bool spritesLoaded() const;
+  //! No sprite image assets have been loaded
+  void setImageAssetsNotLoaded();
 
-  //! The sprites have been loaded
-  void setSpritesLoaded();
+  //! Get the loaded sprite image asset names
+  QList<QString> getLoadedImageAssetNames() const;
 
-  //! The sprites have not been loaded
-  void setSpritesNotLoaded();
+  //! Get the memory used by the loaded sprite image assets (bytes)
+  qint64 getLoadedImageAssetBytes() const;
 
   //! Get the active armor state
   Inventory::ChestArmorState getActiveArmorState() const;
@@ -179,6 +177,19 @@ public:
   //! Check if the character is in town
   bool isInTown() const;
 
+  //! Recalculate the stats that depend on the level and the base stats
+  void recalculateDerivedStats();
+
+  //! Save the character state (the location is not saved)
+  void saveState( SaveGameState::CharacterState& state ) const;
+
+  //! Restore the character state (the name and type are not restored)
+  void restoreState( const SaveGameState::CharacterState& state );
+
+protected:
+
+  //! Calculate the base stats that depend on the level and the total stats
+  virtual void calculateBaseStats();
 
 signals:
 
@@ -200,6 +211,9 @@ public slots:
 
 private slots:
 
+  void handleBaseStatsChanged();
+  void flushStats();
+
   void handleWeaponChanged( const Inventory::WeaponState state );
   void handleShieldChanged( const Inventory::WeaponState state );
   void handleRingChanged();
@@ -211,6 +225,21 @@ private slots:
 
 private:
 
+  // The stat sources that can be dirty
+  enum StatSource{
+    NoStatSource = 0x0,
+    BaseStatSource = 0x1,
+    InventoryStatSource = 0x2,
+    AllStatSources = BaseStatSource | InventoryStatSource
+  };
+
+  // Mark stat sources as dirty (the stats are recalculated once per
+  // event loop turn)
+  void invalidateStats( const int stat_sources );
+
+  // Recalculate the stats and emit the changes
+  void recalculateStats();
+
   // Connect to base stats changed signal
   void connectToBaseStatsChangedSignal();
 
@@ -247,12 +276,18 @@ private:
   // The character magic
   int d_magic;
 
+  // The character magic bonus (inventory modifier) that was last emitted
+  int d_magic_bonus;
+
   // The character dexterity
   int d_dexterity;
 
   // The character vitality
   int d_vitality;
 
+  // The character vitality bonus (inventory modifier) that was last emitted
+  int d_vitality_bonus;
+
   // The character max health
   int d_max_health;
 
@@ -295,18 +330,23 @@ private:
   // The quest log
   QuestLog* d_quest_log;
 
-  // The character dungeon sprites
-  SpellWeaponAndArmorClassStateGameSpriteMap d_dungeon_sprites;
+  // The dirty stat sources
+  int d_dirty_stat_sources;
+
+  // Records if a stat flush has been scheduled
+  bool d_stats_flush_scheduled;
+
+  // Records if the stats have been calculated at least once
+  bool d_stats_calculated;
 
-  // The character town sprites
-  WeaponAndArmorClassStateGameSpriteMap d_town_sprites;
+  // The cached inventory modifiers
+  Inventory::Modifiers d_inventory_modifiers;
 
-  // The direction sprites
-  QMap<QString,std::shared_ptr<ActorData::DirectionGameSpriteMap> >
-  d_direction_sprites;
+  // The loaded sprite image assets (and the memory that each one uses)
+  QHash<QString,qint64> d_loaded_image_assets;
 
-  // Records if the sprites have been loaded
-  bool d_sprites_loaded;
+  // The memory used by the loaded sprite image assets
+  qint64 d_loaded_image_asset_bytes;
 
   // The active character states
   Inventory::ChestArmorState d_active_armor_state;
@@ -0,0 +1,281 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   CharacterSpriteStreamer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The character sprite streamer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// QtD1 Includes
+#include "CharacterSpriteStreamer.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const qint64 CharacterSpriteStreamer::s_default_memory_budget;
+
+// Constructor
+CharacterSpriteStreamer::CharacterSpriteStreamer( Character* character,
+                                                  QObject* parent )
+  : QObject( parent ),
+    d_character( character ),
+    d_memory_budget( s_default_memory_budget ),
+    d_used_image_assets(),
+    d_required_image_assets(),
+    d_prefetch_image_assets(),
+    d_loading_image_assets(),
+    d_image_asset_loader( NULL )
+{
+  if( !character )
+    qFatal( "CharacterSpriteStreamer Error: The character cannot be NULL!" );
+
+  QObject::connect( d_character, SIGNAL(characterStateChanged()),
+                    this, SLOT(streamSpriteSets()) );
+}
+
+// Destructor
+/*! \details The image asset loader cannot be deleted while it is loading
+ * assets on another thread.
+ */
+CharacterSpriteStreamer::~CharacterSpriteStreamer()
+{
+  if( d_image_asset_loader )
+    d_image_asset_loader->waitForLoadToFinish();
+}
+
+// Set the memory budget (bytes)
+/*! \details If the memory used by the loaded image assets exceeds the new
+ * budget the least recently used image assets will be dumped immediately.
+ */
+void CharacterSpriteStreamer::setMemoryBudget( const qint64 memory_budget )
+{
+  d_memory_budget = memory_budget;
+
+  this->evictImageAssets();
+}
+
+// Get the memory budget (bytes)
+qint64 CharacterSpriteStreamer::getMemoryBudget() const
+{
+  return d_memory_budget;
+}
+
+// Get the memory used by the loaded character image assets (bytes)
+qint64 CharacterSpriteStreamer::getMemoryUsage() const
+{
+  return d_character->getLoadedImageAssetBytes();
+}
+
+// Get the number of image assets waiting to be loaded
+int CharacterSpriteStreamer::getNumberOfQueuedImageAssets() const
+{
+  return d_required_image_assets.size() + d_prefetch_image_assets.size();
+}
+
+// Check if image assets are being loaded
+bool CharacterSpriteStreamer::isStreaming() const
+{
+  return d_image_asset_loader != NULL;
+}
+
+// Stream in the active sprite set and prefetch the related sprite set
+/*! \details The previously queued image assets will be discarded (they
+ * belong to a sprite set that is no longer needed).
+ */
+void CharacterSpriteStreamer::streamSpriteSets()
+{
+  // The initial sprite set is loaded with the level
+  if( d_character->getLoadedImageAssetNames().empty() )
+    return;
+
+  QSet<QString> active_image_asset_names;
+  d_character->getActiveImageAssetNames( active_image_asset_names );
+
+  this->touchImageAssets( active_image_asset_names );
+
+  // Queue the missing image assets of the active sprite set
+  d_required_image_assets.clear();
+
+  QSet<QString>::const_iterator image_asset_name_it, image_asset_name_end;
+  image_asset_name_it = active_image_asset_names.begin();
+  image_asset_name_end = active_image_asset_names.end();
+
+  while( image_asset_name_it != image_asset_name_end )
+  {
+    if( !d_character->isImageAssetLoaded( *image_asset_name_it ) &&
+        !d_loading_image_assets.contains( *image_asset_name_it ) )
+      d_required_image_assets << *image_asset_name_it;
+
+    ++image_asset_name_it;
+  }
+
+  // Queue the image assets of the other location for the current equipment
+  QSet<QString> prefetch_image_asset_names;
+  d_character->getSpriteSetImageAssetNames( !d_character->isInTown(),
+                                            d_character->getActiveWeaponState(),
+                                            d_character->getActiveArmorState(),
+                                            prefetch_image_asset_names );
+
+  d_prefetch_image_assets.clear();
+
+  image_asset_name_it = prefetch_image_asset_names.begin();
+  image_asset_name_end = prefetch_image_asset_names.end();
+
+  while( image_asset_name_it != image_asset_name_end )
+  {
+    if( !d_character->isImageAssetLoaded( *image_asset_name_it ) &&
+        !d_loading_image_assets.contains( *image_asset_name_it ) )
+      d_prefetch_image_assets << *image_asset_name_it;
+
+    ++image_asset_name_it;
+  }
+
+  this->startNextLoad();
+}
+
+// Handle image asset loading finished
+void CharacterSpriteStreamer::handleImageAssetLoadingFinished( const int )
+{
+  ImageAssetLoader* image_asset_loader = d_image_asset_loader;
+  d_image_asset_loader = NULL;
+
+  d_character->loadRawImageAssets( *image_asset_loader->getLoadedAssets() );
+
+  // The loader sent the signal that called this slot - delete it later
+  image_asset_loader->deleteLater();
+
+  this->touchImageAssets( d_loading_image_assets );
+
+  // Refresh the active sprite if the active sprite set is now complete
+  QSet<QString> active_image_asset_names;
+  d_character->getActiveImageAssetNames( active_image_asset_names );
+
+  if( active_image_asset_names.intersect( d_loading_image_assets ).size() > 0 &&
+      d_character->imageAssetsLoaded() )
+  {
+    d_character->finalizeImageAssetLoading();
+
+    emit activeSpriteSetLoaded();
+  }
+
+  d_loading_image_assets.clear();
+
+  this->evictImageAssets();
+  this->startNextLoad();
+}
+
+// Mark image assets as most recently used
+/*! \details Image assets that were loaded by the level (instead of the
+ * streamer) will be treated as the least recently used assets. Image assets
+ * that are not loaded will be ignored.
+ */
+void CharacterSpriteStreamer::touchImageAssets(
+                                     const QSet<QString>& image_asset_names )
+{
+  // Synchronize the used image assets with the loaded image assets
+  QList<QString> loaded_image_asset_names =
+    d_character->getLoadedImageAssetNames();
+
+  QList<QString>::iterator used_image_asset_it =
+    d_used_image_assets.begin();
+
+  while( used_image_asset_it != d_used_image_assets.end() )
+  {
+    if( d_character->isImageAssetLoaded( *used_image_asset_it ) )
+      ++used_image_asset_it;
+    else
+      used_image_asset_it = d_used_image_assets.erase( used_image_asset_it );
+  }
+
+  QList<QString>::const_iterator loaded_image_asset_it =
+    loaded_image_asset_names.begin();
+
+  while( loaded_image_asset_it != loaded_image_asset_names.end() )
+  {
+    if( !d_used_image_assets.contains( *loaded_image_asset_it ) )
+      d_used_image_assets.prepend( *loaded_image_asset_it );
+
+    ++loaded_image_asset_it;
+  }
+
+  // Move the touched image assets to the back of the list
+  QSet<QString>::const_iterator image_asset_name_it =
+    image_asset_names.begin();
+
+  while( image_asset_name_it != image_asset_names.end() )
+  {
+    if( d_used_image_assets.removeOne( *image_asset_name_it ) )
+      d_used_image_assets << *image_asset_name_it;
+
+    ++image_asset_name_it;
+  }
+}
+
+// Start loading the next queued image assets
+/*! \details The missing image assets of the active sprite set are loaded
+ * together. Prefetched image assets are loaded one at a time so that a
+ * change in the character state never waits long for the loader.
+ */
+void CharacterSpriteStreamer::startNextLoad()
+{
+  // Only one load can be in progress
+  if( d_image_asset_loader )
+    return;
+
+  if( !d_required_image_assets.empty() )
+  {
+    d_loading_image_assets = d_required_image_assets.toSet();
+    d_required_image_assets.clear();
+  }
+  else if( !d_prefetch_image_assets.empty() )
+    d_loading_image_assets << d_prefetch_image_assets.takeFirst();
+  else
+    return;
+
+  d_image_asset_loader = new ImageAssetLoader( this );
+  d_image_asset_loader->setAssetsToLoad( d_loading_image_assets );
+
+  QObject::connect( d_image_asset_loader,
+                    SIGNAL(assetLoadingFinished(const int)),
+                    this,
+                    SLOT(handleImageAssetLoadingFinished(const int)) );
+
+  d_image_asset_loader->loadAssets();
+}
+
+// Dump the least recently used image assets until the budget is met
+/*! \details The image assets of the active sprite set are never dumped, so
+ * the budget can be exceeded if it is smaller than the active sprite set.
+ */
+void CharacterSpriteStreamer::evictImageAssets()
+{
+  if( d_character->getLoadedImageAssetBytes() <= d_memory_budget )
+    return;
+
+  QSet<QString> active_image_asset_names;
+  d_character->getActiveImageAssetNames( active_image_asset_names );
+
+  this->touchImageAssets( active_image_asset_names );
+
+  QList<QString>::iterator used_image_asset_it =
+    d_used_image_assets.begin();
+
+  while( used_image_asset_it != d_used_image_assets.end() &&
+         d_character->getLoadedImageAssetBytes() > d_memory_budget )
+  {
+    if( !active_image_asset_names.contains( *used_image_asset_it ) )
+    {
+      d_character->dumpImageAsset( *used_image_asset_it );
+
+      used_image_asset_it = d_used_image_assets.erase( used_image_asset_it );
+    }
+    else
+      ++used_image_asset_it;
+  }
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end CharacterSpriteStreamer.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,122 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   CharacterSpriteStreamer.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The character sprite streamer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef CHARACTER_SPRITE_STREAMER_H
+#define CHARACTER_SPRITE_STREAMER_H
+
+// Qt Includes
+#include <QObject>
+#include <QSet>
+#include <QList>
+#include <QString>
+
+// QtD1 Includes
+#include "Character.h"
+#include "ImageAssetLoader.h"
+
+namespace QtD1{
+
+/*! The character sprite streamer
+ *
+ * The character sprite sets (one per location, weapon and armor state) are
+ * streamed in on demand. When the character state changes the missing image
+ * assets of the active sprite set are loaded first. The sprite set of the
+ * other location (town or dungeon) for the current equipment is then
+ * prefetched one image asset at a time in the background. Loaded image
+ * assets are tracked in least recently used order - when the memory used by
+ * the character image assets exceeds the memory budget the least recently
+ * used assets that are not part of the active sprite set will be dumped.
+ *
+ * The initial sprite set is loaded with the level assets. The streamer will
+ * not load anything until the character has at least one loaded image asset.
+ */
+class CharacterSpriteStreamer : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  //! The default memory budget (bytes)
+  static const qint64 s_default_memory_budget = 64*1024*1024;
+
+  //! Constructor
+  CharacterSpriteStreamer( Character* character, QObject* parent = 0 );
+
+  //! Destructor
+  ~CharacterSpriteStreamer();
+
+  //! Set the memory budget (bytes)
+  void setMemoryBudget( const qint64 memory_budget );
+
+  //! Get the memory budget (bytes)
+  qint64 getMemoryBudget() const;
+
+  //! Get the memory used by the loaded character image assets (bytes)
+  qint64 getMemoryUsage() const;
+
+  //! Get the number of image assets waiting to be loaded
+  int getNumberOfQueuedImageAssets() const;
+
+  //! Check if image assets are being loaded
+  bool isStreaming() const;
+
+signals:
+
+  //! The image assets of the active sprite set have been loaded
+  void activeSpriteSetLoaded();
+
+public slots:
+
+  //! Stream in the active sprite set and prefetch the related sprite set
+  void streamSpriteSets();
+
+private slots:
+
+  // Handle image asset loading finished
+  void handleImageAssetLoadingFinished( const int number_of_assets_loaded );
+
+private:
+
+  // Mark image assets as most recently used
+  void touchImageAssets( const QSet<QString>& image_asset_names );
+
+  // Start loading the next queued image assets
+  void startNextLoad();
+
+  // Dump the least recently used image assets until the budget is met
+  void evictImageAssets();
+
+  // The character
+  Character* d_character;
+
+  // The memory budget
+  qint64 d_memory_budget;
+
+  // The loaded image assets (least recently used first)
+  QList<QString> d_used_image_assets;
+
+  // The image assets of the active sprite set that must be loaded
+  QList<QString> d_required_image_assets;
+
+  // The image assets that will be prefetched
+  QList<QString> d_prefetch_image_assets;
+
+  // The image assets that are being loaded
+  QSet<QString> d_loading_image_assets;
+
+  // The image asset loader (only exists while assets are being loaded)
+  ImageAssetLoader* d_image_asset_loader;
+};
+
+} // end QtD1 namespace
+
+#endif // end CHARACTER_SPRITE_STREAMER_H
+
+//---------------------------------------------------------------------------//
+// end CharacterSpriteStreamer.h
+//---------------------------------------------------------------------------//
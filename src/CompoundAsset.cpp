@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   CompoundAsset.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The compound asset class definition
+//!
+//---------------------------------------------------------------------------//
+
+// QtD1 Includes
+#include "CompoundAsset.h"
+
+namespace QtD1{
+
+// Constructor
+CompoundAsset::CompoundAsset()
+  : d_file_names(),
+    d_parts()
+{ /* ... */ }
+
+// Add a part
+void CompoundAsset::addPart( const QString& file_name_with_path,
+                             const QByteArray& data )
+{
+  d_file_names << file_name_with_path;
+  d_parts << data;
+}
+
+// Get the number of parts
+int CompoundAsset::getNumberOfParts() const
+{
+  return d_parts.size();
+}
+
+// Get the file names (with paths) of the parts
+const QStringList& CompoundAsset::getFileNames() const
+{
+  return d_file_names;
+}
+
+// Get the file name (with path) of a part
+const QString& CompoundAsset::getPartFileName( const int part ) const
+{
+  return d_file_names[part];
+}
+
+// Get the data of a part
+const QByteArray& CompoundAsset::getPartData( const int part ) const
+{
+  return d_parts[part];
+}
+
+// Find the first part with a file extension (-1 if there is none)
+int CompoundAsset::findPart( const QString& file_extension ) const
+{
+  for( int i = 0; i < d_file_names.size(); ++i )
+  {
+    if( d_file_names[i].endsWith( file_extension, Qt::CaseInsensitive ) )
+      return i;
+  }
+
+  return -1;
+}
+
+// Get the size of all parts (bytes)
+qint64 CompoundAsset::getSize() const
+{
+  qint64 size = 0;
+
+  for( int i = 0; i < d_parts.size(); ++i )
+    size += d_parts[i].size();
+
+  return size;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end CompoundAsset.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,75 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   CompoundAsset.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The compound asset class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef COMPOUND_ASSET_H
+#define COMPOUND_ASSET_H
+
+// Qt Includes
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+
+namespace QtD1{
+
+/*! The compound asset
+ *
+ * A compound asset holds the extracted data of each file in a concatenated
+ * asset string (e.g. "/levels/towndata/town.cel+/levels/towndata/town.pal")
+ * as a separate part. The part data is implicitly shared so handing out a
+ * part (or copying the asset) never copies the file data.
+ */
+class CompoundAsset
+{
+
+public:
+
+  //! Constructor
+  CompoundAsset();
+
+  //! Destructor
+  ~CompoundAsset()
+  { /* ... */ }
+
+  //! Add a part
+  void addPart( const QString& file_name_with_path, const QByteArray& data );
+
+  //! Get the number of parts
+  int getNumberOfParts() const;
+
+  //! Get the file names (with paths) of the parts
+  const QStringList& getFileNames() const;
+
+  //! Get the file name (with path) of a part
+  const QString& getPartFileName( const int part ) const;
+
+  //! Get the data of a part
+  const QByteArray& getPartData( const int part ) const;
+
+  //! Find the first part with a file extension (-1 if there is none)
+  int findPart( const QString& file_extension ) const;
+
+  //! Get the size of all parts (bytes)
+  qint64 getSize() const;
+
+private:
+
+  // The file names (with paths) of the parts
+  QStringList d_file_names;
+
+  // The data of the parts
+  QVector<QByteArray> d_parts;
+};
+
+} // end QtD1 namespace
+
+#endif // end COMPOUND_ASSET_H
+
+//---------------------------------------------------------------------------//
+// end CompoundAsset.h
+//---------------------------------------------------------------------------//
@@ -9,14 +9,20 @@
 // Std Lib Includes
 #include <iostream>
 
+// Qt Includes
+#include <QPixmap>
+
 // QtD1 Includes
 #include "CursorDatabase.h"
-#include "MenuSprite.h"
+#include "PCXFrameLoader.h"
+#include "CelFrameLoader.h"
 
 namespace QtD1{
 
 // Initialize static member data
 std::unique_ptr<CursorDatabase> CursorDatabase::s_instance;
+QImage CursorDatabase::s_ui_cursor_image;
+QVector<QImage> CursorDatabase::s_game_cursor_images;
   
 //! Get the singleton instance
 CursorDatabase* CursorDatabase::getInstance()
@@ -27,6 +33,35 @@ CursorDatabase* CursorDatabase::getInstance()
   return s_instance.get();
 }
 
+// Load the cursors (can be called from a worker thread)
+/*! \details Only the cursor images are decoded. The cursors are created
+ * from the images on the GUI thread when the database is first requested
+ * (see getInstance). Images that have already been decoded are not decoded
+ * again.
+ */
+void CursorDatabase::loadCursors()
+{
+  // Load the ui cursor image
+  if( s_ui_cursor_image.isNull() )
+  {
+    PCXFrameLoader cursor_loader;
+    cursor_loader.setSource( "/ui_art/cursor.pcx" );
+    cursor_loader.setTransparentColor( "black" );
+
+    s_ui_cursor_image = cursor_loader.decodeFrames()->front();
+  }
+
+  // Load the game cursor images
+  if( s_game_cursor_images.isEmpty() )
+  {
+    CelFrameLoader game_cursor_loader;
+    game_cursor_loader.setSource(
+                         "/data/inv/objcurs.cel+/levels/towndata/town.pal" );
+
+    s_game_cursor_images = *game_cursor_loader.decodeFrames();
+  }
+}
+
 // Default Constructor (this is only included for qml registration)
 /* \details Never call this constructor directly.
  */
@@ -35,6 +70,8 @@ CursorDatabase::CursorDatabase( QObject* parent )
 { /* ... */ }
 
 // Constructor
+/*! \details QCursors can only be created on the GUI thread.
+ */
 CursorDatabase::CursorDatabase( const bool load_cursors )
   : d_ui_cursor(),
     d_game_cursors(),
@@ -42,35 +79,25 @@ CursorDatabase::CursorDatabase( const bool load_cursors )
 {
   if( load_cursors )
   {
-    // Load the ui cursor
-    QtD1::MenuSprite cursor_sprite;
-    cursor_sprite.setSource( "/ui_art/cursor.pcx" );
-    cursor_sprite.setBackgroundColor( "black" );
-    cursor_sprite.loadSync();
-    
-    QPixmap ui_cursor_image = cursor_sprite.getFrame( 0 );
+    // Decode any cursor images that have not been decoded yet
+    CursorDatabase::loadCursors();
     
     // The cursor hotspot will be the upper-left corner (0,0)
-    d_ui_cursor = QCursor( ui_cursor_image, 0, 0 );
-    
-    // Load the game cursors
-    QtD1::MenuSprite game_cursor_sprites;
-    game_cursor_sprites.setSource( "/data/inv/objcurs.cel+/levels/towndata/town.pal" );
-    game_cursor_sprites.setDisplayedFrameIndices( "all" );
-    game_cursor_sprites.loadSync();
-    
-    QVector<QPixmap> game_cursor_images;
-    game_cursor_sprites.getFrames( game_cursor_images );
+    d_ui_cursor = QCursor( QPixmap::fromImage( s_ui_cursor_image ), 0, 0 );
     
-    d_game_cursors.resize( game_cursor_images.size() );
+    // Create the game cursors
+    d_game_cursors.resize( s_game_cursor_images.size() );
     
-    for( int i = 0; i < game_cursor_images.size(); ++i )
+    for( int i = 0; i < s_game_cursor_images.size(); ++i )
     {
+      QPixmap game_cursor_image =
+        QPixmap::fromImage( s_game_cursor_images[i] );
+      
       // The first 10 cursors have a hotspot at the upper-left corner (0,0)
       if( i < 10 )
-        d_game_cursors[i] = QCursor( game_cursor_images[i], 0, 0 );
+        d_game_cursors[i] = QCursor( game_cursor_image, 0, 0 );
       else
-        d_game_cursors[i] = QCursor( game_cursor_images[i] );
+        d_game_cursors[i] = QCursor( game_cursor_image );
     }
   }
 }
@@ -218,6 +218,9 @@ public:
   //! Get the singleton instance
   static CursorDatabase* getInstance();
 
+  //! Load the cursors (can be called from a worker thread)
+  static void loadCursors();
+
   //! Default Constructor (this is only included for qml registration)
   CursorDatabase( QObject* parent = 0 );
 
@@ -254,6 +257,12 @@ private:
   // The singleton instance
   static std::unique_ptr<CursorDatabase> s_instance;
 
+  // The decoded ui cursor image
+  static QImage s_ui_cursor_image;
+
+  // The decoded game cursor images
+  static QVector<QImage> s_game_cursor_images;
+
   // The ui cursor
   QCursor d_ui_cursor;
   
@@ -28,12 +28,8 @@ void CustomMPQFileHeader::addElement( const QString& filename_with_path,
   d_header.push_back( Element{filename_with_path, start_location} );
 }
 
-// Add header to buffer
-/*! \details The position in the modified buffer where the data starts will
- * be returned.
- */
-qint64 CustomMPQFileHeader::addToBuffer(
-                                      QByteArray& buffer_without_header ) const
+// Serialize the header
+QByteArray CustomMPQFileHeader::serialize() const
 {
   QByteArray serialized_header_data;
   QDataStream header_data_serializer( &serialized_header_data,
@@ -50,6 +46,18 @@ qint64 CustomMPQFileHeader::addToBuffer(
                            << d_header[i].start_location;
   }
 
+  return serialized_header_data;
+}
+
+// Add header to buffer
+/*! \details The position in the modified buffer where the data starts will
+ * be returned.
+ */
+qint64 CustomMPQFileHeader::addToBuffer(
+                                      QByteArray& buffer_without_header ) const
+{
+  QByteArray serialized_header_data = this->serialize();
+
   buffer_without_header.prepend( serialized_header_data );
 
   return serialized_header_data.size();
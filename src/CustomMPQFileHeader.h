@@ -43,6 +43,9 @@ public:
   void addElement( const QString& filename_with_path,
                    const qint64 start_location );
 
+  //! Serialize the header
+  QByteArray serialize() const;
+
   //! Add header to buffer
   qint64 addToBuffer( QByteArray& buffer_without_header ) const;
 
@@ -42,6 +42,42 @@ QString FrameLoader::getSource() const
   return d_source;
 }
 
+// Get the image asset cache key of the frames
+/*! \details Frame loaders that modify the frames of the source (e.g. by
+ * making a color transparent) must add the modifications to the key.
+ */
+QString FrameLoader::getCacheKey() const
+{
+  return d_source;
+}
+
+// Decode all of the frames from the source (no signals are emitted)
+/*! \details The frames will only be decoded if they are not resident in the
+ * image asset cache. The decoded frames are added to the cache. Only QImages
+ * are created so this can be called from any thread.
+ */
+ImageAssetCache::AssetHandle FrameLoader::decodeFrames()
+{
+  ImageAssetCache* asset_cache = ImageAssetCache::getInstance();
+
+  ImageAssetCache::AssetHandle frames =
+    asset_cache->find( this->getCacheKey() );
+
+  if( !frames )
+  {
+    ImageAssetCache::Asset loaded_frames( this->getReadyForFrameLoading() );
+
+    for( int i = 0; i < loaded_frames.size(); ++i )
+      loaded_frames[i] = this->loadFrame( i );
+
+    this->finishFrameLoading();
+
+    frames = asset_cache->insert( this->getCacheKey(), loaded_frames );
+  }
+
+  return frames;
+}
+
 // Load the frames from the source
 void FrameLoader::loadFrames()
 {
@@ -87,25 +123,40 @@ void FrameLoader::handleAsyncFrameLoadingFinished()
 }
 
 // Load the frames from the source implementation
+/*! \details The frames are decoded with decodeFrames, which uses the image
+ * asset cache.
+ */
 void FrameLoader::loadAllFramesImpl( FrameLoader* obj )
 {
-  int number_of_frames = obj->getReadyForFrameLoading();
+  ImageAssetCache::AssetHandle frames = obj->decodeFrames();
 
   QList<int> frame_indices;
-  
-  for( int i = 0; i < number_of_frames; ++i )
+
+  for( int i = 0; i < frames->size(); ++i )
     frame_indices << i;
 
-  FrameLoader::loadFramesLoop( frame_indices, number_of_frames, obj );
+  FrameLoader::emitCachedFrames( frame_indices, *frames, obj );
 }
 
 // Load the frames from the source implementation
+/*! \details If all frames of the source are resident in the image asset
+ * cache the selected frames will be taken from the cache. Otherwise only the
+ * selected frames are decoded (they are not added to the cache).
+ */
 void FrameLoader::loadFramesImpl( QList<int> frame_indices,
                                   FrameLoader* obj )
 {
-  int number_of_frames = obj->getReadyForFrameLoading();
+  ImageAssetCache::AssetHandle frames =
+    ImageAssetCache::getInstance()->find( obj->getCacheKey() );
 
-  FrameLoader::loadFramesLoop( frame_indices, number_of_frames, obj );
+  if( frames )
+    FrameLoader::emitCachedFrames( frame_indices, *frames, obj );
+  else
+  {
+    int number_of_frames = obj->getReadyForFrameLoading();
+
+    FrameLoader::loadFramesLoop( frame_indices, number_of_frames, obj );
+  }
 }
 
 // Load the frames
@@ -120,7 +171,7 @@ void FrameLoader::loadFramesLoop( const QList<int>& frame_indices,
 
     if( frame_index >= 0 && frame_index < total_frames )
     {
-      QImage frame = obj->loadFrame( i );
+      QImage frame = obj->loadFrame( frame_index );
     
       emit obj->frameLoaded( frame_index, frame );
     }
@@ -135,6 +186,27 @@ void FrameLoader::loadFramesLoop( const QList<int>& frame_indices,
 
   emit obj->sourceLoaded( obj->getSource() );
 }
+
+// Emit the frames of a cached asset
+void FrameLoader::emitCachedFrames( const QList<int>& frame_indices,
+                                    const ImageAssetCache::Asset& frames,
+                                    FrameLoader* obj )
+{
+  for( int i = 0; i < frame_indices.size(); ++i )
+  {
+    int frame_index = frame_indices[i];
+
+    if( frame_index >= 0 && frame_index < frames.size() )
+      emit obj->frameLoaded( frame_index, frames[frame_index] );
+    else
+    {
+      qWarning( "FrameLoader Warning: Encountered an invalid frame index: "
+                "%i not in [0,%i]", frame_index, frames.size()-1 );
+    }
+  }
+
+  emit obj->sourceLoaded( obj->getSource() );
+}
   
 } // end QtD1 namespace
 
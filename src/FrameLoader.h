@@ -17,6 +17,9 @@
 #include <QFuture>
 #include <QFutureWatcher>
 
+// QtD1 Includes
+#include "ImageAssetCache.h"
+
 namespace QtD1{
 
 //! The frame loader
@@ -39,6 +42,12 @@ public:
   //! Get the source
   QString getSource() const;
 
+  //! Get the image asset cache key of the frames
+  virtual QString getCacheKey() const;
+
+  //! Decode all of the frames from the source (no signals are emitted)
+  ImageAssetCache::AssetHandle decodeFrames();
+
 signals:
 
   void frameLoaded( const int frame_index, QImage frame );
@@ -92,6 +101,11 @@ private:
                               const int total_frames,
                               FrameLoader* obj );
 
+  // Emit the frames of a cached asset
+  static void emitCachedFrames( const QList<int>& frame_indices,
+                                const ImageAssetCache::Asset& frames,
+                                FrameLoader* obj );
+
   // The source
   QString d_source;
 
@@ -8,9 +8,11 @@
 
 // Std Lib Includes
 #include <utility>
+#include <iostream>
 
 // Qt Includes
 #include <QtConcurrentRun>
+#include <QKeyEvent>
 
 // QtD1 Includes
 #include "Game.h"
@@ -20,9 +22,12 @@
 #include "Rogue.h"
 #include "Sorcerer.h"
 #include "Warrior.h"
+#include "SaveGameFile.h"
 #include "qtd1_config.h"
 #include "AudioDevice.h"
+#include "SoftwareMixer.h"
 #include "MainWindow.h"
+#include "Telemetry.h"
 
 namespace QtD1{
 
@@ -42,20 +47,30 @@ Game* Game::getInstance()
   Game::Game()
   : QWidget(),
     d_character(),
+    d_character_sprite_streamer(),
     d_game_timer_id( -1 ),
+    d_simulation_clock( s_tick_duration ),
     d_game_paused( true ),
+    d_save_game_writer(),
+    d_ticks_since_autosave( 0 ),
+    d_game_save_requested( false ),
     d_loading_screen( new LoadingScreen( this ) ),
     d_game_control_panel( new QDeclarativeView( this ) ),
     d_character_stats( new QDeclarativeView( this ) ),
     d_game_menu( new QDeclarativeView( this ) ),
     d_game_options_menu( new QDeclarativeView( this ) ),
     d_level( new Town ),
-    d_level_viewer( new QGraphicsView( d_level, this ) )
+    d_level_viewer( new QGraphicsView( d_level, this ) ),
+    d_telemetry_overlay( new TelemetryOverlay( this ) ),
+    d_character_stats_loaded( false ),
+    d_game_menu_loaded( false ),
+    d_game_options_menu_loaded( false )
 {
   // Move the loading screen
   d_loading_screen->move( 0, 0 );
 
-  // Set up the level
+  // Set up the level (the background is created by worker threads while
+  // the title and loading screens are shown)
   d_level->createBackground();
 
   QPixmap level_background( d_level_viewer->size() );
@@ -70,19 +85,33 @@ Game* Game::getInstance()
                                         QGraphicsView::DontSavePainterState |
                                         QGraphicsView::DontAdjustForAntialiasing );
 
+  // The telemetry overlay is toggled with F12
+  d_telemetry_overlay->move( 0, 0 );
+  d_telemetry_overlay->hide();
+
   // Create the menu item over sound
   d_game_menu_item_over_sound.setSource( "/sfx/items/titlemov.wav" );
+  d_game_menu_item_over_sound.setPriority( SoundBank::InterfacePriority );
 
   // Create the menu item click sound
   d_game_menu_item_click_sound.setSource( "/sfx/items/titlslct.wav" );
+  d_game_menu_item_click_sound.setPriority( SoundBank::InterfacePriority );
 
   // Create the control panel click sound
   d_control_panel_click_sound.setSource( "/sfx/items/titlemov.wav" );
+  d_control_panel_click_sound.setPriority( SoundBank::InterfacePriority );
+
+  // Track the game saves
+  QObject::connect( &d_save_game_writer, SIGNAL(saveFinished(const bool)),
+                    this, SLOT(handleGameSaveFinished(const bool)) );
 }
 
 // Destructor
 Game::~Game()
 {
+  // Make sure that the last save has been written
+  d_save_game_writer.waitForSaveToFinish();
+
   // Make sure that the character doesn't get deleted twice
   if( d_character )
     d_level->removeItem( d_character.get() );
@@ -94,72 +123,59 @@ QDeclarativeView* Game::getGameMenu()
   return d_game_menu;
 }
 
+// Get the simulation clock (tick and frame timings)
+const SimulationClock& Game::getSimulationClock() const
+{
+  return d_simulation_clock;
+}
+
 // Create a new game
 void Game::create( const QString& character_name,
                    const int character_class )
 {
   emit gameLoadStarted();
 
-  // Create a new character
-  switch( character_class )
-  {
-    case Character::Rogue:
-    {
-      d_character.reset( new Rogue( character_name ) );
-      break;
-    }
-    case Character::Sorcerer:
-    {
-      d_character.reset( new Sorcerer( character_name ) );
-      break;
-    }
-    case Character::Warrior:
-    {
-      d_character.reset( new Warrior( character_name ) );
-      break;
-    }
-    default:
-      qFatal( "Error: invalid character class! The game cannot be created." );
-  }
-
-  // Initialize the loading screen
-  d_loading_screen->trackAssetLoadProgression(
-                                             d_level, LoadingScreen::newGame );
-
-  // Add the character to the level
-  d_level->insertCharacter( d_character.get(),
-                            QPointF( 3250, 2450 ),
-                            South );
-
-  // Load the level assets
-  QObject::connect( d_level, SIGNAL(assetLoadingStarted(const int)),
-                    this, SLOT(handleTownAssetLoadStarted()) );
-  QObject::connect( d_level, SIGNAL(assetLoadingFinished(const int)),
-                    this, SLOT(handleTownAssetLoadFinished()) );
+  this->createCharacter( character_name, character_class );
 
-  d_level->loadImageAssets();
+  this->loadTown( QPointF( 3250, 2450 ), South );
 }
 
 // Restore a previous game
+/*! \details The save game file of the character is read with a single
+ * sequential read.
+ */
 void Game::restore( const QString& character_name )
 {
-  // Game* game = Game::getInstance();
+  SaveGameState state;
 
-  // restored_character = Character::restore( character_name );
+  if( !SaveGameFile::read( SaveGameFile::getFileName( character_name ),
+                           state ) )
+  {
+    qWarning( "Game Warning: Unable to restore the save game of "
+              "character %s!", character_name.toLatin1().data() );
+    return;
+  }
 
-  // // Make sure that the restore was successful
-  // if( !restored_character )
-  //   qFatal( "Unable to restore character %s state!", character_name );
+  emit gameLoadStarted();
 
-  // game->d_character.reset( restored_character );
+  const SaveGameState::CharacterState& character_state =
+    state.getCharacterState();
 
-  // game->connectCharacterSignalsToGameSlots();
+  this->createCharacter( character_state.name, character_state.type );
 
-  // // Restart the game timer
-  // d_game_timer_id = this->startTimer( s_refresh_delay_time );
-  // d_game_paused = false;
+  // Restore the character state (the max health and mana are recalculated
+  // before the health and mana are restored)
+  d_character->restoreState( character_state );
 
-  // // Restore the rest of the game
+  // Only the town can be entered right now - a character that was saved in
+  // another level will start at the town entrance
+  if( character_state.level_number == d_level->getNumber() )
+  {
+    this->loadTown( character_state.position,
+                    (Direction)character_state.direction );
+  }
+  else
+    this->loadTown( QPointF( 3250, 2450 ), South );
 }
 
 // Pause the game
@@ -171,6 +187,7 @@ void Game::pause()
     {
       this->killTimer( d_game_timer_id );
       d_game_timer_id = -1;
+      d_simulation_clock.stop();
       d_game_paused = true;
     }
   }
@@ -183,7 +200,8 @@ void Game::resume()
   {
     if( d_game_timer_id < 0 )
     {
-      d_game_timer_id = this->startTimer( s_refresh_delay_time );
+      d_game_timer_id = this->startTimer( s_frame_delay_time );
+      d_simulation_clock.start();
       d_game_paused = false;
     }
   }
@@ -196,9 +214,19 @@ void Game::quit()
 }
 
 // Save the game
+/*! \details The save game file is written by a worker thread from a
+ * snapshot of the game state.
+ */
 void Game::save()
 {
+  if( !d_character )
+    return;
 
+  emit gameSaveStarted();
+
+  d_game_save_requested = true;
+
+  d_save_game_writer.save( this->createSaveGameState() );
 }
 
 // Play the game music
@@ -241,14 +269,29 @@ void Game::playControlPanelClickSound()
 void Game::setGameMusicVolume( int volume )
 {
   AudioDevice::getInstance().setMusicVolume( volume );
+
+  SoftwareMixer::getInstance()->setBusVolume( SoftwareMixer::MusicBus,
+                                              volume );
 }
 
 void Game::setGameSoundVolume( int volume )
 {
-  int number_of_channels = AudioDevice::getInstance().getNumberOfChannels();
+  SoftwareMixer* mixer = SoftwareMixer::getInstance();
+
+  // The software mixer volumes are single atomic writes
+  if( mixer->isEnabled() )
+  {
+    mixer->setBusVolume( SoftwareMixer::EffectBus, volume );
+    mixer->setBusVolume( SoftwareMixer::VoiceBus, volume );
+  }
+  else
+  {
+    int number_of_channels =
+      AudioDevice::getInstance().getNumberOfMixerChannels();
 
-  for( int i = 0; i < number_of_channels; ++i )
-    AudioDevice::getInstance().setMixerChannelVolume( i, volume );
+    for( int i = 0; i < number_of_channels; ++i )
+      AudioDevice::getInstance().setMixerChannelVolume( i, volume );
+  }
 }
 
 // Show the loading screen
@@ -317,6 +360,8 @@ void Game::hideCharacterSpellBook()
 // Show the character stats
 void Game::showCharacterStats()
 {
+  this->loadCharacterStats();
+
   emit characterStatsWidgetActivated();
 
   d_character_stats->show();
@@ -349,6 +394,8 @@ void Game::hideQuestLog()
 // Show the game menu
 void Game::showGameMenu()
 {
+  this->loadGameMenu();
+
   this->pause();
 
   emit gameMenuWidgetActivated();
@@ -372,6 +419,8 @@ void Game::hideGameMenu()
 // Show the game options menu
 void Game::showGameOptionsMenu()
 {
+  this->loadGameOptionsMenu();
+
   emit gameOptionsMenuWidgetActivated();
 
   d_game_options_menu->show();
@@ -425,15 +474,68 @@ void Game::resizeEvent( QResizeEvent* event )
 }
 
 // Handle the timer event
-void Game::timerEvent( QTimerEvent* event )
+/*! \details The timer fires once per frame. The level simulation is advanced
+ * in fixed ticks so that the game speed does not depend on the frame rate.
+ * All ticks that are simulated in a single frame are repainted together
+ * since the scene only repaints when control returns to the event loop (the
+ * update time telemetry does not include the rendering - see the paint time
+ * telemetry).
+ */
+void Game::timerEvent( QTimerEvent* )
 {
-  d_level->advance();
+  Telemetry::ScopedTimer update_timer( Telemetry::GameUpdateTimeHistogram );
+
+  int number_of_ticks = d_simulation_clock.startFrame();
+
+  for( int i = 0; i < number_of_ticks; ++i )
+  {
+    Telemetry::ScopedTimer tick_timer( Telemetry::GameTickTimeHistogram );
+
+    d_simulation_clock.startTick();
+
+    d_level->advanceTick();
+
+    d_simulation_clock.finishTick();
+  }
+
+  // Only the sections of the game state that have changed since the last
+  // save are written by an autosave
+  d_ticks_since_autosave += number_of_ticks;
+
+  if( d_ticks_since_autosave >= s_autosave_interval )
+  {
+    d_ticks_since_autosave = 0;
+
+    d_save_game_writer.saveIncremental( this->createSaveGameState() );
+  }
+
+  d_level->interpolateActors( d_simulation_clock.getInterpolationFraction() );
+
+  // Keep the per-thread trace buffers from overflowing
+  if( Telemetry::isTracing() )
+    Telemetry::getInstance()->drainTraceBuffers();
 }
 
 // Handle key press events
+/*! \details F12 toggles the telemetry overlay and F11 starts or stops the
+ * telemetry trace.
+ */
 void Game::keyPressEvent( QKeyEvent* event )
 {
-
+  if( event->key() == Qt::Key_F12 && !event->isAutoRepeat() )
+  {
+    if( d_telemetry_overlay->isVisible() )
+      d_telemetry_overlay->hide();
+    else
+    {
+      d_telemetry_overlay->raise();
+      d_telemetry_overlay->show();
+    }
+  }
+  else if( event->key() == Qt::Key_F11 && !event->isAutoRepeat() )
+    this->toggleTelemetryTrace();
+  else
+    QWidget::keyPressEvent( event );
 }
 
 // Handle key release events
@@ -472,6 +574,75 @@ void Game::handleCharacterLevelUp( const int )
   // Show the level up button
 }
 
+// Load the character stats menu (if it has not been loaded)
+void Game::loadCharacterStats()
+{
+  if( d_character_stats_loaded )
+    return;
+
+  d_character_stats->setSource( QUrl( CHARACTER_STATS_QML_PATH ) );
+  d_character_stats->move( 80, 119 );
+
+  CharacterFrontendProxy::connectToBackend( d_character_stats, d_character.get() );
+  GameFrontendProxy::connectToBackend(
+                                   d_character_stats,
+                                   SIGNAL(characterStatsWidgetActivated()),
+                                   SIGNAL(characterStatsWidgetDeactivated()) );
+
+  d_character_stats_loaded = true;
+}
+
+// Load the game menu (if it has not been loaded)
+void Game::loadGameMenu()
+{
+  if( d_game_menu_loaded )
+    return;
+
+  d_game_menu->setSource( QUrl( GAME_MENU_QML_PATH ) );
+  d_game_menu->setStyleSheet( QString("background: transparent") );
+
+  GameFrontendProxy::connectToBackend( d_game_menu,
+                                       SIGNAL(gameMenuWidgetActivated()),
+                                       SIGNAL(gameMenuWidgetDeactivated()) );
+
+  d_game_menu_loaded = true;
+}
+
+// Load the game options menu (if it has not been loaded)
+void Game::loadGameOptionsMenu()
+{
+  if( d_game_options_menu_loaded )
+    return;
+
+  d_game_options_menu->setSource( QUrl( GAME_OPTIONS_MENU_QML_PATH ) );
+  d_game_options_menu->setStyleSheet( QString("background: transparent") );
+
+  GameFrontendProxy::connectToBackend( d_game_options_menu,
+                                       SIGNAL(gameOptionsMenuWidgetActivated()),
+                                       SIGNAL(gameOptionsMenuWidgetDeactivated()) );
+
+  d_game_options_menu_loaded = true;
+}
+
+// Toggle the telemetry trace (the trace is exported when it is stopped)
+/*! \details The trace is written to qtd1_trace.json in the working
+ * directory (it can be opened with chrome://tracing).
+ */
+void Game::toggleTelemetryTrace()
+{
+  Telemetry* telemetry = Telemetry::getInstance();
+
+  if( Telemetry::isTracing() )
+  {
+    telemetry->stopTrace();
+
+    if( telemetry->exportChromeTrace( "qtd1_trace.json" ) )
+      std::cout << "Telemetry trace written to qtd1_trace.json" << std::endl;
+  }
+  else
+    telemetry->startTrace();
+}
+
 // Handle the character death
 void Game::handleCharacterDeath()
 {
@@ -486,6 +657,9 @@ void Game::handleTownAssetLoadStarted()
 
 void Game::handleTownAssetLoadFinished()
 {
+  // Prefetch the character sprite sets that will be needed next
+  d_character_sprite_streamer->streamSpriteSets();
+
   // Load the control panel
   d_game_control_panel->setSource( QUrl( GAME_CONTROL_PANEL_QML_PATH ) );
   d_game_control_panel->setAutoFillBackground( false );
@@ -500,31 +674,9 @@ void Game::handleTownAssetLoadFinished()
                                      SIGNAL(controlPanelWidgetActivated()),
                                      SIGNAL(controlPanelWidgetDeactivated()) );
 
-  // Load the character stats menu
-  d_character_stats->setSource( QUrl( CHARACTER_STATS_QML_PATH ) );
-  d_character_stats->move( 80, 119 );
-
-  CharacterFrontendProxy::connectToBackend( d_character_stats, d_character.get() );
-  GameFrontendProxy::connectToBackend(
-                                   d_character_stats,
-                                   SIGNAL(characterStatsWidgetActivated()),
-                                   SIGNAL(characterStatsWidgetDeactivated()) );
-
-  // Load the game menu
-  d_game_menu->setSource( QUrl( GAME_MENU_QML_PATH ) );
-  d_game_menu->setStyleSheet( QString("background: transparent") );
-
-  GameFrontendProxy::connectToBackend( d_game_menu,
-                                       SIGNAL(gameMenuWidgetActivated()),
-                                       SIGNAL(gameMenuWidgetDeactivated()) );
-
-  // Load the game options menu
-  d_game_options_menu->setSource( QUrl( GAME_OPTIONS_MENU_QML_PATH ) );
-  d_game_options_menu->setStyleSheet( QString("background: transparent") );
-
-  GameFrontendProxy::connectToBackend( d_game_options_menu,
-                                       SIGNAL(gameOptionsMenuWidgetActivated()),
-                                       SIGNAL(gameOptionsMenuWidgetDeactivated()) );
+  // The character stats menu will be loaded for the new character when it
+  // is first shown (the game menus are only loaded once)
+  d_character_stats_loaded = false;
 
   // Connecting the control panel to the game menu widget signals will ensure
   // that the menu button will behave correctly
@@ -558,7 +710,8 @@ void Game::handleTownAssetLoadFinished()
   d_character->activate();
 
   // Start the game timer
-  d_game_timer_id = this->startTimer( s_refresh_delay_time );
+  d_game_timer_id = this->startTimer( s_frame_delay_time );
+  d_simulation_clock.start();
   d_game_paused = false;
 
   // Show the level viewer and control panel
@@ -581,6 +734,122 @@ void Game::handleLevelAssetLoadFinished()
 
 }
 
+void Game::handleGameSaveFinished( const bool )
+{
+  // Autosaves are not reported
+  if( d_game_save_requested && !d_save_game_writer.isSaving() )
+  {
+    d_game_save_requested = false;
+
+    emit gameSaveFinished();
+  }
+}
+
+// Create the character
+void Game::createCharacter( const QString& character_name,
+                            const int character_class )
+{
+  // The streamer of the previous character must be removed first
+  d_character_sprite_streamer.reset();
+
+  // Create a new character
+  switch( character_class )
+  {
+    case Character::Rogue:
+    {
+      d_character.reset( new Rogue( character_name ) );
+      break;
+    }
+    case Character::Sorcerer:
+    {
+      d_character.reset( new Sorcerer( character_name ) );
+      break;
+    }
+    case Character::Warrior:
+    {
+      d_character.reset( new Warrior( character_name ) );
+      break;
+    }
+    default:
+      qFatal( "Error: invalid character class! The game cannot be created." );
+  }
+
+  // Stream the character sprite sets as the character state changes
+  d_character_sprite_streamer.reset(
+                         new CharacterSpriteStreamer( d_character.get() ) );
+
+  // Save the game to the character save game file
+  d_save_game_writer.setFileName(
+                             SaveGameFile::getFileName( character_name ) );
+  d_ticks_since_autosave = 0;
+}
+
+// Load the town (the character will be added to the town)
+void Game::loadTown( const QPointF& character_position,
+                     const Direction character_direction )
+{
+  // Initialize the loading screen
+  d_loading_screen->trackAssetLoadProgression(
+                                             d_level, LoadingScreen::newGame );
+
+  // Decode the level sounds while the loading screen is shown
+  d_preloaded_level_sounds =
+    SoundBank::getInstance()->preloadAsync( d_level->getSoundSources() );
+
+  // Add the character to the level
+  d_level->insertCharacter( d_character.get(),
+                            character_position,
+                            character_direction );
+
+  // Load the level assets
+  QObject::connect( d_level, SIGNAL(assetLoadingStarted(const int)),
+                    this, SLOT(handleTownAssetLoadStarted()) );
+  QObject::connect( d_level, SIGNAL(assetLoadingFinished(const int)),
+                    this, SLOT(handleTownAssetLoadFinished()) );
+
+  d_level->loadImageAssets();
+}
+
+// Create a snapshot of the game state
+/*! \details The inventory does not hold items and the quest log does not
+ * track quest states yet so the item and quest sections are saved empty.
+ * The state of the current level only records the killed monsters - there
+ * is no automap and the level objects do not record their use yet.
+ */
+SaveGameState Game::createSaveGameState() const
+{
+  SaveGameState::CharacterState character_state;
+  d_character->saveState( character_state );
+  character_state.level_number = d_level->getNumber();
+  character_state.position = d_character->getSimulatedPos();
+  character_state.direction = d_character->getDirection();
+
+  SaveGameState state;
+  state.setCharacterState( character_state );
+
+  // Record the killed monsters of the current level (by monster id)
+  const MonsterStore& monster_store = d_level->getMonsterStore();
+
+  SaveGameState::LevelState level_state;
+
+  for( int i = 0; i < monster_store.getNumberOfMonsters(); ++i )
+  {
+    const int monster_id = monster_store.getMonsterId( i );
+
+    if( monster_store.getState( monster_id ) == Actor::Dead )
+    {
+      if( level_state.killed_monsters.size() <= monster_id )
+        level_state.killed_monsters.resize( monster_id+1 );
+
+      level_state.killed_monsters.setBit( monster_id );
+    }
+  }
+
+  state.setLevelState( d_level->getNumber(), level_state );
+
+  return state;
+}
+
 // Connect the character signals to the game slots
 void Game::connectCharacterSignalsToGameSlots()
 {
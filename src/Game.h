@@ -21,7 +21,12 @@
 #include "Level.h"
 #include "LoadingScreen.h"
 #include "Character.h"
+#include "CharacterSpriteStreamer.h"
 #include "Sound.h"
+#include "SimulationClock.h"
+#include "SaveGameState.h"
+#include "SaveGameWriter.h"
+#include "TelemetryOverlay.h"
 
 namespace QtD1{
 
@@ -41,6 +46,9 @@ public:
   //! Get the game menu
   QDeclarativeView* getGameMenu();
 
+  //! Get the simulation clock (tick and frame timings)
+  const SimulationClock& getSimulationClock() const;
+
 signals:
 
   void gameLoadStarted();
@@ -171,6 +179,8 @@ private slots:
   void handleLevelAssetLoadStarted();
   void handleLevelAssetLoadFinished();
 
+  void handleGameSaveFinished( const bool success );
+
 protected:
 
   //! Handle show events
@@ -214,16 +224,45 @@ private:
   // Constructor
   Game();
 
+  // Create the character
+  void createCharacter( const QString& character_name,
+                        const int character_class );
+
+  // Load the town (the character will be added to the town)
+  void loadTown( const QPointF& character_position,
+                 const Direction character_direction );
+
+  // Create a snapshot of the game state
+  SaveGameState createSaveGameState() const;
+
   // Connect the character signals to the game slots
   void connectCharacterSignalsToGameSlots();
 
+  // Load the character stats menu (if it has not been loaded)
+  void loadCharacterStats();
+
+  // Load the game menu (if it has not been loaded)
+  void loadGameMenu();
+
+  // Load the game options menu (if it has not been loaded)
+  void loadGameOptionsMenu();
+
+  // Toggle the telemetry trace (the trace is exported when it is stopped)
+  void toggleTelemetryTrace();
+
   // Connect the frontend to the backend
   void connectFrontendToBackend( QDeclarativeView* frontend_widget,
                                  const char* activated_signal,
                                  const char* deactivated_signal );
 
-  // The game state refresh delay time (ms)
-  static const int s_refresh_delay_time = 33;
+  // The game state tick duration (ms)
+  static const int s_tick_duration = 33;
+
+  // The frame refresh delay time (ms)
+  static const int s_frame_delay_time = 8;
+
+  // The number of game state ticks between autosaves (~30 s)
+  static const int s_autosave_interval = 900;
 
   // The singleton instance
   static Game* s_instance;
@@ -231,12 +270,27 @@ private:
   // The character
   std::unique_ptr<Character> d_character;
 
+  // The character sprite streamer
+  std::unique_ptr<CharacterSpriteStreamer> d_character_sprite_streamer;
+
   // The game timer id
   int d_game_timer_id;
 
+  // The simulation clock
+  SimulationClock d_simulation_clock;
+
   // Check if the game is paused
   bool d_game_paused;
 
+  // The save game writer
+  SaveGameWriter d_save_game_writer;
+
+  // The number of game state ticks since the last autosave
+  int d_ticks_since_autosave;
+
+  // Records if a game save has been requested
+  bool d_game_save_requested;
+
   // The game loading screen
   LoadingScreen* d_loading_screen;
 
@@ -258,6 +312,18 @@ private:
   // The level viewer
   QGraphicsView* d_level_viewer;
 
+  // The telemetry overlay
+  TelemetryOverlay* d_telemetry_overlay;
+
+  // Records if the character stats menu has been loaded
+  bool d_character_stats_loaded;
+
+  // Records if the game menu has been loaded
+  bool d_game_menu_loaded;
+
+  // Records if the game options menu has been loaded
+  bool d_game_options_menu_loaded;
+
   // The menu item over sound
   Sound d_game_menu_item_over_sound;
 
@@ -266,6 +332,9 @@ private:
 
   // The control panel click sound
   Sound d_control_panel_click_sound;
+
+  // The preloaded level sounds (kept resident while the level is loaded)
+  QFuture<SoundBank::PreloadedSounds> d_preloaded_level_sounds;
 };
 
 } // end QtD1 namespace
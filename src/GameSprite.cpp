@@ -12,6 +12,7 @@
 // QtD1 Includes
 #include "GameSprite.h"
 #include "GameSpriteData.h"
+#include "Telemetry.h"
 
 namespace QtD1{
 
@@ -145,9 +146,13 @@ void GameSprite::setFrame( const int frame )
 }
 
 // Increment the sprite frame
+/*! \details A sprite whose asset has been dumped has no frames to cycle
+ * through and will keep its current frame.
+ */
 void GameSprite::incrementFrame()
 {
-  d_current_frame = (d_current_frame+1) % d_asset_data->getNumberOfFrames();
+  if( this->isReady() )
+    d_current_frame = (d_current_frame+1) % d_asset_data->getNumberOfFrames();
 }
 
 // Get the sprite frame
@@ -190,6 +195,9 @@ void GameSprite::paint( QPainter* painter,
                         const QStyleOptionGraphicsItem*,
                         QWidget* )
 {
+  Telemetry::ScopedTimer
+    paint_timer( Telemetry::GameSpritePaintTimeHistogram );
+
   // Note: Painting occurs in local coordinates, hence the 0, 0 position.
   if( this->isReady() )
     painter->drawPixmap( 0, 0, this->getFrameImage() );
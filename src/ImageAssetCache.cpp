@@ -0,0 +1,331 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ImageAssetCache.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The image asset cache class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QImageReader>
+#include <QMutexLocker>
+
+// QtD1 Includes
+#include "ImageAssetCache.h"
+#include "Telemetry.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const qint64 ImageAssetCache::s_default_memory_budget;
+std::unique_ptr<ImageAssetCache> ImageAssetCache::s_instance;
+QMutex ImageAssetCache::s_instance_mutex;
+
+// Get the singleton instance
+/*! \details The instance can be requested by any thread.
+ */
+ImageAssetCache* ImageAssetCache::getInstance()
+{
+  QMutexLocker instance_locker( &s_instance_mutex );
+
+  // Just-in-time initialization
+  if( !s_instance )
+    s_instance.reset( new ImageAssetCache );
+
+  return s_instance.get();
+}
+
+// Constructor
+ImageAssetCache::ImageAssetCache()
+  : d_mutex(),
+    d_memory_budget( s_default_memory_budget ),
+    d_memory_usage( 0 ),
+    d_weak_assets(),
+    d_retained_assets(),
+    d_used_asset_names(),
+    d_hits( 0 ),
+    d_misses( 0 )
+{ /* ... */ }
+
+// Set the memory budget (bytes)
+/*! \details If the memory used by the retained assets exceeds the new
+ * budget the least recently used assets will be released immediately.
+ */
+void ImageAssetCache::setMemoryBudget( const qint64 memory_budget )
+{
+  QMutexLocker locker( &d_mutex );
+
+  d_memory_budget = memory_budget;
+
+  this->releaseAssets();
+}
+
+// Get the memory budget (bytes)
+qint64 ImageAssetCache::getMemoryBudget() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_memory_budget;
+}
+
+// Get the memory used by the assets that are retained by the cache
+qint64 ImageAssetCache::getMemoryUsage() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_memory_usage;
+}
+
+// Get the number of assets that are retained by the cache
+int ImageAssetCache::getNumberOfRetainedAssets() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_retained_assets.size();
+}
+
+// Get the number of assets that are resident (retained or still in use)
+/*! \details Assets that are no longer in use are counted until the cache
+ * releases an asset or is cleared.
+ */
+int ImageAssetCache::getNumberOfResidentAssets() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_weak_assets.size();
+}
+
+// Check if an asset is resident (retained or still in use)
+bool ImageAssetCache::isResident( const QString& asset_name ) const
+{
+  QMutexLocker locker( &d_mutex );
+
+  QHash<QString,WeakAssetHandle>::const_iterator weak_asset_it =
+    d_weak_assets.find( asset_name );
+
+  if( weak_asset_it != d_weak_assets.end() )
+    return !weak_asset_it.value().expired();
+  else
+    return false;
+}
+
+// Find a resident asset (returns a null handle if it is not resident)
+/*! \details A resident asset will become the most recently used asset.
+ */
+ImageAssetCache::AssetHandle ImageAssetCache::find(
+                                                 const QString& asset_name )
+{
+  QMutexLocker locker( &d_mutex );
+
+  AssetHandle asset = this->findImpl( asset_name );
+
+  if( asset )
+    ++d_hits;
+  else
+    ++d_misses;
+
+  return asset;
+}
+
+// Insert an asset (returns the resident asset if there is one)
+/*! \details If the asset is already resident (e.g. it was decoded by
+ * another thread at the same time) the resident asset is returned and the
+ * new asset is discarded.
+ */
+ImageAssetCache::AssetHandle ImageAssetCache::insert(
+                                                   const QString& asset_name,
+                                                   const Asset& asset )
+{
+  QMutexLocker locker( &d_mutex );
+
+  AssetHandle resident_asset = this->findImpl( asset_name );
+
+  if( resident_asset )
+    return resident_asset;
+
+  AssetHandle new_asset( new Asset( asset ) );
+
+  d_weak_assets[asset_name] = new_asset;
+
+  this->retain( asset_name, new_asset );
+  this->releaseAssets();
+
+  return new_asset;
+}
+
+// Load an asset (it will only be decoded if it is not resident)
+/*! \details The asset is decoded without holding the cache lock so that
+ * other assets can be requested while it is being decoded.
+ */
+ImageAssetCache::AssetHandle ImageAssetCache::load(
+                                                 const QString& asset_name )
+{
+  {
+    QMutexLocker locker( &d_mutex );
+
+    AssetHandle asset = this->findImpl( asset_name );
+
+    if( asset )
+    {
+      ++d_hits;
+
+      return asset;
+    }
+
+    ++d_misses;
+  }
+
+  return this->insert( asset_name, ImageAssetCache::decode( asset_name ) );
+}
+
+// Release all assets retained by the cache
+/*! \details Assets that are still in use stay resident.
+ */
+void ImageAssetCache::clear()
+{
+  QMutexLocker locker( &d_mutex );
+
+  d_retained_assets.clear();
+  d_used_asset_names.clear();
+  d_memory_usage = 0;
+
+  this->removeExpiredAssets();
+}
+
+// Get the number of asset requests that found a resident asset
+int ImageAssetCache::getNumberOfHits() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_hits;
+}
+
+// Get the number of asset requests that did not find a resident asset
+int ImageAssetCache::getNumberOfMisses() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_misses;
+}
+
+// Decode an asset
+/*! \details The decode time of every asset is recorded by the telemetry
+ * (the trace event is named after the asset).
+ */
+ImageAssetCache::Asset ImageAssetCache::decode( const QString& asset_name )
+{
+  Telemetry::ScopedTimer decode_timer(
+                      Telemetry::ImageAssetDecodeTimeHistogram, asset_name );
+
+  QImageReader image_reader( asset_name );
+
+  Asset asset( image_reader.imageCount() );
+
+  for( int i = 0; i < asset.size(); ++i )
+  {
+    asset[i] = image_reader.read();
+
+    image_reader.jumpToNextImage();
+  }
+
+  return asset;
+}
+
+// Get the memory used by an asset (bytes)
+qint64 ImageAssetCache::getAssetBytes( const Asset& asset )
+{
+  qint64 asset_bytes = 0;
+
+  for( int i = 0; i < asset.size(); ++i )
+    asset_bytes += asset[i].byteCount();
+
+  return asset_bytes;
+}
+
+// Find a resident asset (the mutex must be locked)
+/*! \details An asset that is still in use but was released by the cache
+ * will be retained again.
+ */
+ImageAssetCache::AssetHandle ImageAssetCache::findImpl(
+                                                 const QString& asset_name )
+{
+  QHash<QString,WeakAssetHandle>::iterator weak_asset_it =
+    d_weak_assets.find( asset_name );
+
+  if( weak_asset_it == d_weak_assets.end() )
+    return AssetHandle();
+
+  AssetHandle asset = weak_asset_it.value().lock();
+
+  if( asset )
+  {
+    this->retain( asset_name, asset );
+    this->releaseAssets();
+  }
+  else
+    d_weak_assets.erase( weak_asset_it );
+
+  return asset;
+}
+
+// Retain an asset as the most recently used asset (the mutex must be locked)
+void ImageAssetCache::retain( const QString& asset_name,
+                              const AssetHandle& asset )
+{
+  if( d_retained_assets.contains( asset_name ) )
+    d_used_asset_names.removeOne( asset_name );
+  else
+  {
+    d_retained_assets[asset_name] = asset;
+
+    d_memory_usage += ImageAssetCache::getAssetBytes( *asset );
+  }
+
+  d_used_asset_names << asset_name;
+}
+
+// Release the least recently used assets (the mutex must be locked)
+/*! \details The most recently used asset is always retained, even if it
+ * exceeds the budget on its own. The weak handles of assets that are no
+ * longer in use are removed once any asset has been released.
+ */
+void ImageAssetCache::releaseAssets()
+{
+  bool assets_released = false;
+
+  while( d_memory_usage > d_memory_budget && d_used_asset_names.size() > 1 )
+  {
+    const QString asset_name = d_used_asset_names.takeFirst();
+
+    d_memory_usage -=
+      ImageAssetCache::getAssetBytes( *d_retained_assets[asset_name] );
+
+    d_retained_assets.remove( asset_name );
+
+    assets_released = true;
+  }
+
+  if( assets_released )
+    this->removeExpiredAssets();
+}
+
+// Remove the expired weak asset handles (the mutex must be locked)
+void ImageAssetCache::removeExpiredAssets()
+{
+  QHash<QString,WeakAssetHandle>::iterator weak_asset_it =
+    d_weak_assets.begin();
+
+  while( weak_asset_it != d_weak_assets.end() )
+  {
+    if( weak_asset_it.value().expired() )
+      weak_asset_it = d_weak_assets.erase( weak_asset_it );
+    else
+      ++weak_asset_it;
+  }
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end ImageAssetCache.cpp
+//---------------------------------------------------------------------------//
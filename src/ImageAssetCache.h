@@ -0,0 +1,159 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ImageAssetCache.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The image asset cache class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef IMAGE_ASSET_CACHE_H
+#define IMAGE_ASSET_CACHE_H
+
+// Std Lib Includes
+#include <memory>
+
+// Qt Includes
+#include <QString>
+#include <QVector>
+#include <QImage>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+namespace QtD1{
+
+/*! The image asset cache
+ *
+ * The decoded image assets are shared by the whole process (levels, menu
+ * sprites and cursors). An asset is keyed by its asset name (e.g.
+ * "/data/inv/objcurs.cel+levels/towndata/town.pal") and is handed out as a
+ * reference counted handle. The cache keeps the most recently used assets
+ * alive up to its memory budget - when the budget is exceeded the cache
+ * releases the least recently used assets. An asset that has been released
+ * by the cache stays available for as long as someone else holds a handle
+ * to it (the cache only keeps a weak handle), so an asset is never decoded
+ * twice while it is resident.
+ *
+ * The cache is thread safe (assets are decoded by worker threads).
+ */
+class ImageAssetCache
+{
+
+public:
+
+  //! The image asset frames
+  typedef QVector<QImage> Asset;
+
+  //! The image asset handle
+  typedef std::shared_ptr<const Asset> AssetHandle;
+
+  //! The weak image asset handle
+  typedef std::weak_ptr<const Asset> WeakAssetHandle;
+
+  //! The default memory budget (bytes)
+  static const qint64 s_default_memory_budget = 256*1024*1024;
+
+  //! Get the singleton instance
+  static ImageAssetCache* getInstance();
+
+  //! Destructor
+  ~ImageAssetCache()
+  { /* ... */ }
+
+  //! Set the memory budget (bytes)
+  void setMemoryBudget( const qint64 memory_budget );
+
+  //! Get the memory budget (bytes)
+  qint64 getMemoryBudget() const;
+
+  //! Get the memory used by the assets that are retained by the cache
+  qint64 getMemoryUsage() const;
+
+  //! Get the number of assets that are retained by the cache
+  int getNumberOfRetainedAssets() const;
+
+  //! Get the number of assets that are resident (retained or still in use)
+  int getNumberOfResidentAssets() const;
+
+  //! Check if an asset is resident (retained or still in use)
+  bool isResident( const QString& asset_name ) const;
+
+  //! Find a resident asset (returns a null handle if it is not resident)
+  AssetHandle find( const QString& asset_name );
+
+  //! Insert an asset (returns the resident asset if there is one)
+  AssetHandle insert( const QString& asset_name, const Asset& asset );
+
+  //! Load an asset (it will only be decoded if it is not resident)
+  AssetHandle load( const QString& asset_name );
+
+  //! Release all assets retained by the cache
+  void clear();
+
+  //! Get the number of asset requests that found a resident asset
+  int getNumberOfHits() const;
+
+  //! Get the number of asset requests that did not find a resident asset
+  int getNumberOfMisses() const;
+
+  //! Decode an asset
+  static Asset decode( const QString& asset_name );
+
+  //! Get the memory used by an asset (bytes)
+  static qint64 getAssetBytes( const Asset& asset );
+
+private:
+
+  // Constructor
+  ImageAssetCache();
+
+  // Find a resident asset (the mutex must be locked)
+  AssetHandle findImpl( const QString& asset_name );
+
+  // Retain an asset as the most recently used asset (the mutex must be locked)
+  void retain( const QString& asset_name, const AssetHandle& asset );
+
+  // Release the least recently used assets (the mutex must be locked)
+  void releaseAssets();
+
+  // Remove the expired weak asset handles (the mutex must be locked)
+  void removeExpiredAssets();
+
+  // The singleton instance
+  static std::unique_ptr<ImageAssetCache> s_instance;
+
+  // The singleton instance mutex
+  static QMutex s_instance_mutex;
+
+  // The cache mutex
+  mutable QMutex d_mutex;
+
+  // The memory budget
+  qint64 d_memory_budget;
+
+  // The memory used by the retained assets
+  qint64 d_memory_usage;
+
+  // The weak handles of all assets that have been cached
+  QHash<QString,WeakAssetHandle> d_weak_assets;
+
+  // The retained assets
+  QHash<QString,AssetHandle> d_retained_assets;
+
+  // The retained asset names (least recently used first)
+  QList<QString> d_used_asset_names;
+
+  // The number of hits
+  int d_hits;
+
+  // The number of misses
+  int d_misses;
+};
+
+} // end QtD1 namespace
+
+#endif // end IMAGE_ASSET_CACHE_H
+
+//---------------------------------------------------------------------------//
+// end ImageAssetCache.h
+//---------------------------------------------------------------------------//
@@ -10,7 +10,6 @@
 #include <iostream>
 
 // Qt Includes
-#include <QImageReader>
 #include <QtConcurrentRun>
 #include <QFile>
 
@@ -23,6 +22,7 @@ namespace QtD1{
 ImageAssetLoader::ImageAssetLoader( QObject* parent )
   : QObject( parent ),
     d_assets(),
+    d_asset_handles(),
     d_asset_load_future(),
     d_asset_load_future_watcher()
 {
@@ -87,6 +87,10 @@ void ImageAssetLoader::loadAssetsSync()
 }
 
 // Load the image assets implementation
+/*! \details The loader holds a handle to each loaded asset so that the
+ * assets stay resident in the image asset cache for as long as the loader
+ * exists.
+ */
 void ImageAssetLoader::loadAssetsImpl( ImageAssetLoader* obj )
 {
   QMap<QString,QVector<QImage> >::iterator asset_it, asset_end;
@@ -98,20 +102,19 @@ void ImageAssetLoader::loadAssetsImpl( ImageAssetLoader* obj )
   // Start loading assets
   emit obj->assetLoadingStarted( obj->d_assets->size() );
   
-  QImageReader image_reader;
+  // Only the assets that are not resident in the cache will be decoded
+  ImageAssetCache* asset_cache = ImageAssetCache::getInstance();
+
+  obj->d_asset_handles.clear();
+
   while( asset_it != asset_end )
   {
-    image_reader.setFileName( asset_it.key() );
-    
-    QVector<QImage>& asset_images = asset_it.value();
-    asset_images.resize( image_reader.imageCount() );
+    ImageAssetCache::AssetHandle asset = asset_cache->load( asset_it.key() );
 
-    for( int i = 0; i < asset_images.size(); ++i )
-    {
-      asset_images[i] = image_reader.read();
+    // The images are implicitly shared with the cached asset
+    asset_it.value() = *asset;
 
-      image_reader.jumpToNextImage();
-    }
+    obj->d_asset_handles << asset;
     
     // The asset has been loaded
     ++assets_loaded;
@@ -16,12 +16,16 @@
 #include <QObject>
 #include <QSet>
 #include <QMap>
+#include <QList>
 #include <QVector>
 #include <QString>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QMetaType>
 
+// QtD1 Includes
+#include "ImageAssetCache.h"
+
 namespace QtD1{
 
 //! The image asset loader
@@ -94,6 +98,9 @@ private:
   // The assets
   std::shared_ptr<QMap<QString,QVector<QImage> > > d_assets;
 
+  // The cached asset handles
+  QList<ImageAssetCache::AssetHandle> d_asset_handles;
+
   // The asset load future
   QFuture<void> d_asset_load_future;
 
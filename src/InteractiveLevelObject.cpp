@@ -15,6 +15,7 @@
 
 // QtD1 Includes
 #include "InteractiveLevelObject.h"
+#include "Telemetry.h"
 
 namespace QtD1{
 
@@ -33,6 +34,9 @@ void InteractiveLevelObject::paint( QPainter* painter,
                                     const QStyleOptionGraphicsItem* option,
                                     QWidget* widget )
 {
+  Telemetry::ScopedTimer
+    paint_timer( Telemetry::InteractiveObjectPaintTimeHistogram );
+
   if( d_paint_with_path )
     painter->strokePath( this->shape(), s_hover_outline_pen );
 
@@ -65,69 +65,82 @@ void Inventory::setInventoryImage( QLabel* inventory_image )
 //! Get the helmet
 //const std::shared_ptr<Helmet>& getHelmet() const;
 
+// Calculate all of the stat modifiers
+/*! \details Items cannot be equipped yet so all of the modifiers are zero.
+ * The individual modifier methods forward to this method so that the
+ * equipped items only have to be summed here once they are added.
+ */
+Inventory::Modifiers Inventory::calculateModifiers() const
+{
+  Modifiers modifiers = {0, 0, 0, 0, 0, 0, 0, 0, 0.0, 0.0, 0.0};
+
+  return modifiers;
+}
+
 // Calculate strength modifier
 int Inventory::calculateStrengthModifier() const
 {
-  return 0;
+  return this->calculateModifiers().strength;
 }
 
 // Calculate magic modifier
 int Inventory::calculateMagicModifier() const
 {
-  return 0;
+  return this->calculateModifiers().magic;
 }
 
 // Calculate dexterity modifier
 int Inventory::calculateDexterityModifier() const
 {
-  return 0;
+  return this->calculateModifiers().dexterity;
 }
 
 //! Calculate vitality modifier
 int Inventory::calculateVitalityModifier() const
 {
-  return 0;
+  return this->calculateModifiers().vitality;
 }
 
 // Calculate health modifier
 int Inventory::calculateHealthModifier() const
 {
-  return 0;
+  return this->calculateModifiers().health;
 }
 
 // Calculate mana modifier
 int Inventory::calculateManaModifier() const
 {
-  return 0;
+  return this->calculateModifiers().mana;
 }
 
 // Calculate damage
 int Inventory::calculateDamage() const
 {
-  return 0;
+  return this->calculateModifiers().damage;
 }
+
 // Calculate armor class
 int Inventory::calculateArmorClass() const
 {
-  return 0;
+  return this->calculateModifiers().armor_class;
 }
 
 // Calculate magic resistance
 qreal Inventory::calculateMagicResistance() const
 {
-  return 0;
+  return this->calculateModifiers().magic_resistance;
 }
 
 // Calculate fire resistance
 qreal Inventory::calculateFireResistance() const
 {
-  return 0;
+  return this->calculateModifiers().fire_resistance;
 }
 
 // Calculate lightning resistance
 qreal Inventory::calculateLightningResistance() const
 {
-  return 0;
+  return this->calculateModifiers().lightning_resistance;
 }
 
 } // end QtD1 namespace
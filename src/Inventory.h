@@ -45,6 +45,21 @@ public:
     HighClassArmorEquiped
   };
 
+  //! The stat modifiers of the equipped items
+  struct Modifiers{
+    int strength;
+    int magic;
+    int dexterity;
+    int vitality;
+    int health;
+    int mana;
+    int damage;
+    int armor_class;
+    qreal magic_resistance;
+    qreal fire_resistance;
+    qreal lightning_resistance;
+  };
+
   //! Destructor
   virtual ~Inventory()
   { /* ... */ }
@@ -91,6 +106,9 @@ public:
   //! Get the helmet
   //const std::shared_ptr<Helmet>& getHelmet() const;
 
+  //! Calculate all of the stat modifiers
+  Modifiers calculateModifiers() const;
+
   //! Calculate strength modifier
   int calculateStrengthModifier() const;
 
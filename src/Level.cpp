@@ -8,24 +8,56 @@
 
 // Qt Includes
 #include <QImageReader>
+#include <QGraphicsView>
+#include <QtConcurrentRun>
 
 // QtD1 Includes
 #include "Level.h"
 #include "LevelPillarFactory.h"
+#include "Telemetry.h"
 
 namespace QtD1{
 
+// Initialize static member data
+const int Level::s_max_path_requests_per_tick;
+const int Level::s_music_crossfade_time;
+
 // Constructor
 Level::Level( QObject* parent )
   : QGraphicsScene( parent ),
     d_character( NULL ),
     d_level_objects(),
+    d_level_sectors(),
+    d_region_streamer(),
+    d_background(),
+    d_background_watcher(),
+    d_background_ready( false ),
+    d_pending_number_of_assets_loaded( -1 ),
+    d_grid(),
+    d_pathfinder(),
+    d_projectile_pool(),
+    d_projectile_layer( new ProjectileLayer( &d_projectile_pool ) ),
+    d_monster_store(),
+    d_monster_renderer( this ),
+    d_actors(),
+    d_animated_objects(),
+    d_level_object_spatial_hash(),
     d_level_object_asset_map(),
     d_music( new Music ),
     d_image_asset_loader(),
     d_needs_restore( false ),
     d_ready( false )
-{ /* ... */ }
+{
+  // The actors move every tick, which would force the scene to continually
+  // rebuild its bsp index - the level object spatial hash is used instead
+  this->setItemIndexMethod( QGraphicsScene::NoIndex );
+
+  // All projectiles are painted by a single item
+  this->addItem( d_projectile_layer );
+
+  QObject::connect( &d_background_watcher, SIGNAL(finished()),
+                    this, SLOT(handleBackgroundCreated()) );
+}
 
 // Constructor
 Level::Level( QObject* parent, const QString& level_music_file_name )
@@ -41,10 +73,222 @@ void Level::setMusic( const std::shared_ptr<Music>& music )
   d_music = music;
 }
 
-// Create the level background
+// Destructor
+/*! \details A background whose data is still being loaded does not have to
+ * be waited for (the worker only writes to its own background data).
+ */
+Level::~Level()
+{ /* ... */ }
+
+// Get the sound sources that should be preloaded
+/*! \details By default no sounds are preloaded.
+ */
+QStringList Level::getSoundSources() const
+{
+  return QStringList();
+}
+
+// Create the level background (off the GUI thread)
+/*! \details The background data (e.g. the baked level blob and the level
+ * grid) is loaded by a worker thread so that the loading screen can be shown
+ * immediately and the image assets can be decoded at the same time. The
+ * worker only gets the background data loader, which creates plain data, so
+ * the level can be destroyed while it runs. The sectors are graphics objects
+ * so they are created on the GUI thread once the data has been loaded (see
+ * handleBackgroundCreated). The backgroundCreated signal will be emitted
+ * once the sectors are in the scene.
+ */
 void Level::createBackground()
 {
-  this->createSectors( d_level_sectors );
+  // A background whose data has been loaded but that has not been added to
+  // the scene yet will be added by handleBackgroundCreated
+  if( d_background_ready || this->isBackgroundStarted() )
+    return;
+
+  d_background_watcher.setFuture(
+                 QtConcurrent::run( Level::loadBackgroundDataImpl,
+                                    this->getBackgroundDataLoader() ) );
+}
+
+// Create the level background synchronously
+/*! \details A background that is being created by a worker thread will be
+ * waited for (it is never created twice).
+ */
+void Level::createBackgroundSync()
+{
+  if( d_background_ready )
+    return;
+
+  if( this->isBackgroundStarted() )
+    this->waitForBackground();
+  else
+  {
+    d_background =
+      Level::loadBackgroundDataImpl( this->getBackgroundDataLoader() );
+
+    this->handleBackgroundCreated();
+  }
+}
+
+// Check if the level background has been created
+bool Level::isBackgroundReady() const
+{
+  return d_background_ready;
+}
+
+// Check if the background creation has been started
+/*! \details The background creation may have finished without the
+ * background having been added to the scene yet (the finished signal is
+ * queued). A watcher without a future reports a started, finished and
+ * canceled future - the background creation is never canceled.
+ */
+bool Level::isBackgroundStarted() const
+{
+  return d_background_watcher.isStarted() &&
+    !d_background_watcher.isCanceled();
+}
+
+// Load the level background data (run in a worker thread)
+std::shared_ptr<Level::Background> Level::loadBackgroundDataImpl(
+                                                BackgroundDataLoader loader )
+{
+  std::shared_ptr<Background> background( new Background );
+
+  (*loader)( *background );
+
+  return background;
+}
+
+// Add the created background to the scene
+/*! \details The sectors are created from the loaded background data first.
+ * The background data is released once the sectors are in the scene.
+ */
+void Level::insertBackground()
+{
+  this->createBackgroundSectors( *d_background );
+
+  this->setSceneRect( d_background->scene_rect );
+
+  QList<LevelSector*>::const_iterator level_sector_it, level_sector_end;
+  level_sector_it = d_background->sectors.begin();
+  level_sector_end = d_background->sectors.end();
+
+  while( level_sector_it != level_sector_end )
+  {
+    this->addItem( *level_sector_it );
+
+    ++level_sector_it;
+  }
+
+  d_level_sectors = d_background->sectors;
+
+  d_region_streamer.setRegions( d_level_sectors );
+
+  this->setGrid( d_background->grid );
+
+  d_background.reset();
+
+  d_background_ready = true;
+
+  emit backgroundCreated();
+}
+
+// Wait for the background (and add it to the scene)
+void Level::waitForBackground()
+{
+  if( d_background_ready )
+    return;
+
+  if( this->isBackgroundStarted() )
+  {
+    d_background_watcher.waitForFinished();
+
+    this->handleBackgroundCreated();
+  }
+  else
+    this->createBackgroundSync();
+}
+
+// Set the level grid
+/*! \details The level object spatial hash will be aligned with the grid
+ * (a level square covers 2x2 tiles).
+ */
+void Level::setGrid( const LevelGrid& grid )
+{
+  d_grid = grid;
+
+  d_level_object_spatial_hash.setOrigin( d_grid.getOrigin() );
+
+  d_pathfinder.setGrid( d_grid );
+}
+
+// Get the level grid
+const LevelGrid& Level::getGrid() const
+{
+  return d_grid;
+}
+
+// Get the level pathfinder
+LevelPathfinder& Level::getPathfinder()
+{
+  return d_pathfinder;
+}
+
+// Get the level projectile pool
+ProjectilePool& Level::getProjectilePool()
+{
+  return d_projectile_pool;
+}
+
+// Get the level monster store
+MonsterStore& Level::getMonsterStore()
+{
+  return d_monster_store;
+}
+
+// Get the level monster renderer
+MonsterRenderer& Level::getMonsterRenderer()
+{
+  return d_monster_renderer;
+}
+
+// Get the level region streamer
+LevelRegionStreamer& Level::getRegionStreamer()
+{
+  return d_region_streamer;
+}
+
+// Request a path between two level positions
+/*! \details The request will be processed during one of the following
+ * simulation ticks. Jump point search is used since most requests are
+ * across open ground (click-to-move, monsters chasing the character).
+ */
+int Level::requestPath( const QPointF& start, const QPointF& goal )
+{
+  return d_pathfinder.queuePathRequest( d_grid.mapToTile( start ),
+                                        d_grid.mapToTile( goal ),
+                                        LevelPathfinder::JumpPointSearch );
+}
+
+// Take the waypoints (tile centers) of a processed path request
+/*! \details If the request has not been processed yet or no path could be
+ * found false will be returned.
+ */
+bool Level::takePath( const int request_id, QVector<QPointF>& waypoints )
+{
+  waypoints.clear();
+
+  QVector<QPoint> path;
+
+  if( !d_pathfinder.takePath( request_id, path ) )
+    return false;
+
+  waypoints.reserve( path.size() );
+
+  for( int i = 0; i < path.size(); ++i )
+    waypoints << d_grid.mapFromTileCenter( path[i] );
+
+  return true;
 }
 
 // Get the character
@@ -62,6 +306,10 @@ void Level::addLevelObject( LevelObject* level_object,
   this->addItem( level_object );
 
   level_object->setPos( location );
+
+  d_level_object_spatial_hash.insert( level_object, location );
+
+  this->trackAnimationState( level_object );
 }
 
 // Add an actor
@@ -71,11 +319,16 @@ void Level::addActor( Actor* actor,
                       const Direction direction )
 {
   d_level_objects << actor;
+  d_actors << actor;
 
   this->addItem( actor );
 
-  actor->setPos( location );
+  actor->setSimulatedPos( location );
   actor->setStateAndDirection( state, direction );
+
+  d_level_object_spatial_hash.insert( actor, location );
+
+  this->trackAnimationState( actor );
 }
 
 // Insert the character
@@ -84,16 +337,27 @@ void Level::insertCharacter( Character* character,
                              const Direction direction )
 {
   d_character = character;
+  d_actors << character;
 
   this->addItem( character );
 
-  character->setPos( location );
+  character->setSimulatedPos( location );
   character->setStateAndDirection( Actor::Standing, direction );
+
+  d_level_object_spatial_hash.insert( character, location );
+
+  this->trackAnimationState( character );
 }
 
 // Remove the character
 void Level::removeCharacter()
 {
+  this->untrackAnimationState( d_character );
+
+  d_level_object_spatial_hash.remove( d_character );
+
+  d_actors.removeOne( d_character );
+
   this->removeItem( d_character );
 }
 
@@ -109,7 +373,172 @@ bool Level::isReady()
   return d_ready;
 }
 
+// Register an object that must be advanced every simulation tick
+void Level::registerAnimatedObject( LevelObject* level_object )
+{
+  if( !d_animated_objects.contains( level_object ) )
+    d_animated_objects << level_object;
+}
+
+// Unregister an object that no longer needs simulation ticks
+void Level::unregisterAnimatedObject( LevelObject* level_object )
+{
+  d_animated_objects.removeOne( level_object );
+}
+
+// Check if an object is registered for simulation ticks
+bool Level::isAnimatedObjectRegistered( LevelObject* level_object ) const
+{
+  return d_animated_objects.contains( level_object );
+}
+
+// Get the number of objects that are advanced every simulation tick
+int Level::getNumberOfAnimatedObjects() const
+{
+  return d_animated_objects.size();
+}
+
+// Get the level objects inside of a rect
+QList<LevelObject*> Level::getLevelObjectsInRect( const QRectF& rect ) const
+{
+  QList<LevelObject*> level_objects;
+
+  d_level_object_spatial_hash.queryRect( rect, level_objects );
+
+  return level_objects;
+}
+
+// Get the level objects inside of a circle
+QList<LevelObject*> Level::getLevelObjectsInRadius( const QPointF& center,
+                                                    const qreal radius ) const
+{
+  QList<LevelObject*> level_objects;
+
+  d_level_object_spatial_hash.queryRadius( center, radius, level_objects );
+
+  return level_objects;
+}
+
+// Get the level objects within a distance of a line segment
+QList<LevelObject*> Level::getLevelObjectsAlongLine(
+                                               const QPointF& start,
+                                               const QPointF& end,
+                                               const qreal half_width ) const
+{
+  QList<LevelObject*> level_objects;
+
+  d_level_object_spatial_hash.queryLine( start, end, half_width,
+                                         level_objects );
+
+  return level_objects;
+}
+
+// Get the level object spatial hash
+const LevelSpatialHash<LevelObject*>& Level::getLevelObjectSpatialHash() const
+{
+  return d_level_object_spatial_hash;
+}
+
+// Advance the level simulation by a single tick
+/*! \details Unlike QGraphicsScene::advance, only the registered animated
+ * objects will be advanced (the sectors, squares and pillars are static).
+ * A limited number of queued path requests are processed first so that the
+ * cost of pathfinding is spread over several ticks. The projectiles and
+ * monsters are advanced last, each in a single batch.
+ * The same two phase protocol is used. The registered objects are copied
+ * before advancing so that objects can safely register or unregister
+ * themselves while they are being advanced.
+ */
+void Level::advanceTick()
+{
+  // Process the queued path requests before the objects move
+  d_pathfinder.processPathRequests( s_max_path_requests_per_tick );
+
+  const QList<LevelObject*> animated_objects = d_animated_objects;
+
+  for( int phase = 0; phase < 2; ++phase )
+  {
+    QList<LevelObject*>::const_iterator object_it, object_end;
+    object_it = animated_objects.begin();
+    object_end = animated_objects.end();
+
+    while( object_it != object_end )
+    {
+      (*object_it)->advance( phase );
+
+      ++object_it;
+    }
+  }
+
+  // Update the spatial hash with the new positions
+  QList<LevelObject*>::const_iterator object_it, object_end;
+  object_it = animated_objects.begin();
+  object_end = animated_objects.end();
+
+  while( object_it != object_end )
+  {
+    if( d_level_object_spatial_hash.contains( *object_it ) )
+      d_level_object_spatial_hash.move( *object_it, (*object_it)->pos() );
+
+    ++object_it;
+  }
+
+  // Advance all projectiles in a single pass
+  d_projectile_pool.advance( d_grid.isEmpty() ? NULL : &d_grid );
+
+  d_projectile_layer->updateProjectiles();
+
+  // Advance all monsters in a single pass (they hunt the character at its
+  // simulated position - the rendered position is interpolated)
+  if( d_character )
+  {
+    // Stream in the regions around the character
+    d_region_streamer.setFocus( d_character->pos() );
+
+    const int damage =
+      d_monster_store.advance( d_character->getSimulatedPos(),
+                               d_character->getArmorClass(),
+                               d_grid.isEmpty() ? NULL : &d_grid );
+
+    if( damage > 0 )
+      d_character->removeHealth( damage );
+  }
+
+  // Only the monsters that can be seen are published to the scene
+  QRectF visible_rect = this->sceneRect();
+
+  if( !this->views().empty() )
+  {
+    const QGraphicsView* view = this->views().front();
+
+    visible_rect =
+      view->mapToScene( view->viewport()->rect() ).boundingRect();
+  }
+
+  d_monster_renderer.publish( d_monster_store, visible_rect );
+}
+
+// Place the actors between their last two simulated positions
+void Level::interpolateActors( const qreal fraction )
+{
+  QList<Actor*>::const_iterator actor_it, actor_end;
+  actor_it = d_actors.begin();
+  actor_end = d_actors.end();
+
+  while( actor_it != actor_end )
+  {
+    (*actor_it)->interpolatePos( fraction );
+
+    ++actor_it;
+  }
+}
+
 // Load the level image assets
+/*! \details The loading can start before the background has been created.
+ * The sector image assets are always the level image asset so the assets
+ * that must be loaded are known in advance. The loaded assets will only be
+ * handed to the level objects once the background is in the scene.
+ */
 void Level::loadImageAssets()
 {
   this->resetAssetData();
@@ -131,6 +560,8 @@ void Level::loadImageAssets()
 // Load the level image assets synchronously
 void Level::loadImageAssetsSync()
 {
+  this->waitForBackground();
+
   this->resetAssetData();
 
   // Gather the assets that must be loaded
@@ -152,6 +583,7 @@ void Level::resetAssetData()
 {
   d_ready = false;
   d_needs_restore = false;
+  d_pending_number_of_assets_loaded = -1;
 
   d_level_object_asset_map.clear();
 
@@ -178,9 +610,12 @@ void Level::gatherImageAssetsToLoad( QSet<QString>& assets_to_load )
   // Add the externally added object assets
   QSet<QString> object_assets;
 
+  // Note: Only the character sprite set that is currently active is
+  //       required - the other sets are streamed in by the character sprite
+  //       streamer when the character state changes.
   if( !d_character->imageAssetsLoaded() )
   {
-    d_character->getImageAssetNames( object_assets );
+    d_character->getMissingActiveImageAssetNames( object_assets );
 
     assets_to_load.unite( object_assets );
     object_assets.clear();
@@ -240,10 +675,14 @@ void Level::notifyLevelObjectsOfImpendingAssetLoad()
 }
 
 // Dump the level image assets
-/*! \details The character assets will not be dumped.
+/*! \details The character assets will not be dumped. All regions will be
+ * evicted - only the regions around the character are loaded again when
+ * the image assets are restored.
  */
 void Level::dumpImageAssets()
 {
+  d_region_streamer.evictRegions();
+
   QList<LevelObject*>::const_iterator level_object_it, level_object_end;
   level_object_it = d_level_objects.begin();
   level_object_end = d_level_objects.end();
@@ -283,9 +722,13 @@ void Level::restoreImageAssetsSync()
 }
 
 // Play the level music
+/*! \details The music that is playing will be crossfaded with the level
+ * music. Levels that share their music keep playing it without a gap.
+ */
 void Level::playLevelMusic()
 {
-  d_music->playMusic();
+  d_music->playMusicWithCrossfade(
+             std::chrono::milliseconds( s_music_crossfade_time ) );
 }
 
 // Pause the level music
@@ -307,17 +750,60 @@ void Level::handleImageAssetLoadingStarted( const int number_of_assets )
 }
 
 // Handle image asset loaded
+/*! \details The loaded assets are recorded by the telemetry (the decode
+ * times are recorded by the image asset cache).
+ */
 void Level::handleImageAssetLoaded( const int number_of_assets_loaded,
-                                    const QString asset_name,
+                                    const QString,
                                     const QVector<QImage> asset )
 {
-  std::cout << asset_name.toStdString() << ": " << asset.size() << std::endl;
+  qint64 asset_bytes = 0;
+
+  for( int i = 0; i < asset.size(); ++i )
+    asset_bytes += asset[i].byteCount();
+
+  Telemetry::addToCounter( Telemetry::ImageAssetsLoadedCounter, 1 );
+  Telemetry::addToCounter( Telemetry::ImageAssetBytesLoadedCounter,
+                           asset_bytes );
 
   emit assetLoaded( number_of_assets_loaded );
 }
 
 // Handle image asset loading finished
 void Level::handleImageAssetLoadingFinished( const int number_of_assets_loaded )
+{
+  // The sectors may still be under construction
+  if( d_background_ready )
+    this->finishImageAssetLoading( number_of_assets_loaded );
+  else
+    d_pending_number_of_assets_loaded = number_of_assets_loaded;
+}
+
+// Handle background created
+void Level::handleBackgroundCreated()
+{
+  // The background may have already been inserted by waitForBackground
+  if( d_background_ready )
+    return;
+
+  // The background data was loaded by a worker thread
+  if( !d_background )
+    d_background = d_background_watcher.result();
+
+  this->insertBackground();
+
+  if( d_pending_number_of_assets_loaded >= 0 )
+  {
+    const int number_of_assets_loaded = d_pending_number_of_assets_loaded;
+
+    d_pending_number_of_assets_loaded = -1;
+
+    this->finishImageAssetLoading( number_of_assets_loaded );
+  }
+}
+
+// Finish image asset loading (requires the background)
+void Level::finishImageAssetLoading( const int number_of_assets_loaded )
 {
   // Check if the character needs this asset
   if( !d_character->imageAssetsLoaded() )
@@ -326,17 +812,11 @@ void Level::handleImageAssetLoadingFinished( const int number_of_assets_loaded )
     d_character->finalizeImageAssetLoading();
   }
 
-  QList<LevelSector*>::const_iterator level_sector_it, level_sector_end;
-  level_sector_it = d_level_sectors.begin();
-  level_sector_end = d_level_sectors.end();
-
-  while( level_sector_it != level_sector_end )
-  {
-    (*level_sector_it)->loadRawImageAssets( *d_image_asset_loader->getLoadedAssets() );
-    (*level_sector_it)->finalizeImageAssetLoading();
-
-    ++level_sector_it;
-  }
+  // Only the regions around the character are loaded before the level is
+  // ready - the other regions are streamed in as the character approaches
+  d_region_streamer.setImageAssetFrames(
+     d_image_asset_loader->getLoadedAssets()->value( this->getImageAssetName() ) );
+  d_region_streamer.loadRegionsSync( d_character->pos() );
 
   QList<LevelObject*>::const_iterator level_object_it, level_object_end;
   level_object_it = d_level_objects.begin();
@@ -356,6 +836,40 @@ void Level::handleImageAssetLoadingFinished( const int number_of_assets_loaded )
   emit assetLoadingFinished( number_of_assets_loaded );
 }
 
+// Handle a level object animation state change
+void Level::handleLevelObjectAnimationStateChanged( const bool animated )
+{
+  LevelObject* level_object = qobject_cast<LevelObject*>( this->sender() );
+
+  if( level_object )
+  {
+    if( animated )
+      this->registerAnimatedObject( level_object );
+    else
+      this->unregisterAnimatedObject( level_object );
+  }
+}
+
+// Track the animation state of a level object
+void Level::trackAnimationState( LevelObject* level_object )
+{
+  if( level_object->isAnimated() )
+    this->registerAnimatedObject( level_object );
+
+  QObject::connect( level_object, SIGNAL(animationStateChanged(const bool)),
+                    this, SLOT(handleLevelObjectAnimationStateChanged(const bool)),
+                    Qt::UniqueConnection );
+}
+
+// Stop tracking the animation state of a level object
+void Level::untrackAnimationState( LevelObject* level_object )
+{
+  QObject::disconnect( level_object, SIGNAL(animationStateChanged(const bool)),
+                       this, SLOT(handleLevelObjectAnimationStateChanged(const bool)) );
+
+  this->unregisterAnimatedObject( level_object );
+}
+
 // Connect the image asset loader signals to the level slots
 void Level::connectImageAssetLoaderSignalsToLevelSlots() const
 {
@@ -9,9 +9,13 @@
 #ifndef LEVEL_H
 #define LEVEL_H
 
+// Std Lib Includes
+#include <memory>
+
 // Qt Includes
 #include <QGraphicsScene>
 #include <QList>
+#include <QStringList>
 #include <QFuture>
 #include <QFutureWatcher>
 
@@ -19,6 +23,15 @@
 #include "LevelObject.h"
 #include "LevelPillar.h"
 #include "LevelSector.h"
+#include "LevelBlob.h"
+#include "LevelRegionStreamer.h"
+#include "LevelSpatialHash.h"
+#include "LevelGrid.h"
+#include "LevelPathfinder.h"
+#include "ProjectilePool.h"
+#include "ProjectileLayer.h"
+#include "MonsterStore.h"
+#include "MonsterRenderer.h"
 #include "ImageAssetLoader.h"
 #include "Character.h"
 #include "Music.h"
@@ -45,8 +58,7 @@ public:
   };
 
   //! Destructor
-  virtual ~Level()
-  { /* ... */ }
+  virtual ~Level();
 
   //! Get the type
   virtual Type getType() const = 0;
@@ -57,9 +69,18 @@ public:
   //! Get the image asset name
   virtual QString getImageAssetName() const = 0;
 
-  //! Create the level background
+  //! Get the sound sources that should be preloaded
+  virtual QStringList getSoundSources() const;
+
+  //! Create the level background (off the GUI thread)
   void createBackground();
 
+  //! Create the level background synchronously
+  void createBackgroundSync();
+
+  //! Check if the level background has been created
+  bool isBackgroundReady() const;
+
   //! Add a level object
   void addLevelObject( LevelObject* level_object, const QPointF& location );
 
@@ -86,8 +107,68 @@ public:
   //! Check if the level is ready
   bool isReady();
 
+  //! Register an object that must be advanced every simulation tick
+  void registerAnimatedObject( LevelObject* level_object );
+
+  //! Unregister an object that no longer needs simulation ticks
+  void unregisterAnimatedObject( LevelObject* level_object );
+
+  //! Check if an object is registered for simulation ticks
+  bool isAnimatedObjectRegistered( LevelObject* level_object ) const;
+
+  //! Get the number of objects that are advanced every simulation tick
+  int getNumberOfAnimatedObjects() const;
+
+  //! Get the level grid
+  const LevelGrid& getGrid() const;
+
+  //! Get the level pathfinder
+  LevelPathfinder& getPathfinder();
+
+  //! Get the level projectile pool
+  ProjectilePool& getProjectilePool();
+
+  //! Get the level monster store
+  MonsterStore& getMonsterStore();
+
+  //! Get the level monster renderer
+  MonsterRenderer& getMonsterRenderer();
+
+  //! Get the level region streamer
+  LevelRegionStreamer& getRegionStreamer();
+
+  //! Request a path between two level positions
+  int requestPath( const QPointF& start, const QPointF& goal );
+
+  //! Take the waypoints (tile centers) of a processed path request
+  bool takePath( const int request_id, QVector<QPointF>& waypoints );
+
+  //! Get the level objects inside of a rect
+  QList<LevelObject*> getLevelObjectsInRect( const QRectF& rect ) const;
+
+  //! Get the level objects inside of a circle
+  QList<LevelObject*> getLevelObjectsInRadius( const QPointF& center,
+                                               const qreal radius ) const;
+
+  //! Get the level objects within a distance of a line segment
+  QList<LevelObject*> getLevelObjectsAlongLine( const QPointF& start,
+                                                const QPointF& end,
+                                                const qreal half_width ) const;
+
+  //! Get the level object spatial hash
+  const LevelSpatialHash<LevelObject*>& getLevelObjectSpatialHash() const;
+
+  //! Advance the level simulation by a single tick
+  void advanceTick();
+
+  //! Place the actors between their last two simulated positions
+  void interpolateActors( const qreal fraction );
+
 signals:
 
+  //! Background created
+  void backgroundCreated();
+
   //! Asset loading started
   void assetLoadingStarted( const int number_of_assets );
 
@@ -134,8 +215,29 @@ protected:
   //! Set the music
   void setMusic( const std::shared_ptr<Music>& music );
 
-  //! Create the level sectors
-  virtual void createSectors( QList<LevelSector*>& sectors ) = 0;
+  //! The level background
+  struct Background{
+    //! The baked level blob
+    std::shared_ptr<LevelBlob> blob;
+    //! The sectors (positioned but not added to the scene)
+    QList<LevelSector*> sectors;
+    //! The scene rect
+    QRectF scene_rect;
+    //! The level grid
+    LevelGrid grid;
+  };
+
+  //! The level background data loader (only plain data can be created)
+  typedef void (*BackgroundDataLoader)( Background& background );
+
+  //! Get the background data loader (the loader is called off the GUI thread)
+  virtual BackgroundDataLoader getBackgroundDataLoader() const = 0;
+
+  //! Create the background sectors from the loaded data (on the GUI thread)
+  virtual void createBackgroundSectors( Background& background ) const = 0;
+
+  //! Set the level grid
+  void setGrid( const LevelGrid& grid );
 
 private slots:
 
@@ -150,8 +252,30 @@ private slots:
   // Handle image asset loading finished
   void handleImageAssetLoadingFinished( const int number_of_assets_loaded );
 
+  // Handle background created
+  void handleBackgroundCreated();
+
+  // Handle a level object animation state change
+  void handleLevelObjectAnimationStateChanged( const bool animated );
+
 private:
 
+  // Check if the background creation has been started
+  bool isBackgroundStarted() const;
+
+  // Load the level background data (run in a worker thread)
+  static std::shared_ptr<Background> loadBackgroundDataImpl(
+                                           BackgroundDataLoader loader );
+
+  // Add the created background to the scene
+  void insertBackground();
+
+  // Wait for the background (and add it to the scene)
+  void waitForBackground();
+
+  // Finish image asset loading (requires the background)
+  void finishImageAssetLoading( const int number_of_assets_loaded );
+
   // Reset the asset data
   void resetAssetData();
 
@@ -168,6 +292,12 @@ private:
   // Connect the image asset loader signals to the level slots
   void connectImageAssetLoaderSignalsToLevelSlots() const;
 
+  // Track the animation state of a level object
+  void trackAnimationState( LevelObject* level_object );
+
+  // Stop tracking the animation state of a level object
+  void untrackAnimationState( LevelObject* level_object );
+
   // The character
   Character* d_character;
 
@@ -177,6 +307,54 @@ private:
   // The level sectors
   QList<LevelSector*> d_level_sectors;
 
+  // The level region streamer (streams in the sectors)
+  LevelRegionStreamer d_region_streamer;
+
+  // The background that is being created
+  std::shared_ptr<Background> d_background;
+
+  // The background data loading watcher
+  QFutureWatcher<std::shared_ptr<Background> > d_background_watcher;
+
+  // Records if the background has been added to the scene
+  bool d_background_ready;
+
+  // The number of loaded image assets that are waiting for the background
+  int d_pending_number_of_assets_loaded;
+
+  // The max number of path requests processed every simulation tick
+  static const int s_max_path_requests_per_tick = 16;
+
+  // The level music crossfade time (ms)
+  static const int s_music_crossfade_time = 2000;
+
+  // The level grid
+  LevelGrid d_grid;
+
+  // The level pathfinder
+  LevelPathfinder d_pathfinder;
+
+  // The projectile pool
+  ProjectilePool d_projectile_pool;
+
+  // The projectile layer (owned by the scene)
+  ProjectileLayer* d_projectile_layer;
+
+  // The monster store
+  MonsterStore d_monster_store;
+
+  // The monster renderer
+  MonsterRenderer d_monster_renderer;
+
+  // The actors (including the character)
+  QList<Actor*> d_actors;
+
+  // The objects that are advanced every simulation tick
+  QList<LevelObject*> d_animated_objects;
+
+  // The level object spatial hash (externally added objects and character)
+  LevelSpatialHash<LevelObject*> d_level_object_spatial_hash;
+
   // The level object asset map (all objects)
   QMap<QString,QList<LevelObject*> > d_level_object_asset_map;
 
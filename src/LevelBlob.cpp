@@ -0,0 +1,531 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelBlob.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level blob class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtEndian>
+#include <QFileInfo>
+#include <QDir>
+
+// QtD1 Includes
+#include "LevelBlob.h"
+#include "LevelPillarFactory.h"
+#include "qtd1_config.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int LevelBlob::s_max_file_name_length;
+const int LevelBlob::s_source_checksum_length;
+const int LevelBlob::s_z_ordered_square_size;
+const int LevelBlob::s_placement_size;
+const quint32 LevelBlob::s_magic;
+const quint32 LevelBlob::s_version;
+QString LevelBlob::s_baked_levels_directory( BAKED_LEVELS_DIR );
+
+// Set the baked level directory (before any level is loaded)
+void LevelBlob::setBakedLevelsDirectory( const QString& directory )
+{
+  s_baked_levels_directory = directory;
+}
+
+// Get the baked level directory
+/*! \details If no directory has been set (or configured with
+ * BAKED_LEVELS_DIR) the levels are baked to ~/.qtd1/levels, which is
+ * writable by an installed game.
+ */
+QString LevelBlob::getBakedLevelsDirectory()
+{
+  if( s_baked_levels_directory.isEmpty() )
+    return QDir::homePath() + "/.qtd1/levels";
+  else
+    return s_baked_levels_directory;
+}
+
+// Get the baked level file name
+QString LevelBlob::getBakedLevelFileName( const QString& level_name )
+{
+  return LevelBlob::getBakedLevelsDirectory() + "/" + level_name + ".qd1l";
+}
+
+// Constructor
+LevelBlob::LevelBlob()
+  : d_file(),
+    d_buffer(),
+    d_data( NULL ),
+    d_size( 0 )
+{ /* ... */ }
+
+// Destructor
+LevelBlob::~LevelBlob()
+{
+  this->close();
+}
+
+// Open (memory map) a baked level file
+/*! \details False will be returned if the file does not exist or if it is
+ * not a valid blob of the current format version (it must be rebaked).
+ */
+bool LevelBlob::open( const QString& file_name )
+{
+  this->close();
+
+  if( !QFileInfo( file_name ).exists() )
+    return false;
+
+  d_file.setFileName( file_name );
+
+  if( !d_file.open( QIODevice::ReadOnly ) )
+    return false;
+
+  d_size = d_file.size();
+  d_data = d_file.map( 0, d_size );
+
+  if( !d_data || !this->validate() )
+  {
+    qWarning( "LevelBlob Warning: %s is not a valid baked level!",
+              file_name.toStdString().c_str() );
+
+    this->close();
+
+    return false;
+  }
+
+  return true;
+}
+
+// Open an in-memory blob
+bool LevelBlob::open( const QByteArray& data )
+{
+  this->close();
+
+  d_buffer = data;
+  d_data = (const uchar*)d_buffer.constData();
+  d_size = d_buffer.size();
+
+  if( !this->validate() )
+  {
+    qWarning( "LevelBlob Warning: The data is not a valid baked level!" );
+
+    this->close();
+
+    return false;
+  }
+
+  return true;
+}
+
+// Close the blob
+void LevelBlob::close()
+{
+  if( d_file.isOpen() )
+  {
+    if( d_data )
+      d_file.unmap( const_cast<uchar*>( d_data ) );
+
+    d_file.close();
+  }
+
+  d_buffer.clear();
+  d_data = NULL;
+  d_size = 0;
+}
+
+// Check if the blob is open
+bool LevelBlob::isOpen() const
+{
+  return d_data != NULL;
+}
+
+// Get the level min file name
+QString LevelBlob::getLevelMinFileName() const
+{
+  const char* file_name = (const char*)(d_data + MinFileNameField);
+
+  return QString::fromLatin1( file_name,
+                              qstrnlen( file_name,
+                                        s_max_file_name_length ) );
+}
+
+// Get the checksum of the level files that the blob was baked from
+QByteArray LevelBlob::getSourceChecksum() const
+{
+  return QByteArray( (const char*)(d_data + SourceChecksumField),
+                     s_source_checksum_length );
+}
+
+// Get the number of pillars
+int LevelBlob::getNumberOfPillars() const
+{
+  return this->getHeaderField( NumberOfPillarsField );
+}
+
+// Get the number of blocks in each pillar
+int LevelBlob::getBlocksPerPillar() const
+{
+  return this->getHeaderField( BlocksPerPillarField );
+}
+
+// Get the number of squares
+int LevelBlob::getNumberOfSquares() const
+{
+  return this->getHeaderField( NumberOfSquaresField );
+}
+
+// Get the number of sectors
+int LevelBlob::getNumberOfSectors() const
+{
+  return this->getHeaderField( NumberOfSectorsField );
+}
+
+// Find a sector by its dun file name (returns -1 if not found)
+int LevelBlob::findSector( const QString& level_dun_file_name ) const
+{
+  const QByteArray raw_file_name = level_dun_file_name.toLatin1();
+
+  for( int i = 0; i < this->getNumberOfSectors(); ++i )
+  {
+    const char* file_name =
+      (const char*)(this->getSectorRecord( i ) + DunFileNameField);
+
+    if( qstrncmp( file_name,
+                  raw_file_name.constData(),
+                  s_max_file_name_length ) == 0 )
+      return i;
+  }
+
+  return -1;
+}
+
+// Get the number of square rows in a sector
+int LevelBlob::getSectorNumberOfRows( const int sector ) const
+{
+  return this->getShortSectorField( sector, NumberOfRowsField );
+}
+
+// Get the number of square columns in a sector
+int LevelBlob::getSectorNumberOfColumns( const int sector ) const
+{
+  return this->getShortSectorField( sector, NumberOfColumnsField );
+}
+
+// Create the level squares
+/*! \details The pillar blocks only have to be decoded (the min and til
+ * files are not parsed).
+ */
+QList<std::shared_ptr<LevelSquare> > LevelBlob::createLevelSquares() const
+{
+  LevelPillarFactory pillar_factory( this->getLevelMinFileName() );
+
+  // Create the level pillars
+  const int number_of_pillars = this->getNumberOfPillars();
+  const int blocks_per_pillar = this->getBlocksPerPillar();
+
+  const uchar* raw_blocks =
+    d_data + this->getHeaderField( PillarBlocksOffsetField );
+
+  QList<std::shared_ptr<LevelPillar> > level_pillars;
+  level_pillars.reserve( number_of_pillars );
+
+  QVector<LevelPillar::Block> blocks( blocks_per_pillar );
+
+  for( int i = 0; i < number_of_pillars; ++i )
+  {
+    for( int j = 0; j < blocks_per_pillar; ++j )
+    {
+      blocks[j] = LevelPillarFactory::decodeBlock(
+                 qFromLittleEndian<quint16>( raw_blocks +
+                                             2*(i*blocks_per_pillar + j) ) );
+    }
+
+    level_pillars << pillar_factory.createLevelPillar( blocks );
+  }
+
+  // Create the level squares
+  const int number_of_squares = this->getNumberOfSquares();
+
+  const uchar* raw_square_pillars =
+    d_data + this->getHeaderField( SquarePillarsOffsetField );
+
+  QList<std::shared_ptr<LevelSquare> > level_squares;
+  level_squares.reserve( number_of_squares );
+
+  for( int i = 0; i < number_of_squares; ++i )
+  {
+    quint16 pillar_indices[4];
+
+    for( int k = 0; k < 4; ++k )
+    {
+      pillar_indices[k] =
+        qFromLittleEndian<quint16>( raw_square_pillars + 2*(4*i + k) );
+    }
+
+    std::shared_ptr<LevelSquare> level_square(
+               new LevelSquare( level_pillars[pillar_indices[0]]->clone(),
+                                level_pillars[pillar_indices[1]]->clone(),
+                                level_pillars[pillar_indices[2]]->clone(),
+                                level_pillars[pillar_indices[3]]->clone() ) );
+
+    level_squares << level_square;
+  }
+
+  return level_squares;
+}
+
+// Create a level sector
+/*! \details The squares are cloned in their precomputed z-order and placed
+ * at their precomputed positions.
+ */
+LevelSector* LevelBlob::createLevelSector(
+                const int sector,
+                const QList<std::shared_ptr<LevelSquare> >& squares ) const
+{
+  const int number_of_z_ordered_squares =
+    this->getSectorField( sector, NumberOfZOrderedSquaresField );
+
+  const uchar* raw_z_order =
+    d_data + this->getSectorField( sector, ZOrderOffsetField );
+
+  QList<LevelSquare*> z_ordered_squares;
+  z_ordered_squares.reserve( number_of_z_ordered_squares );
+
+  for( int i = 0; i < number_of_z_ordered_squares; ++i )
+  {
+    const uchar* entry = raw_z_order + i*s_z_ordered_square_size;
+
+    const quint16 square_index = qFromLittleEndian<quint16>( entry );
+
+    if( square_index == 0 || square_index > squares.size() )
+    {
+      qFatal( "LevelBlob Error: Invalid square index %i in sector %i!",
+              square_index, sector );
+    }
+
+    LevelSquare* square = squares[square_index-1]->clone();
+
+    square->setPos( qFromLittleEndian<qint16>( entry + 2 ),
+                    qFromLittleEndian<qint16>( entry + 4 ) );
+
+    z_ordered_squares << square;
+  }
+
+  return new LevelSector( this->getSectorNumberOfRows( sector ),
+                          this->getSectorNumberOfColumns( sector ),
+                          z_ordered_squares );
+}
+
+// Create a level sector grid
+LevelGrid LevelBlob::createLevelGrid( const int sector ) const
+{
+  LevelGrid grid( 2*this->getSectorNumberOfColumns( sector ),
+                  2*this->getSectorNumberOfRows( sector ) );
+
+  const uchar* raw_pillar_ids =
+    d_data + this->getSectorField( sector, TilePillarIdsOffsetField );
+
+  const uchar* raw_flags =
+    d_data + this->getSectorField( sector, TileFlagsOffsetField );
+
+  for( int j = 0; j < grid.getHeight(); ++j )
+  {
+    for( int i = 0; i < grid.getWidth(); ++i )
+    {
+      const int index = j*grid.getWidth() + i;
+
+      grid.setPillarId( i, j,
+                        qFromLittleEndian<quint16>( raw_pillar_ids +
+                                                    2*index ) );
+      grid.setFlags( i, j, raw_flags[index] );
+    }
+  }
+
+  return grid;
+}
+
+// Get the monster placements of a sector
+void LevelBlob::getMonsterPlacements(
+       const int sector,
+       QVector<LevelSectorFactory::Placement>& monster_placements ) const
+{
+  this->getPlacements( sector,
+                       NumberOfMonstersField,
+                       MonstersOffsetField,
+                       monster_placements );
+}
+
+// Get the object placements of a sector
+void LevelBlob::getObjectPlacements(
+       const int sector,
+       QVector<LevelSectorFactory::Placement>& object_placements ) const
+{
+  this->getPlacements( sector,
+                       NumberOfObjectsField,
+                       ObjectsOffsetField,
+                       object_placements );
+}
+
+// Validate the blob data
+/*! \details Every section must lie inside of the blob so that the accessors
+ * never have to check the bounds.
+ */
+bool LevelBlob::validate() const
+{
+  if( d_size < HeaderSize )
+    return false;
+
+  if( this->getHeaderField( MagicField ) != s_magic )
+    return false;
+
+  if( this->getHeaderField( VersionField ) != s_version )
+    return false;
+
+  if( this->getHeaderField( SizeField ) != d_size )
+    return false;
+
+  const qint64 number_of_pillars = this->getNumberOfPillars();
+  const qint64 number_of_squares = this->getNumberOfSquares();
+  const qint64 number_of_sectors = this->getNumberOfSectors();
+
+  if( !this->isSectionValid( this->getHeaderField( PillarBlocksOffsetField ),
+                             2*number_of_pillars*this->getBlocksPerPillar() ) )
+    return false;
+
+  if( !this->isSectionValid( this->getHeaderField( SquarePillarsOffsetField ),
+                             2*4*number_of_squares ) )
+    return false;
+
+  if( !this->isSectionValid( this->getHeaderField( PillarFlagsOffsetField ),
+                             number_of_pillars ) )
+    return false;
+
+  if( !this->isSectionValid( this->getHeaderField( SectorsOffsetField ),
+                             number_of_sectors*SectorRecordSize ) )
+    return false;
+
+  // Check the square pillar indices
+  const uchar* raw_square_pillars =
+    d_data + this->getHeaderField( SquarePillarsOffsetField );
+
+  for( int i = 0; i < 4*number_of_squares; ++i )
+  {
+    if( qFromLittleEndian<quint16>( raw_square_pillars + 2*i ) >=
+        number_of_pillars )
+      return false;
+  }
+
+  // Check the sectors
+  for( int i = 0; i < number_of_sectors; ++i )
+  {
+    const qint64 number_of_squares_in_sector =
+      (qint64)this->getSectorNumberOfRows( i )*
+      this->getSectorNumberOfColumns( i );
+
+    if( !this->isSectionValid(
+                        this->getSectorField( i, SquareIndicesOffsetField ),
+                        2*number_of_squares_in_sector ) )
+      return false;
+
+    if( !this->isSectionValid(
+                        this->getSectorField( i, ZOrderOffsetField ),
+                        (qint64)s_z_ordered_square_size*
+                        this->getSectorField( i,
+                                              NumberOfZOrderedSquaresField ) ) )
+      return false;
+
+    if( !this->isSectionValid(
+                        this->getSectorField( i, TilePillarIdsOffsetField ),
+                        2*4*number_of_squares_in_sector ) )
+      return false;
+
+    if( !this->isSectionValid( this->getSectorField( i, TileFlagsOffsetField ),
+                               4*number_of_squares_in_sector ) )
+      return false;
+
+    if( !this->isSectionValid(
+                        this->getSectorField( i, MonstersOffsetField ),
+                        (qint64)s_placement_size*
+                        this->getSectorField( i, NumberOfMonstersField ) ) )
+      return false;
+
+    if( !this->isSectionValid(
+                        this->getSectorField( i, ObjectsOffsetField ),
+                        (qint64)s_placement_size*
+                        this->getSectorField( i, NumberOfObjectsField ) ) )
+      return false;
+  }
+
+  return true;
+}
+
+// Check that a section lies inside of the blob
+bool LevelBlob::isSectionValid( const quint32 offset,
+                                const qint64 size ) const
+{
+  return offset >= (quint32)HeaderSize && offset % 4 == 0 &&
+    offset + size <= d_size;
+}
+
+// Read a header field
+quint32 LevelBlob::getHeaderField( const HeaderField field ) const
+{
+  return qFromLittleEndian<quint32>( d_data + field );
+}
+
+// Get a sector record
+const uchar* LevelBlob::getSectorRecord( const int sector ) const
+{
+  if( sector < 0 || sector >= this->getNumberOfSectors() )
+    qFatal( "LevelBlob Error: Invalid sector %i!", sector );
+
+  return d_data + this->getHeaderField( SectorsOffsetField ) +
+    sector*SectorRecordSize;
+}
+
+// Read a 32-bit sector record field
+quint32 LevelBlob::getSectorField( const int sector,
+                                   const SectorField field ) const
+{
+  return qFromLittleEndian<quint32>( this->getSectorRecord( sector ) + field );
+}
+
+// Read a 16-bit sector record field
+quint16 LevelBlob::getShortSectorField( const int sector,
+                                        const SectorField field ) const
+{
+  return qFromLittleEndian<quint16>( this->getSectorRecord( sector ) + field );
+}
+
+// Read the placements of a sector
+void LevelBlob::getPlacements(
+             const int sector,
+             const SectorField number_field,
+             const SectorField offset_field,
+             QVector<LevelSectorFactory::Placement>& placements ) const
+{
+  const int number_of_placements =
+    this->getSectorField( sector, number_field );
+
+  const uchar* raw_placements =
+    d_data + this->getSectorField( sector, offset_field );
+
+  placements.resize( number_of_placements );
+
+  for( int i = 0; i < number_of_placements; ++i )
+  {
+    const uchar* entry = raw_placements + i*s_placement_size;
+
+    placements[i].x = qFromLittleEndian<quint16>( entry );
+    placements[i].y = qFromLittleEndian<quint16>( entry + 2 );
+    placements[i].id = qFromLittleEndian<quint16>( entry + 4 );
+  }
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end LevelBlob.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,230 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelBlob.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level blob class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LEVEL_BLOB_H
+#define LEVEL_BLOB_H
+
+// Std Lib Includes
+#include <memory>
+
+// Qt Includes
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QFile>
+
+// QtD1 Includes
+#include "LevelSquare.h"
+#include "LevelSector.h"
+#include "LevelSectorFactory.h"
+#include "LevelGrid.h"
+
+namespace QtD1{
+
+/*! The level blob
+ *
+ * A baked level is a single binary blob that holds everything that is
+ * parsed from the min, til, sol and dun files of a level: the pillar block
+ * tables, the square pillar tables and, for each sector, the square indices,
+ * the squares in z-order (with their positions), the sector grid and the
+ * monster and object placements. The blob is memory mapped and the level
+ * objects are constructed directly from it - no level files are parsed when
+ * a baked level is entered. Blobs are generated by the LevelBlobBaker
+ * (either by the qtd1_level_baker tool or on the first run).
+ *
+ * All values are stored little-endian and all sections are 4 byte aligned.
+ * A blob with a different magic number or format version is rejected. The
+ * header also stores a checksum of the level files that the blob was baked
+ * from so that a stale blob can be detected (see
+ * LevelBlobBaker::calculateSourceChecksum).
+ */
+class LevelBlob
+{
+
+public:
+
+  //! The header field offsets (bytes)
+  enum HeaderField{
+    MagicField = 0,
+    VersionField = 4,
+    NumberOfPillarsField = 8,
+    BlocksPerPillarField = 12,
+    NumberOfSquaresField = 16,
+    NumberOfSectorsField = 20,
+    PillarBlocksOffsetField = 24,
+    SquarePillarsOffsetField = 28,
+    PillarFlagsOffsetField = 32,
+    SectorsOffsetField = 36,
+    SizeField = 40,
+    MinFileNameField = 44,
+    SourceChecksumField = 108,
+    HeaderSize = 124
+  };
+
+  //! The sector record field offsets (bytes)
+  enum SectorField{
+    DunFileNameField = 0,
+    NumberOfColumnsField = 64,
+    NumberOfRowsField = 66,
+    SquareIndicesOffsetField = 68,
+    ZOrderOffsetField = 72,
+    NumberOfZOrderedSquaresField = 76,
+    TilePillarIdsOffsetField = 80,
+    TileFlagsOffsetField = 84,
+    NumberOfMonstersField = 88,
+    MonstersOffsetField = 92,
+    NumberOfObjectsField = 96,
+    ObjectsOffsetField = 100,
+    SectorRecordSize = 104
+  };
+
+  //! The max length of a stored file name (including the terminating null)
+  static const int s_max_file_name_length = 64;
+
+  //! The length of the source checksum (md5)
+  static const int s_source_checksum_length = 16;
+
+  //! The size of a z-ordered square entry (index, x, y, padding)
+  static const int s_z_ordered_square_size = 8;
+
+  //! The size of a placement entry (x, y, id, padding)
+  static const int s_placement_size = 8;
+
+  //! The magic number
+  static const quint32 s_magic = 0x4C314451; // "QD1L"
+
+  //! The format version
+  static const quint32 s_version = 2;
+
+  //! Set the baked level directory (before any level is loaded)
+  static void setBakedLevelsDirectory( const QString& directory );
+
+  //! Get the baked level directory
+  static QString getBakedLevelsDirectory();
+
+  //! Get the baked level file name
+  static QString getBakedLevelFileName( const QString& level_name );
+
+  //! Constructor
+  LevelBlob();
+
+  //! Destructor
+  ~LevelBlob();
+
+  //! Open (memory map) a baked level file
+  bool open( const QString& file_name );
+
+  //! Open an in-memory blob
+  bool open( const QByteArray& data );
+
+  //! Close the blob
+  void close();
+
+  //! Check if the blob is open
+  bool isOpen() const;
+
+  //! Get the level min file name
+  QString getLevelMinFileName() const;
+
+  //! Get the checksum of the level files that the blob was baked from
+  QByteArray getSourceChecksum() const;
+
+  //! Get the number of pillars
+  int getNumberOfPillars() const;
+
+  //! Get the number of blocks in each pillar
+  int getBlocksPerPillar() const;
+
+  //! Get the number of squares
+  int getNumberOfSquares() const;
+
+  //! Get the number of sectors
+  int getNumberOfSectors() const;
+
+  //! Find a sector by its dun file name (returns -1 if not found)
+  int findSector( const QString& level_dun_file_name ) const;
+
+  //! Get the number of square rows in a sector
+  int getSectorNumberOfRows( const int sector ) const;
+
+  //! Get the number of square columns in a sector
+  int getSectorNumberOfColumns( const int sector ) const;
+
+  //! Create the level squares
+  QList<std::shared_ptr<LevelSquare> > createLevelSquares() const;
+
+  //! Create a level sector
+  LevelSector* createLevelSector(
+               const int sector,
+               const QList<std::shared_ptr<LevelSquare> >& squares ) const;
+
+  //! Create a level sector grid
+  LevelGrid createLevelGrid( const int sector ) const;
+
+  //! Get the monster placements of a sector
+  void getMonsterPlacements(
+      const int sector,
+      QVector<LevelSectorFactory::Placement>& monster_placements ) const;
+
+  //! Get the object placements of a sector
+  void getObjectPlacements(
+      const int sector,
+      QVector<LevelSectorFactory::Placement>& object_placements ) const;
+
+private:
+
+  // Validate the blob data
+  bool validate() const;
+
+  // Check that a section lies inside of the blob
+  bool isSectionValid( const quint32 offset, const qint64 size ) const;
+
+  // Read a header field
+  quint32 getHeaderField( const HeaderField field ) const;
+
+  // Get a sector record
+  const uchar* getSectorRecord( const int sector ) const;
+
+  // Read a 32-bit sector record field
+  quint32 getSectorField( const int sector, const SectorField field ) const;
+
+  // Read a 16-bit sector record field
+  quint16 getShortSectorField( const int sector,
+                               const SectorField field ) const;
+
+  // Read the placements of a sector
+  void getPlacements(
+            const int sector,
+            const SectorField number_field,
+            const SectorField offset_field,
+            QVector<LevelSectorFactory::Placement>& placements ) const;
+
+  // The baked level directory
+  static QString s_baked_levels_directory;
+
+  // The mapped file
+  QFile d_file;
+
+  // The in-memory data
+  QByteArray d_buffer;
+
+  // The blob data
+  const uchar* d_data;
+
+  // The blob size
+  qint64 d_size;
+};
+
+} // end QtD1 namespace
+
+#endif // end LEVEL_BLOB_H
+
+//---------------------------------------------------------------------------//
+// end LevelBlob.h
+//---------------------------------------------------------------------------//
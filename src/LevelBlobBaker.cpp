@@ -0,0 +1,411 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelBlobBaker.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level blob baker class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cstring>
+
+// Qt Includes
+#include <QtEndian>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMap>
+#include <QCryptographicHash>
+
+// QtD1 Includes
+#include "LevelBlobBaker.h"
+#include "LevelBlob.h"
+#include "LevelPillarFactory.h"
+#include "LevelSectorFactory.h"
+
+namespace QtD1{
+
+// Constructor
+LevelBlobBaker::LevelBlobBaker( const QString& level_min_file_name,
+                                const QString& level_til_file_name,
+                                const QString& level_sol_file_name )
+  : d_level_min_file_name( level_min_file_name ),
+    d_level_til_file_name( level_til_file_name ),
+    d_level_sol_file_name( level_sol_file_name ),
+    d_level_dun_file_names()
+{
+  if( level_min_file_name.size() >= LevelBlob::s_max_file_name_length )
+  {
+    qFatal( "LevelBlobBaker Error: The min file name %s is too long!",
+            level_min_file_name.toStdString().c_str() );
+  }
+}
+
+// Add a sector
+void LevelBlobBaker::addSector( const QString& level_dun_file_name )
+{
+  if( level_dun_file_name.size() >= LevelBlob::s_max_file_name_length )
+  {
+    qFatal( "LevelBlobBaker Error: The dun file name %s is too long!",
+            level_dun_file_name.toStdString().c_str() );
+  }
+
+  d_level_dun_file_names << level_dun_file_name;
+}
+
+// Calculate the checksum of the level files
+/*! \details The checksum is the md5 hash of the contents of the min, til,
+ * sol and dun files (in that order). The files are only read, not parsed.
+ */
+QByteArray LevelBlobBaker::calculateSourceChecksum() const
+{
+  QStringList level_file_names;
+  level_file_names << d_level_min_file_name << d_level_til_file_name;
+
+  if( !d_level_sol_file_name.isEmpty() )
+    level_file_names << d_level_sol_file_name;
+
+  level_file_names << d_level_dun_file_names;
+
+  QCryptographicHash hash( QCryptographicHash::Md5 );
+
+  QStringList::const_iterator file_name_it, file_name_end;
+  file_name_it = level_file_names.begin();
+  file_name_end = level_file_names.end();
+
+  while( file_name_it != file_name_end )
+  {
+    QFile file( *file_name_it );
+    file.open( QIODevice::ReadOnly );
+
+    hash.addData( file.readAll() );
+
+    ++file_name_it;
+  }
+
+  return hash.result();
+}
+
+// Bake the level blob
+/*! \details The level files are parsed with the level factories. The
+ * square z-order of each sector is the one calculated by the LevelSector
+ * constructor (sorted by y, then by row and column).
+ */
+QByteArray LevelBlobBaker::bake() const
+{
+  // Parse the level tables
+  LevelPillarFactory pillar_factory( d_level_min_file_name );
+
+  const int blocks_per_pillar = pillar_factory.getNumberOfBlocksPerPillar();
+
+  QByteArray raw_pillar_blocks;
+
+  {
+    QFile min_file( d_level_min_file_name );
+    min_file.open( QIODevice::ReadOnly );
+
+    raw_pillar_blocks = min_file.readAll();
+  }
+
+  const int number_of_pillars =
+    raw_pillar_blocks.size()/(2*blocks_per_pillar);
+
+  QVector<quint16> square_pillar_indices;
+  LevelSectorFactory::readSquarePillarIndices( d_level_til_file_name,
+                                               square_pillar_indices );
+
+  const int number_of_squares = square_pillar_indices.size()/4;
+
+  QByteArray pillar_flags;
+
+  if( !d_level_sol_file_name.isEmpty() )
+  {
+    LevelSectorFactory::readPillarFlags( d_level_sol_file_name,
+                                         pillar_flags );
+  }
+
+  // Write the header
+  QByteArray blob( LevelBlob::HeaderSize, '\0' );
+
+  LevelBlobBaker::setField( blob, LevelBlob::MagicField, LevelBlob::s_magic );
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::VersionField,
+                            LevelBlob::s_version );
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::NumberOfPillarsField,
+                            number_of_pillars );
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::BlocksPerPillarField,
+                            blocks_per_pillar );
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::NumberOfSquaresField,
+                            number_of_squares );
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::NumberOfSectorsField,
+                            d_level_dun_file_names.size() );
+  LevelBlobBaker::setFileNameField( blob,
+                                    LevelBlob::MinFileNameField,
+                                    d_level_min_file_name );
+
+  const QByteArray source_checksum = this->calculateSourceChecksum();
+
+  memcpy( blob.data() + LevelBlob::SourceChecksumField,
+          source_checksum.constData(),
+          LevelBlob::s_source_checksum_length );
+
+  // Write the pillar blocks (the raw min file data)
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::PillarBlocksOffsetField,
+                            LevelBlobBaker::align( blob ) );
+
+  blob.append( raw_pillar_blocks.left( 2*number_of_pillars*blocks_per_pillar ) );
+
+  // Write the square pillar indices
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::SquarePillarsOffsetField,
+                            LevelBlobBaker::align( blob ) );
+
+  LevelBlobBaker::appendShorts( blob,
+                                square_pillar_indices.constData(),
+                                4*number_of_squares );
+
+  // Write the pillar flags (one per pillar)
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::PillarFlagsOffsetField,
+                            LevelBlobBaker::align( blob ) );
+
+  blob.append( pillar_flags.left( number_of_pillars ) );
+  blob.append( QByteArray( number_of_pillars -
+                           qMin( pillar_flags.size(), number_of_pillars ),
+                           '\0' ) );
+
+  // Write the sector records (the sections are filled in below)
+  const int sectors_offset = LevelBlobBaker::align( blob );
+
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::SectorsOffsetField,
+                            sectors_offset );
+
+  blob.append( QByteArray( d_level_dun_file_names.size()*
+                           LevelBlob::SectorRecordSize,
+                           '\0' ) );
+
+  for( int s = 0; s < d_level_dun_file_names.size(); ++s )
+  {
+    const int record = sectors_offset + s*LevelBlob::SectorRecordSize;
+
+    LevelSectorFactory sector_factory( d_level_min_file_name,
+                                       d_level_til_file_name,
+                                       d_level_dun_file_names[s] );
+
+    int num_rows, num_cols;
+    QVector<quint16> square_indices;
+
+    sector_factory.readSquareIndices( num_rows, num_cols, square_indices );
+
+    LevelBlobBaker::setFileNameField( blob,
+                                      record + LevelBlob::DunFileNameField,
+                                      d_level_dun_file_names[s] );
+    LevelBlobBaker::setShortField( blob,
+                                   record + LevelBlob::NumberOfColumnsField,
+                                   num_cols );
+    LevelBlobBaker::setShortField( blob,
+                                   record + LevelBlob::NumberOfRowsField,
+                                   num_rows );
+
+    // Write the square indices
+    LevelBlobBaker::setField( blob,
+                              record + LevelBlob::SquareIndicesOffsetField,
+                              LevelBlobBaker::align( blob ) );
+
+    LevelBlobBaker::appendShorts( blob,
+                                  square_indices.constData(),
+                                  square_indices.size() );
+
+    // Write the squares in z-order with their positions
+    const int sector_width = (num_cols+num_rows)*64;
+
+    QMap<int,QVector<quint16> > z_order_map;
+
+    for( int j = 0; j < num_rows; ++j )
+    {
+      for( int i = 0; i < num_cols; ++i )
+      {
+        const quint16 square_index = square_indices[j*num_cols + i];
+
+        if( square_index > 0 )
+        {
+          const int y_pos = (i+j)*32;
+          const int x_pos = sector_width/2 + (i-j-1)*64;
+
+          z_order_map[y_pos] << square_index << (quint16)(qint16)x_pos
+                             << (quint16)(qint16)y_pos << 0;
+        }
+      }
+    }
+
+    LevelBlobBaker::setField( blob,
+                              record + LevelBlob::ZOrderOffsetField,
+                              LevelBlobBaker::align( blob ) );
+
+    int number_of_z_ordered_squares = 0;
+
+    QMap<int,QVector<quint16> >::const_iterator z_order_it, z_order_end;
+    z_order_it = z_order_map.begin();
+    z_order_end = z_order_map.end();
+
+    while( z_order_it != z_order_end )
+    {
+      LevelBlobBaker::appendShorts( blob,
+                                    z_order_it.value().constData(),
+                                    z_order_it.value().size() );
+
+      number_of_z_ordered_squares += z_order_it.value().size()/4;
+
+      ++z_order_it;
+    }
+
+    LevelBlobBaker::setField( blob,
+                              record + LevelBlob::NumberOfZOrderedSquaresField,
+                              number_of_z_ordered_squares );
+
+    // Write the sector grid
+    const LevelGrid grid =
+      sector_factory.createLevelGrid( square_pillar_indices, pillar_flags );
+
+    LevelBlobBaker::setField( blob,
+                              record + LevelBlob::TilePillarIdsOffsetField,
+                              LevelBlobBaker::align( blob ) );
+
+    LevelBlobBaker::appendShorts( blob,
+                                  grid.getRawPillarIds(),
+                                  grid.getNumberOfTiles() );
+
+    LevelBlobBaker::setField( blob,
+                              record + LevelBlob::TileFlagsOffsetField,
+                              LevelBlobBaker::align( blob ) );
+
+    blob.append( (const char*)grid.getRawFlags(), grid.getNumberOfTiles() );
+
+    // Write the monster and object placements
+    QVector<LevelSectorFactory::Placement> placements[2];
+
+    sector_factory.readPlacements( placements[0], placements[1] );
+
+    const LevelBlob::SectorField number_fields[2] =
+      {LevelBlob::NumberOfMonstersField, LevelBlob::NumberOfObjectsField};
+    const LevelBlob::SectorField offset_fields[2] =
+      {LevelBlob::MonstersOffsetField, LevelBlob::ObjectsOffsetField};
+
+    for( int k = 0; k < 2; ++k )
+    {
+      LevelBlobBaker::setField( blob,
+                                record + number_fields[k],
+                                placements[k].size() );
+      LevelBlobBaker::setField( blob,
+                                record + offset_fields[k],
+                                LevelBlobBaker::align( blob ) );
+
+      for( int i = 0; i < placements[k].size(); ++i )
+      {
+        const quint16 entry[4] = {(quint16)placements[k][i].x,
+                                  (quint16)placements[k][i].y,
+                                  (quint16)placements[k][i].id,
+                                  0};
+
+        LevelBlobBaker::appendShorts( blob, entry, 4 );
+      }
+    }
+  }
+
+  LevelBlobBaker::setField( blob,
+                            LevelBlob::SizeField,
+                            LevelBlobBaker::align( blob ) );
+
+  return blob;
+}
+
+// Write a level blob to a file
+/*! \details The blob is written to a temporary file first so that a partly
+ * written blob is never mapped.
+ */
+bool LevelBlobBaker::write( const QByteArray& blob, const QString& file_name )
+{
+  QDir().mkpath( QFileInfo( file_name ).absolutePath() );
+
+  const QString temp_file_name = file_name + ".tmp";
+
+  {
+    QFile file( temp_file_name );
+
+    if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+      return false;
+
+    if( file.write( blob ) != blob.size() )
+    {
+      file.remove();
+
+      return false;
+    }
+  }
+
+  QFile::remove( file_name );
+
+  return QFile::rename( temp_file_name, file_name );
+}
+
+// Pad the blob to a 4 byte boundary (returns the new size)
+quint32 LevelBlobBaker::align( QByteArray& blob )
+{
+  while( blob.size() % 4 != 0 )
+    blob.append( '\0' );
+
+  return blob.size();
+}
+
+// Set a 32-bit field of the blob
+void LevelBlobBaker::setField( QByteArray& blob,
+                               const int offset,
+                               const quint32 value )
+{
+  qToLittleEndian<quint32>( value, (uchar*)blob.data() + offset );
+}
+
+// Set a 16-bit field of the blob
+void LevelBlobBaker::setShortField( QByteArray& blob,
+                                    const int offset,
+                                    const quint16 value )
+{
+  qToLittleEndian<quint16>( value, (uchar*)blob.data() + offset );
+}
+
+// Append 16-bit values to the blob
+void LevelBlobBaker::appendShorts( QByteArray& blob,
+                                   const quint16* values,
+                                   const int n )
+{
+  const int offset = blob.size();
+
+  blob.resize( offset + 2*n );
+
+  for( int i = 0; i < n; ++i )
+    qToLittleEndian<quint16>( values[i], (uchar*)blob.data() + offset + 2*i );
+}
+
+// Set a file name field of the blob
+void LevelBlobBaker::setFileNameField( QByteArray& blob,
+                                       const int offset,
+                                       const QString& file_name )
+{
+  const QByteArray raw_file_name = file_name.toLatin1();
+
+  memcpy( blob.data() + offset,
+          raw_file_name.constData(),
+          qMin( raw_file_name.size(), LevelBlob::s_max_file_name_length-1 ) );
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end LevelBlobBaker.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelBlobBaker.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level blob baker class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LEVEL_BLOB_BAKER_H
+#define LEVEL_BLOB_BAKER_H
+
+// Qt Includes
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+namespace QtD1{
+
+/*! The level blob baker
+ *
+ * The baker parses the min, til, sol and dun files of a level once and
+ * writes the level blob (see LevelBlob for the format).
+ */
+class LevelBlobBaker
+{
+
+public:
+
+  //! Constructor
+  LevelBlobBaker( const QString& level_min_file_name,
+                  const QString& level_til_file_name,
+                  const QString& level_sol_file_name );
+
+  //! Destructor
+  ~LevelBlobBaker()
+  { /* ... */ }
+
+  //! Add a sector
+  void addSector( const QString& level_dun_file_name );
+
+  //! Calculate the checksum of the level files
+  QByteArray calculateSourceChecksum() const;
+
+  //! Bake the level blob
+  QByteArray bake() const;
+
+  //! Write a level blob to a file
+  static bool write( const QByteArray& blob, const QString& file_name );
+
+private:
+
+  // Pad the blob to a 4 byte boundary (returns the new size)
+  static quint32 align( QByteArray& blob );
+
+  // Set a 32-bit field of the blob
+  static void setField( QByteArray& blob,
+                        const int offset,
+                        const quint32 value );
+
+  // Set a 16-bit field of the blob
+  static void setShortField( QByteArray& blob,
+                             const int offset,
+                             const quint16 value );
+
+  // Append 16-bit values to the blob
+  static void appendShorts( QByteArray& blob,
+                            const quint16* values,
+                            const int n );
+
+  // Set a file name field of the blob
+  static void setFileNameField( QByteArray& blob,
+                                const int offset,
+                                const QString& file_name );
+
+  // The level min file name
+  QString d_level_min_file_name;
+
+  // The level til file name
+  QString d_level_til_file_name;
+
+  // The level sol file name
+  QString d_level_sol_file_name;
+
+  // The level dun file names
+  QStringList d_level_dun_file_names;
+};
+
+} // end QtD1 namespace
+
+#endif // end LEVEL_BLOB_BAKER_H
+
+//---------------------------------------------------------------------------//
+// end LevelBlobBaker.h
+//---------------------------------------------------------------------------//
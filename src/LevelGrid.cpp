@@ -0,0 +1,251 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelGrid.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level grid class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cmath>
+
+// QtD1 Includes
+#include "LevelGrid.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const quint16 LevelGrid::s_no_pillar;
+const quint16 LevelGrid::s_no_object;
+
+// Default constructor
+LevelGrid::LevelGrid()
+  : d_width( 0 ),
+    d_height( 0 ),
+    d_origin(),
+    d_pillar_ids(),
+    d_flags(),
+    d_light(),
+    d_object_ids()
+{ /* ... */ }
+
+// Constructor
+/*! \details All tiles will initially have no pillar and will block walking.
+ */
+LevelGrid::LevelGrid( const int width, const int height )
+  : d_width( width ),
+    d_height( height ),
+    d_origin(),
+    d_pillar_ids( width*height, s_no_pillar ),
+    d_flags( width*height, BlocksWalking ),
+    d_light( width*height, 0 ),
+    d_object_ids( width*height, s_no_object )
+{
+  if( width < 0 || height < 0 )
+  {
+    qFatal( "LevelGrid Error: Invalid grid dimensions (%i,%i)!",
+            width, height );
+  }
+}
+
+// Get the width (number of tile columns)
+int LevelGrid::getWidth() const
+{
+  return d_width;
+}
+
+// Get the height (number of tile rows)
+int LevelGrid::getHeight() const
+{
+  return d_height;
+}
+
+// Get the number of tiles
+int LevelGrid::getNumberOfTiles() const
+{
+  return d_width*d_height;
+}
+
+// Check if the grid has no tiles
+bool LevelGrid::isEmpty() const
+{
+  return d_width*d_height == 0;
+}
+
+// Check if a tile is inside of the grid
+bool LevelGrid::isInside( const int x, const int y ) const
+{
+  return x >= 0 && x < d_width && y >= 0 && y < d_height;
+}
+
+// Get the index of a tile
+int LevelGrid::getIndex( const int x, const int y ) const
+{
+  return y*d_width + x;
+}
+
+// Set the origin (level position of the top corner of tile (0,0))
+void LevelGrid::setOrigin( const QPointF& origin )
+{
+  d_origin = origin;
+}
+
+// Get the origin
+const QPointF& LevelGrid::getOrigin() const
+{
+  return d_origin;
+}
+
+// Map a level position to tile coordinates (x=column, y=row)
+/*! \details The returned tile may be outside of the grid.
+ */
+QPoint LevelGrid::mapToTile( const QPointF& position ) const
+{
+  const qreal u = (position.x() - d_origin.x())/(s_tile_width/2);
+  const qreal v = (position.y() - d_origin.y())/(s_tile_height/2);
+
+  return QPoint( (int)std::floor( (v + u)/2 ), (int)std::floor( (v - u)/2 ) );
+}
+
+// Map tile coordinates to the level position of the tile top corner
+QPointF LevelGrid::mapFromTile( const QPoint& tile ) const
+{
+  return QPointF( d_origin.x() + (tile.x() - tile.y())*(s_tile_width/2),
+                  d_origin.y() + (tile.x() + tile.y())*(s_tile_height/2) );
+}
+
+// Map tile coordinates to the level position of the tile center
+QPointF LevelGrid::mapFromTileCenter( const QPoint& tile ) const
+{
+  return this->mapFromTile( tile ) + QPointF( 0, s_tile_height/2 );
+}
+
+// Set the pillar id of a tile
+void LevelGrid::setPillarId( const int x, const int y, const quint16 pillar_id )
+{
+  d_pillar_ids[this->getIndex( x, y )] = pillar_id;
+}
+
+// Get the pillar id of a tile
+quint16 LevelGrid::getPillarId( const int x, const int y ) const
+{
+  return d_pillar_ids[this->getIndex( x, y )];
+}
+
+// Set the flags of a tile
+void LevelGrid::setFlags( const int x, const int y, const quint8 flags )
+{
+  d_flags[this->getIndex( x, y )] = flags;
+}
+
+// Get the flags of a tile
+quint8 LevelGrid::getFlags( const int x, const int y ) const
+{
+  return d_flags[this->getIndex( x, y )];
+}
+
+// Check if a tile can be walked on
+/*! \details Tiles outside of the grid cannot be walked on.
+ */
+bool LevelGrid::isWalkable( const int x, const int y ) const
+{
+  if( this->isInside( x, y ) )
+    return !(d_flags[this->getIndex( x, y )] & BlocksWalking);
+  else
+    return false;
+}
+
+// Set the light level of a tile
+void LevelGrid::setLight( const int x, const int y, const quint8 light )
+{
+  d_light[this->getIndex( x, y )] = light;
+}
+
+// Get the light level of a tile
+quint8 LevelGrid::getLight( const int x, const int y ) const
+{
+  return d_light[this->getIndex( x, y )];
+}
+
+// Set the object id of a tile
+void LevelGrid::setObjectId( const int x, const int y, const quint16 object_id )
+{
+  d_object_ids[this->getIndex( x, y )] = object_id;
+}
+
+// Get the object id of a tile
+quint16 LevelGrid::getObjectId( const int x, const int y ) const
+{
+  return d_object_ids[this->getIndex( x, y )];
+}
+
+// Copy the tiles of another grid into this grid
+/*! \details Tiles that fall outside of this grid will be ignored. Tiles in
+ * the other grid that have no pillar will not overwrite the tiles in this
+ * grid.
+ */
+void LevelGrid::paste( const LevelGrid& other_grid,
+                       const int x_offset,
+                       const int y_offset )
+{
+  for( int j = 0; j < other_grid.d_height; ++j )
+  {
+    const int y = j + y_offset;
+
+    for( int i = 0; i < other_grid.d_width; ++i )
+    {
+      const int x = i + x_offset;
+
+      if( !this->isInside( x, y ) )
+        continue;
+
+      const int other_index = other_grid.getIndex( i, j );
+
+      if( other_grid.d_pillar_ids[other_index] == s_no_pillar )
+        continue;
+
+      const int index = this->getIndex( x, y );
+
+      d_pillar_ids[index] = other_grid.d_pillar_ids[other_index];
+      d_flags[index] = other_grid.d_flags[other_index];
+      d_light[index] = other_grid.d_light[other_index];
+      d_object_ids[index] = other_grid.d_object_ids[other_index];
+    }
+  }
+}
+
+// Get the raw pillar ids
+const quint16* LevelGrid::getRawPillarIds() const
+{
+  return d_pillar_ids.constData();
+}
+
+// Get the raw flags
+const quint8* LevelGrid::getRawFlags() const
+{
+  return d_flags.constData();
+}
+
+// Get the raw light levels
+const quint8* LevelGrid::getRawLight() const
+{
+  return d_light.constData();
+}
+
+// Get the raw light levels
+quint8* LevelGrid::getRawLight()
+{
+  return d_light.data();
+}
+
+// Get the raw object ids
+const quint16* LevelGrid::getRawObjectIds() const
+{
+  return d_object_ids.constData();
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end LevelGrid.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,173 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelGrid.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level grid class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LEVEL_GRID_H
+#define LEVEL_GRID_H
+
+// Qt Includes
+#include <QVector>
+#include <QPoint>
+#include <QPointF>
+
+namespace QtD1{
+
+/*! The level grid
+ *
+ * The level grid is the logical tile map of a level. Each tile is covered by
+ * a single level pillar (a level square covers 2x2 tiles). Tiles are
+ * isometric diamonds that are 64 pixels wide and 32 pixels high: a step
+ * along the tile column moves (+32,+16) in the level and a step along the
+ * tile row moves (-32,+16). The tile data is stored as a structure of arrays
+ * (row-major) so that pathfinding, lighting and visibility can run over
+ * tightly packed data without walking the scene items.
+ */
+class LevelGrid
+{
+
+public:
+
+  //! The tile flags (matches the sol file flags)
+  enum TileFlag{
+    BlocksWalking = 0x01,
+    BlocksLight = 0x02,
+    BlocksMissiles = 0x04
+  };
+
+  //! The pillar id of tiles that have no pillar
+  static const quint16 s_no_pillar = 0xFFFF;
+
+  //! The object id of tiles that have no object
+  static const quint16 s_no_object = 0;
+
+  //! The tile width (pixels)
+  static const int s_tile_width = 64;
+
+  //! The tile height (pixels)
+  static const int s_tile_height = 32;
+
+  //! Default constructor
+  LevelGrid();
+
+  //! Constructor
+  LevelGrid( const int width, const int height );
+
+  //! Destructor
+  ~LevelGrid()
+  { /* ... */ }
+
+  //! Get the width (number of tile columns)
+  int getWidth() const;
+
+  //! Get the height (number of tile rows)
+  int getHeight() const;
+
+  //! Get the number of tiles
+  int getNumberOfTiles() const;
+
+  //! Check if the grid has no tiles
+  bool isEmpty() const;
+
+  //! Check if a tile is inside of the grid
+  bool isInside( const int x, const int y ) const;
+
+  //! Get the index of a tile
+  int getIndex( const int x, const int y ) const;
+
+  //! Set the origin (level position of the top corner of tile (0,0))
+  void setOrigin( const QPointF& origin );
+
+  //! Get the origin
+  const QPointF& getOrigin() const;
+
+  //! Map a level position to tile coordinates (x=column, y=row)
+  QPoint mapToTile( const QPointF& position ) const;
+
+  //! Map tile coordinates to the level position of the tile top corner
+  QPointF mapFromTile( const QPoint& tile ) const;
+
+  //! Map tile coordinates to the level position of the tile center
+  QPointF mapFromTileCenter( const QPoint& tile ) const;
+
+  //! Set the pillar id of a tile
+  void setPillarId( const int x, const int y, const quint16 pillar_id );
+
+  //! Get the pillar id of a tile
+  quint16 getPillarId( const int x, const int y ) const;
+
+  //! Set the flags of a tile
+  void setFlags( const int x, const int y, const quint8 flags );
+
+  //! Get the flags of a tile
+  quint8 getFlags( const int x, const int y ) const;
+
+  //! Check if a tile can be walked on
+  bool isWalkable( const int x, const int y ) const;
+
+  //! Set the light level of a tile
+  void setLight( const int x, const int y, const quint8 light );
+
+  //! Get the light level of a tile
+  quint8 getLight( const int x, const int y ) const;
+
+  //! Set the object id of a tile
+  void setObjectId( const int x, const int y, const quint16 object_id );
+
+  //! Get the object id of a tile
+  quint16 getObjectId( const int x, const int y ) const;
+
+  //! Copy the tiles of another grid into this grid
+  void paste( const LevelGrid& other_grid,
+              const int x_offset,
+              const int y_offset );
+
+  //! Get the raw pillar ids
+  const quint16* getRawPillarIds() const;
+
+  //! Get the raw flags
+  const quint8* getRawFlags() const;
+
+  //! Get the raw light levels
+  const quint8* getRawLight() const;
+
+  //! Get the raw light levels
+  quint8* getRawLight();
+
+  //! Get the raw object ids
+  const quint16* getRawObjectIds() const;
+
+private:
+
+  // The width
+  int d_width;
+
+  // The height
+  int d_height;
+
+  // The origin
+  QPointF d_origin;
+
+  // The pillar ids
+  QVector<quint16> d_pillar_ids;
+
+  // The flags
+  QVector<quint8> d_flags;
+
+  // The light levels
+  QVector<quint8> d_light;
+
+  // The object ids
+  QVector<quint16> d_object_ids;
+};
+
+} // end QtD1 namespace
+
+#endif // end LEVEL_GRID_H
+
+//---------------------------------------------------------------------------//
+// end LevelGrid.h
+//---------------------------------------------------------------------------//
@@ -72,6 +72,15 @@ public:
   
   //! Dump the image assets
   virtual void dumpImageAssets() = 0;
+
+  //! Check if the object must be advanced every simulation tick
+  virtual bool isAnimated() const
+  { return false; }
+
+signals:
+
+  //! The object started or stopped requiring simulation ticks
+  void animationStateChanged( const bool animated );
 };
   
 } // end QtD1 namespace
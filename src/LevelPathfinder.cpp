@@ -0,0 +1,793 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelPathfinder.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level pathfinder class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cstdlib>
+#include <algorithm>
+
+// QtD1 Includes
+#include "LevelPathfinder.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int LevelPathfinder::s_straight_cost;
+const int LevelPathfinder::s_diagonal_cost;
+
+// Default constructor
+LevelPathfinder::LevelPathfinder()
+  : d_grid(),
+    d_max_expanded_nodes( 0 ),
+    d_number_of_expanded_nodes( 0 ),
+    d_generation( 0 ),
+    d_open_generation(),
+    d_closed_generation(),
+    d_g_cost(),
+    d_f_cost(),
+    d_parent(),
+    d_heap(),
+    d_heap_size( 0 ),
+    d_heap_position(),
+    d_next_request_id( 1 ),
+    d_queued_requests(),
+    d_processed_requests()
+{ /* ... */ }
+
+// Constructor
+LevelPathfinder::LevelPathfinder( const LevelGrid& grid )
+  : d_grid(),
+    d_max_expanded_nodes( 0 ),
+    d_number_of_expanded_nodes( 0 ),
+    d_generation( 0 ),
+    d_open_generation(),
+    d_closed_generation(),
+    d_g_cost(),
+    d_f_cost(),
+    d_parent(),
+    d_heap(),
+    d_heap_size( 0 ),
+    d_heap_position(),
+    d_next_request_id( 1 ),
+    d_queued_requests(),
+    d_processed_requests()
+{
+  this->setGrid( grid );
+}
+
+// Set the grid (the search buffers will be reallocated if necessary)
+/*! \details The max number of expanded nodes will be reset to the number of
+ * tiles in the grid (no limit).
+ */
+void LevelPathfinder::setGrid( const LevelGrid& grid )
+{
+  d_grid = grid;
+
+  const int number_of_tiles = grid.getNumberOfTiles();
+
+  if( d_open_generation.size() != number_of_tiles )
+  {
+    d_open_generation.fill( 0, number_of_tiles );
+    d_closed_generation.fill( 0, number_of_tiles );
+    d_g_cost.resize( number_of_tiles );
+    d_f_cost.resize( number_of_tiles );
+    d_parent.resize( number_of_tiles );
+    d_heap.resize( number_of_tiles );
+    d_heap_position.resize( number_of_tiles );
+
+    d_generation = 0;
+  }
+
+  d_heap_size = 0;
+  d_max_expanded_nodes = number_of_tiles;
+}
+
+// Get the grid
+const LevelGrid& LevelPathfinder::getGrid() const
+{
+  return d_grid;
+}
+
+// Set the max number of nodes that can be expanded in a single search
+/*! \details A search that hits the limit will fail. This can be used to
+ * bound the cost of searches for goals that are unreachable.
+ */
+void LevelPathfinder::setMaxExpandedNodes( const int max_expanded_nodes )
+{
+  d_max_expanded_nodes = max_expanded_nodes;
+}
+
+// Get the max number of nodes that can be expanded in a single search
+int LevelPathfinder::getMaxExpandedNodes() const
+{
+  return d_max_expanded_nodes;
+}
+
+// Find a path between two tiles
+/*! \details The path will contain every tile that must be stepped on to
+ * get from the start tile to the goal tile (the start tile is not included).
+ * If no path can be found, false will be returned and the path will be
+ * empty. The start and goal tiles must both be walkable.
+ */
+bool LevelPathfinder::findPath( const QPoint& start,
+                                const QPoint& goal,
+                                QVector<QPoint>& path,
+                                const Algorithm algorithm )
+{
+  path.clear();
+
+  d_number_of_expanded_nodes = 0;
+
+  if( !this->isWalkable( start.x(), start.y() ) )
+    return false;
+
+  if( !this->isWalkable( goal.x(), goal.y() ) )
+    return false;
+
+  if( start == goal )
+    return true;
+
+  const int start_node = d_grid.getIndex( start.x(), start.y() );
+  const int goal_node = d_grid.getIndex( goal.x(), goal.y() );
+
+  this->startSearch();
+
+  bool found;
+
+  if( algorithm == JumpPointSearch )
+    found = this->runJumpPointSearch( start_node, goal_node );
+  else
+    found = this->runAStar( start_node, goal_node );
+
+  if( found )
+    this->reconstructPath( start_node, goal_node, path );
+
+  return found;
+}
+
+// Get the number of nodes expanded in the last search
+int LevelPathfinder::getNumberOfExpandedNodes() const
+{
+  return d_number_of_expanded_nodes;
+}
+
+// Queue a path request
+/*! \details The returned id can be used to check the status of the request
+ * and to take the path once the request has been processed.
+ */
+int LevelPathfinder::queuePathRequest( const QPoint& start,
+                                       const QPoint& goal,
+                                       const Algorithm algorithm )
+{
+  PathRequest request;
+  request.id = d_next_request_id++;
+  request.start = start;
+  request.goal = goal;
+  request.algorithm = algorithm;
+
+  d_queued_requests << request;
+
+  return request.id;
+}
+
+// Get the number of queued path requests
+int LevelPathfinder::getNumberOfQueuedPathRequests() const
+{
+  return d_queued_requests.size();
+}
+
+// Process the queued path requests (returns the number processed)
+/*! \details Requests are processed in the order that they were queued. If
+ * the max number of requests is negative all queued requests will be
+ * processed.
+ */
+int LevelPathfinder::processPathRequests( const int max_requests )
+{
+  int number_processed = 0;
+
+  while( !d_queued_requests.isEmpty() )
+  {
+    if( max_requests >= 0 && number_processed >= max_requests )
+      break;
+
+    const PathRequest request = d_queued_requests.takeFirst();
+
+    PathResult& result = d_processed_requests[request.id];
+    result.found = this->findPath( request.start,
+                                   request.goal,
+                                   result.path,
+                                   request.algorithm );
+
+    ++number_processed;
+  }
+
+  return number_processed;
+}
+
+// Get the status of a path request
+LevelPathfinder::RequestStatus LevelPathfinder::getPathRequestStatus(
+                                                const int request_id ) const
+{
+  QHash<int,PathResult>::const_iterator result_it =
+    d_processed_requests.find( request_id );
+
+  if( result_it != d_processed_requests.end() )
+    return result_it->found ? PathFound : NoPathFound;
+
+  for( int i = 0; i < d_queued_requests.size(); ++i )
+  {
+    if( d_queued_requests[i].id == request_id )
+      return PendingRequest;
+  }
+
+  return InvalidRequest;
+}
+
+// Take the path of a processed path request (the request will be removed)
+/*! \details If the request has not been processed yet false will be
+ * returned and the request will be left in the queue.
+ */
+bool LevelPathfinder::takePath( const int request_id, QVector<QPoint>& path )
+{
+  QHash<int,PathResult>::iterator result_it =
+    d_processed_requests.find( request_id );
+
+  if( result_it == d_processed_requests.end() )
+  {
+    path.clear();
+
+    return false;
+  }
+
+  const bool found = result_it->found;
+  path = result_it->path;
+
+  d_processed_requests.erase( result_it );
+
+  return found;
+}
+
+// Cancel a path request
+void LevelPathfinder::cancelPathRequest( const int request_id )
+{
+  d_processed_requests.remove( request_id );
+
+  for( int i = 0; i < d_queued_requests.size(); ++i )
+  {
+    if( d_queued_requests[i].id == request_id )
+    {
+      d_queued_requests.removeAt( i );
+      break;
+    }
+  }
+}
+
+// Check if a tile can be walked on
+bool LevelPathfinder::isWalkable( const int x, const int y ) const
+{
+  return d_grid.isWalkable( x, y );
+}
+
+// Get the octile distance between two tiles
+int LevelPathfinder::getDistance( const int x_a, const int y_a,
+                                  const int x_b, const int y_b )
+{
+  const int dx = std::abs( x_a - x_b );
+  const int dy = std::abs( y_a - y_b );
+
+  return s_straight_cost*(dx + dy) +
+    (s_diagonal_cost - 2*s_straight_cost)*std::min( dx, dy );
+}
+
+// Start a new search
+/*! \details Instead of clearing the per-node state the generation is
+ * incremented. The per-node state is only cleared when the generation wraps.
+ */
+void LevelPathfinder::startSearch()
+{
+  ++d_generation;
+
+  if( d_generation == 0 )
+  {
+    d_open_generation.fill( 0 );
+    d_closed_generation.fill( 0 );
+
+    d_generation = 1;
+  }
+
+  d_heap_size = 0;
+}
+
+// Open a node (or update it if a cheaper path to it has been found)
+void LevelPathfinder::openNode( const int node,
+                                const int parent,
+                                const int g_cost,
+                                const int goal_x,
+                                const int goal_y )
+{
+  if( d_open_generation[node] != d_generation )
+  {
+    const int width = d_grid.getWidth();
+
+    d_open_generation[node] = d_generation;
+    d_g_cost[node] = g_cost;
+    d_f_cost[node] = g_cost +
+      this->getDistance( node % width, node / width, goal_x, goal_y );
+    d_parent[node] = parent;
+
+    this->pushHeap( node );
+  }
+  else if( g_cost < d_g_cost[node] )
+  {
+    d_f_cost[node] -= d_g_cost[node] - g_cost;
+    d_g_cost[node] = g_cost;
+    d_parent[node] = parent;
+
+    this->siftUp( d_heap_position[node] );
+  }
+}
+
+// Run the A* search
+bool LevelPathfinder::runAStar( const int start, const int goal )
+{
+  const int width = d_grid.getWidth();
+  const int goal_x = goal % width;
+  const int goal_y = goal / width;
+
+  this->openNode( start, start, 0, goal_x, goal_y );
+
+  while( d_heap_size > 0 )
+  {
+    const int node = this->popHeap();
+
+    if( node == goal )
+      return true;
+
+    d_closed_generation[node] = d_generation;
+
+    if( ++d_number_of_expanded_nodes > d_max_expanded_nodes )
+      return false;
+
+    const int x = node % width;
+    const int y = node / width;
+
+    for( int dy = -1; dy <= 1; ++dy )
+    {
+      for( int dx = -1; dx <= 1; ++dx )
+      {
+        if( dx == 0 && dy == 0 )
+          continue;
+
+        const int neighbor_x = x + dx;
+        const int neighbor_y = y + dy;
+
+        if( !this->isWalkable( neighbor_x, neighbor_y ) )
+          continue;
+
+        int move_cost = s_straight_cost;
+
+        // Diagonal moves cannot cut the corner of a blocked tile
+        if( dx != 0 && dy != 0 )
+        {
+          if( !this->isWalkable( x + dx, y ) || !this->isWalkable( x, y + dy ) )
+            continue;
+
+          move_cost = s_diagonal_cost;
+        }
+
+        const int neighbor = node + dy*width + dx;
+
+        if( d_closed_generation[neighbor] == d_generation )
+          continue;
+
+        this->openNode( neighbor,
+                        node,
+                        d_g_cost[node] + move_cost,
+                        goal_x,
+                        goal_y );
+      }
+    }
+  }
+
+  return false;
+}
+
+// Run the jump point search
+/*! \details The jump point search only expands the nodes where the optimal
+ * path could change direction, which greatly reduces the number of heap
+ * operations in the open areas of a level. The pruning rules are the ones
+ * for movement that cannot cut corners.
+ */
+bool LevelPathfinder::runJumpPointSearch( const int start, const int goal )
+{
+  const int width = d_grid.getWidth();
+  const int goal_x = goal % width;
+  const int goal_y = goal / width;
+
+  this->openNode( start, start, 0, goal_x, goal_y );
+
+  int neighbor_dx[8];
+  int neighbor_dy[8];
+
+  while( d_heap_size > 0 )
+  {
+    const int node = this->popHeap();
+
+    if( node == goal )
+      return true;
+
+    d_closed_generation[node] = d_generation;
+
+    if( ++d_number_of_expanded_nodes > d_max_expanded_nodes )
+      return false;
+
+    const int x = node % width;
+    const int y = node / width;
+
+    // Find the directions that need to be searched
+    int number_of_neighbors = 0;
+
+    if( node == start )
+    {
+      for( int dy = -1; dy <= 1; ++dy )
+      {
+        for( int dx = -1; dx <= 1; ++dx )
+        {
+          if( dx == 0 && dy == 0 )
+            continue;
+
+          if( !this->isWalkable( x + dx, y + dy ) )
+            continue;
+
+          if( dx != 0 && dy != 0 &&
+              (!this->isWalkable( x + dx, y ) || !this->isWalkable( x, y + dy )) )
+            continue;
+
+          neighbor_dx[number_of_neighbors] = dx;
+          neighbor_dy[number_of_neighbors] = dy;
+          ++number_of_neighbors;
+        }
+      }
+    }
+    else
+    {
+      const int parent = d_parent[node];
+      const int dx = (x > parent % width) - (x < parent % width);
+      const int dy = (y > parent / width) - (y < parent / width);
+
+      if( dx != 0 && dy != 0 )
+      {
+        const bool vertical_walkable = this->isWalkable( x, y + dy );
+        const bool horizontal_walkable = this->isWalkable( x + dx, y );
+
+        if( vertical_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = 0;
+          neighbor_dy[number_of_neighbors] = dy;
+          ++number_of_neighbors;
+        }
+
+        if( horizontal_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = dx;
+          neighbor_dy[number_of_neighbors] = 0;
+          ++number_of_neighbors;
+        }
+
+        if( vertical_walkable && horizontal_walkable &&
+            this->isWalkable( x + dx, y + dy ) )
+        {
+          neighbor_dx[number_of_neighbors] = dx;
+          neighbor_dy[number_of_neighbors] = dy;
+          ++number_of_neighbors;
+        }
+      }
+      else if( dx != 0 )
+      {
+        const bool next_walkable = this->isWalkable( x + dx, y );
+        const bool top_walkable = this->isWalkable( x, y + 1 );
+        const bool bottom_walkable = this->isWalkable( x, y - 1 );
+
+        if( next_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = dx;
+          neighbor_dy[number_of_neighbors] = 0;
+          ++number_of_neighbors;
+
+          if( top_walkable && this->isWalkable( x + dx, y + 1 ) )
+          {
+            neighbor_dx[number_of_neighbors] = dx;
+            neighbor_dy[number_of_neighbors] = 1;
+            ++number_of_neighbors;
+          }
+
+          if( bottom_walkable && this->isWalkable( x + dx, y - 1 ) )
+          {
+            neighbor_dx[number_of_neighbors] = dx;
+            neighbor_dy[number_of_neighbors] = -1;
+            ++number_of_neighbors;
+          }
+        }
+
+        if( top_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = 0;
+          neighbor_dy[number_of_neighbors] = 1;
+          ++number_of_neighbors;
+        }
+
+        if( bottom_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = 0;
+          neighbor_dy[number_of_neighbors] = -1;
+          ++number_of_neighbors;
+        }
+      }
+      else
+      {
+        const bool next_walkable = this->isWalkable( x, y + dy );
+        const bool right_walkable = this->isWalkable( x + 1, y );
+        const bool left_walkable = this->isWalkable( x - 1, y );
+
+        if( next_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = 0;
+          neighbor_dy[number_of_neighbors] = dy;
+          ++number_of_neighbors;
+
+          if( right_walkable && this->isWalkable( x + 1, y + dy ) )
+          {
+            neighbor_dx[number_of_neighbors] = 1;
+            neighbor_dy[number_of_neighbors] = dy;
+            ++number_of_neighbors;
+          }
+
+          if( left_walkable && this->isWalkable( x - 1, y + dy ) )
+          {
+            neighbor_dx[number_of_neighbors] = -1;
+            neighbor_dy[number_of_neighbors] = dy;
+            ++number_of_neighbors;
+          }
+        }
+
+        if( right_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = 1;
+          neighbor_dy[number_of_neighbors] = 0;
+          ++number_of_neighbors;
+        }
+
+        if( left_walkable )
+        {
+          neighbor_dx[number_of_neighbors] = -1;
+          neighbor_dy[number_of_neighbors] = 0;
+          ++number_of_neighbors;
+        }
+      }
+    }
+
+    // Jump in each direction and open the jump points
+    for( int i = 0; i < number_of_neighbors; ++i )
+    {
+      const int jump_point = this->jump( x + neighbor_dx[i],
+                                         y + neighbor_dy[i],
+                                         neighbor_dx[i],
+                                         neighbor_dy[i],
+                                         goal );
+
+      if( jump_point < 0 )
+        continue;
+
+      if( d_closed_generation[jump_point] == d_generation )
+        continue;
+
+      const int jump_cost = this->getDistance( x, y,
+                                               jump_point % width,
+                                               jump_point / width );
+
+      this->openNode( jump_point,
+                      node,
+                      d_g_cost[node] + jump_cost,
+                      goal_x,
+                      goal_y );
+    }
+  }
+
+  return false;
+}
+
+// Jump from a tile in a direction (returns the jump point or -1)
+/*! \details A tile is a jump point if it is the goal, if it has a forced
+ * neighbor (a neighbor that can only be reached optimally through it) or,
+ * when moving diagonally, if a straight jump from it finds a jump point.
+ */
+int LevelPathfinder::jump( int x,
+                           int y,
+                           const int dx,
+                           const int dy,
+                           const int goal ) const
+{
+  const int width = d_grid.getWidth();
+
+  while( true )
+  {
+    if( !this->isWalkable( x, y ) )
+      return -1;
+
+    const int node = y*width + x;
+
+    if( node == goal )
+      return node;
+
+    if( dx != 0 && dy != 0 )
+    {
+      if( this->jump( x + dx, y, dx, 0, goal ) >= 0 ||
+          this->jump( x, y + dy, 0, dy, goal ) >= 0 )
+        return node;
+    }
+    else if( dx != 0 )
+    {
+      if( (this->isWalkable( x, y - 1 ) && !this->isWalkable( x - dx, y - 1 )) ||
+          (this->isWalkable( x, y + 1 ) && !this->isWalkable( x - dx, y + 1 )) )
+        return node;
+    }
+    else
+    {
+      if( (this->isWalkable( x - 1, y ) && !this->isWalkable( x - 1, y - dy )) ||
+          (this->isWalkable( x + 1, y ) && !this->isWalkable( x + 1, y - dy )) )
+        return node;
+    }
+
+    // Diagonal moves cannot cut the corner of a blocked tile
+    if( !this->isWalkable( x + dx, y ) || !this->isWalkable( x, y + dy ) )
+      return -1;
+
+    x += dx;
+    y += dy;
+  }
+}
+
+// Reconstruct the path from the goal to the start
+/*! \details Consecutive nodes in the search tree always lie on a straight or
+ * diagonal line (jump points may be several tiles apart) so the tiles
+ * between them are filled in.
+ */
+void LevelPathfinder::reconstructPath( const int start,
+                                       const int goal,
+                                       QVector<QPoint>& path ) const
+{
+  const int width = d_grid.getWidth();
+
+  int node = goal;
+
+  while( node != start )
+  {
+    const int parent = d_parent[node];
+
+    int x = node % width;
+    int y = node / width;
+
+    const int parent_x = parent % width;
+    const int parent_y = parent / width;
+
+    const int dx = (parent_x > x) - (parent_x < x);
+    const int dy = (parent_y > y) - (parent_y < y);
+
+    while( x != parent_x || y != parent_y )
+    {
+      path << QPoint( x, y );
+
+      x += dx;
+      y += dy;
+    }
+
+    node = parent;
+  }
+
+  std::reverse( path.begin(), path.end() );
+}
+
+// Push a node onto the open heap
+void LevelPathfinder::pushHeap( const int node )
+{
+  d_heap[d_heap_size] = node;
+  d_heap_position[node] = d_heap_size;
+
+  this->siftUp( d_heap_size++ );
+}
+
+// Pop the cheapest node from the open heap
+int LevelPathfinder::popHeap()
+{
+  const int node = d_heap[0];
+
+  --d_heap_size;
+
+  if( d_heap_size > 0 )
+  {
+    d_heap[0] = d_heap[d_heap_size];
+    d_heap_position[d_heap[0]] = 0;
+
+    this->siftDown( 0 );
+  }
+
+  return node;
+}
+
+// Move a node up the open heap
+void LevelPathfinder::siftUp( int position )
+{
+  const int node = d_heap[position];
+
+  while( position > 0 )
+  {
+    const int parent_position = (position - 1)/2;
+    const int parent_node = d_heap[parent_position];
+
+    if( !this->isCheaper( node, parent_node ) )
+      break;
+
+    d_heap[position] = parent_node;
+    d_heap_position[parent_node] = position;
+
+    position = parent_position;
+  }
+
+  d_heap[position] = node;
+  d_heap_position[node] = position;
+}
+
+// Move a node down the open heap
+void LevelPathfinder::siftDown( int position )
+{
+  const int node = d_heap[position];
+
+  while( true )
+  {
+    int child_position = 2*position + 1;
+
+    if( child_position >= d_heap_size )
+      break;
+
+    if( child_position + 1 < d_heap_size &&
+        this->isCheaper( d_heap[child_position+1], d_heap[child_position] ) )
+      ++child_position;
+
+    const int child_node = d_heap[child_position];
+
+    if( !this->isCheaper( child_node, node ) )
+      break;
+
+    d_heap[position] = child_node;
+    d_heap_position[child_node] = position;
+
+    position = child_position;
+  }
+
+  d_heap[position] = node;
+  d_heap_position[node] = position;
+}
+
+// Check if a node is cheaper than another node
+/*! \details Ties are broken in favor of the node that is closer to the goal
+ * (larger path cost from the start), which reduces the number of expanded
+ * nodes on open ground.
+ */
+bool LevelPathfinder::isCheaper( const int node_a,
+                                const int node_b ) const
+{
+  if( d_f_cost[node_a] != d_f_cost[node_b] )
+    return d_f_cost[node_a] < d_f_cost[node_b];
+  else
+    return d_g_cost[node_a] > d_g_cost[node_b];
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end LevelPathfinder.cpp
+//---------------------------------------------------------------------------//
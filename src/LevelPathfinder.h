@@ -0,0 +1,225 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelPathfinder.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level pathfinder class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LEVEL_PATHFINDER_H
+#define LEVEL_PATHFINDER_H
+
+// Qt Includes
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QPoint>
+
+// QtD1 Includes
+#include "LevelGrid.h"
+
+namespace QtD1{
+
+/*! The level pathfinder
+ *
+ * Paths are found on the level grid tiles with 8-way movement (diagonal
+ * moves cannot cut the corner of a blocked tile). All search state is
+ * allocated when the grid is set: the open set is a preallocated binary heap
+ * and the visited/closed sets are generation stamps, so a search never
+ * allocates (except for the returned path) and never has to clear the
+ * per-tile state.
+ *
+ * Path requests can be queued and then processed in batches (e.g. once per
+ * simulation tick) so that many actors can request paths without each
+ * request running in the middle of the actor update.
+ */
+class LevelPathfinder
+{
+
+public:
+
+  //! The search algorithms
+  enum Algorithm{
+    AStar = 0,
+    JumpPointSearch
+  };
+
+  //! The path request status
+  enum RequestStatus{
+    InvalidRequest = 0,
+    PendingRequest,
+    PathFound,
+    NoPathFound
+  };
+
+  //! Default constructor
+  LevelPathfinder();
+
+  //! Constructor
+  LevelPathfinder( const LevelGrid& grid );
+
+  //! Destructor
+  ~LevelPathfinder()
+  { /* ... */ }
+
+  //! Set the grid (the search buffers will be reallocated if necessary)
+  void setGrid( const LevelGrid& grid );
+
+  //! Get the grid
+  const LevelGrid& getGrid() const;
+
+  //! Set the max number of nodes that can be expanded in a single search
+  void setMaxExpandedNodes( const int max_expanded_nodes );
+
+  //! Get the max number of nodes that can be expanded in a single search
+  int getMaxExpandedNodes() const;
+
+  //! Find a path between two tiles
+  bool findPath( const QPoint& start,
+                 const QPoint& goal,
+                 QVector<QPoint>& path,
+                 const Algorithm algorithm = AStar );
+
+  //! Get the number of nodes expanded in the last search
+  int getNumberOfExpandedNodes() const;
+
+  //! Queue a path request
+  int queuePathRequest( const QPoint& start,
+                        const QPoint& goal,
+                        const Algorithm algorithm = AStar );
+
+  //! Get the number of queued path requests
+  int getNumberOfQueuedPathRequests() const;
+
+  //! Process the queued path requests (returns the number processed)
+  int processPathRequests( const int max_requests = -1 );
+
+  //! Get the status of a path request
+  RequestStatus getPathRequestStatus( const int request_id ) const;
+
+  //! Take the path of a processed path request (the request will be removed)
+  bool takePath( const int request_id, QVector<QPoint>& path );
+
+  //! Cancel a path request
+  void cancelPathRequest( const int request_id );
+
+private:
+
+  // The path request
+  struct PathRequest
+  {
+    int id;
+    QPoint start;
+    QPoint goal;
+    Algorithm algorithm;
+  };
+
+  // The path request result
+  struct PathResult
+  {
+    bool found;
+    QVector<QPoint> path;
+  };
+
+  // Check if a tile can be walked on
+  bool isWalkable( const int x, const int y ) const;
+
+  // Get the octile distance between two tiles
+  static int getDistance( const int x_a, const int y_a,
+                          const int x_b, const int y_b );
+
+  // Start a new search
+  void startSearch();
+
+  // Open a node (or update it if a cheaper path to it has been found)
+  void openNode( const int node, const int parent, const int g_cost,
+                 const int goal_x, const int goal_y );
+
+  // Run the A* search
+  bool runAStar( const int start, const int goal );
+
+  // Run the jump point search
+  bool runJumpPointSearch( const int start, const int goal );
+
+  // Jump from a tile in a direction (returns the jump point or -1)
+  int jump( int x, int y, const int dx, const int dy, const int goal ) const;
+
+  // Reconstruct the path from the goal to the start
+  void reconstructPath( const int start,
+                        const int goal,
+                        QVector<QPoint>& path ) const;
+
+  // Push a node onto the open heap
+  void pushHeap( const int node );
+
+  // Pop the cheapest node from the open heap
+  int popHeap();
+
+  // Move a node up the open heap
+  void siftUp( int position );
+
+  // Move a node down the open heap
+  void siftDown( int position );
+
+  // Check if a node is cheaper than another node
+  bool isCheaper( const int node_a, const int node_b ) const;
+
+  // The cost of a straight move
+  static const int s_straight_cost = 10;
+
+  // The cost of a diagonal move
+  static const int s_diagonal_cost = 14;
+
+  // The grid
+  LevelGrid d_grid;
+
+  // The max number of expanded nodes
+  int d_max_expanded_nodes;
+
+  // The number of nodes expanded in the last search
+  int d_number_of_expanded_nodes;
+
+  // The current search generation
+  quint32 d_generation;
+
+  // The generation in which each node was opened
+  QVector<quint32> d_open_generation;
+
+  // The generation in which each node was closed
+  QVector<quint32> d_closed_generation;
+
+  // The path cost from the start to each node
+  QVector<int> d_g_cost;
+
+  // The estimated total path cost through each node
+  QVector<int> d_f_cost;
+
+  // The parent of each node
+  QVector<int> d_parent;
+
+  // The open heap
+  QVector<int> d_heap;
+
+  // The number of nodes in the open heap
+  int d_heap_size;
+
+  // The position of each node in the open heap
+  QVector<int> d_heap_position;
+
+  // The next path request id
+  int d_next_request_id;
+
+  // The queued path requests
+  QList<PathRequest> d_queued_requests;
+
+  // The processed path requests
+  QHash<int,PathResult> d_processed_requests;
+};
+
+} // end QtD1 namespace
+
+#endif // end LEVEL_PATHFINDER_H
+
+//---------------------------------------------------------------------------//
+// end LevelPathfinder.h
+//---------------------------------------------------------------------------//
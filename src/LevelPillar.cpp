@@ -16,6 +16,7 @@
 // QtD1 Includes
 #include "LevelPillar.h"
 #include "LevelPillarData.h"
+#include "Telemetry.h"
 
 namespace QtD1{
 
@@ -102,6 +103,15 @@ void LevelPillar::dumpImageAssets()
     d_data->dumpImageAssets();
 }
 
+// Get the pillar data (shared by all clones of the pillar)
+/*! \details The pillar image is stored in the data, so loading or dumping
+ * the image assets of a pillar affects all of its clones.
+ */
+std::shared_ptr<LevelPillarData> LevelPillar::getData() const
+{
+  return d_data;
+}
+
 // Get the bounding rect of the pillar
 QRectF LevelPillar::boundingRect() const
 {
@@ -119,6 +129,9 @@ void LevelPillar::paint( QPainter* painter,
                          const QStyleOptionGraphicsItem*,
                          QWidget* )
 {
+  Telemetry::ScopedTimer
+    paint_timer( Telemetry::LevelPillarPaintTimeHistogram );
+
   // Note: Painting occurs in local coordinates, hence the 0, 0 position.
   painter->drawPixmap( 0, 0, d_data->image() );
 }
@@ -9,6 +9,9 @@
 #ifndef LEVEL_PILLAR_H
 #define LEVEL_PILLAR_H
 
+// Std Lib Includes
+#include <memory>
+
 // Qt Includes
 #include <QVector>
 
@@ -81,6 +84,9 @@ public:
   //! Clone the level pillar
   virtual LevelPillar* clone() const = 0;
 
+  //! Get the pillar data (shared by all clones of the pillar)
+  std::shared_ptr<LevelPillarData> getData() const;
+
 protected:
 
   //! Get the image asset required by this level pillar
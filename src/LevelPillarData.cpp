@@ -89,11 +89,51 @@ void LevelPillarData::loadImageAsset(
   d_pillar_shape.addRegion( d_pillar_image.createHeuristicMask() );
 }
 
+// Render the pillar image (safe to call from any thread)
+/*! \details Only the pillar blocks are read, which never change once they
+ * have been set. The image can therefore be rendered by a worker thread
+ * while the GUI thread uses the pillar (unlike a QPixmap, a QImage can be
+ * painted on outside of the GUI thread). The rendered image must be handed
+ * to loadImage on the GUI thread.
+ */
+QImage LevelPillarData::renderImage(
+                             const QVector<QImage>& image_asset_frames ) const
+{
+  QImage pillar_image( d_pillar_bounding_rect.size().toSize(),
+                       QImage::Format_ARGB32_Premultiplied );
+  pillar_image.fill( 0 );
+
+  QPainter pillar_painter( &pillar_image );
+
+  // Create the left column of the pillar
+  this->createPillarColumn( pillar_painter,
+                            image_asset_frames,
+                            d_pillar_blocks.size()-2 );
+
+  // Create the right column of the pillar
+  this->createPillarColumn( pillar_painter,
+                            image_asset_frames,
+                            d_pillar_blocks.size()-1 );
+
+  return pillar_image;
+}
+
+// Load a rendered pillar image
+void LevelPillarData::loadImage( const QImage& pillar_image )
+{
+  d_pillar_image = QPixmap::fromImage( pillar_image );
+
+  // Get the pillar shape
+  d_pillar_shape = QPainterPath();
+  d_pillar_shape.addRegion( d_pillar_image.createHeuristicMask() );
+}
+
 // Create a pillar column
+template<typename Frame>
 void LevelPillarData::createPillarColumn(
                                     QPainter& pillar_painter,
-                                    const QVector<QPixmap>& image_asset_frames,
-                                    const int start_index )
+                                    const QVector<Frame>& image_asset_frames,
+                                    const int start_index ) const
 {
   // Note: All even indices will form the left column of the pillar starting
   //       from the top. All odd indices will form the right column of the
@@ -138,9 +178,9 @@ void LevelPillarData::createPillarColumn(
       }
 
       // Draw the block
-      pillar_painter.drawPixmap( pillar_painter_viewport,
-                                 image_asset_frames[block.frame_index],
-                                 image_asset_frames[block.frame_index].rect() );
+      LevelPillarData::drawBlockFrame( pillar_painter,
+                                       pillar_painter_viewport,
+                                       image_asset_frames[block.frame_index] );
       first_block = false;
     }
 
@@ -149,6 +189,22 @@ void LevelPillarData::createPillarColumn(
   }
 }
 
+// Draw a pillar block frame
+void LevelPillarData::drawBlockFrame( QPainter& pillar_painter,
+                                      const QRect& viewport,
+                                      const QPixmap& frame )
+{
+  pillar_painter.drawPixmap( viewport, frame, frame.rect() );
+}
+
+// Draw a pillar block frame
+void LevelPillarData::drawBlockFrame( QPainter& pillar_painter,
+                                      const QRect& viewport,
+                                      const QImage& frame )
+{
+  pillar_painter.drawImage( viewport, frame, frame.rect() );
+}
+
 // Dump the image assets
 void LevelPillarData::dumpImageAssets()
 {
@@ -179,6 +235,16 @@ QPixmap LevelPillarData::image() const
 {
   return d_pillar_image;
 }
+
+// Get the memory used by the pillar image (bytes)
+/*! \details The memory is calculated from the pillar size, so it is also
+ * known before the image has been loaded.
+ */
+qint64 LevelPillarData::getImageBytes() const
+{
+  return (qint64)d_pillar_bounding_rect.width()*
+    (qint64)d_pillar_bounding_rect.height()*4;
+}
   
 } // end QtD1 namespace
 
@@ -12,6 +12,7 @@
 // Qt Includes
 #include <QVector>
 #include <QPixmap>
+#include <QImage>
 #include <QPainterPath>
 
 // QtD1 Includes
@@ -44,6 +45,12 @@ public:
   //! Load the image asset
   void loadImageAsset( const QVector<QPixmap>& image_asset_frames );
 
+  //! Render the pillar image (safe to call from any thread)
+  QImage renderImage( const QVector<QImage>& image_asset_frames ) const;
+
+  //! Load a rendered pillar image
+  void loadImage( const QImage& pillar_image );
+
   //! Dump the image assets
   void dumpImageAssets();
 
@@ -59,12 +66,26 @@ public:
   //! Get the level pillar image
   QPixmap image() const;
 
+  //! Get the memory used by the pillar image (bytes)
+  qint64 getImageBytes() const;
+
 private:
 
   // Create a pillar column
+  template<typename Frame>
   void createPillarColumn( QPainter& pillar_painer,
-                           const QVector<QPixmap>& image_asset_frames,
-                           const int start_index );
+                           const QVector<Frame>& image_asset_frames,
+                           const int start_index ) const;
+
+  // Draw a pillar block frame
+  static void drawBlockFrame( QPainter& pillar_painter,
+                              const QRect& viewport,
+                              const QPixmap& frame );
+
+  // Draw a pillar block frame
+  static void drawBlockFrame( QPainter& pillar_painter,
+                              const QRect& viewport,
+                              const QImage& frame );
 
   // The level image blocks
   QVector<LevelPillar::Block> d_pillar_blocks;
@@ -67,19 +67,7 @@ LevelPillarFactory::createLevelPillars() const
 
       stream >> raw_data;
 
-      // Indexing in the min file starts at 1 (shift left to 0)
-      blocks[i].frame_index = (raw_data & 0x0FFF) - 1;
-
-      if( blocks[i].frame_index >= 0 )
-      {
-        blocks[i].transparent = false;
-        blocks[i].type = (raw_data & 0x7000) >> 12;
-      }
-      else
-      {
-        blocks[i].transparent = true;
-        blocks[i].type = -1;
-      }
+      blocks[i] = LevelPillarFactory::decodeBlock( raw_data );
     }
 
     // Create the pillar
@@ -89,6 +77,41 @@ LevelPillarFactory::createLevelPillars() const
   return level_pillars;
 }
 
+// Create a level pillar from its blocks
+std::shared_ptr<LevelPillar> LevelPillarFactory::createLevelPillar(
+                            const QVector<LevelPillar::Block>& blocks ) const
+{
+  return this->getLevelPillarCreationFunction()( blocks );
+}
+
+// Get the number of blocks in each pillar
+int LevelPillarFactory::getNumberOfBlocksPerPillar() const
+{
+  return this->getLevelPillarNumBlocksFunction()();
+}
+
+// Decode a raw min file block
+LevelPillar::Block LevelPillarFactory::decodeBlock( const quint16 raw_data )
+{
+  LevelPillar::Block block;
+
+  // Indexing in the min file starts at 1 (shift left to 0)
+  block.frame_index = (raw_data & 0x0FFF) - 1;
+
+  if( block.frame_index >= 0 )
+  {
+    block.transparent = false;
+    block.type = (raw_data & 0x7000) >> 12;
+  }
+  else
+  {
+    block.transparent = true;
+    block.type = -1;
+  }
+
+  return block;
+}
+
 // Get the number of blocks in a town pillar
 int LevelPillarFactory::getNumberOfBlocksInTownPillar()
 {
@@ -38,6 +38,16 @@ public:
   //! Create the level pillars
   QList<std::shared_ptr<LevelPillar> > createLevelPillars() const;
 
+  //! Create a level pillar from its blocks
+  std::shared_ptr<LevelPillar> createLevelPillar(
+                           const QVector<LevelPillar::Block>& blocks ) const;
+
+  //! Get the number of blocks in each pillar
+  int getNumberOfBlocksPerPillar() const;
+
+  //! Decode a raw min file block
+  static LevelPillar::Block decodeBlock( const quint16 raw_data );
+
 private:
 
   // The level pillar number of blocks function typedef
@@ -0,0 +1,625 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelRegionStreamer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level region streamer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QSet>
+#include <QThread>
+#include <QtConcurrentRun>
+#include <QtConcurrentMap>
+#include <qmath.h>
+
+// QtD1 Includes
+#include "LevelRegionStreamer.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const qint64 LevelRegionStreamer::s_default_memory_budget;
+const int LevelRegionStreamer::s_default_resident_distance;
+const int LevelRegionStreamer::s_default_prefetch_distance;
+
+// Constructor
+LevelRegionStreamer::LevelRegionStreamer( QObject* parent )
+  : QObject( parent ),
+    d_regions(),
+    d_image_asset_frames(),
+    d_memory_budget( s_default_memory_budget ),
+    d_memory_usage( 0 ),
+    d_resident_distance( s_default_resident_distance ),
+    d_prefetch_distance( s_default_prefetch_distance ),
+    d_focus(),
+    d_focus_updates( 0 ),
+    d_queued_regions(),
+    d_max_concurrent_loads( qMax( QThread::idealThreadCount(), 1 ) ),
+    d_region_loads()
+{ /* ... */ }
+
+// Destructor
+/*! \details The region loads cannot be deleted while the pillar images are
+ * being rendered on another thread.
+ */
+LevelRegionStreamer::~LevelRegionStreamer()
+{
+  this->cancelLoads();
+}
+
+// Set the regions (the level sectors must be in the scene)
+/*! \details Each level sector becomes a region. Regions with pillar images
+ * that have already been loaded are resident - all other regions are
+ * hidden until they have been loaded.
+ */
+void LevelRegionStreamer::setRegions(
+                                  const QList<LevelSector*>& level_sectors )
+{
+  this->cancelLoads();
+
+  d_regions.clear();
+  d_queued_regions.clear();
+  d_memory_usage = 0;
+  d_focus_updates = 0;
+
+  QSet<const LevelPillarData*> loaded_pillar_data;
+
+  QList<LevelSector*>::const_iterator level_sector_it, level_sector_end;
+  level_sector_it = level_sectors.begin();
+  level_sector_end = level_sectors.end();
+
+  while( level_sector_it != level_sector_end )
+  {
+    Region region;
+    region.sector = *level_sector_it;
+    region.rect = region.sector->sceneBoundingRect();
+    region.memory = 0;
+    region.state = Resident;
+    region.last_used = 0;
+
+    region.sector->getPillarData( region.pillar_data );
+
+    for( int i = 0; i < region.pillar_data.size(); ++i )
+    {
+      const LevelPillarData* pillar_data = region.pillar_data[i].get();
+
+      region.memory += pillar_data->getImageBytes();
+
+      if( pillar_data->imageAssetsLoaded() )
+      {
+        if( !loaded_pillar_data.contains( pillar_data ) )
+        {
+          loaded_pillar_data.insert( pillar_data );
+
+          d_memory_usage += pillar_data->getImageBytes();
+        }
+      }
+      else
+        region.state = Unloaded;
+    }
+
+    region.sector->setVisible( region.state == Resident );
+
+    d_regions << region;
+
+    ++level_sector_it;
+  }
+}
+
+// Set the level image asset frames
+void LevelRegionStreamer::setImageAssetFrames(
+                                 const QVector<QImage>& image_asset_frames )
+{
+  d_image_asset_frames = image_asset_frames;
+}
+
+// Set the memory budget (bytes)
+/*! \details If the memory used by the pillar images exceeds the new budget
+ * the least recently used regions will be evicted immediately.
+ */
+void LevelRegionStreamer::setMemoryBudget( const qint64 memory_budget )
+{
+  d_memory_budget = memory_budget;
+
+  this->evictLeastRecentlyUsedRegions( 0 );
+}
+
+// Get the memory budget (bytes)
+qint64 LevelRegionStreamer::getMemoryBudget() const
+{
+  return d_memory_budget;
+}
+
+// Set the resident and prefetch distances (pixels)
+void LevelRegionStreamer::setDistances( const qreal resident_distance,
+                                        const qreal prefetch_distance )
+{
+  if( resident_distance < 0.0 || prefetch_distance < resident_distance )
+  {
+    qFatal( "LevelRegionStreamer Error: Invalid distances (resident=%f, "
+            "prefetch=%f)!", resident_distance, prefetch_distance );
+  }
+
+  d_resident_distance = resident_distance;
+  d_prefetch_distance = prefetch_distance;
+}
+
+// Get the resident distance (pixels)
+qreal LevelRegionStreamer::getResidentDistance() const
+{
+  return d_resident_distance;
+}
+
+// Get the prefetch distance (pixels)
+qreal LevelRegionStreamer::getPrefetchDistance() const
+{
+  return d_prefetch_distance;
+}
+
+// Get the memory used by the pillar images (bytes)
+qint64 LevelRegionStreamer::getMemoryUsage() const
+{
+  return d_memory_usage;
+}
+
+// Get the number of regions
+int LevelRegionStreamer::getNumberOfRegions() const
+{
+  return d_regions.size();
+}
+
+// Get the state of a region
+LevelRegionStreamer::RegionState LevelRegionStreamer::getRegionState(
+                                                      const int region ) const
+{
+  return d_regions[region].state;
+}
+
+// Get the number of regions waiting to be loaded
+int LevelRegionStreamer::getNumberOfQueuedRegions() const
+{
+  return d_queued_regions.size();
+}
+
+// Check if regions are being loaded
+bool LevelRegionStreamer::isStreaming() const
+{
+  return !d_region_loads.empty();
+}
+
+// Load the regions around a position synchronously
+/*! \details The regions within the resident distance of the position will
+ * be loaded before this returns (the pillar images are rendered by all
+ * worker threads). The regions within the prefetch distance will then be
+ * streamed in the background.
+ */
+void LevelRegionStreamer::loadRegionsSync( const QPointF& position )
+{
+  if( d_image_asset_frames.empty() )
+  {
+    qWarning( "LevelRegionStreamer Warning: The regions cannot be loaded "
+              "without the level image asset frames!" );
+    return;
+  }
+
+  // Finish the regions that are already being loaded
+  this->waitForLoadsToFinish();
+
+  QList<int> required_regions;
+  QList<PillarRender> renders;
+  QSet<const LevelPillarData*> rendered_pillar_data;
+
+  for( int i = 0; i < d_regions.size(); ++i )
+  {
+    if( d_regions[i].state == Unloaded &&
+        this->getDistance( i, position ) <= d_resident_distance )
+    {
+      required_regions << i;
+
+      const QList<std::shared_ptr<LevelPillarData> >& pillar_data =
+        d_regions[i].pillar_data;
+
+      for( int j = 0; j < pillar_data.size(); ++j )
+      {
+        if( !pillar_data[j]->imageAssetsLoaded() &&
+            !rendered_pillar_data.contains( pillar_data[j].get() ) )
+        {
+          rendered_pillar_data.insert( pillar_data[j].get() );
+
+          PillarRender render;
+          render.pillar_data = pillar_data[j];
+          render.image_asset_frames = &d_image_asset_frames;
+
+          renders << render;
+        }
+      }
+    }
+  }
+
+  QtConcurrent::blockingMap( renders, LevelRegionStreamer::renderPillar );
+
+  for( int i = 0; i < renders.size(); ++i )
+  {
+    renders[i].pillar_data->loadImage( renders[i].image );
+
+    d_memory_usage += renders[i].pillar_data->getImageBytes();
+  }
+
+  for( int i = 0; i < required_regions.size(); ++i )
+  {
+    d_regions[required_regions[i]].state = Resident;
+    d_regions[required_regions[i]].sector->setVisible( true );
+
+    emit regionLoaded( required_regions[i] );
+  }
+
+  this->updateFocus( position );
+}
+
+// Evict all regions
+/*! \details Loads that are in progress will be discarded.
+ */
+void LevelRegionStreamer::evictRegions()
+{
+  this->cancelLoads();
+
+  d_queued_regions.clear();
+
+  for( int i = 0; i < d_regions.size(); ++i )
+  {
+    for( int j = 0; j < d_regions[i].pillar_data.size(); ++j )
+    {
+      if( d_regions[i].pillar_data[j]->imageAssetsLoaded() )
+        d_regions[i].pillar_data[j]->dumpImageAssets();
+    }
+
+    d_regions[i].state = Unloaded;
+    d_regions[i].last_used = 0;
+    d_regions[i].sector->setVisible( false );
+  }
+
+  d_memory_usage = 0;
+  d_focus_updates = 0;
+}
+
+// Set the focus (streams the regions around the focus)
+/*! \details This is cheap to call every simulation tick - nothing is done
+ * unless the focus has moved.
+ */
+void LevelRegionStreamer::setFocus( const QPointF& position )
+{
+  if( d_focus_updates > 0 && position == d_focus )
+    return;
+
+  this->updateFocus( position );
+}
+
+// Update the focus
+/*! \details The regions within the prefetch distance are marked as used and
+ * the unloaded ones are queued (closest first).
+ */
+void LevelRegionStreamer::updateFocus( const QPointF& position )
+{
+  d_focus = position;
+  ++d_focus_updates;
+
+  QMap<qreal,int> queued_regions;
+
+  for( int i = 0; i < d_regions.size(); ++i )
+  {
+    const qreal distance = this->getDistance( i, position );
+
+    if( distance <= d_prefetch_distance )
+    {
+      d_regions[i].last_used = d_focus_updates;
+
+      if( d_regions[i].state == Unloaded )
+        queued_regions.insertMulti( distance, i );
+    }
+  }
+
+  d_queued_regions = queued_regions.values();
+
+  if( !d_image_asset_frames.empty() )
+    this->startNextLoads();
+
+  this->evictLeastRecentlyUsedRegions( 0 );
+}
+
+// Handle region loading finished
+void LevelRegionStreamer::handleRegionLoadingFinished()
+{
+  QFutureWatcher<void>* watcher =
+    static_cast<QFutureWatcher<void>*>( this->sender() );
+
+  RegionLoad* load = d_region_loads.take( watcher );
+
+  // The watcher sent the signal that called this slot - delete it later
+  watcher->deleteLater();
+
+  if( !load )
+    return;
+
+  this->finishRegionLoad( load );
+
+  delete load;
+
+  this->evictLeastRecentlyUsedRegions( 0 );
+  this->startNextLoads();
+}
+
+// Create a region load
+/*! \details Only the pillars that have not been loaded (e.g. by a
+ * neighbouring region) will be rendered.
+ */
+LevelRegionStreamer::RegionLoad* LevelRegionStreamer::createRegionLoad(
+                                                      const int region ) const
+{
+  RegionLoad* load = new RegionLoad;
+  load->region = region;
+  load->image_asset_frames = d_image_asset_frames;
+  load->memory = 0;
+
+  const QList<std::shared_ptr<LevelPillarData> >& pillar_data =
+    d_regions[region].pillar_data;
+
+  for( int i = 0; i < pillar_data.size(); ++i )
+  {
+    if( !pillar_data[i]->imageAssetsLoaded() )
+    {
+      PillarRender render;
+      render.pillar_data = pillar_data[i];
+      render.image_asset_frames = &load->image_asset_frames;
+
+      load->renders << render;
+      load->memory += pillar_data[i]->getImageBytes();
+    }
+  }
+
+  return load;
+}
+
+// Render the pillar images of a region (run in a worker thread)
+void LevelRegionStreamer::renderRegion( RegionLoad* load )
+{
+  QList<PillarRender>::iterator render_it, render_end;
+  render_it = load->renders.begin();
+  render_end = load->renders.end();
+
+  while( render_it != render_end )
+  {
+    LevelRegionStreamer::renderPillar( *render_it );
+
+    ++render_it;
+  }
+}
+
+// Render a pillar image
+void LevelRegionStreamer::renderPillar( PillarRender& render )
+{
+  render.image =
+    render.pillar_data->renderImage( *render.image_asset_frames );
+}
+
+// Finish a region load
+/*! \details A pillar that is shared with another region may have been
+ * loaded while the region was being loaded - it will not be loaded again.
+ */
+void LevelRegionStreamer::finishRegionLoad( RegionLoad* load )
+{
+  QList<PillarRender>::const_iterator render_it, render_end;
+  render_it = load->renders.begin();
+  render_end = load->renders.end();
+
+  while( render_it != render_end )
+  {
+    if( !render_it->pillar_data->imageAssetsLoaded() )
+    {
+      render_it->pillar_data->loadImage( render_it->image );
+
+      d_memory_usage += render_it->pillar_data->getImageBytes();
+    }
+
+    ++render_it;
+  }
+
+  Region& region = d_regions[load->region];
+  region.state = Resident;
+  region.sector->setVisible( true );
+
+  emit regionLoaded( load->region );
+}
+
+// Get the distance between a position and a region
+qreal LevelRegionStreamer::getDistance( const int region,
+                                        const QPointF& position ) const
+{
+  const QRectF& rect = d_regions[region].rect;
+
+  const qreal dx = qMax( qMax( rect.left() - position.x(),
+                               position.x() - rect.right() ),
+                         (qreal)0.0 );
+  const qreal dy = qMax( qMax( rect.top() - position.y(),
+                               position.y() - rect.bottom() ),
+                         (qreal)0.0 );
+
+  return qSqrt( dx*dx + dy*dy );
+}
+
+// Start loading the next queued regions
+/*! \details The regions within the resident distance are always loaded.
+ * The other regions are only prefetched if there is room for them in the
+ * memory budget (regions that are still in use will not be evicted to make
+ * room). Since the queue is sorted by distance, prefetching stops at the
+ * first region that does not fit.
+ */
+void LevelRegionStreamer::startNextLoads()
+{
+  while( d_region_loads.size() < d_max_concurrent_loads &&
+         !d_queued_regions.empty() )
+  {
+    const int region = d_queued_regions.takeFirst();
+
+    if( d_regions[region].state != Unloaded )
+      continue;
+
+    RegionLoad* load = this->createRegionLoad( region );
+
+    if( this->getDistance( region, d_focus ) > d_resident_distance &&
+        !this->evictLeastRecentlyUsedRegions( load->memory ) )
+    {
+      delete load;
+
+      d_queued_regions.clear();
+
+      break;
+    }
+
+    d_regions[region].state = Loading;
+
+    // All pillars may have been loaded by the neighbouring regions
+    if( load->renders.empty() )
+    {
+      this->finishRegionLoad( load );
+
+      delete load;
+
+      continue;
+    }
+
+    QFutureWatcher<void>* watcher = new QFutureWatcher<void>( this );
+
+    QObject::connect( watcher, SIGNAL(finished()),
+                      this, SLOT(handleRegionLoadingFinished()) );
+
+    d_region_loads.insert( watcher, load );
+
+    watcher->setFuture(
+                QtConcurrent::run( LevelRegionStreamer::renderRegion, load ) );
+  }
+}
+
+// Evict the least recently used regions until the memory is available
+/*! \details Only the resident regions that were outside of the prefetch
+ * distance at the last focus update can be evicted. If not enough memory
+ * can be freed false will be returned.
+ */
+bool LevelRegionStreamer::evictLeastRecentlyUsedRegions(
+                                                  const qint64 memory_needed )
+{
+  while( d_memory_usage + memory_needed > d_memory_budget )
+  {
+    int lru_region = -1;
+
+    for( int i = 0; i < d_regions.size(); ++i )
+    {
+      if( d_regions[i].state == Resident &&
+          d_regions[i].last_used < d_focus_updates )
+      {
+        if( lru_region < 0 ||
+            d_regions[i].last_used < d_regions[lru_region].last_used )
+          lru_region = i;
+      }
+    }
+
+    if( lru_region < 0 )
+      return false;
+
+    this->evictRegion( lru_region );
+  }
+
+  return true;
+}
+
+// Evict a region
+/*! \details The pillars that are shared with a region that is resident or
+ * being loaded are kept.
+ */
+void LevelRegionStreamer::evictRegion( const int region )
+{
+  QSet<const LevelPillarData*> retained_pillar_data;
+
+  for( int i = 0; i < d_regions.size(); ++i )
+  {
+    if( i != region && d_regions[i].state != Unloaded )
+    {
+      for( int j = 0; j < d_regions[i].pillar_data.size(); ++j )
+        retained_pillar_data.insert( d_regions[i].pillar_data[j].get() );
+    }
+  }
+
+  QList<std::shared_ptr<LevelPillarData> >::const_iterator pillar_data_it,
+    pillar_data_end;
+  pillar_data_it = d_regions[region].pillar_data.begin();
+  pillar_data_end = d_regions[region].pillar_data.end();
+
+  while( pillar_data_it != pillar_data_end )
+  {
+    if( (*pillar_data_it)->imageAssetsLoaded() &&
+        !retained_pillar_data.contains( pillar_data_it->get() ) )
+    {
+      (*pillar_data_it)->dumpImageAssets();
+
+      d_memory_usage -= (*pillar_data_it)->getImageBytes();
+    }
+
+    ++pillar_data_it;
+  }
+
+  d_regions[region].state = Unloaded;
+  d_regions[region].sector->setVisible( false );
+}
+
+// Wait for the region loads to finish
+void LevelRegionStreamer::waitForLoadsToFinish()
+{
+  QMap<QFutureWatcher<void>*,RegionLoad*>::iterator load_it, load_end;
+  load_it = d_region_loads.begin();
+  load_end = d_region_loads.end();
+
+  while( load_it != load_end )
+  {
+    load_it.key()->waitForFinished();
+
+    this->finishRegionLoad( load_it.value() );
+
+    delete load_it.key();
+    delete load_it.value();
+
+    ++load_it;
+  }
+
+  d_region_loads.clear();
+}
+
+// Cancel the region loads
+/*! \details The rendered pillar images will be discarded.
+ */
+void LevelRegionStreamer::cancelLoads()
+{
+  QMap<QFutureWatcher<void>*,RegionLoad*>::iterator load_it, load_end;
+  load_it = d_region_loads.begin();
+  load_end = d_region_loads.end();
+
+  while( load_it != load_end )
+  {
+    load_it.key()->waitForFinished();
+
+    if( load_it.value()->region < d_regions.size() )
+      d_regions[load_it.value()->region].state = Unloaded;
+
+    delete load_it.key();
+    delete load_it.value();
+
+    ++load_it;
+  }
+
+  d_region_loads.clear();
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end LevelRegionStreamer.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,247 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelRegionStreamer.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level region streamer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LEVEL_REGION_STREAMER_H
+#define LEVEL_REGION_STREAMER_H
+
+// Std Lib Includes
+#include <memory>
+
+// Qt Includes
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QMap>
+#include <QImage>
+#include <QPointF>
+#include <QRectF>
+#include <QFutureWatcher>
+
+// QtD1 Includes
+#include "LevelSector.h"
+#include "LevelPillarData.h"
+
+namespace QtD1{
+
+/*! The level region streamer
+ *
+ * The level background is streamed in by region (a region is a level
+ * sector) instead of being loaded all at once. The regions within the
+ * resident distance of the focus (the character) are loaded first - the
+ * level is playable as soon as they are resident. The regions within the
+ * prefetch distance are then loaded by worker threads in order of their
+ * distance from the focus. A region is loaded by rendering the images of
+ * its pillars from the level image asset frames (the frames are decoded
+ * once by the level image asset loader and shared by all regions).
+ *
+ * The memory used by the pillar images is tracked. When the memory budget
+ * is exceeded the least recently used regions outside of the prefetch
+ * distance are evicted (their pillar images are dumped). Pillars that are
+ * shared with a region that is still in use are kept. Regions that are not
+ * resident are hidden.
+ */
+class LevelRegionStreamer : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  //! The region states
+  enum RegionState{
+    Unloaded = 0,
+    Loading,
+    Resident
+  };
+
+  //! The default memory budget (bytes)
+  static const qint64 s_default_memory_budget = 96*1024*1024;
+
+  //! The default resident distance (pixels)
+  static const int s_default_resident_distance = 640;
+
+  //! The default prefetch distance (pixels)
+  static const int s_default_prefetch_distance = 1600;
+
+  //! Constructor
+  LevelRegionStreamer( QObject* parent = 0 );
+
+  //! Destructor
+  ~LevelRegionStreamer();
+
+  //! Set the regions (the level sectors must be in the scene)
+  void setRegions( const QList<LevelSector*>& level_sectors );
+
+  //! Set the level image asset frames
+  void setImageAssetFrames( const QVector<QImage>& image_asset_frames );
+
+  //! Set the memory budget (bytes)
+  void setMemoryBudget( const qint64 memory_budget );
+
+  //! Get the memory budget (bytes)
+  qint64 getMemoryBudget() const;
+
+  //! Set the resident and prefetch distances (pixels)
+  void setDistances( const qreal resident_distance,
+                     const qreal prefetch_distance );
+
+  //! Get the resident distance (pixels)
+  qreal getResidentDistance() const;
+
+  //! Get the prefetch distance (pixels)
+  qreal getPrefetchDistance() const;
+
+  //! Get the memory used by the pillar images (bytes)
+  qint64 getMemoryUsage() const;
+
+  //! Get the number of regions
+  int getNumberOfRegions() const;
+
+  //! Get the state of a region
+  RegionState getRegionState( const int region ) const;
+
+  //! Get the number of regions waiting to be loaded
+  int getNumberOfQueuedRegions() const;
+
+  //! Check if regions are being loaded
+  bool isStreaming() const;
+
+  //! Load the regions around a position synchronously
+  void loadRegionsSync( const QPointF& position );
+
+  //! Evict all regions
+  void evictRegions();
+
+signals:
+
+  //! A region has been loaded
+  void regionLoaded( const int region );
+
+public slots:
+
+  //! Set the focus (streams the regions around the focus)
+  void setFocus( const QPointF& position );
+
+private slots:
+
+  // Handle region loading finished
+  void handleRegionLoadingFinished();
+
+private:
+
+  // A level region
+  struct Region{
+    // The sector
+    LevelSector* sector;
+    // The scene rect
+    QRectF rect;
+    // The unique pillar data
+    QList<std::shared_ptr<LevelPillarData> > pillar_data;
+    // The memory used by the pillar images when resident (bytes)
+    qint64 memory;
+    // The state
+    RegionState state;
+    // The focus update when the region was last in use
+    quint64 last_used;
+  };
+
+  // A pillar image render
+  struct PillarRender{
+    // The pillar data
+    std::shared_ptr<LevelPillarData> pillar_data;
+    // The level image asset frames
+    const QVector<QImage>* image_asset_frames;
+    // The rendered pillar image
+    QImage image;
+  };
+
+  // A region load
+  struct RegionLoad{
+    // The region
+    int region;
+    // The level image asset frames
+    QVector<QImage> image_asset_frames;
+    // The pillar image renders
+    QList<PillarRender> renders;
+    // The memory used by the rendered pillar images (bytes)
+    qint64 memory;
+  };
+
+  // Update the focus
+  void updateFocus( const QPointF& position );
+
+  // Create a region load
+  RegionLoad* createRegionLoad( const int region ) const;
+
+  // Render the pillar images of a region (run in a worker thread)
+  static void renderRegion( RegionLoad* load );
+
+  // Render a pillar image
+  static void renderPillar( PillarRender& render );
+
+  // Finish a region load
+  void finishRegionLoad( RegionLoad* load );
+
+  // Get the distance between a position and a region
+  qreal getDistance( const int region, const QPointF& position ) const;
+
+  // Start loading the next queued regions
+  void startNextLoads();
+
+  // Evict the least recently used regions until the memory is available
+  bool evictLeastRecentlyUsedRegions( const qint64 memory_needed );
+
+  // Evict a region
+  void evictRegion( const int region );
+
+  // Wait for the region loads to finish
+  void waitForLoadsToFinish();
+
+  // Cancel the region loads
+  void cancelLoads();
+
+  // The regions
+  QVector<Region> d_regions;
+
+  // The level image asset frames
+  QVector<QImage> d_image_asset_frames;
+
+  // The memory budget
+  qint64 d_memory_budget;
+
+  // The memory used by the pillar images
+  qint64 d_memory_usage;
+
+  // The resident distance
+  qreal d_resident_distance;
+
+  // The prefetch distance
+  qreal d_prefetch_distance;
+
+  // The focus
+  QPointF d_focus;
+
+  // The number of focus updates
+  quint64 d_focus_updates;
+
+  // The regions waiting to be loaded (closest first)
+  QList<int> d_queued_regions;
+
+  // The max number of regions that are loaded at the same time
+  int d_max_concurrent_loads;
+
+  // The region loads
+  QMap<QFutureWatcher<void>*,RegionLoad*> d_region_loads;
+};
+
+} // end QtD1 namespace
+
+#endif // end LEVEL_REGION_STREAMER_H
+
+//---------------------------------------------------------------------------//
+// end LevelRegionStreamer.h
+//---------------------------------------------------------------------------//
@@ -96,6 +96,50 @@ LevelSector::LevelSector( QVector<QVector<LevelSquare*> > level_squares )
   this->setFlag( QGraphicsItem::ItemHasNoContents, true );
 }
 
+// Constructor (squares positioned and sorted in z-order)
+/*! \details The squares must already be positioned w.r.t. the sector
+ * coordinate system and sorted by their y position (e.g. by a baked level
+ * - see LevelBlob), so no z-order has to be calculated.
+ */
+LevelSector::LevelSector( const int num_rows,
+                          const int num_cols,
+                          const QList<LevelSquare*>& z_ordered_level_squares )
+  : d_level_square_z_order_map(),
+    d_bounding_rect()
+{
+  if( z_ordered_level_squares.empty() )
+    qFatal( "LevelSector Error: There are no squares in the sector!" );
+
+  // Calculate the sector dimensions
+  int sector_width = (num_cols+num_rows)*64;
+  int sector_height = (num_cols+num_cols)*32 +
+    (z_ordered_level_squares.front()->boundingRect().height() - 64);
+
+  d_bounding_rect = QRectF( 0, 0, sector_width, sector_height );
+
+  // Assign the level squares to this in order of the z-order
+  QList<LevelSquare*>::const_iterator level_squares_it, level_squares_end;
+  level_squares_it = z_ordered_level_squares.begin();
+  level_squares_end = z_ordered_level_squares.end();
+
+  while( level_squares_it != level_squares_end )
+  {
+    QPointF position = (*level_squares_it)->pos();
+
+    d_level_square_z_order_map[(int)position.y()] << *level_squares_it;
+
+    (*level_squares_it)->setParentItem( this );
+
+    // Set the position again so that it is w.r.t. the sector coordinate sys.
+    (*level_squares_it)->setPos( position );
+
+    ++level_squares_it;
+  }
+
+  // There is nothing to draw (all drawing is done by the pillars)
+  this->setFlag( QGraphicsItem::ItemHasNoContents, true );
+}
+
 // Get the number of image assets used by the object
 int LevelSector::getNumberOfImageAssets() const
 {
@@ -184,6 +228,50 @@ void LevelSector::dumpImageAssets()
   }
 }
 
+// Get the unique pillar data of the squares
+/*! \details Squares that share a pillar (e.g. the same square used in
+ * several places) will share the pillar data, which will only be added once.
+ */
+void LevelSector::getPillarData(
+               QList<std::shared_ptr<LevelPillarData> >& pillar_data ) const
+{
+  QSet<const LevelPillarData*> added_pillar_data;
+
+  QList<std::shared_ptr<LevelPillarData> > square_pillar_data;
+
+  QMap<int,QList<LevelSquare*> >::const_iterator z_order_it, z_order_end;
+  z_order_it = d_level_square_z_order_map.begin();
+  z_order_end = d_level_square_z_order_map.end();
+
+  while( z_order_it != z_order_end )
+  {
+    QList<LevelSquare*>::const_iterator level_square_it, level_square_end;
+    level_square_it = z_order_it.value().begin();
+    level_square_end = z_order_it.value().end();
+
+    while( level_square_it != level_square_end )
+    {
+      square_pillar_data.clear();
+
+      (*level_square_it)->getPillarData( square_pillar_data );
+
+      for( int i = 0; i < square_pillar_data.size(); ++i )
+      {
+        if( !added_pillar_data.contains( square_pillar_data[i].get() ) )
+        {
+          added_pillar_data.insert( square_pillar_data[i].get() );
+
+          pillar_data << square_pillar_data[i];
+        }
+      }
+
+      ++level_square_it;
+    }
+
+    ++z_order_it;
+  }
+}
+
 // Get the bounding rect of the level square
 QRectF LevelSector::boundingRect() const
 {
@@ -27,6 +27,11 @@ public:
   //! Constructor
   LevelSector( QVector<QVector<LevelSquare*> > level_squares );
 
+  //! Constructor (squares positioned and sorted in z-order)
+  LevelSector( const int num_rows,
+               const int num_cols,
+               const QList<LevelSquare*>& z_ordered_level_squares );
+
   //! Destructor
   ~LevelSector()
   { /* ... */ }
@@ -50,6 +55,10 @@ public:
   //! Dump the image assets
   void dumpImageAssets() override;
 
+  //! Get the unique pillar data of the squares
+  void getPillarData(
+              QList<std::shared_ptr<LevelPillarData> >& pillar_data ) const;
+
   //! Get the bounding rect of the level square
   QRectF boundingRect() const override;
 
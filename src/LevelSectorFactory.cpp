@@ -69,6 +69,132 @@ LevelSector* LevelSectorFactory::createLevelSector() const
 // Create the level sector (advanced)
 LevelSector* LevelSectorFactory::createLevelSector(
                     const QList<std::shared_ptr<LevelSquare> >& squares ) const
+{
+  // Read the square indices from the dun file
+  int num_rows, num_cols;
+  QVector<quint16> square_indices;
+
+  this->readSquareIndices( num_rows, num_cols, square_indices );
+
+  // Initialize the square rows and columns
+  QVector<QVector<LevelSquare*> > ordered_squares( num_rows );
+
+  for( int j = 0; j < num_rows; ++j )
+  {
+    ordered_squares[j].resize( num_cols );
+
+    for( int i = 0; i < num_cols; ++i )
+    {
+      // Get the square index
+      quint16 square_index = square_indices[j*num_cols + i];
+
+      if( square_index > 0 )
+        ordered_squares[j][i] = squares[square_index-1]->clone();
+    }
+  }
+
+  // Note: the monster and object placements are read separately (see
+  //       readPlacements)
+
+  return new LevelSector( ordered_squares );
+}
+
+// Create the level sector grid
+/*! \details Each square in the dun file covers 2x2 tiles of the grid (top,
+ * right, left and bottom pillars of the square). The tile flags will be set
+ * from the sol file if one is provided (otherwise all tiles with a pillar
+ * will be walkable).
+ */
+LevelGrid LevelSectorFactory::createLevelGrid(
+                               const QString& level_sol_file_name ) const
+{
+  // Read the square pillar indices from the til file
+  QVector<quint16> pillar_indices;
+
+  LevelSectorFactory::readSquarePillarIndices( d_level_til_file_name,
+                                               pillar_indices );
+
+  // Read the pillar flags from the sol file
+  QByteArray pillar_flags;
+
+  if( !level_sol_file_name.isEmpty() )
+  {
+    LevelSectorFactory::readPillarFlags( level_sol_file_name,
+                                         pillar_flags );
+  }
+
+  return this->createLevelGrid( pillar_indices, pillar_flags );
+}
+
+// Create the level sector grid (advanced)
+/*! \details The til and sol tables are usually shared by all sectors of a
+ * level so they only need to be read once. The tiles without pillar flags
+ * will be walkable.
+ */
+LevelGrid LevelSectorFactory::createLevelGrid(
+                                 const QVector<quint16>& pillar_indices,
+                                 const QByteArray& pillar_flags ) const
+{
+  // Read the square indices from the dun file
+  int num_rows, num_cols;
+  QVector<quint16> square_indices;
+
+  this->readSquareIndices( num_rows, num_cols, square_indices );
+
+  // Fill the grid
+  LevelGrid grid( 2*num_cols, 2*num_rows );
+
+  const int number_of_squares = pillar_indices.size()/4;
+
+  for( int j = 0; j < num_rows; ++j )
+  {
+    for( int i = 0; i < num_cols; ++i )
+    {
+      quint16 square_index = square_indices[j*num_cols + i];
+
+      if( square_index == 0 )
+        continue;
+
+      if( square_index > number_of_squares )
+      {
+        qFatal( "LevelSectorFactory Error: Invalid square index %i in dun "
+                "file %s (row=%i,col=%i)!",
+                square_index, d_level_dun_file_name.toStdString().c_str(),
+                j, i );
+      }
+
+      // Top, right, left, bottom
+      const int tile_x[4] = {2*i, 2*i+1, 2*i, 2*i+1};
+      const int tile_y[4] = {2*j, 2*j, 2*j+1, 2*j+1};
+
+      for( int k = 0; k < 4; ++k )
+      {
+        quint16 pillar_index = pillar_indices[(square_index-1)*4 + k];
+
+        grid.setPillarId( tile_x[k], tile_y[k], pillar_index );
+
+        if( pillar_index < pillar_flags.size() )
+        {
+          grid.setFlags( tile_x[k], tile_y[k],
+                         (quint8)pillar_flags[pillar_index] &
+                         (LevelGrid::BlocksWalking |
+                          LevelGrid::BlocksLight |
+                          LevelGrid::BlocksMissiles) );
+        }
+        else
+          grid.setFlags( tile_x[k], tile_y[k], 0 );
+      }
+    }
+  }
+
+  return grid;
+}
+
+// Read the square indices from the dun file (row-major, 0 = no square)
+void LevelSectorFactory::readSquareIndices(
+                                   int& num_rows,
+                                   int& num_cols,
+                                   QVector<quint16>& square_indices ) const
 {
   // Open the dun file
   QFile dun_file( d_level_dun_file_name );
@@ -79,18 +205,18 @@ LevelSector* LevelSectorFactory::createLevelSector(
   stream.setByteOrder( QDataStream::LittleEndian );
 
   // Get the number of rows and columns
-  quint16 num_rows, num_cols;
+  quint16 raw_num_rows, raw_num_cols;
 
-  stream >> num_cols;
-  stream >> num_rows;
+  stream >> raw_num_cols;
+  stream >> raw_num_rows;
 
-  // Initialize the square rows and columns
-  QVector<QVector<LevelSquare*> > ordered_squares( num_rows );
+  num_rows = raw_num_rows;
+  num_cols = raw_num_cols;
+
+  square_indices.resize( num_rows*num_cols );
 
   for( int j = 0; j < num_rows; ++j )
   {
-    ordered_squares[j].resize( num_cols );
-
     for( int i = 0; i < num_cols; ++i )
     {
       // Make sure that the stream is still valid
@@ -101,19 +227,135 @@ LevelSector* LevelSectorFactory::createLevelSector(
                 d_level_dun_file_name.toStdString().c_str(), j, i );
       }
 
-      // Get the square index
-      quint16 square_index;
+      stream >> square_indices[j*num_cols + i];
+    }
+  }
+}
 
-      stream >> square_index;
+// Read the monster and object placements from the dun file
+/*! \details The square indices can be followed by layers that cover the
+ * sector grid tiles (2x2 tiles per square): an item layer (unused), a
+ * monster layer, an object layer and a transparency layer. Missing layers
+ * are treated as empty.
+ */
+void LevelSectorFactory::readPlacements(
+                               QVector<Placement>& monster_placements,
+                               QVector<Placement>& object_placements ) const
+{
+  monster_placements.clear();
+  object_placements.clear();
 
-      if( square_index > 0 )
-        ordered_squares[j][i] = squares[square_index-1]->clone();
+  // Open the dun file
+  QFile dun_file( d_level_dun_file_name );
+  dun_file.open( QIODevice::ReadOnly );
+
+  // Extract the dun file data
+  QDataStream stream( &dun_file );
+  stream.setByteOrder( QDataStream::LittleEndian );
+
+  quint16 raw_num_rows, raw_num_cols;
+
+  stream >> raw_num_cols;
+  stream >> raw_num_rows;
+
+  // Skip the square indices
+  stream.skipRawData( 2*raw_num_rows*raw_num_cols );
+
+  // Skip the item layer
+  stream.skipRawData( 2*(2*raw_num_rows)*(2*raw_num_cols) );
+
+  LevelSectorFactory::readPlacementLayer( stream,
+                                          2*raw_num_rows,
+                                          2*raw_num_cols,
+                                          monster_placements );
+
+  LevelSectorFactory::readPlacementLayer( stream,
+                                          2*raw_num_rows,
+                                          2*raw_num_cols,
+                                          object_placements );
+}
+
+// Read a placement layer from the dun file stream
+void LevelSectorFactory::readPlacementLayer(
+                                          QDataStream& stream,
+                                          const int num_rows,
+                                          const int num_cols,
+                                          QVector<Placement>& placements )
+{
+  for( int j = 0; j < num_rows; ++j )
+  {
+    for( int i = 0; i < num_cols; ++i )
+    {
+      if( stream.atEnd() )
+        return;
+
+      quint16 id;
+
+      stream >> id;
+
+      if( id != 0 )
+      {
+        Placement placement = {i, j, id};
+
+        placements << placement;
+      }
     }
   }
+}
 
-  // Todo: parse the additional info in the dun file...
+// Read the pillar indices of each square from a til file
+/*! \details There are four pillar indices per square (top, right, left,
+ * bottom).
+ */
+void LevelSectorFactory::readSquarePillarIndices(
+                                      const QString& level_til_file_name,
+                                      QVector<quint16>& pillar_indices )
+{
+  if( !level_til_file_name.contains( ".til" ) )
+  {
+    qFatal( "LevelSectorFactory Error: cannot parse file %s (only .til "
+            "files can be parsed)!",
+            level_til_file_name.toStdString().c_str() );
+  }
 
-  return new LevelSector( ordered_squares );
+  // Open the til file
+  QFile til_file( level_til_file_name );
+  til_file.open( QIODevice::ReadOnly );
+
+  // Extract the til file data
+  QDataStream stream( &til_file );
+  stream.setByteOrder( QDataStream::LittleEndian );
+
+  pillar_indices.clear();
+  pillar_indices.reserve( til_file.size()/2 );
+
+  while( !stream.atEnd() )
+  {
+    quint16 pillar_index;
+
+    stream >> pillar_index;
+
+    pillar_indices << pillar_index;
+  }
+}
+
+// Read the pillar flags from a sol file
+/*! \details There is one flag byte per pillar.
+ */
+void LevelSectorFactory::readPillarFlags( const QString& level_sol_file_name,
+                                          QByteArray& pillar_flags )
+{
+  if( !level_sol_file_name.contains( ".sol" ) )
+  {
+    qFatal( "LevelSectorFactory Error: cannot parse file %s (only .sol "
+            "files can be parsed)!",
+            level_sol_file_name.toStdString().c_str() );
+  }
+
+  QFile sol_file( level_sol_file_name );
+  sol_file.open( QIODevice::ReadOnly );
+
+  pillar_flags = sol_file.readAll();
 }
 
 } // end QtD1
@@ -6,12 +6,18 @@
 //!
 //---------------------------------------------------------------------------//
 
+#ifndef LEVEL_SECTOR_FACTORY_H
+#define LEVEL_SECTOR_FACTORY_H
+
 // Qt Includes
 #include <QString>
 #include <QList>
+#include <QVector>
+#include <QByteArray>
 
 // QtD1 Includes
 #include "LevelSector.h"
+#include "LevelGrid.h"
 
 namespace QtD1{
 
@@ -21,6 +27,16 @@ class LevelSectorFactory
 
 public:
 
+  //! A monster or object placement in the dun file
+  struct Placement{
+    //! The tile column in the sector grid
+    int x;
+    //! The tile row in the sector grid
+    int y;
+    //! The raw monster or object id
+    int id;
+  };
+
   //! Constructor
   LevelSectorFactory( const QString& level_min_file_name,
                       const QString& level_til_file_name,
@@ -37,8 +53,39 @@ public:
   LevelSector* createLevelSector(
                    const QList<std::shared_ptr<LevelSquare> >& squares ) const;
 
+  //! Create the level sector grid
+  LevelGrid createLevelGrid(
+                      const QString& level_sol_file_name = QString() ) const;
+
+  //! Create the level sector grid (advanced)
+  LevelGrid createLevelGrid( const QVector<quint16>& pillar_indices,
+                             const QByteArray& pillar_flags ) const;
+
+  //! Read the pillar indices of each square from a til file
+  static void readSquarePillarIndices( const QString& level_til_file_name,
+                                       QVector<quint16>& pillar_indices );
+
+  //! Read the pillar flags from a sol file
+  static void readPillarFlags( const QString& level_sol_file_name,
+                               QByteArray& pillar_flags );
+
+  //! Read the square indices from the dun file (row-major, 0 = no square)
+  void readSquareIndices( int& num_rows,
+                          int& num_cols,
+                          QVector<quint16>& square_indices ) const;
+
+  //! Read the monster and object placements from the dun file
+  void readPlacements( QVector<Placement>& monster_placements,
+                       QVector<Placement>& object_placements ) const;
+
 private:
 
+  // Read a placement layer from the dun file stream
+  static void readPlacementLayer( QDataStream& stream,
+                                  const int num_rows,
+                                  const int num_cols,
+                                  QVector<Placement>& placements );
+
   // The level min file name
   QString d_level_min_file_name;
 
@@ -51,6 +98,8 @@ private:
   
 } // end QtD1
 
+#endif // end LEVEL_SECTOR_FACTORY_H
+
 //---------------------------------------------------------------------------//
 // end LevelSectorFactory.cpp
 //---------------------------------------------------------------------------//
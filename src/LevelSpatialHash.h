@@ -0,0 +1,153 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelSpatialHash.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level spatial hash class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LEVEL_SPATIAL_HASH_H
+#define LEVEL_SPATIAL_HASH_H
+
+// Qt Includes
+#include <QHash>
+#include <QVector>
+#include <QList>
+#include <QPoint>
+#include <QPointF>
+#include <QRectF>
+
+namespace QtD1{
+
+/*! The level spatial hash
+ *
+ * The spatial hash stores items in buckets that are keyed by the level square
+ * coordinates of the item. Level squares are isometric diamonds: a step along
+ * the square column moves (+width/2,+height/2) in the level and a step along
+ * the square row moves (-width/2,+height/2). Moving an item only touches the
+ * bucket that it left and the bucket that it entered. The item type must be
+ * usable as a QHash key (e.g. a pointer).
+ */
+template<typename T>
+class LevelSpatialHash
+{
+
+public:
+
+  //! Constructor
+  LevelSpatialHash( const QPointF& origin = QPointF(),
+                    const qreal square_width = 128.0,
+                    const qreal square_height = 64.0 );
+
+  //! Destructor
+  ~LevelSpatialHash()
+  { /* ... */ }
+
+  //! Set the origin (location of square (0,0))
+  void setOrigin( const QPointF& origin );
+
+  //! Get the origin
+  const QPointF& getOrigin() const;
+
+  //! Map a level position to square coordinates (x=column, y=row)
+  QPoint mapToSquare( const QPointF& position ) const;
+
+  //! Map square coordinates to the level position of the square
+  QPointF mapFromSquare( const QPoint& square ) const;
+
+  //! Insert an item (or move it if it has already been inserted)
+  void insert( const T& item, const QPointF& position );
+
+  //! Move an item
+  void move( const T& item, const QPointF& new_position );
+
+  //! Remove an item
+  void remove( const T& item );
+
+  //! Check if an item has been inserted
+  bool contains( const T& item ) const;
+
+  //! Get the position of an item
+  QPointF getPosition( const T& item ) const;
+
+  //! Get the square of an item
+  QPoint getSquare( const T& item ) const;
+
+  //! Get the number of items
+  int size() const;
+
+  //! Check if there are no items
+  bool isEmpty() const;
+
+  //! Remove all items
+  void clear();
+
+  //! Get the items in a square
+  void querySquare( const QPoint& square, QList<T>& items ) const;
+
+  //! Get the items inside of a rect
+  void queryRect( const QRectF& rect, QList<T>& items ) const;
+
+  //! Get the items inside of a circle
+  void queryRadius( const QPointF& center,
+                    const qreal radius,
+                    QList<T>& items ) const;
+
+  //! Get the items within a distance of a line segment
+  void queryLine( const QPointF& start,
+                  const QPointF& end,
+                  const qreal half_width,
+                  QList<T>& items ) const;
+
+private:
+
+  // The item entry
+  struct Entry
+  {
+    QPoint square;
+    QPointF position;
+  };
+
+  // Get the bucket key of a square
+  static quint32 getKey( const QPoint& square );
+
+  // Get the items in the squares that overlap a rect (unfiltered)
+  template<typename Predicate>
+  void queryCandidates( const QRectF& rect,
+                        const Predicate& predicate,
+                        QList<T>& items ) const;
+
+  // Remove an item from a bucket
+  void removeFromBucket( const T& item, const QPoint& square );
+
+  // The origin
+  QPointF d_origin;
+
+  // The square half width
+  qreal d_square_half_width;
+
+  // The square half height
+  qreal d_square_half_height;
+
+  // The buckets
+  QHash<quint32,QVector<T> > d_buckets;
+
+  // The item entries
+  QHash<T,Entry> d_entries;
+};
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// Template Includes
+//---------------------------------------------------------------------------//
+
+#include "LevelSpatialHash_def.h"
+
+//---------------------------------------------------------------------------//
+
+#endif // end LEVEL_SPATIAL_HASH_H
+
+//---------------------------------------------------------------------------//
+// end LevelSpatialHash.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,442 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LevelSpatialHash_def.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level spatial hash class definition
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LEVEL_SPATIAL_HASH_DEF_H
+#define LEVEL_SPATIAL_HASH_DEF_H
+
+// Std Lib Includes
+#include <cmath>
+#include <algorithm>
+
+// Qt Includes
+#include <QSet>
+#include <QLineF>
+
+namespace QtD1{
+
+// Constructor
+template<typename T>
+LevelSpatialHash<T>::LevelSpatialHash( const QPointF& origin,
+                                       const qreal square_width,
+                                       const qreal square_height )
+  : d_origin( origin ),
+    d_square_half_width( square_width/2 ),
+    d_square_half_height( square_height/2 ),
+    d_buckets(),
+    d_entries()
+{
+  if( square_width <= 0.0 || square_height <= 0.0 )
+  {
+    qFatal( "LevelSpatialHash Error: The square dimensions must be greater "
+            "than zero!" );
+  }
+}
+
+// Set the origin (location of square (0,0))
+/*! \details All items will be rehashed.
+ */
+template<typename T>
+void LevelSpatialHash<T>::setOrigin( const QPointF& origin )
+{
+  d_origin = origin;
+
+  QHash<T,Entry> old_entries;
+  old_entries.swap( d_entries );
+
+  d_buckets.clear();
+
+  typename QHash<T,Entry>::const_iterator entry_it, entry_end;
+  entry_it = old_entries.begin();
+  entry_end = old_entries.end();
+
+  while( entry_it != entry_end )
+  {
+    this->insert( entry_it.key(), entry_it.value().position );
+
+    ++entry_it;
+  }
+}
+
+// Get the origin
+template<typename T>
+const QPointF& LevelSpatialHash<T>::getOrigin() const
+{
+  return d_origin;
+}
+
+// Map a level position to square coordinates (x=column, y=row)
+template<typename T>
+QPoint LevelSpatialHash<T>::mapToSquare( const QPointF& position ) const
+{
+  const qreal u = (position.x() - d_origin.x())/d_square_half_width;
+  const qreal v = (position.y() - d_origin.y())/d_square_half_height;
+
+  return QPoint( (int)std::floor( (v + u)/2 ), (int)std::floor( (v - u)/2 ) );
+}
+
+// Map square coordinates to the level position of the square
+/*! \details The position of the square is the top corner of its diamond.
+ */
+template<typename T>
+QPointF LevelSpatialHash<T>::mapFromSquare( const QPoint& square ) const
+{
+  return QPointF( d_origin.x() + (square.x() - square.y())*d_square_half_width,
+                  d_origin.y() + (square.x() + square.y())*d_square_half_height );
+}
+
+// Insert an item (or move it if it has already been inserted)
+template<typename T>
+void LevelSpatialHash<T>::insert( const T& item, const QPointF& position )
+{
+  if( d_entries.contains( item ) )
+    this->move( item, position );
+  else
+  {
+    Entry& entry = d_entries[item];
+    entry.square = this->mapToSquare( position );
+    entry.position = position;
+
+    d_buckets[LevelSpatialHash::getKey( entry.square )].append( item );
+  }
+}
+
+// Move an item
+/*! \details If the item stays in the same square only its stored position
+ * will be updated.
+ */
+template<typename T>
+void LevelSpatialHash<T>::move( const T& item, const QPointF& new_position )
+{
+  typename QHash<T,Entry>::iterator entry_it = d_entries.find( item );
+
+  if( entry_it == d_entries.end() )
+    this->insert( item, new_position );
+  else
+  {
+    QPoint new_square = this->mapToSquare( new_position );
+
+    if( new_square != entry_it.value().square )
+    {
+      this->removeFromBucket( item, entry_it.value().square );
+
+      d_buckets[LevelSpatialHash::getKey( new_square )].append( item );
+
+      entry_it.value().square = new_square;
+    }
+
+    entry_it.value().position = new_position;
+  }
+}
+
+// Remove an item
+template<typename T>
+void LevelSpatialHash<T>::remove( const T& item )
+{
+  typename QHash<T,Entry>::iterator entry_it = d_entries.find( item );
+
+  if( entry_it != d_entries.end() )
+  {
+    this->removeFromBucket( item, entry_it.value().square );
+
+    d_entries.erase( entry_it );
+  }
+}
+
+// Check if an item has been inserted
+template<typename T>
+bool LevelSpatialHash<T>::contains( const T& item ) const
+{
+  return d_entries.contains( item );
+}
+
+// Get the position of an item
+template<typename T>
+QPointF LevelSpatialHash<T>::getPosition( const T& item ) const
+{
+  return d_entries.value( item ).position;
+}
+
+// Get the square of an item
+template<typename T>
+QPoint LevelSpatialHash<T>::getSquare( const T& item ) const
+{
+  return d_entries.value( item ).square;
+}
+
+// Get the number of items
+template<typename T>
+int LevelSpatialHash<T>::size() const
+{
+  return d_entries.size();
+}
+
+// Check if there are no items
+template<typename T>
+bool LevelSpatialHash<T>::isEmpty() const
+{
+  return d_entries.isEmpty();
+}
+
+// Remove all items
+template<typename T>
+void LevelSpatialHash<T>::clear()
+{
+  d_buckets.clear();
+  d_entries.clear();
+}
+
+// Get the items in a square
+template<typename T>
+void LevelSpatialHash<T>::querySquare( const QPoint& square,
+                                       QList<T>& items ) const
+{
+  typename QHash<quint32,QVector<T> >::const_iterator bucket_it =
+    d_buckets.find( LevelSpatialHash::getKey( square ) );
+
+  if( bucket_it != d_buckets.end() )
+  {
+    for( int i = 0; i < bucket_it.value().size(); ++i )
+      items << bucket_it.value()[i];
+  }
+}
+
+// Get the items inside of a rect
+template<typename T>
+void LevelSpatialHash<T>::queryRect( const QRectF& rect,
+                                     QList<T>& items ) const
+{
+  this->queryCandidates( rect,
+                         [&rect]( const QPointF& position ){
+                           return rect.contains( position ); },
+                         items );
+}
+
+// Get the items inside of a circle
+template<typename T>
+void LevelSpatialHash<T>::queryRadius( const QPointF& center,
+                                       const qreal radius,
+                                       QList<T>& items ) const
+{
+  const qreal radius_squared = radius*radius;
+
+  this->queryCandidates( QRectF( center.x() - radius, center.y() - radius,
+                                 2*radius, 2*radius ),
+                         [&center,radius_squared]( const QPointF& position ){
+                           const QPointF diff = position - center;
+                           return diff.x()*diff.x() + diff.y()*diff.y() <=
+                             radius_squared; },
+                         items );
+}
+
+// Get the items within a distance of a line segment
+/*! \details The segment is walked in steps of at most half a square so that
+ * only the squares along the line are visited (a long diagonal line would
+ * otherwise visit every square in its bounding rect).
+ */
+template<typename T>
+void LevelSpatialHash<T>::queryLine( const QPointF& start,
+                                     const QPointF& end,
+                                     const qreal half_width,
+                                     QList<T>& items ) const
+{
+  const QPointF segment = end - start;
+  const qreal length_squared =
+    segment.x()*segment.x() + segment.y()*segment.y();
+
+  const qreal step_size = std::min( d_square_half_width, d_square_half_height );
+  const int number_of_steps =
+    std::max( 1, (int)std::ceil( std::sqrt( length_squared )/step_size ) );
+
+  // Gather the squares along the line
+  const qreal pad = half_width + step_size;
+
+  QSet<quint32> visited_keys;
+
+  for( int step = 0; step <= number_of_steps; ++step )
+  {
+    const QPointF sample = start + segment*((qreal)step/number_of_steps);
+
+    const QPoint corners[4] = {
+      this->mapToSquare( sample + QPointF( -pad, -pad ) ),
+      this->mapToSquare( sample + QPointF( pad, -pad ) ),
+      this->mapToSquare( sample + QPointF( -pad, pad ) ),
+      this->mapToSquare( sample + QPointF( pad, pad ) ) };
+
+    int min_col = corners[0].x(), max_col = corners[0].x();
+    int min_row = corners[0].y(), max_row = corners[0].y();
+
+    for( int i = 1; i < 4; ++i )
+    {
+      min_col = std::min( min_col, corners[i].x() );
+      max_col = std::max( max_col, corners[i].x() );
+      min_row = std::min( min_row, corners[i].y() );
+      max_row = std::max( max_row, corners[i].y() );
+    }
+
+    for( int row = min_row; row <= max_row; ++row )
+    {
+      for( int col = min_col; col <= max_col; ++col )
+        visited_keys.insert( LevelSpatialHash::getKey( QPoint( col, row ) ) );
+    }
+  }
+
+  // Filter the items in the visited squares
+  const qreal half_width_squared = half_width*half_width;
+
+  QSet<quint32>::const_iterator key_it, key_end;
+  key_it = visited_keys.begin();
+  key_end = visited_keys.end();
+
+  while( key_it != key_end )
+  {
+    typename QHash<quint32,QVector<T> >::const_iterator bucket_it =
+      d_buckets.find( *key_it );
+
+    if( bucket_it != d_buckets.end() )
+    {
+      const QVector<T>& bucket = bucket_it.value();
+
+      for( int i = 0; i < bucket.size(); ++i )
+      {
+        const QPointF position = d_entries.value( bucket[i] ).position;
+
+        // Find the closest point on the segment
+        qreal t = 0.0;
+
+        if( length_squared > 0.0 )
+        {
+          const QPointF diff = position - start;
+
+          t = (diff.x()*segment.x() + diff.y()*segment.y())/length_squared;
+          t = std::max( (qreal)0.0, std::min( (qreal)1.0, t ) );
+        }
+
+        const QPointF offset = position - (start + segment*t);
+
+        if( offset.x()*offset.x() + offset.y()*offset.y() <=
+            half_width_squared )
+          items << bucket[i];
+      }
+    }
+
+    ++key_it;
+  }
+}
+
+// Get the bucket key of a square
+/*! \details Square coordinates must be in [-32768,32767].
+ */
+template<typename T>
+quint32 LevelSpatialHash<T>::getKey( const QPoint& square )
+{
+  return ((quint32)(square.x() & 0xFFFF) << 16) |
+    (quint32)(square.y() & 0xFFFF);
+}
+
+// Get the items in the squares that overlap a rect (unfiltered)
+/*! \details If the rect covers more squares than there are occupied buckets,
+ * the occupied buckets will be visited instead.
+ */
+template<typename T>
+template<typename Predicate>
+void LevelSpatialHash<T>::queryCandidates( const QRectF& rect,
+                                           const Predicate& predicate,
+                                           QList<T>& items ) const
+{
+  const QPoint corners[4] = { this->mapToSquare( rect.topLeft() ),
+                              this->mapToSquare( rect.topRight() ),
+                              this->mapToSquare( rect.bottomLeft() ),
+                              this->mapToSquare( rect.bottomRight() ) };
+
+  int min_col = corners[0].x(), max_col = corners[0].x();
+  int min_row = corners[0].y(), max_row = corners[0].y();
+
+  for( int i = 1; i < 4; ++i )
+  {
+    min_col = std::min( min_col, corners[i].x() );
+    max_col = std::max( max_col, corners[i].x() );
+    min_row = std::min( min_row, corners[i].y() );
+    max_row = std::max( max_row, corners[i].y() );
+  }
+
+  const qint64 number_of_squares =
+    (qint64)(max_col - min_col + 1)*(max_row - min_row + 1);
+
+  if( number_of_squares > d_buckets.size() )
+  {
+    typename QHash<T,Entry>::const_iterator entry_it, entry_end;
+    entry_it = d_entries.begin();
+    entry_end = d_entries.end();
+
+    while( entry_it != entry_end )
+    {
+      if( predicate( entry_it.value().position ) )
+        items << entry_it.key();
+
+      ++entry_it;
+    }
+  }
+  else
+  {
+    for( int row = min_row; row <= max_row; ++row )
+    {
+      for( int col = min_col; col <= max_col; ++col )
+      {
+        typename QHash<quint32,QVector<T> >::const_iterator bucket_it =
+          d_buckets.find( LevelSpatialHash::getKey( QPoint( col, row ) ) );
+
+        if( bucket_it == d_buckets.end() )
+          continue;
+
+        const QVector<T>& bucket = bucket_it.value();
+
+        for( int i = 0; i < bucket.size(); ++i )
+        {
+          if( predicate( d_entries.value( bucket[i] ).position ) )
+            items << bucket[i];
+        }
+      }
+    }
+  }
+}
+
+// Remove an item from a bucket
+template<typename T>
+void LevelSpatialHash<T>::removeFromBucket( const T& item,
+                                            const QPoint& square )
+{
+  const quint32 key = LevelSpatialHash::getKey( square );
+
+  typename QHash<quint32,QVector<T> >::iterator bucket_it =
+    d_buckets.find( key );
+
+  if( bucket_it != d_buckets.end() )
+  {
+    QVector<T>& bucket = bucket_it.value();
+
+    int index = bucket.indexOf( item );
+
+    if( index >= 0 )
+    {
+      // Swap with the last item so that the removal does not shift the bucket
+      bucket[index] = bucket.last();
+      bucket.pop_back();
+    }
+
+    if( bucket.isEmpty() )
+      d_buckets.erase( bucket_it );
+  }
+}
+
+} // end QtD1 namespace
+
+#endif // end LEVEL_SPATIAL_HASH_DEF_H
+
+//---------------------------------------------------------------------------//
+// end LevelSpatialHash_def.h
+//---------------------------------------------------------------------------//
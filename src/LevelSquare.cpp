@@ -119,6 +119,16 @@ void LevelSquare::paint( QPainter*,
                          QWidget* )
 { /* ... */ }
 
+// Get the pillar data of the pillars
+void LevelSquare::getPillarData(
+               QList<std::shared_ptr<LevelPillarData> >& pillar_data ) const
+{
+  pillar_data << d_top_pillar->getData()
+              << d_right_pillar->getData()
+              << d_left_pillar->getData()
+              << d_bottom_pillar->getData();
+}
+
 // Clone the level square
 LevelSquare* LevelSquare::clone()
 {
@@ -64,6 +64,10 @@ public:
   //! Clone the level square
   LevelSquare* clone();
 
+  //! Get the pillar data of the pillars
+  void getPillarData(
+              QList<std::shared_ptr<LevelPillarData> >& pillar_data ) const;
+
 private:
 
   // The pillars
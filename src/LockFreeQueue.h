@@ -0,0 +1,207 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   LockFreeQueue.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The lock-free queue class declaration and definition
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+// Std Lib Includes
+#include <atomic>
+#include <algorithm>
+
+// Qt Includes
+#include <QVector>
+
+namespace QtD1{
+
+/*! The lock-free queue
+ * \details A bounded single-producer, single-consumer queue. One thread
+ * may push values while another thread pops them - neither thread ever
+ * waits for the other (e.g. the GUI thread can hand commands to the audio
+ * thread). The capacity is rounded up to a power of two.
+ */
+template<typename T>
+class LockFreeQueue
+{
+
+public:
+
+  //! Constructor
+  LockFreeQueue( const int capacity );
+
+  //! Destructor
+  ~LockFreeQueue()
+  { /* ... */ }
+
+  //! Get the capacity
+  int getCapacity() const;
+
+  //! Check if the queue is empty
+  bool isEmpty() const;
+
+  //! Get the number of values in the queue
+  int getSize() const;
+
+  //! Push a value (producer only - returns false if the queue is full)
+  bool push( const T& value );
+
+  //! Push values (producer only - returns the number of values pushed)
+  int push( const T* values, const int number_of_values );
+
+  //! Pop a value (consumer only - returns false if the queue is empty)
+  bool pop( T& value );
+
+  //! Pop values (consumer only - returns the number of values popped)
+  int pop( T* values, const int number_of_values );
+
+private:
+
+  // Constructors and assignment operator
+  LockFreeQueue();
+  LockFreeQueue( const LockFreeQueue& that );
+  LockFreeQueue& operator=( const LockFreeQueue& that );
+
+  // The values
+  QVector<T> d_values;
+
+  // The index mask
+  unsigned d_mask;
+
+  // The index of the next value that will be popped
+  std::atomic<unsigned> d_head;
+
+  // The index of the next value that will be pushed
+  std::atomic<unsigned> d_tail;
+};
+
+// Constructor
+template<typename T>
+LockFreeQueue<T>::LockFreeQueue( const int capacity )
+  : d_values(),
+    d_mask( 0 ),
+    d_head( 0 ),
+    d_tail( 0 )
+{
+  unsigned rounded_capacity = 1;
+
+  while( rounded_capacity < (unsigned)capacity )
+    rounded_capacity <<= 1;
+
+  d_values.resize( rounded_capacity );
+  d_mask = rounded_capacity - 1;
+}
+
+// Get the capacity
+template<typename T>
+inline int LockFreeQueue<T>::getCapacity() const
+{
+  return d_values.size();
+}
+
+// Check if the queue is empty
+template<typename T>
+inline bool LockFreeQueue<T>::isEmpty() const
+{
+  return d_head.load( std::memory_order_acquire ) ==
+    d_tail.load( std::memory_order_acquire );
+}
+
+// Get the number of values in the queue
+/*! \details The producer will never see more values than there are and
+ * the consumer will never see fewer values than there are.
+ */
+template<typename T>
+inline int LockFreeQueue<T>::getSize() const
+{
+  const unsigned head = d_head.load( std::memory_order_acquire );
+
+  return d_tail.load( std::memory_order_acquire ) - head;
+}
+
+// Push a value (producer only - returns false if the queue is full)
+template<typename T>
+inline bool LockFreeQueue<T>::push( const T& value )
+{
+  const unsigned tail = d_tail.load( std::memory_order_relaxed );
+
+  if( tail - d_head.load( std::memory_order_acquire ) > d_mask )
+    return false;
+
+  d_values[tail & d_mask] = value;
+
+  // Publish the value
+  d_tail.store( tail + 1, std::memory_order_release );
+
+  return true;
+}
+
+// Push values (producer only - returns the number of values pushed)
+/*! \details The values that do not fit in the queue will not be pushed.
+ */
+template<typename T>
+inline int LockFreeQueue<T>::push( const T* values,
+                                   const int number_of_values )
+{
+  const unsigned tail = d_tail.load( std::memory_order_relaxed );
+
+  const int free_space =
+    d_values.size() - (tail - d_head.load( std::memory_order_acquire ));
+
+  const int number_of_values_pushed = std::min( free_space, number_of_values );
+
+  for( int i = 0; i < number_of_values_pushed; ++i )
+    d_values[(tail + i) & d_mask] = values[i];
+
+  // Publish the values
+  d_tail.store( tail + number_of_values_pushed, std::memory_order_release );
+
+  return number_of_values_pushed;
+}
+
+// Pop a value (consumer only - returns false if the queue is empty)
+template<typename T>
+inline bool LockFreeQueue<T>::pop( T& value )
+{
+  const unsigned head = d_head.load( std::memory_order_relaxed );
+
+  if( head == d_tail.load( std::memory_order_acquire ) )
+    return false;
+
+  value = d_values[head & d_mask];
+
+  // Release the slot
+  d_head.store( head + 1, std::memory_order_release );
+
+  return true;
+}
+
+// Pop values (consumer only - returns the number of values popped)
+template<typename T>
+inline int LockFreeQueue<T>::pop( T* values, const int number_of_values )
+{
+  const unsigned head = d_head.load( std::memory_order_relaxed );
+
+  const int number_of_values_popped =
+    std::min( (int)(d_tail.load( std::memory_order_acquire ) - head),
+              number_of_values );
+
+  for( int i = 0; i < number_of_values_popped; ++i )
+    values[i] = d_values.at( (head + i) & d_mask );
+
+  // Release the slots
+  d_head.store( head + number_of_values_popped, std::memory_order_release );
+
+  return number_of_values_popped;
+}
+
+} // end QtD1 namespace
+
+#endif // end LOCK_FREE_QUEUE_H
+
+//---------------------------------------------------------------------------//
+// end LockFreeQueue.h
+//---------------------------------------------------------------------------//
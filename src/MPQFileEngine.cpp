@@ -17,6 +17,7 @@
 // QtD1 Includes
 #include "MPQFileEngine.h"
 #include "MPQHandler.h"
+#include "CustomMPQFileHeader.h"
 
 namespace QtD1{
 
@@ -24,10 +25,49 @@ namespace QtD1{
 MPQFileEngine::MPQFileEngine( const QStringList& filenames,
                               const QByteArray& file_data )
   : d_file_names( filenames ),
-    d_file_data( file_data ),
+    d_asset(),
+    d_file_data_segments( 1, file_data ),
+    d_file_data_size( file_data.size() ),
     d_file_data_pos( 0 )
 { /* ... */ }
 
+// Constructor (compound asset)
+/*! \details The parts of the asset are not concatenated. When the engine
+ * is read through a QFile the parts appear as a single buffer (with a
+ * custom header if there is more than one part) - the data is only copied
+ * into the buffer that the reader provides.
+ */
+MPQFileEngine::MPQFileEngine( const CompoundAsset& asset )
+  : d_file_names( asset.getFileNames() ),
+    d_asset( asset ),
+    d_file_data_segments(),
+    d_file_data_size( 0 ),
+    d_file_data_pos( 0 )
+{
+  // Only add the header if there is more than one file present
+  if( asset.getNumberOfParts() > 1 )
+  {
+    CustomMPQFileHeader header;
+
+    qint64 start_location = 0;
+
+    for( int i = 0; i < asset.getNumberOfParts(); ++i )
+    {
+      header.addElement( asset.getPartFileName( i ), start_location );
+
+      start_location += asset.getPartData( i ).size();
+    }
+
+    d_file_data_segments << header.serialize();
+  }
+
+  for( int i = 0; i < asset.getNumberOfParts(); ++i )
+    d_file_data_segments << asset.getPartData( i );
+
+  for( int i = 0; i < d_file_data_segments.size(); ++i )
+    d_file_data_size += d_file_data_segments[i].size();
+}
+
 // Destructor
 MPQFileEngine::~MPQFileEngine()
 { /* ... */ }
@@ -63,7 +103,7 @@ bool MPQFileEngine::close()
 // Return the size of the file
 qint64 MPQFileEngine::size() const
 {
-  return d_file_data.size();
+  return d_file_data_size;
 }
 
 // Return the current file position
@@ -75,7 +115,7 @@ qint64 MPQFileEngine::pos() const
 // Set the file position to the given offset (from the beginning of the file)
 bool MPQFileEngine::seek( qint64 offset )
 {
-  if( offset <= d_file_data.size() )
+  if( offset <= d_file_data_size )
   {
     d_file_data_pos = offset;
 
@@ -175,15 +215,43 @@ qint64 MPQFileEngine::read( char* data, qint64 maxlen )
 {
   // Calculate the number of bytes to read
   qint64 bytes_to_read =
-    std::min( maxlen, d_file_data.size() - d_file_data_pos );
+    std::min( maxlen, d_file_data_size - d_file_data_pos );
 
-  if( bytes_to_read > 0 )
-    memcpy( data, d_file_data.constData()+d_file_data_pos, bytes_to_read );
+  if( bytes_to_read <= 0 )
+    return 0;
 
-  // Set the position
-  d_file_data_pos += bytes_to_read;
+  qint64 bytes_read = 0;
+  qint64 segment_start = 0;
 
-  return bytes_to_read;
+  for( int i = 0; i < d_file_data_segments.size(); ++i )
+  {
+    const QByteArray& segment = d_file_data_segments[i];
+
+    const qint64 segment_end = segment_start + segment.size();
+
+    if( d_file_data_pos < segment_end )
+    {
+      const qint64 segment_pos = d_file_data_pos - segment_start;
+      
+      const qint64 segment_bytes_to_read =
+        std::min( bytes_to_read - bytes_read, segment.size() - segment_pos );
+
+      memcpy( data+bytes_read,
+              segment.constData()+segment_pos,
+              segment_bytes_to_read );
+
+      // Set the position
+      bytes_read += segment_bytes_to_read;
+      d_file_data_pos += segment_bytes_to_read;
+
+      if( bytes_read == bytes_to_read )
+        break;
+    }
+
+    segment_start = segment_end;
+  }
+
+  return bytes_read;
 }
 
 // Read a line of data from the file
@@ -191,6 +259,12 @@ qint64 MPQFileEngine::readLine( char* data, qint64 maxlen )
 {
   return this->read( data, maxlen );
 }
+
+// Get the compound asset (empty if the engine was not created from one)
+const CompoundAsset& MPQFileEngine::getCompoundAsset() const
+{
+  return d_asset;
+}
   
 } // end QtD1 namespace
 
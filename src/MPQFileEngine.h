@@ -13,6 +13,10 @@
 #include <QAbstractFileEngine>
 #include <QStringList>
 #include <QByteArray>
+#include <QVector>
+
+// QtD1 Includes
+#include "CompoundAsset.h"
 
 namespace QtD1{
 
@@ -28,6 +32,9 @@ public:
   //! Constructor
   MPQFileEngine( const QStringList& filenames, const QByteArray& file_data );
 
+  //! Constructor (compound asset)
+  MPQFileEngine( const CompoundAsset& asset );
+
   //! Destructor
   ~MPQFileEngine();
 
@@ -70,13 +77,22 @@ public:
   //! Read a line of data from the file
   qint64 readLine( char* data, qint64 maxlen ) override;
 
+  //! Get the compound asset (empty if the engine was not created from one)
+  const CompoundAsset& getCompoundAsset() const;
+
 private:
 
   // The name of the opened file(s)
   QStringList d_file_names;
 
-  // The (possibly concatenated) file data
-  QByteArray d_file_data;
+  // The compound asset
+  CompoundAsset d_asset;
+
+  // The file data segments (the header followed by the file parts)
+  QVector<QByteArray> d_file_data_segments;
+
+  // The size of the file data
+  qint64 d_file_data_size;
 
   // The position in the file data
   qint64 d_file_data_pos;
@@ -10,17 +10,18 @@
 #include <StormLib.h>
 
 // Qt Includes
-#include <QBuffer>
+#include <QMutexLocker>
 
 // QtD1 Includes
 #include "MPQHandler.h"
-#include "CustomMPQFileHeader.h"
 #include "qtd1_config.h"
+#include "Telemetry.h"
 
 namespace QtD1{
 
 // Initialize static member data
 std::unique_ptr<MPQHandler> MPQHandler::s_instance;
+QString MPQHandler::s_archive_file_name( DIABDAT_MPQ_PATH );
 
 // Get the singleton instance
 MPQHandler* MPQHandler::getInstance()
@@ -32,25 +33,43 @@ MPQHandler* MPQHandler::getInstance()
   return s_instance.get();
 }
 
+// Set the archive that will be opened (before the instance is created)
+/*! \details This allows tools (e.g. the benchmarks) to use an archive
+ * other than diabdat.mpq. Calling this method after the instance has been
+ * created is an error.
+ */
+void MPQHandler::setArchiveFileName( const QString& archive_file_name )
+{
+  if( s_instance )
+  {
+    qFatal( "MPQHandler Error: The archive cannot be changed after it has "
+            "been opened!" );
+  }
+
+  s_archive_file_name = archive_file_name;
+}
+
 // Constructor
 MPQHandler::MPQHandler()
   : QAbstractFileEngineHandler(),
-    d_mpq_file( 0 )
+    d_mpq_file( 0 ),
+    d_mpq_file_mutex()
 {
   // Open the MPQ file
   HANDLE mpq_file_handle;
   
-  const bool mpq_file_opened = SFileOpenArchive( DIABDAT_MPQ_PATH,
-                                                 0,
-                                                 STREAM_FLAG_READ_ONLY,
-                                                 &mpq_file_handle );
+  const bool mpq_file_opened =
+    SFileOpenArchive( s_archive_file_name.toLocal8Bit().data(),
+                      0,
+                      STREAM_FLAG_READ_ONLY,
+                      &mpq_file_handle );
 
   // Make sure the MPQ file opened successfully
   if( !mpq_file_opened )
   {
     qFatal( "Error: The MPQ file (%s) could not be opened!\n"
             "StormLib error code: %i",
-            DIABDAT_MPQ_PATH,
+            s_archive_file_name.toLocal8Bit().data(),
             GetLastError() );
   }
 
@@ -118,21 +137,15 @@ std::shared_ptr<MPQFileEngine> MPQHandler::createSafeWithCheck(
                               this->createWithCheck( file_names_with_paths ) );
 }
 
-// Open a file 
-/*! \details The caller will take ownership of the returned pointer and
- * must free it when it is no longer needed to prevent a memory leak. If the
- * file(s) does(do) not exist a std::exception will be thrown. If multiple 
- * files are present their contents will be concatenated and a header will be 
- * added that indicates where each file begins in the file buffer.
+// Open the concatenated files (with paths) as a compound asset
+/*! \details Each file is extracted into its own part - the file data is
+ * never concatenated. If the file(s) does(do) not exist a std::exception
+ * will be thrown.
  */
-MPQFileEngine* MPQHandler::createWithCheck(
+CompoundAsset MPQHandler::openCompoundAsset(
                                    const QString& file_names_with_paths ) const
 {
-  QByteArray combined_file_data;
-  QBuffer file_buffer( &combined_file_data );
-  file_buffer.open( QIODevice::WriteOnly );
-
-  CustomMPQFileHeader header;
+  CompoundAsset asset;
   
   QStringList extracted_file_names_with_paths;
 
@@ -141,24 +154,29 @@ MPQFileEngine* MPQHandler::createWithCheck(
 
   for( int i = 0; i < extracted_file_names_with_paths.size(); ++i )
   {
-    header.addElement( extracted_file_names_with_paths[i],
-                       file_buffer.pos() );
-    
     QByteArray file_data;
 
     this->extractFile( extracted_file_names_with_paths[i], file_data );
 
-    file_buffer.write( file_data );
+    asset.addPart( extracted_file_names_with_paths[i], file_data );
   }
 
-  file_buffer.close();
-
-  // Only add the header if there is more than one file present
-  if( extracted_file_names_with_paths.size() > 1 )
-    header.addToBuffer( combined_file_data );
+  return asset;
+}
 
-  return new MPQFileEngine( extracted_file_names_with_paths,
-                            combined_file_data );
+// Open a file 
+/*! \details The caller will take ownership of the returned pointer and
+ * must free it when it is no longer needed to prevent a memory leak. If the
+ * file(s) does(do) not exist a std::exception will be thrown. If multiple 
+ * files are present they will be read as a single buffer with a header
+ * that indicates where each file begins (see MPQFileEngine). Readers that
+ * understand compound assets can access the parts directly with
+ * MPQFileEngine::getCompoundAsset.
+ */
+MPQFileEngine* MPQHandler::createWithCheck(
+                                   const QString& file_names_with_paths ) const
+{
+  return new MPQFileEngine( this->openCompoundAsset( file_names_with_paths ) );
 }
 
 // Open a file
@@ -183,6 +201,10 @@ MPQFileEngine* MPQHandler::create( const QString &file_name_with_path ) const
 void MPQHandler::extractFile( const QString& file_name_with_path,
                               QByteArray& file_data ) const
 {
+  // Several image asset loaders (e.g. the level loader and the character
+  // sprite streamer) can read from the archive at the same time
+  QMutexLocker lock( &d_mpq_file_mutex );
+
   QString compatible_file_name_with_path = file_name_with_path;
 
   this->cleanFilePath( compatible_file_name_with_path );
@@ -223,6 +245,93 @@ void MPQHandler::extractFile( const QString& file_name_with_path,
 
   // Close the raw file
   SFileCloseFile( raw_archived_file );
+
+  Telemetry::addToCounter( Telemetry::MPQBytesReadCounter, file_data.size() );
+  Telemetry::addToCounter( Telemetry::MPQFilesExtractedCounter, 1 );
+}
+
+// Open an archived file for streaming (returns the archived file handle)
+/*! \details This method can only open a single file. Do not pass in a
+ * concatenated file string. If the file does not exist a std::exception
+ * will be thrown. The handle must be closed with closeArchivedFile.
+ */
+uintptr_t MPQHandler::openArchivedFile( const QString& file_name_with_path,
+                                        qint64& file_size ) const
+{
+  QMutexLocker lock( &d_mpq_file_mutex );
+
+  QString compatible_file_name_with_path = file_name_with_path;
+
+  this->cleanFilePath( compatible_file_name_with_path );
+  this->convertPathStyleToMPQPathStyle( compatible_file_name_with_path );
+
+  if( !this->doesFileWithMPQPathStyleExist(compatible_file_name_with_path) )
+  {
+    throw std::runtime_error( "Error: file %s does not exist!" + 
+                              file_name_with_path.toStdString() );
+  }
+
+  HANDLE raw_archived_file;
+
+  // Open the file
+  const bool archived_file_opened =
+    SFileOpenFileEx( (HANDLE)d_mpq_file,
+                     compatible_file_name_with_path.toStdString().c_str(),
+                     0,
+                     &raw_archived_file );
+
+  // Make sure that the archived file opened successfully
+  if( !archived_file_opened )
+  {
+    qFatal( "Error: The archived file (%s) in the MPQ file could not be "
+            "opened!",
+            file_name_with_path.toStdString().c_str() );
+  }
+
+  file_size = SFileGetFileSize( raw_archived_file, NULL );
+
+  return reinterpret_cast<uintptr_t>( raw_archived_file );
+}
+
+// Read from an archived file (returns the number of bytes read)
+/*! \details Only the sectors that hold the requested data are read (and
+ * decompressed) so an archived file can be streamed without extracting it.
+ */
+qint64 MPQHandler::readArchivedFile( const uintptr_t archived_file,
+                                     const qint64 offset,
+                                     char* data,
+                                     const qint64 max_size ) const
+{
+  QMutexLocker lock( &d_mpq_file_mutex );
+
+  HANDLE raw_archived_file = reinterpret_cast<HANDLE>( archived_file );
+
+  LONG offset_high = (LONG)(offset >> 32);
+
+  SFileSetFilePointer( raw_archived_file,
+                       (LONG)(offset & 0xFFFFFFFF),
+                       &offset_high,
+                       FILE_BEGIN );
+
+  DWORD bytes_read = 0;
+
+  SFileReadFile( raw_archived_file,
+                 data,
+                 (DWORD)max_size,
+                 &bytes_read,
+                 NULL );
+
+  Telemetry::addToCounter( Telemetry::MPQBytesReadCounter, bytes_read );
+
+  return bytes_read;
+}
+
+// Close an archived file
+void MPQHandler::closeArchivedFile( const uintptr_t archived_file ) const
+{
+  QMutexLocker lock( &d_mpq_file_mutex );
+
+  SFileCloseFile( reinterpret_cast<HANDLE>( archived_file ) );
 }
 
 // Extract file names with clean paths
@@ -17,6 +17,7 @@
 #include <QString>
 #include <QStringList>
 #include <QByteArray>
+#include <QMutex>
 
 // QtD1 Includes
 #include "MPQFileEngine.h"
@@ -34,6 +35,9 @@ public:
 
   //! Get the singleton instance
   static MPQHandler* getInstance();
+
+  //! Set the archive that will be opened (before the instance is created)
+  static void setArchiveFileName( const QString& archive_file_name );
   
   //! Destructor
   ~MPQHandler();
@@ -44,6 +48,10 @@ public:
   //! Check if the concatenated files (with paths) exist in the mpq file
   bool doFilesExist( const QString& file_names_with_paths ) const;
 
+  //! Open the concatenated files (with paths) as a compound asset
+  CompoundAsset openCompoundAsset(
+                              const QString& file_names_with_paths ) const;
+
   //! Open a file (automatic garbage collection = safe)
   std::shared_ptr<MPQFileEngine> createSafeWithCheck(
                               const QString& file_names_with_paths ) const;
@@ -58,6 +66,19 @@ public:
   //! Extract a file
   void extractFile( const QString& file_name_with_path,
                     QByteArray& file_data ) const;
+
+  //! Open an archived file for streaming (returns the archived file handle)
+  uintptr_t openArchivedFile( const QString& file_name_with_path,
+                              qint64& file_size ) const;
+
+  //! Read from an archived file (returns the number of bytes read)
+  qint64 readArchivedFile( const uintptr_t archived_file,
+                           const qint64 offset,
+                           char* data,
+                           const qint64 max_size ) const;
+
+  //! Close an archived file
+  void closeArchivedFile( const uintptr_t archived_file ) const;
   
 private:
 
@@ -83,8 +104,14 @@ private:
   // Note: A unique ptr is used here for automatic garbage collection.
   static std::unique_ptr<MPQHandler> s_instance;
 
+  // The archive file name (diabdat.mpq by default)
+  static QString s_archive_file_name;
+
   // The mpq file
   uintptr_t d_mpq_file;
+
+  // The mutex used to serialize archive reads (StormLib is not thread safe)
+  mutable QMutex d_mpq_file_mutex;
 };
   
 } // end QtD1 namespace
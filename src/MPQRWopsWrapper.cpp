@@ -0,0 +1,220 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MPQRWopsWrapper.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The mpq SDL_RWops wrapper class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+#include <cstring>
+
+// QtD1 Includes
+#include "MPQRWopsWrapper.h"
+#include "MPQHandler.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int MPQRWopsWrapper::s_read_ahead_size;
+
+// Constructor
+/*! \details If the file does not exist a std::exception will be thrown.
+ */
+MPQRWopsWrapper::MPQRWopsWrapper( const QString& file_name_with_path )
+  : d_archived_file( 0 ),
+    d_file_size( 0 ),
+    d_file_pos( 0 ),
+    d_window(),
+    d_window_pos( 0 ),
+    d_window_size( 0 ),
+    d_raw_rwops( NULL )
+{
+  d_archived_file =
+    MPQHandler::getInstance()->openArchivedFile( file_name_with_path,
+                                                 d_file_size );
+
+  d_raw_rwops = SDL_AllocRW();
+
+  // Make sure the raw SDL_RWops != NULL
+  if( d_raw_rwops == NULL )
+    qFatal( "Error: The SDL_RWops could not be allocated!" );
+
+  d_raw_rwops->size = MPQRWopsWrapper::sizeCallback;
+  d_raw_rwops->seek = MPQRWopsWrapper::seekCallback;
+  d_raw_rwops->read = MPQRWopsWrapper::readCallback;
+  d_raw_rwops->write = MPQRWopsWrapper::writeCallback;
+  d_raw_rwops->close = MPQRWopsWrapper::closeCallback;
+  d_raw_rwops->type = SDL_RWOPS_UNKNOWN;
+  d_raw_rwops->hidden.unknown.data1 = this;
+}
+
+// Destructor
+MPQRWopsWrapper::~MPQRWopsWrapper()
+{
+  SDL_FreeRW( d_raw_rwops );
+
+  d_raw_rwops = NULL;
+
+  MPQHandler::getInstance()->closeArchivedFile( d_archived_file );
+}
+
+// Get the file size
+qint64 MPQRWopsWrapper::getSize() const
+{
+  return d_file_size;
+}
+
+// Get the raw SDL_RWops pointer
+SDL_RWops* MPQRWopsWrapper::getRawRWopsPtr()
+{
+  return d_raw_rwops;
+}
+
+// Get the raw SDL_RWops pointer
+const SDL_RWops* MPQRWopsWrapper::getRawRWopsPtr() const
+{
+  return d_raw_rwops;
+}
+
+// Get the wrapper that owns an SDL_RWops
+MPQRWopsWrapper* MPQRWopsWrapper::getWrapper( SDL_RWops* rwops )
+{
+  return (MPQRWopsWrapper*)rwops->hidden.unknown.data1;
+}
+
+// Size callback
+Sint64 MPQRWopsWrapper::sizeCallback( SDL_RWops* rwops )
+{
+  return MPQRWopsWrapper::getWrapper( rwops )->d_file_size;
+}
+
+// Seek callback
+Sint64 MPQRWopsWrapper::seekCallback( SDL_RWops* rwops,
+                                      Sint64 offset,
+                                      int whence )
+{
+  return MPQRWopsWrapper::getWrapper( rwops )->seek( offset, whence );
+}
+
+// Read callback
+size_t MPQRWopsWrapper::readCallback( SDL_RWops* rwops,
+                                      void* data,
+                                      size_t size,
+                                      size_t max_number )
+{
+  if( size == 0 )
+    return 0;
+
+  qint64 bytes_read =
+    MPQRWopsWrapper::getWrapper( rwops )->read( (char*)data,
+                                                size*max_number );
+
+  return bytes_read/size;
+}
+
+// Write callback
+/*! \details Archived files are read only.
+ */
+size_t MPQRWopsWrapper::writeCallback( SDL_RWops*,
+                                       const void*,
+                                       size_t,
+                                       size_t )
+{
+  SDL_SetError( "Archived files are read only" );
+
+  return 0;
+}
+
+// Close callback
+/*! \details The wrapper owns the SDL_RWops - there is nothing to close.
+ */
+int MPQRWopsWrapper::closeCallback( SDL_RWops* )
+{
+  return 0;
+}
+
+// Seek
+Sint64 MPQRWopsWrapper::seek( Sint64 offset, int whence )
+{
+  qint64 file_pos;
+
+  switch( whence )
+  {
+    case RW_SEEK_SET:
+      file_pos = offset;
+      break;
+    case RW_SEEK_CUR:
+      file_pos = d_file_pos + offset;
+      break;
+    case RW_SEEK_END:
+      file_pos = d_file_size + offset;
+      break;
+    default:
+      return SDL_SetError( "Unknown seek whence value" );
+  }
+
+  if( file_pos < 0 || file_pos > d_file_size )
+    return SDL_SetError( "Cannot seek outside of the archived file" );
+
+  d_file_pos = file_pos;
+
+  return d_file_pos;
+}
+
+// Read
+/*! \details The data is copied from the read-ahead window. The window is
+ * refilled from the mpq file when the data is not in it.
+ */
+qint64 MPQRWopsWrapper::read( char* data, qint64 max_size )
+{
+  const qint64 bytes_to_read =
+    std::min( max_size, d_file_size - d_file_pos );
+
+  qint64 bytes_read = 0;
+
+  while( bytes_read < bytes_to_read )
+  {
+    // Refill the window
+    if( d_file_pos < d_window_pos ||
+        d_file_pos >= d_window_pos + d_window_size )
+    {
+      // The window is only allocated once the file is read
+      if( d_window.isEmpty() )
+        d_window.resize( s_read_ahead_size );
+
+      d_window_pos = d_file_pos;
+      d_window_size = MPQHandler::getInstance()->readArchivedFile(
+                                                      d_archived_file,
+                                                      d_window_pos,
+                                                      d_window.data(),
+                                                      d_window.size() );
+
+      if( d_window_size <= 0 )
+      {
+        d_window_size = 0;
+        break;
+      }
+    }
+
+    const qint64 window_bytes_to_read =
+      std::min( bytes_to_read - bytes_read,
+                d_window_pos + d_window_size - d_file_pos );
+
+    memcpy( data+bytes_read,
+            d_window.constData()+(d_file_pos - d_window_pos),
+            window_bytes_to_read );
+
+    bytes_read += window_bytes_to_read;
+    d_file_pos += window_bytes_to_read;
+  }
+
+  return bytes_read;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end MPQRWopsWrapper.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,119 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MPQRWopsWrapper.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The mpq SDL_RWops wrapper class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef MPQ_RWOPS_WRAPPER_H
+#define MPQ_RWOPS_WRAPPER_H
+
+// Std Lib Includes
+#include <cstdint>
+
+// SDL Includes
+#include <SDL_rwops.h>
+
+// Qt Includes
+#include <QString>
+#include <QByteArray>
+
+namespace QtD1{
+
+/*! The mpq SDL_RWops wrapper
+ * \details The SDL_RWops streams an archived file straight from the mpq
+ * file: only the sectors that are needed are read (through the MPQHandler)
+ * and only a small read-ahead window is kept in memory. The wrapper owns
+ * the SDL_RWops - it must outlive everyone that uses it (closing the
+ * SDL_RWops does nothing).
+ */
+class MPQRWopsWrapper
+{
+
+public:
+
+  //! The read-ahead window size (bytes)
+  static const int s_read_ahead_size = 64*1024;
+
+  //! Constructor
+  MPQRWopsWrapper( const QString& file_name_with_path );
+
+  //! Destructor
+  ~MPQRWopsWrapper();
+
+  //! Get the file size
+  qint64 getSize() const;
+
+  //! Get the raw SDL_RWops pointer
+  SDL_RWops* getRawRWopsPtr();
+
+  //! Get the raw SDL_RWops pointer
+  const SDL_RWops* getRawRWopsPtr() const;
+
+private:
+
+  // Constructors and assignment operator
+  MPQRWopsWrapper();
+  MPQRWopsWrapper( const MPQRWopsWrapper& that );
+  MPQRWopsWrapper& operator=( const MPQRWopsWrapper& that );
+
+  // Get the wrapper that owns an SDL_RWops
+  static MPQRWopsWrapper* getWrapper( SDL_RWops* rwops );
+
+  // Size callback
+  static Sint64 sizeCallback( SDL_RWops* rwops );
+
+  // Seek callback
+  static Sint64 seekCallback( SDL_RWops* rwops, Sint64 offset, int whence );
+
+  // Read callback
+  static size_t readCallback( SDL_RWops* rwops,
+                              void* data,
+                              size_t size,
+                              size_t max_number );
+
+  // Write callback
+  static size_t writeCallback( SDL_RWops* rwops,
+                               const void* data,
+                               size_t size,
+                               size_t number );
+
+  // Close callback
+  static int closeCallback( SDL_RWops* rwops );
+
+  // Seek
+  Sint64 seek( Sint64 offset, int whence );
+
+  // Read
+  qint64 read( char* data, qint64 max_size );
+
+  // The archived file
+  uintptr_t d_archived_file;
+
+  // The file size
+  qint64 d_file_size;
+
+  // The file position
+  qint64 d_file_pos;
+
+  // The read-ahead window
+  QByteArray d_window;
+
+  // The file position of the read-ahead window
+  qint64 d_window_pos;
+
+  // The size of the data in the read-ahead window
+  qint64 d_window_size;
+
+  // The raw SDL_RWops
+  SDL_RWops* d_raw_rwops;
+};
+  
+} // end QtD1 namespace
+
+#endif // end MPQ_RWOPS_WRAPPER_H
+
+//---------------------------------------------------------------------------//
+// end MPQRWopsWrapper.h
+//---------------------------------------------------------------------------//
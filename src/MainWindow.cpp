@@ -11,15 +11,20 @@
 
 // Qt Includes
 #include <QFontDatabase>
+#include <QTimer>
 #include <QtDeclarative/QDeclarativeView>
+#include <QtDeclarative/QDeclarativeComponent>
 
 // QtD1 Includes
 #include "MainWindow.h"
 #include "MainWindowFrontendProxy.h"
 #include "MPQHandler.h"
 #include "AudioDevice.h"
+#include "SoftwareMixer.h"
 #include "BitmapText.h"
 #include "CursorDatabase.h"
+#include "CelPaletteRegistry.h"
+#include "StartupProfiler.h"
 #include "Game.h"
 #include "qtd1_config.h"
 
@@ -38,155 +43,281 @@ MainWindow* MainWindow::getInstance()
 }
 
 // Constructor
+/*! \details The bitmap fonts, the town palette and the cursors are decoded
+ * to QImages in worker threads while the audio device is opened and the menu
+ * sounds are set up (see finishInitialization).
+ */
 MainWindow::MainWindow()
   : QMainWindow(),
-    d_active_widget()
+    d_active_widget(),
+    d_background( NULL ),
+    d_intro_screen( NULL ),
+    d_title_screen( NULL ),
+    d_main_menu( NULL ),
+    d_credits_screen( NULL ),
+    d_multi_player_menu( NULL ),
+    d_single_player_menu( NULL ),
+    d_game( NULL ),
+    d_image_viewer( NULL ),
+    d_menu_music_playing( false ),
+    d_initializer( new ParallelInitializer ),
+    d_created_screens(),
+    d_screens_to_precompile(),
+    d_precompiled_views()
 {
   // Force this to delete when closed
   this->setAttribute( Qt::WA_DeleteOnClose );
   
   // Register the MPQHandler with the file engine system
-  QtD1::MPQHandler::getInstance();
+  {
+    StartupProfiler::ScopedPhase phase( "Register MPQ handler" );
+
+    QtD1::MPQHandler::getInstance();
+  }
+
+  // Decode the qtd1 bitmap fonts and the cursors in worker threads
+  QtD1::BitmapText::addStandardFontTasks( *d_initializer );
+
+  d_initializer->addTask( "Load town palette", &MainWindow::loadTownPalette );
+  d_initializer->addTask( "Load cursors",
+                          &QtD1::CursorDatabase::loadCursors,
+                          QStringList() << "Load town palette" );
+
+  d_initializer->start();
 
   // Open the audio device
-  QtD1::AudioDevice::getInstance().open();
+  {
+    StartupProfiler::ScopedPhase phase( "Open audio device" );
 
-  // Register freemono fonts
-  QFontDatabase::addApplicationFont( FREE_MONO_TTF_PATH );
-  QFontDatabase::addApplicationFont( FREE_MONO_BOLD_TTF_PATH );
-  QFontDatabase::addApplicationFont( FREE_MONO_OBLIQUE_TTF_PATH );
-  QFontDatabase::addApplicationFont( FREE_MONO_BOLD_OBLIQUE_TTF_PATH );
+    QtD1::AudioDevice::getInstance().open();
 
-  // Load qtd1 bitmap fonts
-  QtD1::BitmapText::loadStandardFonts();
+    // Mix the sounds in-process (optional)
+    if( QTD1_ENABLE_SOFTWARE_MIXER )
+      QtD1::SoftwareMixer::getInstance()->enable();
+  }
 
-  // Tell the main window to use the custom UI cursor
-  QtD1::CursorDatabase::getInstance()->setWidgetToManage( this );
-  QtD1::CursorDatabase::getInstance()->activateUICursor();
+  // Register freemono fonts
+  {
+    StartupProfiler::ScopedPhase phase( "Register TTF fonts" );
+
+    QFontDatabase::addApplicationFont( FREE_MONO_TTF_PATH );
+    QFontDatabase::addApplicationFont( FREE_MONO_BOLD_TTF_PATH );
+    QFontDatabase::addApplicationFont( FREE_MONO_OBLIQUE_TTF_PATH );
+    QFontDatabase::addApplicationFont( FREE_MONO_BOLD_OBLIQUE_TTF_PATH );
+  }
 
   // Create the menu item over sound
   d_menu_item_over_sound.setSource( "/sfx/items/titlemov.wav" );
+  d_menu_item_over_sound.setPriority( SoundBank::InterfacePriority );
 
   // Create the menu item click sound
   d_menu_item_click_sound.setSource( "/sfx/items/titlslct.wav" );
+  d_menu_item_click_sound.setPriority( SoundBank::InterfacePriority );
 
   // Create the menu music
   d_menu_music.setSource( "/music/dintro.wav" );
-  d_menu_music_playing = false;
 }
 
 // Destructor
 MainWindow::~MainWindow()
 { /* ... */ }
 
+// Finish the initialization that was started by the constructor
+/*! \details The bitmap fonts must be registered before any qml that uses
+ * them is loaded. The glyph pixmaps and the cursors are created here from the
+ * images that the workers decoded (QPixmaps and QCursors can only be created
+ * on the GUI thread).
+ */
+void MainWindow::finishInitialization()
+{
+  if( !d_initializer )
+    return;
+
+  {
+    StartupProfiler::ScopedPhase phase( "Wait for worker initialization" );
+
+    d_initializer->waitForFinished();
+  }
+
+  d_initializer.reset();
+
+  StartupProfiler::ScopedPhase phase( "Create glyph pixmaps and cursors" );
+
+  // Load qtd1 bitmap fonts (the glyph images have already been decoded)
+  QtD1::BitmapText::loadStandardFonts();
+
+  // Tell the main window to use the custom UI cursor
+  QtD1::CursorDatabase::getInstance()->setWidgetToManage( this );
+  QtD1::CursorDatabase::getInstance()->activateUICursor();
+}
+
+// Load the town palette (run in a worker thread)
+/*! \details The palette registry keeps the palette resident for the
+ * cursors and the town.
+ */
+void MainWindow::loadTownPalette()
+{
+  QtD1::CelPaletteRegistry::getInstance()->getPalette(
+                                               "/levels/towndata/town.pal" );
+}
+
 // Load the widgets
+/*! \details Only the background and the game widget are created. The
+ * other widgets are created when they are first activated.
+ */
 void MainWindow::loadWidgets()
 {
+  this->finishInitialization();
+
+  StartupProfiler::ScopedPhase phase( "Load widgets" );
+
   // Create the background widget
-  QWidget* background = new QWidget( this );
+  d_background = new QWidget( this );
   {
     QPalette palette;
-    palette.setColor( background->backgroundRole(), Qt::black );
-    background->setPalette(palette);
-    background->setFixedSize( 800, 600 );
-    background->show();
+    palette.setColor( d_background->backgroundRole(), Qt::black );
+    d_background->setPalette(palette);
+    d_background->setFixedSize( 800, 600 );
+    d_background->show();
 
-    this->setCentralWidget( background );
+    this->setCentralWidget( d_background );
   }
 
-  // Create the intro screen widget
+  // Create the game widget (the level background is created by worker
+  // threads while the menus are shown)
   {
-    QDeclarativeView* intro_screen_view =
-      new QDeclarativeView( QUrl(INTRO_SCREEN_QML_PATH), background );
+    d_game = Game::getInstance();
+    d_game->setParent( d_background );
+
+    // Connect the main menu quit button to the close slot
+    QObject::connect( d_game->getGameMenu()->engine(), SIGNAL(quit()),
+                      this, SLOT(close()) );
+  }
+}
+
+// Get a widget (the widget will be created if it does not exist yet)
+QWidget* MainWindow::getWidget( QWidget*& widget,
+                                WidgetCreatorPointer widget_creator )
+{
+  if( !widget )
+    widget = (this->*widget_creator)();
+
+  return widget;
+}
+
+// Create a qml view (a precompiled view will be used if there is one)
+/*! \details The view is hidden until it is activated.
+ */
+QDeclarativeView* MainWindow::createView( const QString& qml_path )
+{
+  StartupProfiler::ScopedPhase phase( "Create view " + qml_path );
+
+  QDeclarativeView* view = d_precompiled_views.take( qml_path );
+
+  if( !view )
+    view = new QDeclarativeView( d_background );
+
+  view->setSource( QUrl( qml_path ) );
+  view->hide();
+
+  d_created_screens << qml_path;
+
+  return view;
+}
+
+// Create the intro screen widget
+QWidget* MainWindow::createIntroScreen()
+{
+  QDeclarativeView* intro_screen_view =
+    this->createView( INTRO_SCREEN_QML_PATH );
 
-    MainWindowFrontendProxy::connectToBackend(
+  MainWindowFrontendProxy::connectToBackend(
                                             intro_screen_view,
                                             SIGNAL(introScreenActivated()),
                                             SIGNAL(introScreenDeactivated()) );
 
-    d_intro_screen = intro_screen_view;
-  }
+  return intro_screen_view;
+}
 
-  // Create the title screen widget
-  {
-    QDeclarativeView* title_screen_view =
-      new QDeclarativeView( QUrl(TITLE_SCREEN_QML_PATH), background );
+// Create the title screen widget
+QWidget* MainWindow::createTitleScreen()
+{
+  QDeclarativeView* title_screen_view =
+    this->createView( TITLE_SCREEN_QML_PATH );
 
-    MainWindowFrontendProxy::connectToBackend(
+  MainWindowFrontendProxy::connectToBackend(
                                             title_screen_view,
                                             SIGNAL(titleScreenActivated()),
                                             SIGNAL(titleScreenDeactivated()) );
 
-    d_title_screen = title_screen_view;
-  }
+  return title_screen_view;
+}
 
-  // Create the main menu widget
-  {
-    QDeclarativeView* main_menu_view =
-      new QDeclarativeView( QUrl(MAIN_MENU_QML_PATH), background );
+// Create the main menu widget
+QWidget* MainWindow::createMainMenu()
+{
+  QDeclarativeView* main_menu_view = this->createView( MAIN_MENU_QML_PATH );
 
-    MainWindowFrontendProxy::connectToBackend( main_menu_view,
-                                               SIGNAL(mainMenuActivated()),
-                                               SIGNAL(mainMenuDeactivated()) );
+  MainWindowFrontendProxy::connectToBackend( main_menu_view,
+                                             SIGNAL(mainMenuActivated()),
+                                             SIGNAL(mainMenuDeactivated()) );
 
-    // Connect the main menu quit button to the close slot
-    QObject::connect( main_menu_view->engine(), SIGNAL(quit()),
-                      this, SLOT(close()) );
+  // Connect the main menu quit button to the close slot
+  QObject::connect( main_menu_view->engine(), SIGNAL(quit()),
+                    this, SLOT(close()) );
 
-    d_main_menu = main_menu_view;
-  }
+  return main_menu_view;
+}
 
-  // Create the credits screen widget
-  {
-    QDeclarativeView* credits_screen_view =
-      new QDeclarativeView( QUrl(CREDITS_SCREEN_QML_PATH), background );
+// Create the credits screen widget
+QWidget* MainWindow::createCreditsScreen()
+{
+  QDeclarativeView* credits_screen_view =
+    this->createView( CREDITS_SCREEN_QML_PATH );
 
-    MainWindowFrontendProxy::connectToBackend(
+  MainWindowFrontendProxy::connectToBackend(
                                           credits_screen_view,
                                           SIGNAL(creditsScreenActivated()),
                                           SIGNAL(creditsScreenDeactivated()) );
 
-    d_credits_screen = credits_screen_view;
-  }
+  return credits_screen_view;
+}
 
-  // Create the multi player menu widget
-  d_multi_player_menu = new QWidget( background );
+// Create the multi player menu widget
+QWidget* MainWindow::createMultiPlayerMenu()
+{
+  QWidget* multi_player_menu = new QWidget( d_background );
+  multi_player_menu->hide();
 
-  // Create the single player menu widget
-  {
-    QDeclarativeView* single_player_menu_view =
-      new QDeclarativeView( QUrl(SINGLE_PLAYER_MENU_QML_PATH), background );
+  return multi_player_menu;
+}
 
-    MainWindowFrontendProxy::connectToBackend(
+// Create the single player menu widget
+QWidget* MainWindow::createSinglePlayerMenu()
+{
+  QDeclarativeView* single_player_menu_view =
+    this->createView( SINGLE_PLAYER_MENU_QML_PATH );
+
+  MainWindowFrontendProxy::connectToBackend(
                                        single_player_menu_view,
                                        SIGNAL(singlePlayerMenuActivated()),
                                        SIGNAL(singlePlayerMenuDeactivated()) );
 
-    d_single_player_menu = single_player_menu_view;
-  }
-
-  // Create the game widget
-  {
-    d_game = Game::getInstance();
-    d_game->setParent( background );
-
-    // Connect the main menu quit button to the close slot
-    QObject::connect( d_game->getGameMenu()->engine(), SIGNAL(quit()),
-                      this, SLOT(close()) );
-  }
+  return single_player_menu_view;
+}
 
-  // Create the image viewer widget
-  {
-    QDeclarativeView* image_viewer_view =
-      new QDeclarativeView( QUrl(IMAGE_VIEWER_QML_PATH), background );
+// Create the image viewer widget
+QWidget* MainWindow::createImageViewer()
+{
+  QDeclarativeView* image_viewer_view =
+    this->createView( IMAGE_VIEWER_QML_PATH );
 
-    MainWindowFrontendProxy::connectToBackend(
+  MainWindowFrontendProxy::connectToBackend(
                                             image_viewer_view,
                                             SIGNAL(imageViewerActivated()),
                                             SIGNAL(imageViewerDeactivated()) );
 
-    d_image_viewer = image_viewer_view;
-  }
+  return image_viewer_view;
 }
 
 // Show the main window
@@ -195,15 +326,30 @@ void MainWindow::customShow()
   // This call to show will show all of the child widgets (not what we want)
   this->show();
 
-  // Deactive all of the widgets that we manage separately
-  d_intro_screen->hide();
-  d_title_screen->hide();
-  d_main_menu->hide();
-  d_credits_screen->hide();
-  d_multi_player_menu->hide();
-  d_single_player_menu->hide();
-  d_game->hide();
-  d_image_viewer->hide();
+  // Deactive all of the widgets that we manage separately (the other
+  // widgets have not been created yet)
+  QList<QWidget*> widgets;
+  widgets << d_intro_screen << d_title_screen << d_main_menu
+          << d_credits_screen << d_multi_player_menu << d_single_player_menu
+          << d_game << d_image_viewer;
+
+  QList<QWidget*>::iterator widget_it, widget_end;
+  widget_it = widgets.begin();
+  widget_end = widgets.end();
+
+  while( widget_it != widget_end )
+  {
+    if( *widget_it )
+      (*widget_it)->hide();
+
+    ++widget_it;
+  }
+}
+
+// Check if a screen has been created
+bool MainWindow::isScreenCreated( const QString& qml_path ) const
+{
+  return d_created_screens.contains( qml_path );
 }
 
 // Check if the menu music is playing
@@ -215,7 +361,8 @@ bool MainWindow::isMenuMusicPlaying()
 // Go to the intro screen
 void MainWindow::gotoIntroScreen()
 {
-  this->activateWidget( d_intro_screen,
+  this->activateWidget( this->getWidget( d_intro_screen,
+                                        &MainWindow::createIntroScreen ),
                         &MainWindow::introScreenActivated,
                         &MainWindow::introScreenDeactivated );
 }
@@ -223,7 +370,8 @@ void MainWindow::gotoIntroScreen()
 // Go to the title screen
 void MainWindow::gotoTitleScreen()
 {
-  this->activateWidget( d_title_screen,
+  this->activateWidget( this->getWidget( d_title_screen,
+                                        &MainWindow::createTitleScreen ),
                         &MainWindow::titleScreenActivated,
                         &MainWindow::titleScreenDeactivated );
 }
@@ -231,7 +379,8 @@ void MainWindow::gotoTitleScreen()
 // Go to the main menu
 void MainWindow::gotoMainMenu()
 {
-  this->activateWidget( d_main_menu,
+  this->activateWidget( this->getWidget( d_main_menu,
+                                        &MainWindow::createMainMenu ),
                         &MainWindow::mainMenuActivated,
                         &MainWindow::mainMenuDeactivated );
 }
@@ -239,7 +388,8 @@ void MainWindow::gotoMainMenu()
 // Go to the credits screen
 void MainWindow::gotoCreditsScreen()
 {
-  this->activateWidget( d_credits_screen,
+  this->activateWidget( this->getWidget( d_credits_screen,
+                                        &MainWindow::createCreditsScreen ),
                         &MainWindow::creditsScreenActivated,
                         &MainWindow::creditsScreenDeactivated );
 }
@@ -247,7 +397,8 @@ void MainWindow::gotoCreditsScreen()
 // Go to the multi player menu
 void MainWindow::gotoMultiPlayerMenu()
 {
-  this->activateWidget( d_multi_player_menu,
+  this->activateWidget( this->getWidget( d_multi_player_menu,
+                                        &MainWindow::createMultiPlayerMenu ),
                         &MainWindow::multiPlayerMenuActivated,
                         &MainWindow::multiPlayerMenuDeactivated );
 }
@@ -255,7 +406,8 @@ void MainWindow::gotoMultiPlayerMenu()
 // Go to the single player menu
 void MainWindow::gotoSinglePlayerMenu()
 {
-  this->activateWidget( d_single_player_menu,
+  this->activateWidget( this->getWidget( d_single_player_menu,
+                                        &MainWindow::createSinglePlayerMenu ),
                         &MainWindow::singlePlayerMenuActivated,
                         &MainWindow::singlePlayerMenuDeactivated );
 }
@@ -274,7 +426,8 @@ void MainWindow::gotoGame( const QString& character_name,
 // Go to the image viewer
 void MainWindow::gotoImageViewer()
 {
-  this->activateWidget( d_image_viewer,
+  this->activateWidget( this->getWidget( d_image_viewer,
+                                        &MainWindow::createImageViewer ),
                         &MainWindow::imageViewerActivated,
                         &MainWindow::imageViewerDeactivated );
 }
@@ -331,6 +484,61 @@ void MainWindow::stopMenuMusic()
   d_menu_music_playing = false;
 }
 
+// Compile the qml of the screens that have not been created when idle
+/*! \details One screen is compiled every time that the event loop is idle
+ * so that the active screen stays responsive. The image viewer is a tool so
+ * it is never precompiled.
+ */
+void MainWindow::precompileWidgets()
+{
+  d_screens_to_precompile.clear();
+  d_screens_to_precompile << MAIN_MENU_QML_PATH
+                          << SINGLE_PLAYER_MENU_QML_PATH
+                          << CREDITS_SCREEN_QML_PATH
+                          << INTRO_SCREEN_QML_PATH;
+
+  QTimer::singleShot( 0, this, SLOT(precompileNextWidget()) );
+}
+
+// Compile the qml of the next screen that has not been created
+/*! \details A view is created for the screen and the screen component is
+ * compiled by the view engine (the engine caches the compiled component).
+ * The screen items are only created when the screen is activated.
+ */
+void MainWindow::precompileNextWidget()
+{
+  while( !d_screens_to_precompile.isEmpty() )
+  {
+    const QString qml_path = d_screens_to_precompile.takeFirst();
+
+    if( this->isScreenCreated( qml_path ) ||
+        d_precompiled_views.contains( qml_path ) )
+      continue;
+
+    StartupProfiler::ScopedPhase phase( "Precompile view " + qml_path );
+
+    QDeclarativeView* view = new QDeclarativeView( d_background );
+    view->hide();
+
+    QDeclarativeComponent* component =
+      new QDeclarativeComponent( view->engine(), QUrl( qml_path ), view );
+
+    if( component->isError() )
+    {
+      qWarning( "MainWindow Warning: Could not precompile %s (%s)!",
+                qml_path.toLatin1().data(),
+                component->errorString().toLatin1().data() );
+    }
+
+    d_precompiled_views[qml_path] = view;
+
+    break;
+  }
+
+  if( !d_screens_to_precompile.isEmpty() )
+    QTimer::singleShot( 0, this, SLOT(precompileNextWidget()) );
+}
+
 } // end QtD1 namespace
 
 //---------------------------------------------------------------------------//
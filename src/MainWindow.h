@@ -11,18 +11,30 @@
 
 // Std Lib Includes
 #include <utility>
+#include <memory>
 
 // Qt Includes
 #include <QMainWindow>
+#include <QHash>
+#include <QStringList>
+#include <QtDeclarative/QDeclarativeView>
 
 // QtD1 Includes
 #include "Sound.h"
 #include "Music.h"
 #include "Game.h"
+#include "ParallelInitializer.h"
 
 namespace QtD1{
 
-//! The main window class
+/*! The main window class
+ *
+ * The screens (e.g. the main menu) are only created when they are first
+ * activated. The qml of the screens that have not been created can be
+ * compiled ahead of time while the application is idle (see
+ * precompileWidgets) - the screen items are still only created (and their
+ * assets decoded) when the screen is first activated.
+ */
 class MainWindow : public QMainWindow
 {
   Q_OBJECT
@@ -44,6 +56,9 @@ public:
   //! Check if the menu music is playing
   bool isMenuMusicPlaying();
 
+  //! Check if a screen has been created
+  bool isScreenCreated( const QString& qml_path ) const;
+
 signals:
 
   // These should only be used by the backend
@@ -108,6 +123,14 @@ public slots:
   //! Stop menu music
   void stopMenuMusic();
 
+  //! Compile the qml of the screens that have not been created when idle
+  void precompileWidgets();
+
+private slots:
+
+  // Compile the qml of the next screen that has not been created
+  void precompileNextWidget();
+
 private:
 
   // Typedef for activated signal pointer
@@ -116,9 +139,45 @@ private:
   // Typedef for deactivated signal pointer
   typedef ActivatedSignalPointer DeactivatedSignalPointer;
 
+  // Typedef for widget creator pointer
+  typedef QWidget*(MainWindow::*WidgetCreatorPointer)();
+
   //! Constructor
   MainWindow();
 
+  // Finish the initialization that was started by the constructor
+  void finishInitialization();
+
+  // Load the town palette (run in a worker thread)
+  static void loadTownPalette();
+
+  // Get a widget (the widget will be created if it does not exist yet)
+  QWidget* getWidget( QWidget*& widget, WidgetCreatorPointer widget_creator );
+
+  // Create a qml view (a precompiled view will be used if there is one)
+  QDeclarativeView* createView( const QString& qml_path );
+
+  // Create the intro screen widget
+  QWidget* createIntroScreen();
+
+  // Create the title screen widget
+  QWidget* createTitleScreen();
+
+  // Create the main menu widget
+  QWidget* createMainMenu();
+
+  // Create the credits screen widget
+  QWidget* createCreditsScreen();
+
+  // Create the multi player menu widget
+  QWidget* createMultiPlayerMenu();
+
+  // Create the single player menu widget
+  QWidget* createSinglePlayerMenu();
+
+  // Create the image viewer widget
+  QWidget* createImageViewer();
+
   // Activate the desired widget
   void activateWidget( QWidget* widget,
                        ActivatedSignalPointer activated_signal,
@@ -132,6 +191,9 @@ private:
   // The active widget
   std::pair<QWidget*,DeactivatedSignalPointer> d_active_widget;
 
+  // The background widget (the parent of all screen widgets)
+  QWidget* d_background;
+
   // The intro screen widget
   QWidget* d_intro_screen;
 
@@ -167,6 +229,18 @@ private:
 
   // Tracks if the menu music is playing
   bool d_menu_music_playing;
+
+  // The initializer that decodes the fonts and cursors in worker threads
+  std::unique_ptr<ParallelInitializer> d_initializer;
+
+  // The qml paths of the screens that have been created
+  QStringList d_created_screens;
+
+  // The qml paths of the screens that should be precompiled
+  QStringList d_screens_to_precompile;
+
+  // The precompiled views (not shown until their screens are created)
+  QHash<QString,QDeclarativeView*> d_precompiled_views;
 };
 
 } // end QtD1 namespace
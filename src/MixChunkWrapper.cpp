@@ -58,22 +58,23 @@ MixChunkWrapper::~MixChunkWrapper()
 }
 
 // Load from the desired device
+/*! \details The chunk holds the decoded samples so the file data is only
+ * kept while the chunk is being decoded.
+ */
 void MixChunkWrapper::loadFromDevice( QIODevice& device )
 {
   // Make sure that the defice is open
   device.open( QIODevice::ReadOnly );
   
-  d_raw_chunk_data.resize( device.size() );
-
   // Read the file data
-  device.read( d_raw_chunk_data.data(), d_raw_chunk_data.size() );
+  QByteArray file_data = device.readAll();
 
   // Close the device
   device.close();
 
   // Create the mix chunk
   SDL_RWops* sdl_stream =
-    SDL_RWFromConstMem( d_raw_chunk_data.data(), d_raw_chunk_data.size() );
+    SDL_RWFromConstMem( file_data.constData(), file_data.size() );
 
   d_raw_mix_chunk = Mix_LoadWAV_RW( sdl_stream, true );
   
@@ -11,22 +11,42 @@
 
 // QtD1 Includes
 #include "MixMusicWrapper.h"
+#include "MPQHandler.h"
 
 namespace QtD1{
 
 // Constructor (from file)
+/*! \details Archived files are streamed from the mpq file while they are
+ * played - only a small read-ahead window is kept in memory.
+ */
 MixMusicWrapper::MixMusicWrapper( const QString& filename )
   : d_raw_mix_music( NULL ),
-    d_raw_music_data()
+    d_raw_music_data(),
+    d_mpq_stream()
 {
-  QFile file( filename );
-  this->loadFromDevice( file );
+  if( MPQHandler::getInstance()->doesFileExist( filename ) )
+  {
+    d_mpq_stream.reset( new MPQRWopsWrapper( filename ) );
+
+    d_raw_mix_music =
+      Mix_LoadMUS_RW( d_mpq_stream->getRawRWopsPtr(), false );
+
+    // Make sure the raw mix music pointer != NULL
+    if( d_raw_mix_music == NULL )
+      qFatal( "Error: Could not stream the music file!" );
+  }
+  else
+  {
+    QFile file( filename );
+    this->loadFromDevice( file );
+  }
 }
 
 // Constructor (from device)
 MixMusicWrapper::MixMusicWrapper( QIODevice& device )
   : d_raw_mix_music( NULL ),
-    d_raw_music_data()
+    d_raw_music_data(),
+    d_mpq_stream()
 {
   this->loadFromDevice( device );
 }
@@ -37,7 +57,8 @@ MixMusicWrapper::MixMusicWrapper( QIODevice& device )
  */
 MixMusicWrapper::MixMusicWrapper( const QByteArray& data )
   : d_raw_mix_music( NULL ),
-    d_raw_music_data( data )
+    d_raw_music_data( data ),
+    d_mpq_stream()
 {
   SDL_RWops* sdl_stream =
     SDL_RWFromConstMem( d_raw_music_data.data(), data.size() );
@@ -49,6 +70,8 @@ MixMusicWrapper::MixMusicWrapper( const QByteArray& data )
 }
 
 // Destructor
+/*! \details The music is freed before the mpq stream that it reads from.
+ */
 MixMusicWrapper::~MixMusicWrapper()
 {
   Mix_FreeMusic( d_raw_mix_music );
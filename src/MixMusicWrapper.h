@@ -9,6 +9,9 @@
 #ifndef MIX_MUSIC_WRAPPER_H
 #define MIX_MUSIC_WRAPPER_H
 
+// Std Lib Includes
+#include <memory>
+
 // SDL Includes
 #include <SDL_mixer.h>
 
@@ -17,6 +20,9 @@
 #include <QByteArray>
 #include <QIODevice>
 
+// QtD1 Includes
+#include "MPQRWopsWrapper.h"
+
 namespace QtD1{
 
 /*! The Mix_Music wrapper
@@ -61,6 +67,9 @@ private:
 
   // The raw music data (may be empty depending on constructor used)
   QByteArray d_raw_music_data;
+
+  // The mpq stream (only used with archived files)
+  std::unique_ptr<MPQRWopsWrapper> d_mpq_stream;
 };
   
 } // end QtD1 namespace
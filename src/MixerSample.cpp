@@ -0,0 +1,143 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MixerSample.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The mixer sample class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <stdexcept>
+#include <cstring>
+
+// Qt Includes
+#include <QFile>
+#include <QByteArray>
+
+// QtD1 Includes
+#include "MixerSample.h"
+
+namespace QtD1{
+
+// Constructor (from wav file)
+/*! \details If the file cannot be decoded or converted a std::exception
+ * will be thrown.
+ */
+MixerSample::MixerSample( const QString& source,
+                          const int frequency,
+                          const int number_of_channels )
+  : d_samples(),
+    d_number_of_channels( number_of_channels )
+{
+  QFile file( source );
+
+  if( !file.open( QIODevice::ReadOnly ) )
+  {
+    throw std::runtime_error( "Could not open sound file " +
+                              source.toStdString() + "!" );
+  }
+
+  // The file data is only kept while the sample is being decoded
+  QByteArray file_data = file.readAll();
+
+  file.close();
+
+  SDL_AudioSpec file_spec;
+  Uint8* file_samples;
+  Uint32 file_samples_size;
+
+  if( SDL_LoadWAV_RW( SDL_RWFromConstMem( file_data.constData(),
+                                          file_data.size() ),
+                      true,
+                      &file_spec,
+                      &file_samples,
+                      &file_samples_size ) == NULL )
+  {
+    throw std::runtime_error( "Could not decode sound file " +
+                              source.toStdString() + " (" +
+                              SDL_GetError() + ")!" );
+  }
+
+  SDL_AudioCVT converter;
+
+  if( SDL_BuildAudioCVT( &converter,
+                         file_spec.format,
+                         file_spec.channels,
+                         file_spec.freq,
+                         AUDIO_S16SYS,
+                         number_of_channels,
+                         frequency ) < 0 )
+  {
+    SDL_FreeWAV( file_samples );
+
+    throw std::runtime_error( "Could not convert sound file " +
+                              source.toStdString() + " (" +
+                              SDL_GetError() + ")!" );
+  }
+
+  // The conversion is done in place
+  QByteArray converted_samples( file_samples_size*converter.len_mult, 0 );
+
+  memcpy( converted_samples.data(), file_samples, file_samples_size );
+
+  SDL_FreeWAV( file_samples );
+
+  converter.buf = (Uint8*)converted_samples.data();
+  converter.len = file_samples_size;
+
+  if( converter.needed )
+  {
+    if( SDL_ConvertAudio( &converter ) < 0 )
+    {
+      throw std::runtime_error( "Could not convert sound file " +
+                                source.toStdString() + " (" +
+                                SDL_GetError() + ")!" );
+    }
+  }
+  else
+    converter.len_cvt = file_samples_size;
+
+  const int number_of_frames =
+    converter.len_cvt/(sizeof(Sint16)*number_of_channels);
+
+  d_samples.resize( number_of_frames*number_of_channels );
+
+  memcpy( d_samples.data(),
+          converted_samples.constData(),
+          d_samples.size()*sizeof(Sint16) );
+}
+
+// Constructor (from converted samples)
+/*! \details A trailing partial frame is dropped.
+ */
+MixerSample::MixerSample( const QVector<Sint16>& samples,
+                          const int number_of_channels )
+  : d_samples( samples ),
+    d_number_of_channels( number_of_channels )
+{
+  d_samples.resize( d_samples.size() - d_samples.size()%number_of_channels );
+}
+
+// Get the number of channels
+int MixerSample::getNumberOfChannels() const
+{
+  return d_number_of_channels;
+}
+
+// Get the number of frames
+int MixerSample::getNumberOfFrames() const
+{
+  return d_samples.size()/d_number_of_channels;
+}
+
+// Get the samples
+const Sint16* MixerSample::getSamples() const
+{
+  return d_samples.constData();
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end MixerSample.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,74 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MixerSample.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The mixer sample class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef MIXER_SAMPLE_H
+#define MIXER_SAMPLE_H
+
+// SDL Includes
+#include <SDL_audio.h>
+
+// Qt Includes
+#include <QString>
+#include <QVector>
+
+namespace QtD1{
+
+/*! The mixer sample
+ * \details A decoded sound that has been converted to the software mixer
+ * format (16-bit samples at the mixer frequency with interleaved
+ * channels). The conversion (including the sample rate conversion) is only
+ * done once - the sample should be cached (see SoundBank::getSample).
+ */
+class MixerSample
+{
+
+public:
+
+  //! Constructor (from wav file)
+  MixerSample( const QString& source,
+               const int frequency,
+               const int number_of_channels );
+
+  //! Constructor (from converted samples)
+  MixerSample( const QVector<Sint16>& samples,
+               const int number_of_channels );
+
+  //! Destructor
+  ~MixerSample()
+  { /* ... */ }
+
+  //! Get the number of channels
+  int getNumberOfChannels() const;
+
+  //! Get the number of frames
+  int getNumberOfFrames() const;
+
+  //! Get the samples
+  const Sint16* getSamples() const;
+
+private:
+
+  // Constructors and assignment operator
+  MixerSample();
+  MixerSample( const MixerSample& that );
+  MixerSample& operator=( const MixerSample& that );
+
+  // The samples
+  QVector<Sint16> d_samples;
+
+  // The number of channels
+  int d_number_of_channels;
+};
+
+} // end QtD1 namespace
+
+#endif // end MIXER_SAMPLE_H
+
+//---------------------------------------------------------------------------//
+// end MixerSample.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MonsterRenderer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The monster renderer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QPainter>
+
+// QtD1 Includes
+#include "MonsterRenderer.h"
+#include "Telemetry.h"
+
+namespace QtD1{
+
+// Constructor
+MonsterRenderProxy::MonsterRenderProxy( QGraphicsItem* parent )
+  : QGraphicsItem( parent ),
+    d_frame( NULL )
+{ /* ... */ }
+
+// Set the frame (can be NULL)
+void MonsterRenderProxy::setFrame( const QPixmap* frame )
+{
+  if( frame != d_frame )
+  {
+    if( !frame || !d_frame || frame->size() != d_frame->size() )
+      this->prepareGeometryChange();
+
+    d_frame = frame;
+
+    this->update();
+  }
+}
+
+// Get the bounding rect of the proxy
+QRectF MonsterRenderProxy::boundingRect() const
+{
+  if( d_frame )
+  {
+    return QRectF( -d_frame->width()/2.0,
+                   -d_frame->height()/2.0,
+                   d_frame->width(),
+                   d_frame->height() );
+  }
+  else
+    return QRectF();
+}
+
+// Paint the frame
+void MonsterRenderProxy::paint( QPainter* painter,
+                                const QStyleOptionGraphicsItem*,
+                                QWidget* )
+{
+  Telemetry::ScopedTimer paint_timer( Telemetry::MonsterPaintTimeHistogram );
+
+  if( d_frame )
+  {
+    painter->drawPixmap( QPointF( -d_frame->width()/2.0,
+                                  -d_frame->height()/2.0 ),
+                         *d_frame );
+  }
+}
+
+// Constructor
+MonsterRenderer::MonsterRenderer( QGraphicsScene* scene )
+  : d_scene( scene ),
+    d_sprites(),
+    d_proxies(),
+    d_number_of_published_monsters( 0 ),
+    d_visible_monster_ids()
+{
+  if( !scene )
+    qFatal( "MonsterRenderer Error: The scene cannot be NULL!" );
+}
+
+// Set the sprite frames of a monster type state and direction
+void MonsterRenderer::setSprite( const int type,
+                                 const Actor::State state,
+                                 const Direction direction,
+                                 const QVector<QPixmap>& frames )
+{
+  if( frames.empty() )
+    qFatal( "MonsterRenderer Error: A sprite must have at least one frame!" );
+
+  d_sprites[MonsterRenderer::getSpriteKey( type, state, direction )] = frames;
+}
+
+// Check if a sprite has been set
+bool MonsterRenderer::hasSprite( const int type,
+                                 const Actor::State state,
+                                 const Direction direction ) const
+{
+  return d_sprites.contains(
+                   MonsterRenderer::getSpriteKey( type, state, direction ) );
+}
+
+// Remove all sprites
+/*! \details The published monsters will not be drawn until the next publish.
+ */
+void MonsterRenderer::clearSprites()
+{
+  for( int i = 0; i < d_proxies.size(); ++i )
+    d_proxies[i]->setFrame( NULL );
+
+  d_sprites.clear();
+}
+
+// Publish the visible monsters (returns # published)
+/*! \details Each visible monster is assigned a proxy that is moved to the
+ * monster position and shows the current frame of the monster sprite. The
+ * visible monsters are found with a linear scan of the monster positions
+ * (see MonsterStore::getMonstersInRect), so a publish is O(N) in the number
+ * of monsters in the level. Only the proxies of the visible monsters are
+ * touched, so the scene graph work depends on the visible monsters alone.
+ */
+int MonsterRenderer::publish( const MonsterStore& monster_store,
+                              const QRectF& visible_rect )
+{
+  d_visible_monster_ids.clear();
+
+  monster_store.getMonstersInRect( visible_rect, d_visible_monster_ids );
+
+  while( d_proxies.size() < d_visible_monster_ids.size() )
+  {
+    MonsterRenderProxy* proxy = new MonsterRenderProxy;
+
+    d_scene->addItem( proxy );
+
+    d_proxies << proxy;
+  }
+
+  for( int i = 0; i < d_visible_monster_ids.size(); ++i )
+  {
+    const int monster_id = d_visible_monster_ids[i];
+
+    QHash<int,QVector<QPixmap> >::const_iterator sprite_it =
+      d_sprites.find( MonsterRenderer::getSpriteKey(
+                                 monster_store.getType( monster_id ),
+                                 monster_store.getState( monster_id ),
+                                 monster_store.getDirection( monster_id ) ) );
+
+    MonsterRenderProxy* proxy = d_proxies[i];
+
+    if( sprite_it != d_sprites.end() )
+    {
+      const QVector<QPixmap>& frames = sprite_it.value();
+
+      proxy->setFrame(
+           &frames[monster_store.getFrame( monster_id ) % frames.size()] );
+    }
+    else
+      proxy->setFrame( NULL );
+
+    proxy->setPos( monster_store.getPosition( monster_id ) );
+    proxy->show();
+  }
+
+  for( int i = d_visible_monster_ids.size();
+       i < d_number_of_published_monsters;
+       ++i )
+    d_proxies[i]->hide();
+
+  d_number_of_published_monsters = d_visible_monster_ids.size();
+
+  return d_number_of_published_monsters;
+}
+
+// Get the number of published monsters
+int MonsterRenderer::getNumberOfPublishedMonsters() const
+{
+  return d_number_of_published_monsters;
+}
+
+// Get the number of render proxies (published and hidden)
+int MonsterRenderer::getNumberOfProxies() const
+{
+  return d_proxies.size();
+}
+
+// Get the sprite key
+int MonsterRenderer::getSpriteKey( const int type,
+                                   const Actor::State state,
+                                   const Direction direction )
+{
+  return (type*(Actor::Dead+1) + state)*16 + direction;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end MonsterRenderer.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,130 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MonsterRenderer.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The monster renderer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef MONSTER_RENDERER_H
+#define MONSTER_RENDERER_H
+
+// Qt Includes
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QHash>
+#include <QVector>
+#include <QPixmap>
+
+// QtD1 Includes
+#include "MonsterStore.h"
+
+namespace QtD1{
+
+/*! The monster render proxy
+ *
+ * A lightweight scene item that paints a single sprite frame centered on
+ * its position. The proxies are owned by the scene.
+ */
+class MonsterRenderProxy : public QGraphicsItem
+{
+
+public:
+
+  //! Constructor
+  MonsterRenderProxy( QGraphicsItem* parent = 0 );
+
+  //! Destructor
+  ~MonsterRenderProxy()
+  { /* ... */ }
+
+  //! Set the frame (can be NULL)
+  void setFrame( const QPixmap* frame );
+
+  //! Get the bounding rect of the proxy
+  QRectF boundingRect() const override;
+
+  //! Paint the frame
+  void paint( QPainter* painter,
+              const QStyleOptionGraphicsItem* option,
+              QWidget* widget ) override;
+
+private:
+
+  // The frame
+  const QPixmap* d_frame;
+};
+
+/*! The monster renderer
+ *
+ * The renderer publishes the monsters of a monster store that are inside of
+ * the visible rect as render proxies. The proxies are pooled - they are only
+ * created when more monsters are visible than ever before and unused
+ * proxies are hidden.
+ */
+class MonsterRenderer
+{
+
+public:
+
+  //! Constructor
+  MonsterRenderer( QGraphicsScene* scene );
+
+  //! Destructor
+  ~MonsterRenderer()
+  { /* ... */ }
+
+  //! Set the sprite frames of a monster type state and direction
+  void setSprite( const int type,
+                  const Actor::State state,
+                  const Direction direction,
+                  const QVector<QPixmap>& frames );
+
+  //! Check if a sprite has been set
+  bool hasSprite( const int type,
+                  const Actor::State state,
+                  const Direction direction ) const;
+
+  //! Remove all sprites
+  void clearSprites();
+
+  //! Publish the visible monsters (returns # published)
+  int publish( const MonsterStore& monster_store,
+               const QRectF& visible_rect );
+
+  //! Get the number of published monsters
+  int getNumberOfPublishedMonsters() const;
+
+  //! Get the number of render proxies (published and hidden)
+  int getNumberOfProxies() const;
+
+private:
+
+  // Get the sprite key
+  static int getSpriteKey( const int type,
+                           const Actor::State state,
+                           const Direction direction );
+
+  // The scene
+  QGraphicsScene* d_scene;
+
+  // The sprites
+  QHash<int,QVector<QPixmap> > d_sprites;
+
+  // The render proxies
+  QVector<MonsterRenderProxy*> d_proxies;
+
+  // The number of published monsters
+  int d_number_of_published_monsters;
+
+  // The visible monster ids (reused between publishes)
+  QVector<int> d_visible_monster_ids;
+};
+
+} // end QtD1 namespace
+
+#endif // end MONSTER_RENDERER_H
+
+//---------------------------------------------------------------------------//
+// end MonsterRenderer.h
+//---------------------------------------------------------------------------//
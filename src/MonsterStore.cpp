@@ -0,0 +1,563 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MonsterStore.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The monster store class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cmath>
+#include <algorithm>
+
+// Qt Includes
+#include <qmath.h>
+
+// QtD1 Includes
+#include "MonsterStore.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int MonsterStore::s_no_monster;
+const int MonsterStore::s_default_capacity;
+const int MonsterStore::s_recoil_duration;
+const int MonsterStore::s_dying_duration;
+
+// Get the default monster type table
+/*! \details The table holds the monsters of the first cathedral levels.
+ */
+const QVector<MonsterStore::MonsterType>&
+MonsterStore::getDefaultMonsterTypes()
+{
+  static QVector<MonsterType> monster_types;
+
+  if( monster_types.empty() )
+  {
+    const MonsterType default_monster_types[] = {
+      {"Zombie", "/monsters/zombie/zombie", 4, 7, 5, 10, 2, 5, 1.0, 256.0, 48.0, 12},
+      {"Ghoul", "/monsters/zombie/zombie", 7, 11, 10, 20, 3, 10, 1.0, 256.0, 48.0, 12},
+      {"Rotting Carcass", "/monsters/zombie/zombie", 15, 25, 15, 25, 5, 15, 1.0, 256.0, 48.0, 12},
+      {"Fallen One", "/monsters/falspear/phall", 1, 4, 0, 15, 1, 3, 2.0, 320.0, 48.0, 10},
+      {"Skeleton", "/monsters/skelaxe/sklax", 2, 4, 0, 20, 1, 4, 1.5, 320.0, 48.0, 10},
+      {"Scavenger", "/monsters/scav/scav", 3, 6, 10, 20, 1, 5, 2.0, 320.0, 48.0, 10}
+    };
+
+    const int number_of_types =
+      sizeof(default_monster_types)/sizeof(default_monster_types[0]);
+
+    for( int i = 0; i < number_of_types; ++i )
+      monster_types << default_monster_types[i];
+  }
+
+  return monster_types;
+}
+
+// Constructor
+MonsterStore::MonsterStore( const int capacity )
+  : d_monster_types( MonsterStore::getDefaultMonsterTypes() ),
+    d_seed( 0 ),
+    d_size( 0 ),
+    d_type(),
+    d_x(),
+    d_y(),
+    d_health(),
+    d_state(),
+    d_direction(),
+    d_frame(),
+    d_state_ticks(),
+    d_id(),
+    d_index(),
+    d_free_ids()
+{
+  if( capacity < 1 )
+  {
+    qFatal( "MonsterStore Error: Invalid capacity (%i)!", capacity );
+  }
+
+  while( this->getCapacity() < capacity )
+    this->grow();
+}
+
+// Set the monster type table
+/*! \details All monsters will be despawned (their types refer to the old
+ * table).
+ */
+void MonsterStore::setMonsterTypes( const QVector<MonsterType>& monster_types )
+{
+  this->clear();
+
+  d_monster_types = monster_types;
+}
+
+// Get the monster type table
+const QVector<MonsterStore::MonsterType>& MonsterStore::getMonsterTypes() const
+{
+  return d_monster_types;
+}
+
+// Find a monster type by name (returns -1 if not found)
+int MonsterStore::findMonsterType( const QString& name ) const
+{
+  for( int i = 0; i < d_monster_types.size(); ++i )
+  {
+    if( d_monster_types[i].name == name )
+      return i;
+  }
+
+  return -1;
+}
+
+// Set the random number generator seed
+void MonsterStore::setSeed( const quint32 seed )
+{
+  d_seed = seed;
+}
+
+// Spawn a monster (returns the monster id)
+/*! \details The store will only allocate memory if it is full.
+ */
+int MonsterStore::spawn( const int type, const QPointF& position )
+{
+  if( type < 0 || type >= d_monster_types.size() )
+    qFatal( "MonsterStore Error: Invalid monster type (%i)!", type );
+
+  if( d_free_ids.empty() )
+    this->grow();
+
+  const int monster_id = d_free_ids.back();
+  d_free_ids.pop_back();
+
+  const MonsterType& monster_type = d_monster_types[type];
+
+  const int index = d_size++;
+
+  d_type[index] = type;
+  d_x[index] = position.x();
+  d_y[index] = position.y();
+  d_health[index] = monster_type.min_health +
+    this->random( monster_type.max_health - monster_type.min_health + 1 );
+  d_state[index] = Actor::Standing;
+  d_direction[index] = South;
+  d_frame[index] = 0;
+  d_state_ticks[index] = 0;
+  d_id[index] = monster_id;
+  d_index[monster_id] = index;
+
+  return monster_id;
+}
+
+// Spawn monsters on random walkable tiles (returns # spawned)
+/*! \details The walkable tiles are gathered in a single pass over the grid
+ * flags. A monster type is chosen randomly from the types for each monster.
+ */
+int MonsterStore::populate( const LevelGrid& grid,
+                            const QVector<int>& types,
+                            const int number_of_monsters )
+{
+  if( types.empty() )
+    qFatal( "MonsterStore Error: At least one monster type is required!" );
+
+  QVector<int> walkable_tiles;
+  walkable_tiles.reserve( grid.getNumberOfTiles() );
+
+  const quint8* flags = grid.getRawFlags();
+
+  for( int i = 0; i < grid.getNumberOfTiles(); ++i )
+  {
+    if( !(flags[i] & LevelGrid::BlocksWalking) )
+      walkable_tiles << i;
+  }
+
+  if( walkable_tiles.empty() )
+    return 0;
+
+  for( int i = 0; i < number_of_monsters; ++i )
+  {
+    const int tile = walkable_tiles[this->random( walkable_tiles.size() )];
+
+    this->spawn( types[this->random( types.size() )],
+                 grid.mapFromTileCenter( QPoint( tile % grid.getWidth(),
+                                                 tile / grid.getWidth() ) ) );
+  }
+
+  return number_of_monsters;
+}
+
+// Despawn a monster
+void MonsterStore::despawn( const int monster_id )
+{
+  this->removeAt( this->getIndex( monster_id ) );
+}
+
+// Despawn all monsters
+void MonsterStore::clear()
+{
+  while( d_size > 0 )
+    this->removeAt( d_size - 1 );
+}
+
+// Check if a monster id refers to a spawned monster
+bool MonsterStore::isSpawned( const int monster_id ) const
+{
+  if( monster_id >= 0 && monster_id < d_index.size() )
+    return d_index[monster_id] >= 0;
+  else
+    return false;
+}
+
+// Get the number of spawned monsters
+int MonsterStore::getNumberOfMonsters() const
+{
+  return d_size;
+}
+
+// Get the capacity (the store grows if it is exceeded)
+int MonsterStore::getCapacity() const
+{
+  return d_id.size();
+}
+
+// Get the id of the monster stored at an index
+/*! \details The spawned monsters are stored at indices [0,n). The index of a
+ * monster can change when another monster is despawned.
+ */
+int MonsterStore::getMonsterId( const int index ) const
+{
+  return d_id[index];
+}
+
+// Get the type of a monster
+int MonsterStore::getType( const int monster_id ) const
+{
+  return d_type[this->getIndex( monster_id )];
+}
+
+// Get the position of a monster
+QPointF MonsterStore::getPosition( const int monster_id ) const
+{
+  const int index = this->getIndex( monster_id );
+
+  return QPointF( d_x[index], d_y[index] );
+}
+
+// Get the health of a monster
+int MonsterStore::getHealth( const int monster_id ) const
+{
+  return d_health[this->getIndex( monster_id )];
+}
+
+// Get the state of a monster
+Actor::State MonsterStore::getState( const int monster_id ) const
+{
+  return (Actor::State)d_state[this->getIndex( monster_id )];
+}
+
+// Get the direction of a monster
+Direction MonsterStore::getDirection( const int monster_id ) const
+{
+  return (Direction)d_direction[this->getIndex( monster_id )];
+}
+
+// Get the animation frame of a monster
+int MonsterStore::getFrame( const int monster_id ) const
+{
+  return d_frame[this->getIndex( monster_id )];
+}
+
+// Damage a monster (returns true if the monster was killed)
+/*! \details Monsters that are dying or dead cannot be damaged.
+ */
+bool MonsterStore::applyDamage( const int monster_id, const int damage )
+{
+  const int index = this->getIndex( monster_id );
+
+  if( d_state[index] == Actor::Dying || d_state[index] == Actor::Dead )
+    return false;
+
+  d_health[index] -= std::max( damage, 0 );
+
+  if( d_health[index] <= 0 )
+  {
+    d_health[index] = 0;
+
+    this->setStateAt( index, Actor::Dying, s_dying_duration );
+
+    return true;
+  }
+  else
+  {
+    this->setStateAt( index, Actor::RecoilingFromHit, s_recoil_duration );
+
+    return false;
+  }
+}
+
+// Get the living monsters inside of a circle
+void MonsterStore::getMonstersInRadius( const QPointF& center,
+                                        const qreal radius,
+                                        QVector<int>& monster_ids ) const
+{
+  const qreal radius_squared = radius*radius;
+
+  for( int i = 0; i < d_size; ++i )
+  {
+    if( d_state[i] == Actor::Dying || d_state[i] == Actor::Dead )
+      continue;
+
+    const qreal dx = d_x[i] - center.x();
+    const qreal dy = d_y[i] - center.y();
+
+    if( dx*dx + dy*dy <= radius_squared )
+      monster_ids << d_id[i];
+  }
+}
+
+// Get the monsters inside of a rect
+/*! \details Dead monsters are included (their corpses are still drawn).
+ */
+void MonsterStore::getMonstersInRect( const QRectF& rect,
+                                      QVector<int>& monster_ids ) const
+{
+  const qreal left = rect.left();
+  const qreal right = rect.right();
+  const qreal top = rect.top();
+  const qreal bottom = rect.bottom();
+
+  for( int i = 0; i < d_size; ++i )
+  {
+    if( d_x[i] >= left && d_x[i] <= right &&
+        d_y[i] >= top && d_y[i] <= bottom )
+      monster_ids << d_id[i];
+  }
+}
+
+// Advance all monsters by a simulation tick (returns damage to target)
+/*! \details Every monster is updated in a single pass. A monster that sees
+ * the target walks towards it (unless the next tile is not walkable) and
+ * attacks it once it is in range. The damage of the attacks that land
+ * during this tick is returned - the chance to hit is reduced by the target
+ * armor class (but never falls below 15%).
+ */
+int MonsterStore::advance( const QPointF& target_position,
+                           const int target_armor_class,
+                           const LevelGrid* grid )
+{
+  int target_damage = 0;
+
+  for( int i = 0; i < d_size; ++i )
+  {
+    const Actor::State state = (Actor::State)d_state[i];
+
+    if( state == Actor::Dead )
+      continue;
+
+    const MonsterType& monster_type = d_monster_types[d_type[i]];
+
+    ++d_frame[i];
+
+    switch( state )
+    {
+      case Actor::Dying:
+      {
+        if( --d_state_ticks[i] <= 0 )
+          this->setStateAt( i, Actor::Dead, 0 );
+
+        break;
+      }
+      case Actor::RecoilingFromHit:
+      {
+        if( --d_state_ticks[i] <= 0 )
+          this->setStateAt( i, Actor::Standing, 0 );
+
+        break;
+      }
+      case Actor::Attacking:
+      {
+        if( --d_state_ticks[i] <= 0 )
+        {
+          const int chance_to_hit =
+            std::max( monster_type.to_hit - target_armor_class, 15 );
+
+          if( this->random( 100 ) < chance_to_hit )
+          {
+            target_damage += monster_type.min_damage +
+              this->random( monster_type.max_damage -
+                            monster_type.min_damage + 1 );
+          }
+
+          this->setStateAt( i, Actor::Standing, 0 );
+        }
+
+        break;
+      }
+      default:
+      {
+        const qreal dx = target_position.x() - d_x[i];
+        const qreal dy = target_position.y() - d_y[i];
+        const qreal distance_squared = dx*dx + dy*dy;
+
+        if( distance_squared <=
+            monster_type.attack_range*monster_type.attack_range )
+        {
+          d_direction[i] = MonsterStore::getDirectionOfDisplacement( dx, dy );
+
+          this->setStateAt( i, Actor::Attacking, monster_type.attack_duration );
+        }
+        else if( distance_squared <=
+                 monster_type.sight_radius*monster_type.sight_radius )
+        {
+          const qreal distance = std::sqrt( distance_squared );
+          const qreal x = d_x[i] + monster_type.walk_speed*dx/distance;
+          const qreal y = d_y[i] + monster_type.walk_speed*dy/distance;
+
+          bool blocked = false;
+
+          if( grid )
+          {
+            const QPoint tile = grid->mapToTile( QPointF( x, y ) );
+
+            blocked = !grid->isInside( tile.x(), tile.y() ) ||
+              !grid->isWalkable( tile.x(), tile.y() );
+          }
+
+          d_direction[i] = MonsterStore::getDirectionOfDisplacement( dx, dy );
+
+          if( blocked )
+          {
+            if( state != Actor::Standing )
+              this->setStateAt( i, Actor::Standing, 0 );
+          }
+          else
+          {
+            d_x[i] = x;
+            d_y[i] = y;
+
+            if( state != Actor::Walking )
+              this->setStateAt( i, Actor::Walking, 0 );
+          }
+        }
+        else if( state != Actor::Standing )
+          this->setStateAt( i, Actor::Standing, 0 );
+      }
+    }
+  }
+
+  return target_damage;
+}
+
+// Get the direction from a displacement
+/*! \details The displacement is in level coordinates (south is +y).
+ */
+Direction MonsterStore::getDirectionOfDisplacement( const qreal dx,
+                                                    const qreal dy )
+{
+  // The angle from south, increasing towards west
+  const qreal angle = std::atan2( -dx, dy );
+
+  int direction = (int)std::floor( angle/(2*M_PI/16) + 0.5 );
+
+  if( direction < 0 )
+    direction += 16;
+
+  return (Direction)(direction % 16);
+}
+
+// Grow the storage
+/*! \details The capacity is doubled. The new ids are pushed onto the free id
+ * stack in reverse so that the lowest ids are used first.
+ */
+void MonsterStore::grow()
+{
+  const int old_capacity = this->getCapacity();
+  const int new_capacity = std::max( 2*old_capacity, 1 );
+
+  d_type.resize( new_capacity );
+  d_x.resize( new_capacity );
+  d_y.resize( new_capacity );
+  d_health.resize( new_capacity );
+  d_state.resize( new_capacity );
+  d_direction.resize( new_capacity );
+  d_frame.resize( new_capacity );
+  d_state_ticks.resize( new_capacity );
+  d_id.resize( new_capacity );
+  d_index.resize( new_capacity );
+
+  d_free_ids.reserve( new_capacity );
+
+  for( int i = new_capacity - 1; i >= old_capacity; --i )
+  {
+    d_index[i] = -1;
+    d_free_ids << i;
+  }
+}
+
+// Remove the monster stored at an index
+void MonsterStore::removeAt( const int index )
+{
+  const int last_index = d_size - 1;
+
+  d_index[d_id[index]] = -1;
+  d_free_ids << d_id[index];
+
+  if( index != last_index )
+  {
+    d_type[index] = d_type[last_index];
+    d_x[index] = d_x[last_index];
+    d_y[index] = d_y[last_index];
+    d_health[index] = d_health[last_index];
+    d_state[index] = d_state[last_index];
+    d_direction[index] = d_direction[last_index];
+    d_frame[index] = d_frame[last_index];
+    d_state_ticks[index] = d_state_ticks[last_index];
+    d_id[index] = d_id[last_index];
+
+    d_index[d_id[index]] = index;
+  }
+
+  --d_size;
+}
+
+// Get the index of a monster
+int MonsterStore::getIndex( const int monster_id ) const
+{
+  if( !this->isSpawned( monster_id ) )
+  {
+    qFatal( "MonsterStore Error: Monster %i has not been spawned!",
+            monster_id );
+  }
+
+  return d_index[monster_id];
+}
+
+// Generate a random number in [0,range)
+/*! \details The linear congruential generator of the original game is
+ * used.
+ */
+int MonsterStore::random( const int range )
+{
+  d_seed = d_seed*0x015A4E35 + 1;
+
+  if( range <= 0 )
+    return 0;
+  else
+    return (int)((d_seed >> 16) % (quint32)range);
+}
+
+// Set the state of the monster stored at an index
+/*! \details The animation restarts when the state changes.
+ */
+void MonsterStore::setStateAt( const int index,
+                               const Actor::State state,
+                               const int state_duration )
+{
+  d_state[index] = state;
+  d_state_ticks[index] = state_duration;
+  d_frame[index] = 0;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end MonsterStore.cpp
+//---------------------------------------------------------------------------//
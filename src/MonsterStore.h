@@ -0,0 +1,239 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MonsterStore.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The monster store class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef MONSTER_STORE_H
+#define MONSTER_STORE_H
+
+// Qt Includes
+#include <QVector>
+#include <QString>
+#include <QPointF>
+#include <QRectF>
+
+// QtD1 Includes
+#include "Actor.h"
+#include "Direction.h"
+#include "LevelGrid.h"
+
+namespace QtD1{
+
+/*! The monster store
+ *
+ * The monsters of a level are simulated in a compact store instead of as
+ * individual actors (an actor is a scene item with its own data object and
+ * signals, which is far too heavy for the hundreds of monsters of a dungeon
+ * level). The monster components are stored in dense parallel arrays and
+ * the AI, animation and combat of every monster are updated in a single
+ * pass each simulation tick. The monster stats come from a type table that
+ * is shared by all monsters of a type. Nothing is put in the scene - the
+ * monster renderer publishes the visible monsters as render proxies.
+ *
+ * Monsters are referred to by id. The ids of despawned monsters are
+ * recycled, so an id must not be used after its monster has been despawned.
+ */
+class MonsterStore
+{
+
+public:
+
+  //! The monster type stats
+  struct MonsterType{
+    //! The name
+    QString name;
+    //! The sprite asset path prefix (the state suffix is appended)
+    QString sprite_prefix;
+    //! The min health
+    int min_health;
+    //! The max health
+    int max_health;
+    //! The armor class
+    int armor_class;
+    //! The chance to hit (percent)
+    int to_hit;
+    //! The min damage
+    int min_damage;
+    //! The max damage
+    int max_damage;
+    //! The walk speed (pixels per simulation tick)
+    qreal walk_speed;
+    //! The sight radius (pixels)
+    qreal sight_radius;
+    //! The attack range (pixels)
+    qreal attack_range;
+    //! The attack duration (simulation ticks)
+    int attack_duration;
+  };
+
+  //! The id returned when there is no monster
+  static const int s_no_monster = -1;
+
+  //! The default capacity
+  static const int s_default_capacity = 256;
+
+  //! The number of ticks that a monster recoils from a hit
+  static const int s_recoil_duration = 6;
+
+  //! The number of ticks that a monster takes to die
+  static const int s_dying_duration = 16;
+
+  //! Get the default monster type table
+  static const QVector<MonsterType>& getDefaultMonsterTypes();
+
+  //! Constructor
+  MonsterStore( const int capacity = s_default_capacity );
+
+  //! Destructor
+  ~MonsterStore()
+  { /* ... */ }
+
+  //! Set the monster type table
+  void setMonsterTypes( const QVector<MonsterType>& monster_types );
+
+  //! Get the monster type table
+  const QVector<MonsterType>& getMonsterTypes() const;
+
+  //! Find a monster type by name (returns -1 if not found)
+  int findMonsterType( const QString& name ) const;
+
+  //! Set the random number generator seed
+  void setSeed( const quint32 seed );
+
+  //! Spawn a monster (returns the monster id)
+  int spawn( const int type, const QPointF& position );
+
+  //! Spawn monsters on random walkable tiles (returns # spawned)
+  int populate( const LevelGrid& grid,
+                const QVector<int>& types,
+                const int number_of_monsters );
+
+  //! Despawn a monster
+  void despawn( const int monster_id );
+
+  //! Despawn all monsters
+  void clear();
+
+  //! Check if a monster id refers to a spawned monster
+  bool isSpawned( const int monster_id ) const;
+
+  //! Get the number of spawned monsters
+  int getNumberOfMonsters() const;
+
+  //! Get the capacity (the store grows if it is exceeded)
+  int getCapacity() const;
+
+  //! Get the id of the monster stored at an index
+  int getMonsterId( const int index ) const;
+
+  //! Get the type of a monster
+  int getType( const int monster_id ) const;
+
+  //! Get the position of a monster
+  QPointF getPosition( const int monster_id ) const;
+
+  //! Get the health of a monster
+  int getHealth( const int monster_id ) const;
+
+  //! Get the state of a monster
+  Actor::State getState( const int monster_id ) const;
+
+  //! Get the direction of a monster
+  Direction getDirection( const int monster_id ) const;
+
+  //! Get the animation frame of a monster
+  int getFrame( const int monster_id ) const;
+
+  //! Damage a monster (returns true if the monster was killed)
+  bool applyDamage( const int monster_id, const int damage );
+
+  //! Get the living monsters inside of a circle
+  void getMonstersInRadius( const QPointF& center,
+                            const qreal radius,
+                            QVector<int>& monster_ids ) const;
+
+  //! Get the monsters inside of a rect
+  void getMonstersInRect( const QRectF& rect,
+                          QVector<int>& monster_ids ) const;
+
+  //! Advance all monsters by a simulation tick (returns damage to target)
+  int advance( const QPointF& target_position,
+               const int target_armor_class,
+               const LevelGrid* grid = NULL );
+
+  //! Get the direction from a displacement
+  static Direction getDirectionOfDisplacement( const qreal dx,
+                                               const qreal dy );
+
+private:
+
+  // Grow the storage
+  void grow();
+
+  // Remove the monster stored at an index
+  void removeAt( const int index );
+
+  // Get the index of a monster (qFatal if the monster is not spawned)
+  int getIndex( const int monster_id ) const;
+
+  // Generate a random number in [0,range)
+  int random( const int range );
+
+  // Set the state of the monster stored at an index
+  void setStateAt( const int index,
+                   const Actor::State state,
+                   const int state_duration );
+
+  // The monster types
+  QVector<MonsterType> d_monster_types;
+
+  // The random number generator state
+  quint32 d_seed;
+
+  // The number of spawned monsters
+  int d_size;
+
+  // The types
+  QVector<int> d_type;
+
+  // The x positions
+  QVector<qreal> d_x;
+
+  // The y positions
+  QVector<qreal> d_y;
+
+  // The health
+  QVector<int> d_health;
+
+  // The states
+  QVector<quint8> d_state;
+
+  // The directions
+  QVector<quint8> d_direction;
+
+  // The animation frames
+  QVector<int> d_frame;
+
+  // The remaining ticks of the current state (0 if unlimited)
+  QVector<int> d_state_ticks;
+
+  // The monster id stored at each index
+  QVector<int> d_id;
+
+  // The index of each monster id (-1 if the id is free)
+  QVector<int> d_index;
+
+  // The free monster ids
+  QVector<int> d_free_ids;
+};
+
+} // end QtD1 namespace
+
+#endif // end MONSTER_STORE_H
+
+//---------------------------------------------------------------------------//
+// end MonsterStore.h
+//---------------------------------------------------------------------------//
@@ -10,9 +10,13 @@
 #include <iostream>
 #include <sstream>
 
+// Qt Includes
+#include <QtConcurrentRun>
+
 // QtD1 Includes
 #include "Music.h"
 #include "AudioDevice.h"
+#include "MusicStreamer.h"
 
 namespace QtD1{
 
@@ -20,8 +24,24 @@ namespace QtD1{
 Music::Music( QObject* parent )
   : QObject( parent ),
     d_source(),
-    d_music()
-{ /* ... */ }
+    d_loading_source(),
+    d_music_source(),
+    d_music(),
+    d_loading( false ),
+    d_play_pending( false ),
+    d_music_watcher()
+{
+  QObject::connect( &d_music_watcher, SIGNAL(finished()),
+                    this, SLOT(handleMusicLoaded()) );
+}
+
+// Destructor
+/*! \details Music that is being opened will be finished first.
+ */
+Music::~Music()
+{
+  d_music_watcher.waitForFinished();
+}
 
 // Get the music source
 QString Music::getSource() const
@@ -30,57 +50,194 @@ QString Music::getSource() const
 }
 
 // Set the music source
+/*! \details The music is not opened until it is played by SDL_mixer (the
+ * music streamer opens its own stream). The music that was opened
+ * previously is kept until the new music has been opened (it may still be
+ * playing).
+ */
 void Music::setSource( const QString& source )
 {
   d_source = source;
+}
 
-  try{
-    d_music.reset( new MixMusicWrapper( d_source ) );
-  }
-  catch( const std::exception& exception )
+// Check if the music has been opened
+bool Music::isLoaded() const
+{
+  return !d_loading && d_music_source == d_source;
+}
+
+// Wait for the music to be opened
+/*! \details The music will be opened if it has not been opened already.
+ */
+void Music::waitForLoaded()
+{
+  if( !d_loading && d_music_source != d_source )
+    this->load();
+
+  if( d_loading )
   {
-    std::ostringstream oss;
-    oss << "Unable to load music file "
-        << d_source.toStdString()
-        << "!";
+    d_music_watcher.waitForFinished();
 
-    qFatal( "%s", oss.str().c_str() );
+    this->handleMusicLoaded();
   }
 }
 
 // Play the music
+/*! \details If the music is still being opened it will be played once it
+ * has been opened.
+ */
 Q_INVOKABLE void Music::playMusic()
 {
+  if( d_loading )
+  {
+    d_play_pending = true;
+
+    return;
+  }
+
   AudioDevice& audio_device = AudioDevice::getInstance();
 
   // Check if the audio device is open
   if( audio_device.isOpen() )
   {
-    if( audio_device.isMusicPaused() )
+    if( this->isStreamed() )
+      MusicStreamer::getInstance()->resume();
+    else if( d_music_source != d_source )
+    {
+      d_play_pending = true;
+
+      this->load();
+    }
+    else if( audio_device.isMusicPaused() )
       audio_device.resumeMusic();
     else
       audio_device.playMusic( *d_music );
   }
 }
 
+// Play the music (the music that is playing will be crossfaded)
+/*! \details The music is played by the music streamer so that it can be
+ * crossfaded with the music that it replaces (the streamer opens its own
+ * stream so the music is not opened). Music that is
+ * played by SDL_mixer (e.g. the menu music) will be faded out. If the music
+ * cannot be streamed it will be played by SDL_mixer without a crossfade.
+ */
+void Music::playMusicWithCrossfade(
+                         std::chrono::duration<int,std::milli> crossfade_time )
+{
+  AudioDevice& audio_device = AudioDevice::getInstance();
+
+  // Check if the audio device is open
+  if( !audio_device.isOpen() )
+    return;
+
+  if( MusicStreamer::getInstance()->play( d_source, crossfade_time ) )
+  {
+    if( audio_device.isMusicPlaying() )
+    {
+      if( audio_device.isMusicPaused() )
+        audio_device.haltMusic();
+      else
+        audio_device.haltMusicWithFadeOut( crossfade_time );
+    }
+  }
+  else
+  {
+    MusicStreamer::getInstance()->stop();
+
+    this->playMusic();
+  }
+}
+
 // Pause the music
 Q_INVOKABLE void Music::pauseMusic()
 {
+  d_play_pending = false;
+
   AudioDevice& audio_device = AudioDevice::getInstance();
 
   // Check if the audio device is open
-  if( audio_device.isOpen() && audio_device.isMusicPlaying() )
-    audio_device.pauseMusic();
+  if( audio_device.isOpen() )
+  {
+    if( this->isStreamed() )
+      MusicStreamer::getInstance()->pause();
+    else if( audio_device.isMusicPlaying() )
+      audio_device.pauseMusic();
+  }
 }
 
 // Stop the music
 Q_INVOKABLE void Music::stopMusic()
 {
+  d_play_pending = false;
+
   AudioDevice& audio_device = AudioDevice::getInstance();
 
   // Check if the audio device is open
   if( audio_device.isOpen() )
-    audio_device.haltMusic();
+  {
+    if( this->isStreamed() )
+      MusicStreamer::getInstance()->stop();
+    else
+      audio_device.haltMusic();
+  }
+}
+
+// Check if the music is played by the music streamer
+bool Music::isStreamed() const
+{
+  return !d_source.isEmpty() &&
+    MusicStreamer::getInstance()->getSource() == d_source;
+}
+
+// Handle the music opened
+/*! \details The music may have been handled already by waitForLoaded.
+ */
+void Music::handleMusicLoaded()
+{
+  if( !d_loading || !d_music_watcher.isFinished() )
+    return;
+
+  try{
+    d_music = d_music_watcher.result();
+    d_music_source = d_loading_source;
+  }
+  catch( const std::exception& exception )
+  {
+    std::ostringstream oss;
+    oss << "Unable to load music file "
+        << d_loading_source.toStdString()
+        << "!";
+
+    qFatal( "%s", oss.str().c_str() );
+  }
+
+  d_loading = false;
+
+  emit loaded();
+
+  if( d_play_pending )
+  {
+    d_play_pending = false;
+
+    this->playMusic();
+  }
+}
+
+// Open the music asynchronously
+void Music::load()
+{
+  d_loading_source = d_source;
+  d_loading = true;
+
+  d_music_watcher.setFuture(
+                     QtConcurrent::run( Music::loadImpl, d_loading_source ) );
+}
+
+// Open the music (run in a worker thread)
+std::shared_ptr<MixMusicWrapper> Music::loadImpl( const QString source )
+{
+  return std::shared_ptr<MixMusicWrapper>( new MixMusicWrapper( source ) );
 }
 
 QML_REGISTER_TYPE( Music );
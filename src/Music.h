@@ -11,9 +11,11 @@
 
 // Std Lib Includes
 #include <memory>
+#include <chrono>
 
 // Qt Includes
 #include <QString>
+#include <QFutureWatcher>
 
 // QtD1 Includes
 #include "MixMusicWrapper.h"
@@ -21,7 +23,13 @@
 
 namespace QtD1{
 
-//! The music class
+/*! The music class
+ *
+ * The music is opened by a worker thread when it is first played by
+ * SDL_mixer (music that is crossfaded is played by the music streamer,
+ * which opens its own stream). The music will be played as soon as it has
+ * been opened.
+ */
 class Music : public QObject
 {
   Q_OBJECT
@@ -34,31 +42,74 @@ public:
   Music( QObject* parent = 0 );
 
   //! Destructor
-  ~Music()
-  { /* ... */ }
+  ~Music();
 
   //! Get the music file source
   QString getSource() const;
 
-  //! Set the music file source
+  //! Set the music file source (the music is opened when it is played)
   void setSource( const QString& source );
 
+  //! Check if the music has been opened
+  bool isLoaded() const;
+
+  //! Wait for the music to be opened
+  void waitForLoaded();
+
   //! Play the music
   Q_INVOKABLE void playMusic();
 
+  //! Play the music (the music that is playing will be crossfaded)
+  void playMusicWithCrossfade(
+                        std::chrono::duration<int,std::milli> crossfade_time );
+
   //! Pause the music
   Q_INVOKABLE void pauseMusic();
 
   //! Stop the music
   Q_INVOKABLE void stopMusic();
 
+signals:
+
+  //! The music has been opened
+  void loaded();
+
+private slots:
+
+  // Handle the music opened
+  void handleMusicLoaded();
+
 private:
 
+  // Open the music asynchronously
+  void load();
+
+  // Open the music (run in a worker thread)
+  static std::shared_ptr<MixMusicWrapper> loadImpl( const QString source );
+
+  // Check if the music is played by the music streamer
+  bool isStreamed() const;
+
   // The music file source
   QString d_source;
 
+  // The music file source that is being opened
+  QString d_loading_source;
+
+  // The music file source of the opened music
+  QString d_music_source;
+
   // The music
-  std::unique_ptr<MixMusicWrapper> d_music;
+  std::shared_ptr<MixMusicWrapper> d_music;
+
+  // Records if the music is being opened
+  bool d_loading;
+
+  // Records if the music should be played once it has been opened
+  bool d_play_pending;
+
+  // The music watcher
+  QFutureWatcher<std::shared_ptr<MixMusicWrapper> > d_music_watcher;
 };
   
 } // end QtD1 namespace
@@ -0,0 +1,270 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MusicStream.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The music stream class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+#include <cstring>
+
+// QtD1 Includes
+#include "MusicStream.h"
+#include "MPQHandler.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int MusicStream::s_block_size;
+
+// Constructor
+/*! \details The frequency, format and number of channels are the audio
+ * device settings that the track will be converted to. Archived files are
+ * streamed from the mpq file. If the track cannot be decoded a warning
+ * will be printed and the stream will not be valid.
+ */
+MusicStream::MusicStream( const QString& source,
+                          const int frequency,
+                          const SDL_AudioFormat format,
+                          const int number_of_channels )
+  : d_source( source ),
+    d_mpq_stream(),
+    d_raw_rwops( NULL ),
+    d_data_pos( 0 ),
+    d_data_size( 0 ),
+    d_data_offset( 0 ),
+    d_frame_size( 0 ),
+    d_converter(),
+    d_block(),
+    d_block_size( 0 ),
+    d_block_offset( 0 ),
+    d_valid( false )
+{
+  if( MPQHandler::getInstance()->doesFileExist( source ) )
+  {
+    d_mpq_stream.reset( new MPQRWopsWrapper( source ) );
+
+    d_raw_rwops = d_mpq_stream->getRawRWopsPtr();
+  }
+  else
+    d_raw_rwops = SDL_RWFromFile( source.toLatin1().data(), "rb" );
+
+  if( d_raw_rwops == NULL )
+  {
+    qWarning( "MusicStream Warning: Could not open music file %s!",
+              source.toLatin1().data() );
+    return;
+  }
+
+  SDL_AudioFormat file_format;
+  int file_frequency, file_number_of_channels;
+
+  if( !this->parseHeader( file_format,
+                          file_frequency,
+                          file_number_of_channels ) )
+  {
+    qWarning( "MusicStream Warning: Music file %s is not a PCM wav file!",
+              source.toLatin1().data() );
+    return;
+  }
+
+  if( SDL_BuildAudioCVT( &d_converter,
+                         file_format,
+                         file_number_of_channels,
+                         file_frequency,
+                         format,
+                         number_of_channels,
+                         frequency ) < 0 )
+  {
+    qWarning( "MusicStream Warning: Music file %s cannot be converted to "
+              "the audio device format (%s)!",
+              source.toLatin1().data(),
+              SDL_GetError() );
+    return;
+  }
+
+  d_block.resize( s_block_size*d_frame_size*
+                  (d_converter.needed ? d_converter.len_mult : 1) );
+
+  d_valid = true;
+}
+
+// Destructor
+MusicStream::~MusicStream()
+{
+  // The mpq stream owns its SDL_RWops
+  if( !d_mpq_stream && d_raw_rwops )
+    SDL_RWclose( d_raw_rwops );
+}
+
+// Get the music file source
+const QString& MusicStream::getSource() const
+{
+  return d_source;
+}
+
+// Check if the stream is valid (the track could be decoded)
+bool MusicStream::isValid() const
+{
+  return d_valid;
+}
+
+// Read the decoded data (the track loops)
+/*! \details The number of bytes that were read will only be less than the
+ * requested size if the track cannot be read anymore.
+ */
+int MusicStream::read( Uint8* data, const int size )
+{
+  if( !d_valid )
+    return 0;
+
+  int bytes_read = 0;
+
+  while( bytes_read < size )
+  {
+    if( d_block_offset == d_block_size )
+    {
+      if( !this->decodeBlock() )
+      {
+        d_valid = false;
+        break;
+      }
+    }
+
+    const int block_bytes_to_read =
+      std::min( size - bytes_read, d_block_size - d_block_offset );
+
+    memcpy( data+bytes_read,
+            d_block.constData()+d_block_offset,
+            block_bytes_to_read );
+
+    bytes_read += block_bytes_to_read;
+    d_block_offset += block_bytes_to_read;
+  }
+
+  return bytes_read;
+}
+
+// Parse the wav header
+/*! \details Chunks other than the format and data chunks are skipped.
+ */
+bool MusicStream::parseHeader( SDL_AudioFormat& format,
+                               int& frequency,
+                               int& number_of_channels )
+{
+  char id[4];
+
+  if( SDL_RWread( d_raw_rwops, id, 4, 1 ) != 1 ||
+      strncmp( id, "RIFF", 4 ) != 0 )
+    return false;
+
+  SDL_ReadLE32( d_raw_rwops );
+
+  if( SDL_RWread( d_raw_rwops, id, 4, 1 ) != 1 ||
+      strncmp( id, "WAVE", 4 ) != 0 )
+    return false;
+
+  bool format_chunk_parsed = false;
+
+  while( SDL_RWread( d_raw_rwops, id, 4, 1 ) == 1 )
+  {
+    const Uint32 chunk_size = SDL_ReadLE32( d_raw_rwops );
+    const Sint64 chunk_pos = SDL_RWtell( d_raw_rwops );
+
+    if( strncmp( id, "fmt ", 4 ) == 0 )
+    {
+      const Uint16 encoding = SDL_ReadLE16( d_raw_rwops );
+      number_of_channels = SDL_ReadLE16( d_raw_rwops );
+      frequency = SDL_ReadLE32( d_raw_rwops );
+
+      // Skip the byte rate
+      SDL_ReadLE32( d_raw_rwops );
+
+      d_frame_size = SDL_ReadLE16( d_raw_rwops );
+      const Uint16 bits_per_sample = SDL_ReadLE16( d_raw_rwops );
+
+      // Only uncompressed 8-bit and 16-bit tracks are supported
+      if( encoding != 1 || number_of_channels == 0 || d_frame_size == 0 )
+        return false;
+
+      if( bits_per_sample == 8 )
+        format = AUDIO_U8;
+      else if( bits_per_sample == 16 )
+        format = AUDIO_S16LSB;
+      else
+        return false;
+
+      format_chunk_parsed = true;
+    }
+    else if( strncmp( id, "data", 4 ) == 0 )
+    {
+      if( !format_chunk_parsed )
+        return false;
+
+      d_data_pos = chunk_pos;
+      d_data_size = chunk_size - chunk_size % d_frame_size;
+      d_data_offset = 0;
+
+      return d_data_size > 0;
+    }
+
+    // Chunks are word aligned
+    if( SDL_RWseek( d_raw_rwops,
+                    chunk_pos + chunk_size + chunk_size % 2,
+                    RW_SEEK_SET ) < 0 )
+      return false;
+  }
+
+  return false;
+}
+
+// Decode the next block
+/*! \details The track is rewound when the end of the sample data is
+ * reached.
+ */
+bool MusicStream::decodeBlock()
+{
+  if( d_data_offset == d_data_size )
+  {
+    if( SDL_RWseek( d_raw_rwops, d_data_pos, RW_SEEK_SET ) < 0 )
+      return false;
+
+    d_data_offset = 0;
+  }
+
+  const int bytes_to_read =
+    std::min( (Sint64)s_block_size*d_frame_size, d_data_size - d_data_offset );
+
+  const size_t bytes_read =
+    SDL_RWread( d_raw_rwops, d_block.data(), 1, bytes_to_read );
+
+  if( bytes_read == 0 || bytes_read % d_frame_size != 0 )
+    return false;
+
+  d_data_offset += bytes_read;
+
+  if( d_converter.needed )
+  {
+    d_converter.buf = (Uint8*)d_block.data();
+    d_converter.len = bytes_read;
+
+    if( SDL_ConvertAudio( &d_converter ) < 0 )
+      return false;
+
+    d_block_size = d_converter.len_cvt;
+  }
+  else
+    d_block_size = bytes_read;
+
+  d_block_offset = 0;
+
+  return d_block_size > 0;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end MusicStream.cpp
+//---------------------------------------------------------------------------//
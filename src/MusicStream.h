@@ -0,0 +1,116 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MusicStream.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The music stream class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef MUSIC_STREAM_H
+#define MUSIC_STREAM_H
+
+// Std Lib Includes
+#include <memory>
+
+// SDL Includes
+#include <SDL_audio.h>
+
+// Qt Includes
+#include <QString>
+#include <QByteArray>
+
+// QtD1 Includes
+#include "MPQRWopsWrapper.h"
+
+namespace QtD1{
+
+/*! The music stream
+ * \details A looping PCM wav music track that is decoded on demand into the
+ * audio device format. The track is streamed from the mpq file through an
+ * MPQRWopsWrapper - only one block of frames is decoded at a time.
+ */
+class MusicStream
+{
+
+public:
+
+  //! The number of frames that are decoded at a time
+  static const int s_block_size = 4096;
+
+  //! Constructor
+  MusicStream( const QString& source,
+               const int frequency,
+               const SDL_AudioFormat format,
+               const int number_of_channels );
+
+  //! Destructor
+  ~MusicStream();
+
+  //! Get the music file source
+  const QString& getSource() const;
+
+  //! Check if the stream is valid (the track could be decoded)
+  bool isValid() const;
+
+  //! Read the decoded data (the track loops)
+  int read( Uint8* data, const int size );
+
+private:
+
+  // Constructors and assignment operator
+  MusicStream();
+  MusicStream( const MusicStream& that );
+  MusicStream& operator=( const MusicStream& that );
+
+  // Parse the wav header
+  bool parseHeader( SDL_AudioFormat& format,
+                    int& frequency,
+                    int& number_of_channels );
+
+  // Decode the next block
+  bool decodeBlock();
+
+  // The music file source
+  QString d_source;
+
+  // The mpq stream
+  std::unique_ptr<MPQRWopsWrapper> d_mpq_stream;
+
+  // The raw SDL_RWops
+  SDL_RWops* d_raw_rwops;
+
+  // The file position of the sample data
+  Sint64 d_data_pos;
+
+  // The size of the sample data
+  Sint64 d_data_size;
+
+  // The position in the sample data
+  Sint64 d_data_offset;
+
+  // The size of a frame in the file (bytes)
+  int d_frame_size;
+
+  // The converter
+  SDL_AudioCVT d_converter;
+
+  // The decoded block
+  QByteArray d_block;
+
+  // The size of the decoded block
+  int d_block_size;
+
+  // The position in the decoded block
+  int d_block_offset;
+
+  // Records if the stream is valid
+  bool d_valid;
+};
+
+} // end QtD1 namespace
+
+#endif // end MUSIC_STREAM_H
+
+//---------------------------------------------------------------------------//
+// end MusicStream.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,483 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MusicStreamer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The music streamer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+#include <cstring>
+
+// Qt Includes
+#include <QMutexLocker>
+
+// QtD1 Includes
+#include "MusicStreamer.h"
+#include "AudioDevice.h"
+
+namespace QtD1{
+
+// Initialize static member data
+std::unique_ptr<MusicStreamer> MusicStreamer::s_instance;
+QMutex MusicStreamer::s_instance_mutex;
+const int MusicStreamer::s_deck_buffer_size;
+const int MusicStreamer::s_fill_block_size;
+const unsigned long MusicStreamer::s_fill_interval;
+
+// Get the singleton instance
+MusicStreamer* MusicStreamer::getInstance()
+{
+  QMutexLocker instance_locker( &s_instance_mutex );
+
+  // Just-in-time initialization
+  if( !s_instance )
+    s_instance.reset( new MusicStreamer );
+
+  return s_instance.get();
+}
+
+// Constructor
+MusicStreamer::MusicStreamer()
+  : d_mutex(),
+    d_decks(),
+    d_deck_buffer(),
+    d_number_of_channels( 2 ),
+    d_paused( false ),
+    d_volume( 1.0f ),
+    d_fill_mutex(),
+    d_fill_condition(),
+    d_stop_filling( false ),
+    d_fill_thread( this )
+{ /* ... */ }
+
+// Destructor
+/*! \details The mix callback is only unregistered if the audio device is
+ * still open (closing the audio device unregisters it). The worker thread
+ * will be stopped.
+ */
+MusicStreamer::~MusicStreamer()
+{
+  if( Mix_QuerySpec( NULL, NULL, NULL ) )
+    Mix_UnregisterEffect( MIX_CHANNEL_POST, MusicStreamer::mixCallback );
+
+  {
+    QMutexLocker fill_locker( &d_fill_mutex );
+
+    d_stop_filling = true;
+
+    d_fill_condition.wakeAll();
+  }
+
+  d_fill_thread.wait();
+}
+
+// Constructor
+MusicStreamer::DeckBuffer::DeckBuffer(
+                           const std::shared_ptr<MusicStream>& music_stream )
+  : stream( music_stream ),
+    samples( s_deck_buffer_size ),
+    ended( false )
+{ /* ... */ }
+
+// Constructor
+MusicStreamer::FillThread::FillThread( MusicStreamer* streamer )
+  : QThread(),
+    d_streamer( streamer )
+{ /* ... */ }
+
+// Fill the deck buffers until the streamer is destroyed
+/*! \details The deck buffers are topped up every s_fill_interval ms (the
+ * audio thread cannot wake this thread without locking a mutex).
+ */
+void MusicStreamer::FillThread::run()
+{
+  QMutexLocker fill_locker( &d_streamer->d_fill_mutex );
+
+  while( !d_streamer->d_stop_filling )
+  {
+    fill_locker.unlock();
+
+    d_streamer->fillDeckBuffers();
+
+    fill_locker.relock();
+
+    if( !d_streamer->d_stop_filling )
+    {
+      d_streamer->d_fill_condition.wait( &d_streamer->d_fill_mutex,
+                                         s_fill_interval );
+    }
+  }
+}
+
+// Play a music track (the current track will be crossfaded)
+/*! \details The track is opened (and its header is parsed) and its deck
+ * buffer is filled before it is handed to the audio thread so that the
+ * crossfade starts right away. If the track cannot be played false will be
+ * returned.
+ */
+bool MusicStreamer::play(
+                  const QString& source,
+                  const std::chrono::duration<int,std::milli> crossfade_time )
+{
+  AudioDevice& audio_device = AudioDevice::getInstance();
+
+  if( !audio_device.isOpen() || audio_device.getFormat() != AUDIO_S16SYS )
+    return false;
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    // Keep playing the current track
+    if( !d_decks.isEmpty() &&
+        !d_decks.back().fading_out &&
+        d_decks.back().buffer->stream->getSource() == source )
+    {
+      d_paused = false;
+
+      return true;
+    }
+  }
+
+  std::shared_ptr<MusicStream> stream(
+                       new MusicStream( source,
+                                        audio_device.getFrequency(),
+                                        audio_device.getFormat(),
+                                        audio_device.getNumberOfChannels() ) );
+
+  if( !stream->isValid() )
+    return false;
+
+  std::shared_ptr<DeckBuffer> buffer( new DeckBuffer( stream ) );
+
+  MusicStreamer::fillDeckBuffer( *buffer,
+                                 audio_device.getNumberOfChannels() );
+
+  const float crossfade_frames =
+    std::max( (qint64)audio_device.getFrequency()*crossfade_time.count()/1000,
+              (qint64)1 );
+
+  QList<Deck> silent_decks;
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    QList<Deck>::iterator deck_it, deck_end;
+    deck_it = d_decks.begin();
+    deck_end = d_decks.end();
+
+    while( deck_it != deck_end )
+    {
+      deck_it->fading_out = true;
+      deck_it->gain_step = -deck_it->gain/crossfade_frames;
+
+      ++deck_it;
+    }
+
+    Deck deck;
+    deck.buffer = buffer;
+    deck.gain = 0.0f;
+    deck.gain_step = 1.0f/crossfade_frames;
+    deck.fading_out = false;
+
+    d_decks << deck;
+
+    d_number_of_channels = audio_device.getNumberOfChannels();
+    d_paused = false;
+
+    silent_decks = this->removeSilentDecks();
+  }
+
+  this->registerMixCallback();
+
+  this->wakeFillThread();
+
+  return true;
+}
+
+// Pause the music
+void MusicStreamer::pause()
+{
+  QMutexLocker locker( &d_mutex );
+
+  d_paused = true;
+}
+
+// Resume the music
+void MusicStreamer::resume()
+{
+  QMutexLocker locker( &d_mutex );
+
+  d_paused = false;
+}
+
+// Stop the music
+/*! \details The tracks are closed on the calling thread.
+ */
+void MusicStreamer::stop()
+{
+  QList<Deck> decks;
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    decks.swap( d_decks );
+    d_paused = false;
+  }
+}
+
+// Check if music is playing
+bool MusicStreamer::isPlaying() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return !d_paused && !d_decks.isEmpty() && !d_decks.back().fading_out;
+}
+
+// Check if music is paused
+bool MusicStreamer::isPaused() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_paused && !d_decks.isEmpty() && !d_decks.back().fading_out;
+}
+
+// Get the music file source of the current track
+QString MusicStreamer::getSource() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  if( !d_decks.isEmpty() && !d_decks.back().fading_out )
+    return d_decks.back().buffer->stream->getSource();
+  else
+    return QString();
+}
+
+// Set the music volume
+/*! \details The volume has the same range as the SDL_mixer music volume.
+ */
+void MusicStreamer::setVolume( const int volume )
+{
+  QMutexLocker locker( &d_mutex );
+
+  d_volume = std::min( std::max( volume, 0 ), MIX_MAX_VOLUME )/
+    (float)MIX_MAX_VOLUME;
+}
+
+// Mix callback
+void MusicStreamer::mixCallback( int,
+                                 void* stream,
+                                 int length,
+                                 void* user_data )
+{
+  ((MusicStreamer*)user_data)->mix( (Sint16*)stream, length/sizeof(Sint16) );
+}
+
+// Mix the decks into the stream
+/*! \details This is called by the audio thread. Only the decoded samples
+ * in the deck buffers are mixed (the music streams are never read here). A
+ * deck buffer that runs dry is filled with silence until the worker thread
+ * catches up.
+ */
+void MusicStreamer::mix( Sint16* samples, const int number_of_samples )
+{
+  QMutexLocker locker( &d_mutex );
+
+  if( d_paused || d_decks.isEmpty() )
+    return;
+
+  if( d_deck_buffer.size() < number_of_samples )
+    d_deck_buffer.resize( number_of_samples );
+
+  const int number_of_frames = number_of_samples/d_number_of_channels;
+
+  QList<Deck>::iterator deck_it, deck_end;
+  deck_it = d_decks.begin();
+  deck_end = d_decks.end();
+
+  while( deck_it != deck_end )
+  {
+    // Skip the decks that have faded out
+    if( deck_it->fading_out && deck_it->gain <= 0.0f )
+    {
+      ++deck_it;
+      continue;
+    }
+
+    Sint16* deck_samples = d_deck_buffer.data();
+
+    const int samples_read =
+      deck_it->buffer->samples.pop( deck_samples, number_of_samples );
+
+    if( samples_read < number_of_samples )
+    {
+      memset( deck_samples + samples_read,
+              0,
+              (number_of_samples - samples_read)*sizeof(Sint16) );
+    }
+
+    for( int i = 0; i < number_of_frames; ++i )
+    {
+      deck_it->gain =
+        std::min( std::max( deck_it->gain + deck_it->gain_step, 0.0f ),
+                  1.0f );
+
+      const float gain = deck_it->gain*d_volume;
+
+      for( int j = 0; j < d_number_of_channels; ++j )
+      {
+        const int sample_index = i*d_number_of_channels + j;
+
+        const float sample =
+          samples[sample_index] + deck_samples[sample_index]*gain;
+
+        samples[sample_index] =
+          (Sint16)std::min( std::max( sample, -32768.0f ), 32767.0f );
+      }
+    }
+
+    // A track that cannot be read anymore is silenced
+    if( samples_read < number_of_samples &&
+        deck_it->buffer->ended.load( std::memory_order_acquire ) &&
+        deck_it->buffer->samples.isEmpty() )
+    {
+      deck_it->fading_out = true;
+      deck_it->gain = 0.0f;
+    }
+
+    ++deck_it;
+  }
+}
+
+// Remove the decks that have faded out
+/*! \details The removed decks are returned so that they can be closed after
+ * the deck mutex has been released.
+ */
+QList<MusicStreamer::Deck> MusicStreamer::removeSilentDecks()
+{
+  QList<Deck> silent_decks;
+
+  QList<Deck>::iterator deck_it = d_decks.begin();
+
+  while( deck_it != d_decks.end() )
+  {
+    if( deck_it->fading_out && deck_it->gain <= 0.0f )
+    {
+      silent_decks << *deck_it;
+
+      deck_it = d_decks.erase( deck_it );
+    }
+    else
+      ++deck_it;
+  }
+
+  return silent_decks;
+}
+
+// Register the mix callback with the audio device
+/*! \details The mix callback is registered again every time that a track is
+ * played because reopening the audio device unregisters it. The deck mutex
+ * must not be held - registering the callback locks the audio thread.
+ */
+void MusicStreamer::registerMixCallback()
+{
+  Mix_UnregisterEffect( MIX_CHANNEL_POST, MusicStreamer::mixCallback );
+
+  if( Mix_RegisterEffect( MIX_CHANNEL_POST,
+                          MusicStreamer::mixCallback,
+                          NULL,
+                          this ) == 0 )
+  {
+    qWarning( "MusicStreamer Warning: The music mix callback could not be "
+              "registered (%s)!", Mix_GetError() );
+  }
+}
+
+// Fill the deck buffers (run in the worker thread)
+/*! \details The deck mutex is only held while the deck buffers are
+ * collected - the music streams are read without it so that the audio
+ * thread never waits for the mpq file.
+ */
+void MusicStreamer::fillDeckBuffers()
+{
+  QList<std::shared_ptr<DeckBuffer> > buffers;
+  int number_of_channels;
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    QList<Deck>::const_iterator deck_it, deck_end;
+    deck_it = d_decks.begin();
+    deck_end = d_decks.end();
+
+    while( deck_it != deck_end )
+    {
+      if( !deck_it->fading_out || deck_it->gain > 0.0f )
+        buffers << deck_it->buffer;
+
+      ++deck_it;
+    }
+
+    number_of_channels = d_number_of_channels;
+  }
+
+  QList<std::shared_ptr<DeckBuffer> >::iterator buffer_it, buffer_end;
+  buffer_it = buffers.begin();
+  buffer_end = buffers.end();
+
+  while( buffer_it != buffer_end )
+  {
+    MusicStreamer::fillDeckBuffer( **buffer_it, number_of_channels );
+
+    ++buffer_it;
+  }
+}
+
+// Fill a deck buffer
+/*! \details Only whole frames are decoded. A deck buffer must only be
+ * filled by one thread at a time.
+ */
+void MusicStreamer::fillDeckBuffer( DeckBuffer& buffer,
+                                    const int number_of_channels )
+{
+  QVector<Sint16> block( s_fill_block_size );
+
+  while( !buffer.ended.load( std::memory_order_relaxed ) )
+  {
+    int block_size = std::min( buffer.samples.getCapacity() -
+                               buffer.samples.getSize(),
+                               s_fill_block_size );
+
+    block_size -= block_size % number_of_channels;
+
+    if( block_size == 0 )
+      break;
+
+    const int bytes_read =
+      buffer.stream->read( (Uint8*)block.data(), block_size*sizeof(Sint16) );
+
+    buffer.samples.push( block.constData(), bytes_read/sizeof(Sint16) );
+
+    // The track loops so a short read means that it cannot be read anymore
+    if( bytes_read < (int)(block_size*sizeof(Sint16)) )
+      buffer.ended.store( true, std::memory_order_release );
+  }
+}
+
+// Wake the worker thread (it will be started if necessary)
+void MusicStreamer::wakeFillThread()
+{
+  QMutexLocker fill_locker( &d_fill_mutex );
+
+  if( !d_fill_thread.isRunning() )
+    d_fill_thread.start();
+
+  d_fill_condition.wakeAll();
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end MusicStreamer.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,210 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MusicStreamer.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The music streamer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef MUSIC_STREAMER_H
+#define MUSIC_STREAMER_H
+
+// Std Lib Includes
+#include <memory>
+#include <chrono>
+#include <atomic>
+
+// SDL Includes
+#include <SDL_mixer.h>
+
+// Qt Includes
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+
+// QtD1 Includes
+#include "MusicStream.h"
+#include "LockFreeQueue.h"
+
+namespace QtD1{
+
+/*! The music streamer
+ *
+ * SDL_mixer can only play one music track at a time so tracks cannot be
+ * crossfaded through it. The streamer mixes the music tracks itself (in a
+ * post-mix effect). The music streams are decoded by a worker thread into
+ * a PCM ring buffer per track - the audio thread only consumes the decoded
+ * samples so it never waits for the mpq file. When a new track is played
+ * the current track fades out while the new track fades in. Playing the
+ * track that is already playing does nothing so that levels that share a
+ * track play it gaplessly.
+ *
+ * Only 16-bit audio devices are supported - if the audio device has a
+ * different format no tracks will be played (the SDL_mixer music should be
+ * used instead). The streamer must only be controlled from the GUI thread.
+ */
+class MusicStreamer
+{
+
+public:
+
+  //! Get the singleton instance
+  static MusicStreamer* getInstance();
+
+  //! Destructor
+  ~MusicStreamer();
+
+  //! Play a music track (the current track will be crossfaded)
+  bool play( const QString& source,
+             const std::chrono::duration<int,std::milli> crossfade_time );
+
+  //! Pause the music
+  void pause();
+
+  //! Resume the music
+  void resume();
+
+  //! Stop the music
+  void stop();
+
+  //! Check if music is playing
+  bool isPlaying() const;
+
+  //! Check if music is paused
+  bool isPaused() const;
+
+  //! Get the music file source of the current track
+  QString getSource() const;
+
+  //! Set the music volume
+  void setVolume( const int volume );
+
+private:
+
+  // The number of samples that a deck buffer can hold
+  static const int s_deck_buffer_size = 1 << 17;
+
+  // The number of samples that are decoded at a time
+  static const int s_fill_block_size = 8192;
+
+  // The time between deck buffer fills (ms)
+  static const unsigned long s_fill_interval = 10;
+
+  // A deck buffer (filled by the worker thread, emptied by the audio thread)
+  struct DeckBuffer{
+    // Constructor
+    DeckBuffer( const std::shared_ptr<MusicStream>& music_stream );
+
+    // The music stream (only read by the thread that fills the buffer)
+    std::shared_ptr<MusicStream> stream;
+    // The decoded samples
+    LockFreeQueue<Sint16> samples;
+    // Records if the music stream cannot be read anymore
+    std::atomic<bool> ended;
+  };
+
+  // The worker thread that fills the deck buffers
+  class FillThread : public QThread
+  {
+
+  public:
+
+    // Constructor
+    FillThread( MusicStreamer* streamer );
+
+    // Fill the deck buffers until the streamer is destroyed
+    void run() override;
+
+  private:
+
+    // The streamer
+    MusicStreamer* d_streamer;
+  };
+
+  // A deck (a track that is being played)
+  struct Deck{
+    // The deck buffer
+    std::shared_ptr<DeckBuffer> buffer;
+    // The gain
+    float gain;
+    // The gain step (per frame)
+    float gain_step;
+    // Records if the deck is fading out
+    bool fading_out;
+  };
+
+  // Constructor
+  MusicStreamer();
+
+  // Mix callback
+  static void mixCallback( int channel,
+                           void* stream,
+                           int length,
+                           void* user_data );
+
+  // Mix the decks into the stream
+  void mix( Sint16* samples, const int number_of_samples );
+
+  // Remove the decks that have faded out
+  QList<Deck> removeSilentDecks();
+
+  // Register the mix callback with the audio device
+  void registerMixCallback();
+
+  // Fill the deck buffers (run in the worker thread)
+  void fillDeckBuffers();
+
+  // Fill a deck buffer
+  static void fillDeckBuffer( DeckBuffer& buffer,
+                              const int number_of_channels );
+
+  // Wake the worker thread (it will be started if necessary)
+  void wakeFillThread();
+
+  // The singleton instance
+  static std::unique_ptr<MusicStreamer> s_instance;
+
+  // The singleton instance mutex
+  static QMutex s_instance_mutex;
+
+  // The deck mutex (shared with the audio thread)
+  mutable QMutex d_mutex;
+
+  // The decks (the current track is the last deck that is not fading out)
+  QList<Deck> d_decks;
+
+  // The deck buffer
+  QVector<Sint16> d_deck_buffer;
+
+  // The number of channels
+  int d_number_of_channels;
+
+  // Records if the music is paused
+  bool d_paused;
+
+  // The volume
+  float d_volume;
+
+  // The fill mutex
+  QMutex d_fill_mutex;
+
+  // The fill condition (wakes the worker thread)
+  QWaitCondition d_fill_condition;
+
+  // Records if the worker thread should stop
+  bool d_stop_filling;
+
+  // The worker thread
+  FillThread d_fill_thread;
+};
+
+} // end QtD1 namespace
+
+#endif // end MUSIC_STREAMER_H
+
+//---------------------------------------------------------------------------//
+// end MusicStreamer.h
+//---------------------------------------------------------------------------//
@@ -64,6 +64,18 @@ void PCXFrameLoader::setNumberOfCols( const int num_cols )
   d_source_cols = num_cols;
 }
 
+// Get the image asset cache key of the frames
+/*! \details The sprite sheet layout and the transparent color are part of
+ * the key since they change the frames that are extracted from the source.
+ */
+QString PCXFrameLoader::getCacheKey() const
+{
+  return QString( "%1?%2x%3,%4" ).arg( this->getSource() )
+    .arg( d_source_rows )
+    .arg( d_source_cols )
+    .arg( QString::number( d_transparent_color.rgba(), 16 ) );
+}
+
 // Get ready for frame loading
 int PCXFrameLoader::getReadyForFrameLoading()
 {
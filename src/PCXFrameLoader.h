@@ -49,6 +49,9 @@ public:
   //! Set the number of columns in the sprite sheet
   void setNumberOfCols( const int num_cols );
 
+  //! Get the image asset cache key of the frames
+  QString getCacheKey() const override;
+
 private:
 
   // Get ready for frame loading
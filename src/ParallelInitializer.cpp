@@ -0,0 +1,214 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ParallelInitializer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The parallel initializer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <stdexcept>
+
+// Qt Includes
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+
+// QtD1 Includes
+#include "ParallelInitializer.h"
+#include "StartupProfiler.h"
+
+namespace QtD1{
+
+// Constructor
+ParallelInitializer::ParallelInitializer()
+  : d_mutex(),
+    d_finished_condition(),
+    d_tasks(),
+    d_task_indices(),
+    d_finished_tasks( 0 ),
+    d_started( false )
+{ /* ... */ }
+
+// Destructor (waits for the tasks to finish)
+/*! \details The tasks that have not been started will not be run.
+ */
+ParallelInitializer::~ParallelInitializer()
+{
+  QMutexLocker locker( &d_mutex );
+
+  if( d_started )
+  {
+    while( d_finished_tasks < d_tasks.size() )
+      d_finished_condition.wait( &d_mutex );
+  }
+}
+
+// Add a task (the dependencies must already have been added)
+/*! \details Requiring that the dependencies are added first guarantees
+ * that there are no dependency cycles.
+ */
+void ParallelInitializer::addTask( const QString& name,
+                                   const Task& task,
+                                   const QStringList& dependencies )
+{
+  QMutexLocker locker( &d_mutex );
+
+  if( d_started )
+  {
+    qFatal( "ParallelInitializer Error: Task %s cannot be added after the "
+            "tasks have been started!", name.toLatin1().data() );
+  }
+
+  if( d_task_indices.contains( name ) )
+  {
+    qFatal( "ParallelInitializer Error: Task %s has already been added!",
+            name.toLatin1().data() );
+  }
+
+  const int task_index = d_tasks.size();
+
+  TaskNode task_node;
+  task_node.name = name;
+  task_node.task = task;
+  task_node.unfinished_dependencies = 0;
+
+  for( int i = 0; i < dependencies.size(); ++i )
+  {
+    QHash<QString,int>::const_iterator dependency_it =
+      d_task_indices.find( dependencies[i] );
+
+    if( dependency_it == d_task_indices.end() )
+    {
+      qFatal( "ParallelInitializer Error: Task %s depends on unknown task "
+              "%s!",
+              name.toLatin1().data(),
+              dependencies[i].toLatin1().data() );
+    }
+
+    d_tasks[dependency_it.value()].dependents << task_index;
+    ++task_node.unfinished_dependencies;
+  }
+
+  d_tasks << task_node;
+  d_task_indices[name] = task_index;
+}
+
+// Start the tasks that do not have any dependencies
+void ParallelInitializer::start()
+{
+  QMutexLocker locker( &d_mutex );
+
+  if( d_started )
+    return;
+
+  d_started = true;
+
+  for( int i = 0; i < d_tasks.size(); ++i )
+  {
+    if( d_tasks[i].unfinished_dependencies == 0 )
+      this->startTask( i );
+  }
+
+  if( d_tasks.isEmpty() )
+    d_finished_condition.wakeAll();
+}
+
+// Wait for all of the tasks to finish
+/*! \details The tasks will be started if they have not been started yet.
+ */
+void ParallelInitializer::waitForFinished()
+{
+  this->start();
+
+  QMutexLocker locker( &d_mutex );
+
+  while( d_finished_tasks < d_tasks.size() )
+    d_finished_condition.wait( &d_mutex );
+}
+
+// Check if all of the tasks have finished
+bool ParallelInitializer::isFinished() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_started && d_finished_tasks == d_tasks.size();
+}
+
+// Get the number of tasks
+int ParallelInitializer::getNumberOfTasks() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_tasks.size();
+}
+
+// Get the number of tasks that have finished
+int ParallelInitializer::getNumberOfFinishedTasks() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_finished_tasks;
+}
+
+// Run a task (run in a worker thread)
+/*! \details Initialization failures are fatal (the tasks replace
+ * initialization that used to be done on the GUI thread).
+ */
+void ParallelInitializer::runTask( ParallelInitializer* initializer,
+                                   const int task_index )
+{
+  QString name;
+  Task task;
+
+  {
+    QMutexLocker locker( &initializer->d_mutex );
+
+    name = initializer->d_tasks[task_index].name;
+    task = initializer->d_tasks[task_index].task;
+  }
+
+  try{
+    StartupProfiler::ScopedPhase phase( name );
+
+    task();
+  }
+  catch( const std::exception& exception )
+  {
+    qFatal( "ParallelInitializer Error: Task %s failed (%s)!",
+            name.toLatin1().data(),
+            exception.what() );
+  }
+
+  initializer->finishTask( task_index );
+}
+
+// Start a task (the mutex must be locked)
+void ParallelInitializer::startTask( const int task_index )
+{
+  QtConcurrent::run( ParallelInitializer::runTask, this, task_index );
+}
+
+// Finish a task and start the dependents that are ready
+void ParallelInitializer::finishTask( const int task_index )
+{
+  QMutexLocker locker( &d_mutex );
+
+  const QList<int> dependents = d_tasks[task_index].dependents;
+
+  for( int i = 0; i < dependents.size(); ++i )
+  {
+    if( --d_tasks[dependents[i]].unfinished_dependencies == 0 )
+      this->startTask( dependents[i] );
+  }
+
+  ++d_finished_tasks;
+
+  if( d_finished_tasks == d_tasks.size() )
+    d_finished_condition.wakeAll();
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end ParallelInitializer.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,120 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ParallelInitializer.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The parallel initializer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef PARALLEL_INITIALIZER_H
+#define PARALLEL_INITIALIZER_H
+
+// Std Lib Includes
+#include <functional>
+
+// Qt Includes
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace QtD1{
+
+/*! The parallel initializer
+ *
+ * Runs independent initialization tasks (e.g. decoding the bitmap fonts) in
+ * worker threads. A task is only started once all of the tasks that it
+ * depends on have finished. Every task is recorded as a startup phase (see
+ * StartupProfiler). The tasks must not create widgets - anything that must
+ * be done on the GUI thread should be done after waitForFinished.
+ */
+class ParallelInitializer
+{
+
+public:
+
+  //! The task type
+  typedef std::function<void()> Task;
+
+  //! Constructor
+  ParallelInitializer();
+
+  //! Destructor (waits for the tasks to finish)
+  ~ParallelInitializer();
+
+  //! Add a task (the dependencies must already have been added)
+  void addTask( const QString& name,
+                const Task& task,
+                const QStringList& dependencies = QStringList() );
+
+  //! Start the tasks that do not have any dependencies
+  void start();
+
+  //! Wait for all of the tasks to finish
+  void waitForFinished();
+
+  //! Check if all of the tasks have finished
+  bool isFinished() const;
+
+  //! Get the number of tasks
+  int getNumberOfTasks() const;
+
+  //! Get the number of tasks that have finished
+  int getNumberOfFinishedTasks() const;
+
+private:
+
+  // Constructors and assignment operator
+  ParallelInitializer( const ParallelInitializer& that );
+  ParallelInitializer& operator=( const ParallelInitializer& that );
+
+  // A task node
+  struct TaskNode{
+    // The task name
+    QString name;
+    // The task
+    Task task;
+    // The number of dependencies that have not finished
+    int unfinished_dependencies;
+    // The tasks that depend on this task
+    QList<int> dependents;
+  };
+
+  // Run a task (run in a worker thread)
+  static void runTask( ParallelInitializer* initializer,
+                       const int task_index );
+
+  // Start a task (the mutex must be locked)
+  void startTask( const int task_index );
+
+  // Finish a task and start the dependents that are ready
+  void finishTask( const int task_index );
+
+  // The task mutex
+  mutable QMutex d_mutex;
+
+  // The finished condition
+  QWaitCondition d_finished_condition;
+
+  // The task nodes
+  QVector<TaskNode> d_tasks;
+
+  // The task indices
+  QHash<QString,int> d_task_indices;
+
+  // The number of tasks that have finished
+  int d_finished_tasks;
+
+  // Records if the tasks have been started
+  bool d_started;
+};
+
+} // end QtD1 namespace
+
+#endif // end PARALLEL_INITIALIZER_H
+
+//---------------------------------------------------------------------------//
+// end ParallelInitializer.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,69 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ProjectileLayer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The projectile layer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// QtD1 Includes
+#include "ProjectileLayer.h"
+#include "Telemetry.h"
+
+namespace QtD1{
+
+// Constructor
+/*! \details The layer is drawn above the level objects.
+ */
+ProjectileLayer::ProjectileLayer( const ProjectilePool* pool,
+                                  QGraphicsItem* parent )
+  : QGraphicsItem( parent ),
+    d_pool( pool ),
+    d_bounding_rect()
+{
+  if( !pool )
+    qFatal( "ProjectileLayer Error: The projectile pool cannot be NULL!" );
+
+  this->setZValue( 1.0 );
+}
+
+// Update the layer after the projectiles have moved
+/*! \details Both the old and the new projectile bounds will be repainted.
+ */
+void ProjectileLayer::updateProjectiles()
+{
+  const QRectF bounding_rect = d_pool->getBoundingRect();
+
+  if( bounding_rect != d_bounding_rect )
+  {
+    this->prepareGeometryChange();
+
+    d_bounding_rect = bounding_rect;
+  }
+
+  if( !d_bounding_rect.isNull() )
+    this->update();
+}
+
+// Get the bounding rect of the layer
+QRectF ProjectileLayer::boundingRect() const
+{
+  return d_bounding_rect;
+}
+
+// Paint the projectiles
+void ProjectileLayer::paint( QPainter* painter,
+                             const QStyleOptionGraphicsItem*,
+                             QWidget* )
+{
+  Telemetry::ScopedTimer
+    paint_timer( Telemetry::ProjectilePaintTimeHistogram );
+
+  d_pool->paint( painter );
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end ProjectileLayer.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,63 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ProjectileLayer.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The projectile layer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef PROJECTILE_LAYER_H
+#define PROJECTILE_LAYER_H
+
+// Qt Includes
+#include <QGraphicsItem>
+
+// QtD1 Includes
+#include "ProjectilePool.h"
+
+namespace QtD1{
+
+/*! The projectile layer
+ *
+ * A single scene item that paints every projectile in a projectile pool in
+ * one batch (the projectiles are not scene items themselves).
+ */
+class ProjectileLayer : public QGraphicsItem
+{
+
+public:
+
+  //! Constructor
+  ProjectileLayer( const ProjectilePool* pool, QGraphicsItem* parent = 0 );
+
+  //! Destructor
+  ~ProjectileLayer()
+  { /* ... */ }
+
+  //! Update the layer after the projectiles have moved
+  void updateProjectiles();
+
+  //! Get the bounding rect of the layer
+  QRectF boundingRect() const override;
+
+  //! Paint the projectiles
+  void paint( QPainter* painter,
+              const QStyleOptionGraphicsItem* option,
+              QWidget* widget ) override;
+
+private:
+
+  // The projectile pool
+  const ProjectilePool* d_pool;
+
+  // The bounding rect
+  QRectF d_bounding_rect;
+};
+
+} // end QtD1 namespace
+
+#endif // end PROJECTILE_LAYER_H
+
+//---------------------------------------------------------------------------//
+// end ProjectileLayer.h
+//---------------------------------------------------------------------------//
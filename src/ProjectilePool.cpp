@@ -0,0 +1,388 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ProjectilePool.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The projectile pool class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+
+// QtD1 Includes
+#include "ProjectilePool.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int ProjectilePool::s_no_projectile;
+const int ProjectilePool::s_default_capacity;
+
+// Constructor
+ProjectilePool::ProjectilePool( const int capacity )
+  : d_sprites(),
+    d_max_sprite_size(),
+    d_size( 0 ),
+    d_x(),
+    d_y(),
+    d_velocity_x(),
+    d_velocity_y(),
+    d_remaining_lifetime(),
+    d_sprite(),
+    d_frame(),
+    d_base_damage(),
+    d_magic_damage(),
+    d_fire_damage(),
+    d_lightning_damage(),
+    d_caster(),
+    d_id(),
+    d_index(),
+    d_free_ids(),
+    d_bounding_rect()
+{
+  if( capacity < 1 )
+  {
+    qFatal( "ProjectilePool Error: Invalid capacity (%i)!", capacity );
+  }
+
+  while( this->getCapacity() < capacity )
+    this->grow();
+}
+
+// Register a sprite (returns the sprite id)
+/*! \details Projectiles that use the sprite will cycle through the frames
+ * (one frame per simulation tick).
+ */
+int ProjectilePool::registerSprite( const QVector<QPixmap>& frames )
+{
+  if( frames.empty() )
+    qFatal( "ProjectilePool Error: A sprite must have at least one frame!" );
+
+  for( int i = 0; i < frames.size(); ++i )
+  {
+    d_max_sprite_size =
+      d_max_sprite_size.expandedTo( QSizeF( frames[i].size() ) );
+  }
+
+  d_sprites << frames;
+
+  return d_sprites.size() - 1;
+}
+
+// Get the number of registered sprites
+int ProjectilePool::getNumberOfSprites() const
+{
+  return d_sprites.size();
+}
+
+// Spawn a projectile (returns the projectile id)
+/*! \details The pool will only allocate memory if it is full.
+ */
+int ProjectilePool::spawn( const SpawnParameters& parameters )
+{
+  if( parameters.sprite < 0 || parameters.sprite >= d_sprites.size() )
+  {
+    qFatal( "ProjectilePool Error: Sprite %i has not been registered!",
+            parameters.sprite );
+  }
+
+  if( d_free_ids.empty() )
+    this->grow();
+
+  const int projectile_id = d_free_ids.back();
+  d_free_ids.pop_back();
+
+  const int index = d_size++;
+
+  d_x[index] = parameters.position.x();
+  d_y[index] = parameters.position.y();
+  d_velocity_x[index] = parameters.velocity.x();
+  d_velocity_y[index] = parameters.velocity.y();
+  d_remaining_lifetime[index] = parameters.lifetime;
+  d_sprite[index] = parameters.sprite;
+  d_frame[index] = 0;
+  d_base_damage[index] = parameters.base_damage;
+  d_magic_damage[index] = parameters.magic_damage;
+  d_fire_damage[index] = parameters.fire_damage;
+  d_lightning_damage[index] = parameters.lightning_damage;
+  d_caster[index] = parameters.caster;
+  d_id[index] = projectile_id;
+  d_index[projectile_id] = index;
+
+  d_bounding_rect |= QRectF( parameters.position.x() -
+                             d_max_sprite_size.width()/2,
+                             parameters.position.y() -
+                             d_max_sprite_size.height()/2,
+                             d_max_sprite_size.width(),
+                             d_max_sprite_size.height() );
+
+  return projectile_id;
+}
+
+// Despawn a projectile
+void ProjectilePool::despawn( const int projectile_id )
+{
+  this->removeAt( this->getIndex( projectile_id ) );
+}
+
+// Despawn all projectiles
+void ProjectilePool::clear()
+{
+  while( d_size > 0 )
+    this->removeAt( d_size - 1 );
+
+  d_bounding_rect = QRectF();
+}
+
+// Check if a projectile is alive
+bool ProjectilePool::isAlive( const int projectile_id ) const
+{
+  if( projectile_id >= 0 && projectile_id < d_index.size() )
+    return d_index[projectile_id] >= 0;
+  else
+    return false;
+}
+
+// Get the number of live projectiles
+int ProjectilePool::getNumberOfProjectiles() const
+{
+  return d_size;
+}
+
+// Get the capacity (the pool grows if it is exceeded)
+int ProjectilePool::getCapacity() const
+{
+  return d_id.size();
+}
+
+// Get the id of the projectile stored at an index
+/*! \details The live projectiles are stored at indices [0,n). The index of a
+ * projectile can change when another projectile is despawned.
+ */
+int ProjectilePool::getProjectileId( const int index ) const
+{
+  return d_id[index];
+}
+
+// Get the position of a projectile
+QPointF ProjectilePool::getPosition( const int projectile_id ) const
+{
+  const int index = this->getIndex( projectile_id );
+
+  return QPointF( d_x[index], d_y[index] );
+}
+
+// Get the velocity of a projectile
+QPointF ProjectilePool::getVelocity( const int projectile_id ) const
+{
+  const int index = this->getIndex( projectile_id );
+
+  return QPointF( d_velocity_x[index], d_velocity_y[index] );
+}
+
+// Set the velocity of a projectile
+void ProjectilePool::setVelocity( const int projectile_id,
+                                  const QPointF& velocity )
+{
+  const int index = this->getIndex( projectile_id );
+
+  d_velocity_x[index] = velocity.x();
+  d_velocity_y[index] = velocity.y();
+}
+
+// Get the remaining lifetime of a projectile (simulation ticks)
+int ProjectilePool::getRemainingLifetime( const int projectile_id ) const
+{
+  return d_remaining_lifetime[this->getIndex( projectile_id )];
+}
+
+// Get the damage of a projectile
+ProjectilePool::Damage ProjectilePool::getDamage(
+                                             const int projectile_id ) const
+{
+  const int index = this->getIndex( projectile_id );
+
+  Damage damage = {d_base_damage[index],
+                   d_magic_damage[index],
+                   d_fire_damage[index],
+                   d_lightning_damage[index]};
+
+  return damage;
+}
+
+// Get the caster of a projectile
+const LevelObject* ProjectilePool::getCaster( const int projectile_id ) const
+{
+  return d_caster[this->getIndex( projectile_id )];
+}
+
+// Advance all projectiles by a simulation tick (returns # expired)
+/*! \details A projectile expires when its lifetime runs out. If a grid is
+ * given, projectiles also expire when they leave the grid or enter a tile
+ * that blocks missiles. The projectiles are visited from the back so that
+ * an expired projectile can be replaced by the last (already advanced)
+ * projectile without disturbing the loop.
+ */
+int ProjectilePool::advance( const LevelGrid* grid )
+{
+  int number_expired = 0;
+
+  for( int i = d_size - 1; i >= 0; --i )
+  {
+    d_x[i] += d_velocity_x[i];
+    d_y[i] += d_velocity_y[i];
+    ++d_frame[i];
+
+    bool expired = --d_remaining_lifetime[i] <= 0;
+
+    if( !expired && grid )
+    {
+      const QPoint tile = grid->mapToTile( QPointF( d_x[i], d_y[i] ) );
+
+      expired = !grid->isInside( tile.x(), tile.y() ) ||
+        (grid->getFlags( tile.x(), tile.y() ) & LevelGrid::BlocksMissiles);
+    }
+
+    if( expired )
+    {
+      this->removeAt( i );
+
+      ++number_expired;
+    }
+  }
+
+  this->updateBoundingRect();
+
+  return number_expired;
+}
+
+// Get the rect that bounds all projectile sprites
+QRectF ProjectilePool::getBoundingRect() const
+{
+  return d_bounding_rect;
+}
+
+// Paint all projectiles
+/*! \details The sprite frame of each projectile is centered on its
+ * position.
+ */
+void ProjectilePool::paint( QPainter* painter ) const
+{
+  for( int i = 0; i < d_size; ++i )
+  {
+    const QVector<QPixmap>& frames = d_sprites[d_sprite[i]];
+    const QPixmap& frame = frames[d_frame[i] % frames.size()];
+
+    painter->drawPixmap( QPointF( d_x[i] - frame.width()/2.0,
+                                  d_y[i] - frame.height()/2.0 ),
+                         frame );
+  }
+}
+
+// Grow the storage
+/*! \details The capacity is doubled. The new ids are pushed onto the free id
+ * stack in reverse so that the lowest ids are used first.
+ */
+void ProjectilePool::grow()
+{
+  const int old_capacity = this->getCapacity();
+  const int new_capacity = std::max( 2*old_capacity, 1 );
+
+  d_x.resize( new_capacity );
+  d_y.resize( new_capacity );
+  d_velocity_x.resize( new_capacity );
+  d_velocity_y.resize( new_capacity );
+  d_remaining_lifetime.resize( new_capacity );
+  d_sprite.resize( new_capacity );
+  d_frame.resize( new_capacity );
+  d_base_damage.resize( new_capacity );
+  d_magic_damage.resize( new_capacity );
+  d_fire_damage.resize( new_capacity );
+  d_lightning_damage.resize( new_capacity );
+  d_caster.resize( new_capacity );
+  d_id.resize( new_capacity );
+  d_index.resize( new_capacity );
+
+  d_free_ids.reserve( new_capacity );
+
+  for( int i = new_capacity - 1; i >= old_capacity; --i )
+  {
+    d_index[i] = -1;
+    d_free_ids << i;
+  }
+}
+
+// Remove the projectile stored at an index
+void ProjectilePool::removeAt( const int index )
+{
+  const int last_index = d_size - 1;
+
+  d_index[d_id[index]] = -1;
+  d_free_ids << d_id[index];
+
+  if( index != last_index )
+  {
+    d_x[index] = d_x[last_index];
+    d_y[index] = d_y[last_index];
+    d_velocity_x[index] = d_velocity_x[last_index];
+    d_velocity_y[index] = d_velocity_y[last_index];
+    d_remaining_lifetime[index] = d_remaining_lifetime[last_index];
+    d_sprite[index] = d_sprite[last_index];
+    d_frame[index] = d_frame[last_index];
+    d_base_damage[index] = d_base_damage[last_index];
+    d_magic_damage[index] = d_magic_damage[last_index];
+    d_fire_damage[index] = d_fire_damage[last_index];
+    d_lightning_damage[index] = d_lightning_damage[last_index];
+    d_caster[index] = d_caster[last_index];
+    d_id[index] = d_id[last_index];
+
+    d_index[d_id[index]] = index;
+  }
+
+  --d_size;
+}
+
+// Get the index of a projectile
+int ProjectilePool::getIndex( const int projectile_id ) const
+{
+  if( !this->isAlive( projectile_id ) )
+  {
+    qFatal( "ProjectilePool Error: Projectile %i is not alive!",
+            projectile_id );
+  }
+
+  return d_index[projectile_id];
+}
+
+// Update the bounding rect
+void ProjectilePool::updateBoundingRect()
+{
+  if( d_size == 0 )
+  {
+    d_bounding_rect = QRectF();
+
+    return;
+  }
+
+  qreal min_x = d_x[0], max_x = d_x[0];
+  qreal min_y = d_y[0], max_y = d_y[0];
+
+  for( int i = 1; i < d_size; ++i )
+  {
+    min_x = std::min( min_x, d_x[i] );
+    max_x = std::max( max_x, d_x[i] );
+    min_y = std::min( min_y, d_y[i] );
+    max_y = std::max( max_y, d_y[i] );
+  }
+
+  d_bounding_rect = QRectF( min_x - d_max_sprite_size.width()/2,
+                            min_y - d_max_sprite_size.height()/2,
+                            max_x - min_x + d_max_sprite_size.width(),
+                            max_y - min_y + d_max_sprite_size.height() );
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end ProjectilePool.cpp
+//---------------------------------------------------------------------------//
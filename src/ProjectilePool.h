@@ -0,0 +1,220 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ProjectilePool.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The projectile pool class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef PROJECTILE_POOL_H
+#define PROJECTILE_POOL_H
+
+// Qt Includes
+#include <QVector>
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include <QPixmap>
+#include <QPainter>
+
+// QtD1 Includes
+#include "LevelGrid.h"
+
+namespace QtD1{
+
+class LevelObject;
+
+/*! The projectile pool
+ *
+ * Projectiles (e.g. the bolts of a spell) are plain pool entries instead of
+ * individually allocated objects. The projectile data is stored as a
+ * structure of arrays that is kept dense: spawning appends to the arrays and
+ * despawning moves the last projectile into the freed entry, so the whole
+ * pool is advanced in one tight loop every simulation tick and painted in a
+ * single batch. Storage is only allocated when the pool grows beyond its
+ * capacity.
+ *
+ * Projectiles are referred to by id. The ids of despawned projectiles are
+ * recycled, so an id must not be used after its projectile has expired.
+ */
+class ProjectilePool
+{
+
+public:
+
+  //! The projectile spawn parameters
+  struct SpawnParameters{
+    //! The position (center of the sprite)
+    QPointF position;
+    //! The velocity (pixels per simulation tick)
+    QPointF velocity;
+    //! The lifetime (simulation ticks)
+    int lifetime;
+    //! The sprite id (see registerSprite)
+    int sprite;
+    //! The base damage
+    int base_damage;
+    //! The magic damage
+    int magic_damage;
+    //! The fire damage
+    int fire_damage;
+    //! The lightning damage
+    int lightning_damage;
+    //! The caster (can be NULL)
+    const LevelObject* caster;
+  };
+
+  //! The projectile damage
+  struct Damage{
+    int base;
+    int magic;
+    int fire;
+    int lightning;
+  };
+
+  //! The id returned when there is no projectile
+  static const int s_no_projectile = -1;
+
+  //! The default capacity
+  static const int s_default_capacity = 256;
+
+  //! Constructor
+  ProjectilePool( const int capacity = s_default_capacity );
+
+  //! Destructor
+  ~ProjectilePool()
+  { /* ... */ }
+
+  //! Register a sprite (returns the sprite id)
+  int registerSprite( const QVector<QPixmap>& frames );
+
+  //! Get the number of registered sprites
+  int getNumberOfSprites() const;
+
+  //! Spawn a projectile (returns the projectile id)
+  int spawn( const SpawnParameters& parameters );
+
+  //! Despawn a projectile
+  void despawn( const int projectile_id );
+
+  //! Despawn all projectiles
+  void clear();
+
+  //! Check if a projectile is alive
+  bool isAlive( const int projectile_id ) const;
+
+  //! Get the number of live projectiles
+  int getNumberOfProjectiles() const;
+
+  //! Get the capacity (the pool grows if it is exceeded)
+  int getCapacity() const;
+
+  //! Get the id of the projectile stored at an index
+  int getProjectileId( const int index ) const;
+
+  //! Get the position of a projectile
+  QPointF getPosition( const int projectile_id ) const;
+
+  //! Get the velocity of a projectile
+  QPointF getVelocity( const int projectile_id ) const;
+
+  //! Set the velocity of a projectile
+  void setVelocity( const int projectile_id, const QPointF& velocity );
+
+  //! Get the remaining lifetime of a projectile (simulation ticks)
+  int getRemainingLifetime( const int projectile_id ) const;
+
+  //! Get the damage of a projectile
+  Damage getDamage( const int projectile_id ) const;
+
+  //! Get the caster of a projectile
+  const LevelObject* getCaster( const int projectile_id ) const;
+
+  //! Advance all projectiles by a simulation tick (returns # expired)
+  int advance( const LevelGrid* grid = NULL );
+
+  //! Get the rect that bounds all projectile sprites
+  QRectF getBoundingRect() const;
+
+  //! Paint all projectiles
+  void paint( QPainter* painter ) const;
+
+private:
+
+  // Grow the storage
+  void grow();
+
+  // Remove the projectile stored at an index
+  void removeAt( const int index );
+
+  // Get the index of a projectile (qFatal if the projectile is not alive)
+  int getIndex( const int projectile_id ) const;
+
+  // Update the bounding rect
+  void updateBoundingRect();
+
+  // The registered sprites
+  QList<QVector<QPixmap> > d_sprites;
+
+  // The size of the largest registered sprite frame
+  QSizeF d_max_sprite_size;
+
+  // The number of live projectiles
+  int d_size;
+
+  // The x positions
+  QVector<qreal> d_x;
+
+  // The y positions
+  QVector<qreal> d_y;
+
+  // The x velocities
+  QVector<qreal> d_velocity_x;
+
+  // The y velocities
+  QVector<qreal> d_velocity_y;
+
+  // The remaining lifetimes
+  QVector<int> d_remaining_lifetime;
+
+  // The sprite ids
+  QVector<int> d_sprite;
+
+  // The sprite frames
+  QVector<int> d_frame;
+
+  // The base damage
+  QVector<int> d_base_damage;
+
+  // The magic damage
+  QVector<int> d_magic_damage;
+
+  // The fire damage
+  QVector<int> d_fire_damage;
+
+  // The lightning damage
+  QVector<int> d_lightning_damage;
+
+  // The casters
+  QVector<const LevelObject*> d_caster;
+
+  // The projectile id stored at each index
+  QVector<int> d_id;
+
+  // The index of each projectile id (-1 if the id is free)
+  QVector<int> d_index;
+
+  // The free projectile ids
+  QVector<int> d_free_ids;
+
+  // The rect that bounds all projectile sprites
+  QRectF d_bounding_rect;
+};
+
+} // end QtD1 namespace
+
+#endif // end PROJECTILE_POOL_H
+
+//---------------------------------------------------------------------------//
+// end ProjectilePool.h
+//---------------------------------------------------------------------------//
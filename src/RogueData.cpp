@@ -115,6 +115,13 @@ void RogueData::handleMagicChange( int, int )
 }
 
 void RogueData::handleLevelUp( const int )
+{
+  this->calculateBaseStats();
+
+  this->updateStats();
+}
+
+void RogueData::calculateBaseStats()
 {
   this->calculateBaseChanceToHitWithMelee();
   this->calculateBaseChanceToHitWithRanged();
@@ -122,8 +129,6 @@ void RogueData::handleLevelUp( const int )
   this->calculateBaseDamage();
   this->calculateBaseHealth();
   this->calculateBaseMana();
-
-  this->updateStats();
 }
 
 void RogueData::connectStatChangeSignalToRogueDataSlots()
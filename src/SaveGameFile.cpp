@@ -0,0 +1,409 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SaveGameFile.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The save game file class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QFile>
+#include <QDataStream>
+
+// QtD1 Includes
+#include "SaveGameFile.h"
+#include "qtd1_config.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const quint32 SaveGameFile::s_magic;
+const quint16 SaveGameFile::s_version;
+const int SaveGameFile::s_header_size;
+const int SaveGameFile::s_record_header_size;
+const int SaveGameFile::s_record_checksum_size;
+const char* SaveGameFile::s_temp_file_suffix = ".tmp";
+const char* SaveGameFile::s_backup_file_suffix = ".bak";
+
+// Get the record id of a section
+quint32 SaveGameFile::getRecordId( const Section section, const quint16 key )
+{
+  return (quint32)section << 16 | key;
+}
+
+// Serialize the sections of a state (the records are keyed by record id)
+QHash<quint32,QByteArray> SaveGameFile::serializeSections(
+                                                 const SaveGameState& state )
+{
+  QHash<quint32,QByteArray> sections;
+
+  sections[SaveGameFile::getRecordId( CharacterSection )] =
+    SaveGameFile::serializeCharacterSection( state );
+
+  sections[SaveGameFile::getRecordId( ItemSection )] =
+    SaveGameFile::serializeItemSection( state );
+
+  sections[SaveGameFile::getRecordId( QuestSection )] =
+    SaveGameFile::serializeQuestSection( state );
+
+  QList<int> level_numbers = state.getLevelNumbers();
+
+  QList<int>::const_iterator level_number_it, level_number_end;
+  level_number_it = level_numbers.begin();
+  level_number_end = level_numbers.end();
+
+  while( level_number_it != level_number_end )
+  {
+    sections[SaveGameFile::getRecordId( LevelSection, *level_number_it )] =
+      SaveGameFile::serializeLevelSection( state, *level_number_it );
+
+    ++level_number_it;
+  }
+
+  return sections;
+}
+
+// Create the file header
+QByteArray SaveGameFile::createHeader()
+{
+  QByteArray header;
+
+  QDataStream stream( &header, QIODevice::WriteOnly );
+  SaveGameFile::initializeStream( stream );
+
+  stream << s_magic << s_version << (quint16)0;
+
+  return header;
+}
+
+// Create a record
+QByteArray SaveGameFile::createRecord( const quint32 record_id,
+                                       const QByteArray& payload )
+{
+  QByteArray record;
+  record.reserve( s_record_header_size + payload.size() +
+                  s_record_checksum_size );
+
+  QDataStream stream( &record, QIODevice::WriteOnly );
+  SaveGameFile::initializeStream( stream );
+
+  stream << (quint8)(record_id >> 16)
+         << (quint16)(record_id & 0xFFFF)
+         << (quint32)payload.size();
+
+  stream.writeRawData( payload.constData(), payload.size() );
+
+  stream << qChecksum( payload.constData(), payload.size() );
+
+  return record;
+}
+
+// Read a save game file
+/*! \details The file is read with a single sequential read before it is
+ * parsed. If the file is missing, a full save was interrupted while it was
+ * replacing the file. In that case the new save (the temp file, which is
+ * complete before the file is replaced) is read. If that fails, the old save
+ * (the backup file) is read.
+ */
+bool SaveGameFile::read( const QString& file_name, SaveGameState& state )
+{
+  if( QFile::exists( file_name ) )
+    return SaveGameFile::readFile( file_name, state );
+
+  if( SaveGameFile::readFile( file_name + s_temp_file_suffix, state ) )
+    return true;
+
+  return SaveGameFile::readFile( file_name + s_backup_file_suffix, state );
+}
+
+// Read a save game file (without falling back to the other files)
+bool SaveGameFile::readFile( const QString& file_name, SaveGameState& state )
+{
+  QFile file( file_name );
+
+  if( !file.open( QIODevice::ReadOnly ) )
+    return false;
+
+  return SaveGameFile::parse( file.readAll(), state );
+}
+
+// Parse the save game file data
+/*! \details The data is only valid if it has a valid header and a character
+ * section. Records that follow a truncated or corrupt record are ignored.
+ */
+bool SaveGameFile::parse( const QByteArray& data, SaveGameState& state )
+{
+  if( data.size() < s_header_size )
+    return false;
+
+  QDataStream stream( data );
+  SaveGameFile::initializeStream( stream );
+
+  quint32 magic;
+  quint16 version, flags;
+
+  stream >> magic >> version >> flags;
+
+  if( magic != s_magic || version == 0 || version > s_version )
+    return false;
+
+  SaveGameState parsed_state;
+  bool character_section_parsed = false;
+
+  int position = s_header_size;
+
+  while( data.size() - position >= s_record_header_size )
+  {
+    quint8 section;
+    quint16 key;
+    quint32 payload_size;
+
+    stream >> section >> key >> payload_size;
+
+    position += s_record_header_size;
+
+    if( data.size() - position <
+        (qint64)payload_size + s_record_checksum_size )
+    {
+      qWarning( "SaveGameFile Warning: The last save game record is "
+                "truncated - it will be ignored!" );
+      break;
+    }
+
+    QByteArray payload = data.mid( position, payload_size );
+
+    stream.skipRawData( payload_size );
+
+    quint16 checksum;
+    stream >> checksum;
+
+    position += payload_size + s_record_checksum_size;
+
+    if( checksum != qChecksum( payload.constData(), payload.size() ) )
+    {
+      qWarning( "SaveGameFile Warning: A save game record is corrupt - it "
+                "and all records that follow it will be ignored!" );
+      break;
+    }
+
+    if( !SaveGameFile::deserializeSection( section,
+                                           key,
+                                           payload,
+                                           parsed_state ) )
+      return false;
+
+    if( section == CharacterSection )
+      character_section_parsed = true;
+  }
+
+  if( character_section_parsed )
+    state = parsed_state;
+
+  return character_section_parsed;
+}
+
+// Get the save game file name of a character
+QString SaveGameFile::getFileName( const QString& character_name )
+{
+  return QString( "%1/%2.sav" ).arg( SAVE_GAMES_DIR ).arg( character_name );
+}
+
+// Initialize a save game data stream
+void SaveGameFile::initializeStream( QDataStream& stream )
+{
+  stream.setByteOrder( QDataStream::LittleEndian );
+  stream.setVersion( QDataStream::Qt_4_6 );
+}
+
+// Serialize the character section
+QByteArray SaveGameFile::serializeCharacterSection(
+                                                 const SaveGameState& state )
+{
+  const SaveGameState::CharacterState& character_state =
+    state.getCharacterState();
+
+  QByteArray payload;
+
+  QDataStream stream( &payload, QIODevice::WriteOnly );
+  SaveGameFile::initializeStream( stream );
+
+  stream << character_state.name
+         << character_state.type
+         << character_state.level
+         << character_state.experience
+         << character_state.gold
+         << character_state.strength
+         << character_state.magic
+         << character_state.dexterity
+         << character_state.vitality
+         << character_state.health
+         << character_state.mana
+         << character_state.level_number
+         << character_state.position
+         << character_state.direction;
+
+  return payload;
+}
+
+// Serialize the item section
+QByteArray SaveGameFile::serializeItemSection( const SaveGameState& state )
+{
+  const QVector<SaveGameState::ItemState>& items = state.getItems();
+
+  QByteArray payload;
+
+  QDataStream stream( &payload, QIODevice::WriteOnly );
+  SaveGameFile::initializeStream( stream );
+
+  stream << (quint32)items.size();
+
+  for( int i = 0; i < items.size(); ++i )
+  {
+    stream << items[i].item_id
+           << items[i].location
+           << items[i].slot
+           << items[i].durability
+           << items[i].max_durability
+           << items[i].seed;
+  }
+
+  return payload;
+}
+
+// Serialize the quest section
+QByteArray SaveGameFile::serializeQuestSection( const SaveGameState& state )
+{
+  const QVector<SaveGameState::QuestState>& quest_states =
+    state.getQuestStates();
+
+  QByteArray payload;
+
+  QDataStream stream( &payload, QIODevice::WriteOnly );
+  SaveGameFile::initializeStream( stream );
+
+  stream << (quint8)quest_states.size();
+
+  for( int i = 0; i < quest_states.size(); ++i )
+    stream << quest_states[i].status << quest_states[i].progress;
+
+  return payload;
+}
+
+// Serialize a level section
+QByteArray SaveGameFile::serializeLevelSection( const SaveGameState& state,
+                                                const int level_number )
+{
+  SaveGameState::LevelState level_state =
+    state.getLevelState( level_number );
+
+  QByteArray payload;
+
+  QDataStream stream( &payload, QIODevice::WriteOnly );
+  SaveGameFile::initializeStream( stream );
+
+  stream << level_state.explored_squares
+         << level_state.killed_monsters
+         << level_state.used_objects;
+
+  return payload;
+}
+
+// Deserialize a section
+/*! \details Unknown sections are skipped.
+ */
+bool SaveGameFile::deserializeSection( const quint8 section,
+                                       const quint16 key,
+                                       const QByteArray& payload,
+                                       SaveGameState& state )
+{
+  QDataStream stream( payload );
+  SaveGameFile::initializeStream( stream );
+
+  switch( section )
+  {
+    case CharacterSection:
+    {
+      SaveGameState::CharacterState character_state;
+
+      stream >> character_state.name
+             >> character_state.type
+             >> character_state.level
+             >> character_state.experience
+             >> character_state.gold
+             >> character_state.strength
+             >> character_state.magic
+             >> character_state.dexterity
+             >> character_state.vitality
+             >> character_state.health
+             >> character_state.mana
+             >> character_state.level_number
+             >> character_state.position
+             >> character_state.direction;
+
+      state.setCharacterState( character_state );
+      break;
+    }
+    case ItemSection:
+    {
+      quint32 number_of_items;
+      stream >> number_of_items;
+
+      if( stream.status() != QDataStream::Ok ||
+          number_of_items > (quint32)payload.size() )
+        return false;
+
+      QVector<SaveGameState::ItemState> items( number_of_items );
+
+      for( int i = 0; i < items.size(); ++i )
+      {
+        stream >> items[i].item_id
+               >> items[i].location
+               >> items[i].slot
+               >> items[i].durability
+               >> items[i].max_durability
+               >> items[i].seed;
+      }
+
+      state.setItems( items );
+      break;
+    }
+    case QuestSection:
+    {
+      quint8 number_of_quests;
+      stream >> number_of_quests;
+
+      for( int i = 0; i < number_of_quests; ++i )
+      {
+        SaveGameState::QuestState quest_state;
+
+        stream >> quest_state.status >> quest_state.progress;
+
+        // Quests that this version does not know about are dropped
+        if( i < SaveGameState::s_number_of_quests )
+          state.setQuestState( (Quest::Type)i, quest_state );
+      }
+      break;
+    }
+    case LevelSection:
+    {
+      SaveGameState::LevelState level_state;
+
+      stream >> level_state.explored_squares
+             >> level_state.killed_monsters
+             >> level_state.used_objects;
+
+      state.setLevelState( key, level_state );
+      break;
+    }
+    default:
+      return true;
+  }
+
+  return stream.status() == QDataStream::Ok;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end SaveGameFile.cpp
+//---------------------------------------------------------------------------//
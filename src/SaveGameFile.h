@@ -0,0 +1,135 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SaveGameFile.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The save game file class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef SAVE_GAME_FILE_H
+#define SAVE_GAME_FILE_H
+
+// Qt Includes
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QHash>
+#include <QDataStream>
+
+// QtD1 Includes
+#include "SaveGameState.h"
+
+namespace QtD1{
+
+/*! The save game file
+ *
+ * A save game file starts with a header (the magic number and the format
+ * version) that is followed by a sequence of records. Each record holds
+ * one section of the save game state (the character, the items, the quest
+ * states or the state of one level): the section id, the section key (the
+ * level number of a level section), the payload size, the payload and a
+ * checksum of the payload. All values are stored little-endian.
+ *
+ * A full save writes one record for every section. An incremental save
+ * appends records for the sections that have changed since the last save -
+ * when a file is read the last record of a section wins. The whole file is
+ * read with a single sequential read. A truncated or corrupt trailing
+ * record (e.g. from an interrupted append) is ignored. Records with an
+ * unknown section id are skipped so that older readers can open newer
+ * files that only add sections.
+ */
+class SaveGameFile
+{
+
+public:
+
+  //! The sections
+  enum Section{
+    CharacterSection = 1,
+    ItemSection,
+    QuestSection,
+    LevelSection
+  };
+
+  //! The magic number
+  static const quint32 s_magic = 0x53314451; // "QD1S"
+
+  //! The format version
+  static const quint16 s_version = 1;
+
+  //! The header size (bytes)
+  static const int s_header_size = 8;
+
+  //! The record header size (bytes)
+  static const int s_record_header_size = 7;
+
+  //! The record checksum size (bytes)
+  static const int s_record_checksum_size = 2;
+
+  //! The suffix of the file that a full save is written to first
+  static const char* s_temp_file_suffix;
+
+  //! The suffix of the file that is replaced by a full save
+  static const char* s_backup_file_suffix;
+
+  //! Get the record id of a section
+  static quint32 getRecordId( const Section section, const quint16 key = 0 );
+
+  //! Serialize the sections of a state (the records are keyed by record id)
+  static QHash<quint32,QByteArray> serializeSections(
+                                                const SaveGameState& state );
+
+  //! Create the file header
+  static QByteArray createHeader();
+
+  //! Create a record
+  static QByteArray createRecord( const quint32 record_id,
+                                  const QByteArray& payload );
+
+  //! Read a save game file
+  static bool read( const QString& file_name, SaveGameState& state );
+
+  //! Parse the save game file data
+  static bool parse( const QByteArray& data, SaveGameState& state );
+
+  //! Get the save game file name of a character
+  static QString getFileName( const QString& character_name );
+
+private:
+
+  // Constructor
+  SaveGameFile();
+
+  // Read a save game file (without falling back to the other files)
+  static bool readFile( const QString& file_name, SaveGameState& state );
+
+  // Initialize a save game data stream
+  static void initializeStream( QDataStream& stream );
+
+  // Serialize the character section
+  static QByteArray serializeCharacterSection( const SaveGameState& state );
+
+  // Serialize the item section
+  static QByteArray serializeItemSection( const SaveGameState& state );
+
+  // Serialize the quest section
+  static QByteArray serializeQuestSection( const SaveGameState& state );
+
+  // Serialize a level section
+  static QByteArray serializeLevelSection( const SaveGameState& state,
+                                           const int level_number );
+
+  // Deserialize a section
+  static bool deserializeSection( const quint8 section,
+                                  const quint16 key,
+                                  const QByteArray& payload,
+                                  SaveGameState& state );
+};
+
+} // end QtD1 namespace
+
+#endif // end SAVE_GAME_FILE_H
+
+//---------------------------------------------------------------------------//
+// end SaveGameFile.h
+//---------------------------------------------------------------------------//
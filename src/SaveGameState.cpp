@@ -0,0 +1,164 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SaveGameState.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The save game state class definition
+//!
+//---------------------------------------------------------------------------//
+
+// QtD1 Includes
+#include "SaveGameState.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int SaveGameState::s_number_of_quests;
+
+// Constructor
+SaveGameState::SaveGameState()
+  : d_character_state(),
+    d_items(),
+    d_quest_states( s_number_of_quests, QuestState() ),
+    d_level_states()
+{ /* ... */ }
+
+// Set the character state
+void SaveGameState::setCharacterState( const CharacterState& character_state )
+{
+  d_character_state = character_state;
+}
+
+// Get the character state
+const SaveGameState::CharacterState&
+SaveGameState::getCharacterState() const
+{
+  return d_character_state;
+}
+
+// Set the items
+void SaveGameState::setItems( const QVector<ItemState>& items )
+{
+  d_items = items;
+}
+
+// Get the items
+const QVector<SaveGameState::ItemState>& SaveGameState::getItems() const
+{
+  return d_items;
+}
+
+// Set the state of a quest
+void SaveGameState::setQuestState( const Quest::Type quest,
+                                   const QuestState& quest_state )
+{
+  d_quest_states[quest] = quest_state;
+}
+
+// Get the state of a quest
+SaveGameState::QuestState SaveGameState::getQuestState(
+                                                const Quest::Type quest ) const
+{
+  return d_quest_states[quest];
+}
+
+// Get the quest states (indexed by quest type)
+const QVector<SaveGameState::QuestState>&
+SaveGameState::getQuestStates() const
+{
+  return d_quest_states;
+}
+
+// Set the state of a level
+void SaveGameState::setLevelState( const int level_number,
+                                   const LevelState& level_state )
+{
+  d_level_states[level_number] = level_state;
+}
+
+// Check if there is a state for a level
+bool SaveGameState::hasLevelState( const int level_number ) const
+{
+  return d_level_states.contains( level_number );
+}
+
+// Get the state of a level
+SaveGameState::LevelState SaveGameState::getLevelState(
+                                           const int level_number ) const
+{
+  return d_level_states.value( level_number );
+}
+
+// Get the level numbers that have a state
+QList<int> SaveGameState::getLevelNumbers() const
+{
+  return d_level_states.keys();
+}
+
+// Check if two states are equal
+bool SaveGameState::operator==( const SaveGameState& other_state ) const
+{
+  return d_character_state == other_state.d_character_state &&
+    d_items == other_state.d_items &&
+    d_quest_states == other_state.d_quest_states &&
+    d_level_states == other_state.d_level_states;
+}
+
+// Check if two states are not equal
+bool SaveGameState::operator!=( const SaveGameState& other_state ) const
+{
+  return !(*this == other_state);
+}
+
+// Check if two character states are equal
+bool operator==( const SaveGameState::CharacterState& lhs,
+                 const SaveGameState::CharacterState& rhs )
+{
+  return lhs.name == rhs.name &&
+    lhs.type == rhs.type &&
+    lhs.level == rhs.level &&
+    lhs.experience == rhs.experience &&
+    lhs.gold == rhs.gold &&
+    lhs.strength == rhs.strength &&
+    lhs.magic == rhs.magic &&
+    lhs.dexterity == rhs.dexterity &&
+    lhs.vitality == rhs.vitality &&
+    lhs.health == rhs.health &&
+    lhs.mana == rhs.mana &&
+    lhs.level_number == rhs.level_number &&
+    lhs.position == rhs.position &&
+    lhs.direction == rhs.direction;
+}
+
+// Check if two item states are equal
+bool operator==( const SaveGameState::ItemState& lhs,
+                 const SaveGameState::ItemState& rhs )
+{
+  return lhs.item_id == rhs.item_id &&
+    lhs.location == rhs.location &&
+    lhs.slot == rhs.slot &&
+    lhs.durability == rhs.durability &&
+    lhs.max_durability == rhs.max_durability &&
+    lhs.seed == rhs.seed;
+}
+
+// Check if two quest states are equal
+bool operator==( const SaveGameState::QuestState& lhs,
+                 const SaveGameState::QuestState& rhs )
+{
+  return lhs.status == rhs.status && lhs.progress == rhs.progress;
+}
+
+// Check if two level states are equal
+bool operator==( const SaveGameState::LevelState& lhs,
+                 const SaveGameState::LevelState& rhs )
+{
+  return lhs.explored_squares == rhs.explored_squares &&
+    lhs.killed_monsters == rhs.killed_monsters &&
+    lhs.used_objects == rhs.used_objects;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end SaveGameState.cpp
+//---------------------------------------------------------------------------//
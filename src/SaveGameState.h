@@ -0,0 +1,204 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SaveGameState.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The save game state class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef SAVE_GAME_STATE_H
+#define SAVE_GAME_STATE_H
+
+// Qt Includes
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QList>
+#include <QBitArray>
+#include <QPointF>
+
+// QtD1 Includes
+#include "Quest.h"
+
+namespace QtD1{
+
+/*! The save game state
+ *
+ * A save game state is an immutable snapshot of everything that is saved:
+ * the character, the inventory items, the quest states and the state of
+ * each level that has been visited. All of the containers are implicitly
+ * shared so taking a snapshot (and handing it to a save game writer that
+ * runs in a worker thread) is cheap.
+ */
+class SaveGameState
+{
+
+public:
+
+  //! The character state
+  struct CharacterState{
+    //! The name
+    QString name;
+    //! The character type
+    qint32 type;
+    //! The level
+    qint32 level;
+    //! The experience
+    qint32 experience;
+    //! The gold amount
+    qint32 gold;
+    //! The base strength
+    qint32 strength;
+    //! The base magic
+    qint32 magic;
+    //! The base dexterity
+    qint32 dexterity;
+    //! The base vitality
+    qint32 vitality;
+    //! The health
+    qint32 health;
+    //! The mana
+    qint32 mana;
+    //! The level that the character is in
+    qint32 level_number;
+    //! The position in the level
+    QPointF position;
+    //! The direction
+    qint32 direction;
+  };
+
+  //! The item locations
+  enum ItemLocation{
+    BodyItemLocation = 0,
+    GridItemLocation,
+    BeltItemLocation
+  };
+
+  //! The item state
+  struct ItemState{
+    //! The base item id
+    quint16 item_id;
+    //! The item location
+    quint8 location;
+    //! The slot in the item location
+    quint8 slot;
+    //! The durability
+    quint16 durability;
+    //! The max durability
+    quint16 max_durability;
+    //! The seed that the item affixes were generated from
+    quint32 seed;
+  };
+
+  //! The quest status
+  enum QuestStatus{
+    QuestNotStarted = 0,
+    QuestActive,
+    QuestCompleted
+  };
+
+  //! The quest state
+  struct QuestState{
+    //! The status
+    quint8 status;
+    //! The progress (quest specific)
+    quint8 progress;
+  };
+
+  //! The level state
+  struct LevelState{
+    //! The explored squares (automap)
+    QBitArray explored_squares;
+    //! The monsters that have been killed
+    QBitArray killed_monsters;
+    //! The level objects that have been used
+    QBitArray used_objects;
+  };
+
+  //! The number of quests
+  static const int s_number_of_quests = Quest::Diablo+1;
+
+  //! Constructor
+  SaveGameState();
+
+  //! Destructor
+  ~SaveGameState()
+  { /* ... */ }
+
+  //! Set the character state
+  void setCharacterState( const CharacterState& character_state );
+
+  //! Get the character state
+  const CharacterState& getCharacterState() const;
+
+  //! Set the items
+  void setItems( const QVector<ItemState>& items );
+
+  //! Get the items
+  const QVector<ItemState>& getItems() const;
+
+  //! Set the state of a quest
+  void setQuestState( const Quest::Type quest, const QuestState& quest_state );
+
+  //! Get the state of a quest
+  QuestState getQuestState( const Quest::Type quest ) const;
+
+  //! Get the quest states (indexed by quest type)
+  const QVector<QuestState>& getQuestStates() const;
+
+  //! Set the state of a level
+  void setLevelState( const int level_number, const LevelState& level_state );
+
+  //! Check if there is a state for a level
+  bool hasLevelState( const int level_number ) const;
+
+  //! Get the state of a level
+  LevelState getLevelState( const int level_number ) const;
+
+  //! Get the level numbers that have a state
+  QList<int> getLevelNumbers() const;
+
+  //! Check if two states are equal
+  bool operator==( const SaveGameState& other_state ) const;
+
+  //! Check if two states are not equal
+  bool operator!=( const SaveGameState& other_state ) const;
+
+private:
+
+  // The character state
+  CharacterState d_character_state;
+
+  // The items
+  QVector<ItemState> d_items;
+
+  // The quest states
+  QVector<QuestState> d_quest_states;
+
+  // The level states
+  QMap<int,LevelState> d_level_states;
+};
+
+//! Check if two character states are equal
+bool operator==( const SaveGameState::CharacterState& lhs,
+                 const SaveGameState::CharacterState& rhs );
+
+//! Check if two item states are equal
+bool operator==( const SaveGameState::ItemState& lhs,
+                 const SaveGameState::ItemState& rhs );
+
+//! Check if two quest states are equal
+bool operator==( const SaveGameState::QuestState& lhs,
+                 const SaveGameState::QuestState& rhs );
+
+//! Check if two level states are equal
+bool operator==( const SaveGameState::LevelState& lhs,
+                 const SaveGameState::LevelState& rhs );
+
+} // end QtD1 namespace
+
+#endif // end SAVE_GAME_STATE_H
+
+//---------------------------------------------------------------------------//
+// end SaveGameState.h
+//---------------------------------------------------------------------------//
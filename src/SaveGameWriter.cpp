@@ -0,0 +1,417 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SaveGameWriter.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The save game writer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+
+// Qt Includes
+#include <QtConcurrentRun>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+// QtD1 Includes
+#include "SaveGameWriter.h"
+#include "SaveGameFile.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int SaveGameWriter::s_compaction_factor;
+
+// Constructor
+SaveGameWriter::SaveGameWriter( QObject* parent )
+  : QObject( parent ),
+    d_file_name(),
+    d_written_sections(),
+    d_file_size( 0 ),
+    d_compacted_file_size( 0 ),
+    d_records_written( 0 ),
+    d_save_in_progress( false ),
+    d_save_deferred( false ),
+    d_deferred_state(),
+    d_deferred_save_full( false ),
+    d_save_future(),
+    d_save_future_watcher()
+{
+  QObject::connect( &d_save_future_watcher, SIGNAL(finished()),
+                    this, SLOT(handleAsyncSaveFinished()) );
+}
+
+// Destructor
+/*! \details A save that is being written (and any deferred save) will be
+ * finished before the writer is destroyed.
+ */
+SaveGameWriter::~SaveGameWriter()
+{
+  this->waitForSaveToFinish();
+}
+
+// Set the save game file name
+/*! \details The sections that have been written to the previous file are
+ * forgotten - the next save will be a full save.
+ */
+void SaveGameWriter::setFileName( const QString& file_name )
+{
+  this->waitForSaveToFinish();
+
+  d_file_name = file_name;
+  d_written_sections.clear();
+  d_file_size = 0;
+  d_compacted_file_size = 0;
+}
+
+// Get the save game file name
+QString SaveGameWriter::getFileName() const
+{
+  return d_file_name;
+}
+
+// Write a full save
+void SaveGameWriter::save( const SaveGameState& state )
+{
+  this->startSave( state, true );
+}
+
+// Write an incremental save
+/*! \details If the file has not been written by this writer yet a full save
+ * will be written instead.
+ */
+void SaveGameWriter::saveIncremental( const SaveGameState& state )
+{
+  this->startSave( state, false );
+}
+
+// Write a full save synchronously
+bool SaveGameWriter::saveSync( const SaveGameState& state )
+{
+  this->waitForSaveToFinish();
+
+  emit saveStarted();
+
+  SaveResult result =
+    SaveGameWriter::writeSave( this->createSaveJob( state, true ) );
+
+  this->finishSave( result );
+
+  return result.success;
+}
+
+// Write an incremental save synchronously
+bool SaveGameWriter::saveIncrementalSync( const SaveGameState& state )
+{
+  this->waitForSaveToFinish();
+
+  emit saveStarted();
+
+  SaveResult result =
+    SaveGameWriter::writeSave( this->createSaveJob( state, false ) );
+
+  this->finishSave( result );
+
+  return result.success;
+}
+
+// Check if a save is being written (or is waiting to be written)
+bool SaveGameWriter::isSaving() const
+{
+  return d_save_in_progress || d_save_deferred;
+}
+
+// Wait for the save (and any deferred saves) to finish
+void SaveGameWriter::waitForSaveToFinish()
+{
+  while( d_save_in_progress )
+  {
+    d_save_future.waitForFinished();
+
+    d_save_in_progress = false;
+
+    this->finishSave( d_save_future.result() );
+  }
+}
+
+// Get the size of the save game file (bytes)
+qint64 SaveGameWriter::getFileSize() const
+{
+  return d_file_size;
+}
+
+// Get the number of records that were written by the last save
+int SaveGameWriter::getNumberOfRecordsWritten() const
+{
+  return d_records_written;
+}
+
+// Handle async save finished
+void SaveGameWriter::handleAsyncSaveFinished()
+{
+  // The save may have already been finished by waitForSaveToFinish
+  if( d_save_in_progress && d_save_future.isFinished() )
+  {
+    d_save_in_progress = false;
+
+    this->finishSave( d_save_future.result() );
+  }
+}
+
+// Create a save job
+SaveGameWriter::SaveJob SaveGameWriter::createSaveJob(
+                                                const SaveGameState& state,
+                                                const bool full ) const
+{
+  SaveJob job;
+  job.file_name = d_file_name;
+  job.state = state;
+  job.full = full;
+  job.written_sections = d_written_sections;
+  job.file_size = d_file_size;
+  job.compacted_file_size = d_compacted_file_size;
+
+  return job;
+}
+
+// Start a save
+/*! \details The state is copied into the save job - the containers of the
+ * state are implicitly shared so this is cheap and the worker thread never
+ * sees later changes to the game state.
+ */
+void SaveGameWriter::startSave( const SaveGameState& state, const bool full )
+{
+  if( d_file_name.isEmpty() )
+  {
+    qWarning( "SaveGameWriter Warning: No save game file name has been "
+              "set - the game cannot be saved!" );
+    return;
+  }
+
+  if( d_save_in_progress )
+  {
+    d_deferred_save_full =
+      d_save_deferred ? d_deferred_save_full || full : full;
+    d_deferred_state = state;
+    d_save_deferred = true;
+
+    return;
+  }
+
+  d_save_in_progress = true;
+
+  emit saveStarted();
+
+  d_save_future = QtConcurrent::run( SaveGameWriter::writeSave,
+                                     this->createSaveJob( state, full ) );
+
+  d_save_future_watcher.setFuture( d_save_future );
+}
+
+// Finish a save
+void SaveGameWriter::finishSave( const SaveResult& result )
+{
+  d_written_sections = result.written_sections;
+  d_file_size = result.file_size;
+  d_compacted_file_size = result.compacted_file_size;
+  d_records_written = result.records_written;
+
+  emit saveFinished( result.success );
+
+  // Start the deferred save
+  if( d_save_deferred )
+  {
+    SaveGameState deferred_state = d_deferred_state;
+
+    d_deferred_state = SaveGameState();
+    d_save_deferred = false;
+
+    this->startSave( deferred_state, d_deferred_save_full );
+  }
+}
+
+// Write a save (run in a worker thread)
+/*! \details An incremental save becomes a full save if the file has not
+ * been written yet or if it needs to be compacted.
+ */
+SaveGameWriter::SaveResult SaveGameWriter::writeSave( const SaveJob& job )
+{
+  QHash<quint32,QByteArray> sections =
+    SaveGameFile::serializeSections( job.state );
+
+  if( job.full ||
+      job.written_sections.isEmpty() ||
+      job.file_size > s_compaction_factor*job.compacted_file_size ||
+      !QFile::exists( job.file_name ) )
+    return SaveGameWriter::writeFullSave( job, sections );
+  else
+    return SaveGameWriter::writeIncrementalSave( job, sections );
+}
+
+// Write a full save
+/*! \details The file is written to a temporary file that replaces the
+ * previous file once it has been written successfully.
+ */
+SaveGameWriter::SaveResult SaveGameWriter::writeFullSave(
+                                 const SaveJob& job,
+                                 const QHash<quint32,QByteArray>& sections )
+{
+  SaveResult result;
+  result.success = false;
+  result.file_size = 0;
+  result.compacted_file_size = 0;
+  result.records_written = 0;
+
+  // The records are written in section order
+  QList<quint32> record_ids = sections.keys();
+  std::sort( record_ids.begin(), record_ids.end() );
+
+  QByteArray data = SaveGameFile::createHeader();
+
+  for( int i = 0; i < record_ids.size(); ++i )
+  {
+    data += SaveGameFile::createRecord( record_ids[i],
+                                        sections[record_ids[i]] );
+  }
+
+  QDir().mkpath( QFileInfo( job.file_name ).absolutePath() );
+
+  const QString temp_file_name =
+    job.file_name + SaveGameFile::s_temp_file_suffix;
+  const QString backup_file_name =
+    job.file_name + SaveGameFile::s_backup_file_suffix;
+
+  QFile temp_file( temp_file_name );
+
+  if( !temp_file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ||
+      temp_file.write( data ) != data.size() ||
+      !temp_file.flush() )
+  {
+    qWarning( "SaveGameWriter Warning: Could not write save game file %s!",
+              temp_file_name.toLatin1().data() );
+    return result;
+  }
+
+  temp_file.close();
+
+  // The old save is kept as a backup until the new save has replaced it (a
+  // save game file is always available - see SaveGameFile::read)
+  QFile::remove( backup_file_name );
+
+  if( QFile::exists( job.file_name ) &&
+      !QFile::rename( job.file_name, backup_file_name ) )
+  {
+    qWarning( "SaveGameWriter Warning: Could not back up save game file %s!",
+              job.file_name.toLatin1().data() );
+    return result;
+  }
+
+  if( !QFile::rename( temp_file_name, job.file_name ) )
+  {
+    qWarning( "SaveGameWriter Warning: Could not replace save game file %s!",
+              job.file_name.toLatin1().data() );
+
+    QFile::rename( backup_file_name, job.file_name );
+
+    return result;
+  }
+
+  QFile::remove( backup_file_name );
+
+  result.success = true;
+  result.written_sections = sections;
+  result.file_size = data.size();
+  result.compacted_file_size = data.size();
+  result.records_written = record_ids.size();
+
+  return result;
+}
+
+// Write an incremental save
+/*! \details Only the sections that have changed since the last save are
+ * appended. If the file has been changed by someone else a full save is
+ * written instead.
+ */
+SaveGameWriter::SaveResult SaveGameWriter::writeIncrementalSave(
+                                 const SaveJob& job,
+                                 const QHash<quint32,QByteArray>& sections )
+{
+  SaveResult result;
+  result.success = false;
+  result.written_sections = job.written_sections;
+  result.file_size = job.file_size;
+  result.compacted_file_size = job.compacted_file_size;
+  result.records_written = 0;
+
+  QByteArray data;
+
+  QHash<quint32,QByteArray>::const_iterator section_it, section_end;
+  section_it = sections.begin();
+  section_end = sections.end();
+
+  while( section_it != section_end )
+  {
+    if( job.written_sections.value( section_it.key() ) != section_it.value() )
+    {
+      data += SaveGameFile::createRecord( section_it.key(),
+                                          section_it.value() );
+
+      result.written_sections[section_it.key()] = section_it.value();
+      ++result.records_written;
+    }
+
+    ++section_it;
+  }
+
+  // Nothing has changed
+  if( result.records_written == 0 )
+  {
+    result.success = true;
+
+    return result;
+  }
+
+  QFile file( job.file_name );
+
+  if( !file.open( QIODevice::WriteOnly | QIODevice::Append ) )
+  {
+    qWarning( "SaveGameWriter Warning: Could not open save game file %s!",
+              job.file_name.toLatin1().data() );
+
+    // The next save will be a full save
+    result.written_sections.clear();
+
+    return result;
+  }
+
+  if( file.size() != job.file_size )
+  {
+    file.close();
+
+    return SaveGameWriter::writeFullSave( job, sections );
+  }
+
+  if( file.write( data ) != data.size() || !file.flush() )
+  {
+    qWarning( "SaveGameWriter Warning: Could not append to save game file "
+              "%s!", job.file_name.toLatin1().data() );
+
+    // The next save will be a full save
+    result.written_sections.clear();
+
+    return result;
+  }
+
+  result.success = true;
+  result.file_size += data.size();
+
+  return result;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end SaveGameWriter.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,191 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SaveGameWriter.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The save game writer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef SAVE_GAME_WRITER_H
+#define SAVE_GAME_WRITER_H
+
+// Qt Includes
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QByteArray>
+#include <QFuture>
+#include <QFutureWatcher>
+
+// QtD1 Includes
+#include "SaveGameState.h"
+
+namespace QtD1{
+
+/*! The save game writer
+ *
+ * Save game states are serialized and written by a worker thread so that
+ * saving never stalls the GUI thread. A full save rewrites the file (it is
+ * written to a temporary file first so that an interrupted save never
+ * corrupts the previous save). An incremental save (autosave) only appends
+ * the sections that have changed since the last save. Once the appended
+ * sections make the file much larger than the last full save the next
+ * incremental save becomes a full save (the file is compacted).
+ *
+ * Only one save is written at a time. A save that is requested while
+ * another save is being written is deferred - if several saves are
+ * deferred only the most recent state is written.
+ */
+class SaveGameWriter : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  //! The file compaction factor
+  static const int s_compaction_factor = 4;
+
+  //! Constructor
+  SaveGameWriter( QObject* parent = 0 );
+
+  //! Destructor
+  ~SaveGameWriter();
+
+  //! Set the save game file name
+  void setFileName( const QString& file_name );
+
+  //! Get the save game file name
+  QString getFileName() const;
+
+  //! Write a full save
+  void save( const SaveGameState& state );
+
+  //! Write an incremental save
+  void saveIncremental( const SaveGameState& state );
+
+  //! Write a full save synchronously
+  bool saveSync( const SaveGameState& state );
+
+  //! Write an incremental save synchronously
+  bool saveIncrementalSync( const SaveGameState& state );
+
+  //! Check if a save is being written (or is waiting to be written)
+  bool isSaving() const;
+
+  //! Wait for the save (and any deferred saves) to finish
+  void waitForSaveToFinish();
+
+  //! Get the size of the save game file (bytes)
+  qint64 getFileSize() const;
+
+  //! Get the number of records that were written by the last save
+  int getNumberOfRecordsWritten() const;
+
+signals:
+
+  //! A save has been started
+  void saveStarted();
+
+  //! A save has finished
+  void saveFinished( const bool success );
+
+private slots:
+
+  // Handle async save finished
+  void handleAsyncSaveFinished();
+
+private:
+
+  // A save job
+  struct SaveJob{
+    // The save game file name
+    QString file_name;
+    // The state to save
+    SaveGameState state;
+    // Write a full save
+    bool full;
+    // The sections that are in the file
+    QHash<quint32,QByteArray> written_sections;
+    // The file size
+    qint64 file_size;
+    // The file size after the last full save
+    qint64 compacted_file_size;
+  };
+
+  // A save result
+  struct SaveResult{
+    // The save succeeded
+    bool success;
+    // The sections that are in the file
+    QHash<quint32,QByteArray> written_sections;
+    // The file size
+    qint64 file_size;
+    // The file size after the last full save
+    qint64 compacted_file_size;
+    // The number of records that were written
+    int records_written;
+  };
+
+  // Create a save job
+  SaveJob createSaveJob( const SaveGameState& state, const bool full ) const;
+
+  // Start a save
+  void startSave( const SaveGameState& state, const bool full );
+
+  // Finish a save
+  void finishSave( const SaveResult& result );
+
+  // Write a save (run in a worker thread)
+  static SaveResult writeSave( const SaveJob& job );
+
+  // Write a full save
+  static SaveResult writeFullSave(
+                          const SaveJob& job,
+                          const QHash<quint32,QByteArray>& sections );
+
+  // Write an incremental save
+  static SaveResult writeIncrementalSave(
+                          const SaveJob& job,
+                          const QHash<quint32,QByteArray>& sections );
+
+  // The save game file name
+  QString d_file_name;
+
+  // The sections that are in the file
+  QHash<quint32,QByteArray> d_written_sections;
+
+  // The file size
+  qint64 d_file_size;
+
+  // The file size after the last full save
+  qint64 d_compacted_file_size;
+
+  // The number of records that were written by the last save
+  int d_records_written;
+
+  // Records if a save is being written
+  bool d_save_in_progress;
+
+  // Records if a save has been deferred
+  bool d_save_deferred;
+
+  // The deferred state
+  SaveGameState d_deferred_state;
+
+  // Records if the deferred save is a full save
+  bool d_deferred_save_full;
+
+  // The save future
+  QFuture<SaveResult> d_save_future;
+
+  // The save future watcher
+  QFutureWatcher<SaveResult> d_save_future_watcher;
+};
+
+} // end QtD1 namespace
+
+#endif // end SAVE_GAME_WRITER_H
+
+//---------------------------------------------------------------------------//
+// end SaveGameWriter.h
+//---------------------------------------------------------------------------//
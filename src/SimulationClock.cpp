@@ -0,0 +1,199 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SimulationClock.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The fixed time step simulation clock class definition
+//!
+//---------------------------------------------------------------------------//
+
+// QtD1 Includes
+#include "SimulationClock.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const qreal SimulationClock::s_running_average_weight = 0.1;
+
+// Constructor
+SimulationClock::SimulationClock( const int tick_duration,
+                                  const int max_catch_up_ticks )
+  : d_tick_duration( tick_duration ),
+    d_max_catch_up_ticks( max_catch_up_ticks ),
+    d_frame_timer(),
+    d_tick_timer(),
+    d_accumulated_time( 0 ),
+    d_number_of_ticks( 0 ),
+    d_number_of_frames( 0 ),
+    d_number_of_dropped_ticks( 0 ),
+    d_average_tick_time( 0.0 ),
+    d_average_frame_time( tick_duration )
+{
+  if( tick_duration <= 0 )
+  {
+    qFatal( "SimulationClock Error: The tick duration must be greater than "
+            "zero!" );
+  }
+
+  if( max_catch_up_ticks <= 0 )
+  {
+    qFatal( "SimulationClock Error: The max number of catch-up ticks must be "
+            "greater than zero!" );
+  }
+}
+
+// Get the tick duration (ms)
+int SimulationClock::getTickDuration() const
+{
+  return d_tick_duration;
+}
+
+// Get the max number of ticks that will be requested in a single frame
+int SimulationClock::getMaxCatchUpTicks() const
+{
+  return d_max_catch_up_ticks;
+}
+
+// Start (or restart) the clock
+/*! \details Any time that accumulated before the clock was stopped will be
+ * discarded so that a paused game does not try to catch up when it resumes.
+ */
+void SimulationClock::start()
+{
+  d_accumulated_time = 0;
+
+  d_frame_timer.start();
+}
+
+// Stop the clock
+void SimulationClock::stop()
+{
+  d_frame_timer.invalidate();
+}
+
+// Check if the clock is running
+bool SimulationClock::isRunning() const
+{
+  return d_frame_timer.isValid();
+}
+
+// Start a new frame and return the number of ticks that must be simulated
+int SimulationClock::startFrame()
+{
+  if( !this->isRunning() )
+    return 0;
+
+  qint64 elapsed_time = d_frame_timer.nsecsElapsed();
+
+  d_frame_timer.restart();
+
+  return this->startFrame( elapsed_time );
+}
+
+// Start a new frame with the elapsed time (ns) and return the ticks
+int SimulationClock::startFrame( const qint64 elapsed_time )
+{
+  ++d_number_of_frames;
+
+  SimulationClock::updateRunningAverage( d_average_frame_time,
+                                         (qreal)elapsed_time/s_ns_per_ms );
+
+  d_accumulated_time += elapsed_time;
+
+  const qint64 tick_duration = d_tick_duration*s_ns_per_ms;
+
+  int number_of_ticks = d_accumulated_time/tick_duration;
+
+  d_accumulated_time -= number_of_ticks*tick_duration;
+
+  // Drop the ticks that we cannot catch up on (the game will slow down
+  // instead of spiraling further behind)
+  if( number_of_ticks > d_max_catch_up_ticks )
+  {
+    d_number_of_dropped_ticks += number_of_ticks - d_max_catch_up_ticks;
+
+    number_of_ticks = d_max_catch_up_ticks;
+  }
+
+  return number_of_ticks;
+}
+
+// Get the interpolation fraction for rendering the current frame
+/*! \details The fraction will always be in [0,1).
+ */
+qreal SimulationClock::getInterpolationFraction() const
+{
+  return (qreal)d_accumulated_time/(d_tick_duration*s_ns_per_ms);
+}
+
+// Start timing a simulation tick
+void SimulationClock::startTick()
+{
+  d_tick_timer.start();
+}
+
+// Finish timing a simulation tick
+void SimulationClock::finishTick()
+{
+  ++d_number_of_ticks;
+
+  if( d_tick_timer.isValid() )
+  {
+    SimulationClock::updateRunningAverage(
+                  d_average_tick_time,
+                  (qreal)d_tick_timer.nsecsElapsed()/s_ns_per_ms );
+
+    d_tick_timer.invalidate();
+  }
+}
+
+// Get the total number of simulated ticks
+qint64 SimulationClock::getNumberOfTicks() const
+{
+  return d_number_of_ticks;
+}
+
+// Get the total number of frames
+qint64 SimulationClock::getNumberOfFrames() const
+{
+  return d_number_of_frames;
+}
+
+// Get the total number of ticks that were dropped (fell too far behind)
+qint64 SimulationClock::getNumberOfDroppedTicks() const
+{
+  return d_number_of_dropped_ticks;
+}
+
+// Get the average time (ms) required to simulate a tick
+qreal SimulationClock::getAverageTickTime() const
+{
+  return d_average_tick_time;
+}
+
+// Get the average time (ms) between frames
+qreal SimulationClock::getAverageFrameTime() const
+{
+  return d_average_frame_time;
+}
+
+// Get the average frame rate (frames per second)
+qreal SimulationClock::getFrameRate() const
+{
+  if( d_average_frame_time > 0.0 )
+    return 1000.0/d_average_frame_time;
+  else
+    return 0.0;
+}
+
+// Update a running average
+void SimulationClock::updateRunningAverage( qreal& average,
+                                            const qreal sample )
+{
+  average += s_running_average_weight*(sample - average);
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end SimulationClock.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,135 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SimulationClock.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The fixed time step simulation clock class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef SIMULATION_CLOCK_H
+#define SIMULATION_CLOCK_H
+
+// Qt Includes
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+namespace QtD1{
+
+/*! The fixed time step simulation clock
+ *
+ * The clock accumulates the real time that has elapsed between frames and
+ * hands it out in fixed size ticks. If the frames fall behind, several ticks
+ * will be requested in a single frame (up to the max number of catch-up
+ * ticks). The remaining time is reported as an interpolation fraction that
+ * can be used to place items between their last two simulated positions.
+ */
+class SimulationClock
+{
+
+public:
+
+  //! Constructor
+  SimulationClock( const int tick_duration,
+                   const int max_catch_up_ticks = 5 );
+
+  //! Destructor
+  ~SimulationClock()
+  { /* ... */ }
+
+  //! Get the tick duration (ms)
+  int getTickDuration() const;
+
+  //! Get the max number of ticks that will be requested in a single frame
+  int getMaxCatchUpTicks() const;
+
+  //! Start (or restart) the clock
+  void start();
+
+  //! Stop the clock
+  void stop();
+
+  //! Check if the clock is running
+  bool isRunning() const;
+
+  //! Start a new frame and return the number of ticks that must be simulated
+  int startFrame();
+
+  //! Start a new frame with the elapsed time (ns) and return the ticks
+  int startFrame( const qint64 elapsed_time );
+
+  //! Get the interpolation fraction for rendering the current frame
+  qreal getInterpolationFraction() const;
+
+  //! Start timing a simulation tick
+  void startTick();
+
+  //! Finish timing a simulation tick
+  void finishTick();
+
+  //! Get the total number of simulated ticks
+  qint64 getNumberOfTicks() const;
+
+  //! Get the total number of frames
+  qint64 getNumberOfFrames() const;
+
+  //! Get the total number of ticks that were dropped (fell too far behind)
+  qint64 getNumberOfDroppedTicks() const;
+
+  //! Get the average time (ms) required to simulate a tick
+  qreal getAverageTickTime() const;
+
+  //! Get the average time (ms) between frames
+  qreal getAverageFrameTime() const;
+
+  //! Get the average frame rate (frames per second)
+  qreal getFrameRate() const;
+
+private:
+
+  // Update a running average
+  static void updateRunningAverage( qreal& average, const qreal sample );
+
+  // The number of nanoseconds in a millisecond
+  static const qint64 s_ns_per_ms = 1000000;
+
+  // The running average weight
+  static const qreal s_running_average_weight;
+
+  // The tick duration (ms)
+  int d_tick_duration;
+
+  // The max number of catch-up ticks in a single frame
+  int d_max_catch_up_ticks;
+
+  // The frame timer
+  QElapsedTimer d_frame_timer;
+
+  // The tick timer
+  QElapsedTimer d_tick_timer;
+
+  // The accumulated time that has not been simulated yet (ns)
+  qint64 d_accumulated_time;
+
+  // The total number of simulated ticks
+  qint64 d_number_of_ticks;
+
+  // The total number of frames
+  qint64 d_number_of_frames;
+
+  // The total number of dropped ticks
+  qint64 d_number_of_dropped_ticks;
+
+  // The average tick time (ms)
+  qreal d_average_tick_time;
+
+  // The average frame time (ms)
+  qreal d_average_frame_time;
+};
+
+} // end QtD1 namespace
+
+#endif // end SIMULATION_CLOCK_H
+
+//---------------------------------------------------------------------------//
+// end SimulationClock.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,633 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SoftwareMixer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The software mixer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Qt Includes
+#include <QMutexLocker>
+
+// QtD1 Includes
+#include "SoftwareMixer.h"
+#include "AudioDevice.h"
+
+namespace QtD1{
+
+// Initialize static member data
+const int SoftwareMixer::s_number_of_buses;
+const int SoftwareMixer::s_max_number_of_voices;
+const int SoftwareMixer::s_command_queue_size;
+const int SoftwareMixer::s_block_size;
+std::unique_ptr<SoftwareMixer> SoftwareMixer::s_instance;
+QMutex SoftwareMixer::s_instance_mutex;
+
+// Get the singleton instance
+SoftwareMixer* SoftwareMixer::getInstance()
+{
+  QMutexLocker instance_locker( &s_instance_mutex );
+
+  // Just-in-time initialization
+  if( !s_instance )
+    s_instance.reset( new SoftwareMixer );
+
+  return s_instance.get();
+}
+
+// Constructor
+/*! \details The mixer format defaults to the default audio device format
+ * until the mixer is enabled.
+ */
+SoftwareMixer::SoftwareMixer()
+  : d_enabled( false ),
+    d_mix_callback_registered( false ),
+    d_frequency( 44100 ),
+    d_number_of_channels( 2 ),
+    d_next_voice_id( 0 ),
+    d_voice_samples(),
+    d_commands( s_command_queue_size ),
+    d_finished_voices( s_command_queue_size ),
+    d_voices(),
+    d_bus_buffers( s_number_of_buses*s_block_size*d_number_of_channels ),
+    d_mix_buffer( s_block_size*d_number_of_channels ),
+    d_playing_voices( 0 ),
+    d_dropped_sounds( 0 ),
+    d_mixed_frames( 0 )
+{
+  d_voices.reserve( s_max_number_of_voices );
+
+  for( int i = 0; i < s_number_of_buses; ++i )
+    d_bus_volumes[i].store( MIX_MAX_VOLUME );
+}
+
+// Destructor
+/*! \details The mix callback is only unregistered if the audio device is
+ * still open (closing the audio device unregisters it).
+ */
+SoftwareMixer::~SoftwareMixer()
+{
+  if( d_mix_callback_registered && Mix_QuerySpec( NULL, NULL, NULL ) )
+    Mix_UnregisterEffect( MIX_CHANNEL_POST, SoftwareMixer::mixCallback );
+}
+
+// Enable the mixer (the audio device must be open)
+/*! \details The mix callback is registered again if the mixer is already
+ * enabled (reopening the audio device unregisters it). Only 16-bit audio
+ * devices are supported. The mixer format is set when the mixer is first
+ * enabled (the cached samples have that format) - if the audio device
+ * format differs from it later on no sounds will be mixed until the audio
+ * device has the mixer format again.
+ */
+bool SoftwareMixer::enable()
+{
+  AudioDevice& audio_device = AudioDevice::getInstance();
+
+  d_mix_callback_registered = false;
+
+  if( !audio_device.isOpen() || audio_device.getFormat() != AUDIO_S16SYS )
+  {
+    qWarning( "SoftwareMixer Warning: The audio device is not open or it "
+              "does not have a 16-bit format - the software mixer cannot "
+              "mix any sounds!" );
+    return false;
+  }
+
+  if( d_enabled )
+  {
+    if( audio_device.getFrequency() != d_frequency ||
+        audio_device.getNumberOfChannels() != d_number_of_channels )
+    {
+      qWarning( "SoftwareMixer Warning: The audio device does not have the "
+                "mixer format - the software mixer cannot mix any sounds!" );
+      return false;
+    }
+  }
+  else
+  {
+    d_frequency = audio_device.getFrequency();
+    d_number_of_channels = audio_device.getNumberOfChannels();
+
+    // The buffers are resized before the audio thread can use them
+    d_bus_buffers.resize( s_number_of_buses*s_block_size*d_number_of_channels );
+    d_mix_buffer.resize( s_block_size*d_number_of_channels );
+  }
+
+  Mix_UnregisterEffect( MIX_CHANNEL_POST, SoftwareMixer::mixCallback );
+
+  if( Mix_RegisterEffect( MIX_CHANNEL_POST,
+                          SoftwareMixer::mixCallback,
+                          NULL,
+                          this ) == 0 )
+  {
+    qWarning( "SoftwareMixer Warning: The mix callback could not be "
+              "registered (%s)!", Mix_GetError() );
+    return false;
+  }
+
+  d_enabled = true;
+  d_mix_callback_registered = true;
+
+  return true;
+}
+
+// Disable the mixer (all voices will be stopped)
+/*! \details Once the mix callback has been unregistered the audio thread
+ * will not touch the mixer anymore so the voices are cleared directly.
+ */
+void SoftwareMixer::disable()
+{
+  if( !d_enabled )
+    return;
+
+  if( d_mix_callback_registered && Mix_QuerySpec( NULL, NULL, NULL ) )
+    Mix_UnregisterEffect( MIX_CHANNEL_POST, SoftwareMixer::mixCallback );
+
+  d_enabled = false;
+  d_mix_callback_registered = false;
+
+  Command command;
+
+  while( d_commands.pop( command ) );
+
+  int voice_id;
+
+  while( d_finished_voices.pop( voice_id ) );
+
+  d_voices.clear();
+  d_voices.reserve( s_max_number_of_voices );
+  d_voice_samples.clear();
+  d_playing_voices.store( 0 );
+}
+
+// Check if the mixer is enabled
+bool SoftwareMixer::isEnabled() const
+{
+  return d_enabled;
+}
+
+// Get the mixer frequency
+int SoftwareMixer::getFrequency() const
+{
+  return d_frequency;
+}
+
+// Get the number of mixer channels (the samples are interleaved)
+int SoftwareMixer::getNumberOfChannels() const
+{
+  return d_number_of_channels;
+}
+
+// Play a sample (returns the voice id or -1 if the sound was dropped)
+/*! \details The sample is kept alive until the voice has finished. If
+ * every voice is busy when the audio thread starts the voice the sound
+ * will be dropped.
+ */
+int SoftwareMixer::play( const SampleHandle& sample,
+                         const Bus bus,
+                         const float gain )
+{
+  if( !sample || sample->getNumberOfFrames() == 0 )
+    return -1;
+
+  // Nobody would process the command
+  if( d_enabled && !d_mix_callback_registered )
+    return -1;
+
+  if( sample->getNumberOfChannels() != d_number_of_channels )
+  {
+    qWarning( "SoftwareMixer Warning: The sample does not have the mixer "
+              "format - it will not be played!" );
+    return -1;
+  }
+
+  this->releaseFinishedVoices();
+
+  // The finished voice queue must be able to hold every voice
+  if( d_voice_samples.size() >= d_finished_voices.getCapacity() )
+  {
+    ++d_dropped_sounds;
+
+    return -1;
+  }
+
+  Command command;
+  command.type = Command::PlayCommand;
+  command.voice_id = d_next_voice_id;
+  command.sample = sample.get();
+  command.bus = bus;
+  command.gain = gain;
+
+  d_voice_samples[command.voice_id] = sample;
+
+  if( !this->queueCommand( command ) )
+  {
+    d_voice_samples.remove( command.voice_id );
+
+    ++d_dropped_sounds;
+
+    return -1;
+  }
+
+  d_next_voice_id = (d_next_voice_id + 1) & 0x7FFFFFFF;
+
+  return command.voice_id;
+}
+
+// Stop a voice
+void SoftwareMixer::stop( const int voice_id )
+{
+  Command command;
+  command.type = Command::StopCommand;
+  command.voice_id = voice_id;
+  command.sample = NULL;
+  command.bus = 0;
+  command.gain = 0.0f;
+
+  this->queueCommand( command );
+}
+
+// Stop the voices of a bus
+void SoftwareMixer::stopBus( const Bus bus )
+{
+  Command command;
+  command.type = Command::StopBusCommand;
+  command.voice_id = -1;
+  command.sample = NULL;
+  command.bus = bus;
+  command.gain = 0.0f;
+
+  this->queueCommand( command );
+}
+
+// Stop all voices
+void SoftwareMixer::stopAll()
+{
+  Command command;
+  command.type = Command::StopAllCommand;
+  command.voice_id = -1;
+  command.sample = NULL;
+  command.bus = 0;
+  command.gain = 0.0f;
+
+  this->queueCommand( command );
+}
+
+// Set the volume of a bus (0 - MIX_MAX_VOLUME)
+/*! \details The volume is picked up by the audio thread when it mixes the
+ * next block.
+ */
+void SoftwareMixer::setBusVolume( const Bus bus, const int volume )
+{
+  d_bus_volumes[bus].store( std::min( std::max( volume, 0 ), MIX_MAX_VOLUME ),
+                            std::memory_order_relaxed );
+}
+
+// Get the volume of a bus
+int SoftwareMixer::getBusVolume( const Bus bus ) const
+{
+  return d_bus_volumes[bus].load( std::memory_order_relaxed );
+}
+
+// Get the number of playing voices
+int SoftwareMixer::getNumberOfPlayingVoices() const
+{
+  return d_playing_voices.load( std::memory_order_relaxed );
+}
+
+// Get the number of sounds that have been dropped
+int SoftwareMixer::getNumberOfDroppedSounds() const
+{
+  return d_dropped_sounds.load( std::memory_order_relaxed );
+}
+
+// Get the number of frames that have been mixed
+qint64 SoftwareMixer::getNumberOfMixedFrames() const
+{
+  return d_mixed_frames.load( std::memory_order_relaxed );
+}
+
+// Mix the voices into the samples (called by the audio thread)
+/*! \details The voices are added to the samples that are already in the
+ * buffer (the SDL_mixer channels and music). If the mixer is not enabled
+ * this can be called by the thread that controls the mixer (e.g. to
+ * benchmark the mixer). Nothing is allocated while mixing.
+ */
+void SoftwareMixer::mix( Sint16* samples, const int number_of_frames )
+{
+  this->processCommands();
+
+  int mixed_frames = 0;
+
+  while( mixed_frames < number_of_frames )
+  {
+    const int block_size =
+      std::min( number_of_frames - mixed_frames, s_block_size );
+
+    this->mixBlock( samples + mixed_frames*d_number_of_channels, block_size );
+
+    mixed_frames += block_size;
+  }
+
+  d_playing_voices.store( d_voices.size(), std::memory_order_relaxed );
+  d_mixed_frames.fetch_add( number_of_frames, std::memory_order_relaxed );
+}
+
+// Mix callback
+void SoftwareMixer::mixCallback( int,
+                                 void* stream,
+                                 int length,
+                                 void* user_data )
+{
+  SoftwareMixer* mixer = (SoftwareMixer*)user_data;
+
+  mixer->mix( (Sint16*)stream,
+              length/(sizeof(Sint16)*mixer->d_number_of_channels) );
+}
+
+// Mix samples into a buffer
+/*! \details The samples are mixed eight at a time with SSE2 (if it is
+ * available).
+ */
+void SoftwareMixer::mixSamples( const Sint16* samples,
+                                const float gain,
+                                float* buffer,
+                                const int number_of_samples )
+{
+  int i = 0;
+
+#ifdef __SSE2__
+  const __m128 gain_vector = _mm_set1_ps( gain );
+
+  for( ; i + 8 <= number_of_samples; i += 8 )
+  {
+    const __m128i packed_samples =
+      _mm_loadu_si128( (const __m128i*)(samples + i) );
+
+    // Sign extend the samples to 32 bits
+    const __m128i low_samples =
+      _mm_srai_epi32( _mm_unpacklo_epi16( packed_samples, packed_samples ),
+                      16 );
+    const __m128i high_samples =
+      _mm_srai_epi32( _mm_unpackhi_epi16( packed_samples, packed_samples ),
+                      16 );
+
+    _mm_storeu_ps( buffer + i,
+                   _mm_add_ps( _mm_loadu_ps( buffer + i ),
+                               _mm_mul_ps( _mm_cvtepi32_ps( low_samples ),
+                                           gain_vector ) ) );
+    _mm_storeu_ps( buffer + i + 4,
+                   _mm_add_ps( _mm_loadu_ps( buffer + i + 4 ),
+                               _mm_mul_ps( _mm_cvtepi32_ps( high_samples ),
+                                           gain_vector ) ) );
+  }
+#endif
+
+  for( ; i < number_of_samples; ++i )
+    buffer[i] += samples[i]*gain;
+}
+
+// Mix a buffer into another buffer
+void SoftwareMixer::mixBuffer( const float* source_buffer,
+                               const float gain,
+                               float* buffer,
+                               const int number_of_samples )
+{
+  int i = 0;
+
+#ifdef __SSE2__
+  const __m128 gain_vector = _mm_set1_ps( gain );
+
+  for( ; i + 4 <= number_of_samples; i += 4 )
+  {
+    _mm_storeu_ps( buffer + i,
+                   _mm_add_ps( _mm_loadu_ps( buffer + i ),
+                               _mm_mul_ps( _mm_loadu_ps( source_buffer + i ),
+                                           gain_vector ) ) );
+  }
+#endif
+
+  for( ; i < number_of_samples; ++i )
+    buffer[i] += source_buffer[i]*gain;
+}
+
+// Add a buffer to the samples (the samples are saturated)
+/*! \details The buffer values are rounded to the nearest integer (ties to
+ * even) with and without SSE2 so that both paths mix identically.
+ */
+void SoftwareMixer::addBuffer( const float* buffer,
+                               Sint16* samples,
+                               const int number_of_samples )
+{
+  int i = 0;
+
+#ifdef __SSE2__
+  const __m128 min_vector = _mm_set1_ps( -65536.0f );
+  const __m128 max_vector = _mm_set1_ps( 65536.0f );
+
+  for( ; i + 8 <= number_of_samples; i += 8 )
+  {
+    const __m128i packed_samples =
+      _mm_loadu_si128( (const __m128i*)(samples + i) );
+
+    // Sign extend the samples to 32 bits
+    const __m128i low_samples =
+      _mm_srai_epi32( _mm_unpacklo_epi16( packed_samples, packed_samples ),
+                      16 );
+    const __m128i high_samples =
+      _mm_srai_epi32( _mm_unpackhi_epi16( packed_samples, packed_samples ),
+                      16 );
+
+    const __m128i low_values = _mm_cvtps_epi32(
+              _mm_min_ps( _mm_max_ps( _mm_loadu_ps( buffer + i ),
+                                      min_vector ),
+                          max_vector ) );
+    const __m128i high_values = _mm_cvtps_epi32(
+              _mm_min_ps( _mm_max_ps( _mm_loadu_ps( buffer + i + 4 ),
+                                      min_vector ),
+                          max_vector ) );
+
+    // Pack the sums back to 16 bits with saturation
+    _mm_storeu_si128( (__m128i*)(samples + i),
+                      _mm_packs_epi32(
+                             _mm_add_epi32( low_samples, low_values ),
+                             _mm_add_epi32( high_samples, high_values ) ) );
+  }
+#endif
+
+  for( ; i < number_of_samples; ++i )
+  {
+    const int value =
+      samples[i] + (int)lrintf( std::min( std::max( buffer[i], -65536.0f ),
+                                          65536.0f ) );
+
+    samples[i] = (Sint16)std::min( std::max( value, -32768 ), 32767 );
+  }
+}
+
+// Queue a command
+/*! \details If the command queue is full a warning will be printed and the
+ * command will be dropped.
+ */
+bool SoftwareMixer::queueCommand( const Command& command )
+{
+  if( !d_commands.push( command ) )
+  {
+    qWarning( "SoftwareMixer Warning: The command queue is full - a command "
+              "has been dropped!" );
+    return false;
+  }
+
+  this->releaseFinishedVoices();
+
+  return true;
+}
+
+// Release the samples of the voices that have finished
+void SoftwareMixer::releaseFinishedVoices()
+{
+  int voice_id;
+
+  while( d_finished_voices.pop( voice_id ) )
+    d_voice_samples.remove( voice_id );
+}
+
+// Process the queued commands (audio thread)
+void SoftwareMixer::processCommands()
+{
+  Command command;
+
+  while( d_commands.pop( command ) )
+  {
+    if( command.type == Command::PlayCommand )
+    {
+      if( d_voices.size() < s_max_number_of_voices )
+      {
+        Voice voice;
+        voice.id = command.voice_id;
+        voice.sample = command.sample;
+        voice.bus = command.bus;
+        voice.gain = command.gain;
+        voice.position = 0;
+
+        // The voices have been reserved so nothing is allocated
+        d_voices << voice;
+      }
+      else
+      {
+        d_finished_voices.push( command.voice_id );
+
+        ++d_dropped_sounds;
+      }
+    }
+    else
+      this->stopVoices( command );
+  }
+}
+
+// Stop the voices that match a command (audio thread)
+void SoftwareMixer::stopVoices( const Command& command )
+{
+  int i = 0;
+
+  while( i < d_voices.size() )
+  {
+    const Voice& voice = d_voices[i];
+
+    if( command.type == Command::StopAllCommand ||
+        (command.type == Command::StopBusCommand &&
+         voice.bus == command.bus) ||
+        (command.type == Command::StopCommand &&
+         voice.id == command.voice_id) )
+    {
+      d_finished_voices.push( voice.id );
+
+      d_voices[i] = d_voices.back();
+      d_voices.pop_back();
+    }
+    else
+      ++i;
+  }
+}
+
+// Mix a block of frames (audio thread)
+/*! \details The voices are mixed onto their buses first. The bus volumes
+ * are then applied while the buses are mixed together.
+ */
+void SoftwareMixer::mixBlock( Sint16* samples, const int number_of_frames )
+{
+  const int number_of_samples = number_of_frames*d_number_of_channels;
+  const int bus_buffer_size = s_block_size*d_number_of_channels;
+
+  float* bus_buffers = d_bus_buffers.data();
+
+  for( int bus = 0; bus < s_number_of_buses; ++bus )
+  {
+    memset( bus_buffers + bus*bus_buffer_size,
+            0,
+            number_of_samples*sizeof(float) );
+  }
+
+  int i = 0;
+
+  while( i < d_voices.size() )
+  {
+    Voice& voice = d_voices[i];
+
+    const int voice_frames =
+      std::min( number_of_frames,
+                voice.sample->getNumberOfFrames() - voice.position );
+
+    SoftwareMixer::mixSamples(
+               voice.sample->getSamples() + voice.position*d_number_of_channels,
+               voice.gain,
+               bus_buffers + voice.bus*bus_buffer_size,
+               voice_frames*d_number_of_channels );
+
+    voice.position += voice_frames;
+
+    if( voice.position == voice.sample->getNumberOfFrames() )
+    {
+      d_finished_voices.push( voice.id );
+
+      d_voices[i] = d_voices.back();
+      d_voices.pop_back();
+    }
+    else
+      ++i;
+  }
+
+  float* mix_buffer = d_mix_buffer.data();
+
+  memset( mix_buffer, 0, number_of_samples*sizeof(float) );
+
+  for( int bus = 0; bus < s_number_of_buses; ++bus )
+  {
+    const int volume = d_bus_volumes[bus].load( std::memory_order_relaxed );
+
+    if( volume > 0 )
+    {
+      SoftwareMixer::mixBuffer( bus_buffers + bus*bus_buffer_size,
+                                volume/(float)MIX_MAX_VOLUME,
+                                mix_buffer,
+                                number_of_samples );
+    }
+  }
+
+  SoftwareMixer::addBuffer( mix_buffer, samples, number_of_samples );
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end SoftwareMixer.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,263 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SoftwareMixer.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The software mixer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef SOFTWARE_MIXER_H
+#define SOFTWARE_MIXER_H
+
+// Std Lib Includes
+#include <memory>
+#include <atomic>
+
+// SDL Includes
+#include <SDL_mixer.h>
+
+// Qt Includes
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+
+// QtD1 Includes
+#include "MixerSample.h"
+#include "LockFreeQueue.h"
+
+namespace QtD1{
+
+/*! The software mixer
+ *
+ * An optional replacement for the SDL_mixer channels. The sounds are mixed
+ * in-process (in a post-mix effect) onto one of the buses (music, effects
+ * or voice) - every bus has its own volume that is applied once the
+ * voices of the bus have been mixed. The samples must already be in the
+ * mixer format (see MixerSample) so no conversion is done while mixing.
+ *
+ * The game thread never waits for the audio thread: voices are started and
+ * stopped through a lock-free command queue and the bus volumes are
+ * single atomic writes. The samples of the voices are kept alive by the
+ * game thread until the audio thread reports that the voices have
+ * finished. The mixing itself is deterministic and does not need an open
+ * audio device (see mix) so that it can be tested and benchmarked.
+ *
+ * Only one thread (the GUI thread) may control the mixer.
+ */
+class SoftwareMixer
+{
+
+public:
+
+  //! The buses
+  enum Bus{
+    MusicBus = 0,
+    EffectBus,
+    VoiceBus
+  };
+
+  //! The number of buses
+  static const int s_number_of_buses = 3;
+
+  //! The max number of voices
+  static const int s_max_number_of_voices = 64;
+
+  //! The command queue size
+  static const int s_command_queue_size = 256;
+
+  //! The number of frames that are mixed at a time
+  static const int s_block_size = 512;
+
+  //! The sample handle
+  typedef std::shared_ptr<const MixerSample> SampleHandle;
+
+  //! Get the singleton instance
+  static SoftwareMixer* getInstance();
+
+  //! Destructor
+  ~SoftwareMixer();
+
+  //! Enable the mixer (the audio device must be open)
+  bool enable();
+
+  //! Disable the mixer (all voices will be stopped)
+  void disable();
+
+  //! Check if the mixer is enabled
+  bool isEnabled() const;
+
+  //! Get the mixer frequency
+  int getFrequency() const;
+
+  //! Get the number of mixer channels (the samples are interleaved)
+  int getNumberOfChannels() const;
+
+  //! Play a sample (returns the voice id or -1 if the sound was dropped)
+  int play( const SampleHandle& sample,
+            const Bus bus,
+            const float gain = 1.0f );
+
+  //! Stop a voice
+  void stop( const int voice_id );
+
+  //! Stop the voices of a bus
+  void stopBus( const Bus bus );
+
+  //! Stop all voices
+  void stopAll();
+
+  //! Set the volume of a bus (0 - MIX_MAX_VOLUME)
+  void setBusVolume( const Bus bus, const int volume );
+
+  //! Get the volume of a bus
+  int getBusVolume( const Bus bus ) const;
+
+  //! Get the number of playing voices
+  int getNumberOfPlayingVoices() const;
+
+  //! Get the number of sounds that have been dropped
+  int getNumberOfDroppedSounds() const;
+
+  //! Get the number of frames that have been mixed
+  qint64 getNumberOfMixedFrames() const;
+
+  //! Mix the voices into the samples (called by the audio thread)
+  void mix( Sint16* samples, const int number_of_frames );
+
+private:
+
+  // A command
+  struct Command{
+    // The command types
+    enum Type{
+      PlayCommand = 0,
+      StopCommand,
+      StopBusCommand,
+      StopAllCommand
+    };
+    // The command type
+    Type type;
+    // The voice id
+    int voice_id;
+    // The sample (play commands only)
+    const MixerSample* sample;
+    // The bus
+    int bus;
+    // The gain
+    float gain;
+  };
+
+  // A voice
+  struct Voice{
+    // The voice id
+    int id;
+    // The sample
+    const MixerSample* sample;
+    // The bus
+    int bus;
+    // The gain
+    float gain;
+    // The position in the sample (frames)
+    int position;
+  };
+
+  // Constructor
+  SoftwareMixer();
+
+  // Mix callback
+  static void mixCallback( int channel,
+                           void* stream,
+                           int length,
+                           void* user_data );
+
+  // Mix samples into a buffer
+  static void mixSamples( const Sint16* samples,
+                          const float gain,
+                          float* buffer,
+                          const int number_of_samples );
+
+  // Mix a buffer into another buffer
+  static void mixBuffer( const float* source_buffer,
+                         const float gain,
+                         float* buffer,
+                         const int number_of_samples );
+
+  // Add a buffer to the samples (the samples are saturated)
+  static void addBuffer( const float* buffer,
+                         Sint16* samples,
+                         const int number_of_samples );
+
+  // Queue a command
+  bool queueCommand( const Command& command );
+
+  // Release the samples of the voices that have finished
+  void releaseFinishedVoices();
+
+  // Process the queued commands (audio thread)
+  void processCommands();
+
+  // Stop the voices that match a command (audio thread)
+  void stopVoices( const Command& command );
+
+  // Mix a block of frames (audio thread)
+  void mixBlock( Sint16* samples, const int number_of_frames );
+
+  // The singleton instance
+  static std::unique_ptr<SoftwareMixer> s_instance;
+
+  // The singleton instance mutex
+  static QMutex s_instance_mutex;
+
+  // Records if the mixer is enabled
+  bool d_enabled;
+
+  // Records if the mix callback is registered with the audio device
+  bool d_mix_callback_registered;
+
+  // The mixer frequency
+  int d_frequency;
+
+  // The number of mixer channels
+  int d_number_of_channels;
+
+  // The id of the next voice
+  int d_next_voice_id;
+
+  // The samples of the voices that have not finished (game thread)
+  QHash<int,SampleHandle> d_voice_samples;
+
+  // The command queue (game thread to audio thread)
+  LockFreeQueue<Command> d_commands;
+
+  // The finished voice queue (audio thread to game thread)
+  LockFreeQueue<int> d_finished_voices;
+
+  // The voices (audio thread)
+  QVector<Voice> d_voices;
+
+  // The bus buffers (audio thread)
+  QVector<float> d_bus_buffers;
+
+  // The mix buffer (audio thread)
+  QVector<float> d_mix_buffer;
+
+  // The bus volumes
+  std::atomic<int> d_bus_volumes[s_number_of_buses];
+
+  // The number of playing voices
+  std::atomic<int> d_playing_voices;
+
+  // The number of sounds that have been dropped
+  std::atomic<int> d_dropped_sounds;
+
+  // The number of frames that have been mixed
+  std::atomic<qint64> d_mixed_frames;
+};
+
+} // end QtD1 namespace
+
+#endif // end SOFTWARE_MIXER_H
+
+//---------------------------------------------------------------------------//
+// end SoftwareMixer.h
+//---------------------------------------------------------------------------//
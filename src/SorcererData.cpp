@@ -115,6 +115,13 @@ void SorcererData::handleMagicChange( int, int )
 }
 
 void SorcererData::handleLevelUp( const int )
+{
+  this->calculateBaseStats();
+
+  this->updateStats();
+}
+
+void SorcererData::calculateBaseStats()
 {
   this->calculateBaseChanceToHitWithMelee();
   this->calculateBaseChanceToHitWithRanged();
@@ -122,8 +129,6 @@ void SorcererData::handleLevelUp( const int )
   this->calculateBaseDamage();
   this->calculateBaseHealth();
   this->calculateBaseMana();
-
-  this->updateStats();
 }
 
 void SorcererData::connectStatChangeSignalToSorcererDataSlots()
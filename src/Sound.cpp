@@ -12,7 +12,6 @@
 
 // QtD1 Includes
 #include "Sound.h"
-#include "AudioDevice.h"
 
 namespace QtD1{
 
@@ -20,12 +19,30 @@ namespace QtD1{
 Sound::Sound( QObject* parent )
   : QObject( parent ),
     d_source(),
-    d_chunk()
-{ /* ... */ }
+    d_priority( SoundBank::EffectPriority ),
+    d_chunk(),
+    d_sample(),
+    d_loading( false ),
+    d_play_pending( false ),
+    d_pending_distance( 0.0 ),
+    d_chunk_watcher(),
+    d_sample_watcher()
+{
+  QObject::connect( &d_chunk_watcher, SIGNAL(finished()),
+                    this, SLOT(handleChunkLoaded()) );
+  QObject::connect( &d_sample_watcher, SIGNAL(finished()),
+                    this, SLOT(handleSampleLoaded()) );
+}
 
 // Destructor
+/*! \details A sound that is being decoded will be finished first (the
+ * sound bank keeps it resident if another sound uses it).
+ */
 Sound::~Sound()
-{ /* ... */ }
+{
+  d_chunk_watcher.waitForFinished();
+  d_sample_watcher.waitForFinished();
+}
 
 // Get the sound source
 QString Sound::getSource() const
@@ -33,33 +50,160 @@ QString Sound::getSource() const
   return d_source;
 }
 
-// Set the sound source
+// Set the sound source (the sound is decoded asynchronously)
+/*! \details The sound chunk is only decoded if no other sound with the
+ * same source is alive. When the software mixer is enabled a sample is
+ * decoded instead of a chunk.
+ */
 void Sound::setSource( const QString& source )
 {
   d_source = source;
+  d_chunk.reset();
+  d_sample.reset();
+  d_loading = true;
 
-  try{
-    d_chunk.reset( new MixChunkWrapper( d_source ) );
+  if( SoftwareMixer::getInstance()->isEnabled() )
+  {
+    d_sample_watcher.setFuture(
+                     SoundBank::getInstance()->getSampleAsync( d_source ) );
   }
-  catch( const std::exception& exception )
+  else
+  {
+    d_chunk_watcher.setFuture(
+                      SoundBank::getInstance()->getChunkAsync( d_source ) );
+  }
+}
+
+// Check if the sound has been decoded
+bool Sound::isLoaded() const
+{
+  return !d_loading;
+}
+
+// Wait for the sound to be decoded
+void Sound::waitForLoaded()
+{
+  if( d_loading )
   {
-    std::ostringstream oss;
-    oss << "Unable to load sound file "
-        << d_source.toStdString()
-        << "!";
+    if( SoftwareMixer::getInstance()->isEnabled() )
+    {
+      d_sample_watcher.waitForFinished();
+
+      this->handleSampleLoaded();
+    }
+    else
+    {
+      d_chunk_watcher.waitForFinished();
 
-    qFatal( "%s", oss.str().c_str() );
+      this->handleChunkLoaded();
+    }
   }
 }
 
+// Get the sound priority
+SoundBank::Priority Sound::getPriority() const
+{
+  return d_priority;
+}
+
+// Set the sound priority
+void Sound::setPriority( const SoundBank::Priority priority )
+{
+  d_priority = priority;
+}
+
 // Play the sound
 Q_INVOKABLE void Sound::playSound()
 {
-  AudioDevice& audio_device = AudioDevice::getInstance();
+  this->playSound( 0.0 );
+}
+
+// Play the sound (at a distance relative to the max audible distance)
+/*! \details If every voice is busy with a more important sound this
+ * sound will be dropped. If the sound is still being decoded it will be
+ * played once it has been decoded (only the last request is kept).
+ */
+void Sound::playSound( const double distance )
+{
+  if( d_loading )
+  {
+    d_play_pending = true;
+    d_pending_distance = distance;
+
+    return;
+  }
+
+  if( d_sample )
+    SoundBank::getInstance()->play( d_sample, d_priority, distance );
+  else
+    SoundBank::getInstance()->play( d_chunk, d_priority, distance );
+}
+
+// Handle the sound chunk decoded
+/*! \details The chunk may have been handled already by waitForLoaded or
+ * it may belong to a previous source.
+ */
+void Sound::handleChunkLoaded()
+{
+  if( !d_loading || !d_chunk_watcher.isFinished() )
+    return;
+
+  try{
+    d_chunk = d_chunk_watcher.result();
+  }
+  catch( const std::exception& exception )
+  {
+    this->handleLoadFailure();
+  }
+
+  d_loading = false;
+
+  emit loaded();
+
+  this->playPendingSound();
+}
+
+// Handle the sound sample decoded
+void Sound::handleSampleLoaded()
+{
+  if( !d_loading || !d_sample_watcher.isFinished() )
+    return;
 
-  // Check if the audio device is open
-  if( audio_device.isOpen() )
-    audio_device.playChunk( *d_chunk );
+  try{
+    d_sample = d_sample_watcher.result();
+  }
+  catch( const std::exception& exception )
+  {
+    this->handleLoadFailure();
+  }
+
+  d_loading = false;
+
+  emit loaded();
+
+  this->playPendingSound();
+}
+
+// Handle a sound that could not be decoded
+void Sound::handleLoadFailure() const
+{
+  std::ostringstream oss;
+  oss << "Unable to load sound file "
+      << d_source.toStdString()
+      << "!";
+
+  qFatal( "%s", oss.str().c_str() );
+}
+
+// Play the sound that was requested while the sound was being decoded
+void Sound::playPendingSound()
+{
+  if( d_play_pending )
+  {
+    d_play_pending = false;
+
+    this->playSound( d_pending_distance );
+  }
 }
 
 QML_REGISTER_TYPE( Sound );
@@ -14,14 +14,20 @@
 
 // Qt Includes
 #include <QString>
+#include <QFutureWatcher>
 
 // QtD1 Includes
-#include "MixChunkWrapper.h"
+#include "SoundBank.h"
 #include "QMLRegistrationHelper.h"
 
 namespace QtD1{
 
-//! The sound class
+/*! The sound class
+ *
+ * The sound is decoded by a worker thread when its source is set. A sound
+ * that is played before it has been decoded will be played as soon as it
+ * has been decoded.
+ */
 class Sound : public QObject
 {
   Q_OBJECT
@@ -39,19 +45,74 @@ public:
   //! Get the sound file source
   QString getSource() const;
 
-  //! Set the sound file source
+  //! Set the sound file source (the sound is decoded asynchronously)
   void setSource( const QString& source );
 
+  //! Check if the sound has been decoded
+  bool isLoaded() const;
+
+  //! Wait for the sound to be decoded
+  void waitForLoaded();
+
+  //! Get the sound priority
+  SoundBank::Priority getPriority() const;
+
+  //! Set the sound priority
+  void setPriority( const SoundBank::Priority priority );
+
   //! Play the sound
   Q_INVOKABLE void playSound();
 
+  //! Play the sound (at a distance relative to the max audible distance)
+  void playSound( const double distance );
+
+signals:
+
+  //! The sound has been decoded
+  void loaded();
+
+private slots:
+
+  // Handle the sound chunk decoded
+  void handleChunkLoaded();
+
+  // Handle the sound sample decoded
+  void handleSampleLoaded();
+
 private:
 
+  // Handle a sound that could not be decoded
+  void handleLoadFailure() const;
+
+  // Play the sound that was requested while the sound was being decoded
+  void playPendingSound();
+
   // The sound file source
   QString d_source;
 
-  // The sound chunk
-  std::unique_ptr<MixChunkWrapper> d_chunk;
+  // The sound priority
+  SoundBank::Priority d_priority;
+
+  // The sound chunk (shared with every sound that has the same source)
+  SoundBank::ChunkHandle d_chunk;
+
+  // The sound sample (only used with the software mixer)
+  SoundBank::SampleHandle d_sample;
+
+  // Records if the sound is being decoded
+  bool d_loading;
+
+  // Records if the sound should be played once it has been decoded
+  bool d_play_pending;
+
+  // The distance of the sound that should be played once it has been decoded
+  double d_pending_distance;
+
+  // The sound chunk watcher
+  QFutureWatcher<SoundBank::ChunkHandle> d_chunk_watcher;
+
+  // The sound sample watcher
+  QFutureWatcher<SoundBank::SampleHandle> d_sample_watcher;
 };
 
 } // end QtD1 namespace
@@ -0,0 +1,458 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SoundBank.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The sound bank class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <stdexcept>
+
+// Qt Includes
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+
+// QtD1 Includes
+#include "SoundBank.h"
+#include "AudioDevice.h"
+
+namespace QtD1{
+
+// Initialize static member data
+std::unique_ptr<SoundBank> SoundBank::s_instance;
+QMutex SoundBank::s_instance_mutex;
+
+// Get the singleton instance
+/*! \details The instance can be requested by any thread.
+ */
+SoundBank* SoundBank::getInstance()
+{
+  QMutexLocker instance_locker( &s_instance_mutex );
+
+  // Just-in-time initialization
+  if( !s_instance )
+    s_instance.reset( new SoundBank );
+
+  return s_instance.get();
+}
+
+// Constructor
+SoundBank::SoundBank()
+  : d_mutex(),
+    d_chunks(),
+    d_decoded_chunks( 0 ),
+    d_samples(),
+    d_decoded_samples( 0 ),
+    d_voices(),
+    d_started_voices( 0 ),
+    d_stolen_voices( 0 ),
+    d_dropped_sounds( 0 )
+{ /* ... */ }
+
+// Get a chunk (it will only be decoded if it is not resident)
+/*! \details The chunk is decoded without holding the cache lock so that
+ * other chunks can be requested while it is being decoded. If the chunk
+ * was decoded by another thread at the same time the resident chunk is
+ * returned and the new chunk is discarded.
+ */
+SoundBank::ChunkHandle SoundBank::getChunk( const QString& source )
+{
+  {
+    QMutexLocker locker( &d_mutex );
+
+    ChunkHandle chunk = d_chunks.value( source ).lock();
+
+    if( chunk )
+      return chunk;
+  }
+
+  ChunkHandle new_chunk = SoundBank::decode( source );
+
+  QMutexLocker locker( &d_mutex );
+
+  ChunkHandle chunk = d_chunks.value( source ).lock();
+
+  if( chunk )
+    return chunk;
+
+  d_chunks[source] = new_chunk;
+  ++d_decoded_chunks;
+
+  return new_chunk;
+}
+
+// Get a sample (it will only be decoded if it is not resident)
+/*! \details The sample is decoded and converted to the software mixer
+ * format without holding the cache lock (see getChunk).
+ */
+SoundBank::SampleHandle SoundBank::getSample( const QString& source )
+{
+  {
+    QMutexLocker locker( &d_mutex );
+
+    SampleHandle sample = d_samples.value( source ).lock();
+
+    if( sample )
+      return sample;
+  }
+
+  SampleHandle new_sample = SoundBank::decodeSample( source );
+
+  QMutexLocker locker( &d_mutex );
+
+  SampleHandle sample = d_samples.value( source ).lock();
+
+  if( sample )
+    return sample;
+
+  d_samples[source] = new_sample;
+  ++d_decoded_samples;
+
+  return new_sample;
+}
+
+// Get the number of samples that have been decoded
+int SoundBank::getNumberOfDecodedSamples() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_decoded_samples;
+}
+
+// Get a chunk in a worker thread
+QFuture<SoundBank::ChunkHandle> SoundBank::getChunkAsync(
+                                                    const QString& source )
+{
+  return QtConcurrent::run( SoundBank::getChunkImpl, this, source );
+}
+
+// Get a sample in a worker thread
+/*! \details If the sample cannot be decoded the future will throw when its
+ * result is requested.
+ */
+QFuture<SoundBank::SampleHandle> SoundBank::getSampleAsync(
+                                                    const QString& source )
+{
+  return QtConcurrent::run( SoundBank::getSampleImpl, this, source );
+}
+
+// Decode the sounds ahead of time (the handles keep them resident)
+/*! \details The samples are decoded instead of the chunks when the
+ * software mixer is enabled. Sounds that cannot be decoded are skipped.
+ */
+SoundBank::PreloadedSounds SoundBank::preload( const QStringList& sources )
+{
+  const bool use_samples = SoftwareMixer::getInstance()->isEnabled();
+
+  PreloadedSounds sounds;
+
+  for( int i = 0; i < sources.size(); ++i )
+  {
+    try{
+      if( use_samples )
+        sounds.samples << this->getSample( sources[i] );
+      else
+        sounds.chunks << this->getChunk( sources[i] );
+    }
+    catch( const std::exception& exception )
+    {
+      qWarning( "SoundBank Warning: Could not preload sound %s (%s)!",
+                sources[i].toLatin1().data(),
+                exception.what() );
+    }
+  }
+
+  return sounds;
+}
+
+// Decode the sounds ahead of time in a worker thread
+/*! \details The result must be kept for as long as the sounds should stay
+ * resident.
+ */
+QFuture<SoundBank::PreloadedSounds> SoundBank::preloadAsync(
+                                                const QStringList& sources )
+{
+  return QtConcurrent::run( SoundBank::preloadImpl, this, sources );
+}
+
+// Check if a chunk is resident
+bool SoundBank::isResident( const QString& source ) const
+{
+  QMutexLocker locker( &d_mutex );
+
+  QHash<QString,WeakChunkHandle>::const_iterator chunk_it =
+    d_chunks.find( source );
+
+  if( chunk_it != d_chunks.end() )
+    return !chunk_it.value().expired();
+  else
+    return false;
+}
+
+// Get the number of resident chunks
+int SoundBank::getNumberOfResidentChunks() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  int resident_chunks = 0;
+
+  QHash<QString,WeakChunkHandle>::const_iterator chunk_it, chunk_end;
+  chunk_it = d_chunks.begin();
+  chunk_end = d_chunks.end();
+
+  while( chunk_it != chunk_end )
+  {
+    if( !chunk_it.value().expired() )
+      ++resident_chunks;
+
+    ++chunk_it;
+  }
+
+  return resident_chunks;
+}
+
+// Get the number of chunks that have been decoded
+int SoundBank::getNumberOfDecodedChunks() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_decoded_chunks;
+}
+
+// Play a chunk (returns the voice or -1 if the sound was dropped)
+/*! \details The distance is relative to the maximum audible distance
+ * (0 = at the listener, 1 = barely audible) - sounds that are farther away
+ * are dropped. The chunk must have been requested beforehand so nothing
+ * is decoded here.
+ */
+int SoundBank::play( const ChunkHandle& chunk,
+                     const Priority priority,
+                     const double distance )
+{
+  AudioDevice& audio_device = AudioDevice::getInstance();
+
+  if( !chunk || !audio_device.isOpen() )
+    return -1;
+
+  if( distance > 1.0 )
+  {
+    ++d_dropped_sounds;
+
+    return -1;
+  }
+
+  // The mixer channels may have been reallocated
+  if( d_voices.size() != audio_device.getNumberOfMixerChannels() )
+  {
+    this->haltAllVoices();
+
+    d_voices.resize( audio_device.getNumberOfMixerChannels() );
+
+    // Channels that are busy with sounds that were not started by the bank
+    // are the first to be stolen
+    for( int i = 0; i < d_voices.size(); ++i )
+    {
+      d_voices[i].priority = AmbientPriority;
+      d_voices[i].distance = 1.0;
+      d_voices[i].start_order = 0;
+    }
+  }
+
+  const int voice = this->findVoice( priority, distance );
+
+  if( voice < 0 )
+  {
+    ++d_dropped_sounds;
+
+    return -1;
+  }
+
+  // Steal the voice
+  if( audio_device.isMixerChannelPlaying( voice ) )
+  {
+    audio_device.haltMixerChannel( voice );
+
+    ++d_stolen_voices;
+  }
+
+  audio_device.setMixerChannelDistance(
+                     voice, (Uint8)(255*qBound( 0.0, distance, 1.0 ) + 0.5) );
+
+  if( audio_device.playChunk( *chunk, voice ) != voice )
+  {
+    qWarning( "SoundBank Warning: Could not play a sound on voice %i!",
+              voice );
+
+    d_voices[voice].chunk.reset();
+
+    return -1;
+  }
+
+  // The voice keeps the chunk alive while it is playing
+  d_voices[voice].chunk = chunk;
+  d_voices[voice].priority = priority;
+  d_voices[voice].distance = distance;
+  d_voices[voice].start_order = d_started_voices++;
+
+  return voice;
+}
+
+// Play a sample with the software mixer (returns the voice id or -1)
+/*! \details Speech is played on the voice bus and every other sound on
+ * the effect bus. The sound is attenuated linearly with the distance (like
+ * the mixer channels) - sounds that are farther away than the maximum
+ * audible distance are dropped.
+ */
+int SoundBank::play( const SampleHandle& sample,
+                     const Priority priority,
+                     const double distance )
+{
+  SoftwareMixer* mixer = SoftwareMixer::getInstance();
+
+  if( !sample || !mixer->isEnabled() )
+    return -1;
+
+  if( distance > 1.0 )
+  {
+    ++d_dropped_sounds;
+
+    return -1;
+  }
+
+  return mixer->play( sample,
+                      priority == SpeechPriority ?
+                      SoftwareMixer::VoiceBus : SoftwareMixer::EffectBus,
+                      1.0 - qBound( 0.0, distance, 1.0 ) );
+}
+
+// Get the number of voices
+int SoundBank::getNumberOfVoices() const
+{
+  return d_voices.size();
+}
+
+// Get the number of voices that have been stolen
+int SoundBank::getNumberOfStolenVoices() const
+{
+  return d_stolen_voices;
+}
+
+// Get the number of sounds that have been dropped
+int SoundBank::getNumberOfDroppedSounds() const
+{
+  return d_dropped_sounds;
+}
+
+// Halt all voices (the chunks of the voices are released)
+void SoundBank::haltAllVoices()
+{
+  AudioDevice& audio_device = AudioDevice::getInstance();
+
+  for( int i = 0; i < d_voices.size(); ++i )
+  {
+    if( audio_device.isOpen() && d_voices[i].chunk )
+      audio_device.haltMixerChannel( i );
+
+    d_voices[i].chunk.reset();
+  }
+}
+
+// Decode a chunk
+SoundBank::ChunkHandle SoundBank::decode( const QString& source )
+{
+  return ChunkHandle( new MixChunkWrapper( source ) );
+}
+
+// Decode a sample
+SoundBank::SampleHandle SoundBank::decodeSample( const QString& source )
+{
+  SoftwareMixer* mixer = SoftwareMixer::getInstance();
+
+  return SampleHandle( new MixerSample( source,
+                                        mixer->getFrequency(),
+                                        mixer->getNumberOfChannels() ) );
+}
+
+// Get a chunk (run in a worker thread)
+SoundBank::ChunkHandle SoundBank::getChunkImpl( SoundBank* sound_bank,
+                                                const QString source )
+{
+  return sound_bank->getChunk( source );
+}
+
+// Get a sample (run in a worker thread)
+SoundBank::SampleHandle SoundBank::getSampleImpl( SoundBank* sound_bank,
+                                                  const QString source )
+{
+  return sound_bank->getSample( source );
+}
+
+// Decode the sounds ahead of time (run in a worker thread)
+SoundBank::PreloadedSounds SoundBank::preloadImpl(
+                                              SoundBank* sound_bank,
+                                              const QStringList sources )
+{
+  return sound_bank->preload( sources );
+}
+
+// Find the voice that should play a sound (-1 if it should be dropped)
+/*! \details A free voice is preferred. Otherwise the least important busy
+ * voice is returned if it is less important than the sound.
+ */
+int SoundBank::findVoice( const Priority priority, const double distance )
+{
+  AudioDevice& audio_device = AudioDevice::getInstance();
+
+  int least_important_voice = -1;
+
+  for( int i = 0; i < d_voices.size(); ++i )
+  {
+    if( !audio_device.isMixerChannelPlaying( i ) )
+    {
+      d_voices[i].chunk.reset();
+
+      return i;
+    }
+
+    if( least_important_voice < 0 ||
+        SoundBank::isLessImportant( d_voices[i],
+                                    d_voices[least_important_voice] ) )
+      least_important_voice = i;
+  }
+
+  // The sound is newer than every voice
+  Voice sound;
+  sound.priority = priority;
+  sound.distance = distance;
+  sound.start_order = d_started_voices;
+
+  if( least_important_voice >= 0 &&
+      SoundBank::isLessImportant( d_voices[least_important_voice],
+                                  sound ) )
+    return least_important_voice;
+  else
+    return -1;
+}
+
+// Check if a voice is less important than another voice
+/*! \details A voice is less important if it has a lower priority, if it
+ * has the same priority and it is farther from the listener or if it is
+ * just as far from the listener and it is older.
+ */
+bool SoundBank::isLessImportant( const Voice& voice,
+                                 const Voice& other_voice )
+{
+  if( voice.priority != other_voice.priority )
+    return voice.priority < other_voice.priority;
+  else if( voice.distance != other_voice.distance )
+    return voice.distance > other_voice.distance;
+  else
+    return voice.start_order < other_voice.start_order;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end SoundBank.cpp
+//---------------------------------------------------------------------------//
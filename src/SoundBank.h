@@ -0,0 +1,230 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SoundBank.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The sound bank class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef SOUND_BANK_H
+#define SOUND_BANK_H
+
+// Std Lib Includes
+#include <memory>
+
+// Qt Includes
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QFuture>
+
+// QtD1 Includes
+#include "MixChunkWrapper.h"
+#include "SoftwareMixer.h"
+
+namespace QtD1{
+
+/*! The sound bank
+ *
+ * The decoded sound chunks are shared by the whole process. A chunk is
+ * keyed by its path (e.g. "/sfx/items/titlemov.wav") and is handed out as
+ * a reference counted handle - it is only decoded the first time that it
+ * is requested and it stays decoded for as long as someone holds a handle
+ * to it. Chunks should be requested when a sound is created so that
+ * nothing is decoded when a sound is played. Chunks can be decoded by a
+ * worker thread (see getChunkAsync) and the sounds of a level should be
+ * preloaded while the level is loading (see preloadAsync).
+ *
+ * The bank also manages the voices (the mixer channels). Every voice
+ * that is started has a priority and a distance from the listener. When
+ * all voices are busy the least important voice (the lowest priority, then
+ * the farthest, then the oldest) is stolen - a sound that is less
+ * important than every busy voice is dropped. A voice keeps its chunk
+ * alive until the voice is reused.
+ *
+ * When the software mixer is enabled the sounds are played by it instead
+ * of the mixer channels. The samples of the software mixer are cached the
+ * same way as the chunks (they are only decoded and converted to the mixer
+ * format once). The software mixer voices are not stolen.
+ *
+ * The chunk and sample caches are thread safe. The voices must only be
+ * started from the GUI thread.
+ */
+class SoundBank
+{
+
+public:
+
+  //! The voice priorities
+  enum Priority{
+    AmbientPriority = 0,
+    EffectPriority,
+    InterfacePriority,
+    SpeechPriority
+  };
+
+  //! The sound chunk handle
+  typedef std::shared_ptr<MixChunkWrapper> ChunkHandle;
+
+  //! The weak sound chunk handle
+  typedef std::weak_ptr<MixChunkWrapper> WeakChunkHandle;
+
+  //! The sound sample handle (used with the software mixer)
+  typedef SoftwareMixer::SampleHandle SampleHandle;
+
+  //! The weak sound sample handle
+  typedef std::weak_ptr<const MixerSample> WeakSampleHandle;
+
+  //! Get the singleton instance
+  static SoundBank* getInstance();
+
+  //! Destructor
+  ~SoundBank()
+  { /* ... */ }
+
+  //! Get a chunk (it will only be decoded if it is not resident)
+  ChunkHandle getChunk( const QString& source );
+
+  //! The preloaded sounds (the handles keep the sounds resident)
+  struct PreloadedSounds{
+    //! The chunks
+    QList<ChunkHandle> chunks;
+    //! The samples (only used with the software mixer)
+    QList<SampleHandle> samples;
+  };
+
+  //! Get a chunk in a worker thread
+  QFuture<ChunkHandle> getChunkAsync( const QString& source );
+
+  //! Decode the sounds ahead of time (the handles keep them resident)
+  PreloadedSounds preload( const QStringList& sources );
+
+  //! Decode the sounds ahead of time in a worker thread
+  QFuture<PreloadedSounds> preloadAsync( const QStringList& sources );
+
+  //! Check if a chunk is resident
+  bool isResident( const QString& source ) const;
+
+  //! Get the number of resident chunks
+  int getNumberOfResidentChunks() const;
+
+  //! Get the number of chunks that have been decoded
+  int getNumberOfDecodedChunks() const;
+
+  //! Get a sample (it will only be decoded if it is not resident)
+  SampleHandle getSample( const QString& source );
+
+  //! Get a sample in a worker thread
+  QFuture<SampleHandle> getSampleAsync( const QString& source );
+
+  //! Get the number of samples that have been decoded
+  int getNumberOfDecodedSamples() const;
+
+  //! Play a chunk (returns the voice or -1 if the sound was dropped)
+  int play( const ChunkHandle& chunk,
+            const Priority priority = EffectPriority,
+            const double distance = 0.0 );
+
+  //! Play a sample with the software mixer (returns the voice id or -1)
+  int play( const SampleHandle& sample,
+            const Priority priority = EffectPriority,
+            const double distance = 0.0 );
+
+  //! Get the number of voices
+  int getNumberOfVoices() const;
+
+  //! Get the number of voices that have been stolen
+  int getNumberOfStolenVoices() const;
+
+  //! Get the number of sounds that have been dropped
+  int getNumberOfDroppedSounds() const;
+
+  //! Halt all voices (the chunks of the voices are released)
+  void haltAllVoices();
+
+private:
+
+  // A voice
+  struct Voice{
+    // The chunk that is playing
+    ChunkHandle chunk;
+    // The priority
+    Priority priority;
+    // The distance from the listener
+    double distance;
+    // The order in which the voice was started
+    quint64 start_order;
+  };
+
+  // Constructor
+  SoundBank();
+
+  // Decode a chunk
+  static ChunkHandle decode( const QString& source );
+
+  // Get a chunk (run in a worker thread)
+  static ChunkHandle getChunkImpl( SoundBank* sound_bank,
+                                   const QString source );
+
+  // Get a sample (run in a worker thread)
+  static SampleHandle getSampleImpl( SoundBank* sound_bank,
+                                     const QString source );
+
+  // Decode the sounds ahead of time (run in a worker thread)
+  static PreloadedSounds preloadImpl( SoundBank* sound_bank,
+                                      const QStringList sources );
+
+  // Decode a sample
+  static SampleHandle decodeSample( const QString& source );
+
+  // Find the voice that should play a sound (-1 if it should be dropped)
+  int findVoice( const Priority priority, const double distance );
+
+  // Check if a voice is less important than another voice
+  static bool isLessImportant( const Voice& voice,
+                               const Voice& other_voice );
+
+  // The singleton instance
+  static std::unique_ptr<SoundBank> s_instance;
+
+  // The singleton instance mutex
+  static QMutex s_instance_mutex;
+
+  // The chunk cache mutex
+  mutable QMutex d_mutex;
+
+  // The weak handles of all chunks that have been decoded
+  QHash<QString,WeakChunkHandle> d_chunks;
+
+  // The number of chunks that have been decoded
+  int d_decoded_chunks;
+
+  // The weak handles of all samples that have been decoded
+  QHash<QString,WeakSampleHandle> d_samples;
+
+  // The number of samples that have been decoded
+  int d_decoded_samples;
+
+  // The voices
+  QVector<Voice> d_voices;
+
+  // The number of voices that have been started
+  quint64 d_started_voices;
+
+  // The number of voices that have been stolen
+  int d_stolen_voices;
+
+  // The number of sounds that have been dropped
+  int d_dropped_sounds;
+};
+
+} // end QtD1 namespace
+
+#endif // end SOUND_BANK_H
+
+//---------------------------------------------------------------------------//
+// end SoundBank.h
+//---------------------------------------------------------------------------//
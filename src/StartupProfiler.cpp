@@ -0,0 +1,179 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   StartupProfiler.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The startup profiler class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+#include <iomanip>
+
+// Qt Includes
+#include <QMutexLocker>
+#include <QThread>
+#include <QCoreApplication>
+
+// QtD1 Includes
+#include "StartupProfiler.h"
+
+namespace QtD1{
+
+// Initialize static member data
+std::unique_ptr<StartupProfiler> StartupProfiler::s_instance;
+QMutex StartupProfiler::s_instance_mutex;
+
+// Constructor
+StartupProfiler::ScopedPhase::ScopedPhase( const QString& name )
+  : d_name( name ),
+    d_start_time( StartupProfiler::getInstance()->getElapsedTime() )
+{ /* ... */ }
+
+// Destructor
+StartupProfiler::ScopedPhase::~ScopedPhase()
+{
+  StartupProfiler* profiler = StartupProfiler::getInstance();
+
+  profiler->recordPhase( d_name,
+                         d_start_time,
+                         profiler->getElapsedTime() - d_start_time );
+}
+
+// Get the singleton instance
+StartupProfiler* StartupProfiler::getInstance()
+{
+  QMutexLocker instance_locker( &s_instance_mutex );
+
+  // Just-in-time initialization
+  if( !s_instance )
+    s_instance.reset( new StartupProfiler );
+
+  return s_instance.get();
+}
+
+// Constructor
+StartupProfiler::StartupProfiler()
+  : d_mutex(),
+    d_timer(),
+    d_phases()
+{
+  d_timer.start();
+}
+
+// Restart the profiler (all recorded phases will be removed)
+void StartupProfiler::restart()
+{
+  QMutexLocker locker( &d_mutex );
+
+  d_timer.restart();
+  d_phases.clear();
+}
+
+// Get the time that has elapsed since the profiler was started (ms)
+qint64 StartupProfiler::getElapsedTime() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  return d_timer.elapsed();
+}
+
+// Record a phase
+/*! \details Phases that are recorded before a QApplication has been
+ * created are assumed to run on the GUI thread.
+ */
+void StartupProfiler::recordPhase( const QString& name,
+                                   const qint64 start_time,
+                                   const qint64 duration )
+{
+  Phase phase;
+  phase.name = name;
+  phase.start_time = start_time;
+  phase.duration = duration;
+  phase.worker_thread = QCoreApplication::instance() &&
+    QThread::currentThread() != QCoreApplication::instance()->thread();
+
+  QMutexLocker locker( &d_mutex );
+
+  d_phases << phase;
+}
+
+// Get the recorded phases (ordered by start time)
+QList<StartupProfiler::Phase> StartupProfiler::getPhases() const
+{
+  QList<Phase> phases;
+
+  {
+    QMutexLocker locker( &d_mutex );
+
+    phases = d_phases;
+  }
+
+  std::stable_sort( phases.begin(),
+                    phases.end(),
+                    StartupProfiler::isPhaseStartedBefore );
+
+  return phases;
+}
+
+// Get the total time of the recorded phases (ms)
+/*! \details Phases that overlap are counted separately so the total phase
+ * time can exceed the elapsed time when phases run in worker threads.
+ */
+qint64 StartupProfiler::getTotalPhaseTime() const
+{
+  QMutexLocker locker( &d_mutex );
+
+  qint64 total_phase_time = 0;
+
+  QList<Phase>::const_iterator phase_it, phase_end;
+  phase_it = d_phases.begin();
+  phase_end = d_phases.end();
+
+  while( phase_it != phase_end )
+  {
+    total_phase_time += phase_it->duration;
+
+    ++phase_it;
+  }
+
+  return total_phase_time;
+}
+
+// Print a report of the recorded phases
+void StartupProfiler::printReport( std::ostream& os ) const
+{
+  QList<Phase> phases = this->getPhases();
+
+  os << "Startup phases (start ms, duration ms, thread):" << std::endl;
+
+  QList<Phase>::const_iterator phase_it, phase_end;
+  phase_it = phases.begin();
+  phase_end = phases.end();
+
+  while( phase_it != phase_end )
+  {
+    os << std::setw( 8 ) << phase_it->start_time
+       << std::setw( 8 ) << phase_it->duration
+       << (phase_it->worker_thread ? "  worker  " : "  gui     ")
+       << phase_it->name.toStdString() << std::endl;
+
+    ++phase_it;
+  }
+
+  os << "Startup time: " << this->getElapsedTime() << " ms ("
+     << this->getTotalPhaseTime() << " ms in phases)" << std::endl;
+}
+
+// Compare the phase start times
+bool StartupProfiler::isPhaseStartedBefore( const Phase& phase_a,
+                                            const Phase& phase_b )
+{
+  return phase_a.start_time < phase_b.start_time;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end StartupProfiler.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,132 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   StartupProfiler.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The startup profiler class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef STARTUP_PROFILER_H
+#define STARTUP_PROFILER_H
+
+// Std Lib Includes
+#include <memory>
+#include <iostream>
+
+// Qt Includes
+#include <QString>
+#include <QList>
+#include <QElapsedTimer>
+#include <QMutex>
+
+namespace QtD1{
+
+/*! The startup profiler
+ *
+ * Records the time that every startup phase (e.g. opening the audio device
+ * or decoding a bitmap font) takes. The phases can be recorded by any
+ * thread. The times are relative to the moment that the profiler was first
+ * used (or restarted) so that overlapping phases can be identified.
+ */
+class StartupProfiler
+{
+
+public:
+
+  //! A startup phase
+  struct Phase{
+    //! The phase name
+    QString name;
+    //! The phase start time (ms)
+    qint64 start_time;
+    //! The phase duration (ms)
+    qint64 duration;
+    //! Records if the phase ran in a worker thread
+    bool worker_thread;
+  };
+
+  //! A phase that is recorded when it goes out of scope
+  class ScopedPhase
+  {
+
+  public:
+
+    //! Constructor
+    ScopedPhase( const QString& name );
+
+    //! Destructor
+    ~ScopedPhase();
+
+  private:
+
+    // Constructors and assignment operator
+    ScopedPhase();
+    ScopedPhase( const ScopedPhase& that );
+    ScopedPhase& operator=( const ScopedPhase& that );
+
+    // The phase name
+    QString d_name;
+
+    // The phase start time (ms)
+    qint64 d_start_time;
+  };
+
+  //! Get the singleton instance
+  static StartupProfiler* getInstance();
+
+  //! Destructor
+  ~StartupProfiler()
+  { /* ... */ }
+
+  //! Restart the profiler (all recorded phases will be removed)
+  void restart();
+
+  //! Get the time that has elapsed since the profiler was started (ms)
+  qint64 getElapsedTime() const;
+
+  //! Record a phase
+  void recordPhase( const QString& name,
+                    const qint64 start_time,
+                    const qint64 duration );
+
+  //! Get the recorded phases (ordered by start time)
+  QList<Phase> getPhases() const;
+
+  //! Get the total time of the recorded phases (ms)
+  qint64 getTotalPhaseTime() const;
+
+  //! Print a report of the recorded phases
+  void printReport( std::ostream& os ) const;
+
+private:
+
+  // Constructor
+  StartupProfiler();
+
+  // Compare the phase start times
+  static bool isPhaseStartedBefore( const Phase& phase_a,
+                                    const Phase& phase_b );
+
+  // The singleton instance
+  static std::unique_ptr<StartupProfiler> s_instance;
+
+  // The singleton instance mutex
+  static QMutex s_instance_mutex;
+
+  // The phase mutex
+  mutable QMutex d_mutex;
+
+  // The startup timer
+  QElapsedTimer d_timer;
+
+  // The recorded phases
+  QList<Phase> d_phases;
+};
+
+} // end QtD1 namespace
+
+#endif // end STARTUP_PROFILER_H
+
+//---------------------------------------------------------------------------//
+// end StartupProfiler.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,606 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   Telemetry.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The telemetry class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <fstream>
+#include <iomanip>
+
+// Qt Includes
+#include <QMutexLocker>
+#include <QThread>
+#include <QCoreApplication>
+
+// QtD1 Includes
+#include "Telemetry.h"
+
+namespace QtD1{
+
+// Initialize static member data
+std::unique_ptr<Telemetry> Telemetry::s_instance;
+QMutex Telemetry::s_instance_mutex;
+std::atomic<qint64> Telemetry::s_counters[Telemetry::s_number_of_counters];
+Telemetry::HistogramData
+Telemetry::s_histograms[Telemetry::s_number_of_histograms];
+std::atomic<bool> Telemetry::s_tracing( false );
+thread_local Telemetry::ThreadTraceBuffer* Telemetry::s_thread_trace_buffer =
+  NULL;
+
+// Get the mean sample
+double Telemetry::HistogramSnapshot::getMean() const
+{
+  if( count > 0 )
+    return sum/(double)count;
+  else
+    return 0.0;
+}
+
+// Get the upper bound of the bucket that contains the percentile
+/*! \details The percentile must be in [0.0,1.0]. The max sample will be
+ * returned if it is less than the bucket upper bound.
+ */
+qint64 Telemetry::HistogramSnapshot::getPercentile(
+                                            const double percentile ) const
+{
+  if( count == 0 )
+    return 0;
+
+  const qint64 target_count = (qint64)(percentile*count + 0.5);
+
+  qint64 cumulative_count = 0;
+
+  for( int i = 0; i < buckets.size(); ++i )
+  {
+    cumulative_count += buckets[i];
+
+    if( cumulative_count >= target_count && cumulative_count > 0 )
+    {
+      const qint64 bucket_upper_bound = ((qint64)1 << i) - 1;
+
+      return bucket_upper_bound < max ? bucket_upper_bound : max;
+    }
+  }
+
+  return max;
+}
+
+// Constructor
+Telemetry::ScopedTimer::ScopedTimer( const Histogram histogram )
+  : d_histogram( histogram ),
+    d_trace_name(),
+    d_timer()
+{
+  d_timer.start();
+}
+
+// Constructor (the trace event will have the requested name)
+Telemetry::ScopedTimer::ScopedTimer( const Histogram histogram,
+                                     const QString& trace_name )
+  : d_histogram( histogram ),
+    d_trace_name( trace_name ),
+    d_timer()
+{
+  d_timer.start();
+}
+
+// Destructor
+/*! \details The histogram sample is in microseconds. A trace event is only
+ * recorded if tracing has been started (the telemetry instance does not
+ * need to be acquired otherwise).
+ */
+Telemetry::ScopedTimer::~ScopedTimer()
+{
+  const qint64 duration = d_timer.nsecsElapsed()/1000;
+
+  Telemetry::addSample( d_histogram, duration );
+
+  if( Telemetry::isTracing() )
+  {
+    Telemetry* telemetry = Telemetry::getInstance();
+
+    telemetry->recordTraceEvent(
+                  d_trace_name.isEmpty() ?
+                  Telemetry::getHistogramName( d_histogram ) : d_trace_name,
+                  d_histogram,
+                  telemetry->getElapsedTime() - duration,
+                  duration );
+  }
+}
+
+// Constructor
+Telemetry::ThreadTraceBuffer::ThreadTraceBuffer( const int id,
+                                                 const QString& name )
+  : thread_id( id ),
+    thread_name( name ),
+    events( Telemetry::s_thread_trace_buffer_size )
+{ /* ... */ }
+
+// Get the singleton instance
+Telemetry* Telemetry::getInstance()
+{
+  QMutexLocker instance_locker( &s_instance_mutex );
+
+  // Just-in-time initialization
+  if( !s_instance )
+    s_instance.reset( new Telemetry );
+
+  return s_instance.get();
+}
+
+// Constructor
+Telemetry::Telemetry()
+  : d_timer(),
+    d_buffer_mutex(),
+    d_thread_trace_buffers(),
+    d_trace_mutex(),
+    d_trace_events()
+{
+  d_timer.start();
+}
+
+// Get the counter name
+QString Telemetry::getCounterName( const Counter counter )
+{
+  switch( counter )
+  {
+  case MPQBytesReadCounter:
+    return "MPQ bytes read";
+  case MPQFilesExtractedCounter:
+    return "MPQ files extracted";
+  case ImageAssetsLoadedCounter:
+    return "Image assets loaded";
+  case ImageAssetBytesLoadedCounter:
+    return "Image asset bytes loaded";
+  case AudioVideoDriftCounter:
+    return "A/V drift (us)";
+  case DroppedTraceEventsCounter:
+    return "Dropped trace events";
+  default:
+    qFatal( "Telemetry Error: Counter %i is not valid!", (int)counter );
+  }
+
+  return QString();
+}
+
+// Get the histogram name
+QString Telemetry::getHistogramName( const Histogram histogram )
+{
+  switch( histogram )
+  {
+  case GameUpdateTimeHistogram:
+    return "Game update (us)";
+  case GameTickTimeHistogram:
+    return "Game tick (us)";
+  case LevelPillarPaintTimeHistogram:
+    return "Paint LevelPillar (us)";
+  case GameSpritePaintTimeHistogram:
+    return "Paint GameSprite (us)";
+  case InteractiveObjectPaintTimeHistogram:
+    return "Paint InteractiveLevelObject (us)";
+  case MonsterPaintTimeHistogram:
+    return "Paint MonsterRenderProxy (us)";
+  case ProjectilePaintTimeHistogram:
+    return "Paint ProjectileLayer (us)";
+  case ImageAssetDecodeTimeHistogram:
+    return "Image asset decode (us)";
+  case ThreadSafeQueueDepthHistogram:
+    return "Thread safe queue depth";
+  case AudioVideoDriftHistogram:
+    return "A/V drift magnitude (us)";
+  default:
+    qFatal( "Telemetry Error: Histogram %i is not valid!", (int)histogram );
+  }
+
+  return QString();
+}
+
+// Add to a counter (thread-safe, lock-free)
+void Telemetry::addToCounter( const Counter counter, const qint64 value )
+{
+  s_counters[counter].fetch_add( value, std::memory_order_relaxed );
+}
+
+// Set a counter (thread-safe, lock-free)
+void Telemetry::setCounter( const Counter counter, const qint64 value )
+{
+  s_counters[counter].store( value, std::memory_order_relaxed );
+}
+
+// Get a counter value
+qint64 Telemetry::getCounter( const Counter counter )
+{
+  return s_counters[counter].load( std::memory_order_relaxed );
+}
+
+// Add a histogram sample (thread-safe, lock-free)
+/*! \details Negative samples are recorded as zero. The histogram fields
+ * are updated independently so a snapshot that is taken while samples are
+ * being added may be off by a few samples.
+ */
+void Telemetry::addSample( const Histogram histogram, const qint64 value )
+{
+  const qint64 sample = value > 0 ? value : 0;
+
+  HistogramData& data = s_histograms[histogram];
+
+  data.count.fetch_add( 1, std::memory_order_relaxed );
+  data.sum.fetch_add( sample, std::memory_order_relaxed );
+  data.buckets[Telemetry::getBucket( sample )].fetch_add(
+                                             1, std::memory_order_relaxed );
+
+  qint64 max = data.max.load( std::memory_order_relaxed );
+
+  while( sample > max &&
+         !data.max.compare_exchange_weak( max,
+                                          sample,
+                                          std::memory_order_relaxed ) );
+}
+
+// Get a histogram snapshot
+Telemetry::HistogramSnapshot Telemetry::getHistogram(
+                                                const Histogram histogram )
+{
+  const HistogramData& data = s_histograms[histogram];
+
+  HistogramSnapshot snapshot;
+  snapshot.name = Telemetry::getHistogramName( histogram );
+  snapshot.count = data.count.load( std::memory_order_relaxed );
+  snapshot.sum = data.sum.load( std::memory_order_relaxed );
+  snapshot.max = data.max.load( std::memory_order_relaxed );
+  snapshot.buckets.resize( s_number_of_histogram_buckets );
+
+  for( int i = 0; i < s_number_of_histogram_buckets; ++i )
+    snapshot.buckets[i] = data.buckets[i].load( std::memory_order_relaxed );
+
+  return snapshot;
+}
+
+// Reset the counters and histograms
+void Telemetry::reset()
+{
+  for( int i = 0; i < s_number_of_counters; ++i )
+    s_counters[i].store( 0, std::memory_order_relaxed );
+
+  for( int i = 0; i < s_number_of_histograms; ++i )
+  {
+    s_histograms[i].count.store( 0, std::memory_order_relaxed );
+    s_histograms[i].sum.store( 0, std::memory_order_relaxed );
+    s_histograms[i].max.store( 0, std::memory_order_relaxed );
+
+    for( int j = 0; j < s_number_of_histogram_buckets; ++j )
+      s_histograms[i].buckets[j].store( 0, std::memory_order_relaxed );
+  }
+}
+
+// Check if trace events are being recorded
+bool Telemetry::isTracing()
+{
+  return s_tracing.load( std::memory_order_relaxed );
+}
+
+// Get the time that has elapsed since the telemetry was created (us)
+qint64 Telemetry::getElapsedTime() const
+{
+  return d_timer.nsecsElapsed()/1000;
+}
+
+// Start recording trace events (the previous trace will be removed)
+void Telemetry::startTrace()
+{
+  this->stopTrace();
+
+  // Discard the events that are still buffered
+  this->drainTraceBuffers();
+
+  {
+    QMutexLocker locker( &d_trace_mutex );
+
+    d_trace_events.clear();
+  }
+
+  s_tracing.store( true, std::memory_order_relaxed );
+}
+
+// Stop recording trace events
+void Telemetry::stopTrace()
+{
+  s_tracing.store( false, std::memory_order_relaxed );
+}
+
+// Record a trace event (the name will only be used if tracing)
+/*! \details The event is added to the buffer that belongs to the calling
+ * thread. If the buffer is full the event will be dropped (the buffers are
+ * drained by the game every frame).
+ */
+void Telemetry::recordTraceEvent( const QString& name,
+                                  const Histogram histogram,
+                                  const qint64 start_time,
+                                  const qint64 duration )
+{
+  if( !Telemetry::isTracing() )
+    return;
+
+  ThreadTraceBuffer* buffer = this->getThreadTraceBuffer();
+
+  TraceEvent event;
+  event.name = name;
+  event.histogram = histogram;
+  event.start_time = start_time;
+  event.duration = duration;
+  event.thread_id = buffer->thread_id;
+
+  if( !buffer->events.push( event ) )
+    Telemetry::addToCounter( DroppedTraceEventsCounter, 1 );
+}
+
+// Move the buffered trace events into the trace (one thread at a time)
+/*! \details Events that do not fit in the trace will be dropped.
+ */
+void Telemetry::drainTraceBuffers()
+{
+  QList<std::shared_ptr<ThreadTraceBuffer> > buffers;
+
+  {
+    QMutexLocker locker( &d_buffer_mutex );
+
+    buffers = d_thread_trace_buffers;
+  }
+
+  QMutexLocker locker( &d_trace_mutex );
+
+  QList<std::shared_ptr<ThreadTraceBuffer> >::iterator buffer_it, buffer_end;
+  buffer_it = buffers.begin();
+  buffer_end = buffers.end();
+
+  while( buffer_it != buffer_end )
+  {
+    TraceEvent event;
+
+    while( (*buffer_it)->events.pop( event ) )
+    {
+      if( d_trace_events.size() < s_max_number_of_trace_events )
+        d_trace_events << event;
+      else
+        Telemetry::addToCounter( DroppedTraceEventsCounter, 1 );
+    }
+
+    ++buffer_it;
+  }
+}
+
+// Get the recorded trace events (the buffers will be drained)
+QList<Telemetry::TraceEvent> Telemetry::getTraceEvents()
+{
+  this->drainTraceBuffers();
+
+  QMutexLocker locker( &d_trace_mutex );
+
+  return d_trace_events;
+}
+
+// Export the trace (Chrome trace event format)
+bool Telemetry::exportChromeTrace( const QString& file_name )
+{
+  std::ofstream file( file_name.toLocal8Bit().data() );
+
+  if( !file.is_open() )
+  {
+    qWarning( "Telemetry Warning: Could not open trace file %s!",
+              file_name.toLocal8Bit().data() );
+
+    return false;
+  }
+
+  this->exportChromeTrace( file );
+
+  return file.good();
+}
+
+// Export the trace (Chrome trace event format)
+/*! \details Every event is exported as a complete ("X") event and every
+ * thread gets a thread name ("M") event. The final counter values are
+ * exported as counter ("C") events.
+ */
+void Telemetry::exportChromeTrace( std::ostream& os )
+{
+  const QList<TraceEvent> trace_events = this->getTraceEvents();
+
+  QList<std::shared_ptr<ThreadTraceBuffer> > buffers;
+
+  {
+    QMutexLocker locker( &d_buffer_mutex );
+
+    buffers = d_thread_trace_buffers;
+  }
+
+  const qint64 process_id = QCoreApplication::applicationPid();
+
+  os << "{\"traceEvents\":[";
+
+  bool first_event = true;
+
+  QList<std::shared_ptr<ThreadTraceBuffer> >::const_iterator buffer_it,
+    buffer_end;
+  buffer_it = buffers.begin();
+  buffer_end = buffers.end();
+
+  while( buffer_it != buffer_end )
+  {
+    os << (first_event ? "\n" : ",\n")
+       << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << process_id
+       << ",\"tid\":" << (*buffer_it)->thread_id
+       << ",\"args\":{\"name\":\""
+       << Telemetry::escapeJSONString( (*buffer_it)->thread_name )
+       << "\"}}";
+
+    first_event = false;
+
+    ++buffer_it;
+  }
+
+  QList<TraceEvent>::const_iterator event_it, event_end;
+  event_it = trace_events.begin();
+  event_end = trace_events.end();
+
+  while( event_it != event_end )
+  {
+    os << (first_event ? "\n" : ",\n")
+       << "{\"name\":\"" << Telemetry::escapeJSONString( event_it->name )
+       << "\",\"cat\":\""
+       << Telemetry::escapeJSONString( Telemetry::getHistogramName(
+                                      (Histogram)event_it->histogram ) )
+       << "\",\"ph\":\"X\",\"ts\":" << event_it->start_time
+       << ",\"dur\":" << event_it->duration
+       << ",\"pid\":" << process_id
+       << ",\"tid\":" << event_it->thread_id << "}";
+
+    first_event = false;
+
+    ++event_it;
+  }
+
+  const qint64 time = this->getElapsedTime();
+
+  for( int i = 0; i < s_number_of_counters; ++i )
+  {
+    const QString name = Telemetry::getCounterName( (Counter)i );
+
+    os << (first_event ? "\n" : ",\n")
+       << "{\"name\":\"" << Telemetry::escapeJSONString( name )
+       << "\",\"ph\":\"C\",\"ts\":" << time
+       << ",\"pid\":" << process_id
+       << ",\"args\":{\"value\":" << Telemetry::getCounter( (Counter)i )
+       << "}}";
+
+    first_event = false;
+  }
+
+  os << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+}
+
+// Print a report of the counters and histograms
+void Telemetry::printReport( std::ostream& os ) const
+{
+  os << "Counters:" << std::endl;
+
+  for( int i = 0; i < s_number_of_counters; ++i )
+  {
+    os << std::setw( 14 ) << Telemetry::getCounter( (Counter)i ) << "  "
+       << Telemetry::getCounterName( (Counter)i ).toStdString()
+       << std::endl;
+  }
+
+  os << "Histograms (count, mean, p50, p95, max):" << std::endl;
+
+  for( int i = 0; i < s_number_of_histograms; ++i )
+  {
+    const HistogramSnapshot histogram =
+      Telemetry::getHistogram( (Histogram)i );
+
+    os << std::setw( 10 ) << histogram.count
+       << std::setw( 10 ) << (qint64)histogram.getMean()
+       << std::setw( 10 ) << histogram.getPercentile( 0.5 )
+       << std::setw( 10 ) << histogram.getPercentile( 0.95 )
+       << std::setw( 10 ) << histogram.max << "  "
+       << histogram.name.toStdString() << std::endl;
+  }
+}
+
+// Get the trace buffer that belongs to the calling thread
+/*! \details The buffer is created the first time that a thread records a
+ * trace event. Buffers are kept after their threads finish so that their
+ * events can still be drained.
+ */
+Telemetry::ThreadTraceBuffer* Telemetry::getThreadTraceBuffer()
+{
+  if( !s_thread_trace_buffer )
+  {
+    QString thread_name;
+
+    if( QCoreApplication::instance() &&
+        QThread::currentThread() == QCoreApplication::instance()->thread() )
+      thread_name = "GUI";
+    else
+      thread_name = "Worker";
+
+    QMutexLocker locker( &d_buffer_mutex );
+
+    const int thread_id = d_thread_trace_buffers.size() + 1;
+
+    std::shared_ptr<ThreadTraceBuffer> buffer(
+          new ThreadTraceBuffer( thread_id,
+                                 QString( "%1 %2" ).arg( thread_name )
+                                                   .arg( thread_id ) ) );
+
+    d_thread_trace_buffers << buffer;
+
+    s_thread_trace_buffer = buffer.get();
+  }
+
+  return s_thread_trace_buffer;
+}
+
+// Get the bucket that a histogram sample belongs to
+/*! \details Bucket 0 holds the zero samples and bucket i holds the samples
+ * in [2^(i-1),2^i). The last bucket also holds all larger samples.
+ */
+int Telemetry::getBucket( const qint64 value )
+{
+  int bucket = 0;
+  quint64 remaining_value = value;
+
+  while( remaining_value > 0 && bucket < s_number_of_histogram_buckets - 1 )
+  {
+    remaining_value >>= 1;
+    ++bucket;
+  }
+
+  return bucket;
+}
+
+// Escape a string for JSON
+std::string Telemetry::escapeJSONString( const QString& string )
+{
+  const QByteArray utf8_string = string.toUtf8();
+
+  std::string escaped_string;
+  escaped_string.reserve( utf8_string.size() );
+
+  for( int i = 0; i < utf8_string.size(); ++i )
+  {
+    const char character = utf8_string[i];
+
+    switch( character )
+    {
+    case '"':
+      escaped_string += "\\\"";
+      break;
+    case '\\':
+      escaped_string += "\\\\";
+      break;
+    case '\n':
+      escaped_string += "\\n";
+      break;
+    case '\t':
+      escaped_string += "\\t";
+      break;
+    default:
+      if( (unsigned char)character < 0x20 )
+        escaped_string += ' ';
+      else
+        escaped_string += character;
+    }
+  }
+
+  return escaped_string;
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end Telemetry.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,292 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   Telemetry.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The telemetry class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// Std Lib Includes
+#include <memory>
+#include <atomic>
+#include <iostream>
+
+// Qt Includes
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QMutex>
+
+// QtD1 Includes
+#include "LockFreeQueue.h"
+
+namespace QtD1{
+
+/*! The telemetry
+ *
+ * Collects the engine-wide frame and load statistics (e.g. the tick time,
+ * the time spent painting each type of graphics item, the time spent
+ * decoding each asset and the number of bytes read from the MPQ archive).
+ * Counters and histograms can be updated by any thread without taking a
+ * lock. When tracing has been started, the scoped timers also record trace
+ * events in a buffer that belongs to the recording thread. The trace can
+ * be exported in the Chrome trace event format (chrome://tracing).
+ */
+class Telemetry
+{
+
+public:
+
+  //! The counters
+  enum Counter{
+    MPQBytesReadCounter = 0,
+    MPQFilesExtractedCounter,
+    ImageAssetsLoadedCounter,
+    ImageAssetBytesLoadedCounter,
+    AudioVideoDriftCounter,
+    DroppedTraceEventsCounter
+  };
+
+  //! The number of counters
+  static const int s_number_of_counters = 6;
+
+  //! The histograms
+  enum Histogram{
+    GameUpdateTimeHistogram = 0,
+    GameTickTimeHistogram,
+    LevelPillarPaintTimeHistogram,
+    GameSpritePaintTimeHistogram,
+    InteractiveObjectPaintTimeHistogram,
+    MonsterPaintTimeHistogram,
+    ProjectilePaintTimeHistogram,
+    ImageAssetDecodeTimeHistogram,
+    ThreadSafeQueueDepthHistogram,
+    AudioVideoDriftHistogram
+  };
+
+  //! The number of histograms
+  static const int s_number_of_histograms = 10;
+
+  //! The number of histogram buckets (bucket i holds values < 2^i)
+  static const int s_number_of_histogram_buckets = 32;
+
+  //! The number of trace events that a thread can buffer between drains
+  static const int s_thread_trace_buffer_size = 8192;
+
+  //! The max number of trace events that will be kept
+  static const int s_max_number_of_trace_events = 1 << 20;
+
+  //! A histogram snapshot
+  struct HistogramSnapshot{
+    //! The histogram name
+    QString name;
+    //! The number of samples
+    qint64 count;
+    //! The sum of the samples
+    qint64 sum;
+    //! The max sample
+    qint64 max;
+    //! The bucket sample counts
+    QVector<qint64> buckets;
+
+    //! Get the mean sample
+    double getMean() const;
+
+    //! Get the upper bound of the bucket that contains the percentile
+    qint64 getPercentile( const double percentile ) const;
+  };
+
+  //! A trace event
+  struct TraceEvent{
+    //! The event name
+    QString name;
+    //! The histogram that the event was recorded with
+    int histogram;
+    //! The event start time (us since the telemetry was created)
+    qint64 start_time;
+    //! The event duration (us)
+    qint64 duration;
+    //! The id of the thread that recorded the event
+    int thread_id;
+  };
+
+  //! A timer that records a histogram sample when it goes out of scope
+  class ScopedTimer
+  {
+
+  public:
+
+    //! Constructor
+    ScopedTimer( const Histogram histogram );
+
+    //! Constructor (the trace event will have the requested name)
+    ScopedTimer( const Histogram histogram, const QString& trace_name );
+
+    //! Destructor
+    ~ScopedTimer();
+
+  private:
+
+    // Constructors and assignment operator
+    ScopedTimer();
+    ScopedTimer( const ScopedTimer& that );
+    ScopedTimer& operator=( const ScopedTimer& that );
+
+    // The histogram
+    Histogram d_histogram;
+
+    // The trace event name
+    QString d_trace_name;
+
+    // The timer
+    QElapsedTimer d_timer;
+  };
+
+  //! Get the singleton instance
+  static Telemetry* getInstance();
+
+  //! Destructor
+  ~Telemetry()
+  { /* ... */ }
+
+  //! Get the counter name
+  static QString getCounterName( const Counter counter );
+
+  //! Get the histogram name
+  static QString getHistogramName( const Histogram histogram );
+
+  //! Add to a counter (thread-safe, lock-free)
+  static void addToCounter( const Counter counter, const qint64 value );
+
+  //! Set a counter (thread-safe, lock-free)
+  static void setCounter( const Counter counter, const qint64 value );
+
+  //! Get a counter value
+  static qint64 getCounter( const Counter counter );
+
+  //! Add a histogram sample (thread-safe, lock-free)
+  static void addSample( const Histogram histogram, const qint64 value );
+
+  //! Get a histogram snapshot
+  static HistogramSnapshot getHistogram( const Histogram histogram );
+
+  //! Reset the counters and histograms
+  static void reset();
+
+  //! Check if trace events are being recorded
+  static bool isTracing();
+
+  //! Get the time that has elapsed since the telemetry was created (us)
+  qint64 getElapsedTime() const;
+
+  //! Start recording trace events (the previous trace will be removed)
+  void startTrace();
+
+  //! Stop recording trace events
+  void stopTrace();
+
+  //! Record a trace event (the name will only be used if tracing)
+  void recordTraceEvent( const QString& name,
+                         const Histogram histogram,
+                         const qint64 start_time,
+                         const qint64 duration );
+
+  //! Move the buffered trace events into the trace (one thread at a time)
+  void drainTraceBuffers();
+
+  //! Get the recorded trace events (the buffers will be drained)
+  QList<TraceEvent> getTraceEvents();
+
+  //! Export the trace (Chrome trace event format)
+  bool exportChromeTrace( const QString& file_name );
+
+  //! Export the trace (Chrome trace event format)
+  void exportChromeTrace( std::ostream& os );
+
+  //! Print a report of the counters and histograms
+  void printReport( std::ostream& os ) const;
+
+private:
+
+  // A trace buffer (only written by the thread that owns it)
+  struct ThreadTraceBuffer{
+    // Constructor
+    ThreadTraceBuffer( const int id, const QString& name );
+
+    // The thread id
+    int thread_id;
+    // The thread name
+    QString thread_name;
+    // The buffered events
+    LockFreeQueue<TraceEvent> events;
+  };
+
+  // The histogram data
+  struct HistogramData{
+    // The number of samples
+    std::atomic<qint64> count;
+    // The sum of the samples
+    std::atomic<qint64> sum;
+    // The max sample
+    std::atomic<qint64> max;
+    // The bucket sample counts
+    std::atomic<qint64> buckets[s_number_of_histogram_buckets];
+  };
+
+  // Constructor
+  Telemetry();
+
+  // Get the trace buffer that belongs to the calling thread
+  ThreadTraceBuffer* getThreadTraceBuffer();
+
+  // Get the bucket that a histogram sample belongs to
+  static int getBucket( const qint64 value );
+
+  // Escape a string for JSON
+  static std::string escapeJSONString( const QString& string );
+
+  // The singleton instance
+  static std::unique_ptr<Telemetry> s_instance;
+
+  // The singleton instance mutex
+  static QMutex s_instance_mutex;
+
+  // The counters
+  static std::atomic<qint64> s_counters[s_number_of_counters];
+
+  // The histograms
+  static HistogramData s_histograms[s_number_of_histograms];
+
+  // Records if trace events are being recorded
+  static std::atomic<bool> s_tracing;
+
+  // The trace buffer that belongs to the calling thread
+  static thread_local ThreadTraceBuffer* s_thread_trace_buffer;
+
+  // The telemetry timer
+  QElapsedTimer d_timer;
+
+  // The trace buffer mutex
+  mutable QMutex d_buffer_mutex;
+
+  // The thread trace buffers (kept until the telemetry is destroyed)
+  QList<std::shared_ptr<ThreadTraceBuffer> > d_thread_trace_buffers;
+
+  // The trace mutex (only one thread can drain the buffers at a time)
+  mutable QMutex d_trace_mutex;
+
+  // The recorded trace events
+  QList<TraceEvent> d_trace_events;
+};
+
+} // end QtD1 namespace
+
+#endif // end TELEMETRY_H
+
+//---------------------------------------------------------------------------//
+// end Telemetry.h
+//---------------------------------------------------------------------------//
@@ -0,0 +1,115 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TelemetryOverlay.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The telemetry overlay class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QPainter>
+#include <QTimerEvent>
+
+// QtD1 Includes
+#include "TelemetryOverlay.h"
+#include "Telemetry.h"
+
+namespace QtD1{
+
+// Constructor
+TelemetryOverlay::TelemetryOverlay( QWidget* parent )
+  : QWidget( parent ),
+    d_refresh_timer_id( -1 ),
+    d_lines()
+{
+  this->setAttribute( Qt::WA_TransparentForMouseEvents );
+  this->setFixedSize( 400, 300 );
+}
+
+// Handle show events
+void TelemetryOverlay::showEvent( QShowEvent* )
+{
+  this->updateLines();
+
+  if( d_refresh_timer_id < 0 )
+    d_refresh_timer_id = this->startTimer( s_refresh_interval );
+}
+
+// Handle hide events
+void TelemetryOverlay::hideEvent( QHideEvent* )
+{
+  if( d_refresh_timer_id >= 0 )
+  {
+    this->killTimer( d_refresh_timer_id );
+
+    d_refresh_timer_id = -1;
+  }
+}
+
+// Handle the timer event
+void TelemetryOverlay::timerEvent( QTimerEvent* event )
+{
+  if( event->timerId() == d_refresh_timer_id )
+  {
+    this->updateLines();
+    this->update();
+  }
+}
+
+// Handle paint events
+void TelemetryOverlay::paintEvent( QPaintEvent* )
+{
+  QPainter painter( this );
+
+  painter.fillRect( this->rect(), QColor( 0, 0, 0, 160 ) );
+  painter.setPen( Qt::white );
+
+  const int line_height = painter.fontMetrics().height();
+
+  for( int i = 0; i < d_lines.size(); ++i )
+    painter.drawText( 5, (i+1)*line_height, d_lines[i] );
+}
+
+// Update the overlay lines
+/*! \details The histograms that do not have any samples are skipped.
+ */
+void TelemetryOverlay::updateLines()
+{
+  d_lines.clear();
+
+  for( int i = 0; i < Telemetry::s_number_of_counters; ++i )
+  {
+    const Telemetry::Counter counter = (Telemetry::Counter)i;
+
+    d_lines << QString( "%1: %2" )
+      .arg( Telemetry::getCounterName( counter ) )
+      .arg( Telemetry::getCounter( counter ) );
+  }
+
+  d_lines << "count / mean / p95 / max";
+
+  for( int i = 0; i < Telemetry::s_number_of_histograms; ++i )
+  {
+    const Telemetry::HistogramSnapshot histogram =
+      Telemetry::getHistogram( (Telemetry::Histogram)i );
+
+    if( histogram.count > 0 )
+    {
+      d_lines << QString( "%1: %2 / %3 / %4 / %5" )
+        .arg( histogram.name )
+        .arg( histogram.count )
+        .arg( (qint64)histogram.getMean() )
+        .arg( histogram.getPercentile( 0.95 ) )
+        .arg( histogram.max );
+    }
+  }
+
+  if( Telemetry::isTracing() )
+    d_lines << "Tracing (F11 to stop and export)";
+}
+
+} // end QtD1 namespace
+
+//---------------------------------------------------------------------------//
+// end TelemetryOverlay.cpp
+//---------------------------------------------------------------------------//
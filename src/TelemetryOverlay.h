@@ -0,0 +1,72 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TelemetryOverlay.h
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The telemetry overlay class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef TELEMETRY_OVERLAY_H
+#define TELEMETRY_OVERLAY_H
+
+// Qt Includes
+#include <QWidget>
+#include <QStringList>
+
+namespace QtD1{
+
+/*! The telemetry overlay
+ *
+ * Shows the telemetry counters and histograms on top of the game. The
+ * overlay is refreshed a few times a second while it is visible and it
+ * ignores all mouse events.
+ */
+class TelemetryOverlay : public QWidget
+{
+  Q_OBJECT
+
+public:
+
+  //! Constructor
+  TelemetryOverlay( QWidget* parent = 0 );
+
+  //! Destructor
+  ~TelemetryOverlay()
+  { /* ... */ }
+
+protected:
+
+  //! Handle show events
+  void showEvent( QShowEvent* event ) override;
+
+  //! Handle hide events
+  void hideEvent( QHideEvent* event ) override;
+
+  //! Handle the timer event
+  void timerEvent( QTimerEvent* event ) override;
+
+  //! Handle paint events
+  void paintEvent( QPaintEvent* event ) override;
+
+private:
+
+  // Update the overlay lines
+  void updateLines();
+
+  // The refresh interval (ms)
+  static const int s_refresh_interval = 500;
+
+  // The refresh timer id
+  int d_refresh_timer_id;
+
+  // The overlay lines
+  QStringList d_lines;
+};
+
+} // end QtD1 namespace
+
+#endif // end TELEMETRY_OVERLAY_H
+
+//---------------------------------------------------------------------------//
+// end TelemetryOverlay.h
+//---------------------------------------------------------------------------//
@@ -12,6 +12,9 @@
 // Qt Includes
 #include <QMutexLocker>
 
+// QtD1 Includes
+#include "Telemetry.h"
+
 namespace QtD1{
 
 // Initialize the static member data
@@ -45,6 +48,10 @@ void ThreadSafeQueue<T>::pushBack( const T& item )
   QMutexLocker locker(&d_mutex);
   
   d_data.push_back( item );
+
+  // Record the queue depth (a growing depth means the consumer is behind)
+  Telemetry::addSample( Telemetry::ThreadSafeQueueDepthHistogram,
+                        d_data.size() );
   
   d_cond.wakeOne();
 }
@@ -8,11 +8,16 @@
 
 // QtD1 Includes
 #include "Town.h"
-#include "LevelSquareFactory.h"
-#include "LevelSectorFactory.h"
 
 namespace QtD1{
 
+// Initialize static member data
+const char* Town::s_sector_dun_file_names[4] =
+  {"/levels/towndata/sector4s.dun",
+   "/levels/towndata/sector3s.dun",
+   "/levels/towndata/sector2s.dun",
+   "/levels/towndata/sector1s.dun"};
+
 //! Constructor
 Town::Town( QObject* parent )
   : Level( parent, "/music/dtowne.wav" )
@@ -36,6 +41,16 @@ QString Town::getImageAssetName() const
   return "/levels/towndata/town.cel+levels/towndata/town.pal";
 }
 
+// Get the sound sources that should be preloaded
+/*! \details The control panel sounds are needed as soon as the town has
+ * been loaded.
+ */
+QStringList Town::getSoundSources() const
+{
+  return QStringList() << "/sfx/items/titlemov.wav"
+                       << "/sfx/items/titlslct.wav";
+}
+
 // Insert the character
 void Town::insertCharacter( Character* character,
                             const QPointF& location,
@@ -54,63 +69,117 @@ void Town::removeCharacter()
   Level::removeCharacter();
 }
 
-// Create the level sectors
-void Town::createSectors( QList<LevelSector*>& sectors )
+// Create the town level blob baker
+LevelBlobBaker Town::createLevelBlobBaker()
 {
-  QString level_min_file_name( "/levels/towndata/town.min" );
-  QString level_sol_file_name( "/levels/towndata/town.sol" );
-  QString level_til_file_name( "/levels/towndata/town.til" );
+  LevelBlobBaker baker( "/levels/towndata/town.min",
+                        "/levels/towndata/town.til",
+                        "/levels/towndata/town.sol" );
+
+  baker.addSector( "/levels/towndata/sector4s.dun" );
+  baker.addSector( "/levels/towndata/sector3s.dun" );
+  baker.addSector( "/levels/towndata/sector2s.dun" );
+  baker.addSector( "/levels/towndata/sector1s.dun" );
 
-  QList<std::shared_ptr<LevelSquare> > level_squares;
+  return baker;
+}
+
+// Get the background data loader
+Level::BackgroundDataLoader Town::getBackgroundDataLoader() const
+{
+  return &Town::loadBackgroundData;
+}
 
+// Load the background data
+/*! \details This is called off the GUI thread so only plain data is created.
+ * The baked town is memory mapped (it is baked and saved on the first run) so
+ * no level files are parsed. The town is rebaked if the level files have
+ * changed since it was baked (only the file contents are hashed).
+ */
+void Town::loadBackgroundData( Background& background )
+{
+  const QString blob_file_name = LevelBlob::getBakedLevelFileName( "town" );
+
+  const LevelBlobBaker baker = Town::createLevelBlobBaker();
+
+  std::shared_ptr<LevelBlob> blob( new LevelBlob );
+
+  if( !blob->open( blob_file_name ) ||
+      blob->getSourceChecksum() != baker.calculateSourceChecksum() )
   {
-    LevelSquareFactory level_square_factory( level_min_file_name,
-                                             level_til_file_name );
+    // A stale blob must not be mapped while it is replaced
+    blob->close();
 
-    level_squares = level_square_factory.createLevelSquares();
+    const QByteArray blob_data = baker.bake();
+
+    if( !LevelBlobBaker::write( blob_data, blob_file_name ) )
+    {
+      qWarning( "Town Warning: Unable to save the baked town to %s!",
+                blob_file_name.toStdString().c_str() );
+    }
+
+    blob->open( blob_data );
   }
 
-  // Create the top sector first
-  LevelSector* top_sector =
-    this->createSector( level_min_file_name,
-                        level_til_file_name,
-                        "/levels/towndata/sector4s.dun",
-                        level_squares );
-
-  // Create the left sector
-  LevelSector* left_sector =
-    this->createSector( level_min_file_name,
-                        level_til_file_name,
-                        "/levels/towndata/sector3s.dun",
-                        level_squares );
-
-  // Create the right sector
-  LevelSector* right_sector =
-    this->createSector( level_min_file_name,
-                        level_til_file_name,
-                        "/levels/towndata/sector2s.dun",
-                        level_squares );
-
-  // Create the bottom sector
-  LevelSector* bottom_sector =
-    this->createSector( level_min_file_name,
-                        level_til_file_name,
-                        "/levels/towndata/sector1s.dun",
-                        level_squares );
+  int sectors[4];
+
+  for( int i = 0; i < 4; ++i )
+  {
+    sectors[i] = blob->findSector( s_sector_dun_file_names[i] );
+
+    if( sectors[i] < 0 )
+    {
+      qFatal( "Town Error: Sector %s is not in the baked town!",
+              s_sector_dun_file_names[i] );
+    }
+  }
+
+  // Create the town grid - the sector tile offsets are the ones used by the
+  // original game (the origin is set once the sectors have been positioned)
+  LevelGrid town_grid( s_grid_size, s_grid_size );
+
+  town_grid.paste( blob->createLevelGrid( sectors[0] ), 0, 0 );
+  town_grid.paste( blob->createLevelGrid( sectors[1] ), 0, 46 );
+  town_grid.paste( blob->createLevelGrid( sectors[2] ), 46, 0 );
+  town_grid.paste( blob->createLevelGrid( sectors[3] ), 46, 46 );
+
+  background.blob = blob;
+  background.grid = town_grid;
+}
+
+// Create the background sectors
+/*! \details This is called on the GUI thread (the level squares and sectors
+ * are graphics objects). The level squares are created once from the blob
+ * and the sectors are cloned from them.
+ */
+void Town::createBackgroundSectors( Background& background ) const
+{
+  const LevelBlob& blob = *background.blob;
+
+  const QList<std::shared_ptr<LevelSquare> > level_squares =
+    blob.createLevelSquares();
+
+  LevelSector* sectors[4];
+
+  for( int i = 0; i < 4; ++i )
+  {
+    sectors[i] = blob.createLevelSector(
+                           blob.findSector( s_sector_dun_file_names[i] ),
+                           level_squares );
+  }
+
+  LevelSector* top_sector = sectors[0];
+  LevelSector* left_sector = sectors[1];
+  LevelSector* right_sector = sectors[2];
+  LevelSector* bottom_sector = sectors[3];
 
   // Resize the town bounding rect
   int town_width = left_sector->boundingRect().width()+
     right_sector->boundingRect().width();
   int town_height = top_sector->boundingRect().height()+
     bottom_sector->boundingRect().height();
-  
-  this->setSceneRect( 0, 0, town_width, town_height );                      
 
-  // Add the sectors to the town
-  this->addItem( top_sector );
-  this->addItem( left_sector );
-  this->addItem( right_sector );
-  this->addItem( bottom_sector );
+  background.scene_rect = QRectF( 0, 0, town_width, town_height );
 
   // Reposition the sectors
   top_sector->setPos( (town_width - top_sector->boundingRect().width())/2, 0 );
@@ -124,23 +193,19 @@ void Town::createSectors( QList<LevelSector*>& sectors )
                          top_sector->boundingRect().height() - 224 );
 
   // Add the sectors to the list
-  sectors.clear();
+  background.sectors.clear();
 
-  sectors << top_sector << left_sector << right_sector << bottom_sector;
-}
+  background.sectors << top_sector << left_sector << right_sector
+                     << bottom_sector;
 
-// Create a sector
-LevelSector* Town::createSector(
-                    const QString& level_min_file_name,
-                    const QString& level_til_file_name,
-                    const QString& level_dun_file_name,
-                    const QList<std::shared_ptr<LevelSquare> >& level_squares )
-{
-  LevelSectorFactory sector_factory( level_min_file_name,
-                                     level_til_file_name,
-                                     level_dun_file_name );
+  // The top corner of the first tile is at the top of the floor diamond of
+  // the first pillar in the top sector (pillar height = square height - 32)
+  int pillar_height = level_squares.front()->boundingRect().height() - 32;
 
-  return sector_factory.createLevelSector( level_squares );
+  background.grid.setOrigin( top_sector->pos() +
+                             QPointF( top_sector->boundingRect().width()/2,
+                                      pillar_height -
+                                      LevelGrid::s_tile_height ) );
 }
 
 } // end QtD1 namespace
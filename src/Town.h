@@ -11,6 +11,8 @@
 
 // QtD1 Includes
 #include "Level.h"
+#include "LevelBlob.h"
+#include "LevelBlobBaker.h"
 
 namespace QtD1{
 
@@ -37,6 +39,9 @@ public:
   //! Get the image asset name
   QString getImageAssetName() const override;
 
+  //! Get the sound sources that should be preloaded
+  QStringList getSoundSources() const override;
+
   //! Insert the character
   void insertCharacter( Character* character,
                         const QPointF& location,
@@ -45,17 +50,25 @@ public:
   //! Remove the character
   void removeCharacter() override;
 
+  //! Create the town level blob baker
+  static LevelBlobBaker createLevelBlobBaker();
+
 private:
 
-  // Create the level sectors
-  void createSectors( QList<LevelSector*>& sectors ) override;
+  // Get the background data loader
+  BackgroundDataLoader getBackgroundDataLoader() const override;
+
+  // Load the background data (called off the GUI thread)
+  static void loadBackgroundData( Background& background );
+
+  // Create the background sectors (called on the GUI thread)
+  void createBackgroundSectors( Background& background ) const override;
+
+  // The top, left, right and bottom sector dun file names
+  static const char* s_sector_dun_file_names[4];
 
-  // Create a sector
-  static LevelSector* createSector(
-                   const QString& level_min_file_name,
-                   const QString& level_til_file_name,
-                   const QString& level_dun_file_name,
-                   const QList<std::shared_ptr<LevelSquare> >& level_squares );
+  // The number of tile rows and columns in the town grid
+  static const int s_grid_size = 96;
 };
   
 } // end QtD1 namespace
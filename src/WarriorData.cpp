@@ -115,6 +115,13 @@ void WarriorData::handleMagicChange( int, int )
 }
 
 void WarriorData::handleLevelUp( const int )
+{
+  this->calculateBaseStats();
+
+  this->updateStats();
+}
+
+void WarriorData::calculateBaseStats()
 {
   this->calculateBaseChanceToHitWithMelee();
   this->calculateBaseChanceToHitWithRanged();
@@ -122,8 +129,6 @@ void WarriorData::handleLevelUp( const int )
   this->calculateBaseDamage();
   this->calculateBaseHealth();
   this->calculateBaseMana();
-
-  this->updateStats();
 }
 
 void WarriorData::connectStatChangeSignalToWarriorDataSlots()
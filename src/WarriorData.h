@@ -63,6 +63,11 @@ public:
   //! Get the base percent chance to hit with spell
   qreal getBaseChanceToHitWithSpell() const override;
 
+protected:
+
+  //! Calculate the base stats that depend on the level and the total stats
+  void calculateBaseStats() override;
+
 private slots:
 
   void handleStrengthChange( int total_strength );
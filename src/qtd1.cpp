@@ -15,6 +15,7 @@
 
 // QtD1 Includes
 #include "MainWindow.h"
+#include "StartupProfiler.h"
 
 // Import custom plugins
 Q_IMPORT_PLUGIN(pcx)
@@ -23,13 +24,28 @@ Q_IMPORT_PLUGIN(cel)
 //! The qtd1 main using a qml front-end
 int main( int argc, char** argv )
 {
+  // Start timing the startup phases
+  QtD1::StartupProfiler::getInstance();
+
   // Create the app instance
   QApplication app( argc, argv );
 
   // Create the main window
-  QtD1::MainWindow* window = QtD1::MainWindow::getInstance();
+  QtD1::MainWindow* window;
+
+  {
+    QtD1::StartupProfiler::ScopedPhase phase( "Create main window" );
+
+    window = QtD1::MainWindow::getInstance();
+  }
+
   window->loadWidgets();
-  window->customShow();
+
+  {
+    QtD1::StartupProfiler::ScopedPhase phase( "Show main window" );
+
+    window->customShow();
+  }
 
   app.setQuitOnLastWindowClosed(true);
   
@@ -37,6 +53,9 @@ int main( int argc, char** argv )
   if( argc == 1 )
   {
     window->gotoTitleScreen();
+
+    // Compile the menus while the title screen is shown
+    window->precompileWidgets();
   }
 
   // Load a tool ui
@@ -49,12 +68,20 @@ int main( int argc, char** argv )
     {
       window->gotoImageViewer();
     }
+    // Report the startup phase times
+    else if( tool_command == "--profile-startup" )
+    {
+      window->gotoTitleScreen();
+
+      QtD1::StartupProfiler::getInstance()->printReport( std::cout );
+    }
     // Print a help message
     else if( tool_command == "-h" || tool_command == "--help" )
     {
       std::cout << "Allowed options: \n"
-                << " -h,--help    display this help message \n"
-                << " --viewer     open the image viewer"
+                << " -h,--help          display this help message \n"
+                << " --viewer           open the image viewer \n"
+                << " --profile-startup  report the startup phase times"
                 << std::endl;
       return 0;
     }
@@ -0,0 +1,77 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   qtd1_level_baker.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  qtd1 level baker (generates the baked level blobs)
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+
+// Qt Includes
+#include <QtGui/QApplication>
+#include <QtPlugin>
+
+// QtD1 Includes
+#include "MPQHandler.h"
+#include "Town.h"
+#include "LevelBlob.h"
+
+// Import custom plugins
+Q_IMPORT_PLUGIN(pcx)
+Q_IMPORT_PLUGIN(cel)
+
+//! The qtd1 level baker main
+int main( int argc, char** argv )
+{
+  // The level objects require a gui application (no windows are shown)
+  QApplication app( argc, argv, false );
+
+  QString output_directory = QtD1::LevelBlob::getBakedLevelsDirectory();
+
+  if( argc == 2 )
+  {
+    QString argument( argv[1] );
+
+    if( argument == "-h" || argument == "--help" )
+    {
+      std::cout << "Usage: qtd1_level_baker [output directory] \n"
+                << " The default output directory is "
+                << output_directory.toStdString()
+                << std::endl;
+      return 0;
+    }
+    else
+      output_directory = argument;
+  }
+  else if( argc > 2 )
+  {
+    std::cerr << "Unknown command line options!" << std::endl;
+    return 1;
+  }
+
+  // Register the MPQHandler with the file engine system
+  QtD1::MPQHandler::getInstance();
+
+  // Bake the town
+  const QString town_file_name = output_directory + "/town.qd1l";
+
+  const QByteArray town_blob = QtD1::Town::createLevelBlobBaker().bake();
+
+  if( !QtD1::LevelBlobBaker::write( town_blob, town_file_name ) )
+  {
+    std::cerr << "Unable to write " << town_file_name.toStdString() << "!"
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << town_file_name.toStdString() << ": " << town_blob.size()
+            << " bytes" << std::endl;
+
+  return 0;
+}
+
+//---------------------------------------------------------------------------//
+// end qtd1_level_baker.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,159 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstActorSpriteTable.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The actor sprite table unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+
+// QtD1 Includes
+#include "ActorSpriteTable.h"
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestActorSpriteTable : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the table can be constructed
+void constructor()
+{
+  QtD1::ActorSpriteTable sprite_table( 10 );
+
+  QCOMPARE( sprite_table.getNumberOfSpriteSets(), 10 );
+  QCOMPARE( sprite_table.getNumberOfStoredSprites(), 0 );
+
+  QVERIFY( sprite_table.getSprite( 9, QtD1::Actor::Dead,
+                                   QtD1::SouthSoutheast ) == NULL );
+  QCOMPARE( sprite_table.getSpriteId( 0, QtD1::Actor::Standing,
+                                      QtD1::South ),
+            QtD1::ActorSpriteTable::s_no_sprite );
+}
+
+//---------------------------------------------------------------------------//
+// Check that sprites are only stored once per source asset
+void createStoredSprites()
+{
+  QtD1::ActorSpriteTable sprite_table;
+
+  QCOMPARE( sprite_table.findStoredSprites( "/plrgfx/warrior/wln/wlnas.cl2" ),
+            QtD1::ActorSpriteTable::s_no_sprite );
+
+  QCOMPARE( sprite_table.createStoredSprites( "/plrgfx/warrior/wln/wlnas.cl2", 8 ),
+            0 );
+  QCOMPARE( sprite_table.createStoredSprites( "/plrgfx/warrior/wln/wlnaw.cl2", 8 ),
+            8 );
+  QCOMPARE( sprite_table.createStoredSprites( "/plrgfx/warrior/wln/wlnas.cl2", 8 ),
+            0 );
+
+  QCOMPARE( sprite_table.getNumberOfStoredSprites(), 16 );
+  QCOMPARE( sprite_table.findStoredSprites( "/plrgfx/warrior/wln/wlnaw.cl2" ),
+            8 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that stored sprites can be assigned to slots
+void assignSprite()
+{
+  QtD1::ActorSpriteTable sprite_table( 4 );
+
+  const int sprite_id =
+    sprite_table.createStoredSprites( "/plrgfx/warrior/wln/wlnas.cl2", 8 );
+
+  // Several slots can share a stored sprite
+  sprite_table.assignSprite( 1, QtD1::Actor::Walking, QtD1::West, sprite_id+2 );
+  sprite_table.assignSprite( 3, QtD1::Actor::Walking, QtD1::West, sprite_id+2 );
+
+  QCOMPARE( sprite_table.getSpriteId( 1, QtD1::Actor::Walking, QtD1::West ),
+            sprite_id+2 );
+  QVERIFY( sprite_table.getSprite( 1, QtD1::Actor::Walking, QtD1::West ) ==
+           &sprite_table.getStoredSprite( sprite_id+2 ) );
+  QVERIFY( sprite_table.getSprite( 3, QtD1::Actor::Walking, QtD1::West ) ==
+           sprite_table.getSprite( 1, QtD1::Actor::Walking, QtD1::West ) );
+
+  QVERIFY( sprite_table.getSprite( 2, QtD1::Actor::Walking, QtD1::West ) ==
+           NULL );
+  QVERIFY( sprite_table.getSprite( 1, QtD1::Actor::Standing, QtD1::West ) ==
+           NULL );
+  QVERIFY( sprite_table.getSprite( 1, QtD1::Actor::Walking, QtD1::East ) ==
+           NULL );
+
+  // The stored sprite addresses are stable
+  const QtD1::GameSprite* sprite =
+    sprite_table.getSprite( 1, QtD1::Actor::Walking, QtD1::West );
+
+  for( int i = 0; i < 100; ++i )
+    sprite_table.createStoredSprites( QString::number( i ), 8 );
+
+  QVERIFY( sprite_table.getSprite( 1, QtD1::Actor::Walking, QtD1::West ) ==
+           sprite );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the assets of a single source asset can be dumped
+void dumpAssets()
+{
+  QtD1::ActorSpriteTable sprite_table;
+
+  QVector<QPixmap> frames( 2, QPixmap( 4, 4 ) );
+  QVector<int> frame_indices( 1, 0 );
+
+  const int first_sprite_id =
+    sprite_table.createStoredSprites( "/plrgfx/warrior/wln/wlnas.cl2", 2 );
+  const int second_sprite_id =
+    sprite_table.createStoredSprites( "/plrgfx/warrior/wln/wlnaw.cl2", 2 );
+
+  for( int i = 0; i < 4; ++i )
+  {
+    QtD1::GameSprite& sprite = sprite_table.getStoredSprite( i );
+
+    sprite = QtD1::GameSprite( i < 2 ? "/plrgfx/warrior/wln/wlnas.cl2" :
+                               "/plrgfx/warrior/wln/wlnaw.cl2",
+                               frame_indices );
+    sprite.setAsset( i < 2 ? "/plrgfx/warrior/wln/wlnas.cl2" :
+                     "/plrgfx/warrior/wln/wlnaw.cl2",
+                     frames );
+
+    QVERIFY( sprite.isReady() );
+  }
+
+  sprite_table.dumpAssets( "/plrgfx/warrior/wln/wlnas.cl2" );
+
+  QVERIFY( !sprite_table.getStoredSprite( first_sprite_id ).isReady() );
+  QVERIFY( !sprite_table.getStoredSprite( first_sprite_id+1 ).isReady() );
+  QVERIFY( sprite_table.getStoredSprite( second_sprite_id ).isReady() );
+  QVERIFY( sprite_table.getStoredSprite( second_sprite_id+1 ).isReady() );
+
+  // The stored sprites are kept so that the source asset can be reloaded
+  QCOMPARE( sprite_table.getNumberOfStoredSprites(), 4 );
+  QCOMPARE( sprite_table.findStoredSprites( "/plrgfx/warrior/wln/wlnas.cl2" ),
+            first_sprite_id );
+
+  sprite_table.dumpAssets();
+
+  QVERIFY( !sprite_table.getStoredSprite( second_sprite_id ).isReady() );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestActorSpriteTable )
+#include "tstActorSpriteTable.moc"
+
+//---------------------------------------------------------------------------//
+// end tstActorSpriteTable.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,218 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstCelPaletteRegistry.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  Cel palette registry unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QtPlugin>
+#include <QImageReader>
+#include <QFile>
+
+// QtD1 Includes
+#include "CelPaletteRegistry.h"
+#include "MPQHandler.h"
+
+// Import custom plugins
+Q_IMPORT_PLUGIN(cel)
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestCelPaletteRegistry : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void initTestCase()
+  {
+    // Register the MPQHandler with the file engine system
+    QtD1::MPQHandler::getInstance();
+  }
+
+  void init()
+  {
+    QtD1::CelPaletteRegistry::getInstance()->clear();
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that palettes are interned
+void getPalette()
+{
+  QtD1::CelPaletteRegistry* registry =
+    QtD1::CelPaletteRegistry::getInstance();
+
+  const int hits = registry->getNumberOfHits();
+  
+  QtD1::CelPaletteRegistry::PaletteHandle palette =
+    registry->getPalette( "/levels/towndata/town.pal" );
+
+  QVERIFY( palette.get() != NULL );
+  QCOMPARE( palette->getName(), QString("levels/towndata/town.pal") );
+  QCOMPARE( registry->getNumberOfPalettes(), 1 );
+
+  // The palette is only parsed once
+  QVERIFY( registry->getPalette( "levels/towndata/town.pal" ) == palette );
+
+  QFile palette_file( "/levels/towndata/town.pal" );
+  palette_file.open( QIODevice::ReadOnly );
+  
+  QVERIFY( registry->getPalette( "levels/towndata/town.pal",
+                                 palette_file.readAll() ) == palette );
+  QCOMPARE( registry->getNumberOfPalettes(), 1 );
+  QCOMPARE( registry->getNumberOfHits(), hits+2 );
+
+  // Palettes in use stay valid after they are released
+  registry->clear();
+
+  QCOMPARE( registry->getNumberOfPalettes(), 0 );
+  QCOMPARE( palette->getName(), QString("levels/towndata/town.pal") );
+  QVERIFY( registry->getPalette( "levels/towndata/town.pal" ) != palette );
+}
+
+//---------------------------------------------------------------------------//
+// Check that translated palettes are interned
+void getTranslatedPalette()
+{
+  QtD1::CelPaletteRegistry* registry =
+    QtD1::CelPaletteRegistry::getInstance();
+
+  QtD1::CelPaletteRegistry::PaletteHandle palette =
+    registry->getTranslatedPalette( "levels/towndata/town.pal",
+                                    "monsters/acid/acidb.trn" );
+
+  QVERIFY( palette.get() != NULL );
+  QCOMPARE( palette->getName(), QString("levels/towndata/town.pal") );
+
+  // The base palette is interned too
+  QCOMPARE( registry->getNumberOfPalettes(), 2 );
+  QVERIFY( registry->getTranslatedPalette( "/levels/towndata/town.pal",
+                                           "/monsters/acid/acidb.trn" ) ==
+           palette );
+
+  // Check the translation
+  QFile translation_file( "/monsters/acid/acidb.trn" );
+  translation_file.open( QIODevice::ReadOnly );
+
+  QByteArray translation_data = translation_file.readAll();
+
+  QtD1::CelPaletteRegistry::PaletteHandle base_palette =
+    registry->getPalette( "levels/towndata/town.pal" );
+
+  for( int i = 0; i < 256; ++i )
+  {
+    if( i == base_palette->getTransparentColorKey() )
+      QCOMPARE( palette->getRgba( i ), base_palette->getRgba( i ) );
+    else
+    {
+      QCOMPARE( palette->getRgba( i ),
+                base_palette->getRgba( (quint8)translation_data[i] ) );
+    }
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that gamma corrected palettes are interned
+void getGammaCorrectedPalette()
+{
+  QtD1::CelPaletteRegistry* registry =
+    QtD1::CelPaletteRegistry::getInstance();
+
+  QtD1::CelPaletteRegistry::PaletteHandle base_palette =
+    registry->getPalette( "levels/towndata/town.pal" );
+
+  // No correction
+  QtD1::CelPaletteRegistry::PaletteHandle palette =
+    registry->getGammaCorrectedPalette( "levels/towndata/town.pal", 1.0 );
+
+  QVERIFY( palette != base_palette );
+  QVERIFY( palette->toColorTable() == base_palette->toColorTable() );
+
+  // Darker
+  palette =
+    registry->getGammaCorrectedPalette( "levels/towndata/town.pal", 2.0 );
+
+  QCOMPARE( registry->getNumberOfPalettes(), 3 );
+  QVERIFY( registry->getGammaCorrectedPalette( "levels/towndata/town.pal",
+                                               2.0 ) == palette );
+
+  for( int i = 0; i < 256; ++i )
+  {
+    if( i == base_palette->getTransparentColorKey() )
+      QCOMPARE( palette->getRgba( i ), base_palette->getRgba( i ) );
+    else
+    {
+      QVERIFY( palette->getColor( i ).red() <=
+               base_palette->getColor( i ).red() );
+      QVERIFY( palette->getColor( i ).green() <=
+               base_palette->getColor( i ).green() );
+      QVERIFY( palette->getColor( i ).blue() <=
+               base_palette->getColor( i ).blue() );
+    }
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that decoded frames share the color table of the palette
+void decode()
+{
+  QtD1::CelPaletteRegistry* registry =
+    QtD1::CelPaletteRegistry::getInstance();
+
+  QImageReader first_reader( "/data/PentSpin.cel+levels/towndata/town.pal" );
+  QImage first_frame = first_reader.read();
+
+  QImageReader second_reader( "/data/inv/objcurs.cel+levels/towndata/town.pal" );
+  QImage second_frame = second_reader.read();
+
+  QVERIFY( !first_frame.isNull() );
+  QVERIFY( !second_frame.isNull() );
+  QCOMPARE( registry->getNumberOfPalettes(), 1 );
+
+  QtD1::CelPaletteRegistry::PaletteHandle palette =
+    registry->getPalette( "levels/towndata/town.pal" );
+
+  QVERIFY( first_frame.colorTable().constData() ==
+           palette->toColorTable().constData() );
+  QVERIFY( second_frame.colorTable().constData() ==
+           palette->toColorTable().constData() );
+}
+
+//---------------------------------------------------------------------------//
+// Check the palette lookup latency
+void getPalette_benchmark()
+{
+  QtD1::CelPaletteRegistry* registry =
+    QtD1::CelPaletteRegistry::getInstance();
+
+  registry->getPalette( "levels/towndata/town.pal" );
+
+  QBENCHMARK{
+    registry->getPalette( "levels/towndata/town.pal" );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestCelPaletteRegistry )
+#include "tstCelPaletteRegistry.moc"
+
+//---------------------------------------------------------------------------//
+// end tstCelPaletteRegistry.cpp
+//---------------------------------------------------------------------------//
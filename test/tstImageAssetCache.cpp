@@ -0,0 +1,182 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstImageAssetCache.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  Image asset cache unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QtPlugin>
+
+// QtD1 Includes
+#include "ImageAssetCache.h"
+#include "MPQHandler.h"
+
+// Import custom plugins
+Q_IMPORT_PLUGIN(pcx)
+Q_IMPORT_PLUGIN(cel)
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestImageAssetCache : public QObject
+{
+  Q_OBJECT
+
+private:
+
+  // Create a test asset
+  QtD1::ImageAssetCache::Asset createAsset( const int num_frames )
+  {
+    QtD1::ImageAssetCache::Asset asset( num_frames );
+
+    for( int i = 0; i < num_frames; ++i )
+    {
+      asset[i] = QImage( 16, 16, QImage::Format_ARGB32 );
+      asset[i].fill( 0 );
+    }
+
+    return asset;
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    // Register the MPQHandler with the file engine system
+    QtD1::MPQHandler::getInstance();
+  }
+
+  void init()
+  {
+    QtD1::ImageAssetCache* cache = QtD1::ImageAssetCache::getInstance();
+
+    cache->clear();
+    cache->setMemoryBudget( QtD1::ImageAssetCache::s_default_memory_budget );
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that an inserted asset can be found
+void insert_find()
+{
+  QtD1::ImageAssetCache* cache = QtD1::ImageAssetCache::getInstance();
+
+  const int hits = cache->getNumberOfHits();
+  const int misses = cache->getNumberOfMisses();
+
+  QVERIFY( !cache->find( "insert_find" ) );
+  QCOMPARE( cache->getNumberOfMisses(), misses+1 );
+
+  QtD1::ImageAssetCache::AssetHandle inserted_asset =
+    cache->insert( "insert_find", this->createAsset( 2 ) );
+
+  QVERIFY( cache->isResident( "insert_find" ) );
+  QCOMPARE( cache->getMemoryUsage(), (qint64)2*16*16*4 );
+
+  QtD1::ImageAssetCache::AssetHandle found_asset =
+    cache->find( "insert_find" );
+
+  QVERIFY( found_asset.get() == inserted_asset.get() );
+  QCOMPARE( cache->getNumberOfHits(), hits+1 );
+
+  // A resident asset is never replaced
+  QtD1::ImageAssetCache::AssetHandle reinserted_asset =
+    cache->insert( "insert_find", this->createAsset( 4 ) );
+
+  QVERIFY( reinserted_asset.get() == inserted_asset.get() );
+  QCOMPARE( reinserted_asset->size(), 2 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the least recently used assets are released
+void setMemoryBudget()
+{
+  QtD1::ImageAssetCache* cache = QtD1::ImageAssetCache::getInstance();
+
+  const qint64 asset_bytes =
+    QtD1::ImageAssetCache::getAssetBytes( this->createAsset( 1 ) );
+
+  cache->setMemoryBudget( 2*asset_bytes );
+
+  QtD1::ImageAssetCache::AssetHandle held_asset =
+    cache->insert( "held", this->createAsset( 1 ) );
+
+  cache->insert( "first", this->createAsset( 1 ) );
+  cache->insert( "second", this->createAsset( 1 ) );
+
+  // The held asset was released by the cache but it is still in use
+  QCOMPARE( cache->getNumberOfRetainedAssets(), 2 );
+  QCOMPARE( cache->getMemoryUsage(), 2*asset_bytes );
+  QVERIFY( cache->isResident( "held" ) );
+  QVERIFY( cache->isResident( "first" ) );
+  QVERIFY( cache->isResident( "second" ) );
+
+  // Finding the held asset retains it again (first is released)
+  QVERIFY( cache->find( "held" ).get() == held_asset.get() );
+  QVERIFY( !cache->isResident( "first" ) );
+  QVERIFY( cache->isResident( "second" ) );
+
+  // The cache always retains the most recently used asset
+  cache->setMemoryBudget( 0 );
+
+  QCOMPARE( cache->getNumberOfRetainedAssets(), 1 );
+  QVERIFY( cache->isResident( "held" ) );
+  QVERIFY( !cache->isResident( "second" ) );
+
+  // The released assets that are no longer in use are forgotten
+  QCOMPARE( cache->getNumberOfResidentAssets(), 1 );
+
+  // Nothing is resident once all handles are released
+  held_asset.reset();
+  cache->clear();
+
+  QVERIFY( !cache->isResident( "held" ) );
+  QCOMPARE( cache->getMemoryUsage(), (qint64)0 );
+  QCOMPARE( cache->getNumberOfResidentAssets(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that an asset is only decoded once
+void load()
+{
+  QtD1::ImageAssetCache* cache = QtD1::ImageAssetCache::getInstance();
+
+  const int hits = cache->getNumberOfHits();
+  const int misses = cache->getNumberOfMisses();
+
+  QtD1::ImageAssetCache::AssetHandle asset =
+    cache->load( "/data/PentSpin.cel+levels/towndata/town.pal" );
+
+  QCOMPARE( asset->size(), 8 );
+  QCOMPARE( cache->getNumberOfMisses(), misses+1 );
+
+  QtD1::ImageAssetCache::AssetHandle cached_asset =
+    cache->load( "/data/PentSpin.cel+levels/towndata/town.pal" );
+
+  QVERIFY( cached_asset.get() == asset.get() );
+  QCOMPARE( cache->getNumberOfHits(), hits+1 );
+  QCOMPARE( cache->getNumberOfMisses(), misses+1 );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestImageAssetCache )
+#include "tstImageAssetCache.moc"
+
+//---------------------------------------------------------------------------//
+// end tstImageAssetCache.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,239 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstLevel.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+
+// Qt Includes
+#include <QtTest/QtTest>
+
+// QtD1 Includes
+#include "Level.h"
+#include "LevelObject.h"
+
+//---------------------------------------------------------------------------//
+// Testing Structures
+//---------------------------------------------------------------------------//
+// A level object that counts the number of times that it is advanced
+class CountingLevelObject : public QtD1::LevelObject
+{
+
+public:
+
+  CountingLevelObject( const bool animated )
+    : QtD1::LevelObject(),
+      d_animated( animated ),
+      d_number_of_advances( 0 )
+  { /* ... */ }
+
+  ~CountingLevelObject()
+  { /* ... */ }
+
+  int getNumberOfImageAssets() const override
+  { return 0; }
+
+  void getImageAssetNames( QSet<QString>& ) const override
+  { /* ... */ }
+
+  bool isImageAssetUsed( const QString& ) const override
+  { return false; }
+
+  bool imageAssetsLoaded() const override
+  { return true; }
+
+  void loadImageAsset( const QString&, const QVector<QPixmap>& ) override
+  { /* ... */ }
+
+  void dumpImageAssets() override
+  { /* ... */ }
+
+  QRectF boundingRect() const override
+  { return QRectF( 0, 0, 32, 32 ); }
+
+  void paint( QPainter*, const QStyleOptionGraphicsItem*, QWidget* ) override
+  { /* ... */ }
+
+  bool isAnimated() const override
+  { return d_animated; }
+
+  // Count the completed advances (the second phase)
+  void advance( int phase ) override
+  {
+    if( phase == 1 )
+      ++d_number_of_advances;
+  }
+
+  // Start or stop requiring simulation ticks
+  void setAnimated( const bool animated )
+  {
+    if( animated != d_animated )
+    {
+      d_animated = animated;
+
+      emit animationStateChanged( animated );
+    }
+  }
+
+  int getNumberOfAdvances() const
+  { return d_number_of_advances; }
+
+private:
+
+  bool d_animated;
+  int d_number_of_advances;
+};
+
+// A level without a background
+class EmptyLevel : public QtD1::Level
+{
+
+public:
+
+  EmptyLevel()
+    : QtD1::Level( 0 )
+  { /* ... */ }
+
+  ~EmptyLevel()
+  { /* ... */ }
+
+  Type getType() const override
+  { return QtD1::Level::Town; }
+
+  int getNumber() const override
+  { return 0; }
+
+  QString getImageAssetName() const override
+  { return QString(); }
+
+protected:
+
+  BackgroundDataLoader getBackgroundDataLoader() const override
+  { return &EmptyLevel::loadBackgroundData; }
+
+  void createBackgroundSectors( Background& ) const override
+  { /* ... */ }
+
+private:
+
+  static void loadBackgroundData( Background& )
+  { /* ... */ }
+};
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestLevel : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that only the animated level objects are registered when added
+void addLevelObject()
+{
+  EmptyLevel level;
+
+  CountingLevelObject* static_object = new CountingLevelObject( false );
+  CountingLevelObject* animated_object = new CountingLevelObject( true );
+
+  level.addLevelObject( static_object, QPointF( 0, 0 ) );
+  level.addLevelObject( animated_object, QPointF( 64, 0 ) );
+
+  QVERIFY( !level.isAnimatedObjectRegistered( static_object ) );
+  QVERIFY( level.isAnimatedObjectRegistered( animated_object ) );
+  QCOMPARE( level.getNumberOfAnimatedObjects(), 1 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only the registered level objects are advanced
+void advanceTick()
+{
+  EmptyLevel level;
+
+  CountingLevelObject* static_object = new CountingLevelObject( false );
+  CountingLevelObject* animated_object = new CountingLevelObject( true );
+
+  level.addLevelObject( static_object, QPointF( 0, 0 ) );
+  level.addLevelObject( animated_object, QPointF( 64, 0 ) );
+
+  level.advanceTick();
+  level.advanceTick();
+
+  QCOMPARE( static_object->getNumberOfAdvances(), 0 );
+  QCOMPARE( animated_object->getNumberOfAdvances(), 2 );
+
+  // Explicitly registered objects are advanced until they are unregistered
+  level.registerAnimatedObject( static_object );
+  level.registerAnimatedObject( static_object );
+
+  QCOMPARE( level.getNumberOfAnimatedObjects(), 2 );
+
+  level.advanceTick();
+
+  QCOMPARE( static_object->getNumberOfAdvances(), 1 );
+  QCOMPARE( animated_object->getNumberOfAdvances(), 3 );
+
+  level.unregisterAnimatedObject( static_object );
+
+  level.advanceTick();
+
+  QCOMPARE( static_object->getNumberOfAdvances(), 1 );
+  QCOMPARE( animated_object->getNumberOfAdvances(), 4 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that an animation state change updates the active set
+void animationStateChanged()
+{
+  EmptyLevel level;
+
+  CountingLevelObject* level_object = new CountingLevelObject( false );
+
+  level.addLevelObject( level_object, QPointF( 0, 0 ) );
+
+  level.advanceTick();
+
+  QCOMPARE( level_object->getNumberOfAdvances(), 0 );
+
+  // The object starts animating
+  level_object->setAnimated( true );
+
+  QVERIFY( level.isAnimatedObjectRegistered( level_object ) );
+
+  level.advanceTick();
+
+  QCOMPARE( level_object->getNumberOfAdvances(), 1 );
+
+  // The object stops animating
+  level_object->setAnimated( false );
+
+  QVERIFY( !level.isAnimatedObjectRegistered( level_object ) );
+  QCOMPARE( level.getNumberOfAnimatedObjects(), 0 );
+
+  level.advanceTick();
+
+  QCOMPARE( level_object->getNumberOfAdvances(), 1 );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestLevel )
+#include "tstLevel.moc"
+
+//---------------------------------------------------------------------------//
+// end tstLevel.cpp
+//---------------------------------------------------------------------------//
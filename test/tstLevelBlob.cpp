@@ -0,0 +1,315 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstLevelBlob.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level blob unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QtPlugin>
+
+// QtD1 Includes
+#include "LevelBlob.h"
+#include "LevelBlobBaker.h"
+#include "LevelSectorFactory.h"
+#include "LevelPillarFactory.h"
+#include "LevelSquareFactory.h"
+#include "MPQHandler.h"
+
+// Import custom plugins
+Q_IMPORT_PLUGIN(cel)
+Q_IMPORT_PLUGIN(pcx)
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestLevelBlob : public QObject
+{
+  Q_OBJECT
+
+private:
+
+  // The baked town blob
+  QByteArray t_blob_data;
+
+private slots:
+
+  void initTestCase()
+  {
+    // Register the MPQHandler with the file engine system
+    QtD1::MPQHandler::getInstance();
+
+    QtD1::LevelBlobBaker baker( "/levels/towndata/town.min",
+                                "/levels/towndata/town.til",
+                                "/levels/towndata/town.sol" );
+    baker.addSector( "/levels/towndata/sector1s.dun" );
+    baker.addSector( "/levels/towndata/sector2s.dun" );
+
+    t_blob_data = baker.bake();
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that a baked blob can be opened
+void open()
+{
+  QtD1::LevelBlob blob;
+
+  QVERIFY( !blob.isOpen() );
+  QVERIFY( blob.open( t_blob_data ) );
+  QVERIFY( blob.isOpen() );
+
+  QCOMPARE( blob.getLevelMinFileName(),
+            QString( "/levels/towndata/town.min" ) );
+  QCOMPARE( blob.getNumberOfSectors(), 2 );
+  QCOMPARE( blob.findSector( "/levels/towndata/sector1s.dun" ), 0 );
+  QCOMPARE( blob.findSector( "/levels/towndata/sector2s.dun" ), 1 );
+  QCOMPARE( blob.findSector( "/levels/towndata/sector3s.dun" ), -1 );
+
+  blob.close();
+
+  QVERIFY( !blob.isOpen() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a baked blob file can be memory mapped
+void open_file()
+{
+  const QString file_name = QDir::temp().filePath( "tstLevelBlob.qd1l" );
+
+  QVERIFY( QtD1::LevelBlobBaker::write( t_blob_data, file_name ) );
+
+  {
+    QtD1::LevelBlob blob;
+
+    QVERIFY( blob.open( file_name ) );
+    QCOMPARE( blob.getNumberOfSectors(), 2 );
+  }
+
+  QVERIFY( QFile::remove( file_name ) );
+
+  QtD1::LevelBlob blob;
+
+  QVERIFY( !blob.open( file_name ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that invalid blobs are rejected
+void open_invalid()
+{
+  QtD1::LevelBlob blob;
+
+  QVERIFY( !blob.open( QByteArray() ) );
+
+  // Truncated
+  QVERIFY( !blob.open( t_blob_data.left( t_blob_data.size()/2 ) ) );
+
+  // Bad magic number
+  QByteArray bad_data = t_blob_data;
+  bad_data[QtD1::LevelBlob::MagicField] = 'X';
+
+  QVERIFY( !blob.open( bad_data ) );
+
+  // Bad version
+  bad_data = t_blob_data;
+  bad_data[QtD1::LevelBlob::VersionField] = 0x7F;
+
+  QVERIFY( !blob.open( bad_data ) );
+  QVERIFY( !blob.isOpen() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the checksum of the level files is stored in the blob
+void getSourceChecksum()
+{
+  QtD1::LevelBlobBaker baker( "/levels/towndata/town.min",
+                              "/levels/towndata/town.til",
+                              "/levels/towndata/town.sol" );
+  baker.addSector( "/levels/towndata/sector1s.dun" );
+  baker.addSector( "/levels/towndata/sector2s.dun" );
+
+  QtD1::LevelBlob blob;
+
+  QVERIFY( blob.open( t_blob_data ) );
+  QCOMPARE( blob.getSourceChecksum().size(),
+            QtD1::LevelBlob::s_source_checksum_length );
+  QCOMPARE( blob.getSourceChecksum(), baker.calculateSourceChecksum() );
+
+  // A blob baked from other level files is stale
+  baker.addSector( "/levels/towndata/sector3s.dun" );
+
+  QVERIFY( blob.getSourceChecksum() != baker.calculateSourceChecksum() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the pillar and square tables match the level files
+void tables()
+{
+  QtD1::LevelBlob blob;
+  blob.open( t_blob_data );
+
+  QtD1::LevelPillarFactory pillar_factory( "/levels/towndata/town.min" );
+
+  QCOMPARE( blob.getNumberOfPillars(),
+            pillar_factory.createLevelPillars().size() );
+  QCOMPARE( blob.getBlocksPerPillar(),
+            pillar_factory.getNumberOfBlocksPerPillar() );
+
+  QtD1::LevelSquareFactory square_factory( "/levels/towndata/town.min",
+                                           "/levels/towndata/town.til" );
+
+  QCOMPARE( blob.getNumberOfSquares(),
+            square_factory.createLevelSquares().size() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the sector grid matches the grid parsed from the level files
+void createLevelGrid()
+{
+  QtD1::LevelBlob blob;
+  blob.open( t_blob_data );
+
+  QtD1::LevelSectorFactory sector_factory( "/levels/towndata/town.min",
+                                           "/levels/towndata/town.til",
+                                           "/levels/towndata/sector1s.dun" );
+
+  QtD1::LevelGrid grid =
+    sector_factory.createLevelGrid( "/levels/towndata/town.sol" );
+
+  QtD1::LevelGrid baked_grid = blob.createLevelGrid( 0 );
+
+  QCOMPARE( baked_grid.getWidth(), grid.getWidth() );
+  QCOMPARE( baked_grid.getHeight(), grid.getHeight() );
+
+  for( int i = 0; i < grid.getNumberOfTiles(); ++i )
+  {
+    QCOMPARE( baked_grid.getRawPillarIds()[i], grid.getRawPillarIds()[i] );
+    QCOMPARE( baked_grid.getRawFlags()[i], grid.getRawFlags()[i] );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that the sector matches the sector parsed from the level files
+void createLevelSector()
+{
+  QtD1::LevelBlob blob;
+  blob.open( t_blob_data );
+
+  QList<std::shared_ptr<QtD1::LevelSquare> > squares =
+    blob.createLevelSquares();
+
+  QtD1::LevelSector* baked_sector = blob.createLevelSector( 0, squares );
+
+  QVERIFY( baked_sector != NULL );
+
+  QtD1::LevelSectorFactory sector_factory( "/levels/towndata/town.min",
+                                           "/levels/towndata/town.til",
+                                           "/levels/towndata/sector1s.dun" );
+
+  QtD1::LevelSector* sector = sector_factory.createLevelSector( squares );
+
+  QCOMPARE( blob.getSectorNumberOfRows( 0 ), 25 );
+  QCOMPARE( blob.getSectorNumberOfColumns( 0 ), 25 );
+  QCOMPARE( baked_sector->boundingRect(), sector->boundingRect() );
+  QCOMPARE( baked_sector->childItems().size(),
+            sector->childItems().size() );
+
+  delete baked_sector;
+  delete sector;
+}
+
+//---------------------------------------------------------------------------//
+// Check that the placements match the placements parsed from the dun file
+void getPlacements()
+{
+  QtD1::LevelBlob blob;
+  blob.open( t_blob_data );
+
+  QtD1::LevelSectorFactory sector_factory( "/levels/towndata/town.min",
+                                           "/levels/towndata/town.til",
+                                           "/levels/towndata/sector1s.dun" );
+
+  QVector<QtD1::LevelSectorFactory::Placement> monsters, objects;
+  sector_factory.readPlacements( monsters, objects );
+
+  QVector<QtD1::LevelSectorFactory::Placement> baked_monsters, baked_objects;
+  blob.getMonsterPlacements( 0, baked_monsters );
+  blob.getObjectPlacements( 0, baked_objects );
+
+  QCOMPARE( baked_monsters.size(), monsters.size() );
+  QCOMPARE( baked_objects.size(), objects.size() );
+
+  for( int i = 0; i < monsters.size(); ++i )
+  {
+    QCOMPARE( baked_monsters[i].x, monsters[i].x );
+    QCOMPARE( baked_monsters[i].y, monsters[i].y );
+    QCOMPARE( baked_monsters[i].id, monsters[i].id );
+  }
+
+  for( int i = 0; i < objects.size(); ++i )
+  {
+    QCOMPARE( baked_objects[i].x, objects[i].x );
+    QCOMPARE( baked_objects[i].y, objects[i].y );
+    QCOMPARE( baked_objects[i].id, objects[i].id );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Compare the sector creation time of the blob and the level files
+void createLevelSector_benchmark_data()
+{
+  QTest::addColumn<bool>( "baked" );
+
+  QTest::newRow( "parsed" ) << false;
+  QTest::newRow( "baked" ) << true;
+}
+
+void createLevelSector_benchmark()
+{
+  QFETCH( bool, baked );
+
+  QBENCHMARK{
+    QtD1::LevelSector* sector;
+
+    if( baked )
+    {
+      QtD1::LevelBlob blob;
+      blob.open( t_blob_data );
+
+      sector = blob.createLevelSector( 0, blob.createLevelSquares() );
+    }
+    else
+    {
+      QtD1::LevelSectorFactory sector_factory(
+                                           "/levels/towndata/town.min",
+                                           "/levels/towndata/town.til",
+                                           "/levels/towndata/sector1s.dun" );
+
+      sector = sector_factory.createLevelSector();
+    }
+
+    delete sector;
+  }
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestLevelBlob )
+#include "tstLevelBlob.moc"
+
+//---------------------------------------------------------------------------//
+// end tstLevelBlob.cpp
+//---------------------------------------------------------------------------//
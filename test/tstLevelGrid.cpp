@@ -0,0 +1,150 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstLevelGrid.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level grid unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+
+// QtD1 Includes
+#include "LevelGrid.h"
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestLevelGrid : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the grid can be constructed
+void constructor()
+{
+  QtD1::LevelGrid empty_grid;
+
+  QVERIFY( empty_grid.isEmpty() );
+
+  QtD1::LevelGrid grid( 10, 20 );
+
+  QCOMPARE( grid.getWidth(), 10 );
+  QCOMPARE( grid.getHeight(), 20 );
+  QCOMPARE( grid.getNumberOfTiles(), 200 );
+  QVERIFY( !grid.isEmpty() );
+
+  QCOMPARE( grid.getPillarId( 3, 4 ), QtD1::LevelGrid::s_no_pillar );
+  QCOMPARE( grid.getObjectId( 3, 4 ), QtD1::LevelGrid::s_no_object );
+  QCOMPARE( grid.getLight( 3, 4 ), (quint8)0 );
+  QVERIFY( !grid.isWalkable( 3, 4 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the tile data can be set
+void setTileData()
+{
+  QtD1::LevelGrid grid( 10, 20 );
+
+  grid.setPillarId( 9, 19, 1234 );
+  grid.setFlags( 9, 19, 0 );
+  grid.setLight( 9, 19, 7 );
+  grid.setObjectId( 9, 19, 5 );
+
+  QCOMPARE( grid.getPillarId( 9, 19 ), (quint16)1234 );
+  QVERIFY( grid.isWalkable( 9, 19 ) );
+  QCOMPARE( grid.getLight( 9, 19 ), (quint8)7 );
+  QCOMPARE( grid.getObjectId( 9, 19 ), (quint16)5 );
+
+  // The data is stored row-major
+  QCOMPARE( grid.getRawPillarIds()[grid.getIndex( 9, 19 )], (quint16)1234 );
+  QCOMPARE( grid.getIndex( 9, 19 ), 199 );
+
+  // Tiles outside of the grid are never walkable
+  QVERIFY( !grid.isInside( 10, 0 ) );
+  QVERIFY( !grid.isWalkable( -1, 0 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that level positions can be mapped to tiles
+void mapToTile()
+{
+  QtD1::LevelGrid grid( 10, 10 );
+  grid.setOrigin( QPointF( 320, 100 ) );
+
+  QCOMPARE( grid.mapToTile( QPointF( 320, 101 ) ), QPoint( 0, 0 ) );
+  QCOMPARE( grid.mapToTile( QPointF( 352, 117 ) ), QPoint( 1, 0 ) );
+  QCOMPARE( grid.mapToTile( QPointF( 288, 117 ) ), QPoint( 0, 1 ) );
+  QCOMPARE( grid.mapToTile( QPointF( 320, 133 ) ), QPoint( 1, 1 ) );
+  QCOMPARE( grid.mapToTile( QPointF( 320, 99 ) ), QPoint( -1, -1 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that tiles can be mapped to level positions
+void mapFromTile()
+{
+  QtD1::LevelGrid grid( 10, 10 );
+  grid.setOrigin( QPointF( 320, 100 ) );
+
+  QCOMPARE( grid.mapFromTile( QPoint( 0, 0 ) ), QPointF( 320, 100 ) );
+  QCOMPARE( grid.mapFromTile( QPoint( 2, 1 ) ), QPointF( 352, 148 ) );
+  QCOMPARE( grid.mapFromTileCenter( QPoint( 2, 1 ) ), QPointF( 352, 164 ) );
+
+  for( int j = 0; j < 10; ++j )
+  {
+    for( int i = 0; i < 10; ++i )
+    {
+      QCOMPARE( grid.mapToTile( grid.mapFromTileCenter( QPoint( i, j ) ) ),
+                QPoint( i, j ) );
+    }
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that a grid can be pasted into another grid
+void paste()
+{
+  QtD1::LevelGrid sector_grid( 4, 4 );
+
+  for( int j = 0; j < 4; ++j )
+  {
+    for( int i = 0; i < 4; ++i )
+    {
+      sector_grid.setPillarId( i, j, j*4 + i );
+      sector_grid.setFlags( i, j, 0 );
+    }
+  }
+
+  // Tiles without a pillar are transparent
+  sector_grid.setPillarId( 0, 0, QtD1::LevelGrid::s_no_pillar );
+
+  QtD1::LevelGrid grid( 6, 6 );
+  grid.setPillarId( 2, 2, 100 );
+
+  grid.paste( sector_grid, 2, 2 );
+
+  QCOMPARE( grid.getPillarId( 2, 2 ), (quint16)100 );
+  QCOMPARE( grid.getPillarId( 3, 2 ), (quint16)1 );
+  QCOMPARE( grid.getPillarId( 5, 5 ), (quint16)15 );
+  QVERIFY( grid.isWalkable( 5, 5 ) );
+  QVERIFY( !grid.isWalkable( 1, 1 ) );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestLevelGrid )
+#include "tstLevelGrid.moc"
+
+//---------------------------------------------------------------------------//
+// end tstLevelGrid.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,469 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstLevelPathfinder.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level pathfinder unit tests and benchmarks
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cstdlib>
+#include <algorithm>
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QtPlugin>
+
+// QtD1 Includes
+#include "LevelPathfinder.h"
+#include "LevelSectorFactory.h"
+#include "MPQHandler.h"
+
+// Import custom plugins
+Q_IMPORT_PLUGIN(cel)
+Q_IMPORT_PLUGIN(pcx)
+
+Q_DECLARE_METATYPE( QtD1::LevelPathfinder::Algorithm )
+
+//---------------------------------------------------------------------------//
+// Helper functions.
+//---------------------------------------------------------------------------//
+// Open a rectangle of tiles
+void openTiles( QtD1::LevelGrid& grid,
+                const int x, const int y,
+                const int width, const int height )
+{
+  for( int j = y; j < y + height; ++j )
+  {
+    for( int i = x; i < x + width; ++i )
+    {
+      if( grid.isInside( i, j ) )
+        grid.setFlags( i, j, 0 );
+    }
+  }
+}
+
+// Create a synthetic dungeon (rooms connected by corridors)
+/*! \details A simple linear congruential generator is used so that the
+ * layout only depends on the seed.
+ */
+QtD1::LevelGrid createDungeonGrid( const unsigned seed,
+                                   QPoint& start,
+                                   QPoint& goal )
+{
+  QtD1::LevelGrid grid( 112, 112 );
+
+  unsigned state = seed;
+
+  auto random = [&state]( const int min, const int max ) -> int {
+    state = state*1103515245u + 12345u;
+    return min + (int)((state >> 16) % (unsigned)(max - min + 1));
+  };
+
+  QList<QPoint> room_centers;
+
+  for( int i = 0; i < 25; ++i )
+  {
+    const int width = random( 4, 14 );
+    const int height = random( 4, 14 );
+    const int x = random( 1, 110 - width );
+    const int y = random( 1, 110 - height );
+
+    openTiles( grid, x, y, width, height );
+
+    const QPoint center( x + width/2, y + height/2 );
+
+    // Connect the room to the previous room with an L-shaped corridor
+    if( !room_centers.isEmpty() )
+    {
+      const QPoint& previous_center = room_centers.back();
+
+      openTiles( grid,
+                 std::min( previous_center.x(), center.x() ),
+                 previous_center.y(),
+                 std::abs( center.x() - previous_center.x() ) + 2,
+                 2 );
+      openTiles( grid,
+                 center.x(),
+                 std::min( previous_center.y(), center.y() ),
+                 2,
+                 std::abs( center.y() - previous_center.y() ) + 2 );
+    }
+
+    room_centers << center;
+  }
+
+  start = room_centers.front();
+  goal = room_centers.back();
+
+  return grid;
+}
+
+// Create the town grid
+QtD1::LevelGrid createTownGrid()
+{
+  QtD1::LevelGrid grid( 96, 96 );
+
+  const char* sector_names[4] = {"/levels/towndata/sector4s.dun",
+                                 "/levels/towndata/sector3s.dun",
+                                 "/levels/towndata/sector2s.dun",
+                                 "/levels/towndata/sector1s.dun"};
+  const int sector_offsets[4][2] = {{0, 0}, {0, 46}, {46, 0}, {46, 46}};
+
+  for( int i = 0; i < 4; ++i )
+  {
+    QtD1::LevelSectorFactory sector_factory( "/levels/towndata/town.min",
+                                             "/levels/towndata/town.til",
+                                             sector_names[i] );
+
+    grid.paste( sector_factory.createLevelGrid( "/levels/towndata/town.sol" ),
+                sector_offsets[i][0],
+                sector_offsets[i][1] );
+  }
+
+  return grid;
+}
+
+// Find the walkable tile closest to a tile
+QPoint findWalkableTile( const QtD1::LevelGrid& grid, const QPoint& tile )
+{
+  for( int radius = 0; radius < grid.getWidth(); ++radius )
+  {
+    for( int j = tile.y() - radius; j <= tile.y() + radius; ++j )
+    {
+      for( int i = tile.x() - radius; i <= tile.x() + radius; ++i )
+      {
+        if( grid.isWalkable( i, j ) )
+          return QPoint( i, j );
+      }
+    }
+  }
+
+  return tile;
+}
+
+// Check that a path is valid and return its cost
+int getPathCost( const QtD1::LevelGrid& grid,
+                 const QPoint& start,
+                 const QVector<QPoint>& path )
+{
+  int cost = 0;
+
+  QPoint tile = start;
+
+  for( int i = 0; i < path.size(); ++i )
+  {
+    const int dx = path[i].x() - tile.x();
+    const int dy = path[i].y() - tile.y();
+
+    // Each step must be to a walkable neighbor
+    if( std::abs( dx ) > 1 || std::abs( dy ) > 1 || (dx == 0 && dy == 0) )
+      return -1;
+
+    if( !grid.isWalkable( path[i].x(), path[i].y() ) )
+      return -1;
+
+    // Diagonal steps cannot cut corners
+    if( dx != 0 && dy != 0 )
+    {
+      if( !grid.isWalkable( tile.x() + dx, tile.y() ) ||
+          !grid.isWalkable( tile.x(), tile.y() + dy ) )
+        return -1;
+
+      cost += 14;
+    }
+    else
+      cost += 10;
+
+    tile = path[i];
+  }
+
+  return cost;
+}
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestLevelPathfinder : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void initTestCase()
+  {
+    // Register the MPQHandler with the file engine system
+    QtD1::MPQHandler::getInstance();
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that a path can be found on open ground
+void findPath_open_data()
+{
+  QTest::addColumn<QtD1::LevelPathfinder::Algorithm>( "algorithm" );
+
+  QTest::newRow( "A*" ) << QtD1::LevelPathfinder::AStar;
+  QTest::newRow( "JPS" ) << QtD1::LevelPathfinder::JumpPointSearch;
+}
+
+void findPath_open()
+{
+  QFETCH( QtD1::LevelPathfinder::Algorithm, algorithm );
+
+  QtD1::LevelGrid grid( 20, 20 );
+  openTiles( grid, 0, 0, 20, 20 );
+
+  QtD1::LevelPathfinder pathfinder( grid );
+
+  QVector<QPoint> path;
+
+  QVERIFY( pathfinder.findPath( QPoint( 2, 2 ), QPoint( 12, 7 ), path, algorithm ) );
+  QCOMPARE( path.size(), 10 );
+  QCOMPARE( path.back(), QPoint( 12, 7 ) );
+  QCOMPARE( getPathCost( grid, QPoint( 2, 2 ), path ), 5*14 + 5*10 );
+
+  // The start tile is the goal tile
+  QVERIFY( pathfinder.findPath( QPoint( 2, 2 ), QPoint( 2, 2 ), path, algorithm ) );
+  QVERIFY( path.isEmpty() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a path can be found around a wall
+void findPath_wall_data()
+{
+  this->findPath_open_data();
+}
+
+void findPath_wall()
+{
+  QFETCH( QtD1::LevelPathfinder::Algorithm, algorithm );
+
+  QtD1::LevelGrid grid( 10, 10 );
+  openTiles( grid, 0, 0, 10, 10 );
+
+  // Wall from (5,0) to (5,8)
+  for( int j = 0; j < 9; ++j )
+    grid.setFlags( 5, j, QtD1::LevelGrid::BlocksWalking );
+
+  QtD1::LevelPathfinder pathfinder( grid );
+
+  QVector<QPoint> path;
+
+  QVERIFY( pathfinder.findPath( QPoint( 2, 2 ), QPoint( 8, 2 ), path, algorithm ) );
+  QCOMPARE( path.back(), QPoint( 8, 2 ) );
+
+  // Down to row 9 and back up - the wall corner cannot be cut
+  QCOMPARE( getPathCost( grid, QPoint( 2, 2 ), path ), 176 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that unreachable goals are reported
+void findPath_unreachable_data()
+{
+  this->findPath_open_data();
+}
+
+void findPath_unreachable()
+{
+  QFETCH( QtD1::LevelPathfinder::Algorithm, algorithm );
+
+  QtD1::LevelGrid grid( 10, 10 );
+  openTiles( grid, 0, 0, 10, 10 );
+
+  for( int j = 0; j < 10; ++j )
+    grid.setFlags( 5, j, QtD1::LevelGrid::BlocksWalking );
+
+  QtD1::LevelPathfinder pathfinder( grid );
+
+  QVector<QPoint> path;
+
+  QVERIFY( !pathfinder.findPath( QPoint( 2, 2 ), QPoint( 8, 2 ), path, algorithm ) );
+  QVERIFY( path.isEmpty() );
+
+  // Blocked goal
+  QVERIFY( !pathfinder.findPath( QPoint( 2, 2 ), QPoint( 5, 2 ), path, algorithm ) );
+
+  // Goal outside of the grid
+  QVERIFY( !pathfinder.findPath( QPoint( 2, 2 ), QPoint( 12, 2 ), path, algorithm ) );
+
+  // Blocked start
+  QVERIFY( !pathfinder.findPath( QPoint( 5, 2 ), QPoint( 8, 2 ), path, algorithm ) );
+  QVERIFY( !pathfinder.findPath( QPoint( 5, 2 ), QPoint( 5, 2 ), path, algorithm ) );
+
+  // Start outside of the grid
+  QVERIFY( !pathfinder.findPath( QPoint( -1, 2 ), QPoint( 2, 2 ), path, algorithm ) );
+
+  // The search can be bounded
+  openTiles( grid, 5, 9, 1, 1 );
+  pathfinder.setGrid( grid );
+  pathfinder.setMaxExpandedNodes( 1 );
+
+  QVERIFY( !pathfinder.findPath( QPoint( 2, 2 ), QPoint( 8, 2 ), path, algorithm ) );
+
+  pathfinder.setMaxExpandedNodes( grid.getNumberOfTiles() );
+
+  QVERIFY( pathfinder.findPath( QPoint( 2, 2 ), QPoint( 8, 2 ), path, algorithm ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that A* and JPS find paths with the same cost
+void findPath_dungeon()
+{
+  for( unsigned seed = 1; seed <= 20; ++seed )
+  {
+    QPoint start, goal;
+
+    QtD1::LevelGrid grid = createDungeonGrid( seed, start, goal );
+
+    QtD1::LevelPathfinder pathfinder( grid );
+
+    QVector<QPoint> a_star_path, jps_path;
+
+    QVERIFY( pathfinder.findPath( start, goal, a_star_path,
+                                  QtD1::LevelPathfinder::AStar ) );
+
+    QVERIFY( pathfinder.findPath( start, goal, jps_path,
+                                  QtD1::LevelPathfinder::JumpPointSearch ) );
+
+    const int a_star_cost = getPathCost( grid, start, a_star_path );
+
+    QVERIFY( a_star_cost >= 0 );
+    QCOMPARE( getPathCost( grid, start, jps_path ), a_star_cost );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that path requests can be processed in batches
+void processPathRequests()
+{
+  QtD1::LevelGrid grid( 20, 20 );
+  openTiles( grid, 0, 0, 20, 20 );
+
+  QtD1::LevelPathfinder pathfinder( grid );
+
+  const int first_id =
+    pathfinder.queuePathRequest( QPoint( 0, 0 ), QPoint( 5, 0 ) );
+  const int second_id =
+    pathfinder.queuePathRequest( QPoint( 0, 0 ), QPoint( 25, 0 ) );
+  const int third_id =
+    pathfinder.queuePathRequest( QPoint( 0, 0 ), QPoint( 0, 5 ),
+                                 QtD1::LevelPathfinder::JumpPointSearch );
+
+  QCOMPARE( pathfinder.getNumberOfQueuedPathRequests(), 3 );
+  QCOMPARE( pathfinder.getPathRequestStatus( first_id ),
+            QtD1::LevelPathfinder::PendingRequest );
+
+  QCOMPARE( pathfinder.processPathRequests( 2 ), 2 );
+  QCOMPARE( pathfinder.getNumberOfQueuedPathRequests(), 1 );
+  QCOMPARE( pathfinder.getPathRequestStatus( first_id ),
+            QtD1::LevelPathfinder::PathFound );
+  QCOMPARE( pathfinder.getPathRequestStatus( second_id ),
+            QtD1::LevelPathfinder::NoPathFound );
+  QCOMPARE( pathfinder.getPathRequestStatus( third_id ),
+            QtD1::LevelPathfinder::PendingRequest );
+
+  QVector<QPoint> path;
+
+  QVERIFY( !pathfinder.takePath( third_id, path ) );
+  QVERIFY( pathfinder.takePath( first_id, path ) );
+  QCOMPARE( path.size(), 5 );
+  QCOMPARE( pathfinder.getPathRequestStatus( first_id ),
+            QtD1::LevelPathfinder::InvalidRequest );
+
+  pathfinder.cancelPathRequest( third_id );
+
+  QCOMPARE( pathfinder.getNumberOfQueuedPathRequests(), 0 );
+  QCOMPARE( pathfinder.processPathRequests(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Benchmarks.
+//---------------------------------------------------------------------------//
+// Benchmark the searches on synthetic 112x112 dungeons
+void benchmark_dungeon_data()
+{
+  this->findPath_open_data();
+}
+
+void benchmark_dungeon()
+{
+  QFETCH( QtD1::LevelPathfinder::Algorithm, algorithm );
+
+  QList<QtD1::LevelGrid> grids;
+  QList<QPoint> starts, goals;
+
+  for( unsigned seed = 1; seed <= 10; ++seed )
+  {
+    QPoint start, goal;
+
+    grids << createDungeonGrid( seed, start, goal );
+    starts << start;
+    goals << goal;
+  }
+
+  QList<QtD1::LevelPathfinder> pathfinders;
+
+  for( int i = 0; i < grids.size(); ++i )
+    pathfinders << QtD1::LevelPathfinder( grids[i] );
+
+  QVector<QPoint> path;
+
+  QBENCHMARK
+  {
+    for( int i = 0; i < pathfinders.size(); ++i )
+      pathfinders[i].findPath( starts[i], goals[i], path, algorithm );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Benchmark the searches across the town
+void benchmark_town_data()
+{
+  this->findPath_open_data();
+}
+
+void benchmark_town()
+{
+  QFETCH( QtD1::LevelPathfinder::Algorithm, algorithm );
+
+  QtD1::LevelGrid grid = createTownGrid();
+
+  QtD1::LevelPathfinder pathfinder( grid );
+
+  // Search between the corners of the town
+  const QPoint corners[4] = {findWalkableTile( grid, QPoint( 10, 10 ) ),
+                             findWalkableTile( grid, QPoint( 85, 10 ) ),
+                             findWalkableTile( grid, QPoint( 10, 85 ) ),
+                             findWalkableTile( grid, QPoint( 85, 85 ) )};
+
+  QVector<QPoint> path;
+
+  QBENCHMARK
+  {
+    for( int i = 0; i < 4; ++i )
+    {
+      for( int j = 0; j < 4; ++j )
+      {
+        if( i != j )
+          pathfinder.findPath( corners[i], corners[j], path, algorithm );
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestLevelPathfinder )
+#include "tstLevelPathfinder.moc"
+
+//---------------------------------------------------------------------------//
+// end tstLevelPathfinder.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,221 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstLevelRegionStreamer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level region streamer unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QImageReader>
+#include <QGraphicsScene>
+#include <QtPlugin>
+
+// QtD1 Includes
+#include "LevelRegionStreamer.h"
+#include "LevelSector.h"
+#include "LevelSectorFactory.h"
+#include "MPQHandler.h"
+
+// Import custom plugins
+Q_IMPORT_PLUGIN(cel)
+Q_IMPORT_PLUGIN(pcx)
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestLevelRegionStreamer : public QObject
+{
+  Q_OBJECT
+
+private:
+
+  // The image asset frames
+  QVector<QImage> t_image_asset_frames;
+
+  // The scene
+  QGraphicsScene* t_scene;
+
+  // The level sectors (regions)
+  QList<QtD1::LevelSector*> t_level_sectors;
+
+  // Wait for the streamer to finish loading regions
+  void waitForStreaming( QtD1::LevelRegionStreamer& streamer )
+  {
+    for( int i = 0; i < 500 && streamer.isStreaming(); ++i )
+      QTest::qWait( 10 );
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    // Register the MPQHandler with the file engine system
+    QtD1::MPQHandler::getInstance();
+
+    // Load the image asset frames
+    QImageReader asset_reader( "/levels/towndata/town.cel+levels/towndata/town.pal" );
+
+    t_image_asset_frames.resize( asset_reader.imageCount() );
+
+    for( int i = 0; i < asset_reader.imageCount(); ++i )
+    {
+      t_image_asset_frames[i] = asset_reader.read();
+
+      asset_reader.jumpToNextImage();
+    }
+  }
+
+  void init()
+  {
+    // Each sector has its own squares so that no pillars are shared
+    t_scene = new QGraphicsScene;
+
+    QtD1::LevelSectorFactory sector_factory( "/levels/towndata/town.min",
+                                             "/levels/towndata/town.til",
+                                             "/levels/towndata/sector1s.dun" );
+
+    QtD1::LevelSector* near_sector = sector_factory.createLevelSector();
+    QtD1::LevelSector* far_sector = sector_factory.createLevelSector();
+
+    t_scene->addItem( near_sector );
+    t_scene->addItem( far_sector );
+
+    far_sector->setPos( 20000, 0 );
+
+    t_level_sectors.clear();
+    t_level_sectors << near_sector << far_sector;
+  }
+
+  void cleanup()
+  {
+    delete t_scene;
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the regions start unloaded and hidden
+void setRegions()
+{
+  QtD1::LevelRegionStreamer streamer;
+  streamer.setRegions( t_level_sectors );
+
+  QCOMPARE( streamer.getNumberOfRegions(), 2 );
+  QCOMPARE( streamer.getRegionState( 0 ), QtD1::LevelRegionStreamer::Unloaded );
+  QCOMPARE( streamer.getRegionState( 1 ), QtD1::LevelRegionStreamer::Unloaded );
+  QCOMPARE( streamer.getMemoryUsage(), (qint64)0 );
+  QVERIFY( !t_level_sectors[0]->isVisible() );
+  QVERIFY( !t_level_sectors[1]->isVisible() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only the regions around a position are loaded
+void loadRegionsSync()
+{
+  QtD1::LevelRegionStreamer streamer;
+  streamer.setRegions( t_level_sectors );
+  streamer.setImageAssetFrames( t_image_asset_frames );
+
+  QSignalSpy region_loaded_spy( &streamer, SIGNAL(regionLoaded(const int)) );
+
+  streamer.loadRegionsSync( t_level_sectors[0]->sceneBoundingRect().center() );
+
+  QCOMPARE( streamer.getRegionState( 0 ), QtD1::LevelRegionStreamer::Resident );
+  QCOMPARE( streamer.getRegionState( 1 ), QtD1::LevelRegionStreamer::Unloaded );
+  QCOMPARE( region_loaded_spy.count(), 1 );
+  QVERIFY( t_level_sectors[0]->isVisible() );
+  QVERIFY( !t_level_sectors[1]->isVisible() );
+  QVERIFY( streamer.getMemoryUsage() > 0 );
+  QCOMPARE( streamer.getNumberOfQueuedRegions(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the regions within the prefetch distance are streamed in
+void setFocus_prefetch()
+{
+  QtD1::LevelRegionStreamer streamer;
+  streamer.setRegions( t_level_sectors );
+  streamer.setImageAssetFrames( t_image_asset_frames );
+  streamer.setDistances( 0.0, 40000.0 );
+  streamer.setMemoryBudget( (qint64)1024*1024*1024 );
+
+  streamer.loadRegionsSync( t_level_sectors[0]->sceneBoundingRect().center() );
+
+  // The far region is only within the prefetch distance
+  QCOMPARE( streamer.getRegionState( 0 ), QtD1::LevelRegionStreamer::Resident );
+  QVERIFY( streamer.getRegionState( 1 ) != QtD1::LevelRegionStreamer::Unloaded );
+
+  this->waitForStreaming( streamer );
+
+  QCOMPARE( streamer.getRegionState( 1 ), QtD1::LevelRegionStreamer::Resident );
+  QVERIFY( t_level_sectors[1]->isVisible() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that distant regions are evicted when the budget is exceeded
+void setFocus_evict()
+{
+  QtD1::LevelRegionStreamer streamer;
+  streamer.setRegions( t_level_sectors );
+  streamer.setImageAssetFrames( t_image_asset_frames );
+
+  streamer.loadRegionsSync( t_level_sectors[0]->sceneBoundingRect().center() );
+
+  const qint64 region_memory = streamer.getMemoryUsage();
+
+  // Only one region fits in the budget
+  streamer.setMemoryBudget( region_memory );
+
+  streamer.setFocus( t_level_sectors[1]->sceneBoundingRect().center() );
+
+  this->waitForStreaming( streamer );
+
+  QCOMPARE( streamer.getRegionState( 0 ), QtD1::LevelRegionStreamer::Unloaded );
+  QCOMPARE( streamer.getRegionState( 1 ), QtD1::LevelRegionStreamer::Resident );
+  QVERIFY( !t_level_sectors[0]->isVisible() );
+  QVERIFY( t_level_sectors[1]->isVisible() );
+  QCOMPARE( streamer.getMemoryUsage(), region_memory );
+}
+
+//---------------------------------------------------------------------------//
+// Check that all regions can be evicted
+void evictRegions()
+{
+  QtD1::LevelRegionStreamer streamer;
+  streamer.setRegions( t_level_sectors );
+  streamer.setImageAssetFrames( t_image_asset_frames );
+
+  streamer.loadRegionsSync( t_level_sectors[0]->sceneBoundingRect().center() );
+
+  streamer.evictRegions();
+
+  QCOMPARE( streamer.getRegionState( 0 ), QtD1::LevelRegionStreamer::Unloaded );
+  QCOMPARE( streamer.getMemoryUsage(), (qint64)0 );
+  QVERIFY( !t_level_sectors[0]->isVisible() );
+
+  // The regions can be loaded again
+  streamer.loadRegionsSync( t_level_sectors[0]->sceneBoundingRect().center() );
+
+  QCOMPARE( streamer.getRegionState( 0 ), QtD1::LevelRegionStreamer::Resident );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestLevelRegionStreamer )
+#include "tstLevelRegionStreamer.moc"
+
+//---------------------------------------------------------------------------//
+// end tstLevelRegionStreamer.cpp
+//---------------------------------------------------------------------------//
@@ -78,6 +78,73 @@ void createLevelSector_cached_squares()
   delete sector;
 }
 
+//---------------------------------------------------------------------------//
+// Check that the level sector grid can be constructed
+void createLevelGrid()
+{
+  QtD1::LevelSectorFactory sector_factory( "/levels/towndata/town.min",
+                                           "/levels/towndata/town.til",
+                                           "/levels/towndata/sector1s.dun" );
+
+  QtD1::LevelGrid grid =
+    sector_factory.createLevelGrid( "/levels/towndata/town.sol" );
+
+  QCOMPARE( grid.getWidth(), 50 );
+  QCOMPARE( grid.getHeight(), 50 );
+
+  // Some of the town tiles must be walkable and some must be blocked
+  int number_of_walkable_tiles = 0;
+
+  for( int j = 0; j < grid.getHeight(); ++j )
+  {
+    for( int i = 0; i < grid.getWidth(); ++i )
+    {
+      if( grid.isWalkable( i, j ) )
+        ++number_of_walkable_tiles;
+    }
+  }
+
+  QVERIFY( number_of_walkable_tiles > 0 );
+  QVERIFY( number_of_walkable_tiles < grid.getNumberOfTiles() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the level sector grid can be constructed from shared tables
+void createLevelGrid_shared_tables()
+{
+  QVector<quint16> square_pillar_indices;
+  QtD1::LevelSectorFactory::readSquarePillarIndices(
+                                                 "/levels/towndata/town.til",
+                                                 square_pillar_indices );
+
+  QByteArray pillar_flags;
+  QtD1::LevelSectorFactory::readPillarFlags( "/levels/towndata/town.sol",
+                                             pillar_flags );
+
+  QVERIFY( square_pillar_indices.size() > 0 );
+  QCOMPARE( square_pillar_indices.size() % 4, 0 );
+  QVERIFY( pillar_flags.size() > 0 );
+
+  QtD1::LevelSectorFactory sector_factory( "/levels/towndata/town.min",
+                                           "/levels/towndata/town.til",
+                                           "/levels/towndata/sector1s.dun" );
+
+  QtD1::LevelGrid shared_grid =
+    sector_factory.createLevelGrid( square_pillar_indices, pillar_flags );
+
+  QtD1::LevelGrid grid =
+    sector_factory.createLevelGrid( "/levels/towndata/town.sol" );
+
+  QCOMPARE( shared_grid.getWidth(), grid.getWidth() );
+  QCOMPARE( shared_grid.getHeight(), grid.getHeight() );
+
+  for( int i = 0; i < grid.getNumberOfTiles(); ++i )
+  {
+    QCOMPARE( shared_grid.getRawPillarIds()[i], grid.getRawPillarIds()[i] );
+    QCOMPARE( shared_grid.getRawFlags()[i], grid.getRawFlags()[i] );
+  }
+}
+
 //---------------------------------------------------------------------------//
 // End test suite.
 //---------------------------------------------------------------------------//
@@ -0,0 +1,180 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstLevelSpatialHash.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The level spatial hash unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+
+// Qt Includes
+#include <QtTest/QtTest>
+
+// QtD1 Includes
+#include "LevelSpatialHash.h"
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestLevelSpatialHash : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that level positions can be mapped to squares
+void mapToSquare()
+{
+  QtD1::LevelSpatialHash<int> spatial_hash( QPointF( 640, 0 ) );
+
+  QCOMPARE( spatial_hash.mapToSquare( QPointF( 640, 1 ) ), QPoint( 0, 0 ) );
+  QCOMPARE( spatial_hash.mapToSquare( QPointF( 640, 63 ) ), QPoint( 0, 0 ) );
+  QCOMPARE( spatial_hash.mapToSquare( QPointF( 704, 33 ) ), QPoint( 1, 0 ) );
+  QCOMPARE( spatial_hash.mapToSquare( QPointF( 576, 33 ) ), QPoint( 0, 1 ) );
+  QCOMPARE( spatial_hash.mapToSquare( QPointF( 640, 65 ) ), QPoint( 1, 1 ) );
+  QCOMPARE( spatial_hash.mapToSquare( QPointF( 640, -1 ) ), QPoint( -1, -1 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that squares can be mapped to level positions
+void mapFromSquare()
+{
+  QtD1::LevelSpatialHash<int> spatial_hash( QPointF( 640, 0 ) );
+
+  QCOMPARE( spatial_hash.mapFromSquare( QPoint( 0, 0 ) ), QPointF( 640, 0 ) );
+  QCOMPARE( spatial_hash.mapFromSquare( QPoint( 2, 0 ) ), QPointF( 768, 64 ) );
+  QCOMPARE( spatial_hash.mapFromSquare( QPoint( 0, 2 ) ), QPointF( 512, 64 ) );
+  QCOMPARE( spatial_hash.mapToSquare(
+                   spatial_hash.mapFromSquare( QPoint( 5, 3 ) ) + QPointF( 0, 1 ) ),
+            QPoint( 5, 3 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that items can be inserted, moved and removed
+void insert_move_remove()
+{
+  QtD1::LevelSpatialHash<int> spatial_hash;
+
+  spatial_hash.insert( 1, QPointF( 0, 10 ) );
+  spatial_hash.insert( 2, QPointF( 0, 20 ) );
+
+  QCOMPARE( spatial_hash.size(), 2 );
+  QVERIFY( spatial_hash.contains( 1 ) );
+  QCOMPARE( spatial_hash.getSquare( 1 ), QPoint( 0, 0 ) );
+
+  QList<int> items;
+  spatial_hash.querySquare( QPoint( 0, 0 ), items );
+
+  QCOMPARE( items.size(), 2 );
+
+  // Move within the square
+  spatial_hash.move( 1, QPointF( 0, 30 ) );
+
+  QCOMPARE( spatial_hash.getPosition( 1 ), QPointF( 0, 30 ) );
+  QCOMPARE( spatial_hash.getSquare( 1 ), QPoint( 0, 0 ) );
+
+  // Move to a new square
+  spatial_hash.move( 1, QPointF( 0, 100 ) );
+
+  QCOMPARE( spatial_hash.getSquare( 1 ), QPoint( 1, 1 ) );
+
+  items.clear();
+  spatial_hash.querySquare( QPoint( 0, 0 ), items );
+
+  QCOMPARE( items.size(), 1 );
+  QCOMPARE( items.front(), 2 );
+
+  spatial_hash.remove( 2 );
+
+  QVERIFY( !spatial_hash.contains( 2 ) );
+
+  items.clear();
+  spatial_hash.querySquare( QPoint( 0, 0 ), items );
+
+  QVERIFY( items.isEmpty() );
+
+  spatial_hash.clear();
+
+  QVERIFY( spatial_hash.isEmpty() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the items in a rect can be queried
+void queryRect()
+{
+  QtD1::LevelSpatialHash<int> spatial_hash;
+
+  for( int i = 0; i < 20; ++i )
+    spatial_hash.insert( i, QPointF( i*50, i*25 ) );
+
+  QList<int> items;
+  spatial_hash.queryRect( QRectF( 90, 40, 120, 70 ), items );
+
+  std::sort( items.begin(), items.end() );
+
+  QCOMPARE( items, QList<int>() << 2 << 3 << 4 );
+
+  // Large rects visit the occupied buckets directly
+  items.clear();
+  spatial_hash.queryRect( QRectF( -10000, -10000, 20000, 20000 ), items );
+
+  QCOMPARE( items.size(), 20 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the items in a circle can be queried
+void queryRadius()
+{
+  QtD1::LevelSpatialHash<int> spatial_hash;
+
+  spatial_hash.insert( 1, QPointF( 0, 0 ) );
+  spatial_hash.insert( 2, QPointF( 30, 40 ) );
+  spatial_hash.insert( 3, QPointF( 300, 400 ) );
+  spatial_hash.insert( 4, QPointF( -50, 1 ) );
+
+  QList<int> items;
+  spatial_hash.queryRadius( QPointF( 0, 0 ), 50, items );
+
+  std::sort( items.begin(), items.end() );
+
+  QCOMPARE( items, QList<int>() << 1 << 2 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the items along a line can be queried
+void queryLine()
+{
+  QtD1::LevelSpatialHash<int> spatial_hash;
+
+  spatial_hash.insert( 1, QPointF( 500, 505 ) );
+  spatial_hash.insert( 2, QPointF( 1000, 990 ) );
+  spatial_hash.insert( 3, QPointF( 500, 0 ) );
+  spatial_hash.insert( 4, QPointF( 1500, 1500 ) );
+
+  QList<int> items;
+  spatial_hash.queryLine( QPointF( 0, 0 ), QPointF( 1200, 1200 ), 10, items );
+
+  std::sort( items.begin(), items.end() );
+
+  QCOMPARE( items, QList<int>() << 1 << 2 );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestLevelSpatialHash )
+#include "tstLevelSpatialHash.moc"
+
+//---------------------------------------------------------------------------//
+// end tstLevelSpatialHash.cpp
+//---------------------------------------------------------------------------//
@@ -15,6 +15,7 @@
 
 // QtD1 Includes
 #include "MPQFileEngine.h"
+#include "CustomMPQFileHeader.h"
 
 //---------------------------------------------------------------------------//
 // Test suite.
@@ -295,6 +296,58 @@ void read()
   QCOMPARE( QString( buffer ), QString("This is test data") );
 }
 
+//---------------------------------------------------------------------------//
+// Check that a compound asset can be read as a single buffer
+void read_compound_asset()
+{
+  QtD1::CompoundAsset asset;
+  asset.addPart( "levels/towndata/town.cel", QByteArray( "This is cel data" ) );
+  asset.addPart( "levels/towndata/town.pal", QByteArray( "palette" ) );
+
+  QtD1::MPQFileEngine file( asset );
+
+  // The parts are shared with the engine
+  QCOMPARE( file.getCompoundAsset().getNumberOfParts(), 2 );
+  QVERIFY( file.getCompoundAsset().getPartData( 0 ).constData() ==
+           asset.getPartData( 0 ).constData() );
+
+  // The buffer must match the legacy concatenated buffer
+  QByteArray legacy_buffer( "This is cel datapalette" );
+
+  QtD1::CustomMPQFileHeader header;
+  header.addElement( "levels/towndata/town.cel", 0 );
+  header.addElement( "levels/towndata/town.pal", 16 );
+  header.addToBuffer( legacy_buffer );
+
+  QCOMPARE( file.size(), (qint64)legacy_buffer.size() );
+
+  // Read the file in chunks that span the part boundaries
+  QByteArray buffer( file.size(), 0 );
+  qint64 bytes_read = 0;
+
+  while( bytes_read < buffer.size() )
+    bytes_read += file.read( buffer.data()+bytes_read, 5 );
+
+  QCOMPARE( bytes_read, (qint64)legacy_buffer.size() );
+  QCOMPARE( buffer, legacy_buffer );
+  QCOMPARE( file.read( buffer.data(), 1 ), 0ll );
+
+  // Read across the part boundary after a seek
+  char boundary_data[4];
+
+  QVERIFY( file.seek( legacy_buffer.size()-9 ) );
+  QCOMPARE( file.read( boundary_data, 4 ), 4ll );
+  QCOMPARE( QByteArray( boundary_data, 4 ), QByteArray( "tapa" ) );
+
+  // A single part asset does not have a header
+  QtD1::CompoundAsset single_asset;
+  single_asset.addPart( "ui_art/title.pcx", QByteArray( "This is test data" ) );
+
+  QtD1::MPQFileEngine single_file( single_asset );
+
+  QCOMPARE( single_file.size(), 17ll );
+}
+
 //---------------------------------------------------------------------------//
 // Check that a line of the file can be read
 void readLine()
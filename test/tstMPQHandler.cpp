@@ -416,6 +416,56 @@ void createSafeWithCheck()
   QVERIFY( exception_thrown );
 }
 
+//---------------------------------------------------------------------------//
+// Check that concatenated files can be opened as a compound asset
+void openCompoundAsset()
+{
+  const QtD1::MPQHandler* mpq_handler =
+    QtD1::MPQHandler::getInstance();
+
+  QtD1::CompoundAsset asset;
+
+  try{
+    asset = mpq_handler->openCompoundAsset( "/levels/towndata/town.cel+/levels/towndata/town.pal" );
+  }
+  catch( ... )
+  {
+    QFAIL( "The compound asset could not be opened!" );
+  }
+
+  QCOMPARE( asset.getNumberOfParts(), 2 );
+  QCOMPARE( asset.getPartFileName( 0 ), QString("levels/towndata/town.cel") );
+  QCOMPARE( asset.getPartData( 0 ).size(), 2176004 );
+  QCOMPARE( asset.getPartFileName( 1 ), QString("levels/towndata/town.pal") );
+  QCOMPARE( asset.getPartData( 1 ).size(), 768 );
+  QCOMPARE( asset.findPart( ".cel" ), 0 );
+  QCOMPARE( asset.findPart( ".pal" ), 1 );
+  QCOMPARE( asset.findPart( ".cl2" ), -1 );
+  QCOMPARE( asset.getSize(), 2176772ll );
+
+  // The engine shares the parts with the asset
+  std::shared_ptr<QtD1::MPQFileEngine> archived_file =
+    mpq_handler->createSafeWithCheck( "/levels/towndata/town.cel+/levels/towndata/town.pal" );
+
+  const QtD1::CompoundAsset& engine_asset = archived_file->getCompoundAsset();
+  
+  QCOMPARE( engine_asset.getNumberOfParts(), 2 );
+  QVERIFY( engine_asset.getPartData( 0 ) == asset.getPartData( 0 ) );
+
+  // Failure to open an asset should result in an exception
+  bool exception_thrown = false;
+  
+  try{
+    asset = mpq_handler->openCompoundAsset( "dummy+levels/towndata/town.pal" );
+  }
+  catch( const std::runtime_error& error )
+  {
+    exception_thrown = true;
+  }
+
+  QVERIFY( exception_thrown );
+}
+
 //---------------------------------------------------------------------------//
 // Check that archived files can be extracted
 void extractFile()
@@ -0,0 +1,360 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstMonsterStore.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The monster store unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QGraphicsScene>
+
+// QtD1 Includes
+#include "MonsterStore.h"
+#include "MonsterRenderer.h"
+
+//---------------------------------------------------------------------------//
+// Test helpers.
+//---------------------------------------------------------------------------//
+// Create a monster type table with a single predictable monster type
+QVector<QtD1::MonsterStore::MonsterType> createMonsterTypes(
+                                                    const qreal walk_speed )
+{
+  QtD1::MonsterStore::MonsterType monster_type =
+    {"Test", "/monsters/test/test", 10, 10, 0, 100, 5, 5,
+     walk_speed, 200.0, 10.0, 3};
+
+  return QVector<QtD1::MonsterStore::MonsterType>( 1, monster_type );
+}
+
+// Create a cathedral sized grid with a blocked border and blocked pillars
+QtD1::LevelGrid createCathedralGrid()
+{
+  QtD1::LevelGrid grid( 112, 112 );
+
+  for( int y = 0; y < grid.getHeight(); ++y )
+  {
+    for( int x = 0; x < grid.getWidth(); ++x )
+    {
+      if( x < 16 || y < 16 || x >= 96 || y >= 96 || (x % 4 == 0 && y % 4 == 0) )
+        grid.setFlags( x, y, QtD1::LevelGrid::BlocksWalking );
+    }
+  }
+
+  return grid;
+}
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestMonsterStore : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the default monster types can be found
+void getDefaultMonsterTypes()
+{
+  QtD1::MonsterStore store;
+
+  QVERIFY( !QtD1::MonsterStore::getDefaultMonsterTypes().empty() );
+  QVERIFY( store.findMonsterType( "Zombie" ) >= 0 );
+  QCOMPARE( store.findMonsterType( "Diablo" ), -1 );
+
+  const QtD1::MonsterStore::MonsterType& zombie =
+    store.getMonsterTypes()[store.findMonsterType( "Zombie" )];
+
+  QVERIFY( zombie.min_health <= zombie.max_health );
+  QVERIFY( zombie.min_damage <= zombie.max_damage );
+}
+
+//---------------------------------------------------------------------------//
+// Check that monsters can be spawned and despawned
+void spawn_despawn()
+{
+  QtD1::MonsterStore store( 2 );
+
+  const int zombie = store.findMonsterType( "Zombie" );
+
+  const int first_id = store.spawn( zombie, QPointF( 10, 10 ) );
+  const int second_id = store.spawn( zombie, QPointF( 20, 20 ) );
+  const int third_id = store.spawn( zombie, QPointF( 30, 30 ) );
+
+  QCOMPARE( store.getNumberOfMonsters(), 3 );
+  QVERIFY( store.getCapacity() >= 3 );
+  QCOMPARE( store.getType( second_id ), zombie );
+  QCOMPARE( store.getPosition( second_id ), QPointF( 20, 20 ) );
+  QCOMPARE( store.getState( second_id ), QtD1::Actor::Standing );
+  QVERIFY( store.getHealth( second_id ) >=
+           store.getMonsterTypes()[zombie].min_health );
+  QVERIFY( store.getHealth( second_id ) <=
+           store.getMonsterTypes()[zombie].max_health );
+
+  store.despawn( first_id );
+
+  QCOMPARE( store.getNumberOfMonsters(), 2 );
+  QVERIFY( !store.isSpawned( first_id ) );
+  QCOMPARE( store.getPosition( third_id ), QPointF( 30, 30 ) );
+
+  // The ids are recycled
+  QCOMPARE( store.spawn( zombie, QPointF() ), first_id );
+
+  store.clear();
+
+  QCOMPARE( store.getNumberOfMonsters(), 0 );
+  QVERIFY( !store.isSpawned( second_id ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that monsters recoil from hits and die
+void applyDamage()
+{
+  QtD1::MonsterStore store;
+  store.setMonsterTypes( createMonsterTypes( 1.0 ) );
+
+  const int id = store.spawn( 0, QPointF( 0, 0 ) );
+
+  // The target is out of sight
+  const QPointF target( 1000, 1000 );
+
+  QVERIFY( !store.applyDamage( id, 3 ) );
+  QCOMPARE( store.getHealth( id ), 7 );
+  QCOMPARE( store.getState( id ), QtD1::Actor::RecoilingFromHit );
+
+  for( int i = 0; i < QtD1::MonsterStore::s_recoil_duration; ++i )
+    store.advance( target, 0 );
+
+  QCOMPARE( store.getState( id ), QtD1::Actor::Standing );
+
+  QVERIFY( store.applyDamage( id, 20 ) );
+  QCOMPARE( store.getHealth( id ), 0 );
+  QCOMPARE( store.getState( id ), QtD1::Actor::Dying );
+
+  QVector<int> monster_ids;
+  store.getMonstersInRadius( QPointF( 0, 0 ), 10, monster_ids );
+
+  QVERIFY( monster_ids.empty() );
+
+  for( int i = 0; i < QtD1::MonsterStore::s_dying_duration; ++i )
+    store.advance( target, 0 );
+
+  QCOMPARE( store.getState( id ), QtD1::Actor::Dead );
+  QVERIFY( !store.applyDamage( id, 20 ) );
+
+  // The corpse is still drawn
+  store.getMonstersInRect( QRectF( -10, -10, 20, 20 ), monster_ids );
+
+  QCOMPARE( monster_ids.size(), 1 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that monsters walk towards and attack the target
+void advance()
+{
+  QtD1::MonsterStore walking_store;
+  walking_store.setMonsterTypes( createMonsterTypes( 2.0 ) );
+
+  const int walking_id = walking_store.spawn( 0, QPointF( 0, 0 ) );
+
+  QCOMPARE( walking_store.advance( QPointF( 50, 0 ), 0 ), 0 );
+  QCOMPARE( walking_store.getState( walking_id ), QtD1::Actor::Walking );
+  QCOMPARE( walking_store.getPosition( walking_id ), QPointF( 2, 0 ) );
+  QCOMPARE( walking_store.getDirection( walking_id ), QtD1::East );
+
+  // Monsters stand when the target is out of sight
+  walking_store.advance( QPointF( 1000, 0 ), 0 );
+
+  QCOMPARE( walking_store.getState( walking_id ), QtD1::Actor::Standing );
+  QCOMPARE( walking_store.getPosition( walking_id ), QPointF( 2, 0 ) );
+
+  QtD1::MonsterStore attacking_store;
+  attacking_store.setMonsterTypes( createMonsterTypes( 2.0 ) );
+
+  const int attacking_id = attacking_store.spawn( 0, QPointF( 0, 0 ) );
+
+  QCOMPARE( attacking_store.advance( QPointF( 0, 5 ), 0 ), 0 );
+  QCOMPARE( attacking_store.getState( attacking_id ), QtD1::Actor::Attacking );
+  QCOMPARE( attacking_store.getDirection( attacking_id ), QtD1::South );
+
+  QCOMPARE( attacking_store.advance( QPointF( 0, 5 ), 0 ), 0 );
+  QCOMPARE( attacking_store.advance( QPointF( 0, 5 ), 0 ), 0 );
+  QCOMPARE( attacking_store.advance( QPointF( 0, 5 ), 0 ), 5 );
+  QCOMPARE( attacking_store.getState( attacking_id ), QtD1::Actor::Standing );
+}
+
+//---------------------------------------------------------------------------//
+// Check that monsters cannot walk onto blocked tiles
+void advance_grid()
+{
+  QtD1::LevelGrid grid( 4, 4 );
+
+  QtD1::MonsterStore store;
+  store.setMonsterTypes( createMonsterTypes( 30.0 ) );
+
+  const int id = store.spawn( 0, grid.mapFromTileCenter( QPoint( 0, 0 ) ) );
+
+  const QPointF target = grid.mapFromTileCenter( QPoint( 3, 0 ) );
+
+  grid.setFlags( 1, 0, QtD1::LevelGrid::BlocksWalking );
+
+  store.advance( target, 0, &grid );
+
+  QCOMPARE( store.getState( id ), QtD1::Actor::Standing );
+  QCOMPARE( store.getPosition( id ),
+            grid.mapFromTileCenter( QPoint( 0, 0 ) ) );
+
+  grid.setFlags( 1, 0, 0 );
+
+  store.advance( target, 0, &grid );
+
+  QCOMPARE( store.getState( id ), QtD1::Actor::Walking );
+  QCOMPARE( grid.mapToTile( store.getPosition( id ) ), QPoint( 1, 0 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that displacements are mapped to directions
+void getDirectionOfDisplacement()
+{
+  QCOMPARE( QtD1::MonsterStore::getDirectionOfDisplacement( 0, 1 ),
+            QtD1::South );
+  QCOMPARE( QtD1::MonsterStore::getDirectionOfDisplacement( -1, 0 ),
+            QtD1::West );
+  QCOMPARE( QtD1::MonsterStore::getDirectionOfDisplacement( 0, -1 ),
+            QtD1::North );
+  QCOMPARE( QtD1::MonsterStore::getDirectionOfDisplacement( 1, 0 ),
+            QtD1::East );
+  QCOMPARE( QtD1::MonsterStore::getDirectionOfDisplacement( 1, 1 ),
+            QtD1::Southeast );
+  QCOMPARE( QtD1::MonsterStore::getDirectionOfDisplacement( -1, -1 ),
+            QtD1::Northwest );
+}
+
+//---------------------------------------------------------------------------//
+// Check that monsters are only spawned on walkable tiles
+void populate()
+{
+  const QtD1::LevelGrid grid = createCathedralGrid();
+
+  QtD1::MonsterStore store;
+  store.setSeed( 42 );
+
+  const QVector<int> types( 1, store.findMonsterType( "Zombie" ) );
+
+  QCOMPARE( store.populate( grid, types, 200 ), 200 );
+  QCOMPARE( store.getNumberOfMonsters(), 200 );
+
+  for( int i = 0; i < store.getNumberOfMonsters(); ++i )
+  {
+    const QPoint tile =
+      grid.mapToTile( store.getPosition( store.getMonsterId( i ) ) );
+
+    QVERIFY( grid.isWalkable( tile.x(), tile.y() ) );
+  }
+
+  // A grid without walkable tiles cannot be populated
+  QtD1::LevelGrid blocked_grid( 2, 2 );
+
+  for( int i = 0; i < 4; ++i )
+    blocked_grid.setFlags( i % 2, i / 2, QtD1::LevelGrid::BlocksWalking );
+
+  QCOMPARE( store.populate( blocked_grid, types, 10 ), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check the cost of populating a cathedral level
+void populate_benchmark()
+{
+  const QtD1::LevelGrid grid = createCathedralGrid();
+
+  QtD1::MonsterStore store;
+
+  QVector<int> types;
+
+  for( int i = 0; i < store.getMonsterTypes().size(); ++i )
+    types << i;
+
+  QBENCHMARK{
+    store.clear();
+    store.populate( grid, types, 200 );
+  }
+
+  QCOMPARE( store.getNumberOfMonsters(), 200 );
+}
+
+//---------------------------------------------------------------------------//
+// Check the cost of advancing many monsters
+void advance_benchmark()
+{
+  const QtD1::LevelGrid grid = createCathedralGrid();
+
+  QtD1::MonsterStore store;
+
+  QVector<int> types;
+
+  for( int i = 0; i < store.getMonsterTypes().size(); ++i )
+    types << i;
+
+  store.populate( grid, types, 1000 );
+
+  const QPointF target = grid.mapFromTileCenter( QPoint( 56, 56 ) );
+
+  QBENCHMARK{
+    store.advance( target, 20, &grid );
+  }
+
+  QCOMPARE( store.getNumberOfMonsters(), 1000 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only the visible monsters are published
+void publish()
+{
+  QGraphicsScene scene;
+
+  QtD1::MonsterRenderer renderer( &scene );
+  renderer.setSprite( 0, QtD1::Actor::Standing, QtD1::South,
+                      QVector<QPixmap>( 2, QPixmap( 8, 8 ) ) );
+
+  QVERIFY( renderer.hasSprite( 0, QtD1::Actor::Standing, QtD1::South ) );
+  QVERIFY( !renderer.hasSprite( 0, QtD1::Actor::Walking, QtD1::South ) );
+
+  QtD1::MonsterStore store;
+  store.spawn( 0, QPointF( 10, 10 ) );
+  store.spawn( 0, QPointF( 20, 20 ) );
+  store.spawn( 0, QPointF( 500, 500 ) );
+
+  QCOMPARE( renderer.publish( store, QRectF( 0, 0, 100, 100 ) ), 2 );
+  QCOMPARE( renderer.getNumberOfProxies(), 2 );
+  QCOMPARE( scene.items().size(), 2 );
+
+  QCOMPARE( renderer.publish( store, QRectF( 0, 0, 1000, 1000 ) ), 3 );
+  QCOMPARE( renderer.getNumberOfProxies(), 3 );
+
+  // Unused proxies are hidden instead of deleted
+  QCOMPARE( renderer.publish( store, QRectF( -100, -100, 10, 10 ) ), 0 );
+  QCOMPARE( renderer.getNumberOfProxies(), 3 );
+  QCOMPARE( scene.items().size(), 3 );
+
+  for( int i = 0; i < scene.items().size(); ++i )
+    QVERIFY( !scene.items()[i]->isVisible() );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestMonsterStore )
+#include "tstMonsterStore.moc"
+
+//---------------------------------------------------------------------------//
+// end tstMonsterStore.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,216 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstParallelInitializer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The parallel initializer unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QStringList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+// QtD1 Includes
+#include "ParallelInitializer.h"
+#include "StartupProfiler.h"
+
+// The finished tasks
+QStringList finished_tasks;
+
+// The finished tasks mutex
+QMutex finished_tasks_mutex;
+
+// The semaphores used to check that tasks overlap
+QSemaphore task_a_started, task_b_started;
+
+// A helper for sleeping (QThread::msleep is protected in Qt4)
+class Sleeper : public QThread
+{
+public:
+  static void sleep( const unsigned long time )
+  { QThread::msleep( time ); }
+};
+
+// Record a finished task
+void recordFinishedTask( const QString& name )
+{
+  QMutexLocker locker( &finished_tasks_mutex );
+
+  finished_tasks << name;
+}
+
+// Slow task a
+void slowTaskA()
+{
+  Sleeper::sleep( 50 );
+
+  recordFinishedTask( "a" );
+}
+
+// Task b
+void taskB()
+{
+  recordFinishedTask( "b" );
+}
+
+// Task c
+void taskC()
+{
+  recordFinishedTask( "c" );
+}
+
+// Overlapping task a (waits for task b to start)
+void overlappingTaskA()
+{
+  task_a_started.release();
+
+  if( task_b_started.tryAcquire( 1, 5000 ) )
+    recordFinishedTask( "a" );
+}
+
+// Overlapping task b (waits for task a to start)
+void overlappingTaskB()
+{
+  task_b_started.release();
+
+  if( task_a_started.tryAcquire( 1, 5000 ) )
+    recordFinishedTask( "b" );
+}
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestParallelInitializer : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void init()
+  {
+    finished_tasks.clear();
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that all of the tasks are run
+void waitForFinished()
+{
+  QtD1::ParallelInitializer initializer;
+
+  initializer.addTask( "a", &slowTaskA );
+  initializer.addTask( "b", &taskB );
+  initializer.addTask( "c", &taskC );
+
+  QCOMPARE( initializer.getNumberOfTasks(), 3 );
+  QVERIFY( !initializer.isFinished() );
+
+  initializer.waitForFinished();
+
+  QVERIFY( initializer.isFinished() );
+  QCOMPARE( initializer.getNumberOfFinishedTasks(), 3 );
+  QCOMPARE( finished_tasks.size(), 3 );
+  QVERIFY( finished_tasks.contains( "a" ) );
+  QVERIFY( finished_tasks.contains( "b" ) );
+  QVERIFY( finished_tasks.contains( "c" ) );
+
+  // An initializer without tasks is finished once it has been started
+  QtD1::ParallelInitializer empty_initializer;
+
+  empty_initializer.waitForFinished();
+
+  QVERIFY( empty_initializer.isFinished() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a task is only run after its dependencies have finished
+void addTask_dependencies()
+{
+  QtD1::ParallelInitializer initializer;
+
+  initializer.addTask( "a", &slowTaskA );
+  initializer.addTask( "b", &taskB, QStringList() << "a" );
+  initializer.addTask( "c", &taskC, QStringList() << "a" << "b" );
+
+  initializer.start();
+  initializer.waitForFinished();
+
+  QCOMPARE( finished_tasks, QStringList() << "a" << "b" << "c" );
+}
+
+//---------------------------------------------------------------------------//
+// Check that independent tasks are run at the same time
+void start_overlap()
+{
+  if( QThreadPool::globalInstance()->maxThreadCount() < 2 )
+    QSKIP( "At least two worker threads are required", SkipSingle );
+
+  QtD1::ParallelInitializer initializer;
+
+  initializer.addTask( "a", &overlappingTaskA );
+  initializer.addTask( "b", &overlappingTaskB );
+
+  initializer.waitForFinished();
+
+  QCOMPARE( finished_tasks.size(), 2 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the tasks are recorded as startup phases
+void start_profiled()
+{
+  QtD1::StartupProfiler* profiler = QtD1::StartupProfiler::getInstance();
+
+  profiler->restart();
+
+  {
+    QtD1::ParallelInitializer initializer;
+
+    initializer.addTask( "a", &slowTaskA );
+    initializer.addTask( "b", &taskB, QStringList() << "a" );
+
+    initializer.waitForFinished();
+  }
+
+  QList<QtD1::StartupProfiler::Phase> phases = profiler->getPhases();
+
+  QCOMPARE( phases.size(), 2 );
+  QCOMPARE( phases[0].name, QString( "a" ) );
+  QCOMPARE( phases[1].name, QString( "b" ) );
+  QVERIFY( phases[0].worker_thread );
+  QVERIFY( phases[0].duration >= 40 );
+  QVERIFY( phases[1].start_time >= phases[0].start_time +
+           phases[0].duration );
+  QVERIFY( profiler->getTotalPhaseTime() >= phases[0].duration );
+
+  // Phases on the calling thread are recorded too
+  {
+    QtD1::StartupProfiler::ScopedPhase phase( "c" );
+  }
+
+  phases = profiler->getPhases();
+
+  QCOMPARE( phases.size(), 3 );
+  QCOMPARE( phases.back().name, QString( "c" ) );
+  QVERIFY( !phases.back().worker_thread );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestParallelInitializer )
+#include "tstParallelInitializer.moc"
+
+//---------------------------------------------------------------------------//
+// end tstParallelInitializer.cpp
+//---------------------------------------------------------------------------//
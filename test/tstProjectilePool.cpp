@@ -0,0 +1,209 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstProjectilePool.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The projectile pool unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+
+// QtD1 Includes
+#include "ProjectilePool.h"
+
+//---------------------------------------------------------------------------//
+// Test helpers.
+//---------------------------------------------------------------------------//
+// Create spawn parameters
+QtD1::ProjectilePool::SpawnParameters createSpawnParameters(
+                                                     const QPointF& position,
+                                                     const QPointF& velocity,
+                                                     const int lifetime )
+{
+  QtD1::ProjectilePool::SpawnParameters parameters =
+    {position, velocity, lifetime, 0, 1, 2, 3, 4, NULL};
+
+  return parameters;
+}
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestProjectilePool : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that projectiles can be spawned and despawned
+void spawn_despawn()
+{
+  QtD1::ProjectilePool pool( 4 );
+  pool.registerSprite( QVector<QPixmap>( 1, QPixmap( 8, 8 ) ) );
+
+  const int first_id = pool.spawn(
+       createSpawnParameters( QPointF( 10, 10 ), QPointF( 1, 0 ), 10 ) );
+  const int second_id = pool.spawn(
+       createSpawnParameters( QPointF( 20, 20 ), QPointF( 0, 1 ), 10 ) );
+
+  QCOMPARE( pool.getNumberOfProjectiles(), 2 );
+  QVERIFY( pool.isAlive( first_id ) );
+  QVERIFY( pool.isAlive( second_id ) );
+  QCOMPARE( pool.getPosition( second_id ), QPointF( 20, 20 ) );
+  QCOMPARE( pool.getDamage( first_id ).base, 1 );
+  QCOMPARE( pool.getDamage( first_id ).lightning, 4 );
+
+  pool.despawn( first_id );
+
+  QCOMPARE( pool.getNumberOfProjectiles(), 1 );
+  QVERIFY( !pool.isAlive( first_id ) );
+  QCOMPARE( pool.getPosition( second_id ), QPointF( 20, 20 ) );
+
+  // The despawned id is recycled without growing the pool
+  const int third_id = pool.spawn(
+       createSpawnParameters( QPointF( 30, 30 ), QPointF( 0, 0 ), 10 ) );
+
+  QCOMPARE( third_id, first_id );
+  QCOMPARE( pool.getCapacity(), 4 );
+
+  pool.clear();
+
+  QCOMPARE( pool.getNumberOfProjectiles(), 0 );
+  QVERIFY( !pool.isAlive( second_id ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the pool grows when it is full
+void grow()
+{
+  QtD1::ProjectilePool pool( 2 );
+  pool.registerSprite( QVector<QPixmap>( 1, QPixmap( 8, 8 ) ) );
+
+  QSet<int> ids;
+
+  for( int i = 0; i < 5; ++i )
+  {
+    ids << pool.spawn(
+       createSpawnParameters( QPointF( i, i ), QPointF( 0, 0 ), 10 ) );
+  }
+
+  QCOMPARE( ids.size(), 5 );
+  QCOMPARE( pool.getNumberOfProjectiles(), 5 );
+  QCOMPARE( pool.getCapacity(), 8 );
+
+  QSet<int>::const_iterator id_it = ids.begin();
+
+  while( id_it != ids.end() )
+  {
+    QVERIFY( pool.isAlive( *id_it ) );
+
+    ++id_it;
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that projectiles move and expire
+void advance()
+{
+  QtD1::ProjectilePool pool;
+  pool.registerSprite( QVector<QPixmap>( 1, QPixmap( 8, 8 ) ) );
+
+  const int short_id = pool.spawn(
+       createSpawnParameters( QPointF( 0, 0 ), QPointF( 2, 1 ), 1 ) );
+  const int long_id = pool.spawn(
+       createSpawnParameters( QPointF( 0, 0 ), QPointF( 1, 2 ), 3 ) );
+
+  QCOMPARE( pool.advance(), 1 );
+  QVERIFY( !pool.isAlive( short_id ) );
+  QCOMPARE( pool.getPosition( long_id ), QPointF( 1, 2 ) );
+  QCOMPARE( pool.getRemainingLifetime( long_id ), 2 );
+
+  QCOMPARE( pool.getBoundingRect(), QRectF( -3, -2, 8, 8 ) );
+
+  QCOMPARE( pool.advance(), 0 );
+  QCOMPARE( pool.advance(), 1 );
+  QCOMPARE( pool.getNumberOfProjectiles(), 0 );
+  QVERIFY( pool.getBoundingRect().isNull() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that projectiles expire on tiles that block missiles
+void advance_grid()
+{
+  QtD1::LevelGrid grid( 4, 4 );
+  grid.setFlags( 2, 1, QtD1::LevelGrid::BlocksMissiles );
+
+  QtD1::ProjectilePool pool;
+  pool.registerSprite( QVector<QPixmap>( 1, QPixmap( 8, 8 ) ) );
+
+  const QPointF step = grid.mapFromTileCenter( QPoint( 1, 1 ) ) -
+    grid.mapFromTileCenter( QPoint( 0, 1 ) );
+
+  const int id = pool.spawn(
+       createSpawnParameters( grid.mapFromTileCenter( QPoint( 0, 1 ) ),
+                              step,
+                              100 ) );
+
+  QCOMPARE( pool.advance( &grid ), 0 );
+  QVERIFY( pool.isAlive( id ) );
+
+  QCOMPARE( pool.advance( &grid ), 1 );
+  QVERIFY( !pool.isAlive( id ) );
+
+  // Projectiles that leave the grid expire
+  pool.spawn( createSpawnParameters( grid.mapFromTileCenter( QPoint( 0, 0 ) ),
+                                     -step,
+                                     100 ) );
+
+  QCOMPARE( pool.advance( &grid ), 1 );
+}
+
+//---------------------------------------------------------------------------//
+// Check the cost of advancing many projectiles
+void advance_benchmark()
+{
+  QtD1::ProjectilePool pool;
+  pool.registerSprite( QVector<QPixmap>( 1, QPixmap( 8, 8 ) ) );
+
+  for( int i = 0; i < 1000; ++i )
+  {
+    pool.spawn( createSpawnParameters( QPointF( i, i ),
+                                       QPointF( (i % 7) - 3, (i % 5) - 2 ),
+                                       (i % 50) + 1 ) );
+  }
+
+  QBENCHMARK{
+    pool.advance();
+
+    // Keep the pool full
+    while( pool.getNumberOfProjectiles() < 1000 )
+    {
+      const int i = pool.getNumberOfProjectiles();
+
+      pool.spawn( createSpawnParameters( QPointF( i, i ),
+                                         QPointF( (i % 7) - 3, (i % 5) - 2 ),
+                                         (i % 50) + 1 ) );
+    }
+  }
+
+  QCOMPARE( pool.getNumberOfProjectiles(), 1000 );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestProjectilePool )
+#include "tstProjectilePool.moc"
+
+//---------------------------------------------------------------------------//
+// end tstProjectilePool.cpp
+//---------------------------------------------------------------------------//
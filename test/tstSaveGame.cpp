@@ -0,0 +1,475 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstSaveGame.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The save game unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+// QtD1 Includes
+#include "SaveGameState.h"
+#include "SaveGameFile.h"
+#include "SaveGameWriter.h"
+#include "WarriorData.h"
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestSaveGame : public QObject
+{
+  Q_OBJECT
+
+private:
+
+  // The save game file name
+  QString t_file_name;
+
+  // A state with a full inventory and a fully explored map
+  QtD1::SaveGameState t_full_state;
+
+  // Create a state with a full inventory and a fully explored map
+  QtD1::SaveGameState createFullState()
+  {
+    QtD1::SaveGameState state;
+
+    QtD1::SaveGameState::CharacterState character_state;
+    character_state.name = "Aidan";
+    character_state.type = 2;
+    character_state.level = 30;
+    character_state.experience = 1583495;
+    character_state.gold = 51000;
+    character_state.strength = 250;
+    character_state.magic = 50;
+    character_state.dexterity = 60;
+    character_state.vitality = 100;
+    character_state.health = 240;
+    character_state.mana = 20;
+    character_state.level_number = 0;
+    character_state.position = QPointF( 3250.5, 2450.25 );
+    character_state.direction = 4;
+
+    state.setCharacterState( character_state );
+
+    // The body slots, the inventory grid and the belt are all filled
+    QVector<QtD1::SaveGameState::ItemState> items;
+
+    for( int i = 0; i < 7+40+8; ++i )
+    {
+      QtD1::SaveGameState::ItemState item;
+      item.item_id = 100+i;
+      item.location = i < 7 ? QtD1::SaveGameState::BodyItemLocation :
+        (i < 47 ? QtD1::SaveGameState::GridItemLocation :
+         QtD1::SaveGameState::BeltItemLocation);
+      item.slot = i < 7 ? i : (i < 47 ? i-7 : i-47);
+      item.durability = 30+i;
+      item.max_durability = 60;
+      item.seed = 0xDEAD0000+i;
+
+      items << item;
+    }
+
+    state.setItems( items );
+
+    for( int i = 0; i < QtD1::SaveGameState::s_number_of_quests; ++i )
+    {
+      QtD1::SaveGameState::QuestState quest_state;
+      quest_state.status = QtD1::SaveGameState::QuestCompleted;
+      quest_state.progress = i;
+
+      state.setQuestState( (QtD1::Quest::Type)i, quest_state );
+    }
+
+    // The town and all 16 dungeon levels have been explored
+    for( int i = 0; i <= 16; ++i )
+    {
+      QtD1::SaveGameState::LevelState level_state;
+      level_state.explored_squares = QBitArray( 112*112, true );
+      level_state.killed_monsters = QBitArray( 200, true );
+      level_state.used_objects = QBitArray( 127, true );
+
+      state.setLevelState( i, level_state );
+    }
+
+    return state;
+  }
+
+  // Change the character gold
+  QtD1::SaveGameState changeGold( const QtD1::SaveGameState& state,
+                                  const int gold )
+  {
+    QtD1::SaveGameState changed_state = state;
+
+    QtD1::SaveGameState::CharacterState character_state =
+      state.getCharacterState();
+    character_state.gold = gold;
+
+    changed_state.setCharacterState( character_state );
+
+    return changed_state;
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    t_file_name = QDir::temp().filePath( "tstSaveGame.sav" );
+    t_full_state = this->createFullState();
+  }
+
+  void cleanup()
+  {
+    QFile::remove( t_file_name );
+    QFile::remove( t_file_name + QtD1::SaveGameFile::s_temp_file_suffix );
+    QFile::remove( t_file_name + QtD1::SaveGameFile::s_backup_file_suffix );
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that a full save can be read back
+void saveSync()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  QVERIFY( writer.saveSync( t_full_state ) );
+  QCOMPARE( writer.getNumberOfRecordsWritten(), 3+17 );
+  QCOMPARE( writer.getFileSize(), QFileInfo( t_file_name ).size() );
+
+  QtD1::SaveGameState state;
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == t_full_state );
+}
+
+//---------------------------------------------------------------------------//
+// Check that an incremental save only appends the changed sections
+void saveIncrementalSync()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  // The first incremental save is a full save
+  QVERIFY( writer.saveIncrementalSync( t_full_state ) );
+  QCOMPARE( writer.getNumberOfRecordsWritten(), 3+17 );
+
+  const qint64 full_file_size = writer.getFileSize();
+
+  QtD1::SaveGameState changed_state = this->changeGold( t_full_state, 10 );
+
+  QVERIFY( writer.saveIncrementalSync( changed_state ) );
+  QCOMPARE( writer.getNumberOfRecordsWritten(), 1 );
+  QVERIFY( writer.getFileSize() > full_file_size );
+  QVERIFY( writer.getFileSize() < full_file_size + 100 );
+
+  QtD1::SaveGameState state;
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == changed_state );
+
+  // Nothing is written if nothing has changed
+  QVERIFY( writer.saveIncrementalSync( changed_state ) );
+  QCOMPARE( writer.getNumberOfRecordsWritten(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the file is compacted once it grows too large
+void saveIncrementalSync_compaction()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  QVERIFY( writer.saveSync( t_full_state ) );
+
+  const qint64 full_file_size = writer.getFileSize();
+
+  QtD1::SaveGameState state = t_full_state;
+
+  for( int i = 0; i < 100; ++i )
+  {
+    // Explore a level a bit more
+    QtD1::SaveGameState::LevelState level_state = state.getLevelState( 1 );
+    level_state.explored_squares.setBit( i, false );
+
+    state.setLevelState( 1, level_state );
+
+    QVERIFY( writer.saveIncrementalSync( state ) );
+    QVERIFY( writer.getFileSize() <=
+             (QtD1::SaveGameWriter::s_compaction_factor+1)*full_file_size );
+  }
+
+  QtD1::SaveGameState read_state;
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, read_state ) );
+  QVERIFY( read_state == state );
+}
+
+//---------------------------------------------------------------------------//
+// Check that saves are written off the calling thread
+void save()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  QSignalSpy save_started_spy( &writer, SIGNAL(saveStarted()) );
+  QSignalSpy save_finished_spy( &writer, SIGNAL(saveFinished(const bool)) );
+
+  writer.save( t_full_state );
+
+  // The saves requested while a save is being written are deferred and
+  // only the most recent state is written
+  writer.saveIncremental( this->changeGold( t_full_state, 1 ) );
+  writer.saveIncremental( this->changeGold( t_full_state, 2 ) );
+
+  QVERIFY( writer.isSaving() );
+
+  writer.waitForSaveToFinish();
+
+  QVERIFY( !writer.isSaving() );
+  QCOMPARE( save_started_spy.count(), 2 );
+  QCOMPARE( save_finished_spy.count(), 2 );
+  QVERIFY( save_finished_spy.at( 1 ).at( 0 ).toBool() );
+
+  QtD1::SaveGameState state;
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == this->changeGold( t_full_state, 2 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that an interrupted append is ignored
+void read_truncated()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  QVERIFY( writer.saveSync( t_full_state ) );
+
+  const qint64 full_file_size = writer.getFileSize();
+
+  QVERIFY( writer.saveIncrementalSync( this->changeGold( t_full_state, 7 ) ) );
+
+  {
+    QFile file( t_file_name );
+    QVERIFY( file.resize( writer.getFileSize()-1 ) );
+  }
+
+  QtD1::SaveGameState state;
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == t_full_state );
+
+  // A corrupt record is ignored too
+  {
+    QFile file( t_file_name );
+    QVERIFY( file.resize( full_file_size ) );
+    QVERIFY( file.open( QIODevice::Append ) );
+
+    QByteArray record = QtD1::SaveGameFile::createRecord(
+         QtD1::SaveGameFile::getRecordId( QtD1::SaveGameFile::ItemSection ),
+         QByteArray( 4, 0 ) );
+    record[record.size()-1] = record[record.size()-1]+1;
+
+    file.write( record );
+  }
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == t_full_state );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a full save that was interrupted while replacing the file can
+// still be read
+void read_interruptedReplace()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  QVERIFY( writer.saveSync( t_full_state ) );
+
+  // The old save has been backed up but the new save has not replaced it
+  const QString backup_file_name =
+    t_file_name + QtD1::SaveGameFile::s_backup_file_suffix;
+
+  QVERIFY( QFile::rename( t_file_name, backup_file_name ) );
+
+  QtD1::SaveGameState state;
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == t_full_state );
+
+  // The new save is preferred over the old save
+  QVERIFY( QFile::copy( backup_file_name,
+                        t_file_name +
+                        QtD1::SaveGameFile::s_temp_file_suffix ) );
+
+  {
+    QFile file( backup_file_name );
+    QVERIFY( file.resize( QtD1::SaveGameFile::s_header_size ) );
+  }
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == t_full_state );
+
+  // The next full save replaces the files
+  QVERIFY( writer.saveSync( this->changeGold( t_full_state, 3 ) ) );
+
+  QVERIFY( QFile::exists( t_file_name ) );
+  QVERIFY( !QFile::exists( backup_file_name ) );
+  QVERIFY( !QFile::exists( t_file_name +
+                           QtD1::SaveGameFile::s_temp_file_suffix ) );
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( state == this->changeGold( t_full_state, 3 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a restored character has the max health and mana of its level
+void saveSync_restoreCharacter()
+{
+  QtD1::WarriorData character_data( "Aidan" );
+  character_data.setLevel( 20 );
+  character_data.setBaseStrength( 60 );
+  character_data.setBaseMagic( 20 );
+  character_data.setBaseDexterity( 40 );
+  character_data.setBaseVitality( 80 );
+  character_data.recalculateDerivedStats();
+
+  // The warrior base health and mana formulas
+  QCOMPARE( character_data.getMaxHealth(), 2*80 + 2*20 + 18 );
+  QCOMPARE( character_data.getMaxMana(), 20 + 20 - 1 );
+
+  character_data.setHealth( 200 );
+  character_data.setMana( 35 );
+
+  QtD1::SaveGameState::CharacterState character_state =
+    t_full_state.getCharacterState();
+  character_data.saveState( character_state );
+
+  QtD1::SaveGameState state = t_full_state;
+  state.setCharacterState( character_state );
+
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  QVERIFY( writer.saveSync( state ) );
+
+  QtD1::SaveGameState read_state;
+
+  QVERIFY( QtD1::SaveGameFile::read( t_file_name, read_state ) );
+
+  QtD1::WarriorData restored_character_data( "Aidan" );
+  restored_character_data.restoreState( read_state.getCharacterState() );
+
+  QCOMPARE( restored_character_data.getLevel(), 20 );
+  QCOMPARE( restored_character_data.getMaxHealth(),
+            character_data.getMaxHealth() );
+  QCOMPARE( restored_character_data.getMaxMana(),
+            character_data.getMaxMana() );
+  QCOMPARE( restored_character_data.getHealth(), 200 );
+  QCOMPARE( restored_character_data.getMana(), 35 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that invalid files are rejected
+void parse_invalid()
+{
+  QtD1::SaveGameState state;
+
+  QVERIFY( !QtD1::SaveGameFile::read( t_file_name, state ) );
+  QVERIFY( !QtD1::SaveGameFile::parse( QByteArray(), state ) );
+
+  QByteArray data = QtD1::SaveGameFile::createHeader();
+
+  // There is no character section
+  QVERIFY( !QtD1::SaveGameFile::parse( data, state ) );
+
+  // The magic number is wrong
+  data[0] = 'X';
+  QVERIFY( !QtD1::SaveGameFile::parse( data, state ) );
+
+  // The version is newer than this version
+  data = QtD1::SaveGameFile::createHeader();
+  data[4] = QtD1::SaveGameFile::s_version+1;
+  QVERIFY( !QtD1::SaveGameFile::parse( data, state ) );
+
+  // Unknown sections are skipped
+  QtD1::SaveGameState saved_state = this->changeGold( state, 5 );
+
+  QHash<quint32,QByteArray> sections =
+    QtD1::SaveGameFile::serializeSections( saved_state );
+
+  data = QtD1::SaveGameFile::createHeader();
+  data += QtD1::SaveGameFile::createRecord( 0xFF0000, QByteArray( 9, 1 ) );
+  data += QtD1::SaveGameFile::createRecord(
+    QtD1::SaveGameFile::getRecordId( QtD1::SaveGameFile::CharacterSection ),
+    sections[QtD1::SaveGameFile::getRecordId(
+                                 QtD1::SaveGameFile::CharacterSection )] );
+
+  QVERIFY( QtD1::SaveGameFile::parse( data, state ) );
+  QVERIFY( state == saved_state );
+}
+
+//---------------------------------------------------------------------------//
+// Check the full save latency
+void saveSync_benchmark()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+
+  QBENCHMARK{
+    writer.saveSync( t_full_state );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check the incremental save latency
+void saveIncrementalSync_benchmark()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+  writer.saveSync( t_full_state );
+
+  int gold = 0;
+
+  QBENCHMARK{
+    writer.saveIncrementalSync( this->changeGold( t_full_state, ++gold ) );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check the load latency
+void read_benchmark()
+{
+  QtD1::SaveGameWriter writer;
+  writer.setFileName( t_file_name );
+  writer.saveSync( t_full_state );
+
+  QBENCHMARK{
+    QtD1::SaveGameState state;
+
+    QtD1::SaveGameFile::read( t_file_name, state );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestSaveGame )
+#include "tstSaveGame.moc"
+
+//---------------------------------------------------------------------------//
+// end tstSaveGame.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,154 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstSimulationClock.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The simulation clock unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+
+// QtD1 Includes
+#include "SimulationClock.h"
+
+// The number of nanoseconds in a millisecond
+const qint64 ns_per_ms = 1000000;
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestSimulationClock : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the clock can be constructed
+void constructor()
+{
+  QtD1::SimulationClock clock( 33, 4 );
+
+  QCOMPARE( clock.getTickDuration(), 33 );
+  QCOMPARE( clock.getMaxCatchUpTicks(), 4 );
+  QVERIFY( !clock.isRunning() );
+  QCOMPARE( clock.getNumberOfTicks(), (qint64)0 );
+  QCOMPARE( clock.getNumberOfFrames(), (qint64)0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the clock can be started and stopped
+void start_stop()
+{
+  QtD1::SimulationClock clock( 33 );
+
+  clock.start();
+
+  QVERIFY( clock.isRunning() );
+
+  clock.stop();
+
+  QVERIFY( !clock.isRunning() );
+  QCOMPARE( clock.startFrame(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the elapsed time is handed out in fixed ticks
+void startFrame()
+{
+  QtD1::SimulationClock clock( 30 );
+
+  clock.start();
+
+  // Frames faster than the tick duration accumulate time
+  QCOMPARE( clock.startFrame( 10*ns_per_ms ), 0 );
+  QCOMPARE( clock.getInterpolationFraction(), 1.0/3 );
+  QCOMPARE( clock.startFrame( 10*ns_per_ms ), 0 );
+  QCOMPARE( clock.startFrame( 10*ns_per_ms ), 1 );
+  QCOMPARE( clock.getInterpolationFraction(), 0.0 );
+
+  // Slow frames catch up on the missed ticks
+  QCOMPARE( clock.startFrame( 75*ns_per_ms ), 2 );
+  QCOMPARE( clock.getInterpolationFraction(), 0.5 );
+
+  QCOMPARE( clock.getNumberOfFrames(), (qint64)4 );
+  QCOMPARE( clock.getNumberOfDroppedTicks(), (qint64)0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the number of catch-up ticks is limited
+void startFrame_catch_up_limit()
+{
+  QtD1::SimulationClock clock( 10, 3 );
+
+  clock.start();
+
+  QCOMPARE( clock.startFrame( 105*ns_per_ms ), 3 );
+  QCOMPARE( clock.getNumberOfDroppedTicks(), (qint64)7 );
+  QCOMPARE( clock.getInterpolationFraction(), 0.5 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that restarting the clock discards the accumulated time
+void start_discards_accumulated_time()
+{
+  QtD1::SimulationClock clock( 30 );
+
+  clock.start();
+
+  clock.startFrame( 20*ns_per_ms );
+
+  clock.stop();
+  clock.start();
+
+  QCOMPARE( clock.getInterpolationFraction(), 0.0 );
+  QCOMPARE( clock.startFrame( 20*ns_per_ms ), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the ticks can be timed
+void startTick_finishTick()
+{
+  QtD1::SimulationClock clock( 30 );
+
+  clock.startTick();
+  clock.finishTick();
+  clock.startTick();
+  clock.finishTick();
+
+  QCOMPARE( clock.getNumberOfTicks(), (qint64)2 );
+  QVERIFY( clock.getAverageTickTime() >= 0.0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the frame rate is estimated from the frame times
+void getFrameRate()
+{
+  QtD1::SimulationClock clock( 10 );
+
+  clock.start();
+
+  for( int i = 0; i < 200; ++i )
+    clock.startFrame( 5*ns_per_ms );
+
+  QVERIFY( qAbs( clock.getAverageFrameTime() - 5.0 ) < 1e-6 );
+  QVERIFY( qAbs( clock.getFrameRate() - 200.0 ) < 1e-3 );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestSimulationClock )
+#include "tstSimulationClock.moc"
+
+//---------------------------------------------------------------------------//
+// end tstSimulationClock.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,306 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstSoftwareMixer.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The software mixer unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QVector>
+
+// QtD1 Includes
+#include "SoftwareMixer.h"
+#include "MixerSample.h"
+#include "MPQHandler.h"
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestSoftwareMixer : public QObject
+{
+  Q_OBJECT
+
+private:
+
+  // Create a sample with a constant value
+  QtD1::SoftwareMixer::SampleHandle createSample( const int number_of_frames,
+                                                  const Sint16 value )
+  {
+    const int number_of_channels =
+      QtD1::SoftwareMixer::getInstance()->getNumberOfChannels();
+
+    return QtD1::SoftwareMixer::SampleHandle(
+         new QtD1::MixerSample(
+                    QVector<Sint16>( number_of_frames*number_of_channels,
+                                     value ),
+                    number_of_channels ) );
+  }
+
+  // Mix a number of frames into a silent buffer
+  QVector<Sint16> mixFrames( const int number_of_frames )
+  {
+    QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+    QVector<Sint16> samples( number_of_frames*mixer->getNumberOfChannels(),
+                             0 );
+
+    mixer->mix( samples.data(), number_of_frames );
+
+    return samples;
+  }
+
+  // Check if every sample has a value
+  bool hasValue( const QVector<Sint16>& samples,
+                 const int first_sample,
+                 const int number_of_samples,
+                 const Sint16 value )
+  {
+    for( int i = first_sample; i < first_sample+number_of_samples; ++i )
+    {
+      if( samples[i] != value )
+        return false;
+    }
+
+    return true;
+  }
+
+private slots:
+
+  void initTestCase()
+  {
+    QtD1::MPQHandler::getInstance();
+  }
+
+  void cleanup()
+  {
+    QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+    mixer->stopAll();
+    this->mixFrames( 1 );
+
+    mixer->setBusVolume( QtD1::SoftwareMixer::MusicBus, MIX_MAX_VOLUME );
+    mixer->setBusVolume( QtD1::SoftwareMixer::EffectBus, MIX_MAX_VOLUME );
+    mixer->setBusVolume( QtD1::SoftwareMixer::VoiceBus, MIX_MAX_VOLUME );
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that a wav file can be converted to the mixer format
+void constructor_file()
+{
+  QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+  QtD1::MixerSample sample( "/sfx/items/titlemov.wav",
+                            mixer->getFrequency(),
+                            mixer->getNumberOfChannels() );
+
+  QCOMPARE( sample.getNumberOfChannels(), mixer->getNumberOfChannels() );
+  QVERIFY( sample.getNumberOfFrames() > 0 );
+  QVERIFY( sample.getSamples() != NULL );
+
+  // Check that a missing file cannot be converted
+  bool exception_thrown = false;
+
+  try{
+    QtD1::MixerSample missing_sample( "/sfx/items/dummy.wav",
+                                      mixer->getFrequency(),
+                                      mixer->getNumberOfChannels() );
+  }
+  catch( const std::exception& exception )
+  {
+    exception_thrown = true;
+  }
+
+  QVERIFY( exception_thrown );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a voice can be mixed
+void mix()
+{
+  QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+  const int number_of_channels = mixer->getNumberOfChannels();
+
+  const int voice_id = mixer->play( this->createSample( 100, 1000 ),
+                                    QtD1::SoftwareMixer::EffectBus,
+                                    0.5f );
+
+  QVERIFY( voice_id >= 0 );
+
+  QVector<Sint16> samples = this->mixFrames( 60 );
+
+  QVERIFY( this->hasValue( samples, 0, 60*number_of_channels, 500 ) );
+  QCOMPARE( mixer->getNumberOfPlayingVoices(), 1 );
+
+  // The voice finishes part way through the buffer
+  samples = this->mixFrames( 60 );
+
+  QVERIFY( this->hasValue( samples, 0, 40*number_of_channels, 500 ) );
+  QVERIFY( this->hasValue( samples,
+                           40*number_of_channels,
+                           20*number_of_channels,
+                           0 ) );
+  QCOMPARE( mixer->getNumberOfPlayingVoices(), 0 );
+
+  // Voices are added to the samples that are already in the buffer
+  mixer->play( this->createSample( 10, 1000 ),
+               QtD1::SoftwareMixer::VoiceBus );
+
+  samples.fill( 100 );
+
+  mixer->mix( samples.data(), 10 );
+
+  QVERIFY( this->hasValue( samples, 0, 10*number_of_channels, 1100 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the mixed samples are saturated
+void mix_saturation()
+{
+  QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+  const int number_of_channels = mixer->getNumberOfChannels();
+
+  mixer->play( this->createSample( 10, 30000 ),
+               QtD1::SoftwareMixer::EffectBus );
+  mixer->play( this->createSample( 10, 30000 ),
+               QtD1::SoftwareMixer::VoiceBus );
+
+  QVector<Sint16> samples = this->mixFrames( 10 );
+
+  QVERIFY( this->hasValue( samples, 0, 10*number_of_channels, 32767 ) );
+
+  mixer->play( this->createSample( 10, -30000 ),
+               QtD1::SoftwareMixer::EffectBus );
+  mixer->play( this->createSample( 10, -30000 ),
+               QtD1::SoftwareMixer::EffectBus );
+
+  samples = this->mixFrames( 10 );
+
+  QVERIFY( this->hasValue( samples, 0, 10*number_of_channels, -32768 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the bus volumes can be set
+void setBusVolume()
+{
+  QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+  const int number_of_channels = mixer->getNumberOfChannels();
+
+  mixer->setBusVolume( QtD1::SoftwareMixer::EffectBus, MIX_MAX_VOLUME/2 );
+  mixer->setBusVolume( QtD1::SoftwareMixer::VoiceBus, 0 );
+  mixer->setBusVolume( QtD1::SoftwareMixer::MusicBus, 2*MIX_MAX_VOLUME );
+
+  QCOMPARE( mixer->getBusVolume( QtD1::SoftwareMixer::EffectBus ),
+            MIX_MAX_VOLUME/2 );
+  QCOMPARE( mixer->getBusVolume( QtD1::SoftwareMixer::VoiceBus ), 0 );
+  QCOMPARE( mixer->getBusVolume( QtD1::SoftwareMixer::MusicBus ),
+            MIX_MAX_VOLUME );
+
+  mixer->play( this->createSample( 10, 1000 ),
+               QtD1::SoftwareMixer::EffectBus );
+  mixer->play( this->createSample( 10, 1000 ),
+               QtD1::SoftwareMixer::VoiceBus );
+
+  QVector<Sint16> samples = this->mixFrames( 10 );
+
+  QVERIFY( this->hasValue( samples, 0, 10*number_of_channels, 500 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that voices can be stopped
+void stop()
+{
+  QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+  const int number_of_channels = mixer->getNumberOfChannels();
+
+  const int effect_voice_id =
+    mixer->play( this->createSample( 100, 1000 ),
+                 QtD1::SoftwareMixer::EffectBus );
+  mixer->play( this->createSample( 100, 100 ),
+               QtD1::SoftwareMixer::VoiceBus );
+  mixer->play( this->createSample( 100, 10 ),
+               QtD1::SoftwareMixer::VoiceBus );
+
+  this->mixFrames( 10 );
+
+  QCOMPARE( mixer->getNumberOfPlayingVoices(), 3 );
+
+  mixer->stop( effect_voice_id );
+
+  QVector<Sint16> samples = this->mixFrames( 10 );
+
+  QVERIFY( this->hasValue( samples, 0, 10*number_of_channels, 110 ) );
+  QCOMPARE( mixer->getNumberOfPlayingVoices(), 2 );
+
+  mixer->stopBus( QtD1::SoftwareMixer::VoiceBus );
+
+  samples = this->mixFrames( 10 );
+
+  QVERIFY( this->hasValue( samples, 0, 10*number_of_channels, 0 ) );
+  QCOMPARE( mixer->getNumberOfPlayingVoices(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that sounds are dropped when every voice is busy
+void play_dropped()
+{
+  QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+  QtD1::SoftwareMixer::SampleHandle sample = this->createSample( 100, 1 );
+
+  const int dropped_sounds = mixer->getNumberOfDroppedSounds();
+
+  for( int i = 0; i < QtD1::SoftwareMixer::s_max_number_of_voices+1; ++i )
+    QVERIFY( mixer->play( sample, QtD1::SoftwareMixer::EffectBus ) >= 0 );
+
+  this->mixFrames( 10 );
+
+  QCOMPARE( mixer->getNumberOfPlayingVoices(),
+            QtD1::SoftwareMixer::s_max_number_of_voices );
+  QCOMPARE( mixer->getNumberOfDroppedSounds(), dropped_sounds+1 );
+}
+
+//---------------------------------------------------------------------------//
+// Check the mixing performance
+void mix_benchmark()
+{
+  QtD1::SoftwareMixer* mixer = QtD1::SoftwareMixer::getInstance();
+
+  QtD1::SoftwareMixer::SampleHandle sample =
+    this->createSample( 1 << 21, 100 );
+
+  for( int i = 0; i < 32; ++i )
+  {
+    mixer->play( sample,
+                 i % 2 == 0 ? QtD1::SoftwareMixer::EffectBus :
+                 QtD1::SoftwareMixer::VoiceBus );
+  }
+
+  QVector<Sint16> samples( 2048*mixer->getNumberOfChannels(), 0 );
+
+  QBENCHMARK{
+    mixer->mix( samples.data(), 2048 );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestSoftwareMixer )
+#include "tstSoftwareMixer.moc"
+
+//---------------------------------------------------------------------------//
+// end tstSoftwareMixer.cpp
+//---------------------------------------------------------------------------//
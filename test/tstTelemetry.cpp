@@ -0,0 +1,267 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstTelemetry.cpp
+//! \author Alex Robinson, Sean Robinson
+//! \brief  The telemetry unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <sstream>
+
+// Qt Includes
+#include <QtTest/QtTest>
+#include <QThread>
+
+// QtD1 Includes
+#include "Telemetry.h"
+
+// A helper for sleeping (QThread::msleep is protected in Qt4)
+class Sleeper : public QThread
+{
+public:
+  static void sleep( const unsigned long time )
+  { QThread::msleep( time ); }
+};
+
+// A thread that updates the telemetry
+class TelemetryThread : public QThread
+{
+public:
+  void run() override
+  {
+    for( int i = 0; i < 1000; ++i )
+    {
+      QtD1::Telemetry::addToCounter( QtD1::Telemetry::MPQBytesReadCounter,
+                                     2 );
+      QtD1::Telemetry::addSample(
+                       QtD1::Telemetry::ThreadSafeQueueDepthHistogram, i );
+    }
+
+    QtD1::Telemetry::ScopedTimer timer(
+                 QtD1::Telemetry::ImageAssetDecodeTimeHistogram, "worker" );
+  }
+};
+
+//---------------------------------------------------------------------------//
+// Test suite.
+//---------------------------------------------------------------------------//
+class TestTelemetry : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  void init()
+  {
+    QtD1::Telemetry::reset();
+    QtD1::Telemetry::getInstance()->stopTrace();
+  }
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the counters can be updated
+void counters()
+{
+  QCOMPARE( QtD1::Telemetry::getCounter(
+                               QtD1::Telemetry::MPQBytesReadCounter ),
+            (qint64)0 );
+
+  QtD1::Telemetry::addToCounter( QtD1::Telemetry::MPQBytesReadCounter, 10 );
+  QtD1::Telemetry::addToCounter( QtD1::Telemetry::MPQBytesReadCounter, 5 );
+
+  QCOMPARE( QtD1::Telemetry::getCounter(
+                               QtD1::Telemetry::MPQBytesReadCounter ),
+            (qint64)15 );
+
+  QtD1::Telemetry::setCounter( QtD1::Telemetry::AudioVideoDriftCounter, -3 );
+
+  QCOMPARE( QtD1::Telemetry::getCounter(
+                               QtD1::Telemetry::AudioVideoDriftCounter ),
+            (qint64)-3 );
+
+  for( int i = 0; i < QtD1::Telemetry::s_number_of_counters; ++i )
+  {
+    QVERIFY( !QtD1::Telemetry::getCounterName(
+                               (QtD1::Telemetry::Counter)i ).isEmpty() );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that the histograms can be updated
+void histograms()
+{
+  QtD1::Telemetry::addSample( QtD1::Telemetry::GameTickTimeHistogram, 0 );
+  QtD1::Telemetry::addSample( QtD1::Telemetry::GameTickTimeHistogram, 1 );
+  QtD1::Telemetry::addSample( QtD1::Telemetry::GameTickTimeHistogram, 3 );
+  QtD1::Telemetry::addSample( QtD1::Telemetry::GameTickTimeHistogram, 100 );
+  QtD1::Telemetry::addSample( QtD1::Telemetry::GameTickTimeHistogram, -5 );
+
+  QtD1::Telemetry::HistogramSnapshot histogram =
+    QtD1::Telemetry::getHistogram( QtD1::Telemetry::GameTickTimeHistogram );
+
+  QCOMPARE( histogram.count, (qint64)5 );
+  QCOMPARE( histogram.sum, (qint64)104 );
+  QCOMPARE( histogram.max, (qint64)100 );
+  QCOMPARE( histogram.buckets.size(),
+            QtD1::Telemetry::s_number_of_histogram_buckets );
+
+  // Bucket 0 holds the zero (and negative) samples
+  QCOMPARE( histogram.buckets[0], (qint64)2 );
+  QCOMPARE( histogram.buckets[1], (qint64)1 );
+  QCOMPARE( histogram.buckets[2], (qint64)1 );
+  QCOMPARE( histogram.buckets[7], (qint64)1 );
+
+  QCOMPARE( histogram.getMean(), 104/5.0 );
+  QCOMPARE( histogram.getPercentile( 0.5 ), (qint64)1 );
+  QCOMPARE( histogram.getPercentile( 1.0 ), (qint64)100 );
+
+  QtD1::Telemetry::reset();
+
+  histogram =
+    QtD1::Telemetry::getHistogram( QtD1::Telemetry::GameTickTimeHistogram );
+
+  QCOMPARE( histogram.count, (qint64)0 );
+  QCOMPARE( histogram.getPercentile( 0.5 ), (qint64)0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the counters and histograms can be updated by many threads
+void addSample_threads()
+{
+  TelemetryThread thread_a, thread_b;
+
+  thread_a.start();
+  thread_b.start();
+
+  thread_a.wait();
+  thread_b.wait();
+
+  QCOMPARE( QtD1::Telemetry::getCounter(
+                               QtD1::Telemetry::MPQBytesReadCounter ),
+            (qint64)4000 );
+
+  QtD1::Telemetry::HistogramSnapshot histogram =
+    QtD1::Telemetry::getHistogram(
+                            QtD1::Telemetry::ThreadSafeQueueDepthHistogram );
+
+  QCOMPARE( histogram.count, (qint64)2000 );
+  QCOMPARE( histogram.sum, (qint64)999000 );
+  QCOMPARE( histogram.max, (qint64)999 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a scoped timer records a sample when it goes out of scope
+void scopedTimer()
+{
+  {
+    QtD1::Telemetry::ScopedTimer
+      timer( QtD1::Telemetry::GameUpdateTimeHistogram );
+
+    Sleeper::sleep( 20 );
+  }
+
+  QtD1::Telemetry::HistogramSnapshot histogram =
+    QtD1::Telemetry::getHistogram( QtD1::Telemetry::GameUpdateTimeHistogram );
+
+  QCOMPARE( histogram.count, (qint64)1 );
+  QVERIFY( histogram.max >= 15000 );
+
+  // No trace events are recorded unless tracing has been started
+  QVERIFY( QtD1::Telemetry::getInstance()->getTraceEvents().isEmpty() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the trace events can be exported
+void exportChromeTrace()
+{
+  QtD1::Telemetry* telemetry = QtD1::Telemetry::getInstance();
+
+  telemetry->startTrace();
+
+  QVERIFY( QtD1::Telemetry::isTracing() );
+
+  {
+    QtD1::Telemetry::ScopedTimer
+      timer( QtD1::Telemetry::ImageAssetDecodeTimeHistogram,
+             "/levels/towndata/town.cel" );
+  }
+
+  {
+    QtD1::Telemetry::ScopedTimer
+      timer( QtD1::Telemetry::GameTickTimeHistogram );
+  }
+
+  TelemetryThread thread;
+  thread.start();
+  thread.wait();
+
+  telemetry->stopTrace();
+
+  // Events recorded after the trace was stopped are ignored
+  {
+    QtD1::Telemetry::ScopedTimer
+      timer( QtD1::Telemetry::GameTickTimeHistogram );
+  }
+
+  QList<QtD1::Telemetry::TraceEvent> events = telemetry->getTraceEvents();
+
+  QCOMPARE( events.size(), 3 );
+  QCOMPARE( events[0].name, QString( "/levels/towndata/town.cel" ) );
+  QCOMPARE( events[1].name,
+            QtD1::Telemetry::getHistogramName(
+                                   QtD1::Telemetry::GameTickTimeHistogram ) );
+  QVERIFY( events[0].start_time <= events[1].start_time );
+
+  // The events recorded by a thread share the thread id
+  QVERIFY( events[0].thread_id == events[1].thread_id );
+
+  bool worker_event_found = false;
+
+  for( int i = 0; i < events.size(); ++i )
+  {
+    if( events[i].name == "worker" )
+    {
+      worker_event_found = true;
+
+      QVERIFY( events[i].thread_id != events[0].thread_id );
+    }
+  }
+
+  QVERIFY( worker_event_found );
+
+  std::ostringstream trace;
+
+  telemetry->exportChromeTrace( trace );
+
+  const std::string trace_string = trace.str();
+
+  QCOMPARE( trace_string.find( "{\"traceEvents\":[" ), (size_t)0 );
+  QVERIFY( trace_string.find( "\"name\":\"/levels/towndata/town.cel\"" ) !=
+           std::string::npos );
+  QVERIFY( trace_string.find( "\"ph\":\"X\"" ) != std::string::npos );
+  QVERIFY( trace_string.find( "\"ph\":\"C\"" ) != std::string::npos );
+  QVERIFY( trace_string.find( "\"ph\":\"M\"" ) != std::string::npos );
+
+  // Starting a new trace removes the previous trace
+  telemetry->startTrace();
+  telemetry->stopTrace();
+
+  QVERIFY( telemetry->getTraceEvents().isEmpty() );
+}
+
+//---------------------------------------------------------------------------//
+// End test suite.
+//---------------------------------------------------------------------------//
+};
+
+//---------------------------------------------------------------------------//
+// Test Main
+//---------------------------------------------------------------------------//
+QTEST_MAIN( TestTelemetry )
+#include "tstTelemetry.moc"
+
+//---------------------------------------------------------------------------//
+// end tstTelemetry.cpp
+//---------------------------------------------------------------------------//